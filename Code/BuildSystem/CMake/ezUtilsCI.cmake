@@ -36,5 +36,10 @@ function(ez_ci_add_test TARGET_NAME)
 
 	file(APPEND ${CMAKE_BINARY_DIR}/Tests.txt "${TARGET_NAME}|${HWA_VALUE}|0\n")
 
+	# When cross-compiling with an emulator (see toolchain-linux-aarch64.cmake), the tests can be run on the build machine through CTest.
+	if (CMAKE_CROSSCOMPILING AND CMAKE_CROSSCOMPILING_EMULATOR AND NOT ARG_NEEDS_HW_ACCESS)
+		add_test(NAME ${TARGET_NAME} COMMAND ${TARGET_NAME} -nogui -all -nosave)
+	endif()
+
 endfunction()
 
@@ -76,7 +76,7 @@ function(ez_set_build_flags_msvc TARGET_NAME)
 	target_compile_options(${TARGET_NAME} PRIVATE "$<$<CONFIG:RELEASE>:/Oi>")
 	
 	# Enable SSE4.1 for Clang on Windows.
-	# Todo: In general we should make this configurable. As of writing SSE4.1 is always active for windows builds (independent of the compiler)
+	# Higher instruction sets are enabled through EZ_SIMD_LEVEL, see ez_set_build_flags_simd()
 	if (CMAKE_CXX_COMPILER_ID MATCHES "Clang" AND EZ_CMAKE_ARCHITECTURE_X86)
 		target_compile_options(${TARGET_NAME} PRIVATE "-msse4.1")
 	endif()
@@ -143,21 +143,55 @@ endfunction()
 
 function(ez_set_build_flags_gcc TARGET_NAME)
 
+	ez_pull_architecture_vars()
+
 	# Wno-enum-compare removes all annoying enum cast warnings
-	target_compile_options(${TARGET_NAME} PRIVATE -fPIC -Wno-enum-compare -mssse3 -mfpmath=sse -gdwarf-3 -pthread)
+	target_compile_options(${TARGET_NAME} PRIVATE -fPIC -Wno-enum-compare -gdwarf-3 -pthread)
 
 	# dynamic linking will fail without fPIC (plugins)
 	# gdwarf-3 will use the old debug info which is compatible with older gdb versions.
 	# these were previously set as CMAKE_C_FLAGS (not CPP)
 	target_compile_options(${TARGET_NAME} PRIVATE -fPIC -gdwarf-3)
 
-	target_compile_options(${TARGET_NAME} PRIVATE -msse4.1)
+	if(EZ_CMAKE_ARCHITECTURE_X86)
+		target_compile_options(${TARGET_NAME} PRIVATE -mssse3 -mfpmath=sse -msse4.1)
+	endif()
 	
 	# Disable warning: multi-character character constant
 	target_compile_options(${TARGET_NAME} PRIVATE -Wno-multichar)
 
 endfunction()
 
+######################################
+### ez_set_build_flags_simd(<target>)
+######################################
+
+function(ez_set_build_flags_simd TARGET_NAME)
+
+	ez_pull_architecture_vars()
+	ez_pull_compiler_vars()
+
+	# EZ_SIMD_LEVEL selects the SIMD implementation of ezSimdVec4f and friends.
+	# FPU: plain C++ implementation, SSE41: SSE up to 4.1, AVX2: SSE implementation that additionally uses AVX2 and FMA instructions
+	set(EZ_SIMD_LEVEL "SSE41" CACHE STRING "Which instruction set the SIMD math implementation is allowed to use on x86 (FPU, SSE41, AVX2).")
+	set_property(CACHE EZ_SIMD_LEVEL PROPERTY STRINGS FPU SSE41 AVX2)
+
+	if (NOT EZ_CMAKE_ARCHITECTURE_X86)
+		return()
+	endif()
+
+	if (EZ_SIMD_LEVEL STREQUAL "FPU")
+		target_compile_definitions(${TARGET_NAME} PUBLIC BUILDSYSTEM_SIMD_IMPLEMENTATION_FPU)
+	elseif (EZ_SIMD_LEVEL STREQUAL "AVX2")
+		if (EZ_CMAKE_COMPILER_MSVC AND NOT CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+			target_compile_options(${TARGET_NAME} PRIVATE "/arch:AVX2")
+		else()
+			target_compile_options(${TARGET_NAME} PRIVATE -mavx2 -mfma)
+		endif()
+	endif()
+
+endfunction()
+
 ######################################
 ### ez_set_build_flags(<target>)
 ######################################
@@ -191,4 +225,6 @@ function(ez_set_build_flags TARGET_NAME)
 
 	endif()
 
+	ez_set_build_flags_simd(${TARGET_NAME})
+
 endfunction()
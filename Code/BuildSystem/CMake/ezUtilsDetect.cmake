@@ -421,21 +421,29 @@ function(ez_detect_architecture)
 
 	elseif (EZ_CMAKE_PLATFORM_LINUX AND EZ_CMAKE_COMPILER_GCC)
 	  
-	  message (STATUS "Platform is X86 (EZ_CMAKE_ARCHITECTURE_X86)")
-	  set_property(GLOBAL PROPERTY EZ_CMAKE_ARCHITECTURE_X86 ON)
+	  # CMAKE_SYSTEM_PROCESSOR is the target processor, which is set by the toolchain file when cross-compiling
+	  if (CMAKE_SYSTEM_PROCESSOR MATCHES "^(aarch64|arm)")
+			message (STATUS "Platform is ARM (EZ_CMAKE_ARCHITECTURE_ARM)")
+			set_property(GLOBAL PROPERTY EZ_CMAKE_ARCHITECTURE_ARM ON)
+			set (ARCH_POSTFIX_PREFIX "Arm")
+	  else ()
+			message (STATUS "Platform is X86 (EZ_CMAKE_ARCHITECTURE_X86)")
+			set_property(GLOBAL PROPERTY EZ_CMAKE_ARCHITECTURE_X86 ON)
+			set (ARCH_POSTFIX_PREFIX "")
+	  endif ()
 	  
 	  # Detect 64-bit builds for Linux, no other way than checking CMAKE_SIZEOF_VOID_P.
 	  if (CMAKE_SIZEOF_VOID_P EQUAL 8)
 	  
 			message (STATUS "Platform is 64-Bit (EZ_CMAKE_ARCHITECTURE_64BIT)")
 			set_property(GLOBAL PROPERTY EZ_CMAKE_ARCHITECTURE_64BIT ON)
-			set_property(GLOBAL PROPERTY EZ_CMAKE_ARCHITECTURE_POSTFIX "64")
+			set_property(GLOBAL PROPERTY EZ_CMAKE_ARCHITECTURE_POSTFIX "${ARCH_POSTFIX_PREFIX}64")
 		
 	  else ()
 	  
 			message (STATUS "Platform is 32-Bit (EZ_CMAKE_ARCHITECTURE_32BIT)")
 			set_property(GLOBAL PROPERTY EZ_CMAKE_ARCHITECTURE_32BIT ON)
-			set_property(GLOBAL PROPERTY EZ_CMAKE_ARCHITECTURE_POSTFIX "32")
+			set_property(GLOBAL PROPERTY EZ_CMAKE_ARCHITECTURE_POSTFIX "${ARCH_POSTFIX_PREFIX}32")
 		
 	  endif ()
 	elseif(EZ_CMAKE_PLATFORM_ANDROID AND EZ_CMAKE_COMPILER_CLANG)
@@ -0,0 +1,29 @@
+# Cross-compiles for 64 bit ARM Linux with the GNU toolchain (Debian / Ubuntu package 'g++-aarch64-linux-gnu').
+#
+# If qemu user mode emulation is installed ('qemu-user'), the unit tests are registered with CTest and run through qemu,
+# which allows to check ARM builds on x86 machines:
+#
+#   cmake -S . -B build-arm64 -DCMAKE_TOOLCHAIN_FILE=Code/BuildSystem/CMake/toolchain-linux-aarch64.cmake -DEZ_BUILD_FILTER=FoundationOnly
+#   cmake --build build-arm64
+#   ctest --test-dir build-arm64 --output-on-failure
+
+set(CMAKE_SYSTEM_NAME Linux)
+set(CMAKE_SYSTEM_PROCESSOR aarch64)
+
+set(EZ_CROSS_TRIPLE "aarch64-linux-gnu")
+set(EZ_CROSS_SYSROOT "/usr/${EZ_CROSS_TRIPLE}")
+
+set(CMAKE_C_COMPILER ${EZ_CROSS_TRIPLE}-gcc)
+set(CMAKE_CXX_COMPILER ${EZ_CROSS_TRIPLE}-g++)
+
+set(CMAKE_FIND_ROOT_PATH ${EZ_CROSS_SYSROOT})
+set(CMAKE_FIND_ROOT_PATH_MODE_PROGRAM NEVER)
+set(CMAKE_FIND_ROOT_PATH_MODE_LIBRARY ONLY)
+set(CMAKE_FIND_ROOT_PATH_MODE_INCLUDE ONLY)
+set(CMAKE_FIND_ROOT_PATH_MODE_PACKAGE ONLY)
+
+find_program(EZ_QEMU_AARCH64 qemu-aarch64)
+
+if (EZ_QEMU_AARCH64)
+	set(CMAKE_CROSSCOMPILING_EMULATOR "${EZ_QEMU_AARCH64};-L;${EZ_CROSS_SYSROOT}")
+endif()
@@ -58,7 +58,7 @@ ezResult ezEngineProcessCommunicationChannel::ConnectToHostProcess()
     ezLog::Debug("Host Process ID: {0}", m_iHostPID);
 
     m_pChannel =
-      ezIpcChannel::CreatePipeChannel(ezCommandLineUtils::GetGlobalInstance()->GetStringOption("-IPC"), ezIpcChannel::Mode::Client);
+      ezIpcChannel::CreateSharedMemoryChannel(ezCommandLineUtils::GetGlobalInstance()->GetStringOption("-IPC"), ezIpcChannel::Mode::Client);
   }
   else
   {
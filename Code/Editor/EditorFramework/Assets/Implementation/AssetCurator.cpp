@@ -1631,39 +1631,20 @@ void ezAssetCurator::IterateDataDirectory(const char* szDataDir, const ezSet<ezS
   if (sDataDir.IsEmpty())
     return;
 
-  ezFileSystemIterator iterator;
-  if (iterator.StartSearch(sDataDir, ezFileSystemIteratorFlags::ReportFilesAndFoldersRecursive).Failed())
-    return;
+  // data directories can contain a huge number of files, so the folders are searched in parallel
+  ezDynamicArray<ezFileStats> files;
+  ezOSFile::GatherAllItemsInFolderParallel(files, sDataDir, ezFileSystemIteratorFlags::ReportFilesRecursive, [](const ezFileStats& folder) {
+    // we do not want to recurse into the AssetCache folder
+    return folder.m_sName != "AssetCache";
+  });
 
   ezStringBuilder sPath;
 
-  while (true)
+  for (const ezFileStats& stats : files)
   {
-    // we do not want to recurse into the AssetCache folder
-    if (iterator.GetStats().m_bIsDirectory)
-    {
-      if (iterator.GetStats().m_sName == "AssetCache")
-      {
-        if (iterator.SkipFolder().Failed())
-          break;
-
-        continue;
-      }
+    stats.GetFullPath(sPath);
 
-      if (iterator.Next().Failed())
-        break;
-
-      continue;
-    }
-
-    sPath = iterator.GetCurrentPath();
-    sPath.AppendPath(iterator.GetStats().m_sName);
-    sPath.MakeCleanPath();
-
-    HandleSingleFile(sPath, validExtensions, iterator.GetStats());
-
-    if (iterator.Next().Failed())
-      break;
+    HandleSingleFile(sPath, validExtensions, stats);
   }
 }
 
@@ -35,7 +35,7 @@ ezResult ezEditorProcessCommunicationChannel::StartClientProcess(
   }
   else
   {
-    m_pChannel = ezIpcChannel::CreatePipeChannel(sMemName, ezIpcChannel::Mode::Server);
+    m_pChannel = ezIpcChannel::CreateSharedMemoryChannel(sMemName, ezIpcChannel::Mode::Server);
   }
 
   m_pChannel->m_MessageEvent.AddEventHandler(ezMakeDelegate(&ezProcessCommunicationChannel::MessageFunc, this));
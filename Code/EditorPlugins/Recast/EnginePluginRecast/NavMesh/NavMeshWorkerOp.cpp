@@ -4,6 +4,7 @@
 
 #include <Core/Assets/AssetFileHeader.h>
 #include <EditorEngineProcessFramework/EngineProcess/EngineProcessDocumentContext.h>
+#include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
 #include <Foundation/Utilities/Progress.h>
 #include <ToolsFoundation/Document/DocumentManager.h>
@@ -41,6 +42,19 @@ ezResult ezLongOpWorker_BuildNavMesh::Execute(ezProgress& progress, ezStreamWrit
   ezRecastNavMeshBuilder NavMeshBuilder;
   ezRecastNavMeshResourceDescriptor desc;
 
+  // start from the previous result, so that only the tiles whose geometry has changed need to be rebuilt
+  {
+    ezFileReader file;
+    if (file.Open(m_sOutputPath).Succeeded())
+    {
+      ezAssetFileHeader header;
+      if (header.Read(file).Failed() || desc.Deserialize(file).Failed())
+      {
+        desc.Clear();
+      }
+    }
+  }
+
   if (!pgRange.BeginNextStep("Building NavMesh"))
     return EZ_FAILURE;
 
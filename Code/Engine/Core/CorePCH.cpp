@@ -47,6 +47,7 @@ EZ_STATICLINK_LIBRARY(Core)
   EZ_STATICLINK_REFERENCE(Core_World_Implementation_SettingsComponent);
   EZ_STATICLINK_REFERENCE(Core_World_Implementation_SpatialData);
   EZ_STATICLINK_REFERENCE(Core_World_Implementation_SpatialSystem);
+  EZ_STATICLINK_REFERENCE(Core_World_Implementation_SpatialSystem_Bvh);
   EZ_STATICLINK_REFERENCE(Core_World_Implementation_SpatialSystem_RegularGrid);
   EZ_STATICLINK_REFERENCE(Core_World_Implementation_World);
   EZ_STATICLINK_REFERENCE(Core_World_Implementation_WorldData);
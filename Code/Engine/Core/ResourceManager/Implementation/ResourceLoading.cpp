@@ -106,11 +106,14 @@ void ezResourceManager::RunWorkerTask(ezResource* pResource)
   {
     s_State->s_bAllowLaunchDataLoadTask = false;
 
+    // if a critical resource is waiting, the file access thread should get to it before any other file access work
+    const ezTaskPriority::Enum priority = s_State->s_LoadingQueue.PeekFront().m_pResource->GetPriority() == ezResourcePriority::Critical ? ezTaskPriority::FileAccessHighPriority : ezTaskPriority::FileAccess;
+
     for (ezUInt32 i = 0; i < s_State->s_WorkerTasksDataLoad.GetCount(); ++i)
     {
       if (s_State->s_WorkerTasksDataLoad[i].m_pTask->IsTaskFinished())
       {
-        s_State->s_WorkerTasksDataLoad[i].m_GroupId = ezTaskSystem::StartSingleTask(s_State->s_WorkerTasksDataLoad[i].m_pTask.Borrow(), ezTaskPriority::FileAccess);
+        s_State->s_WorkerTasksDataLoad[i].m_GroupId = ezTaskSystem::StartSingleTask(s_State->s_WorkerTasksDataLoad[i].m_pTask.Borrow(), priority);
         return;
       }
     }
@@ -122,11 +125,22 @@ void ezResourceManager::RunWorkerTask(ezResource* pResource)
       auto& data = s_State->s_WorkerTasksDataLoad.ExpandAndGetRef();
       data.m_pTask = EZ_DEFAULT_NEW(ezResourceManagerWorkerDataLoad);
       data.m_pTask->ConfigureTask(s, ezTaskNesting::Maybe);
-      data.m_GroupId = ezTaskSystem::StartSingleTask(data.m_pTask.Borrow(), ezTaskPriority::FileAccess);
+      data.m_GroupId = ezTaskSystem::StartSingleTask(data.m_pTask.Borrow(), priority);
     }
   }
 }
 
+void ezResourceManager::SetDataLoadBatchSize(ezUInt32 uiMaxResourcesPerTask)
+{
+  EZ_LOCK(s_ResourceMutex);
+  s_State->s_uiDataLoadBatchSize = ezMath::Max(1u, uiMaxResourcesPerTask);
+}
+
+ezUInt32 ezResourceManager::GetDataLoadBatchSize()
+{
+  return s_State->s_uiDataLoadBatchSize;
+}
+
 void ezResourceManager::ReverseBubbleSortStep(ezDeque<LoadingInfo>& data)
 {
   // Yep, it's really bubble sort!
@@ -143,7 +157,7 @@ void ezResourceManager::ReverseBubbleSortStep(ezDeque<LoadingInfo>& data)
     const ezUInt32 idx2 = i - 1;
     const ezUInt32 idx1 = i - 2;
 
-    if (data[idx1].m_fPriority > data[idx1].m_fPriority)
+    if (data[idx1].m_fPriority > data[idx2].m_fPriority)
     {
       ezMath::Swap(data[idx1], data[idx2]);
     }
@@ -252,6 +266,9 @@ void ezResourceManager::AddToLoadingQueue(ezResource* pResource, bool bHighestPr
   {
     li.m_fPriority = pResource->GetLoadingPriority(s_State->s_LastFrameUpdate);
     s_State->s_LoadingQueue.PushBack(li);
+
+    // resources with highest priority are needed right away, there is no time to prefetch anything for them
+    s_State->s_QueuedForLoadingHints.PushBack(pResource->GetResourceID());
   }
 }
 
@@ -413,6 +430,16 @@ void ezResourceManager::EnsureResourceLoadingState(ezResource* pResourceToLoad,
     {
       EZ_LOCK(s_ResourceMutex);
 
+      if (ezTaskSystem::GetCurrentThreadWorkerType() == ezWorkerThreadType::FileAccess)
+      {
+        // a loader blocks on another resource while reading (e.g. a sound event on its sound bank)
+        // that resource may already have been read as part of the current batch, so pass on what was read so far
+        for (auto& td : s_State->s_WorkerTasksDataLoad)
+        {
+          td.m_pTask->DispatchBatch();
+        }
+      }
+
       for (ezUInt32 i = 0; i < s_State->s_WorkerTasksUpdateContent.GetCount(); ++i)
       {
         const ezResource* pQueuedResource = s_State->s_WorkerTasksUpdateContent[i].m_pTask->m_pResourceToLoad;
@@ -484,6 +484,22 @@ void ezResourceManager::PerFrameUpdate()
     s_State->s_ResourcesToUnloadOnMainThread.Clear();
   }
 
+  {
+    ezVariantArray queuedResources;
+
+    {
+      EZ_LOCK(s_ResourceMutex);
+      queuedResources.Swap(s_State->s_QueuedForLoadingHints);
+    }
+
+    // Allows Fileserve to request the files of all these resources in one go, before the loading tasks ask for them one by one.
+    // Uses a global event for the same reason as ezResourceManager_ReloadAllResources.
+    if (!queuedResources.IsEmpty())
+    {
+      EZ_BROADCAST_EVENT(ezResourceManager_ResourcesQueuedForLoading, queuedResources);
+    }
+  }
+
   if (s_State->m_AutoFreeUnusedTimeout.IsPositive())
   {
     FreeUnusedResources(s_State->m_AutoFreeUnusedTimeout, s_State->m_AutoFreeUnusedThreshold);
@@ -558,6 +574,11 @@ void ezResourceManager::EngineAboutToShutdown()
     ezTaskSystem::CancelTask(s_State->s_WorkerTasksUpdateContent[i].m_pTask.Borrow());
   }
 
+  for (ezUInt32 i = 0; i < s_State->s_WorkerTasksFinalize.GetCount(); ++i)
+  {
+    ezTaskSystem::CancelTask(s_State->s_WorkerTasksFinalize[i].m_pTask.Borrow());
+  }
+
   {
     EZ_LOCK(s_ResourceMutex);
 
@@ -604,9 +625,18 @@ bool ezResourceManager::IsAnyLoadingInProgress()
     }
   }
 
+  // a resource stays assigned to its update content task from being read until it is finalized
   for (ezUInt32 i = 0; i < s_State->s_WorkerTasksUpdateContent.GetCount(); ++i)
   {
-    if (!s_State->s_WorkerTasksUpdateContent[i].m_pTask->IsTaskFinished())
+    if (!s_State->s_WorkerTasksUpdateContent[i].m_pTask->IsTaskFinished() || s_State->s_WorkerTasksUpdateContent[i].m_pTask->m_pResourceToLoad != nullptr)
+    {
+      return true;
+    }
+  }
+
+  for (ezUInt32 i = 0; i < s_State->s_WorkerTasksFinalize.GetCount(); ++i)
+  {
+    if (!s_State->s_WorkerTasksFinalize[i].m_pTask->IsTaskFinished())
     {
       return true;
     }
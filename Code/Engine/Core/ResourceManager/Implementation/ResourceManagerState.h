@@ -4,6 +4,7 @@
 EZ_CORE_INTERNAL_HEADER
 
 #include <Core/ResourceManager/ResourceManager.h>
+#include <Foundation/Types/Variant.h>
 
 class ezResourceManagerState
 {
@@ -12,6 +13,7 @@ private:
   friend class ezResourceManager;
   friend class ezResourceManagerWorkerDataLoad;
   friend class ezResourceManagerWorkerUpdateContent;
+  friend class ezResourceManagerWorkerFinalize;
   friend class ezResourceHandleReadContext;
 
   /// \name Events
@@ -46,6 +48,12 @@ private:
     ezTaskGroupID m_GroupId;
   };
 
+  struct TaskDataFinalize
+  {
+    ezUniquePtr<ezResourceManagerWorkerFinalize> m_pTask;
+    ezTaskGroupID m_GroupId;
+  };
+
   bool m_bTaskNamesInitialized = false;
   bool s_bBroadcastExistsEvent = false;
   ezUInt32 s_uiForceNoFallbackAcquisition = 0;
@@ -55,11 +63,16 @@ private:
 
   ezHashTable<const ezRTTI*, ezResourceManager::LoadedResources> s_LoadedResources;
 
+  // IDs of resources that were queued for loading since the last frame, broadcast as a hint to prefetch their files
+  ezVariantArray s_QueuedForLoadingHints;
+
   bool s_bAllowLaunchDataLoadTask = true;
+  ezUInt32 s_uiDataLoadBatchSize = 16;
   bool s_bShutdown = false;
 
   ezHybridArray<TaskDataUpdateContent, 24> s_WorkerTasksUpdateContent;
   ezHybridArray<TaskDataDataLoad, 8> s_WorkerTasksDataLoad;
+  ezHybridArray<TaskDataFinalize, 8> s_WorkerTasksFinalize;
 
   ezTime s_LastFrameUpdate;
   ezUInt32 s_uiLastResourcePriorityUpdateIdx = 0;
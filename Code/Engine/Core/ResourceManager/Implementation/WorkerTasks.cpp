@@ -4,6 +4,7 @@
 #include <Core/ResourceManager/ResourceManager.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Types/ScopeExit.h>
 
 ezResourceManagerWorkerDataLoad::ezResourceManagerWorkerDataLoad() = default;
 ezResourceManagerWorkerDataLoad::~ezResourceManagerWorkerDataLoad() = default;
@@ -12,25 +13,37 @@ void ezResourceManagerWorkerDataLoad::Execute()
 {
   EZ_PROFILE_SCOPE("LoadResourceFromDisk");
 
-  ezResource* pResourceToLoad = nullptr;
-  ezResourceTypeLoader* pLoader = nullptr;
-  ezUniquePtr<ezResourceTypeLoader> pCustomLoader;
+  // Every execution reads up to a whole batch of resources, the decoding and finalizing is then started for the whole batch at once.
+  // Resources are still taken from the queue one at a time, such that a resource that gets promoted to the front while this batch is
+  // running (e.g. because some other thread blocks on it) is picked up next. The mutex is only locked to take the next resource from the
+  // queue, not while reading.
 
-  {
-    EZ_LOCK(ezResourceManager::s_ResourceMutex);
+  const ezTime tStart = ezTime::Now();
 
-    if (ezResourceManager::s_State->s_LoadingQueue.IsEmpty())
-    {
-      ezResourceManager::s_State->s_bAllowLaunchDataLoadTask = true;
-      return;
-    }
+  EZ_LOCK(ezResourceManager::s_ResourceMutex);
 
-    ezResourceManager::UpdateLoadingDeadlines();
+  ezResourceManager::UpdateLoadingDeadlines();
+
+  const ezUInt32 uiBatchSize = ezResourceManager::s_State->s_uiDataLoadBatchSize;
+  ezUInt32 uiNumRead = 0;
+  ezUInt32 uiNextUpdateContentTask = 0;
+
+  while (!ezResourceManager::s_State->s_LoadingQueue.IsEmpty() && !ezResourceManager::s_State->s_bShutdown)
+  {
+    ezResource* pResourceToLoad = ezResourceManager::s_State->s_LoadingQueue.PeekFront().m_pResource;
+    const bool bIsCritical = pResourceToLoad->GetPriority() == ezResourcePriority::Critical;
+
+    // a batch is either critical or not, so that every stage can run it with the appropriate task priority
+    if (m_ReadBatch.IsEmpty())
+      m_bCriticalBatch = bIsCritical;
+    else if (bIsCritical != m_bCriticalBatch)
+      break;
 
-    auto it = ezResourceManager::s_State->s_LoadingQueue.PeekFront();
-    pResourceToLoad = it.m_pResource;
     ezResourceManager::s_State->s_LoadingQueue.PopFront();
 
+    ezResourceTypeLoader* pLoader = nullptr;
+    ezUniquePtr<ezResourceTypeLoader> pCustomLoader;
+
     if (pResourceToLoad->m_Flags.IsSet(ezResourceFlags::HasCustomDataLoader))
     {
       pCustomLoader = std::move(ezResourceManager::s_State->s_CustomLoaders[pResourceToLoad]);
@@ -38,69 +51,144 @@ void ezResourceManagerWorkerDataLoad::Execute()
       pResourceToLoad->m_Flags.Remove(ezResourceFlags::HasCustomDataLoader);
       pResourceToLoad->m_Flags.Add(ezResourceFlags::PreventFileReload);
     }
+
+    if (pLoader == nullptr)
+      pLoader = ezResourceManager::GetResourceTypeLoader(pResourceToLoad->GetDynamicRTTI());
+
+    if (pLoader == nullptr)
+      pLoader = pResourceToLoad->GetDefaultResourceTypeLoader();
+
+    EZ_ASSERT_DEV(pLoader != nullptr, "No Loader function available for Resource Type '{0}'", pResourceToLoad->GetDynamicRTTI()->GetTypeName());
+
+    // find an update content task that is not used by any other batch
+    // continue where the previous resource of this batch stopped, all tasks before that were busy a moment ago
+    ezUInt32 uiTaskIdx = ezInvalidIndex;
+    {
+      const ezUInt32 uiNumUpdateContentTasks = ezResourceManager::s_State->s_WorkerTasksUpdateContent.GetCount();
+
+      for (ezUInt32 i = 0; i < uiNumUpdateContentTasks; ++i)
+      {
+        const ezUInt32 uiIdx = (uiNextUpdateContentTask + i) % uiNumUpdateContentTasks;
+        const ezResourceManagerWorkerUpdateContent* pTask = ezResourceManager::s_State->s_WorkerTasksUpdateContent[uiIdx].m_pTask.Borrow();
+
+        if (pTask->m_pResourceToLoad == nullptr && pTask->IsTaskFinished())
+        {
+          uiTaskIdx = uiIdx;
+          break;
+        }
+      }
+    }
+
+    // if no such task could be found, we must allocate a new one
+    if (uiTaskIdx == ezInvalidIndex)
+    {
+      ezStringBuilder s;
+      s.Format("Resource Content Updater {0}", ezResourceManager::s_State->s_WorkerTasksUpdateContent.GetCount());
+
+      uiTaskIdx = ezResourceManager::s_State->s_WorkerTasksUpdateContent.GetCount();
+
+      auto& td = ezResourceManager::s_State->s_WorkerTasksUpdateContent.ExpandAndGetRef();
+      td.m_pTask = EZ_DEFAULT_NEW(ezResourceManagerWorkerUpdateContent);
+      td.m_pTask->ConfigureTask(s, ezTaskNesting::Maybe);
+    }
+
+    uiNextUpdateContentTask = uiTaskIdx + 1;
+
+    ezResourceManagerWorkerUpdateContent* pUpdateContentTask = ezResourceManager::s_State->s_WorkerTasksUpdateContent[uiTaskIdx].m_pTask.Borrow();
+    pUpdateContentTask->m_pLoader = pLoader;
+    pUpdateContentTask->m_pCustomLoader = std::move(pCustomLoader);
+    pUpdateContentTask->m_pResourceToLoad = pResourceToLoad;
+
+    ezResourceLoadData LoaderData;
+
+    {
+      ezResourceManager::s_ResourceMutex.Unlock();
+      EZ_SCOPE_EXIT(ezResourceManager::s_ResourceMutex.Lock());
+
+      LoaderData = pLoader->OpenDataStream(pResourceToLoad);
+    }
+
+    pUpdateContentTask->m_LoaderData = LoaderData;
+
+    // the batch may have been dispatched while OpenDataStream() waited for another resource, then this starts a new one
+    if (m_ReadBatch.IsEmpty())
+      m_bCriticalBatch = bIsCritical;
+
+    m_ReadBatch.PushBack(uiTaskIdx);
+
+    ++uiNumRead;
+
+    // give the task system a chance to run other file access tasks in between, which may have a higher priority
+    if (uiNumRead >= uiBatchSize || ezTime::Now() - tStart > ezTime::Milliseconds(5))
+      break;
   }
 
-  if (pLoader == nullptr)
-    pLoader = ezResourceManager::GetResourceTypeLoader(pResourceToLoad->GetDynamicRTTI());
+  DispatchBatch();
 
-  if (pLoader == nullptr)
-    pLoader = pResourceToLoad->GetDefaultResourceTypeLoader();
+  // restart the next loading task (this one is about to finish)
+  ezResourceManager::s_State->s_bAllowLaunchDataLoadTask = true;
+  ezResourceManager::RunWorkerTask(nullptr);
+}
 
-  EZ_ASSERT_DEV(pLoader != nullptr, "No Loader function available for Resource Type '{0}'", pResourceToLoad->GetDynamicRTTI()->GetTypeName());
+void ezResourceManagerWorkerDataLoad::DispatchBatch()
+{
+  EZ_ASSERT_DEV(ezResourceManager::s_ResourceMutex.IsLocked(), "Resource mutex must be locked");
 
-  ezResourceLoadData LoaderData = pLoader->OpenDataStream(pResourceToLoad);
+  if (m_ReadBatch.IsEmpty())
+    return;
 
-  // we need this info later to do some work in a lock, all the directly following code is outside the lock
-  const bool bResourceIsLoadedOnMainThread = pResourceToLoad->GetBaseResourceFlags().IsAnySet(ezResourceFlags::UpdateOnMainThread);
+  EZ_PROFILE_SCOPE("DispatchResourceBatch");
 
-  ezResourceManagerWorkerUpdateContent* pUpdateContentTask = nullptr;
-  ezTaskGroupID* pUpdateContentGroup = nullptr;
+  // critical resources are usually waited for, so they should not linger behind all the other resources that were loaded before
+  const ezTaskPriority::Enum decodePriority = m_bCriticalBatch ? ezTaskPriority::EarlyNextFrame : ezTaskPriority::LateNextFrame;
+  const ezTaskPriority::Enum finalizePriority = m_bCriticalBatch ? ezTaskPriority::ThisFrameMainThread : ezTaskPriority::SomeFrameMainThread;
 
-  EZ_LOCK(ezResourceManager::s_ResourceMutex);
+  ezResourceManagerWorkerFinalize* pFinalizeTask = nullptr;
+  ezTaskGroupID* pFinalizeGroup = nullptr;
 
-  // try to find an update content task that has finished and can be reused
-  for (ezUInt32 i = 0; i < ezResourceManager::s_State->s_WorkerTasksUpdateContent.GetCount(); ++i)
+  for (auto& td : ezResourceManager::s_State->s_WorkerTasksFinalize)
   {
-    auto& td = ezResourceManager::s_State->s_WorkerTasksUpdateContent[i];
-
-    if (ezTaskSystem::IsTaskGroupFinished(td.m_GroupId))
+    if (td.m_pTask->IsTaskFinished())
     {
-      pUpdateContentTask = td.m_pTask.Borrow();
-      pUpdateContentGroup = &td.m_GroupId;
+      pFinalizeTask = td.m_pTask.Borrow();
+      pFinalizeGroup = &td.m_GroupId;
       break;
     }
   }
 
-  // if no such task could be found, we must allocate a new one
-  if (pUpdateContentTask == nullptr)
+  if (pFinalizeTask == nullptr)
   {
     ezStringBuilder s;
-    s.Format("Resource Content Updater {0}", ezResourceManager::s_State->s_WorkerTasksUpdateContent.GetCount());
+    s.Format("Resource Finalizer {0}", ezResourceManager::s_State->s_WorkerTasksFinalize.GetCount());
 
-    auto& td = ezResourceManager::s_State->s_WorkerTasksUpdateContent.ExpandAndGetRef();
-    td.m_pTask = EZ_DEFAULT_NEW(ezResourceManagerWorkerUpdateContent);
+    auto& td = ezResourceManager::s_State->s_WorkerTasksFinalize.ExpandAndGetRef();
+    td.m_pTask = EZ_DEFAULT_NEW(ezResourceManagerWorkerFinalize);
     td.m_pTask->ConfigureTask(s, ezTaskNesting::Maybe);
 
-    pUpdateContentTask = td.m_pTask.Borrow();
-    pUpdateContentGroup = &td.m_GroupId;
+    pFinalizeTask = td.m_pTask.Borrow();
+    pFinalizeGroup = &td.m_GroupId;
   }
 
-  // set up the data load task and launch it
+  // all resources that can be updated on any thread are decoded in parallel, the others are decoded by the finalize task
+  const ezTaskGroupID decodeGroup = ezTaskSystem::CreateTaskGroup(decodePriority);
+
+  pFinalizeTask->m_Batch.Clear();
+  for (ezUInt32 uiTaskIdx : m_ReadBatch)
   {
-    pUpdateContentTask->m_LoaderData = LoaderData;
-    pUpdateContentTask->m_pLoader = pLoader;
-    pUpdateContentTask->m_pCustomLoader = std::move(pCustomLoader);
-    pUpdateContentTask->m_pResourceToLoad = pResourceToLoad;
+    auto& td = ezResourceManager::s_State->s_WorkerTasksUpdateContent[uiTaskIdx];
+    pFinalizeTask->m_Batch.PushBack(td.m_pTask.Borrow());
 
-    // schedule the task to run, either on the main thread or on some other thread
-    *pUpdateContentGroup = ezTaskSystem::StartSingleTask(pUpdateContentTask, bResourceIsLoadedOnMainThread ? ezTaskPriority::SomeFrameMainThread : ezTaskPriority::LateNextFrame);
+    if (!td.m_pTask->m_pResourceToLoad->GetBaseResourceFlags().IsAnySet(ezResourceFlags::UpdateOnMainThread))
+    {
+      ezTaskSystem::AddTaskToGroup(decodeGroup, td.m_pTask.Borrow());
+      td.m_GroupId = decodeGroup;
+    }
+  }
 
-    // restart the next loading task (this one is about to finish)
-    ezResourceManager::s_State->s_bAllowLaunchDataLoadTask = true;
-    ezResourceManager::RunWorkerTask(nullptr);
+  m_ReadBatch.Clear();
 
-    pCustomLoader.Clear();
-  }
+  ezTaskSystem::StartTaskGroup(decodeGroup);
+  *pFinalizeGroup = ezTaskSystem::StartSingleTask(pFinalizeTask, finalizePriority, decodeGroup);
 }
 
 
@@ -110,12 +198,20 @@ ezResourceManagerWorkerUpdateContent::ezResourceManagerWorkerUpdateContent() = d
 ezResourceManagerWorkerUpdateContent::~ezResourceManagerWorkerUpdateContent() = default;
 
 void ezResourceManagerWorkerUpdateContent::Execute()
+{
+  UpdateContent();
+}
+
+void ezResourceManagerWorkerUpdateContent::UpdateContent()
 {
   if (!m_LoaderData.m_sResourceDescription.IsEmpty())
     m_pResourceToLoad->SetResourceDescription(m_LoaderData.m_sResourceDescription);
 
   m_pResourceToLoad->CallUpdateContent(m_LoaderData.m_pDataStream);
+}
 
+void ezResourceManagerWorkerUpdateContent::Finalize()
+{
   if (m_pResourceToLoad->m_uiQualityLevelsLoadable > 0)
   {
     // if the resource can have more details loaded, put it into the preload queue right away again
@@ -142,16 +238,45 @@ void ezResourceManagerWorkerUpdateContent::Execute()
   }
 
   m_pLoader->CloseDataStream(m_pResourceToLoad, m_LoaderData);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+
+ezResourceManagerWorkerFinalize::ezResourceManagerWorkerFinalize() = default;
+ezResourceManagerWorkerFinalize::~ezResourceManagerWorkerFinalize() = default;
+
+void ezResourceManagerWorkerFinalize::Execute()
+{
+  EZ_PROFILE_SCOPE("FinalizeResources");
+
+  for (ezResourceManagerWorkerUpdateContent* pTask : m_Batch)
+  {
+    if (pTask->m_pResourceToLoad->GetBaseResourceFlags().IsAnySet(ezResourceFlags::UpdateOnMainThread))
+    {
+      pTask->UpdateContent();
+    }
+
+    pTask->Finalize();
+  }
 
   {
     EZ_LOCK(ezResourceManager::s_ResourceMutex);
-    EZ_ASSERT_DEV(ezResourceManager::IsQueuedForLoading(m_pResourceToLoad), "Multi-threaded access detected");
-    m_pResourceToLoad->m_Flags.Remove(ezResourceFlags::IsQueuedForLoading);
-    m_pResourceToLoad->m_LastAcquire = ezResourceManager::GetLastFrameUpdate();
+
+    for (ezResourceManagerWorkerUpdateContent* pTask : m_Batch)
+    {
+      EZ_ASSERT_DEV(ezResourceManager::IsQueuedForLoading(pTask->m_pResourceToLoad), "Multi-threaded access detected");
+      pTask->m_pResourceToLoad->m_Flags.Remove(ezResourceFlags::IsQueuedForLoading);
+      pTask->m_pResourceToLoad->m_LastAcquire = ezResourceManager::GetLastFrameUpdate();
+
+      // the update content task may be used by the next batch now
+      pTask->m_pCustomLoader.Clear();
+      pTask->m_pLoader = nullptr;
+      pTask->m_pResourceToLoad = nullptr;
+    }
   }
 
-  m_pLoader = nullptr;
-  m_pResourceToLoad = nullptr;
+  m_Batch.Clear();
 }
 
 
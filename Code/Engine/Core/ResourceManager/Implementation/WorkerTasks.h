@@ -2,10 +2,15 @@
 
 #include <Core/ResourceManager/Implementation/Declarations.h>
 #include <Core/ResourceManager/ResourceTypeLoader.h>
+#include <Foundation/Containers/HybridArray.h>
 #include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Types/UniquePtr.h>
 
 /// \brief [internal] Worker task for loading resources (typically from disk).
+///
+/// This is the first stage of the loading pipeline. It runs on the file access thread and reads the data of a batch of resources back to back.
+/// Afterwards the batch is handed to the ezResourceManagerWorkerUpdateContent tasks, which decode the resources in parallel, and to one
+/// ezResourceManagerWorkerFinalize task, which finishes the whole batch on the main thread.
 class EZ_CORE_DLL ezResourceManagerWorkerDataLoad final : public ezTask
 {
 public:
@@ -18,10 +23,18 @@ private:
   ezResourceManagerWorkerDataLoad();
 
   virtual void Execute() override;
+
+  /// \brief Starts the decode and finalize stages for all resources that have been read so far.
+  void DispatchBatch();
+
+  // indices into ezResourceManagerState::s_WorkerTasksUpdateContent of the resources that have been read, but not dispatched yet
+  ezHybridArray<ezUInt32, 16> m_ReadBatch;
+  bool m_bCriticalBatch = false;
 };
 
-/// \brief [internal] Worker task for uploading resource data.
-/// Depending on the resource type, this may get scheduled to run on the main thread or on any thread.
+/// \brief [internal] Worker task for decoding resource data, i.e. calling ezResource::UpdateContent().
+///
+/// Resources that must be updated on the main thread are not decoded by this task, but by the ezResourceManagerWorkerFinalize task of their batch.
 class EZ_CORE_DLL ezResourceManagerWorkerUpdateContent final : public ezTask
 {
 public:
@@ -38,7 +51,30 @@ private:
   friend class ezResourceManager;
   friend class ezResourceManagerState;
   friend class ezResourceManagerWorkerDataLoad;
+  friend class ezResourceManagerWorkerFinalize;
   ezResourceManagerWorkerUpdateContent();
 
   virtual void Execute() override;
+
+  void UpdateContent();
+  void Finalize();
+};
+
+/// \brief [internal] Main thread task that finishes a batch of resources once all of them have been decoded.
+///
+/// Closes the data streams, updates the memory usage and removes the resources from the loading queue with a single lock of the resource mutex.
+class EZ_CORE_DLL ezResourceManagerWorkerFinalize final : public ezTask
+{
+public:
+  ~ezResourceManagerWorkerFinalize();
+
+  ezHybridArray<ezResourceManagerWorkerUpdateContent*, 16> m_Batch;
+
+private:
+  friend class ezResourceManager;
+  friend class ezResourceManagerState;
+  friend class ezResourceManagerWorkerDataLoad;
+  ezResourceManagerWorkerFinalize();
+
+  virtual void Execute() override;
 };
@@ -135,6 +135,7 @@ private:
   friend class ezResourceManager;
   friend class ezResourceManagerWorkerDataLoad;
   friend class ezResourceManagerWorkerUpdateContent;
+  friend class ezResourceManagerWorkerFinalize;
 
   /// \brief Called by ezResourceManager shortly after resource creation.
   void SetUniqueID(const char* szUniqueID, bool bIsReloadable);
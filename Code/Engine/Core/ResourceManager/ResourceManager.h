@@ -101,6 +101,17 @@ public:
   /// \brief Returns the current loading state of the given resource.
   static ezResourceState GetLoadingState(const ezTypelessResourceHandle& hResource);
 
+  /// \brief Sets how many resources a single data loading task may read, before it hands the file access thread back to the task system.
+  ///
+  /// The resources of one batch are read back to back, then decoded in parallel and finally finished together on the main thread.
+  /// Larger batches save task scheduling overhead when many small resources are queued. A task always stops early after a few
+  /// milliseconds and resources are always taken from the front of the loading queue, so this does not delay high priority resources much.
+  /// A value of 1 loads every resource with its own task.
+  static void SetDataLoadBatchSize(ezUInt32 uiMaxResourcesPerTask);
+
+  /// \brief Returns the value set by SetDataLoadBatchSize().
+  static ezUInt32 GetDataLoadBatchSize();
+
   ///@}
   /// \name Reloading resources
   ///@{
@@ -215,6 +226,9 @@ public:
   static ezMutex& GetMutex() { return s_ResourceMutex; }
 
   /// \brief Must be called once per frame for some bookkeeping.
+  ///
+  /// Also broadcasts the global event 'ezResourceManager_ResourcesQueuedForLoading' with the IDs of all resources that were queued
+  /// for loading since the last call (as an ezVariantArray), so that file providers can prefetch their data.
   static void PerFrameUpdate();
 
   /// \brief Makes sure that no further resource loading will take place.
@@ -395,6 +409,7 @@ private:
   friend class ezResource;
   friend class ezResourceManagerWorkerDataLoad;
   friend class ezResourceManagerWorkerUpdateContent;
+  friend class ezResourceManagerWorkerFinalize;
   friend class ezResourceHandleReadContext;
 
   // Events
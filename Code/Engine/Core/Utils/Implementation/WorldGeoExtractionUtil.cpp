@@ -3,6 +3,7 @@
 #include <Core/Utils/WorldGeoExtractionUtil.h>
 #include <Core/World/World.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Math/Mat3.h>
 #include <Foundation/Utilities/GraphicsUtils.h>
 
@@ -10,6 +11,9 @@ EZ_IMPLEMENT_MESSAGE_TYPE(ezMsgExtractGeometry);
 EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezMsgExtractGeometry, 1, ezRTTIDefaultAllocator<ezMsgExtractGeometry>)
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 
+static const ezUInt32 s_uiMinObjectsPerChunk = 64;
+static const ezUInt32 s_uiMaxChunks = 64;
+
 struct GatherObjectsTraverser
 {
   ezTagSet* m_pExcludeTags = nullptr;
@@ -49,17 +53,77 @@ void ezWorldGeoExtractionUtil::ExtractWorldGeometry(Geometry& geo, const ezWorld
 
   EZ_LOG_BLOCK("ExtractWorldGeometry", world.GetName());
 
-  ezMsgExtractGeometry msg;
-  msg.m_Mode = mode;
-  msg.m_pWorldGeometry = &geo;
+  if (selection.IsEmpty())
+    return;
+
+  // The objects are split into chunks that extract their geometry in parallel. The message handlers only read from the world,
+  // which is allowed from any thread while the read marker is held. Each chunk writes into its own geometry, which are then
+  // appended in chunk order, so the result is the same as sending the messages one after another.
+  const ezUInt32 uiNumObjects = selection.GetCount();
+  const ezUInt32 uiNumChunks = ezMath::Min((uiNumObjects + s_uiMinObjectsPerChunk - 1) / s_uiMinObjectsPerChunk, s_uiMaxChunks);
+  const ezUInt32 uiObjectsPerChunk = (uiNumObjects + uiNumChunks - 1) / uiNumChunks;
+
+  ezDynamicArray<Geometry> chunkGeometry;
+  chunkGeometry.SetCount(uiNumChunks);
+
+  auto extractChunk = [&](ezUInt32 uiChunk, Geometry& chunkGeo) {
+    ezMsgExtractGeometry msg;
+    msg.m_Mode = mode;
+    msg.m_pWorldGeometry = &chunkGeo;
+
+    const ezUInt32 uiFirstObject = uiChunk * uiObjectsPerChunk;
+    const ezUInt32 uiEndObject = ezMath::Min(uiFirstObject + uiObjectsPerChunk, uiNumObjects);
+
+    for (ezUInt32 i = uiFirstObject; i < uiEndObject; ++i)
+    {
+      const ezGameObject* pObject;
+      if (!world.TryGetObject(selection[i], pObject))
+        continue;
+
+      pObject->SendMessage(msg);
+    }
+  };
+
+  if (uiNumChunks == 1)
+  {
+    // nothing to merge, write directly into the output
+    extractChunk(0, geo);
+    return;
+  }
+
+  ezParallelForParams params;
+  params.uiBinSize = 1;
 
-  for (ezGameObjectHandle hObject : selection)
+  ezTaskSystem::ParallelForIndexed(0, uiNumChunks,
+    [&](ezUInt32 uiStartChunk, ezUInt32 uiEndChunk) {
+      for (ezUInt32 uiChunk = uiStartChunk; uiChunk < uiEndChunk; ++uiChunk)
+      {
+        extractChunk(uiChunk, chunkGeometry[uiChunk]);
+      }
+    },
+    "ExtractWorldGeometry", params);
+
+  for (const Geometry& chunkGeo : chunkGeometry)
   {
-    const ezGameObject* pObject;
-    if (!world.TryGetObject(hObject, pObject))
-      continue;
+    const ezUInt32 uiVertexOffset = geo.m_Vertices.GetCount();
 
-    pObject->SendMessage(msg);
+    for (const Vertex& v : chunkGeo.m_Vertices)
+    {
+      geo.m_Vertices.PushBack(v);
+    }
+
+    for (const Triangle& t : chunkGeo.m_Triangles)
+    {
+      Triangle& nt = geo.m_Triangles.ExpandAndGetRef();
+      nt.m_uiVertexIndices[0] = t.m_uiVertexIndices[0] + uiVertexOffset;
+      nt.m_uiVertexIndices[1] = t.m_uiVertexIndices[1] + uiVertexOffset;
+      nt.m_uiVertexIndices[2] = t.m_uiVertexIndices[2] + uiVertexOffset;
+    }
+
+    for (const BoxShape& box : chunkGeo.m_BoxShapes)
+    {
+      geo.m_BoxShapes.PushBack(box);
+    }
   }
 }
 
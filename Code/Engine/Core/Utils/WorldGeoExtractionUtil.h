@@ -68,6 +68,8 @@ public:
   /// \brief Extracts the desired geometry from a specified subset of objects in a world
   ///
   /// The geometry object is not cleared, so this can be called repeatedly to append more data.
+  /// Large selections are split into chunks that send ezMsgExtractGeometry from multiple threads, so message handlers must not
+  /// modify the world or any other shared state. The order of the resulting geometry does not depend on the number of threads.
   static void ExtractWorldGeometry(Geometry& geo, const ezWorld& world, ExtractionMode mode, const ezDeque<ezGameObjectHandle>& selection);
 
   /// \brief Writes the given geometry in .obj format to file
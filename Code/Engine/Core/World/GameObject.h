@@ -501,7 +501,19 @@ private:
     ezSpatialDataHandle m_hSpatialData;
     ezUInt32 m_uiSpatialDataCategoryBitmask;
 
-    ezUInt32 m_uiPadding2[2];
+    struct TransformFlags
+    {
+      enum Enum
+      {
+        LocalChanged = EZ_BIT(0),  ///< The local transform, bounds, velocity or parent changed since the last world update.
+        GlobalChanged = EZ_BIT(1), ///< The global transform was recomputed in the last world update, children have to be recomputed as well.
+      };
+    };
+
+    ezUInt32 m_uiTransformFlags;
+    ezUInt32 m_uiPadding2;
+
+    void MarkLocalChanged();
 
     void UpdateLocalTransform();
 
@@ -511,7 +523,7 @@ private:
 
     void ConditionalUpdateGlobalBounds(ezSpatialSystem* pSpatialSytem);
     void UpdateGlobalBounds();
-    void UpdateGlobalBoundsAndSpatialData(ezSpatialSystem& spatialSytem);
+    bool UpdateGlobalBoundsAndSpatialData(ezSpatialSystem& spatialSytem);
 
     void UpdateVelocity(const ezSimdFloat& fInvDeltaSeconds);
 
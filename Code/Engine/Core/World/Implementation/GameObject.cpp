@@ -206,6 +206,9 @@ void ezGameObject::UpdateGlobalTransformAndBoundsRecursive()
 
   ezSimdTransform oldGlobalTransform = GetGlobalTransformSimd();
 
+  // the world update still has to update the velocity of dynamic objects
+  m_pTransformationData->MarkLocalChanged();
+
   if (m_pTransformationData->m_pParentData != nullptr)
   {
     m_pTransformationData->UpdateGlobalTransformWithParent();
@@ -629,6 +632,7 @@ void ezGameObject::UpdateLocalBounds()
   m_pTransformationData->m_localBounds = ezSimdConversion::ToBBoxSphere(msg.m_ResultingLocalBounds);
   m_pTransformationData->m_localBounds.m_BoxHalfExtents.SetW(msg.m_bAlwaysVisible ? 1.0f : 0.0f);
   m_pTransformationData->m_uiSpatialDataCategoryBitmask = msg.m_uiSpatialDataCategoryBitmask;
+  m_pTransformationData->MarkLocalChanged();
 
   if (IsStatic())
   {
@@ -951,6 +955,8 @@ void ezGameObject::TransformationData::UpdateLocalTransform()
   m_localRotation = tLocal.m_Rotation;
   m_localScaling = tLocal.m_Scale;
   m_localScaling.SetW(1.0f);
+
+  MarkLocalChanged();
 }
 
 void ezGameObject::TransformationData::ConditionalUpdateGlobalTransform()
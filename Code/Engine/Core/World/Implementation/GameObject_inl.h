@@ -245,6 +245,7 @@ EZ_ALWAYS_INLINE ezTransform ezGameObject::GetGlobalTransform() const
 EZ_ALWAYS_INLINE void ezGameObject::SetLocalPosition(const ezSimdVec4f& position, UpdateBehaviorIfStatic updateBehavior)
 {
   m_pTransformationData->m_localPosition = position;
+  m_pTransformationData->MarkLocalChanged();
 
   if (IsStatic() && updateBehavior == UpdateBehaviorIfStatic::UpdateImmediately)
   {
@@ -261,6 +262,7 @@ EZ_ALWAYS_INLINE const ezSimdVec4f& ezGameObject::GetLocalPositionSimd() const
 EZ_ALWAYS_INLINE void ezGameObject::SetLocalRotation(const ezSimdQuat& rotation, UpdateBehaviorIfStatic updateBehavior)
 {
   m_pTransformationData->m_localRotation = rotation;
+  m_pTransformationData->MarkLocalChanged();
 
   if (IsStatic() && updateBehavior == UpdateBehaviorIfStatic::UpdateImmediately)
   {
@@ -279,6 +281,7 @@ EZ_ALWAYS_INLINE void ezGameObject::SetLocalScaling(const ezSimdVec4f& scaling,
   ezSimdFloat uniformScale = m_pTransformationData->m_localScaling.w();
   m_pTransformationData->m_localScaling = scaling;
   m_pTransformationData->m_localScaling.SetW(uniformScale);
+  m_pTransformationData->MarkLocalChanged();
 
   if (IsStatic() && updateBehavior == UpdateBehaviorIfStatic::UpdateImmediately)
   {
@@ -295,6 +298,7 @@ EZ_ALWAYS_INLINE const ezSimdVec4f& ezGameObject::GetLocalScalingSimd() const
 EZ_ALWAYS_INLINE void ezGameObject::SetLocalUniformScaling(const ezSimdFloat& scaling, UpdateBehaviorIfStatic updateBehavior)
 {
   m_pTransformationData->m_localScaling.SetW(scaling);
+  m_pTransformationData->MarkLocalChanged();
 
   if (IsStatic() && updateBehavior == UpdateBehaviorIfStatic::UpdateImmediately)
   {
@@ -389,6 +393,7 @@ EZ_ALWAYS_INLINE const ezSimdTransform& ezGameObject::GetGlobalTransformSimd() c
 EZ_ALWAYS_INLINE void ezGameObject::SetVelocity(const ezVec3& vVelocity)
 {
   m_pTransformationData->m_velocity = ezSimdVec4f(vVelocity.x, vVelocity.y, vVelocity.z, 1.0f);
+  m_pTransformationData->MarkLocalChanged();
 }
 
 EZ_ALWAYS_INLINE ezVec3 ezGameObject::GetVelocity() const
@@ -532,6 +537,11 @@ EZ_ALWAYS_INLINE bool ezGameObject::SendMessageRecursive(ezMessage& msg) const
 
 //////////////////////////////////////////////////////////////////////////
 
+EZ_ALWAYS_INLINE void ezGameObject::TransformationData::MarkLocalChanged()
+{
+  m_uiTransformFlags |= TransformFlags::LocalChanged;
+}
+
 EZ_ALWAYS_INLINE void ezGameObject::TransformationData::UpdateGlobalTransform()
 {
   m_globalTransform.m_Position = m_localPosition;
@@ -554,7 +564,7 @@ EZ_FORCE_INLINE void ezGameObject::TransformationData::UpdateGlobalBounds()
   m_globalBounds.m_BoxHalfExtents.SetW(m_localBounds.m_BoxHalfExtents.w());
 }
 
-EZ_FORCE_INLINE void ezGameObject::TransformationData::UpdateGlobalBoundsAndSpatialData(ezSpatialSystem& spatialSytem)
+EZ_FORCE_INLINE bool ezGameObject::TransformationData::UpdateGlobalBoundsAndSpatialData(ezSpatialSystem& spatialSytem)
 {
   ezSimdBBoxSphere oldGlobalBounds = m_globalBounds;
 
@@ -570,7 +580,10 @@ EZ_FORCE_INLINE void ezGameObject::TransformationData::UpdateGlobalBoundsAndSpat
     bool bIsAlwaysVisible = m_globalBounds.m_BoxHalfExtents.w() != ezSimdFloat::Zero();
 
     UpdateSpatialData(spatialSytem, bWasAlwaysVisible, bIsAlwaysVisible);
+    return true;
   }
+
+  return false;
 }
 
 EZ_ALWAYS_INLINE void ezGameObject::TransformationData::UpdateVelocity(const ezSimdFloat& fInvDeltaSeconds)
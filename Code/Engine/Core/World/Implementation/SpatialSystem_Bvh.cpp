@@ -0,0 +1,754 @@
+#include <CorePCH.h>
+
+#include <Core/World/SpatialSystem_Bvh.h>
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/Threading/TaskSystem.h>
+
+namespace
+{
+  /// \brief Marks stack entries of the visibility traversal whose subtree is known to be completely inside the frustum.
+  static constexpr ezUInt32 s_uiInsideFrustumFlag = 1u << 31;
+
+  /// \brief Minimum number of leaves a visibility task should get, smaller trees are culled serially.
+  static constexpr ezUInt32 s_uiMinLeavesPerBvhCullingTask = 2048;
+
+  ezCVarBool CVarParallelBvhCulling("g_ParallelBvhCulling", true, ezCVarFlags::Default,
+    "Splits large visibility queries of the BVH spatial system across the task system");
+
+  enum class BoxFrustumResult
+  {
+    Outside,
+    Intersecting,
+    Inside
+  };
+
+  /// \brief Half the surface area of a box, used as the cost of a node.
+  EZ_ALWAYS_INLINE float GetBoxCost(const ezSimdBBox& box)
+  {
+    const ezSimdVec4f extents = box.m_Max - box.m_Min;
+    return extents.Dot<3>(extents.Get<ezSwizzle::YZXW>());
+  }
+
+  EZ_ALWAYS_INLINE ezSimdBBox GetUnion(const ezSimdBBox& a, const ezSimdBBox& b)
+  {
+    return ezSimdBBox(a.m_Min.CompMin(b.m_Min), a.m_Max.CompMax(b.m_Max));
+  }
+
+  /// \brief The queries test the bounding sphere of the leaves, so the leaf box has to enclose the sphere and not only the box.
+  EZ_ALWAYS_INLINE ezSimdBBox GetLeafBox(const ezSimdBBoxSphere& bounds)
+  {
+    const ezSimdVec4f halfExtents = bounds.m_BoxHalfExtents.CompMax(bounds.m_CenterAndRadius.Get<ezSwizzle::WWWW>());
+
+    ezSimdBBox box;
+    box.SetCenterAndHalfExtents(bounds.m_CenterAndRadius, halfExtents);
+    return box;
+  }
+} // namespace
+
+struct ezSpatialSystem_Bvh::Node
+{
+  EZ_DECLARE_POD_TYPE();
+
+  EZ_ALWAYS_INLINE bool IsLeaf() const { return m_uiChildren[0] == ezInvalidIndex; }
+
+  ezSimdBBox m_Box;
+  ezSpatialData* m_pData;       ///< Only set for leaves.
+  ezUInt32 m_uiParent;          ///< Next free node if this node is unused.
+  ezUInt32 m_uiChildren[2];     ///< Both ezInvalidIndex for leaves.
+  ezUInt32 m_uiCategoryBitmask; ///< Union of the category bitmasks of all leaves in this subtree.
+  ezInt32 m_iHeight;            ///< 0 for leaves, -1 for unused nodes.
+};
+
+/// \brief The frustum planes transposed into four plus two lanes, together with the absolute values of their normals for box tests.
+struct ezSpatialSystem_Bvh::FrustumPlanes
+{
+  ezSimdVec4f m_x0x1x2x3;
+  ezSimdVec4f m_y0y1y2y3;
+  ezSimdVec4f m_z0z1z2z3;
+  ezSimdVec4f m_w0w1w2w3;
+
+  ezSimdVec4f m_x4x5x4x5;
+  ezSimdVec4f m_y4y5y4y5;
+  ezSimdVec4f m_z4z5z4z5;
+  ezSimdVec4f m_w4w5w4w5;
+
+  ezSimdVec4f m_absX0123;
+  ezSimdVec4f m_absY0123;
+  ezSimdVec4f m_absZ0123;
+
+  ezSimdVec4f m_absX4545;
+  ezSimdVec4f m_absY4545;
+  ezSimdVec4f m_absZ4545;
+
+  EZ_FORCE_INLINE BoxFrustumResult Classify(const ezSimdBBox& box) const
+  {
+    const ezSimdVec4f center = box.GetCenter();
+    const ezSimdVec4f halfExtents = box.GetHalfExtents();
+
+    const ezSimdVec4f cx = center.Get<ezSwizzle::XXXX>();
+    const ezSimdVec4f cy = center.Get<ezSwizzle::YYYY>();
+    const ezSimdVec4f cz = center.Get<ezSwizzle::ZZZZ>();
+    const ezSimdVec4f hx = halfExtents.Get<ezSwizzle::XXXX>();
+    const ezSimdVec4f hy = halfExtents.Get<ezSwizzle::YYYY>();
+    const ezSimdVec4f hz = halfExtents.Get<ezSwizzle::ZZZZ>();
+
+    ezSimdVec4f dist_0123 = ezSimdVec4f::MulAdd(cx, m_x0x1x2x3, m_w0w1w2w3);
+    dist_0123 = ezSimdVec4f::MulAdd(cy, m_y0y1y2y3, dist_0123);
+    dist_0123 = ezSimdVec4f::MulAdd(cz, m_z0z1z2z3, dist_0123);
+
+    ezSimdVec4f dist_4545 = ezSimdVec4f::MulAdd(cx, m_x4x5x4x5, m_w4w5w4w5);
+    dist_4545 = ezSimdVec4f::MulAdd(cy, m_y4y5y4y5, dist_4545);
+    dist_4545 = ezSimdVec4f::MulAdd(cz, m_z4z5z4z5, dist_4545);
+
+    // projected radius of the box onto the plane normals
+    ezSimdVec4f radius_0123 = hx.CompMul(m_absX0123);
+    radius_0123 = ezSimdVec4f::MulAdd(hy, m_absY0123, radius_0123);
+    radius_0123 = ezSimdVec4f::MulAdd(hz, m_absZ0123, radius_0123);
+
+    ezSimdVec4f radius_4545 = hx.CompMul(m_absX4545);
+    radius_4545 = ezSimdVec4f::MulAdd(hy, m_absY4545, radius_4545);
+    radius_4545 = ezSimdVec4f::MulAdd(hz, m_absZ4545, radius_4545);
+
+    // the plane normals point out of the frustum
+    if ((dist_0123 > radius_0123 || dist_4545 > radius_4545).AnySet<4>())
+      return BoxFrustumResult::Outside;
+
+    if ((dist_0123 <= -radius_0123 && dist_4545 <= -radius_4545).AllSet<4>())
+      return BoxFrustumResult::Inside;
+
+    return BoxFrustumResult::Intersecting;
+  }
+
+  EZ_FORCE_INLINE bool Overlaps(const ezSimdBSphere& sphere) const
+  {
+    const ezSimdVec4f cx = sphere.m_CenterAndRadius.Get<ezSwizzle::XXXX>();
+    const ezSimdVec4f cy = sphere.m_CenterAndRadius.Get<ezSwizzle::YYYY>();
+    const ezSimdVec4f cz = sphere.m_CenterAndRadius.Get<ezSwizzle::ZZZZ>();
+    const ezSimdVec4f r = sphere.m_CenterAndRadius.Get<ezSwizzle::WWWW>();
+
+    ezSimdVec4f dist_0123 = ezSimdVec4f::MulAdd(cx, m_x0x1x2x3, m_w0w1w2w3);
+    dist_0123 = ezSimdVec4f::MulAdd(cy, m_y0y1y2y3, dist_0123);
+    dist_0123 = ezSimdVec4f::MulAdd(cz, m_z0z1z2z3, dist_0123);
+
+    ezSimdVec4f dist_4545 = ezSimdVec4f::MulAdd(cx, m_x4x5x4x5, m_w4w5w4w5);
+    dist_4545 = ezSimdVec4f::MulAdd(cy, m_y4y5y4y5, dist_4545);
+    dist_4545 = ezSimdVec4f::MulAdd(cz, m_z4z5z4z5, dist_4545);
+
+    return (dist_0123 > r || dist_4545 > r).NoneSet<4>();
+  }
+};
+
+struct ezSpatialSystem_Bvh::CullingSubtree
+{
+  ezUInt32 m_uiNode = ezInvalidIndex;
+  bool m_bInside = false;
+  ezUInt32 m_uiNumObjectsTested = 0;
+  ezUInt32 m_uiNumObjectsPassed = 0;
+  ezDynamicArray<const ezGameObject*> m_Objects;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+// clang-format off
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezSpatialSystem_Bvh, 1, ezRTTINoAllocator)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+// clang-format on
+
+ezSpatialSystem_Bvh::ezSpatialSystem_Bvh(float fLeafMargin /* = 0.2f */)
+  : m_AlignedAllocator("Spatial System Aligned", ezFoundation::GetAlignedAllocator())
+  , m_fLeafMargin(fLeafMargin)
+  , m_Nodes(&m_AlignedAllocator)
+{
+  EZ_CHECK_AT_COMPILETIME(sizeof(ezUInt32) <= sizeof(ezSpatialData::m_uiUserData));
+}
+
+ezSpatialSystem_Bvh::~ezSpatialSystem_Bvh() = default;
+
+ezUInt32 ezSpatialSystem_Bvh::GetTreeHeight() const
+{
+  return m_uiRootNode != ezInvalidIndex ? m_Nodes[m_uiRootNode].m_iHeight + 1 : 0;
+}
+
+void ezSpatialSystem_Bvh::GetAllNodeBoxes(ezHybridArray<ezBoundingBox, 16>& out_BoundingBoxes, ezSpatialData::Category filterCategory, ezUInt32 uiMaxDepth) const
+{
+  if (m_uiRootNode == ezInvalidIndex)
+    return;
+
+  const ezUInt32 uiCategoryBitmask = filterCategory != ezInvalidSpatialDataCategory ? filterCategory.GetBitmask() : 0xFFFFFFFF;
+
+  ezHybridArray<ezUInt32, 64> stack;
+  ezHybridArray<ezUInt32, 64> depthStack;
+  stack.PushBack(m_uiRootNode);
+  depthStack.PushBack(0);
+
+  while (!stack.IsEmpty())
+  {
+    const Node& node = m_Nodes[stack.PeekBack()];
+    const ezUInt32 uiDepth = depthStack.PeekBack();
+    stack.PopBack();
+    depthStack.PopBack();
+
+    if (node.IsLeaf() || uiDepth > uiMaxDepth || (node.m_uiCategoryBitmask & uiCategoryBitmask) == 0)
+      continue;
+
+    out_BoundingBoxes.PushBack(ezSimdConversion::ToBBox(node.m_Box));
+
+    for (ezUInt32 uiChild : node.m_uiChildren)
+    {
+      stack.PushBack(uiChild);
+      depthStack.PushBack(uiDepth + 1);
+    }
+  }
+}
+
+void ezSpatialSystem_Bvh::FindObjectsInSphereInternal(const ezBoundingSphere& sphere, ezUInt32 uiCategoryBitmask, QueryCallback callback,
+  QueryStats* pStats) const
+{
+  if (m_uiRootNode == ezInvalidIndex)
+    return;
+
+  const ezSimdBSphere simdSphere(ezSimdConversion::ToVec3(sphere.m_vCenter), sphere.m_fRadius);
+
+  ezHybridArray<ezUInt32, 64> stack;
+  stack.PushBack(m_uiRootNode);
+
+  while (!stack.IsEmpty())
+  {
+    const Node& node = m_Nodes[stack.PeekBack()];
+    stack.PopBack();
+
+    if ((node.m_uiCategoryBitmask & uiCategoryBitmask) == 0 || !node.m_Box.Overlaps(simdSphere))
+      continue;
+
+    if (!node.IsLeaf())
+    {
+      stack.PushBack(node.m_uiChildren[1]);
+      stack.PushBack(node.m_uiChildren[0]);
+      continue;
+    }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    if (pStats != nullptr)
+    {
+      pStats->m_uiNumObjectsTested++;
+    }
+#endif
+
+    const ezSpatialData* pData = node.m_pData;
+    if (!simdSphere.Overlaps(pData->m_Bounds.GetSphere()))
+      continue;
+
+    if (callback(pData->m_pObject) == ezVisitorExecution::Stop)
+      return;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    if (pStats != nullptr)
+    {
+      pStats->m_uiNumObjectsPassed++;
+    }
+#endif
+  }
+}
+
+void ezSpatialSystem_Bvh::FindObjectsInBoxInternal(const ezBoundingBox& box, ezUInt32 uiCategoryBitmask, QueryCallback callback, QueryStats* pStats) const
+{
+  if (m_uiRootNode == ezInvalidIndex)
+    return;
+
+  const ezSimdBBox simdBox(ezSimdConversion::ToVec3(box.m_vMin), ezSimdConversion::ToVec3(box.m_vMax));
+
+  ezHybridArray<ezUInt32, 64> stack;
+  stack.PushBack(m_uiRootNode);
+
+  while (!stack.IsEmpty())
+  {
+    const Node& node = m_Nodes[stack.PeekBack()];
+    stack.PopBack();
+
+    if ((node.m_uiCategoryBitmask & uiCategoryBitmask) == 0 || !node.m_Box.Overlaps(simdBox))
+      continue;
+
+    if (!node.IsLeaf())
+    {
+      stack.PushBack(node.m_uiChildren[1]);
+      stack.PushBack(node.m_uiChildren[0]);
+      continue;
+    }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    if (pStats != nullptr)
+    {
+      pStats->m_uiNumObjectsTested++;
+    }
+#endif
+
+    const ezSpatialData* pData = node.m_pData;
+    if (!simdBox.Overlaps(pData->m_Bounds.GetSphere()) || !simdBox.Overlaps(pData->m_Bounds.GetBox()))
+      continue;
+
+    if (callback(pData->m_pObject) == ezVisitorExecution::Stop)
+      return;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    if (pStats != nullptr)
+    {
+      pStats->m_uiNumObjectsPassed++;
+    }
+#endif
+  }
+}
+
+void ezSpatialSystem_Bvh::FindVisibleObjectsInternal(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects,
+  QueryStats* pStats) const
+{
+  if (m_uiRootNode == ezInvalidIndex)
+    return;
+
+  FrustumPlanes planes;
+  {
+    ezSimdVec4f plane0 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(0).m_vNormal.x)));
+    ezSimdVec4f plane1 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(1).m_vNormal.x)));
+    ezSimdVec4f plane2 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(2).m_vNormal.x)));
+    ezSimdVec4f plane3 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(3).m_vNormal.x)));
+    ezSimdVec4f plane4 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(4).m_vNormal.x)));
+    ezSimdVec4f plane5 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(5).m_vNormal.x)));
+
+    ezSimdMat4f helperMat;
+    helperMat.SetRows(plane0, plane1, plane2, plane3);
+
+    planes.m_x0x1x2x3 = helperMat.m_col0;
+    planes.m_y0y1y2y3 = helperMat.m_col1;
+    planes.m_z0z1z2z3 = helperMat.m_col2;
+    planes.m_w0w1w2w3 = helperMat.m_col3;
+
+    helperMat.SetRows(plane4, plane5, plane4, plane5);
+
+    planes.m_x4x5x4x5 = helperMat.m_col0;
+    planes.m_y4y5y4y5 = helperMat.m_col1;
+    planes.m_z4z5z4z5 = helperMat.m_col2;
+    planes.m_w4w5w4w5 = helperMat.m_col3;
+
+    planes.m_absX0123 = planes.m_x0x1x2x3.Abs();
+    planes.m_absY0123 = planes.m_y0y1y2y3.Abs();
+    planes.m_absZ0123 = planes.m_z0z1z2z3.Abs();
+
+    planes.m_absX4545 = planes.m_x4x5x4x5.Abs();
+    planes.m_absY4545 = planes.m_y4y5y4y5.Abs();
+    planes.m_absZ4545 = planes.m_z4z5z4z5.Abs();
+  }
+
+  ezUInt32 uiNumObjectsTested = 0;
+  ezUInt32 uiNumObjectsPassed = 0;
+  ezUInt32 uiNumTasks = 0;
+
+  const ezUInt32 uiMaxNumTasks = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks) + 1;
+  if (CVarParallelBvhCulling && uiMaxNumTasks > 1 && m_uiNumLeaves >= 2 * s_uiMinLeavesPerBvhCullingTask)
+  {
+    // Cull the top of the tree serially, level by level, until there are enough visible subtrees to keep all threads busy.
+    // Every subtree writes into its own array, merging them in order gives the same result as the serial path.
+    const ezUInt32 uiMaxNumSubtrees = ezMath::Min(uiMaxNumTasks * 4, m_uiNumLeaves / s_uiMinLeavesPerBvhCullingTask);
+
+    ezHybridArray<CullingSubtree, 64> subtrees;
+    ezHybridArray<CullingSubtree, 64> nextLevel;
+    subtrees.ExpandAndGetRef().m_uiNode = m_uiRootNode;
+
+    bool bExpanded = true;
+    while (bExpanded && subtrees.GetCount() < uiMaxNumSubtrees)
+    {
+      bExpanded = false;
+      nextLevel.Clear();
+
+      for (const CullingSubtree& subtree : subtrees)
+      {
+        const Node& node = m_Nodes[subtree.m_uiNode];
+        if ((node.m_uiCategoryBitmask & uiCategoryBitmask) == 0)
+          continue;
+
+        bool bInside = subtree.m_bInside;
+        if (!bInside)
+        {
+          const BoxFrustumResult result = planes.Classify(node.m_Box);
+          if (result == BoxFrustumResult::Outside)
+            continue;
+
+          bInside = (result == BoxFrustumResult::Inside);
+        }
+
+        if (node.IsLeaf())
+        {
+          CullingSubtree& leaf = nextLevel.ExpandAndGetRef();
+          leaf.m_uiNode = subtree.m_uiNode;
+          leaf.m_bInside = bInside;
+          continue;
+        }
+
+        for (ezUInt32 uiChild : node.m_uiChildren)
+        {
+          CullingSubtree& child = nextLevel.ExpandAndGetRef();
+          child.m_uiNode = uiChild;
+          child.m_bInside = bInside;
+        }
+
+        bExpanded = true;
+      }
+
+      subtrees.Swap(nextLevel);
+    }
+
+    uiNumTasks = subtrees.GetCount();
+
+    ezParallelForParams params;
+    params.uiBinSize = 1;
+    params.uiMaxTasksPerThread = 4;
+
+    ezTaskSystem::ParallelForIndexed(0, uiNumTasks,
+      [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+        {
+          CullingSubtree& subtree = subtrees[i];
+          subtree.m_uiNumObjectsPassed =
+            FindVisibleObjectsInSubtree(subtree.m_uiNode, subtree.m_bInside, uiCategoryBitmask, planes, subtree.m_Objects, subtree.m_uiNumObjectsTested);
+        }
+      },
+      "SpatialSystem_Bvh::FindVisibleObjects", params);
+
+    for (const CullingSubtree& subtree : subtrees)
+    {
+      out_Objects.PushBackRange(subtree.m_Objects);
+      uiNumObjectsTested += subtree.m_uiNumObjectsTested;
+      uiNumObjectsPassed += subtree.m_uiNumObjectsPassed;
+    }
+  }
+  else
+  {
+    uiNumObjectsPassed = FindVisibleObjectsInSubtree(m_uiRootNode, false, uiCategoryBitmask, planes, out_Objects, uiNumObjectsTested);
+  }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (pStats != nullptr)
+  {
+    pStats->m_uiNumObjectsTested = uiNumObjectsTested;
+    pStats->m_uiNumObjectsPassed = uiNumObjectsPassed;
+    pStats->m_uiNumTasks = uiNumTasks;
+  }
+#endif
+}
+
+ezUInt32 ezSpatialSystem_Bvh::FindVisibleObjectsInSubtree(ezUInt32 uiNode, bool bInside, ezUInt32 uiCategoryBitmask, const FrustumPlanes& planes,
+  ezDynamicArray<const ezGameObject*>& out_Objects, ezUInt32& inout_uiNumObjectsTested) const
+{
+  ezUInt32 uiNumObjectsPassed = 0;
+
+  ezHybridArray<ezUInt32, 64> stack;
+  stack.PushBack(bInside ? (uiNode | s_uiInsideFrustumFlag) : uiNode);
+
+  while (!stack.IsEmpty())
+  {
+    const ezUInt32 uiEntry = stack.PeekBack();
+    stack.PopBack();
+
+    const Node& node = m_Nodes[uiEntry & ~s_uiInsideFrustumFlag];
+    if ((node.m_uiCategoryBitmask & uiCategoryBitmask) == 0)
+      continue;
+
+    ezUInt32 uiInsideFlag = uiEntry & s_uiInsideFrustumFlag;
+
+    if (node.IsLeaf())
+    {
+      // the leaf box encloses the bounding sphere, so if it is inside the sphere test would pass as well
+      if (uiInsideFlag == 0)
+      {
+        ++inout_uiNumObjectsTested;
+
+        if (!planes.Overlaps(node.m_pData->m_Bounds.GetSphere()))
+          continue;
+      }
+
+      out_Objects.PushBack(node.m_pData->m_pObject);
+      ++uiNumObjectsPassed;
+      continue;
+    }
+
+    if (uiInsideFlag == 0)
+    {
+      const BoxFrustumResult result = planes.Classify(node.m_Box);
+      if (result == BoxFrustumResult::Outside)
+        continue;
+
+      if (result == BoxFrustumResult::Inside)
+      {
+        uiInsideFlag = s_uiInsideFrustumFlag;
+      }
+    }
+
+    stack.PushBack(node.m_uiChildren[1] | uiInsideFlag);
+    stack.PushBack(node.m_uiChildren[0] | uiInsideFlag);
+  }
+
+  return uiNumObjectsPassed;
+}
+
+void ezSpatialSystem_Bvh::SpatialDataAdded(ezSpatialData* pData)
+{
+  const ezUInt32 uiLeaf = AllocateNode();
+
+  Node& leaf = m_Nodes[uiLeaf];
+  leaf.m_pData = pData;
+  leaf.m_uiCategoryBitmask = pData->m_uiCategoryBitmask;
+  ComputeFatBox(pData->m_Bounds, leaf.m_Box);
+
+  pData->m_uiUserData[0] = uiLeaf;
+
+  InsertLeaf(uiLeaf);
+  ++m_uiNumLeaves;
+}
+
+void ezSpatialSystem_Bvh::SpatialDataRemoved(ezSpatialData* pData)
+{
+  const ezUInt32 uiLeaf = pData->m_uiUserData[0];
+  EZ_ASSERT_DEBUG(m_Nodes[uiLeaf].m_pData == pData, "Implementation error");
+
+  RemoveLeaf(uiLeaf);
+  FreeNode(uiLeaf);
+  --m_uiNumLeaves;
+}
+
+void ezSpatialSystem_Bvh::SpatialDataChanged(ezSpatialData* pData, const ezSimdBBoxSphere& oldBounds, ezUInt32 uiOldCategoryBitmask)
+{
+  const ezUInt32 uiLeaf = pData->m_uiUserData[0];
+  Node& leaf = m_Nodes[uiLeaf];
+  EZ_ASSERT_DEBUG(leaf.m_pData == pData, "Implementation error");
+
+  if (pData->m_uiCategoryBitmask == uiOldCategoryBitmask)
+  {
+    // Small movements stay within the enlarged leaf box and don't change the tree at all
+    if (leaf.m_Box.Contains(GetLeafBox(pData->m_Bounds)))
+      return;
+  }
+
+  RemoveLeaf(uiLeaf);
+
+  Node& movedLeaf = m_Nodes[uiLeaf];
+  movedLeaf.m_uiCategoryBitmask = pData->m_uiCategoryBitmask;
+  ComputeFatBox(pData->m_Bounds, movedLeaf.m_Box);
+
+  InsertLeaf(uiLeaf);
+}
+
+void ezSpatialSystem_Bvh::FixSpatialDataPointer(ezSpatialData* pOldPtr, ezSpatialData* pNewPtr)
+{
+  Node& leaf = m_Nodes[pNewPtr->m_uiUserData[0]];
+  EZ_ASSERT_DEBUG(leaf.m_pData == pOldPtr, "Implementation error");
+
+  leaf.m_pData = pNewPtr;
+}
+
+ezUInt32 ezSpatialSystem_Bvh::AllocateNode()
+{
+  ezUInt32 uiNode = m_uiFirstFreeNode;
+  if (uiNode != ezInvalidIndex)
+  {
+    m_uiFirstFreeNode = m_Nodes[uiNode].m_uiParent;
+  }
+  else
+  {
+    uiNode = m_Nodes.GetCount();
+    m_Nodes.ExpandAndGetRef();
+  }
+
+  Node& node = m_Nodes[uiNode];
+  node.m_pData = nullptr;
+  node.m_uiParent = ezInvalidIndex;
+  node.m_uiChildren[0] = ezInvalidIndex;
+  node.m_uiChildren[1] = ezInvalidIndex;
+  node.m_uiCategoryBitmask = 0;
+  node.m_iHeight = 0;
+
+  return uiNode;
+}
+
+void ezSpatialSystem_Bvh::FreeNode(ezUInt32 uiNode)
+{
+  Node& node = m_Nodes[uiNode];
+  node.m_pData = nullptr;
+  node.m_uiParent = m_uiFirstFreeNode;
+  node.m_iHeight = -1;
+
+  m_uiFirstFreeNode = uiNode;
+}
+
+void ezSpatialSystem_Bvh::InsertLeaf(ezUInt32 uiLeaf)
+{
+  if (m_uiRootNode == ezInvalidIndex)
+  {
+    m_uiRootNode = uiLeaf;
+    m_Nodes[uiLeaf].m_uiParent = ezInvalidIndex;
+    return;
+  }
+
+  // Walk down to the sibling that adds the least surface area to the tree
+  const ezSimdBBox leafBox = m_Nodes[uiLeaf].m_Box;
+
+  ezUInt32 uiSibling = m_uiRootNode;
+  while (!m_Nodes[uiSibling].IsLeaf())
+  {
+    const Node& node = m_Nodes[uiSibling];
+
+    const float fCombinedCost = GetBoxCost(GetUnion(node.m_Box, leafBox));
+
+    // cost of making a new parent for this node and the new leaf
+    const float fCost = 2.0f * fCombinedCost;
+
+    // minimum cost of pushing the leaf further down the tree
+    const float fInheritanceCost = 2.0f * (fCombinedCost - GetBoxCost(node.m_Box));
+
+    float fChildCosts[2];
+    for (ezUInt32 i = 0; i < 2; ++i)
+    {
+      const Node& child = m_Nodes[node.m_uiChildren[i]];
+      fChildCosts[i] = GetBoxCost(GetUnion(child.m_Box, leafBox)) + fInheritanceCost;
+      if (!child.IsLeaf())
+      {
+        fChildCosts[i] -= GetBoxCost(child.m_Box);
+      }
+    }
+
+    if (fCost < fChildCosts[0] && fCost < fChildCosts[1])
+      break;
+
+    uiSibling = node.m_uiChildren[fChildCosts[0] < fChildCosts[1] ? 0 : 1];
+  }
+
+  // Create a new parent for the sibling and the leaf, the node array might grow so no references are kept across this
+  const ezUInt32 uiOldParent = m_Nodes[uiSibling].m_uiParent;
+  const ezUInt32 uiNewParent = AllocateNode();
+
+  {
+    Node& newParent = m_Nodes[uiNewParent];
+    newParent.m_uiParent = uiOldParent;
+    newParent.m_uiChildren[0] = uiSibling;
+    newParent.m_uiChildren[1] = uiLeaf;
+  }
+
+  if (uiOldParent != ezInvalidIndex)
+  {
+    Node& oldParent = m_Nodes[uiOldParent];
+    oldParent.m_uiChildren[oldParent.m_uiChildren[0] == uiSibling ? 0 : 1] = uiNewParent;
+  }
+  else
+  {
+    m_uiRootNode = uiNewParent;
+  }
+
+  m_Nodes[uiSibling].m_uiParent = uiNewParent;
+  m_Nodes[uiLeaf].m_uiParent = uiNewParent;
+
+  // Refit and rebalance all ancestors
+  ezUInt32 uiNode = uiNewParent;
+  while (uiNode != ezInvalidIndex)
+  {
+    uiNode = Balance(uiNode);
+    Refit(uiNode);
+    uiNode = m_Nodes[uiNode].m_uiParent;
+  }
+}
+
+void ezSpatialSystem_Bvh::RemoveLeaf(ezUInt32 uiLeaf)
+{
+  if (uiLeaf == m_uiRootNode)
+  {
+    m_uiRootNode = ezInvalidIndex;
+    return;
+  }
+
+  const ezUInt32 uiParent = m_Nodes[uiLeaf].m_uiParent;
+  const ezUInt32 uiGrandParent = m_Nodes[uiParent].m_uiParent;
+  const ezUInt32 uiSibling = m_Nodes[uiParent].m_uiChildren[m_Nodes[uiParent].m_uiChildren[0] == uiLeaf ? 1 : 0];
+
+  // The sibling takes the place of the parent
+  m_Nodes[uiSibling].m_uiParent = uiGrandParent;
+  m_Nodes[uiLeaf].m_uiParent = ezInvalidIndex;
+  FreeNode(uiParent);
+
+  if (uiGrandParent == ezInvalidIndex)
+  {
+    m_uiRootNode = uiSibling;
+    return;
+  }
+
+  Node& grandParent = m_Nodes[uiGrandParent];
+  grandParent.m_uiChildren[grandParent.m_uiChildren[0] == uiParent ? 0 : 1] = uiSibling;
+
+  ezUInt32 uiNode = uiGrandParent;
+  while (uiNode != ezInvalidIndex)
+  {
+    uiNode = Balance(uiNode);
+    Refit(uiNode);
+    uiNode = m_Nodes[uiNode].m_uiParent;
+  }
+}
+
+void ezSpatialSystem_Bvh::Refit(ezUInt32 uiNode)
+{
+  Node& node = m_Nodes[uiNode];
+  const Node& child0 = m_Nodes[node.m_uiChildren[0]];
+  const Node& child1 = m_Nodes[node.m_uiChildren[1]];
+
+  node.m_Box = GetUnion(child0.m_Box, child1.m_Box);
+  node.m_uiCategoryBitmask = child0.m_uiCategoryBitmask | child1.m_uiCategoryBitmask;
+  node.m_iHeight = ezMath::Max(child0.m_iHeight, child1.m_iHeight) + 1;
+}
+
+ezUInt32 ezSpatialSystem_Bvh::Balance(ezUInt32 uiA)
+{
+  Node& a = m_Nodes[uiA];
+  if (a.IsLeaf() || a.m_iHeight < 2)
+    return uiA;
+
+  const ezInt32 iBalance = m_Nodes[a.m_uiChildren[1]].m_iHeight - m_Nodes[a.m_uiChildren[0]].m_iHeight;
+  if (iBalance >= -1 && iBalance <= 1)
+    return uiA;
+
+  // Rotate the higher child B up, A takes the place of B's lower child
+  const ezUInt32 uiHigherChild = iBalance > 1 ? 1 : 0;
+  const ezUInt32 uiB = a.m_uiChildren[uiHigherChild];
+  Node& b = m_Nodes[uiB];
+
+  const ezUInt32 uiF = b.m_uiChildren[0];
+  const ezUInt32 uiG = b.m_uiChildren[1];
+  const bool bKeepF = m_Nodes[uiF].m_iHeight > m_Nodes[uiG].m_iHeight;
+  const ezUInt32 uiKept = bKeepF ? uiF : uiG;
+  const ezUInt32 uiMoved = bKeepF ? uiG : uiF;
+
+  b.m_uiChildren[0] = uiA;
+  b.m_uiChildren[1] = uiKept;
+  b.m_uiParent = a.m_uiParent;
+  a.m_uiParent = uiB;
+
+  if (b.m_uiParent != ezInvalidIndex)
+  {
+    Node& parent = m_Nodes[b.m_uiParent];
+    parent.m_uiChildren[parent.m_uiChildren[0] == uiA ? 0 : 1] = uiB;
+  }
+  else
+  {
+    m_uiRootNode = uiB;
+  }
+
+  a.m_uiChildren[uiHigherChild] = uiMoved;
+  m_Nodes[uiMoved].m_uiParent = uiA;
+
+  Refit(uiA);
+  Refit(uiB);
+
+  return uiB;
+}
+
+void ezSpatialSystem_Bvh::ComputeFatBox(const ezSimdBBoxSphere& bounds, ezSimdBBox& out_Box) const
+{
+  out_Box = GetLeafBox(bounds);
+  out_Box.Grow(out_Box.GetHalfExtents() * m_fLeafMargin);
+}
+
+EZ_STATICLINK_FILE(Core, Core_World_Implementation_SpatialSystem_Bvh);
@@ -1,8 +1,10 @@
 #include <CorePCH.h>
 
 #include <Core/World/SpatialSystem_RegularGrid.h>
+#include <Foundation/Configuration/CVar.h>
 #include <Foundation/Containers/HashSet.h>
 #include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/Threading/TaskSystem.h>
 
 namespace
 {
@@ -75,50 +77,182 @@ namespace
     return (cmp_0123 || cmp_4545).NoneSet<4>();
   }
 
-  EZ_FORCE_INLINE ezUInt32 SphereFrustumIntersect(const ezSimdBSphere& sphereA, const ezSimdBSphere& sphereB, const PlaneData& planeData)
+  /// \brief The frustum planes with each plane component broadcast into all four lanes, used to test four spheres against a plane at once.
+  struct FrustumPlanesSoA
   {
-    ezSimdVec4f posA_xxxx(sphereA.m_CenterAndRadius.x());
-    ezSimdVec4f posA_yyyy(sphereA.m_CenterAndRadius.y());
-    ezSimdVec4f posA_zzzz(sphereA.m_CenterAndRadius.z());
-    ezSimdVec4f posA_rrrr(sphereA.m_CenterAndRadius.w());
+    ezSimdVec4f m_x[6];
+    ezSimdVec4f m_y[6];
+    ezSimdVec4f m_z[6];
+    ezSimdVec4f m_w[6];
+  };
+
+} // namespace
+
+// Cell stores these, so they cannot live in the anonymous namespace.
+namespace ezRegularGridInternal
+{
+  /// \brief Four bounding spheres stored as structure of arrays.
+  struct SphereBlock
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    float m_x[4];
+    float m_y[4];
+    float m_z[4];
+    float m_r[4];
+  };
+
+  /// \brief Stores bounding spheres in blocks of four as structure of arrays, so that culling can test four spheres per plane at once.
+  ///
+  /// Lanes beyond GetCount() in the last block are unused and have to be masked out by the caller.
+  class BoundingSphereArray
+  {
+  public:
+    BoundingSphereArray(ezAllocatorBase* pAllocator)
+      : m_Blocks(pAllocator)
+    {
+    }
+
+    EZ_ALWAYS_INLINE ezUInt32 GetCount() const { return m_uiCount; }
+    EZ_ALWAYS_INLINE ezUInt32 GetBlockCount() const { return m_Blocks.GetCount(); }
+    EZ_ALWAYS_INLINE const SphereBlock& GetBlock(ezUInt32 uiBlockIndex) const { return m_Blocks[uiBlockIndex]; }
+
+    EZ_FORCE_INLINE ezSimdBSphere operator[](ezUInt32 uiIndex) const
+    {
+      const SphereBlock& block = m_Blocks[uiIndex / 4];
+      const ezUInt32 uiLane = uiIndex % 4;
+
+      return ezSimdBSphere(ezSimdVec4f(block.m_x[uiLane], block.m_y[uiLane], block.m_z[uiLane]), block.m_r[uiLane]);
+    }
 
-    ezSimdVec4f dotA_0123;
-    dotA_0123 = ezSimdVec4f::MulAdd(posA_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
-    dotA_0123 = ezSimdVec4f::MulAdd(posA_yyyy, planeData.m_y0y1y2y3, dotA_0123);
-    dotA_0123 = ezSimdVec4f::MulAdd(posA_zzzz, planeData.m_z0z1z2z3, dotA_0123);
+    EZ_FORCE_INLINE void Set(ezUInt32 uiIndex, const ezSimdBSphere& sphere)
+    {
+      float EZ_ALIGN_16(values[4]);
+      sphere.m_CenterAndRadius.Store<4>(values);
+
+      SphereBlock& block = m_Blocks[uiIndex / 4];
+      const ezUInt32 uiLane = uiIndex % 4;
 
-    ezSimdVec4f posB_xxxx(sphereB.m_CenterAndRadius.x());
-    ezSimdVec4f posB_yyyy(sphereB.m_CenterAndRadius.y());
-    ezSimdVec4f posB_zzzz(sphereB.m_CenterAndRadius.z());
-    ezSimdVec4f posB_rrrr(sphereB.m_CenterAndRadius.w());
+      block.m_x[uiLane] = values[0];
+      block.m_y[uiLane] = values[1];
+      block.m_z[uiLane] = values[2];
+      block.m_r[uiLane] = values[3];
+    }
+
+    EZ_FORCE_INLINE void PushBack(const ezSimdBSphere& sphere)
+    {
+      if (m_uiCount % 4 == 0)
+      {
+        // zero the unused lanes so they never contain denormals or NaNs
+        ezMemoryUtils::ZeroFill(&m_Blocks.ExpandAndGetRef(), 1);
+      }
+
+      Set(m_uiCount, sphere);
+      ++m_uiCount;
+    }
+
+    EZ_FORCE_INLINE void RemoveAtAndSwap(ezUInt32 uiIndex)
+    {
+      const ezUInt32 uiLastIndex = m_uiCount - 1;
+      if (uiIndex != uiLastIndex)
+      {
+        Set(uiIndex, (*this)[uiLastIndex]);
+      }
+
+      --m_uiCount;
+
+      if (m_uiCount % 4 == 0)
+      {
+        m_Blocks.PopBack();
+      }
+    }
 
-    ezSimdVec4f dotB_0123;
-    dotB_0123 = ezSimdVec4f::MulAdd(posB_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
-    dotB_0123 = ezSimdVec4f::MulAdd(posB_yyyy, planeData.m_y0y1y2y3, dotB_0123);
-    dotB_0123 = ezSimdVec4f::MulAdd(posB_zzzz, planeData.m_z0z1z2z3, dotB_0123);
+  private:
+    ezDynamicArray<SphereBlock> m_Blocks;
+    ezUInt32 m_uiCount = 0;
+  };
+} // namespace ezRegularGridInternal
 
-    ezSimdVec4f posAB_xxxx = posA_xxxx.GetCombined<ezSwizzle::XXXX>(posB_xxxx);
-    ezSimdVec4f posAB_yyyy = posA_yyyy.GetCombined<ezSwizzle::XXXX>(posB_yyyy);
-    ezSimdVec4f posAB_zzzz = posA_zzzz.GetCombined<ezSwizzle::XXXX>(posB_zzzz);
-    ezSimdVec4f posAB_rrrr = posA_rrrr.GetCombined<ezSwizzle::XXXX>(posB_rrrr);
+namespace
+{
 
-    ezSimdVec4f dot_A45B45;
-    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_xxxx, planeData.m_x4x5x4x5, planeData.m_w4w5w4w5);
-    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_yyyy, planeData.m_y4y5y4y5, dot_A45B45);
-    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_zzzz, planeData.m_z4z5z4z5, dot_A45B45);
+  EZ_ALWAYS_INLINE ezUInt32 GetLaneMask(const ezSimdVec4b& b)
+  {
+    return (b.x() ? 1 : 0) | (b.y() ? 2 : 0) | (b.z() ? 4 : 0) | (b.w() ? 8 : 0);
+  }
 
-    ezSimdVec4b cmp_A0123 = dotA_0123 > posA_rrrr;
-    ezSimdVec4b cmp_B0123 = dotB_0123 > posB_rrrr;
-    ezSimdVec4b cmp_A45B45 = dot_A45B45 > posAB_rrrr;
+  EZ_ALWAYS_INLINE ezSimdVec4b SpherePlaneOutside(
+    const ezSimdVec4f& x, const ezSimdVec4f& y, const ezSimdVec4f& z, const ezSimdVec4f& r, const FrustumPlanesSoA& planes, ezUInt32 uiPlane)
+  {
+    ezSimdVec4f dist = ezSimdVec4f::MulAdd(x, planes.m_x[uiPlane], planes.m_w[uiPlane]);
+    dist = ezSimdVec4f::MulAdd(y, planes.m_y[uiPlane], dist);
+    dist = ezSimdVec4f::MulAdd(z, planes.m_z[uiPlane], dist);
 
-    ezSimdVec4b cmp_A45 = cmp_A45B45.Get<ezSwizzle::XYXY>();
-    ezSimdVec4b cmp_B45 = cmp_A45B45.Get<ezSwizzle::ZWZW>();
+    return dist > r;
+  }
 
-    ezUInt32 result = (cmp_A0123 || cmp_A45).NoneSet<4>() ? 1 : 0;
-    result |= (cmp_B0123 || cmp_B45).NoneSet<4>() ? 2 : 0;
+  /// \brief Returns a bitmask of the spheres in the block that intersect the frustum.
+  EZ_FORCE_INLINE ezUInt32 SphereFrustumIntersect(const ezRegularGridInternal::SphereBlock& block, const FrustumPlanesSoA& planes)
+  {
+    ezSimdVec4f x, y, z, r;
+    x.Load<4>(block.m_x);
+    y.Load<4>(block.m_y);
+    z.Load<4>(block.m_z);
+    r.Load<4>(block.m_r);
+
+    // unrolled by hand, see PlaneData
+    ezSimdVec4b outside = SpherePlaneOutside(x, y, z, r, planes, 0);
+    outside = outside || SpherePlaneOutside(x, y, z, r, planes, 1);
+    outside = outside || SpherePlaneOutside(x, y, z, r, planes, 2);
+    outside = outside || SpherePlaneOutside(x, y, z, r, planes, 3);
+    outside = outside || SpherePlaneOutside(x, y, z, r, planes, 4);
+    outside = outside || SpherePlaneOutside(x, y, z, r, planes, 5);
+
+    if (outside.AllSet<4>())
+      return 0;
+
+    return GetLaneMask(!outside);
+  }
 
-    return result;
+  /// \brief Tests two blocks at once so the plane tests of both blocks can be interleaved. Returns an 8 bit mask.
+  EZ_FORCE_INLINE ezUInt32 SphereFrustumIntersect(const ezRegularGridInternal::SphereBlock& blockA, const ezRegularGridInternal::SphereBlock& blockB, const FrustumPlanesSoA& planes)
+  {
+    ezSimdVec4f xA, yA, zA, rA;
+    xA.Load<4>(blockA.m_x);
+    yA.Load<4>(blockA.m_y);
+    zA.Load<4>(blockA.m_z);
+    rA.Load<4>(blockA.m_r);
+
+    ezSimdVec4f xB, yB, zB, rB;
+    xB.Load<4>(blockB.m_x);
+    yB.Load<4>(blockB.m_y);
+    zB.Load<4>(blockB.m_z);
+    rB.Load<4>(blockB.m_r);
+
+    ezSimdVec4b outsideA = SpherePlaneOutside(xA, yA, zA, rA, planes, 0);
+    ezSimdVec4b outsideB = SpherePlaneOutside(xB, yB, zB, rB, planes, 0);
+    outsideA = outsideA || SpherePlaneOutside(xA, yA, zA, rA, planes, 1);
+    outsideB = outsideB || SpherePlaneOutside(xB, yB, zB, rB, planes, 1);
+    outsideA = outsideA || SpherePlaneOutside(xA, yA, zA, rA, planes, 2);
+    outsideB = outsideB || SpherePlaneOutside(xB, yB, zB, rB, planes, 2);
+    outsideA = outsideA || SpherePlaneOutside(xA, yA, zA, rA, planes, 3);
+    outsideB = outsideB || SpherePlaneOutside(xB, yB, zB, rB, planes, 3);
+    outsideA = outsideA || SpherePlaneOutside(xA, yA, zA, rA, planes, 4);
+    outsideB = outsideB || SpherePlaneOutside(xB, yB, zB, rB, planes, 4);
+    outsideA = outsideA || SpherePlaneOutside(xA, yA, zA, rA, planes, 5);
+    outsideB = outsideB || SpherePlaneOutside(xB, yB, zB, rB, planes, 5);
+
+    if ((outsideA && outsideB).AllSet<4>())
+      return 0;
+
+    return GetLaneMask(!outsideA) | (GetLaneMask(!outsideB) << 4);
   }
+
+  /// \brief Minimum number of bounding spheres a task has to test, smaller queries are not split.
+  static constexpr ezUInt32 s_uiMinSpheresPerCullingTask = 2048;
+
+  ezCVarBool CVarParallelCulling("g_ParallelVisibilityCulling", true, ezCVarFlags::Default,
+    "Splits large visibility queries of the regular grid spatial system across the task system");
 } // namespace
 
 //////////////////////////////////////////////////////////////////////////
@@ -150,7 +284,7 @@ struct ezSpatialSystem_RegularGrid::Cell
 
     while (m_BoundingSpheres.GetCount() <= highestCategory)
     {
-      m_BoundingSpheres.PushBack(ezDynamicArray<ezSimdBSphere>(pAlignedAllocator));
+      m_BoundingSpheres.PushBack(ezRegularGridInternal::BoundingSphereArray(pAlignedAllocator));
       m_DataPointers.PushBack(ezDynamicArray<ezSpatialData*>(m_DataPointers.GetAllocator()));
     }
 
@@ -253,7 +387,7 @@ struct ezSpatialSystem_RegularGrid::Cell
     ezUInt32 dataIndex = pUserData->m_uiCachedDataIndex;
     EZ_ASSERT_DEBUG(pUserData->m_uiCachedCategory == category, "Implementation error");
 
-    m_BoundingSpheres[category][dataIndex] = pData->m_Bounds.GetSphere();
+    m_BoundingSpheres[category].Set(dataIndex, pData->m_Bounds.GetSphere());
 
     while (mask > 0)
     {
@@ -263,7 +397,7 @@ struct ezSpatialSystem_RegularGrid::Cell
       const bool found = m_DataPointersToIndex[category].TryGetValue(pData, dataIndex);
       EZ_ASSERT_DEBUG(found, "Implementation error");
 
-      m_BoundingSpheres[category][dataIndex] = pData->m_Bounds.GetSphere();
+      m_BoundingSpheres[category].Set(dataIndex, pData->m_Bounds.GetSphere());
     }
   }
 
@@ -272,10 +406,87 @@ struct ezSpatialSystem_RegularGrid::Cell
     return ezSimdConversion::ToBBoxSphere(m_Bounds).GetBox();
   }
 
+  EZ_FORCE_INLINE ezUInt32 GetNumBoundingSpheres(ezUInt32 uiFilteredCategoryBitmask) const
+  {
+    ezUInt32 uiNumSpheres = 0;
+
+    while (uiFilteredCategoryBitmask > 0)
+    {
+      ezUInt32 category = ezMath::FirstBitLow(uiFilteredCategoryBitmask);
+      uiFilteredCategoryBitmask &= uiFilteredCategoryBitmask - 1;
+
+      uiNumSpheres += m_BoundingSpheres[category].GetCount();
+    }
+
+    return uiNumSpheres;
+  }
+
+  /// \brief Appends all objects of the given categories that intersect the frustum to out_Objects and returns the number of objects that passed.
+  EZ_FORCE_INLINE ezUInt32 FindVisibleObjects(
+    ezUInt32 uiFilteredCategoryBitmask, const FrustumPlanesSoA& planes, ezDynamicArray<const ezGameObject*>& out_Objects) const
+  {
+    ezUInt32 uiNumObjectsPassed = 0;
+
+    while (uiFilteredCategoryBitmask > 0)
+    {
+      ezUInt32 category = ezMath::FirstBitLow(uiFilteredCategoryBitmask);
+      uiFilteredCategoryBitmask &= uiFilteredCategoryBitmask - 1;
+
+      auto& boundingSpheres = m_BoundingSpheres[category];
+      auto& dataPointers = m_DataPointers[category];
+
+      const ezUInt32 uiNumSpheres = boundingSpheres.GetCount();
+      const ezUInt32 uiNumBlocks = boundingSpheres.GetBlockCount();
+      ezUInt32 uiBlockIndex = 0;
+
+      // 8 spheres per iteration
+      for (; uiBlockIndex + 1 < uiNumBlocks; uiBlockIndex += 2)
+      {
+        ezUInt32 mask = SphereFrustumIntersect(boundingSpheres.GetBlock(uiBlockIndex), boundingSpheres.GetBlock(uiBlockIndex + 1), planes);
+
+        const ezUInt32 uiFirstIndex = uiBlockIndex * 4;
+        if (uiNumSpheres - uiFirstIndex < 8)
+        {
+          // mask out the unused lanes of the last block
+          mask &= (1u << (uiNumSpheres - uiFirstIndex)) - 1;
+        }
+
+        while (mask > 0)
+        {
+          ezUInt32 i = ezMath::FirstBitLow(mask);
+          mask &= mask - 1;
+
+          out_Objects.PushBack(dataPointers[uiFirstIndex + i]->m_pObject);
+          ++uiNumObjectsPassed;
+        }
+      }
+
+      // remaining block
+      if (uiBlockIndex < uiNumBlocks)
+      {
+        ezUInt32 mask = SphereFrustumIntersect(boundingSpheres.GetBlock(uiBlockIndex), planes);
+
+        const ezUInt32 uiFirstIndex = uiBlockIndex * 4;
+        mask &= (1u << (uiNumSpheres - uiFirstIndex)) - 1;
+
+        while (mask > 0)
+        {
+          ezUInt32 i = ezMath::FirstBitLow(mask);
+          mask &= mask - 1;
+
+          out_Objects.PushBack(dataPointers[uiFirstIndex + i]->m_pObject);
+          ++uiNumObjectsPassed;
+        }
+      }
+    }
+
+    return uiNumObjectsPassed;
+  }
+
   ezSimdBBoxSphere m_Bounds;
   ezUInt32 m_uiCategoryBitmask = 0;
 
-  ezHybridArray<ezDynamicArray<ezSimdBSphere>, 4> m_BoundingSpheres;
+  ezHybridArray<ezRegularGridInternal::BoundingSphereArray, 4> m_BoundingSpheres;
   ezHybridArray<ezDynamicArray<ezSpatialData*>, 4> m_DataPointers;
   ezHybridArray<ezHashTable<ezSpatialData*, ezUInt32>, 4> m_DataPointersToIndex;
 };
@@ -380,7 +591,7 @@ void ezSpatialSystem_RegularGrid::FindObjectsInSphereInternal(const ezBoundingSp
 
       for (ezUInt32 i = 0; i < numSpheres; ++i)
       {
-        auto& objectSphere = boundingSpheres[i];
+        const ezSimdBSphere objectSphere = boundingSpheres[i];
         if (!simdSphere.Overlaps(objectSphere))
           continue;
 
@@ -426,7 +637,7 @@ void ezSpatialSystem_RegularGrid::FindObjectsInBoxInternal(const ezBoundingBox&
 
       for (ezUInt32 i = 0; i < numSpheres; ++i)
       {
-        auto& objectSphere = boundingSpheres[i];
+        const ezSimdBSphere objectSphere = boundingSpheres[i];
         if (!simdBox.Overlaps(objectSphere))
           continue;
 
@@ -490,86 +701,126 @@ void ezSpatialSystem_RegularGrid::FindVisibleObjectsInternal(const ezFrustum& fr
     planeData.m_w4w5w4w5 = helperMat.m_col3;
   }
 
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  FrustumPlanesSoA planes;
+  for (ezUInt32 i = 0; i < 6; ++i)
+  {
+    const ezPlane& plane = frustum.GetPlane(i);
+    planes.m_x[i] = ezSimdVec4f(plane.m_vNormal.x);
+    planes.m_y[i] = ezSimdVec4f(plane.m_vNormal.y);
+    planes.m_z[i] = ezSimdVec4f(plane.m_vNormal.z);
+    planes.m_w[i] = ezSimdVec4f(plane.m_fNegDistance);
+  }
+
+  struct VisibleCell
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    const Cell* m_pCell;
+    ezUInt32 m_uiFilteredCategoryBitmask;
+  };
+
+  ezHybridArray<VisibleCell, 64> visibleCells;
   ezUInt32 uiNumObjectsTested = 0;
-  ezUInt32 uiNumObjectsPassed = 0;
-#endif
 
   ForEachCellInBox(simdBox, uiCategoryBitmask, [&](const ezSimdVec4i& cellIndex, ezUInt64 cellKey, const Cell& cell, ezUInt32 uiFilteredCategoryBitmask) {
     ezSimdBSphere cellSphere = cell.m_Bounds.GetSphere();
     if (!SphereFrustumIntersect(cellSphere, planeData))
       return;
 
-    ezUInt32 filteredMask = uiFilteredCategoryBitmask;
-    while (filteredMask > 0)
-    {
-      ezUInt32 category = ezMath::FirstBitLow(filteredMask);
-      filteredMask &= filteredMask - 1;
+    const ezUInt32 uiNumSpheres = cell.GetNumBoundingSpheres(uiFilteredCategoryBitmask);
+    if (uiNumSpheres == 0)
+      return;
 
-      auto& boundingSpheres = cell.m_BoundingSpheres[category];
-      auto& dataPointers = cell.m_DataPointers[category];
+    auto& visibleCell = visibleCells.ExpandAndGetRef();
+    visibleCell.m_pCell = &cell;
+    visibleCell.m_uiFilteredCategoryBitmask = uiFilteredCategoryBitmask;
 
-      const ezUInt32 numSpheres = boundingSpheres.GetCount();
+    uiNumObjectsTested += uiNumSpheres;
+  });
 
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-      uiNumObjectsTested += numSpheres;
-#endif
-      ezUInt32 currentIndex = 0;
+  ezUInt32 uiNumObjectsPassed = 0;
+  ezUInt32 uiNumTasks = 0;
 
-      while (currentIndex < numSpheres)
-      {
-        if (numSpheres - currentIndex >= 32)
-        {
-          ezUInt32 mask = 0;
+  const ezUInt32 uiMaxNumTasks = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks) + 1;
+  if (CVarParallelCulling && uiMaxNumTasks > 1 && uiNumObjectsTested >= 2 * s_uiMinSpheresPerCullingTask && visibleCells.GetCount() > 1)
+  {
+    uiNumTasks = ezMath::Min(uiNumObjectsTested / s_uiMinSpheresPerCullingTask, uiMaxNumTasks, visibleCells.GetCount());
 
-          for (ezUInt32 i = 0; i < 32; i += 2)
-          {
-            auto& objectSphereA = boundingSpheres[currentIndex + i + 0];
-            auto& objectSphereB = boundingSpheres[currentIndex + i + 1];
+    // Split the visible cells into consecutive ranges with roughly the same number of spheres.
+    // Every range writes into its own array, merging them in order gives the same result as the serial path.
+    struct CullingTask
+    {
+      ezUInt32 m_uiFirstCell = 0;
+      ezUInt32 m_uiNumSpheres = 0;
+      ezUInt32 m_uiNumObjectsPassed = 0;
+      ezDynamicArray<const ezGameObject*> m_Objects;
+    };
 
-            mask |= SphereFrustumIntersect(objectSphereA, objectSphereB, planeData) << i;
-          }
+    ezHybridArray<CullingTask, 16> tasks;
+    tasks.SetCount(uiNumTasks);
 
-          while (mask > 0)
-          {
-            ezUInt32 i = ezMath::FirstBitLow(mask);
-            mask &= mask - 1;
+    {
+      const ezUInt32 uiSpheresPerTask = uiNumObjectsTested / uiNumTasks;
 
-            ezSpatialData* pData = dataPointers[currentIndex + i];
-            out_Objects.PushBack(pData->m_pObject);
+      ezUInt32 uiTaskIndex = 0;
+      for (ezUInt32 i = 0; i < visibleCells.GetCount(); ++i)
+      {
+        if (tasks[uiTaskIndex].m_uiNumSpheres >= uiSpheresPerTask && uiTaskIndex + 1 < uiNumTasks)
+        {
+          ++uiTaskIndex;
+          tasks[uiTaskIndex].m_uiFirstCell = i;
+        }
 
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-            uiNumObjectsPassed++;
-#endif
-          }
+        const VisibleCell& visibleCell = visibleCells[i];
+        tasks[uiTaskIndex].m_uiNumSpheres += visibleCell.m_pCell->GetNumBoundingSpheres(visibleCell.m_uiFilteredCategoryBitmask);
+      }
 
-          currentIndex += 32;
-        }
-        else
-        {
-          ezUInt32 i = currentIndex;
-          ++currentIndex;
+      // the last cells may have ended up in fewer ranges than planned
+      uiNumTasks = uiTaskIndex + 1;
+      tasks.SetCount(uiNumTasks);
+    }
 
-          auto& objectSphere = boundingSpheres[i];
-          if (!SphereFrustumIntersect(objectSphere, planeData))
-            continue;
+    ezParallelForParams params;
+    params.uiBinSize = 1;
+    params.uiMaxTasksPerThread = 1;
 
-          ezSpatialData* pData = dataPointers[i];
-          out_Objects.PushBack(pData->m_pObject);
+    ezTaskSystem::ParallelForIndexed(0, uiNumTasks,
+      [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        for (ezUInt32 uiTaskIndex = uiStartIndex; uiTaskIndex < uiEndIndex; ++uiTaskIndex)
+        {
+          CullingTask& task = tasks[uiTaskIndex];
+          task.m_Objects.Reserve(task.m_uiNumSpheres);
 
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-          uiNumObjectsPassed++;
-#endif
+          const ezUInt32 uiEndCell = (uiTaskIndex + 1 < uiNumTasks) ? tasks[uiTaskIndex + 1].m_uiFirstCell : visibleCells.GetCount();
+          for (ezUInt32 i = task.m_uiFirstCell; i < uiEndCell; ++i)
+          {
+            const VisibleCell& visibleCell = visibleCells[i];
+            task.m_uiNumObjectsPassed += visibleCell.m_pCell->FindVisibleObjects(visibleCell.m_uiFilteredCategoryBitmask, planes, task.m_Objects);
+          }
         }
-      }
+      },
+      "SpatialSystem_RegularGrid::FindVisibleObjects", params);
+
+    for (const CullingTask& task : tasks)
+    {
+      out_Objects.PushBackRange(task.m_Objects);
+      uiNumObjectsPassed += task.m_uiNumObjectsPassed;
     }
-  });
+  }
+  else
+  {
+    for (const VisibleCell& visibleCell : visibleCells)
+    {
+      uiNumObjectsPassed += visibleCell.m_pCell->FindVisibleObjects(visibleCell.m_uiFilteredCategoryBitmask, planes, out_Objects);
+    }
+  }
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   if (pStats != nullptr)
   {
     pStats->m_uiNumObjectsTested = uiNumObjectsTested;
     pStats->m_uiNumObjectsPassed = uiNumObjectsPassed;
+    pStats->m_uiNumTasks = uiNumTasks;
   }
 #endif
 }
@@ -213,6 +213,7 @@ ezGameObjectHandle ezWorld::CreateObject(const ezGameObjectDesc& desc, ezGameObj
   pTransformationData->m_globalBounds = pTransformationData->m_localBounds;
   pTransformationData->m_hSpatialData.Invalidate();
   pTransformationData->m_uiSpatialDataCategoryBitmask = 0;
+  pTransformationData->m_uiTransformFlags = ezGameObject::TransformationData::TransformFlags::LocalChanged;
 
   if (pParentData != nullptr)
   {
@@ -352,15 +353,15 @@ void ezWorld::PostMessage(
   ezRTTIAllocator* pMsgRTTIAllocator = msg.GetDynamicRTTI()->GetAllocator();
   if (delay.GetSeconds() > 0.0)
   {
-    ezMessage* pMsgCopy = pMsgRTTIAllocator->Clone<ezMessage>(&msg, &m_Data.m_Allocator);
+    ezMessage* pMsgCopy = pMsgRTTIAllocator->Clone<ezMessage>(&msg, &m_Data.m_TimedMessageAllocator);
 
     metaData.m_Due = m_Data.m_Clock.GetAccumulatedTime() + delay;
-    m_Data.m_TimedMessageQueues[queueType].Enqueue(pMsgCopy, metaData);
+    m_Data.EnqueueMessage(pMsgCopy, metaData, queueType, true);
   }
   else
   {
     ezMessage* pMsgCopy = pMsgRTTIAllocator->Clone<ezMessage>(&msg, m_Data.m_StackAllocator.GetCurrentAllocator());
-    m_Data.m_MessageQueues[queueType].Enqueue(pMsgCopy, metaData);
+    m_Data.EnqueueMessage(pMsgCopy, metaData, queueType, false);
   }
 }
 
@@ -378,15 +379,15 @@ void ezWorld::PostMessage(const ezComponentHandle& receiverComponent, const ezMe
   ezRTTIAllocator* pMsgRTTIAllocator = msg.GetDynamicRTTI()->GetAllocator();
   if (delay.GetSeconds() > 0.0)
   {
-    ezMessage* pMsgCopy = pMsgRTTIAllocator->Clone<ezMessage>(&msg, &m_Data.m_Allocator);
+    ezMessage* pMsgCopy = pMsgRTTIAllocator->Clone<ezMessage>(&msg, &m_Data.m_TimedMessageAllocator);
 
     metaData.m_Due = m_Data.m_Clock.GetAccumulatedTime() + delay;
-    m_Data.m_TimedMessageQueues[queueType].Enqueue(pMsgCopy, metaData);
+    m_Data.EnqueueMessage(pMsgCopy, metaData, queueType, true);
   }
   else
   {
     ezMessage* pMsgCopy = pMsgRTTIAllocator->Clone<ezMessage>(&msg, m_Data.m_StackAllocator.GetCurrentAllocator());
-    m_Data.m_MessageQueues[queueType].Enqueue(pMsgCopy, metaData);
+    m_Data.EnqueueMessage(pMsgCopy, metaData, queueType, false);
   }
 }
 
@@ -506,6 +507,16 @@ void ezWorld::Update()
 
     EZ_PROFILE_SCOPE("Update Transforms");
     m_Data.UpdateGlobalTransforms(fInvDelta);
+
+    ezStringBuilder sStatName;
+    sStatName.Format("World Update/{0}/Dynamic Transforms", m_Data.m_sName);
+    ezStats::SetStat(sStatName, m_Data.m_uiNumDynamicTransforms);
+
+    sStatName.Format("World Update/{0}/Transforms Updated", m_Data.m_sName);
+    ezStats::SetStat(sStatName, m_Data.m_uiNumTransformsUpdated);
+
+    sStatName.Format("World Update/{0}/Spatial Data Updates", m_Data.m_sName);
+    ezStats::SetStat(sStatName, m_Data.m_uiNumSpatialDataUpdates);
   }
 
   // post-transform phase
@@ -653,6 +664,7 @@ void ezWorld::LinkToParent(ezGameObject* pObject)
     pParentObject->m_ChildCount++;
 
     pObject->m_pTransformationData->m_pParentData = pParentObject->m_pTransformationData;
+    pObject->m_pTransformationData->MarkLocalChanged();
 
     if (pParentObject->m_Flags.IsSet(ezObjectFlags::ChildChangesNotifications))
     {
@@ -687,6 +699,7 @@ void ezWorld::UnlinkFromParent(ezGameObject* pObject)
     pParentObject->m_ChildCount--;
     pObject->m_ParentIndex = 0;
     pObject->m_pTransformationData->m_pParentData = nullptr;
+    pObject->m_pTransformationData->MarkLocalChanged();
 
     // Note that the sibling indices must not be set to 0 here.
     // They are still needed if we currently iterate over child objects.
@@ -828,37 +841,58 @@ void ezWorld::ProcessQueuedMessages(ezObjectMsgQueueType::Enum queueType)
 
   // regular messages
   {
-    ezInternal::WorldData::MessageQueue& queue = m_Data.m_MessageQueues[queueType];
-    queue.Sort(MessageComparer());
+    auto& messages = m_Data.m_MessagesToProcess;
 
-    for (ezUInt32 i = 0; i < queue.GetCount(); ++i)
+    // messages that are posted while processing are processed in the same call, in a sorted batch of their own
+    m_Data.GatherQueuedMessages(queueType, false, messages);
+    while (!messages.IsEmpty())
     {
-      ProcessQueuedMessage(queue[i]);
+      // the messages come from the queues of all threads, sorting makes the processing order independent of who posted them when
+      messages.Sort(MessageComparer());
 
-      // no need to deallocate these messages, they are allocated through a frame allocator
-    }
+      for (ezUInt32 i = 0; i < messages.GetCount(); ++i)
+      {
+        ProcessQueuedMessage(messages[i]);
+
+        // no need to deallocate these messages, they are allocated through a frame allocator
+      }
 
-    queue.Clear();
+      messages.Clear();
+      m_Data.GatherQueuedMessages(queueType, false, messages);
+    }
   }
 
   // timed messages
   {
-    ezInternal::WorldData::MessageQueue& queue = m_Data.m_TimedMessageQueues[queueType];
-    queue.Sort(MessageComparer());
+    auto& messages = m_Data.m_MessagesToProcess;
+    auto& heap = m_Data.m_TimedMessageHeaps[queueType];
+
+    // move the messages that were posted since the last call into the heap, all older messages are already in there
+    m_Data.GatherQueuedMessages(queueType, true, messages);
+    for (const auto& entry : messages)
+    {
+      ezInternal::WorldData::TimedMessage timedMessage;
+      timedMessage.m_Entry = entry;
+      timedMessage.m_iSortingKey = entry.m_pMessage->GetSortingKey();
+      timedMessage.m_uiHash = entry.m_pMessage->GetHash();
+      timedMessage.m_MessageId = entry.m_pMessage->GetId();
+
+      ezInternal::WorldData::PushTimedMessage(heap, timedMessage);
+    }
+
+    messages.Clear();
 
     const ezTime now = m_Data.m_Clock.GetAccumulatedTime();
 
-    while (!queue.IsEmpty())
+    while (!heap.IsEmpty() && heap[0].m_Entry.m_MetaData.m_Due <= now)
     {
-      auto& entry = queue.Peek();
-      if (entry.m_MetaData.m_Due > now)
-        break;
+      // remove the message from the heap first, message handlers might post new messages
+      ezInternal::WorldData::MessageQueue::Entry entry = heap[0].m_Entry;
+      ezInternal::WorldData::PopTimedMessage(heap);
 
       ProcessQueuedMessage(entry);
 
-      EZ_DELETE(&m_Data.m_Allocator, entry.m_pMessage);
-
-      queue.Dequeue();
+      EZ_DELETE(&m_Data.m_TimedMessageAllocator, entry.m_pMessage);
     }
   }
 }
@@ -1299,6 +1333,9 @@ void ezWorld::RecreateHierarchyData(ezGameObject* pObject, bool bWasDynamic)
     ezGameObject::TransformationData* pNewTransformationData = m_Data.CreateTransformationData(bIsDynamic, uiNewHierarchyLevel);
     ezMemoryUtils::Copy(pNewTransformationData, pOldTransformationData, 1);
 
+    // also clears GlobalChanged, which only has a meaning within the old hierarchy
+    pNewTransformationData->m_uiTransformFlags = ezGameObject::TransformationData::TransformFlags::LocalChanged;
+
     pObject->m_uiHierarchyLevel = uiNewHierarchyLevel;
     pObject->m_pTransformationData = pNewTransformationData;
 
@@ -36,6 +36,205 @@ namespace ezInternal
 
   ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+  void WorldData::EnqueueMessage(ezMessage* pMessage, const QueuedMsgMetaData& metaData, ezObjectMsgQueueType::Enum queueType, bool bTimed) const
+  {
+    const ezUInt32 uiThreadIndex = ezInternal::GetStackAllocatorThreadIndex();
+    if (uiThreadIndex == ezInvalidIndex)
+    {
+      MessageQueue& queue = bTimed ? m_TimedMessageQueues[queueType] : m_MessageQueues[queueType];
+      queue.Enqueue(pMessage, metaData);
+      return;
+    }
+
+    ThreadMessageQueues* pQueues = m_ThreadMessageQueues[uiThreadIndex];
+    if (pQueues == nullptr)
+    {
+      // only this thread ever writes this slot
+      ezLocalAllocatorWrapper allocatorWrapper(&m_Allocator);
+      pQueues = EZ_NEW(&m_Allocator, ThreadMessageQueues);
+      allocatorWrapper.Reset();
+
+      m_ThreadMessageQueues[uiThreadIndex] = pQueues;
+    }
+
+    auto& queue = bTimed ? pQueues->m_TimedMessages[queueType] : pQueues->m_Messages[queueType];
+
+    MessageQueue::Entry& entry = queue.ExpandAndGetRef();
+    entry.m_pMessage = pMessage;
+    entry.m_MetaData = metaData;
+  }
+
+  void WorldData::GatherQueuedMessages(ezObjectMsgQueueType::Enum queueType, bool bTimed, ezDynamicArrayBase<MessageQueue::Entry>& out_Messages)
+  {
+    MessageQueue& sharedQueue = bTimed ? m_TimedMessageQueues[queueType] : m_MessageQueues[queueType];
+    for (ezUInt32 i = 0; i < sharedQueue.GetCount(); ++i)
+    {
+      out_Messages.PushBack(sharedQueue[i]);
+    }
+
+    sharedQueue.Clear();
+
+    for (ThreadMessageQueues* pQueues : m_ThreadMessageQueues)
+    {
+      if (pQueues == nullptr)
+        continue;
+
+      auto& queue = bTimed ? pQueues->m_TimedMessages[queueType] : pQueues->m_Messages[queueType];
+      out_Messages.PushBackRange(queue);
+      queue.Clear();
+    }
+  }
+
+  // static
+  EZ_FORCE_INLINE bool WorldData::IsDueBefore(const TimedMessage& a, const TimedMessage& b)
+  {
+    // same order as the comparer for regular messages, but on the cached sort criteria
+    if (a.m_Entry.m_MetaData.m_Due != b.m_Entry.m_MetaData.m_Due)
+      return a.m_Entry.m_MetaData.m_Due < b.m_Entry.m_MetaData.m_Due;
+
+    if (a.m_iSortingKey != b.m_iSortingKey)
+      return a.m_iSortingKey < b.m_iSortingKey;
+
+    if (a.m_MessageId != b.m_MessageId)
+      return a.m_MessageId < b.m_MessageId;
+
+    if (a.m_Entry.m_MetaData.m_uiReceiverData != b.m_Entry.m_MetaData.m_uiReceiverData)
+      return a.m_Entry.m_MetaData.m_uiReceiverData < b.m_Entry.m_MetaData.m_uiReceiverData;
+
+    return a.m_uiHash < b.m_uiHash;
+  }
+
+  // static
+  void WorldData::PushTimedMessage(ezDynamicArrayBase<TimedMessage>& heap, const TimedMessage& timedMessage)
+  {
+    ezUInt32 uiIndex = heap.GetCount();
+    heap.PushBack(timedMessage);
+
+    while (uiIndex > 0)
+    {
+      const ezUInt32 uiParentIndex = (uiIndex - 1) / 2;
+      if (!IsDueBefore(timedMessage, heap[uiParentIndex]))
+        break;
+
+      heap[uiIndex] = heap[uiParentIndex];
+      uiIndex = uiParentIndex;
+    }
+
+    heap[uiIndex] = timedMessage;
+  }
+
+  // static
+  void WorldData::PopTimedMessage(ezDynamicArrayBase<TimedMessage>& heap)
+  {
+    const TimedMessage last = heap.PeekBack();
+    heap.PopBack();
+
+    const ezUInt32 uiCount = heap.GetCount();
+    if (uiCount == 0)
+      return;
+
+    ezUInt32 uiIndex = 0;
+    while (true)
+    {
+      ezUInt32 uiChildIndex = uiIndex * 2 + 1;
+      if (uiChildIndex >= uiCount)
+        break;
+
+      if (uiChildIndex + 1 < uiCount && IsDueBefore(heap[uiChildIndex + 1], heap[uiChildIndex]))
+        ++uiChildIndex;
+
+      if (!IsDueBefore(heap[uiChildIndex], last))
+        break;
+
+      heap[uiIndex] = heap[uiChildIndex];
+      uiIndex = uiChildIndex;
+    }
+
+    heap[uiIndex] = last;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  WorldData::TimedMessageAllocation::TimedMessageAllocation(ezAllocatorBase* pParent)
+    : m_pParent(pParent)
+    , m_pNextFreeInChunk(nullptr)
+    , m_pChunkEnd(nullptr)
+    , m_Chunks(pParent)
+  {
+    for (ezUInt32 i = 0; i < NumSizeClasses; ++i)
+    {
+      m_FreeLists[i] = nullptr;
+    }
+  }
+
+  WorldData::TimedMessageAllocation::~TimedMessageAllocation()
+  {
+    for (void* pChunk : m_Chunks)
+    {
+      m_pParent->Deallocate(pChunk);
+    }
+  }
+
+  void* WorldData::TimedMessageAllocation::Allocate(size_t uiSize, size_t uiAlign)
+  {
+    EZ_ASSERT_DEV(uiAlign <= Alignment && Alignment % uiAlign == 0, "Unsupported alignment {0}", ((ezUInt32)uiAlign));
+
+    const ezUInt32 uiSizeClass = static_cast<ezUInt32>((uiSize + SizeClassGranularity - 1) / SizeClassGranularity) - 1;
+    if (uiSizeClass >= NumSizeClasses)
+    {
+      ezUInt8* pMemory = static_cast<ezUInt8*>(m_pParent->Allocate(HeaderSize + uiSize, Alignment));
+      *reinterpret_cast<ezUInt32*>(pMemory) = LargeAllocation;
+      return pMemory + HeaderSize;
+    }
+
+    const ezUInt32 uiSlotSize = HeaderSize + (uiSizeClass + 1) * SizeClassGranularity;
+
+    EZ_LOCK(m_Mutex);
+
+    ezUInt8* pSlot = static_cast<ezUInt8*>(m_FreeLists[uiSizeClass]);
+    if (pSlot != nullptr)
+    {
+      // the next pointer of the free list is stored in the payload of a free slot
+      m_FreeLists[uiSizeClass] = *reinterpret_cast<void**>(pSlot + HeaderSize);
+    }
+    else
+    {
+      if (m_pNextFreeInChunk + uiSlotSize > m_pChunkEnd)
+      {
+        // the remainder of the current chunk is wasted, that is at most one slot of the largest size class
+        m_pNextFreeInChunk = static_cast<ezUInt8*>(m_pParent->Allocate(ChunkSize, Alignment));
+        m_pChunkEnd = m_pNextFreeInChunk + ChunkSize;
+        m_Chunks.PushBack(m_pNextFreeInChunk);
+      }
+
+      pSlot = m_pNextFreeInChunk;
+      m_pNextFreeInChunk += uiSlotSize;
+
+      *reinterpret_cast<ezUInt32*>(pSlot) = uiSizeClass;
+    }
+
+    return pSlot + HeaderSize;
+  }
+
+  void WorldData::TimedMessageAllocation::Deallocate(void* ptr)
+  {
+    ezUInt8* pSlot = static_cast<ezUInt8*>(ptr) - HeaderSize;
+    const ezUInt32 uiSizeClass = *reinterpret_cast<ezUInt32*>(pSlot);
+
+    if (uiSizeClass == LargeAllocation)
+    {
+      m_pParent->Deallocate(pSlot);
+      return;
+    }
+
+    EZ_LOCK(m_Mutex);
+
+    *reinterpret_cast<void**>(ptr) = m_FreeLists[uiSizeClass];
+    m_FreeLists[uiSizeClass] = pSlot;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
   WorldData::WorldData(ezWorldDesc& desc)
     : m_sName(desc.m_sName)
     , m_Allocator(desc.m_sName, ezFoundation::GetDefaultAllocator())
@@ -45,6 +244,7 @@ namespace ezInternal
     , m_ObjectStorage(&m_BlockAllocator, &m_Allocator)
     , m_MaxInitializationTimePerFrame(desc.m_MaxComponentInitializationTimePerFrame)
     , m_Clock(desc.m_sName)
+    , m_TimedMessageAllocator("TimedMessages", &m_Allocator)
     , m_WriteThreadID((ezThreadID)0)
     , m_iWriteCounter(0)
     , m_bSimulateWorld(true)
@@ -147,11 +347,38 @@ namespace ezInternal
         while (!queue.IsEmpty())
         {
           MessageQueue::Entry& entry = queue.Peek();
-          EZ_DELETE(&m_Allocator, entry.m_pMessage);
+          EZ_DELETE(&m_TimedMessageAllocator, entry.m_pMessage);
 
           queue.Dequeue();
         }
       }
+
+      for (ThreadMessageQueues* pQueues : m_ThreadMessageQueues)
+      {
+        if (pQueues == nullptr)
+          continue;
+
+        // regular messages are allocated through a frame allocator, see above
+        for (auto& entry : pQueues->m_TimedMessages[i])
+        {
+          EZ_DELETE(&m_TimedMessageAllocator, entry.m_pMessage);
+        }
+      }
+
+      {
+        auto& heap = m_TimedMessageHeaps[i];
+        for (auto& timedMessage : heap)
+        {
+          EZ_DELETE(&m_TimedMessageAllocator, timedMessage.m_Entry.m_pMessage);
+        }
+
+        heap.Clear();
+      }
+    }
+
+    for (ThreadMessageQueues*& pQueues : m_ThreadMessageQueues)
+    {
+      EZ_DELETE(&m_Allocator, pQueues);
     }
   }
 
@@ -286,17 +513,23 @@ namespace ezInternal
     {
       ezSimdFloat m_fInvDt;
       ezSpatialSystem* m_pSpatialSystem;
+      ezAtomicInteger32 m_iNumTransformsUpdated;
+      ezUInt32 m_uiNumSpatialDataUpdates;
     };
 
     UserData userData;
     userData.m_fInvDt = fInvDeltaSeconds;
     userData.m_pSpatialSystem = m_pSpatialSystem.Borrow();
+    userData.m_uiNumSpatialDataUpdates = 0;
 
     struct RootLevel
     {
       EZ_ALWAYS_INLINE static ezVisitorExecution::Enum Visit(ezGameObject::TransformationData* pData, void* pUserData)
       {
-        WorldData::UpdateGlobalTransform(pData, static_cast<UserData*>(pUserData)->m_fInvDt);
+        if (WorldData::UpdateGlobalTransform(pData, static_cast<UserData*>(pUserData)->m_fInvDt))
+        {
+          static_cast<UserData*>(pUserData)->m_iNumTransformsUpdated.Increment();
+        }
         return ezVisitorExecution::Continue;
       }
     };
@@ -305,7 +538,10 @@ namespace ezInternal
     {
       EZ_ALWAYS_INLINE static ezVisitorExecution::Enum Visit(ezGameObject::TransformationData* pData, void* pUserData)
       {
-        WorldData::UpdateGlobalTransformWithParent(pData, static_cast<UserData*>(pUserData)->m_fInvDt);
+        if (WorldData::UpdateGlobalTransformWithParent(pData, static_cast<UserData*>(pUserData)->m_fInvDt))
+        {
+          static_cast<UserData*>(pUserData)->m_iNumTransformsUpdated.Increment();
+        }
         return ezVisitorExecution::Continue;
       }
     };
@@ -314,8 +550,11 @@ namespace ezInternal
     {
       EZ_ALWAYS_INLINE static ezVisitorExecution::Enum Visit(ezGameObject::TransformationData* pData, void* pUserData)
       {
-        WorldData::UpdateGlobalTransformAndSpatialData(pData, static_cast<UserData*>(pUserData)->m_fInvDt,
-          *static_cast<UserData*>(pUserData)->m_pSpatialSystem);
+        if (WorldData::UpdateGlobalTransformAndSpatialData(pData, static_cast<UserData*>(pUserData)->m_fInvDt,
+              *static_cast<UserData*>(pUserData)->m_pSpatialSystem, static_cast<UserData*>(pUserData)->m_uiNumSpatialDataUpdates))
+        {
+          static_cast<UserData*>(pUserData)->m_iNumTransformsUpdated.Increment();
+        }
         return ezVisitorExecution::Continue;
       }
     };
@@ -324,17 +563,30 @@ namespace ezInternal
     {
       EZ_ALWAYS_INLINE static ezVisitorExecution::Enum Visit(ezGameObject::TransformationData* pData, void* pUserData)
       {
-        WorldData::UpdateGlobalTransformWithParentAndSpatialData(pData, static_cast<UserData*>(pUserData)->m_fInvDt,
-          *static_cast<UserData*>(pUserData)->m_pSpatialSystem);
+        if (WorldData::UpdateGlobalTransformWithParentAndSpatialData(pData, static_cast<UserData*>(pUserData)->m_fInvDt,
+              *static_cast<UserData*>(pUserData)->m_pSpatialSystem, static_cast<UserData*>(pUserData)->m_uiNumSpatialDataUpdates))
+        {
+          static_cast<UserData*>(pUserData)->m_iNumTransformsUpdated.Increment();
+        }
         return ezVisitorExecution::Continue;
       }
     };
 
+    m_uiNumDynamicTransforms = 0;
+
     Hierarchy& hierarchy = m_Hierarchies[HierarchyType::Dynamic];
     if (!hierarchy.m_Data.IsEmpty())
     {
       auto dataPtr = hierarchy.m_Data.GetData();
 
+      for (ezUInt32 i = 0; i < hierarchy.m_Data.GetCount(); ++i)
+      {
+        for (const Hierarchy::DataBlock& block : *dataPtr[i])
+        {
+          m_uiNumDynamicTransforms += block.m_uiCount;
+        }
+      }
+
       // If we have no spatial system, we perform multi-threaded update as we do not
       // have to acquire a write lock in the process.
       if (m_pSpatialSystem == nullptr)
@@ -356,6 +608,9 @@ namespace ezInternal
         }
       }
     }
+
+    m_uiNumTransformsUpdated = static_cast<ezUInt32>(userData.m_iNumTransformsUpdated);
+    m_uiNumSpatialDataUpdates = userData.m_uiNumSpatialDataUpdates;
   }
 
 } // namespace ezInternal
@@ -130,14 +130,23 @@ namespace ezInternal
     void TraverseDepthFirst(VisitorFunc& func);
     static ezVisitorExecution::Enum TraverseObjectDepthFirst(ezGameObject* pObject, VisitorFunc& func);
 
-    static void UpdateGlobalTransform(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds);
-    static void UpdateGlobalTransformWithParent(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds);
+    /// \brief Called instead of the global transform update for objects that did not change. Resets the velocity of objects that only moved in the last update.
+    static void SkipGlobalTransformUpdate(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds);
 
-    static void UpdateGlobalTransformAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem& spatialSystem);
-    static void UpdateGlobalTransformWithParentAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem& spatialSystem);
+    // These return false if the update was skipped because neither the object nor its parent changed.
+    static bool UpdateGlobalTransform(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds);
+    static bool UpdateGlobalTransformWithParent(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds);
+
+    static bool UpdateGlobalTransformAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem& spatialSystem, ezUInt32& inout_uiNumSpatialDataUpdates);
+    static bool UpdateGlobalTransformWithParentAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem& spatialSystem, ezUInt32& inout_uiNumSpatialDataUpdates);
 
     void UpdateGlobalTransforms(float fInvDeltaSeconds);
 
+    // statistics of the last UpdateGlobalTransforms() call
+    ezUInt32 m_uiNumDynamicTransforms = 0;
+    ezUInt32 m_uiNumTransformsUpdated = 0;
+    ezUInt32 m_uiNumSpatialDataUpdates = 0;
+
     // game object lookups
     ezHashTable<ezUInt32, ezGameObjectId, ezHashHelper<ezUInt32>, ezLocalAllocatorWrapper> m_GlobalKeyToIdTable;
     ezHashTable<ezUInt32, ezHashedString, ezHashHelper<ezUInt32>, ezLocalAllocatorWrapper> m_IdToGlobalKeyTable;
@@ -228,6 +237,91 @@ namespace ezInternal
     mutable MessageQueue m_MessageQueues[ezObjectMsgQueueType::COUNT];
     mutable MessageQueue m_TimedMessageQueues[ezObjectMsgQueueType::COUNT];
 
+    /// \brief Message queues that are only ever written by one thread, so posting a message does not need to take a lock.
+    ///
+    /// They are indexed with ezInternal::GetStackAllocatorThreadIndex(), the same index that gives each thread its own arena in the stack allocator
+    /// that regular message copies are allocated from. Threads that don't get an index post to the shared, locked queues above.
+    struct ThreadMessageQueues
+    {
+      ezDynamicArray<MessageQueue::Entry, ezLocalAllocatorWrapper> m_Messages[ezObjectMsgQueueType::COUNT];
+      ezDynamicArray<MessageQueue::Entry, ezLocalAllocatorWrapper> m_TimedMessages[ezObjectMsgQueueType::COUNT];
+    };
+
+    /// \brief Created on first use by the thread with the corresponding index.
+    mutable ThreadMessageQueues* m_ThreadMessageQueues[ezInternal::StackAllocatorMaxThreads] = {};
+
+    /// \brief All messages of one queue type gathered from all threads, sorted once before they are processed.
+    ezDynamicArray<MessageQueue::Entry, ezLocalAllocatorWrapper> m_MessagesToProcess;
+
+    /// \brief Adds the message to the queue of the calling thread. This method is thread safe.
+    void EnqueueMessage(ezMessage* pMessage, const QueuedMsgMetaData& metaData, ezObjectMsgQueueType::Enum queueType, bool bTimed) const;
+
+    /// \brief Moves the messages of the given queue type that have been posted since the last call from all threads to out_Messages.
+    ///
+    /// Not thread safe, no thread may post messages at the same time.
+    void GatherQueuedMessages(ezObjectMsgQueueType::Enum queueType, bool bTimed, ezDynamicArrayBase<MessageQueue::Entry>& out_Messages);
+
+    /// \brief A delayed message that has been moved from the timed message queue into the timed message heap.
+    ///
+    /// The sort criteria are cached so comparing two entries does not need to touch the messages.
+    struct TimedMessage
+    {
+      EZ_DECLARE_POD_TYPE();
+
+      MessageQueue::Entry m_Entry;
+      ezInt32 m_iSortingKey;
+      ezUInt32 m_uiHash;
+      ezMessageId m_MessageId;
+    };
+
+    /// \brief Binary min-heaps of all pending delayed messages, ordered by due time.
+    ///
+    /// Newly posted delayed messages are collected in the timed message queues and moved into the heap once per frame,
+    /// so processing only touches the messages that are actually due instead of sorting all pending messages each frame.
+    ezDynamicArray<TimedMessage, ezLocalAllocatorWrapper> m_TimedMessageHeaps[ezObjectMsgQueueType::COUNT];
+
+    static bool IsDueBefore(const TimedMessage& a, const TimedMessage& b);
+    static void PushTimedMessage(ezDynamicArrayBase<TimedMessage>& heap, const TimedMessage& timedMessage);
+    static void PopTimedMessage(ezDynamicArrayBase<TimedMessage>& heap);
+
+    /// \brief Allocation policy that keeps the memory of delayed message copies in per size free lists.
+    ///
+    /// Delayed messages are typically small and short-lived, so once the pool has grown to the number of pending messages
+    /// posting a delayed message does not need to allocate from the heap anymore. Allocations are thread safe.
+    class TimedMessageAllocation
+    {
+    public:
+      TimedMessageAllocation(ezAllocatorBase* pParent);
+      ~TimedMessageAllocation();
+
+      void* Allocate(size_t uiSize, size_t uiAlign);
+      void Deallocate(void* ptr);
+
+      EZ_ALWAYS_INLINE ezAllocatorBase* GetParent() const { return m_pParent; }
+
+    private:
+      enum
+      {
+        Alignment = 16,
+        HeaderSize = 16, ///< Stores the size class in front of every allocation, keeps the payload 16 byte aligned.
+        SizeClassGranularity = 16,
+        NumSizeClasses = 16, ///< Messages up to 256 bytes are pooled, larger ones are passed on to the parent allocator.
+        LargeAllocation = NumSizeClasses,
+        ChunkSize = 16 * 1024
+      };
+
+      ezAllocatorBase* m_pParent;
+      ezMutex m_Mutex;
+
+      void* m_FreeLists[NumSizeClasses];
+      ezUInt8* m_pNextFreeInChunk;
+      ezUInt8* m_pChunkEnd;
+      ezDynamicArray<void*> m_Chunks;
+    };
+
+    typedef ezAllocator<TimedMessageAllocation, ezMemoryTrackingFlags::RegisterAllocator> TimedMessageAllocator;
+    mutable TimedMessageAllocator m_TimedMessageAllocator;
+
     ezThreadID m_WriteThreadID;
     ezInt32 m_iWriteCounter;
     mutable ezAtomicInteger32 m_iReadCounter;
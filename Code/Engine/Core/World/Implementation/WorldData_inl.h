@@ -57,36 +57,84 @@ namespace ezInternal
   }
 
   // static
-  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransform(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds)
+  EZ_FORCE_INLINE void WorldData::SkipGlobalTransformUpdate(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds)
   {
+    if (pData->m_uiTransformFlags != 0)
+    {
+      // The object moved in the last update but not in this one, update the velocity once more so it goes back to zero.
+      pData->UpdateVelocity(fInvDeltaSeconds);
+      pData->m_uiTransformFlags = 0;
+    }
+  }
+
+  // static
+  EZ_FORCE_INLINE bool WorldData::UpdateGlobalTransform(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds)
+  {
+    if ((pData->m_uiTransformFlags & ezGameObject::TransformationData::TransformFlags::LocalChanged) == 0)
+    {
+      SkipGlobalTransformUpdate(pData, fInvDeltaSeconds);
+      return false;
+    }
+
     pData->UpdateGlobalTransform();
     pData->UpdateVelocity(fInvDeltaSeconds);
     pData->UpdateGlobalBounds();
+    pData->m_uiTransformFlags = ezGameObject::TransformationData::TransformFlags::GlobalChanged;
+    return true;
   }
 
   // static
-  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransformWithParent(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds)
+  EZ_FORCE_INLINE bool WorldData::UpdateGlobalTransformWithParent(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds)
   {
+    if ((pData->m_pParentData->m_uiTransformFlags & ezGameObject::TransformationData::TransformFlags::GlobalChanged) == 0 &&
+        (pData->m_uiTransformFlags & ezGameObject::TransformationData::TransformFlags::LocalChanged) == 0)
+    {
+      SkipGlobalTransformUpdate(pData, fInvDeltaSeconds);
+      return false;
+    }
+
     pData->UpdateGlobalTransformWithParent();
     pData->UpdateVelocity(fInvDeltaSeconds);
     pData->UpdateGlobalBounds();
+    pData->m_uiTransformFlags = ezGameObject::TransformationData::TransformFlags::GlobalChanged;
+    return true;
   }
 
   // static
-  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransformAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds,
-    ezSpatialSystem& spatialSystem)
+  EZ_FORCE_INLINE bool WorldData::UpdateGlobalTransformAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds,
+    ezSpatialSystem& spatialSystem, ezUInt32& inout_uiNumSpatialDataUpdates)
   {
+    if ((pData->m_uiTransformFlags & ezGameObject::TransformationData::TransformFlags::LocalChanged) == 0)
+    {
+      SkipGlobalTransformUpdate(pData, fInvDeltaSeconds);
+      return false;
+    }
+
     pData->UpdateGlobalTransform();
     pData->UpdateVelocity(fInvDeltaSeconds);
-    pData->UpdateGlobalBoundsAndSpatialData(spatialSystem);
+    if (pData->UpdateGlobalBoundsAndSpatialData(spatialSystem))
+      ++inout_uiNumSpatialDataUpdates;
+    pData->m_uiTransformFlags = ezGameObject::TransformationData::TransformFlags::GlobalChanged;
+    return true;
   }
 
   // static
-  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransformWithParentAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem& spatialSystem)
+  EZ_FORCE_INLINE bool WorldData::UpdateGlobalTransformWithParentAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds,
+    ezSpatialSystem& spatialSystem, ezUInt32& inout_uiNumSpatialDataUpdates)
   {
+    if ((pData->m_pParentData->m_uiTransformFlags & ezGameObject::TransformationData::TransformFlags::GlobalChanged) == 0 &&
+        (pData->m_uiTransformFlags & ezGameObject::TransformationData::TransformFlags::LocalChanged) == 0)
+    {
+      SkipGlobalTransformUpdate(pData, fInvDeltaSeconds);
+      return false;
+    }
+
     pData->UpdateGlobalTransformWithParent();
     pData->UpdateVelocity(fInvDeltaSeconds);
-    pData->UpdateGlobalBoundsAndSpatialData(spatialSystem);
+    if (pData->UpdateGlobalBoundsAndSpatialData(spatialSystem))
+      ++inout_uiNumSpatialDataUpdates;
+    pData->m_uiTransformFlags = ezGameObject::TransformationData::TransformFlags::GlobalChanged;
+    return true;
   }
 
   ///////////////////////////////////////////////////////////////////////////////////////////////////
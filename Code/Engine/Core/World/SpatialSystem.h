@@ -36,6 +36,7 @@ public:
     ezUInt32 m_uiTotalNumObjects;  ///< The total number of spatial objects in this system.
     ezUInt32 m_uiNumObjectsTested; ///< Number of objects tested for the query condition.
     ezUInt32 m_uiNumObjectsPassed; ///< Number of objects that passed the query condition.
+    ezUInt32 m_uiNumTasks;         ///< Number of tasks the query was split into, 0 if it was executed serially.
     ezTime m_TimeTaken;            ///< Time taken to execute the query
 
     EZ_ALWAYS_INLINE QueryStats()
@@ -43,6 +44,7 @@ public:
       m_uiTotalNumObjects = 0;
       m_uiNumObjectsTested = 0;
       m_uiNumObjectsPassed = 0;
+      m_uiNumTasks = 0;
     }
   };
 
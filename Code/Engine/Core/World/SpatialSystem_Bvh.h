@@ -0,0 +1,71 @@
+#pragma once
+
+#include <Core/World/SpatialSystem.h>
+
+/// \brief Spatial system that stores all spatial data in a dynamic bounding volume hierarchy.
+///
+/// Every spatial data is a leaf of a binary tree of bounding boxes. The tree is built incrementally, new data is inserted next to the node
+/// that increases the surface area of the tree the least and the tree is rebalanced with rotations on the way back up.
+/// The box of a leaf is slightly larger than the actual bounds, so objects that move only a little don't change the tree at all.
+///
+/// In contrast to ezSpatialSystem_RegularGrid there is no fixed cell size, so huge objects and dense clusters of small objects are culled
+/// hierarchically as well. Use it by setting it as ezWorldDesc::m_pSpatialSystem.
+class EZ_CORE_DLL ezSpatialSystem_Bvh : public ezSpatialSystem
+{
+  EZ_ADD_DYNAMIC_REFLECTION(ezSpatialSystem_Bvh, ezSpatialSystem);
+
+public:
+  /// \brief \a fLeafMargin is the fraction of their size by which the leaf boxes are enlarged in every direction.
+  ezSpatialSystem_Bvh(float fLeafMargin = 0.2f);
+  ~ezSpatialSystem_Bvh();
+
+  /// \brief Returns the number of levels of the tree, 0 if it is empty.
+  ezUInt32 GetTreeHeight() const;
+
+  /// \brief Returns the bounding boxes of all inner nodes up to the given depth. Useful for debug visualizations.
+  void GetAllNodeBoxes(ezHybridArray<ezBoundingBox, 16>& out_BoundingBoxes, ezSpatialData::Category filterCategory = ezInvalidSpatialDataCategory,
+    ezUInt32 uiMaxDepth = ezInvalidIndex) const;
+
+private:
+  // ezSpatialSystem implementation
+  virtual void FindObjectsInSphereInternal(const ezBoundingSphere& sphere, ezUInt32 uiCategoryBitmask, QueryCallback callback,
+    QueryStats* pStats = nullptr) const override;
+  virtual void FindObjectsInBoxInternal(const ezBoundingBox& box, ezUInt32 uiCategoryBitmask, QueryCallback callback, QueryStats* pStats = nullptr) const override;
+
+  virtual void FindVisibleObjectsInternal(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects,
+    QueryStats* pStats = nullptr) const override;
+
+  virtual void SpatialDataAdded(ezSpatialData* pData) override;
+  virtual void SpatialDataRemoved(ezSpatialData* pData) override;
+  virtual void SpatialDataChanged(ezSpatialData* pData, const ezSimdBBoxSphere& oldBounds, ezUInt32 uiOldCategoryBitmask) override;
+  virtual void FixSpatialDataPointer(ezSpatialData* pOldPtr, ezSpatialData* pNewPtr) override;
+
+  struct Node;
+  struct FrustumPlanes;
+  struct CullingSubtree;
+
+  ezUInt32 AllocateNode();
+  void FreeNode(ezUInt32 uiNode);
+
+  void InsertLeaf(ezUInt32 uiLeaf);
+  void RemoveLeaf(ezUInt32 uiLeaf);
+
+  /// \brief Recomputes box, height and category bitmask of an inner node from its children.
+  void Refit(ezUInt32 uiNode);
+
+  /// \brief Rotates the subtree at the given node if it is unbalanced and returns the index of the node that is now at its place.
+  ezUInt32 Balance(ezUInt32 uiNode);
+
+  void ComputeFatBox(const ezSimdBBoxSphere& bounds, ezSimdBBox& out_Box) const;
+
+  ezUInt32 FindVisibleObjectsInSubtree(ezUInt32 uiNode, bool bInside, ezUInt32 uiCategoryBitmask, const FrustumPlanes& planes,
+    ezDynamicArray<const ezGameObject*>& out_Objects, ezUInt32& inout_uiNumObjectsTested) const;
+
+  ezProxyAllocator m_AlignedAllocator;
+  ezSimdFloat m_fLeafMargin;
+
+  ezDynamicArray<Node> m_Nodes;
+  ezUInt32 m_uiRootNode = ezInvalidIndex;
+  ezUInt32 m_uiFirstFreeNode = ezInvalidIndex;
+  ezUInt32 m_uiNumLeaves = 0;
+};
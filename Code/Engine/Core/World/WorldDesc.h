@@ -22,6 +22,8 @@ struct ezWorldDesc
   ezHashedString m_sName;
   ezUInt64 m_uiRandomNumberGeneratorSeed = 0;
 
+  /// \brief The spatial system of the world, e.g. EZ_NEW(ezFoundation::GetAlignedAllocator(), ezSpatialSystem_Bvh).
+  /// ezSpatialSystem_RegularGrid is used if none is set and m_bAutoCreateSpatialSystem is true.
   ezUniquePtr<ezSpatialSystem> m_pSpatialSystem;
   bool m_bAutoCreateSpatialSystem = true; ///< automatically create a default spatial system if none is set
 
@@ -4,9 +4,9 @@
 #undef EZ_USE_POSIX_FILE_API
 #define EZ_USE_POSIX_FILE_API EZ_ON
 
-/// Iterating through the file system is not supported
+/// Iterating through the file system is supported
 #undef EZ_SUPPORTS_FILE_ITERATORS
-#define EZ_SUPPORTS_FILE_ITERATORS EZ_OFF
+#define EZ_SUPPORTS_FILE_ITERATORS EZ_ON
 
 /// Getting the stats of a file (modification times etc.) is supported.
 #undef EZ_SUPPORTS_FILE_STATS
@@ -42,5 +42,12 @@
 
 // SIMD support
 #undef EZ_SIMD_IMPLEMENTATION
-#define EZ_SIMD_IMPLEMENTATION EZ_SIMD_IMPLEMENTATION_FPU
+
+#if defined(BUILDSYSTEM_SIMD_IMPLEMENTATION_FPU)
+#  define EZ_SIMD_IMPLEMENTATION EZ_SIMD_IMPLEMENTATION_FPU
+#elif EZ_ENABLED(EZ_PLATFORM_ARCH_X86)
+#  define EZ_SIMD_IMPLEMENTATION EZ_SIMD_IMPLEMENTATION_SSE
+#else
+#  define EZ_SIMD_IMPLEMENTATION EZ_SIMD_IMPLEMENTATION_FPU
+#endif
 
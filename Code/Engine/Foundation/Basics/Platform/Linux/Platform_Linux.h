@@ -33,7 +33,7 @@
 #  define EZ_PLATFORM_32BIT EZ_ON
 #endif
 
-#if __arm__
+#if __arm__ || __aarch64__
 #  undef EZ_PLATFORM_ARCH_ARM
 #  define EZ_PLATFORM_ARCH_ARM EZ_ON
 #else
@@ -67,7 +67,9 @@
 // SIMD support
 #undef EZ_SIMD_IMPLEMENTATION
 
-#if EZ_ENABLED(EZ_PLATFORM_ARCH_X86)
+#if defined(BUILDSYSTEM_SIMD_IMPLEMENTATION_FPU)
+#  define EZ_SIMD_IMPLEMENTATION EZ_SIMD_IMPLEMENTATION_FPU
+#elif EZ_ENABLED(EZ_PLATFORM_ARCH_X86)
 #  define EZ_SIMD_IMPLEMENTATION EZ_SIMD_IMPLEMENTATION_SSE
 #elif EZ_ENABLED(EZ_PLATFORM_ARCH_ARM)
 #  define EZ_SIMD_IMPLEMENTATION EZ_SIMD_IMPLEMENTATION_FPU
@@ -1,6 +1,8 @@
 #include <FoundationPCH.h>
 
 #include <Foundation/Communication/Implementation/IpcChannelEnet.h>
+#include <Foundation/Communication/Implementation/Linux/PipeChannel_linux.h>
+#include <Foundation/Communication/Implementation/Linux/SharedMemoryChannel_linux.h>
 #include <Foundation/Communication/Implementation/MessageLoop.h>
 #include <Foundation/Communication/Implementation/Win/PipeChannel_win.h>
 #include <Foundation/Communication/IpcChannel.h>
@@ -33,12 +35,29 @@ ezIpcChannel* ezIpcChannel::CreatePipeChannel(const char* szAddress, Mode::Enum
 
 #if EZ_ENABLED(EZ_PLATFORM_WINDOWS_DESKTOP)
   return EZ_DEFAULT_NEW(ezPipeChannel_win, szAddress, mode);
+#elif EZ_ENABLED(EZ_PLATFORM_LINUX)
+  return EZ_DEFAULT_NEW(ezPipeChannel_linux, szAddress, mode);
 #else
   EZ_ASSERT_NOT_IMPLEMENTED;
   return nullptr;
 #endif
 }
 
+ezIpcChannel* ezIpcChannel::CreateSharedMemoryChannel(const char* szAddress, Mode::Enum mode)
+{
+#if EZ_ENABLED(EZ_PLATFORM_LINUX)
+  if (ezStringUtils::IsNullOrEmpty(szAddress) || ezStringUtils::GetStringElementCount(szAddress) > 200)
+  {
+    ezLog::Error("Failed to create shared memory channel '{0}', name is not valid", szAddress);
+    return nullptr;
+  }
+
+  return EZ_DEFAULT_NEW(ezSharedMemoryChannel_linux, szAddress, mode);
+#else
+  return CreatePipeChannel(szAddress, mode);
+#endif
+}
+
 
 ezIpcChannel* ezIpcChannel::CreateNetworkChannel(const char* szAddress, Mode::Enum mode)
 {
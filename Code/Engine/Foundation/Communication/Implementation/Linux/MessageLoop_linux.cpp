@@ -0,0 +1,124 @@
+#include <FoundationPCH.h>
+
+#if EZ_ENABLED(EZ_PLATFORM_LINUX)
+
+#include <Foundation/Communication/Implementation/Linux/MessageLoop_linux.h>
+#include <Foundation/Communication/Implementation/Linux/PipeChannel_linux.h>
+#include <Foundation/Communication/IpcChannel.h>
+#include <Foundation/Logging/Log.h>
+
+#include <errno.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+ezMessageLoop_linux::ezMessageLoop_linux()
+{
+  m_iWakeUpFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  EZ_ASSERT_DEBUG(m_iWakeUpFd != -1, "Failed to create eventfd: {0}", strerror(errno));
+}
+
+ezMessageLoop_linux::~ezMessageLoop_linux()
+{
+  StopUpdateThread();
+  close(m_iWakeUpFd);
+}
+
+void ezMessageLoop_linux::WakeUp()
+{
+  if (ezAtomicUtils::Set(m_iHaveWork, 1))
+  {
+    // already running
+    return;
+  }
+
+  // wake up the loop
+  eventfd_write(m_iWakeUpFd, 1);
+}
+
+bool ezMessageLoop_linux::WaitForMessages(ezInt32 iTimeout, ezIpcChannel* pFilter)
+{
+  // All channels are processed whenever the loop wakes up, so there is nothing to defer for pFilter.
+  EZ_IGNORE_UNUSED(pFilter);
+
+  m_PolledChannels.Clear();
+  m_PollFds.Clear();
+
+  pollfd& wakeUp = m_PollFds.ExpandAndGetRef();
+  wakeUp.fd = m_iWakeUpFd;
+  wakeUp.events = POLLIN;
+  wakeUp.revents = 0;
+
+  {
+    EZ_LOCK(m_ChannelsMutex);
+    for (ezPipeChannel_linux* pChannel : m_Channels)
+    {
+      pollfd& fd = m_PollFds.ExpandAndGetRef();
+      fd.fd = -1; // ignored by poll
+      fd.events = 0;
+      fd.revents = 0;
+
+      // a channel can have work that does not depend on its socket, e.g. data in a shared memory ring
+      if (pChannel->PrepareWait(fd))
+        iTimeout = 0;
+
+      m_PolledChannels.PushBack(pChannel);
+    }
+  }
+
+  const int iResult = poll(m_PollFds.GetData(), m_PollFds.GetCount(), iTimeout);
+  if (iResult < 0)
+  {
+    if (errno != EINTR)
+    {
+      ezLog::Error("Polling the IPC channels failed: {0}", strerror(errno));
+    }
+    return false;
+  }
+
+  bool bDidWork = false;
+
+  if (m_PollFds[0].revents != 0)
+  {
+    // internal notification
+    eventfd_t value;
+    eventfd_read(m_iWakeUpFd, &value);
+    ezAtomicUtils::Set(m_iHaveWork, 0);
+    bDidWork = true;
+  }
+
+  EZ_LOCK(m_ChannelsMutex);
+  for (ezUInt32 i = 0; i < m_PolledChannels.GetCount(); ++i)
+  {
+    ezPipeChannel_linux* pChannel = m_PolledChannels[i];
+
+    // the channel may have been removed while we were waiting
+    if (!m_Channels.Contains(pChannel))
+      continue;
+
+    bDidWork |= pChannel->ProcessIO(m_PollFds[i + 1].revents);
+  }
+
+  return bDidWork;
+}
+
+void ezMessageLoop_linux::RegisterChannel(ezPipeChannel_linux* pChannel)
+{
+  {
+    EZ_LOCK(m_ChannelsMutex);
+    m_Channels.PushBack(pChannel);
+  }
+
+  // make the loop poll the new channel
+  WakeUp();
+}
+
+void ezMessageLoop_linux::UnregisterChannel(ezPipeChannel_linux* pChannel)
+{
+  EZ_LOCK(m_ChannelsMutex);
+  m_Channels.RemoveAndSwap(pChannel);
+}
+
+#endif
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Communication_Implementation_Linux_MessageLoop_linux);
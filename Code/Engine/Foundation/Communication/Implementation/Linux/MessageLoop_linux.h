@@ -0,0 +1,49 @@
+#pragma once
+
+#include <Foundation/FoundationInternal.h>
+EZ_FOUNDATION_INTERNAL_HEADER
+
+#if EZ_ENABLED(EZ_PLATFORM_LINUX)
+
+#include <Foundation/Basics.h>
+#include <Foundation/Communication/Implementation/MessageLoop.h>
+
+#include <poll.h>
+
+EZ_DEFINE_AS_POD_TYPE(pollfd);
+
+class ezIpcChannel;
+class ezPipeChannel_linux;
+
+/// \brief Message loop that polls the sockets of all ezPipeChannel_linux instances.
+///
+/// WakeUp() signals an eventfd that is part of every poll call.
+class EZ_FOUNDATION_DLL ezMessageLoop_linux : public ezMessageLoop
+{
+public:
+  ezMessageLoop_linux();
+  ~ezMessageLoop_linux();
+
+protected:
+  virtual void WakeUp() override;
+  virtual bool WaitForMessages(ezInt32 iTimeout, ezIpcChannel* pFilter) override;
+
+private:
+  friend class ezPipeChannel_linux;
+
+  void RegisterChannel(ezPipeChannel_linux* pChannel);
+  void UnregisterChannel(ezPipeChannel_linux* pChannel);
+
+  int m_iWakeUpFd = -1;
+  ezInt32 m_iHaveWork = 0;
+
+  // Locked while channels are processed, so that unregistering a channel waits until the message loop is done with it.
+  ezMutex m_ChannelsMutex;
+  ezDynamicArray<ezPipeChannel_linux*> m_Channels;
+
+  // Only accessed from worker thread
+  ezDynamicArray<ezPipeChannel_linux*> m_PolledChannels;
+  ezDynamicArray<pollfd> m_PollFds;
+};
+
+#endif
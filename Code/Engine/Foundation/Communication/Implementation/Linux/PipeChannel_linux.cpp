@@ -0,0 +1,383 @@
+#include <FoundationPCH.h>
+
+#if EZ_ENABLED(EZ_PLATFORM_LINUX)
+
+#include <Foundation/Algorithm/HashingUtils.h>
+#include <Foundation/Communication/Implementation/Linux/MessageLoop_linux.h>
+#include <Foundation/Communication/Implementation/Linux/PipeChannel_linux.h>
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Threading/ThreadUtils.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+ezPipeChannel_linux::ezPipeChannel_linux(const char* szAddress, Mode::Enum mode)
+    : ezIpcChannel(szAddress, mode)
+{
+  CreateSocket(szAddress);
+  m_pOwner->AddChannel(this);
+}
+
+ezPipeChannel_linux::~ezPipeChannel_linux()
+{
+  Shutdown();
+}
+
+bool ezPipeChannel_linux::CreateSocket(const char* szAddress)
+{
+  // Sockets in the abstract namespace start with a zero byte and are gone as soon as the last socket is closed,
+  // so there are no socket files that need to be cleaned up after a crash.
+  ezStringBuilder sName("ezIpc/", szAddress);
+  if (sName.GetElementCount() > sizeof(m_SocketAddress.sun_path) - 1)
+  {
+    const ezUInt64 uiHash = ezHashingUtils::xxHash64(szAddress, ezStringUtils::GetStringElementCount(szAddress));
+    sName.Format("ezIpc/{0}", ezArgU(uiHash, 16, true, 16, true));
+  }
+
+  memset(&m_SocketAddress, 0, sizeof(m_SocketAddress));
+  m_SocketAddress.sun_family = AF_UNIX;
+  memcpy(m_SocketAddress.sun_path + 1, sName.GetData(), sName.GetElementCount());
+  m_SocketAddressLength = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1 + sName.GetElementCount());
+
+  if (m_Mode == Mode::Server)
+  {
+    m_iListenSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+    if (m_iListenSocket == -1 || bind(m_iListenSocket, reinterpret_cast<sockaddr*>(&m_SocketAddress), m_SocketAddressLength) != 0 ||
+        listen(m_iListenSocket, 1) != 0)
+    {
+      ezLog::Error("Could not create IPC socket '{0}': {1}", szAddress, strerror(errno));
+      CloseSockets();
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void ezPipeChannel_linux::Shutdown()
+{
+  if (m_Connected)
+  {
+    Disconnect();
+  }
+  while (m_Connected)
+  {
+    ezThreadUtils::Sleep(ezTime::Milliseconds(10));
+  }
+
+  // once both are done, neither the queued tasks nor the poll loop touch this channel anymore
+  m_pOwner->RemoveChannel(this);
+  static_cast<ezMessageLoop_linux*>(m_pOwner)->UnregisterChannel(this);
+
+  CloseSockets();
+}
+
+void ezPipeChannel_linux::CloseSockets()
+{
+  if (m_iListenSocket != -1)
+  {
+    close(m_iListenSocket);
+    m_iListenSocket = -1;
+  }
+
+  if (m_iSocket != -1)
+  {
+    close(m_iSocket);
+    m_iSocket = -1;
+  }
+
+  m_bAcceptConnection = false;
+}
+
+void ezPipeChannel_linux::AddToMessageLoop(ezMessageLoop* pMsgLoop)
+{
+  static_cast<ezMessageLoop_linux*>(pMsgLoop)->RegisterChannel(this);
+}
+
+void ezPipeChannel_linux::InternalConnect()
+{
+  if (m_Connected || m_iSocket != -1)
+    return;
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+  if (m_ThreadId == 0)
+    m_ThreadId = ezThreadUtils::GetCurrentThreadID();
+#endif
+
+  if (m_Mode == Mode::Server)
+  {
+    if (m_iListenSocket == -1)
+      return;
+
+    m_bAcceptConnection = true;
+    AcceptConnection();
+  }
+  else
+  {
+    int iSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+    if (iSocket == -1 || connect(iSocket, reinterpret_cast<sockaddr*>(&m_SocketAddress), m_SocketAddressLength) != 0)
+    {
+      ezLog::Error("Could not connect to IPC socket: {0}", strerror(errno));
+
+      if (iSocket != -1)
+        close(iSocket);
+
+      return;
+    }
+
+    fcntl(iSocket, F_SETFL, fcntl(iSocket, F_GETFL) | O_NONBLOCK);
+    m_iSocket = iSocket;
+
+    OnSocketConnected();
+  }
+}
+
+void ezPipeChannel_linux::InternalDisconnect()
+{
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+  if (m_ThreadId != 0)
+    EZ_ASSERT_DEBUG(m_ThreadId == ezThreadUtils::GetCurrentThreadID(), "Function must be called from worker thread!");
+#endif
+
+  CloseSockets();
+
+  {
+    EZ_LOCK(m_OutputQueueMutex);
+    m_OutputQueue.Clear();
+    m_uiOutputOffset = 0;
+    m_OutputBlocked = false;
+    m_Connected = false;
+  }
+
+  m_Events.Broadcast(ezIpcChannelEvent(m_Mode == Mode::Client ? ezIpcChannelEvent::DisconnectedFromServer : ezIpcChannelEvent::DisconnectedFromClient, this));
+  // Raise in case another thread is waiting for new messages (as we would sleep forever otherwise).
+  m_IncomingMessages.RaiseSignal();
+}
+
+void ezPipeChannel_linux::InternalSend()
+{
+  if (m_Connected && !m_OutputBlocked)
+  {
+    if (!ProcessOutgoingMessages())
+    {
+      InternalDisconnect();
+    }
+  }
+}
+
+bool ezPipeChannel_linux::NeedWakeup() const
+{
+  return m_OutputBlocked == 0;
+}
+
+bool ezPipeChannel_linux::PrepareWait(pollfd& out_Fd)
+{
+  if (m_bAcceptConnection)
+  {
+    out_Fd.fd = m_iListenSocket;
+    out_Fd.events = POLLIN;
+  }
+  else if (m_iSocket != -1)
+  {
+    out_Fd.fd = m_iSocket;
+    out_Fd.events = m_OutputBlocked ? (POLLIN | POLLOUT) : POLLIN;
+  }
+
+  return false;
+}
+
+bool ezPipeChannel_linux::ProcessIO(ezInt16 iEvents)
+{
+  if (iEvents == 0)
+    return false;
+
+  EZ_ASSERT_DEBUG(m_ThreadId == ezThreadUtils::GetCurrentThreadID(), "Function must be called from worker thread!");
+
+  if (m_bAcceptConnection)
+    return AcceptConnection();
+
+  if (m_iSocket == -1)
+    return false;
+
+  bool bRes = true;
+  if (iEvents & (POLLIN | POLLHUP | POLLERR))
+  {
+    // also read on errors, recv reports them and there may be data left before the connection was closed
+    bRes = ProcessIncomingData();
+  }
+
+  if (bRes && m_iSocket != -1 && (iEvents & POLLOUT))
+  {
+    bRes = ProcessOutgoingMessages();
+  }
+
+  if (!bRes && m_iSocket != -1)
+  {
+    InternalDisconnect();
+  }
+
+  return true;
+}
+
+bool ezPipeChannel_linux::AcceptConnection()
+{
+  int iSocket = accept4(m_iListenSocket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+  if (iSocket == -1)
+  {
+    if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+    {
+      ezLog::Error("Could not accept IPC connection: {0}", strerror(errno));
+    }
+    return false;
+  }
+
+  // just like a named pipe with a single instance, only one client is ever served
+  close(m_iListenSocket);
+  m_iListenSocket = -1;
+  m_bAcceptConnection = false;
+
+  m_iSocket = iSocket;
+  OnSocketConnected();
+  return true;
+}
+
+void ezPipeChannel_linux::OnSocketConnected()
+{
+  m_Connected = true;
+
+  m_Events.Broadcast(ezIpcChannelEvent(m_Mode == Mode::Client ? ezIpcChannelEvent::ConnectedToServer : ezIpcChannelEvent::ConnectedToClient, this));
+
+  if (!ProcessOutgoingMessages())
+  {
+    InternalDisconnect();
+  }
+}
+
+void ezPipeChannel_linux::OnSocketDataReceived(ezArrayPtr<const ezUInt8> data)
+{
+  ReceiveMessageData(data);
+}
+
+bool ezPipeChannel_linux::ProcessIncomingData()
+{
+  while (m_iSocket != -1)
+  {
+    const ssize_t iBytesRead = recv(m_iSocket, m_InputBuffer, BUFFER_SIZE, 0);
+
+    if (iBytesRead > 0)
+    {
+      OnSocketDataReceived(ezArrayPtr<const ezUInt8>(m_InputBuffer, static_cast<ezUInt32>(iBytesRead)));
+
+      // poll is level triggered, so anything left over is picked up with the next wait
+      if (iBytesRead < BUFFER_SIZE)
+        return true;
+
+      continue;
+    }
+
+    if (iBytesRead == 0)
+    {
+      // connection was closed by the other side
+      return false;
+    }
+
+    if (errno == EINTR)
+      continue;
+
+    if (errno == EAGAIN || errno == EWOULDBLOCK)
+      return true;
+
+    if (m_Mode == Mode::Server)
+    {
+      // only log when in server mode, otherwise this can result in an endless recursion
+      ezLog::Error("Read from IPC socket failed: {0}", strerror(errno));
+    }
+    return false;
+  }
+
+  return true;
+}
+
+bool ezPipeChannel_linux::ProcessOutgoingMessages()
+{
+  EZ_ASSERT_DEBUG(m_ThreadId == ezThreadUtils::GetCurrentThreadID(), "Function must be called from worker thread!");
+
+  if (m_iSocket == -1)
+    return true;
+
+  while (true)
+  {
+    // gather several messages into one call, small messages would otherwise cost one syscall each
+    iovec buffers[MAX_MESSAGES_PER_WRITE];
+    ezUInt32 uiNumBuffers = 0;
+    {
+      EZ_LOCK(m_OutputQueueMutex);
+      if (m_OutputQueue.IsEmpty())
+      {
+        m_OutputBlocked = false;
+        return true;
+      }
+
+      uiNumBuffers = ezMath::Min<ezUInt32>(m_OutputQueue.GetCount(), MAX_MESSAGES_PER_WRITE);
+      for (ezUInt32 i = 0; i < uiNumBuffers; ++i)
+      {
+        const ezMemoryStreamStorage& storage = m_OutputQueue[i];
+        const ezUInt32 uiOffset = (i == 0) ? m_uiOutputOffset : 0;
+
+        buffers[i].iov_base = const_cast<ezUInt8*>(storage.GetData()) + uiOffset;
+        buffers[i].iov_len = storage.GetStorageSize() - uiOffset;
+      }
+    }
+
+    msghdr header;
+    memset(&header, 0, sizeof(header));
+    header.msg_iov = buffers;
+    header.msg_iovlen = uiNumBuffers;
+
+    const ssize_t iBytesWritten = sendmsg(m_iSocket, &header, MSG_NOSIGNAL);
+    if (iBytesWritten < 0)
+    {
+      if (errno == EINTR)
+        continue;
+
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+      {
+        // continue once poll reports the socket as writable again
+        m_OutputBlocked = true;
+        return true;
+      }
+
+      if (m_Mode == Mode::Server)
+      {
+        ezLog::Error("Write to IPC socket failed: {0}", strerror(errno));
+      }
+      return false;
+    }
+
+    EZ_LOCK(m_OutputQueueMutex);
+    ezUInt64 uiRemaining = static_cast<ezUInt64>(iBytesWritten);
+    while (uiRemaining > 0)
+    {
+      const ezUInt32 uiLeft = m_OutputQueue.PeekFront().GetStorageSize() - m_uiOutputOffset;
+      if (uiRemaining < uiLeft)
+      {
+        m_uiOutputOffset += static_cast<ezUInt32>(uiRemaining);
+        break;
+      }
+
+      // message was sent
+      uiRemaining -= uiLeft;
+      m_OutputQueue.PopFront();
+      m_uiOutputOffset = 0;
+    }
+  }
+}
+
+#endif
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Communication_Implementation_Linux_PipeChannel_linux);
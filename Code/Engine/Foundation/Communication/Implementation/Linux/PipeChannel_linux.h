@@ -0,0 +1,76 @@
+#pragma once
+
+#include <Foundation/FoundationInternal.h>
+EZ_FOUNDATION_INTERNAL_HEADER
+
+#if EZ_ENABLED(EZ_PLATFORM_LINUX)
+
+#include <Foundation/Basics.h>
+#include <Foundation/Communication/IpcChannel.h>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/// \brief IPC channel over an AF_UNIX stream socket in the abstract socket namespace.
+///
+/// Like the named pipe on Windows, the server accepts exactly one client.
+class EZ_FOUNDATION_DLL ezPipeChannel_linux : public ezIpcChannel
+{
+public:
+  ezPipeChannel_linux(const char* szAddress, Mode::Enum mode);
+  ~ezPipeChannel_linux();
+
+protected:
+  friend class ezMessageLoop_linux;
+
+  bool CreateSocket(const char* szAddress);
+  /// \brief Disconnects and removes the channel from the message loop. Must be called by the destructor of the most derived class.
+  void Shutdown();
+
+  virtual void AddToMessageLoop(ezMessageLoop* pMsgLoop) override;
+
+  // All functions from here on down are run from worker thread only
+  virtual void InternalConnect() override;
+  virtual void InternalDisconnect() override;
+  virtual void InternalSend() override;
+  virtual bool NeedWakeup() const override;
+
+  /// \brief Fills out the socket and events to poll for. Returns true, if there is work to do that must not wait for the socket.
+  virtual bool PrepareWait(pollfd& out_Fd);
+  /// \brief Called after every poll with the events that were returned for the socket. Returns whether any work was done.
+  virtual bool ProcessIO(ezInt16 iEvents);
+
+  /// \brief Called once the socket connection is established.
+  virtual void OnSocketConnected();
+  /// \brief Called with all data that is read from the socket.
+  virtual void OnSocketDataReceived(ezArrayPtr<const ezUInt8> data);
+  /// \brief Sends as much of m_OutputQueue as possible. Returns false on errors.
+  virtual bool ProcessOutgoingMessages();
+
+  bool AcceptConnection();
+  bool ProcessIncomingData();
+  void CloseSockets();
+
+  enum Constants
+  {
+    BUFFER_SIZE = 1024 * 64,
+    MAX_MESSAGES_PER_WRITE = 16,
+  };
+
+  // Setup in ctor
+  sockaddr_un m_SocketAddress;
+  socklen_t m_SocketAddressLength = 0;
+  int m_iListenSocket = -1;
+
+  // Only accessed from worker thread
+  int m_iSocket = -1;
+  bool m_bAcceptConnection = false;
+  ezUInt32 m_uiOutputOffset = 0; ///< How many bytes of the first message in m_OutputQueue have been sent already.
+  ezUInt8 m_InputBuffer[BUFFER_SIZE];
+
+  // Shared data
+  ezAtomicInteger32 m_OutputBlocked = false; ///< Whether the output has to wait until the socket or ring is writable again. Changed while m_OutputQueueMutex is locked.
+};
+
+#endif
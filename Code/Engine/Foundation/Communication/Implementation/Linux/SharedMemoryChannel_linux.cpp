@@ -0,0 +1,300 @@
+#include <FoundationPCH.h>
+
+#if EZ_ENABLED(EZ_PLATFORM_LINUX)
+
+#include <Foundation/Communication/Implementation/Linux/SharedMemoryChannel_linux.h>
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Threading/AtomicUtils.h>
+
+#include <string.h>
+#include <unistd.h>
+
+ezSharedMemoryChannel_linux::ezSharedMemoryChannel_linux(const char* szAddress, Mode::Enum mode)
+    : ezPipeChannel_linux(szAddress, mode)
+{
+}
+
+ezSharedMemoryChannel_linux::~ezSharedMemoryChannel_linux()
+{
+  // must happen before the shared memory is destroyed
+  Shutdown();
+}
+
+ezResult ezSharedMemoryChannel_linux::OpenSharedMemory(const char* szName, bool bCreate)
+{
+  const ezUInt64 uiSize = sizeof(SharedHeader) + 2 * RING_SIZE;
+  if (m_SharedMemory.OpenShared(szName, uiSize, ezMemoryMappedFile::Mode::ReadWrite).Failed())
+    return EZ_FAILURE;
+
+  SharedHeader* pHeader = static_cast<SharedHeader*>(m_SharedMemory.GetWritePointer());
+  if (bCreate)
+  {
+    new (pHeader) SharedHeader();
+    pHeader->m_uiMagic = SHARED_MAGIC_VALUE;
+    pHeader->m_uiRingSize = RING_SIZE;
+  }
+  else if (pHeader->m_uiMagic != SHARED_MAGIC_VALUE || pHeader->m_uiRingSize != RING_SIZE)
+  {
+    m_SharedMemory.Close();
+    return EZ_FAILURE;
+  }
+
+  const ezUInt32 uiOutputRing = (m_Mode == Mode::Server) ? 0 : 1;
+  ezUInt8* pData = reinterpret_cast<ezUInt8*>(pHeader + 1);
+
+  m_pOutputRing = &pHeader->m_Rings[uiOutputRing];
+  m_pOutputData = pData + uiOutputRing * RING_SIZE;
+  m_pInputRing = &pHeader->m_Rings[1 - uiOutputRing];
+  m_pInputData = pData + (1 - uiOutputRing) * RING_SIZE;
+
+  m_iOutputWritePos = ezAtomicUtils::Read(m_pOutputRing->m_iWritePos);
+  m_iInputReadPos = ezAtomicUtils::Read(m_pInputRing->m_iReadPos);
+  return EZ_SUCCESS;
+}
+
+void ezSharedMemoryChannel_linux::CloseSharedMemory()
+{
+  m_pInputRing = nullptr;
+  m_pOutputRing = nullptr;
+  m_pInputData = nullptr;
+  m_pOutputData = nullptr;
+  m_uiHandshakeBytes = 0;
+
+  m_SharedMemory.Close();
+}
+
+void ezSharedMemoryChannel_linux::InternalDisconnect()
+{
+  // the other side may have written its last messages right before closing the connection
+  ProcessIncomingRing();
+  CloseSharedMemory();
+
+  ezPipeChannel_linux::InternalDisconnect();
+}
+
+bool ezSharedMemoryChannel_linux::PrepareWait(pollfd& out_Fd)
+{
+  ezPipeChannel_linux::PrepareWait(out_Fd);
+
+  // the socket itself is never written to in bulk, blocked output waits for a wake-up from the reader instead
+  out_Fd.events &= ~POLLOUT;
+
+  if (m_pInputRing == nullptr)
+    return false;
+
+  // Announce that we are about to sleep, then check again. Either the writer sees the flag and wakes us up,
+  // or we see its data here, so no wake-up can get lost in between.
+  ezAtomicUtils::Set(m_pInputRing->m_iReaderWaiting, 1);
+  if (ezAtomicUtils::Read(m_pInputRing->m_iWritePos) != m_iInputReadPos)
+    return true;
+
+  if (m_OutputBlocked)
+  {
+    ezAtomicUtils::Set(m_pOutputRing->m_iWriterWaiting, 1);
+    if (m_iOutputWritePos - ezAtomicUtils::Read(m_pOutputRing->m_iReadPos) < RING_SIZE)
+      return true;
+  }
+
+  return false;
+}
+
+bool ezSharedMemoryChannel_linux::ProcessIO(ezInt16 iEvents)
+{
+  // handles accepting the connection, the handshake, wake-ups and the connection being closed
+  bool bDidWork = ezPipeChannel_linux::ProcessIO(iEvents);
+
+  if (m_pInputRing == nullptr)
+    return bDidWork;
+
+  bDidWork |= ProcessIncomingRing();
+
+  if (m_OutputBlocked && m_pOutputRing != nullptr)
+  {
+    const ezInt64 iPrevWritePos = m_iOutputWritePos;
+    ProcessOutgoingMessages();
+    bDidWork |= (iPrevWritePos != m_iOutputWritePos);
+  }
+
+  return bDidWork;
+}
+
+void ezSharedMemoryChannel_linux::OnSocketConnected()
+{
+  if (m_Mode == Mode::Client)
+  {
+    // wait for the handshake in OnSocketDataReceived
+    m_uiHandshakeBytes = 0;
+    return;
+  }
+
+  static ezAtomicInteger32 s_iSharedMemoryCounter;
+
+  ezStringBuilder sName;
+  sName.Format("/ezIpc_{0}_{1}", (ezUInt32)getpid(), s_iSharedMemoryCounter.Increment());
+
+  if (OpenSharedMemory(sName, true).Failed())
+  {
+    ezLog::Error("Could not create shared memory for IPC channel");
+    InternalDisconnect();
+    return;
+  }
+
+  Handshake handshake;
+  memset(&handshake, 0, sizeof(handshake));
+  handshake.m_uiMagic = SHARED_MAGIC_VALUE;
+  handshake.m_uiRingSize = RING_SIZE;
+  ezStringUtils::Copy(handshake.m_szSharedMemoryName, EZ_ARRAY_SIZE(handshake.m_szSharedMemoryName), sName);
+
+  // the socket was just connected and is empty, so this never blocks
+  if (send(m_iSocket, &handshake, sizeof(handshake), MSG_NOSIGNAL) != sizeof(handshake))
+  {
+    ezLog::Error("Could not send IPC shared memory handshake: {0}", strerror(errno));
+    InternalDisconnect();
+    return;
+  }
+
+  ezPipeChannel_linux::OnSocketConnected();
+}
+
+void ezSharedMemoryChannel_linux::OnSocketDataReceived(ezArrayPtr<const ezUInt8> data)
+{
+  // after the handshake the socket only carries wake-ups, which need no handling beyond having woken up the loop
+  if (m_pInputRing != nullptr || m_Mode == Mode::Server)
+    return;
+
+  const ezUInt32 uiCount = ezMath::Min<ezUInt32>(data.GetCount(), sizeof(Handshake) - m_uiHandshakeBytes);
+  memcpy(reinterpret_cast<ezUInt8*>(&m_Handshake) + m_uiHandshakeBytes, data.GetPtr(), uiCount);
+  m_uiHandshakeBytes += uiCount;
+
+  if (m_uiHandshakeBytes < sizeof(Handshake))
+    return;
+
+  m_Handshake.m_szSharedMemoryName[EZ_ARRAY_SIZE(m_Handshake.m_szSharedMemoryName) - 1] = '\0';
+
+  if (m_Handshake.m_uiMagic != SHARED_MAGIC_VALUE || m_Handshake.m_uiRingSize != RING_SIZE ||
+      OpenSharedMemory(m_Handshake.m_szSharedMemoryName, false).Failed())
+  {
+    ezLog::Error("Invalid IPC shared memory handshake");
+    InternalDisconnect();
+    return;
+  }
+
+  ezPipeChannel_linux::OnSocketConnected();
+}
+
+bool ezSharedMemoryChannel_linux::ProcessIncomingRing()
+{
+  if (m_pInputRing == nullptr)
+    return false;
+
+  const ezInt64 iWritePos = ezAtomicUtils::Read(m_pInputRing->m_iWritePos);
+  if (iWritePos == m_iInputReadPos)
+    return false;
+
+  // the data is handed out directly from the ring, it may wrap around at the end
+  const ezUInt32 uiCount = static_cast<ezUInt32>(iWritePos - m_iInputReadPos);
+  const ezUInt32 uiOffset = static_cast<ezUInt32>(m_iInputReadPos & (RING_SIZE - 1));
+  const ezUInt32 uiFirstPart = ezMath::Min<ezUInt32>(uiCount, RING_SIZE - uiOffset);
+
+  ReceiveMessageData(ezArrayPtr<const ezUInt8>(m_pInputData + uiOffset, uiFirstPart));
+  if (uiCount > uiFirstPart)
+  {
+    ReceiveMessageData(ezArrayPtr<const ezUInt8>(m_pInputData, uiCount - uiFirstPart));
+  }
+
+  // full barrier, the space is only released after the data was consumed
+  ezAtomicUtils::Add(m_pInputRing->m_iReadPos, static_cast<ezInt64>(uiCount));
+  m_iInputReadPos = iWritePos;
+
+  if (ezAtomicUtils::Set(m_pInputRing->m_iWriterWaiting, 0) != 0)
+  {
+    SendWakeUp();
+  }
+
+  return true;
+}
+
+bool ezSharedMemoryChannel_linux::ProcessOutgoingMessages()
+{
+  if (m_pOutputRing == nullptr)
+    return true;
+
+  ezInt64 iReadPos = ezAtomicUtils::Read(m_pOutputRing->m_iReadPos);
+  ezInt64 iWritePos = m_iOutputWritePos;
+
+  while (true)
+  {
+    const ezMemoryStreamStorage* pStorage = nullptr;
+    {
+      EZ_LOCK(m_OutputQueueMutex);
+      if (m_OutputQueue.IsEmpty())
+      {
+        m_OutputBlocked = false;
+        break;
+      }
+      pStorage = &m_OutputQueue.PeekFront();
+    }
+
+    ezUInt32 uiFree = RING_SIZE - static_cast<ezUInt32>(iWritePos - iReadPos);
+    if (uiFree == 0)
+    {
+      iReadPos = ezAtomicUtils::Read(m_pOutputRing->m_iReadPos);
+      uiFree = RING_SIZE - static_cast<ezUInt32>(iWritePos - iReadPos);
+
+      if (uiFree == 0)
+      {
+        // the reader wakes us up once it made room, PrepareWait checks again before sleeping
+        m_OutputBlocked = true;
+        ezAtomicUtils::Set(m_pOutputRing->m_iWriterWaiting, 1);
+        break;
+      }
+    }
+
+    const ezUInt32 uiCount = ezMath::Min<ezUInt32>(uiFree, pStorage->GetStorageSize() - m_uiOutputOffset);
+    const ezUInt32 uiOffset = static_cast<ezUInt32>(iWritePos & (RING_SIZE - 1));
+    const ezUInt32 uiFirstPart = ezMath::Min<ezUInt32>(uiCount, RING_SIZE - uiOffset);
+    const ezUInt8* pSource = pStorage->GetData() + m_uiOutputOffset;
+
+    memcpy(m_pOutputData + uiOffset, pSource, uiFirstPart);
+    memcpy(m_pOutputData, pSource + uiFirstPart, uiCount - uiFirstPart);
+
+    iWritePos += uiCount;
+    m_uiOutputOffset += uiCount;
+
+    if (m_uiOutputOffset == pStorage->GetStorageSize())
+    {
+      // message was sent
+      EZ_LOCK(m_OutputQueueMutex);
+      m_OutputQueue.PopFront();
+      m_uiOutputOffset = 0;
+    }
+  }
+
+  if (iWritePos != m_iOutputWritePos)
+  {
+    // full barrier, the data is only published after it was written
+    ezAtomicUtils::Add(m_pOutputRing->m_iWritePos, iWritePos - m_iOutputWritePos);
+    m_iOutputWritePos = iWritePos;
+
+    if (ezAtomicUtils::Set(m_pOutputRing->m_iReaderWaiting, 0) != 0)
+    {
+      SendWakeUp();
+    }
+  }
+
+  return true;
+}
+
+void ezSharedMemoryChannel_linux::SendWakeUp()
+{
+  if (m_iSocket == -1)
+    return;
+
+  // If the socket buffer is full, there are plenty of unread wake-ups already, so failures can be ignored.
+  const ezUInt8 uiWakeUp = 0;
+  send(m_iSocket, &uiWakeUp, 1, MSG_NOSIGNAL | MSG_DONTWAIT);
+}
+
+#endif
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Communication_Implementation_Linux_SharedMemoryChannel_linux);
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <Foundation/FoundationInternal.h>
+EZ_FOUNDATION_INTERNAL_HEADER
+
+#if EZ_ENABLED(EZ_PLATFORM_LINUX)
+
+#include <Foundation/Basics.h>
+#include <Foundation/Communication/Implementation/Linux/PipeChannel_linux.h>
+#include <Foundation/IO/MemoryMappedFile.h>
+
+/// \brief IPC channel that transfers the message data through two single-producer / single-consumer rings in shared memory.
+///
+/// The connection is established through the socket of ezPipeChannel_linux. Once connected, the server creates the shared memory
+/// and sends its name to the client. From then on the socket only carries single byte wake-up notifications, which are only sent
+/// when the other side announced that it is about to sleep. As long as both sides are busy, data is exchanged without any syscalls.
+class EZ_FOUNDATION_DLL ezSharedMemoryChannel_linux : public ezPipeChannel_linux
+{
+public:
+  ezSharedMemoryChannel_linux(const char* szAddress, Mode::Enum mode);
+  ~ezSharedMemoryChannel_linux();
+
+protected:
+  // All functions from here on down are run from worker thread only
+  virtual void InternalDisconnect() override;
+
+  virtual bool PrepareWait(pollfd& out_Fd) override;
+  virtual bool ProcessIO(ezInt16 iEvents) override;
+
+  virtual void OnSocketConnected() override;
+  virtual void OnSocketDataReceived(ezArrayPtr<const ezUInt8> data) override;
+  virtual bool ProcessOutgoingMessages() override;
+
+private:
+  /// \brief Read and write positions of one ring. Both count all bytes ever transferred and only grow.
+  struct RingHeader
+  {
+    alignas(64) volatile ezInt64 m_iWritePos; ///< Only advanced by the producer.
+    volatile ezInt32 m_iWriterWaiting;        ///< Set by the producer when the ring is full and it waits for the consumer.
+    alignas(64) volatile ezInt64 m_iReadPos;  ///< Only advanced by the consumer.
+    volatile ezInt32 m_iReaderWaiting;        ///< Set by the consumer before it waits for new data.
+  };
+
+  /// \brief Placed at the start of the shared memory, followed by the data of both rings.
+  struct SharedHeader
+  {
+    ezUInt32 m_uiMagic;
+    ezUInt32 m_uiRingSize;
+    RingHeader m_Rings[2]; ///< The server writes into the first ring, the client into the second.
+  };
+
+  /// \brief Sent by the server over the socket right after the connection was accepted.
+  struct Handshake
+  {
+    ezUInt32 m_uiMagic;
+    ezUInt32 m_uiRingSize;
+    char m_szSharedMemoryName[56];
+  };
+
+  enum Constants : ezUInt32
+  {
+    RING_SIZE = 1024 * 1024, ///< Must be a power of two. Larger messages are transferred in pieces.
+    SHARED_MAGIC_VALUE = 'ezSM',
+  };
+
+  ezResult OpenSharedMemory(const char* szName, bool bCreate);
+  void CloseSharedMemory();
+  bool ProcessIncomingRing();
+  void SendWakeUp();
+
+  ezMemoryMappedFile m_SharedMemory;
+
+  // Only accessed from worker thread
+  RingHeader* m_pInputRing = nullptr;
+  RingHeader* m_pOutputRing = nullptr;
+  const ezUInt8* m_pInputData = nullptr;
+  ezUInt8* m_pOutputData = nullptr;
+  ezInt64 m_iInputReadPos = 0;
+  ezInt64 m_iOutputWritePos = 0;
+
+  Handshake m_Handshake;
+  ezUInt32 m_uiHandshakeBytes = 0;
+};
+
+#endif
@@ -9,6 +9,8 @@ EZ_IMPLEMENT_SINGLETON(ezMessageLoop);
 
 #if EZ_ENABLED(EZ_PLATFORM_WINDOWS_DESKTOP)
 #include <Foundation/Communication/Implementation/Win/MessageLoop_win.h>
+#elif EZ_ENABLED(EZ_PLATFORM_LINUX)
+#include <Foundation/Communication/Implementation/Linux/MessageLoop_linux.h>
 #else
 #include <Foundation/Communication/Implementation/Mobile/MessageLoop_mobile.h>
 #endif
@@ -25,6 +27,8 @@ EZ_BEGIN_SUBSYSTEM_DECLARATION(Foundation, MessageLoop)
   {
     #if EZ_ENABLED(EZ_PLATFORM_WINDOWS_DESKTOP)
       EZ_DEFAULT_NEW(ezMessageLoop_win);
+    #elif EZ_ENABLED(EZ_PLATFORM_LINUX)
+      EZ_DEFAULT_NEW(ezMessageLoop_linux);
     #else
       EZ_DEFAULT_NEW(ezMessageLoop_mobile);
     #endif
@@ -47,6 +47,12 @@ public:
   /// \param mode Whether to run in client or server mode.
   static ezIpcChannel* CreatePipeChannel(const char* szAddress, Mode::Enum mode);
 
+  /// \brief Creates an IPC communication channel that transfers the messages through ring buffers in shared memory.
+  ///
+  /// The connection is established and monitored through a pipe with the given address, see CreatePipeChannel.
+  /// On platforms without shared memory channel support, this returns a pipe channel.
+  static ezIpcChannel* CreateSharedMemoryChannel(const char* szAddress, Mode::Enum mode);
+
   static ezIpcChannel* CreateNetworkChannel(const char* szAddress, Mode::Enum mode);
 
   /// \brief Connects async. On success, m_Events will be broadcasted.
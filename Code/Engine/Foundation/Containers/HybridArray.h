@@ -41,10 +41,7 @@ public:
 protected:
 
   /// \brief The fixed size array.
-  struct : ezAligned<EZ_ALIGNMENT_OF(T)>
-  {
-    ezUInt8 m_StaticData[Size * sizeof(T)];
-  };
+  alignas(EZ_ALIGNMENT_OF(T)) ezUInt8 m_StaticData[Size * sizeof(T)];
 
   EZ_ALWAYS_INLINE T* GetStaticArray()
   {
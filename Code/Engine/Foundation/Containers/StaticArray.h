@@ -54,10 +54,7 @@ private:
   const T* GetStaticArray() const;
 
   /// \brief The fixed size array.
-  struct : ezAligned<EZ_ALIGNMENT_OF(T)>
-  {
-    ezUInt8 m_Data[Capacity * sizeof(T)];
-  };
+  alignas(EZ_ALIGNMENT_OF(T)) ezUInt8 m_Data[Capacity * sizeof(T)];
 
   friend class ezArrayBase<T, ezStaticArray<T, Capacity>>;
 };
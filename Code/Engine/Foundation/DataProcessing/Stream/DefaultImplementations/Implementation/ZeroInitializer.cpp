@@ -34,6 +34,19 @@ ezResult ezProcessingStreamSpawnerZeroInitialized::UpdateStreamBindings()
 
 void ezProcessingStreamSpawnerZeroInitialized::InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
 {
+  if (m_pStream->GetDataLayout() == ezProcessingStream::DataLayout::SoA)
+  {
+    const ezUInt64 uiComponentSize = m_pStream->GetComponentSize();
+
+    for (ezUInt32 uiComponent = 0; uiComponent < m_pStream->GetComponentCount(); ++uiComponent)
+    {
+      ezUInt8* pComponentData = m_pStream->GetWritableComponentData<ezUInt8>(uiComponent);
+      ezMemoryUtils::ZeroFill<ezUInt8>(pComponentData + uiStartIndex * uiComponentSize, static_cast<size_t>(uiNumElements * uiComponentSize));
+    }
+
+    return;
+  }
+
   const ezUInt64 uiElementSize = m_pStream->GetElementSize();
   const ezUInt64 uiElementStride = m_pStream->GetElementStride();
 
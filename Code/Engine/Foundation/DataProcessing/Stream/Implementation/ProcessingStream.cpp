@@ -2,13 +2,18 @@
 
 #include <Foundation/Basics.h>
 #include <Foundation/DataProcessing/Stream/ProcessingStream.h>
+#include <Foundation/Memory/MemoryUtils.h>
 
-ezProcessingStream::ezProcessingStream(const char* szName, ezProcessingStream::DataType Type, ezUInt64 uiAlignment /*= 64*/)
+ezProcessingStream::ezProcessingStream(const char* szName, ezProcessingStream::DataType Type, DataLayout Layout /*= DataLayout::AoS*/,
+                                       ezUInt64 uiAlignment /*= 64*/)
     : m_pData(nullptr)
     , m_uiAlignment(uiAlignment)
     , m_uiNumElements(0)
+    , m_uiNumPaddedElements(0)
     , m_uiTypeSize(GetDataTypeSize(Type))
+    , m_uiComponentSize(GetDataTypeComponentSize(Type))
     , m_Type(Type)
+    , m_Layout(Layout)
     , m_Name()
 {
   m_Name.Assign(szName);
@@ -31,20 +36,28 @@ void ezProcessingStream::SetSize(ezUInt64 uiNumElements)
     return;
   }
 
+  // with the padding, every component array of an SoA stream starts at a cache line (for 4 byte components)
+  const ezUInt64 uiNumPaddedElements = ezMemoryUtils::AlignSize<ezUInt64>(uiNumElements, ElementPadding);
+  const size_t uiDataSize = static_cast<size_t>(uiNumPaddedElements * GetDataTypeSize(m_Type));
+
   /// \todo Allow to reuse memory from a pool ?
   if (m_uiAlignment > 0)
   {
-    m_pData = ezFoundation::GetAlignedAllocator()->Allocate(static_cast<size_t>(uiNumElements * GetDataTypeSize(m_Type)),
-                                                            static_cast<size_t>(m_uiAlignment));
+    m_pData = ezFoundation::GetAlignedAllocator()->Allocate(uiDataSize, static_cast<size_t>(m_uiAlignment));
   }
   else
   {
-    m_pData = ezFoundation::GetDefaultAllocator()->Allocate(static_cast<size_t>(uiNumElements * GetDataTypeSize(m_Type)), 0);
+    m_pData = ezFoundation::GetDefaultAllocator()->Allocate(uiDataSize, 0);
   }
 
   EZ_ASSERT_DEV(m_pData != nullptr, "Allocating {0} elements of {1} bytes each, with {2} bytes alignment, failed", uiNumElements,
                 ((ezUInt32)GetDataTypeSize(m_Type)), m_uiAlignment);
+
+  // chunked iteration also processes the padding elements, they must not contain garbage (e.g. NaNs or denormals)
+  ezMemoryUtils::ZeroFill<ezUInt8>(static_cast<ezUInt8*>(m_pData), uiDataSize);
+
   m_uiNumElements = uiNumElements;
+  m_uiNumPaddedElements = uiNumPaddedElements;
 }
 
 void ezProcessingStream::FreeData()
@@ -59,9 +72,12 @@ void ezProcessingStream::FreeData()
     {
       ezFoundation::GetDefaultAllocator()->Deallocate(m_pData);
     }
+
+    m_pData = nullptr;
   }
 
   m_uiNumElements = 0;
+  m_uiNumPaddedElements = 0;
 }
 
 size_t ezProcessingStream::GetDataTypeSize(DataType Type)
@@ -110,6 +126,35 @@ size_t ezProcessingStream::GetDataTypeSize(DataType Type)
   return 0;
 }
 
+size_t ezProcessingStream::GetDataTypeComponentSize(DataType Type)
+{
+  switch (Type)
+  {
+    case DataType::Half:
+    case DataType::Half2:
+    case DataType::Half3:
+    case DataType::Half4:
+    case DataType::Short2:
+    case DataType::Short4:
+      return 2;
+
+    case DataType::Float:
+    case DataType::Float2:
+    case DataType::Float3:
+    case DataType::Float4:
+    case DataType::Matrix4x4:
+    case DataType::Int:
+    case DataType::Int2:
+    case DataType::Int3:
+    case DataType::Int4:
+      return 4;
+  }
+
+  EZ_ASSERT_NOT_IMPLEMENTED;
+
+  return 0;
+}
+
 
 
 EZ_STATICLINK_FILE(Foundation, Foundation_DataProcessing_Stream_Implementation_ProcessingStream);
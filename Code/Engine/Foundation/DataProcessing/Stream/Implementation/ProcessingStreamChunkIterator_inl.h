@@ -0,0 +1,66 @@
+
+inline ezProcessingStreamChunkIterator::ezProcessingStreamChunkIterator(const ezProcessingStream* pStream, ezUInt64 uiNumElements, ezUInt64 uiStartIndex)
+{
+  EZ_ASSERT_DEV(pStream != nullptr, "Stream pointer may not be null!");
+  EZ_ASSERT_DEV(pStream->GetDataLayout() == ezProcessingStream::DataLayout::SoA || pStream->GetComponentCount() == 1,
+                "Only SoA streams and streams with a single component can be iterated in chunks");
+  EZ_ASSERT_DEV(uiStartIndex % ChunkSize == 0, "The start index ({0}) must be a multiple of the chunk size", uiStartIndex);
+  EZ_ASSERT_DEBUG(ezMemoryUtils::AlignSize<ezUInt64>(uiStartIndex + uiNumElements, ChunkSize) <= pStream->GetNumPaddedElements(),
+                  "Iterating over more elements than the stream contains");
+
+  m_pData = static_cast<ezUInt8*>(pStream->GetWritableData());
+  m_uiComponentSize = pStream->GetComponentSize();
+  m_uiComponentStride = pStream->GetNumPaddedElements() * m_uiComponentSize;
+  m_uiCurrentIndex = uiStartIndex;
+  m_uiEndIndex = uiStartIndex + uiNumElements;
+}
+
+EZ_ALWAYS_INLINE bool ezProcessingStreamChunkIterator::HasReachedEnd() const
+{
+  return m_uiCurrentIndex >= m_uiEndIndex;
+}
+
+EZ_ALWAYS_INLINE void ezProcessingStreamChunkIterator::Advance()
+{
+  m_uiCurrentIndex += ChunkSize;
+}
+
+EZ_ALWAYS_INLINE void ezProcessingStreamChunkIterator::Advance(ezUInt32 uiNumChunks)
+{
+  m_uiCurrentIndex += ChunkSize * uiNumChunks;
+}
+
+EZ_ALWAYS_INLINE ezUInt32 ezProcessingStreamChunkIterator::GetNumValidElements() const
+{
+  return static_cast<ezUInt32>(ezMath::Min<ezUInt64>(m_uiEndIndex - m_uiCurrentIndex, ChunkSize));
+}
+
+EZ_ALWAYS_INLINE ezSimdVec4b ezProcessingStreamChunkIterator::GetValidMask() const
+{
+  const ezUInt32 uiNumValid = GetNumValidElements();
+  return ezSimdVec4b(uiNumValid > 0, uiNumValid > 1, uiNumValid > 2, uiNumValid > 3);
+}
+
+EZ_ALWAYS_INLINE ezSimdVec4f ezProcessingStreamChunkIterator::Load(ezUInt32 uiComponent) const
+{
+  EZ_ASSERT_DEBUG(m_uiComponentSize == sizeof(float), "Only float streams can be loaded into SIMD registers");
+
+  ezSimdVec4f result;
+  result.Load<4>(GetComponent<const float>(uiComponent));
+  return result;
+}
+
+EZ_ALWAYS_INLINE void ezProcessingStreamChunkIterator::Store(const ezSimdVec4f& value, ezUInt32 uiComponent) const
+{
+  EZ_ASSERT_DEBUG(m_uiComponentSize == sizeof(float), "Only float streams can be stored from SIMD registers");
+
+  value.Store<4>(GetComponent<float>(uiComponent));
+}
+
+template <typename Type>
+EZ_ALWAYS_INLINE Type* ezProcessingStreamChunkIterator::GetComponent(ezUInt32 uiComponent) const
+{
+  EZ_ASSERT_DEBUG(sizeof(Type) == m_uiComponentSize, "Component type does not match the stream");
+
+  return reinterpret_cast<Type*>(m_pData + uiComponent * m_uiComponentStride + m_uiCurrentIndex * m_uiComponentSize);
+}
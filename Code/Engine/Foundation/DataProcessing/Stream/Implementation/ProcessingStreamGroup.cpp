@@ -70,13 +70,13 @@ void ezProcessingStreamGroup::ClearProcessors()
   m_Processors.Clear();
 }
 
-ezProcessingStream* ezProcessingStreamGroup::AddStream(const char* szName, ezProcessingStream::DataType Type)
+ezProcessingStream* ezProcessingStreamGroup::AddStream(const char* szName, ezProcessingStream::DataType Type, ezProcessingStream::DataLayout Layout)
 {
   // Treat adding a stream two times as an error (return null)
   if (GetStreamByName(szName))
     return nullptr;
 
-  ezProcessingStream* pStream = EZ_DEFAULT_NEW(ezProcessingStream, szName, Type, 64);
+  ezProcessingStream* pStream = EZ_DEFAULT_NEW(ezProcessingStream, szName, Type, Layout, 64);
 
   m_DataStreams.PushBack(pStream);
 
@@ -219,6 +219,20 @@ void ezProcessingStreamGroup::RunPendingDeletions()
     // Move the data
     for (ezProcessingStream* pStream : m_DataStreams)
     {
+      if (pStream->GetDataLayout() == ezProcessingStream::DataLayout::SoA)
+      {
+        const ezUInt64 uiComponentSize = pStream->GetComponentSize();
+
+        for (ezUInt32 uiComponent = 0; uiComponent < pStream->GetComponentCount(); ++uiComponent)
+        {
+          ezUInt8* pComponentData = pStream->GetWritableComponentData<ezUInt8>(uiComponent);
+
+          ezMemoryUtils::Copy<ezUInt8>(pComponentData + uiElementToRemove * uiComponentSize, pComponentData + uiLastActiveElementIndex * uiComponentSize, static_cast<size_t>(uiComponentSize));
+        }
+
+        continue;
+      }
+
       const ezUInt64 uiStreamElementStride = pStream->GetElementStride();
       const ezUInt64 uiStreamElementSize = pStream->GetElementSize();
       const void* pSourceData = ezMemoryUtils::AddByteOffset(pStream->GetData(), static_cast<ptrdiff_t>(uiLastActiveElementIndex * uiStreamElementStride));
@@ -4,6 +4,7 @@ ezProcessingStreamIterator<Type>::ezProcessingStreamIterator(const ezProcessingS
     : m_pCurrentPtr(nullptr), m_pEndPtr(nullptr), m_uiElementStride(0)
 {
   EZ_ASSERT_DEV(pStream != nullptr, "Stream pointer may not be null!");
+  EZ_ASSERT_DEV(pStream->GetDataLayout() == ezProcessingStream::DataLayout::AoS, "SoA streams have to be iterated with ezProcessingStreamChunkIterator");
 
   m_uiElementStride = pStream->GetElementStride();
 
@@ -42,6 +42,16 @@ public:
     Int4
   };
 
+  /// \brief How the components of the elements are arranged in memory.
+  enum class DataLayout
+  {
+    AoS, ///< All components of one element are stored together, e.g. xyz xyz xyz ...
+    SoA, ///< Each component is stored in its own array, e.g. xxx ... yyy ... zzz ..., which allows to process several elements with one SIMD instruction
+  };
+
+  /// \brief The number of elements is always rounded up to a multiple of this, so that chunked iteration never has to handle partial chunks.
+  static constexpr ezUInt32 ElementPadding = 16;
+
   /// \brief Returns a const pointer to the data casted to the type T, note that no type check is done!
   template <typename T>
   const T* GetData() const
@@ -75,18 +85,60 @@ public:
   ezUInt64 GetElementSize() const { return m_uiTypeSize; }
 
   /// \brief Returns the stride between two elements of the stream.
+  ///
+  /// For SoA streams this is the stride between two elements within one component array.
   ezUInt64 GetElementStride() const
   {
-    // For now this is the type size, but this method will help with introduction of interleaved streams etc.
-    return m_uiTypeSize;
+    return m_Layout == DataLayout::SoA ? m_uiComponentSize : m_uiTypeSize;
+  }
+
+  /// \brief Returns the memory layout of the stream.
+  DataLayout GetDataLayout() const { return m_Layout; }
+
+  /// \brief Returns the number of components of one element, e.g. 3 for Float3.
+  ezUInt32 GetComponentCount() const { return static_cast<ezUInt32>(m_uiTypeSize / m_uiComponentSize); }
+
+  /// \brief Returns the size of one component of an element, e.g. 4 for Float3.
+  ezUInt64 GetComponentSize() const { return m_uiComponentSize; }
+
+  /// \brief Returns the number of elements the storage was allocated for, which includes the padding.
+  ezUInt64 GetNumPaddedElements() const { return m_uiNumPaddedElements; }
+
+  /// \brief Returns a const pointer to the array of the given component, casted to the type T. Only valid for SoA streams.
+  template <typename T>
+  const T* GetComponentData(ezUInt32 uiComponent) const
+  {
+    return static_cast<const T*>(GetComponentData(uiComponent));
+  }
+
+  /// \brief Returns a const pointer to the start of the array of the given component. Only valid for SoA streams.
+  const void* GetComponentData(ezUInt32 uiComponent) const { return GetWritableComponentData(uiComponent); }
+
+  /// \brief Returns a non-const pointer to the array of the given component, casted to the type T. Only valid for SoA streams.
+  template <typename T>
+  T* GetWritableComponentData(ezUInt32 uiComponent) const
+  {
+    return static_cast<T*>(GetWritableComponentData(uiComponent));
+  }
+
+  /// \brief Returns a non-const pointer to the start of the array of the given component. Only valid for SoA streams.
+  void* GetWritableComponentData(ezUInt32 uiComponent) const
+  {
+    EZ_ASSERT_DEBUG(m_Layout == DataLayout::SoA, "Component arrays are only available for SoA streams");
+    EZ_ASSERT_DEBUG(uiComponent < GetComponentCount(), "Invalid component index {0}", uiComponent);
+
+    return static_cast<ezUInt8*>(m_pData) + uiComponent * m_uiNumPaddedElements * m_uiComponentSize;
   }
 
   static size_t GetDataTypeSize(DataType Type);
 
+  /// \brief Returns the size of a single component of the given data type, e.g. 2 for Half3.
+  static size_t GetDataTypeComponentSize(DataType Type);
+
 protected:
   friend class ezProcessingStreamGroup;
 
-  ezProcessingStream(const char* szName, DataType Type, ezUInt64 uiAlignment = 64);
+  ezProcessingStream(const char* szName, DataType Type, DataLayout Layout = DataLayout::AoS, ezUInt64 uiAlignment = 64);
 
   void SetSize(ezUInt64 uiNumElements);
 
@@ -98,10 +150,16 @@ protected:
 
   ezUInt64 m_uiNumElements;
 
+  ezUInt64 m_uiNumPaddedElements;
+
   ezUInt64 m_uiTypeSize;
 
+  ezUInt64 m_uiComponentSize;
+
   DataType m_Type;
 
+  DataLayout m_Layout;
+
   ezHashedString m_Name;
 };
 
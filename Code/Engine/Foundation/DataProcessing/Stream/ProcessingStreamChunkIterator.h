@@ -0,0 +1,62 @@
+#pragma once
+
+#include <Foundation/DataProcessing/Stream/ProcessingStream.h>
+#include <Foundation/Memory/MemoryUtils.h>
+#include <Foundation/SimdMath/SimdVec4b.h>
+#include <Foundation/SimdMath/SimdVec4f.h>
+
+/// \brief Helper class to iterate over stream elements in chunks of four, which matches the width of ezSimdVec4f.
+///
+/// For SoA streams, Load() and Store() give access to one component of all elements of the current chunk as one ezSimdVec4f,
+/// so a Float3 stream is processed with three SIMD operations per four elements instead of four unaligned ezVec3 operations.
+/// Single component streams (e.g. Float) are the same in both layouts and can be iterated this way as well.
+///
+/// The start index must be a multiple of ChunkSize. Since streams are padded (see ezProcessingStream::ElementPadding), the last chunk
+/// is always complete, but may contain elements beyond the requested range. Processing these is harmless for plain arithmetic,
+/// anything with side effects (e.g. removing elements) has to check GetValidMask() or GetNumValidElements().
+class ezProcessingStreamChunkIterator
+{
+public:
+  /// \brief The number of elements in each chunk.
+  static constexpr ezUInt32 ChunkSize = 4;
+
+  /// \brief Constructor.
+  ezProcessingStreamChunkIterator(const ezProcessingStream* pStream, ezUInt64 uiNumElements, ezUInt64 uiStartIndex);
+
+  /// \brief Returns true if the iterator has reached the end of the stream or the number of elements it should iterate over.
+  bool HasReachedEnd() const;
+
+  /// \brief Advances to the next chunk.
+  void Advance();
+
+  /// \brief Advances by the given number of chunks.
+  void Advance(ezUInt32 uiNumChunks);
+
+  /// \brief Returns the index of the first element in the current chunk.
+  ezUInt64 GetCurrentIndex() const { return m_uiCurrentIndex; }
+
+  /// \brief Returns how many elements of the current chunk are within the range that should be iterated over.
+  ezUInt32 GetNumValidElements() const;
+
+  /// \brief Returns which lanes of the current chunk are within the range that should be iterated over.
+  ezSimdVec4b GetValidMask() const;
+
+  /// \brief Loads the given component of all elements in the current chunk. Only for streams with float components.
+  ezSimdVec4f Load(ezUInt32 uiComponent = 0) const;
+
+  /// \brief Stores the given component of all elements in the current chunk. Only for streams with float components.
+  void Store(const ezSimdVec4f& value, ezUInt32 uiComponent = 0) const;
+
+  /// \brief Returns a pointer to the given component of the first element of the current chunk, the other elements of the chunk follow directly.
+  template <typename Type>
+  Type* GetComponent(ezUInt32 uiComponent = 0) const;
+
+protected:
+  ezUInt8* m_pData;
+  ezUInt64 m_uiComponentSize;
+  ezUInt64 m_uiComponentStride;
+  ezUInt64 m_uiCurrentIndex;
+  ezUInt64 m_uiEndIndex;
+};
+
+#include <Foundation/DataProcessing/Stream/Implementation/ProcessingStreamChunkIterator_inl.h>
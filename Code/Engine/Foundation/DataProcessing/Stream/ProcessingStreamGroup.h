@@ -44,7 +44,9 @@ public:
   void ClearProcessors();
 
   /// \brief Adds a stream with the given name to the stream group. Adding a stream two times with the same name will return nullptr for the second attempt to signal an error.
-  ezProcessingStream* AddStream(const char* szName, ezProcessingStream::DataType Type);
+  ///
+  /// Streams that are mostly processed by SIMD code should use the SoA layout, see ezProcessingStreamChunkIterator.
+  ezProcessingStream* AddStream(const char* szName, ezProcessingStream::DataType Type, ezProcessingStream::DataLayout Layout = ezProcessingStream::DataLayout::AoS);
 
   /// \brief Removes the stream with the given name, if it exists.
   void RemoveStreamByName(const char* szName);
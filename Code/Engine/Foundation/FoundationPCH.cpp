@@ -37,6 +37,9 @@ EZ_STATICLINK_LIBRARY(Foundation)
   EZ_STATICLINK_REFERENCE(Foundation_Communication_Implementation_GlobalEvent);
   EZ_STATICLINK_REFERENCE(Foundation_Communication_Implementation_IpcChannel);
   EZ_STATICLINK_REFERENCE(Foundation_Communication_Implementation_IpcChannelEnet);
+  EZ_STATICLINK_REFERENCE(Foundation_Communication_Implementation_Linux_MessageLoop_linux);
+  EZ_STATICLINK_REFERENCE(Foundation_Communication_Implementation_Linux_PipeChannel_linux);
+  EZ_STATICLINK_REFERENCE(Foundation_Communication_Implementation_Linux_SharedMemoryChannel_linux);
   EZ_STATICLINK_REFERENCE(Foundation_Communication_Implementation_Message);
   EZ_STATICLINK_REFERENCE(Foundation_Communication_Implementation_MessageLoop);
   EZ_STATICLINK_REFERENCE(Foundation_Communication_Implementation_Mobile_MessageLoop_mobile);
@@ -110,6 +113,7 @@ EZ_STATICLINK_LIBRARY(Foundation)
   EZ_STATICLINK_REFERENCE(Foundation_Memory_Implementation_MemoryTracker);
   EZ_STATICLINK_REFERENCE(Foundation_Memory_Implementation_MemoryUtils);
   EZ_STATICLINK_REFERENCE(Foundation_Memory_Implementation_PageAllocator);
+  EZ_STATICLINK_REFERENCE(Foundation_Memory_Implementation_StackAllocator);
   EZ_STATICLINK_REFERENCE(Foundation_Memory_Policies_GuardedAllocation);
   EZ_STATICLINK_REFERENCE(Foundation_Profiling_Implementation_Profiling);
   EZ_STATICLINK_REFERENCE(Foundation_Reflection_Implementation_PropertyAttributes);
@@ -154,6 +158,7 @@ EZ_STATICLINK_LIBRARY(Foundation)
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskSystemTasks);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskSystemThreads);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskSystemUtils);
+  EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskWorkStealingQueue);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskWorkerThread);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_Thread);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_ThreadSignal);
@@ -9,22 +9,18 @@
 void ezArchiveBuilder::AddFolder(const char* szAbsFolderPath,
   ezArchiveCompressionMode defaultMode /*= ezArchiveCompressionMode::Uncompressed*/, InclusionCallback callback /*= InclusionCallback()*/)
 {
-#if EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS)
-  ezFileSystemIterator fileIt;
-
+#if EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS) && EZ_ENABLED(EZ_SUPPORTS_FILE_STATS)
   ezStringBuilder sBasePath = szAbsFolderPath;
   sBasePath.MakeCleanPath();
 
-  if (fileIt.StartSearch(sBasePath, ezFileSystemIteratorFlags::ReportFilesRecursive).Failed())
-    return;
+  ezDynamicArray<ezFileStats> files;
+  ezOSFile::GatherAllItemsInFolderParallel(files, sBasePath, ezFileSystemIteratorFlags::ReportFilesRecursive);
 
   ezStringBuilder fullPath;
   ezStringBuilder relPath;
 
-  do
+  for (const ezFileStats& stat : files)
   {
-    const auto& stat = fileIt.GetStats();
-
     stat.GetFullPath(fullPath);
     relPath = fullPath;
 
@@ -54,8 +50,7 @@ void ezArchiveBuilder::AddFolder(const char* szAbsFolderPath,
       e.m_sRelTargetPath = relPath;
       e.m_CompressionMode = compression;
     }
-
-  } while (fileIt.Next().Succeeded());
+  }
 #else
   EZ_ASSERT_NOT_IMPLEMENTED;
 #endif
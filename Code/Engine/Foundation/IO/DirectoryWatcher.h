@@ -2,6 +2,7 @@
 
 #include <Foundation/Basics.h>
 #include <Foundation/Strings/String.h>
+#include <Foundation/Time/Time.h>
 #include <Foundation/Types/Bitflags.h>
 #include <Foundation/Types/Delegate.h>
 
@@ -35,7 +36,8 @@ public:
       Writes = EZ_BIT(1),        ///< Watch for writes.
       Creates = EZ_BIT(2),       ///< Watch for newly created files.
       Renames = EZ_BIT(3),       ///< Watch for renames.
-      Subdirectories = EZ_BIT(4) ///< Watch files in subdirectories recursively.
+      Subdirectories = EZ_BIT(4), ///< Watch files in subdirectories recursively.
+      Default = 0
     };
 
     struct Bits
@@ -74,8 +76,20 @@ public:
   /// \note There might be multiple changes on the same file reported.
   void EnumerateChanges(EnumerateChangesFunction func);
 
+  /// \brief
+  ///   Sets for how long changes are collected before EnumerateChanges reports them.
+  ///
+  /// Only used where changes are gathered by a background thread (Linux). Changes are reported as one batch once no new change
+  /// arrived for this long, and repeated modifications, temporary files and chains of renames within a batch are merged.
+  void SetCoalescingWindow(ezTime window) { m_CoalescingWindow = window; }
+
+  /// \brief
+  ///   Returns the time set with SetCoalescingWindow().
+  ezTime GetCoalescingWindow() const { return m_CoalescingWindow; }
+
 private:
   ezString m_sDirectoryPath;
+  ezTime m_CoalescingWindow = ezTime::Milliseconds(100);
   ezDirectoryWatcherImpl* m_pImpl = nullptr;
 };
 
@@ -0,0 +1,668 @@
+#pragma once
+
+#include <Foundation/FoundationInternal.h>
+EZ_FOUNDATION_INTERNAL_HEADER
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Containers/HashSet.h>
+#include <Foundation/Containers/HashTable.h>
+#include <Foundation/IO/DirectoryWatcher.h>
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Threading/Lock.h>
+#include <Foundation/Threading/Mutex.h>
+#include <Foundation/Threading/Thread.h>
+#include <Foundation/Types/UniquePtr.h>
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct ezDirectoryWatcherImpl;
+
+class ezDirectoryWatcherThread : public ezThread
+{
+public:
+  ezDirectoryWatcherThread(ezDirectoryWatcherImpl* pImpl)
+    : ezThread("ezDirectoryWatcher")
+    , m_pImpl(pImpl)
+  {
+  }
+
+private:
+  virtual ezUInt32 Run() override;
+
+  ezDirectoryWatcherImpl* m_pImpl;
+};
+
+/// inotify only watches a single directory per watch descriptor, so every sub-directory gets its own watch.
+/// A background thread reads the events and records them as changes relative to the watched directory, which are
+/// handed out by EnumerateChanges once no new change has arrived for the coalescing window.
+struct ezDirectoryWatcherImpl
+{
+  struct Change
+  {
+    ezString m_sPath;
+    ezDirectoryWatcherAction m_Action;
+  };
+
+  void AddWatch(const ezString& sRelativePath, bool bReportContents);
+  void RenameWatches(const ezString& sOldPath, const ezString& sNewPath);
+  void RemoveWatches(const ezString& sPath);
+
+  void RenameExistingPaths(const ezString& sOldPath, const ezString& sNewPath);
+  void RemoveExistingPaths(const ezString& sPath);
+
+  void ReadEvents();
+  void ProcessEvent(const inotify_event* pEvent);
+  void FlushPendingMove();
+
+  void AddChange(const ezString& sPath, ezDirectoryWatcherAction action);
+  void AddRename(const ezString& sOldPath, const ezString& sNewPath, bool bNewPathExisted);
+
+  ezString m_sRootPath;
+  ezBitflags<ezDirectoryWatcher::Watch> m_WhatToWatch;
+  ezUInt32 m_uiInotifyMask = 0;
+  int m_iInotifyFd = -1;
+  int m_WakeupPipe[2] = {-1, -1};
+  ezUniquePtr<ezDirectoryWatcherThread> m_pThread;
+
+  // only accessed by the background thread while it runs
+  ezHashTable<int, ezString> m_WatchToPath;
+  // inotify does not report that a rename replaced a file, so all entries of the watched directories are tracked
+  ezHashSet<ezString> m_ExistingPaths;
+  // the thread only has a small stack, so the events are read into a heap buffer
+  ezDynamicArray<ezUInt8> m_EventBuffer;
+  ezUInt32 m_uiPendingMoveCookie = 0;
+  ezString m_sPendingMovePath;
+  bool m_bPendingMoveIsDirectory = false;
+
+  // protected by m_Mutex
+  ezMutex m_Mutex;
+  ezDynamicArray<Change> m_Changes;
+  ezHashTable<ezString, ezUInt32> m_LastChangeForPath;
+  ezTime m_FirstChangeTime;
+  ezTime m_LastChangeTime;
+};
+
+ezUInt32 ezDirectoryWatcherThread::Run()
+{
+  m_pImpl->ReadEvents();
+  return 0;
+}
+
+ezDirectoryWatcher::ezDirectoryWatcher()
+  : m_pImpl(EZ_DEFAULT_NEW(ezDirectoryWatcherImpl))
+{
+}
+
+ezResult ezDirectoryWatcher::OpenDirectory(const ezString& absolutePath, ezBitflags<Watch> whatToWatch)
+{
+  EZ_ASSERT_DEV(m_sDirectoryPath.IsEmpty(), "Directory already open, call CloseDirectory first!");
+  ezStringBuilder sPath(absolutePath);
+  sPath.MakeCleanPath();
+  sPath.Trim("", "/");
+
+  m_pImpl->m_sRootPath = sPath;
+  m_pImpl->m_WhatToWatch = whatToWatch;
+
+  // Reads are reported as modifications, the same as on Windows. Creating and deleting sub-directories has to be
+  // tracked in any case to keep the watches up to date.
+  ezUInt32 uiMask = IN_ONLYDIR | IN_EXCL_UNLINK;
+  if (whatToWatch.IsSet(Watch::Reads))
+    uiMask |= IN_ACCESS;
+  if (whatToWatch.IsSet(Watch::Writes))
+    uiMask |= IN_MODIFY;
+  if (whatToWatch.IsSet(Watch::Creates))
+    uiMask |= IN_CREATE | IN_DELETE;
+  if (whatToWatch.IsSet(Watch::Renames))
+    uiMask |= IN_MOVED_FROM | IN_MOVED_TO | IN_CREATE | IN_DELETE;
+  if (whatToWatch.IsSet(Watch::Subdirectories))
+    uiMask |= IN_CREATE | IN_MOVED_FROM | IN_MOVED_TO;
+  m_pImpl->m_uiInotifyMask = uiMask;
+
+  m_pImpl->m_iInotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (m_pImpl->m_iInotifyFd < 0)
+  {
+    ezLog::Error("inotify_init1 failed: {0}", strerror(errno));
+    return EZ_FAILURE;
+  }
+
+  if (pipe2(m_pImpl->m_WakeupPipe, O_CLOEXEC) != 0)
+  {
+    close(m_pImpl->m_iInotifyFd);
+    m_pImpl->m_iInotifyFd = -1;
+    return EZ_FAILURE;
+  }
+
+  m_pImpl->AddWatch(ezString(), false);
+
+  if (m_pImpl->m_WatchToPath.IsEmpty())
+  {
+    close(m_pImpl->m_iInotifyFd);
+    close(m_pImpl->m_WakeupPipe[0]);
+    close(m_pImpl->m_WakeupPipe[1]);
+    m_pImpl->m_iInotifyFd = -1;
+    m_pImpl->m_WakeupPipe[0] = -1;
+    m_pImpl->m_WakeupPipe[1] = -1;
+    return EZ_FAILURE;
+  }
+
+  m_pImpl->m_pThread = EZ_DEFAULT_NEW(ezDirectoryWatcherThread, m_pImpl);
+  m_pImpl->m_pThread->Start();
+
+  m_sDirectoryPath = sPath;
+
+  return EZ_SUCCESS;
+}
+
+void ezDirectoryWatcher::CloseDirectory()
+{
+  if (!m_sDirectoryPath.IsEmpty())
+  {
+    // wake up the background thread, it stops as soon as the pipe becomes readable
+    const char wakeup = 0;
+    const ssize_t iWritten = write(m_pImpl->m_WakeupPipe[1], &wakeup, 1);
+    EZ_IGNORE_UNUSED(iWritten);
+    m_pImpl->m_pThread->Join();
+    m_pImpl->m_pThread.Clear();
+
+    close(m_pImpl->m_iInotifyFd);
+    close(m_pImpl->m_WakeupPipe[0]);
+    close(m_pImpl->m_WakeupPipe[1]);
+    m_pImpl->m_iInotifyFd = -1;
+    m_pImpl->m_WakeupPipe[0] = -1;
+    m_pImpl->m_WakeupPipe[1] = -1;
+
+    m_pImpl->m_WatchToPath.Clear();
+    m_pImpl->m_ExistingPaths.Clear();
+    m_pImpl->m_EventBuffer.Clear();
+    m_pImpl->m_uiPendingMoveCookie = 0;
+    m_pImpl->m_sPendingMovePath.Clear();
+    m_pImpl->m_Changes.Clear();
+    m_pImpl->m_LastChangeForPath.Clear();
+
+    m_sDirectoryPath.Clear();
+  }
+}
+
+ezDirectoryWatcher::~ezDirectoryWatcher()
+{
+  CloseDirectory();
+  EZ_DEFAULT_DELETE(m_pImpl);
+}
+
+void ezDirectoryWatcher::EnumerateChanges(EnumerateChangesFunction func)
+{
+  EZ_ASSERT_DEV(!m_sDirectoryPath.IsEmpty(), "No directory opened!");
+
+  ezDynamicArray<ezDirectoryWatcherImpl::Change> changes;
+
+  {
+    EZ_LOCK(m_pImpl->m_Mutex);
+
+    if (m_pImpl->m_Changes.IsEmpty())
+      return;
+
+    // wait until a burst of changes is over, but don't hold changes back forever if files keep changing
+    const ezTime tNow = ezTime::Now();
+    if (tNow - m_pImpl->m_LastChangeTime < m_CoalescingWindow && tNow - m_pImpl->m_FirstChangeTime < m_CoalescingWindow * 10.0)
+      return;
+
+    changes.Swap(m_pImpl->m_Changes);
+    m_pImpl->m_LastChangeForPath.Clear();
+  }
+
+  for (const auto& change : changes)
+  {
+    if (change.m_Action != ezDirectoryWatcherAction::None)
+    {
+      func(change.m_sPath, change.m_Action);
+    }
+  }
+}
+
+void ezDirectoryWatcherImpl::AddWatch(const ezString& sRelativePath, bool bReportContents)
+{
+  ezStringBuilder sAbsolutePath = m_sRootPath;
+  sAbsolutePath.AppendPath(sRelativePath);
+
+  const int iWatch = inotify_add_watch(m_iInotifyFd, sAbsolutePath, m_uiInotifyMask);
+  if (iWatch < 0)
+  {
+    ezLog::Warning("Failed to watch directory '{0}': {1}", sAbsolutePath, strerror(errno));
+    return;
+  }
+
+  m_WatchToPath[iWatch] = sRelativePath;
+
+  DIR* pDir = opendir(sAbsolutePath);
+  if (pDir == nullptr)
+    return;
+
+  ezStringBuilder sChildPath;
+  while (dirent* pEntry = readdir(pDir))
+  {
+    if (strcmp(pEntry->d_name, ".") == 0 || strcmp(pEntry->d_name, "..") == 0)
+      continue;
+
+    sChildPath = sRelativePath;
+    sChildPath.AppendPath(pEntry->d_name);
+
+    m_ExistingPaths.Insert(sChildPath);
+
+    bool bIsDirectory = pEntry->d_type == DT_DIR;
+    if (pEntry->d_type == DT_UNKNOWN)
+    {
+      struct stat info;
+      ezStringBuilder sAbsoluteChildPath = m_sRootPath;
+      sAbsoluteChildPath.AppendPath(sChildPath);
+      bIsDirectory = stat(sAbsoluteChildPath, &info) == 0 && S_ISDIR(info.st_mode);
+    }
+
+    // files in a new directory may have been created before the watch was added, so they are reported here
+    if (bReportContents && m_WhatToWatch.IsSet(ezDirectoryWatcher::Watch::Creates))
+    {
+      AddChange(sChildPath, ezDirectoryWatcherAction::Added);
+    }
+
+    if (bIsDirectory && m_WhatToWatch.IsSet(ezDirectoryWatcher::Watch::Subdirectories))
+    {
+      AddWatch(sChildPath, bReportContents);
+    }
+  }
+
+  closedir(pDir);
+}
+
+void ezDirectoryWatcherImpl::RenameWatches(const ezString& sOldPath, const ezString& sNewPath)
+{
+  ezStringBuilder sPath;
+  for (auto it = m_WatchToPath.GetIterator(); it.IsValid(); ++it)
+  {
+    sPath = it.Value();
+    if (sPath == sOldPath || (sPath.StartsWith(sOldPath) && sPath.GetData()[sOldPath.GetElementCount()] == '/'))
+    {
+      sPath.ReplaceSubString(sPath.GetData(), sPath.GetData() + sOldPath.GetElementCount(), sNewPath);
+      it.Value() = sPath;
+    }
+  }
+}
+
+void ezDirectoryWatcherImpl::RemoveWatches(const ezString& sPath)
+{
+  ezHybridArray<int, 16> watchesToRemove;
+  for (auto it = m_WatchToPath.GetIterator(); it.IsValid(); ++it)
+  {
+    const ezString& sWatchPath = it.Value();
+    if (sWatchPath == sPath || (sWatchPath.StartsWith(sPath) && sWatchPath.GetData()[sPath.GetElementCount()] == '/'))
+    {
+      watchesToRemove.PushBack(it.Key());
+    }
+  }
+
+  for (int iWatch : watchesToRemove)
+  {
+    inotify_rm_watch(m_iInotifyFd, iWatch);
+    m_WatchToPath.Remove(iWatch);
+  }
+}
+
+void ezDirectoryWatcherImpl::RenameExistingPaths(const ezString& sOldPath, const ezString& sNewPath)
+{
+  ezHybridArray<ezString, 16> pathsToRename;
+  for (const ezString& sPath : m_ExistingPaths)
+  {
+    if (sPath == sOldPath || (sPath.StartsWith(sOldPath) && sPath.GetData()[sOldPath.GetElementCount()] == '/'))
+    {
+      pathsToRename.PushBack(sPath);
+    }
+  }
+
+  ezStringBuilder sPath;
+  for (const ezString& sOldEntry : pathsToRename)
+  {
+    m_ExistingPaths.Remove(sOldEntry);
+
+    sPath = sOldEntry;
+    sPath.ReplaceSubString(sPath.GetData(), sPath.GetData() + sOldPath.GetElementCount(), sNewPath);
+    m_ExistingPaths.Insert(sPath);
+  }
+}
+
+void ezDirectoryWatcherImpl::RemoveExistingPaths(const ezString& sPath)
+{
+  ezHybridArray<ezString, 16> pathsToRemove;
+  for (const ezString& sEntry : m_ExistingPaths)
+  {
+    if (sEntry == sPath || (sEntry.StartsWith(sPath) && sEntry.GetData()[sPath.GetElementCount()] == '/'))
+    {
+      pathsToRemove.PushBack(sEntry);
+    }
+  }
+
+  for (const ezString& sEntry : pathsToRemove)
+  {
+    m_ExistingPaths.Remove(sEntry);
+  }
+}
+
+void ezDirectoryWatcherImpl::ReadEvents()
+{
+  // the allocator alignment is sufficient for inotify_event
+  m_EventBuffer.SetCountUninitialized(64 * 1024);
+  ezUInt8* buffer = m_EventBuffer.GetData();
+
+  while (true)
+  {
+    pollfd fds[2];
+    fds[0].fd = m_iInotifyFd;
+    fds[0].events = POLLIN;
+    fds[0].revents = 0;
+    fds[1].fd = m_WakeupPipe[0];
+    fds[1].events = POLLIN;
+    fds[1].revents = 0;
+
+    // the two halves of a rename are queued together, if the second one does not follow, the file was moved out of the watched directory
+    const int iTimeoutMS = m_uiPendingMoveCookie != 0 ? 10 : -1;
+
+    const int iResult = poll(fds, 2, iTimeoutMS);
+    if (iResult < 0)
+    {
+      if (errno == EINTR)
+        continue;
+
+      ezLog::Error("Polling inotify events of '{0}' failed: {1}", m_sRootPath, strerror(errno));
+      return;
+    }
+
+    if (fds[1].revents != 0)
+      return;
+
+    if (iResult == 0)
+    {
+      FlushPendingMove();
+      continue;
+    }
+
+    const ssize_t iNumBytes = read(m_iInotifyFd, buffer, m_EventBuffer.GetCount());
+    if (iNumBytes <= 0)
+    {
+      if (iNumBytes < 0 && (errno == EINTR || errno == EAGAIN))
+        continue;
+
+      ezLog::Error("Reading inotify events of '{0}' failed: {1}", m_sRootPath, strerror(errno));
+      return;
+    }
+
+    for (ssize_t iOffset = 0; iOffset < iNumBytes;)
+    {
+      const inotify_event* pEvent = reinterpret_cast<const inotify_event*>(buffer + iOffset);
+      ProcessEvent(pEvent);
+      iOffset += sizeof(inotify_event) + pEvent->len;
+    }
+  }
+}
+
+void ezDirectoryWatcherImpl::ProcessEvent(const inotify_event* pEvent)
+{
+  if ((pEvent->mask & IN_Q_OVERFLOW) != 0)
+  {
+    ezLog::Warning("Too many file changes in '{0}', some changes were lost", m_sRootPath);
+    return;
+  }
+
+  if ((pEvent->mask & IN_IGNORED) != 0)
+  {
+    // the directory was deleted or moved out of the watched directory
+    m_WatchToPath.Remove(pEvent->wd);
+    return;
+  }
+
+  const ezString* pDirectory = m_WatchToPath.GetValue(pEvent->wd);
+  if (pDirectory == nullptr || pEvent->len == 0)
+    return;
+
+  ezStringBuilder sPath = *pDirectory;
+  sPath.AppendPath(pEvent->name);
+
+  const bool bIsDirectory = (pEvent->mask & IN_ISDIR) != 0;
+  const bool bWatchSubdirectories = m_WhatToWatch.IsSet(ezDirectoryWatcher::Watch::Subdirectories);
+
+  if (m_uiPendingMoveCookie != 0 && ((pEvent->mask & IN_MOVED_TO) == 0 || pEvent->cookie != m_uiPendingMoveCookie))
+  {
+    FlushPendingMove();
+  }
+
+  if ((pEvent->mask & IN_MOVED_FROM) != 0)
+  {
+    m_uiPendingMoveCookie = pEvent->cookie;
+    m_sPendingMovePath = sPath;
+    m_bPendingMoveIsDirectory = bIsDirectory;
+    return;
+  }
+
+  if ((pEvent->mask & IN_MOVED_TO) != 0)
+  {
+    if (m_uiPendingMoveCookie != 0)
+    {
+      if (bIsDirectory && bWatchSubdirectories)
+      {
+        RenameWatches(m_sPendingMovePath, sPath);
+      }
+
+      const bool bNewPathExisted = m_ExistingPaths.Contains(sPath);
+      RenameExistingPaths(m_sPendingMovePath, sPath);
+
+      if (m_WhatToWatch.IsSet(ezDirectoryWatcher::Watch::Renames))
+      {
+        AddRename(m_sPendingMovePath, sPath, bNewPathExisted);
+      }
+
+      m_uiPendingMoveCookie = 0;
+      m_sPendingMovePath.Clear();
+      return;
+    }
+
+    // moved in from outside of the watched directory
+    const bool bNewPathExisted = !m_ExistingPaths.Insert(sPath);
+
+    if (m_WhatToWatch.IsSet(ezDirectoryWatcher::Watch::Renames))
+    {
+      AddChange(sPath, bNewPathExisted ? ezDirectoryWatcherAction::Modified : ezDirectoryWatcherAction::Added);
+    }
+
+    if (bIsDirectory && bWatchSubdirectories)
+    {
+      AddWatch(sPath, true);
+    }
+    return;
+  }
+
+  if ((pEvent->mask & IN_CREATE) != 0)
+  {
+    m_ExistingPaths.Insert(sPath);
+
+    if (m_WhatToWatch.IsSet(ezDirectoryWatcher::Watch::Creates))
+    {
+      AddChange(sPath, ezDirectoryWatcherAction::Added);
+    }
+
+    if (bIsDirectory && bWatchSubdirectories)
+    {
+      AddWatch(sPath, true);
+    }
+    return;
+  }
+
+  if ((pEvent->mask & IN_DELETE) != 0)
+  {
+    RemoveExistingPaths(sPath);
+
+    if (m_WhatToWatch.IsSet(ezDirectoryWatcher::Watch::Creates))
+    {
+      AddChange(sPath, ezDirectoryWatcherAction::Removed);
+    }
+    return;
+  }
+
+  if ((pEvent->mask & (IN_MODIFY | IN_ACCESS)) != 0)
+  {
+    AddChange(sPath, ezDirectoryWatcherAction::Modified);
+  }
+}
+
+void ezDirectoryWatcherImpl::FlushPendingMove()
+{
+  if (m_uiPendingMoveCookie == 0)
+    return;
+
+  // moved out of the watched directory
+  if (m_bPendingMoveIsDirectory)
+  {
+    RemoveWatches(m_sPendingMovePath);
+  }
+
+  RemoveExistingPaths(m_sPendingMovePath);
+
+  if (m_WhatToWatch.IsSet(ezDirectoryWatcher::Watch::Renames))
+  {
+    AddChange(m_sPendingMovePath, ezDirectoryWatcherAction::Removed);
+  }
+
+  m_uiPendingMoveCookie = 0;
+  m_sPendingMovePath.Clear();
+}
+
+void ezDirectoryWatcherImpl::AddChange(const ezString& sPath, ezDirectoryWatcherAction action)
+{
+  EZ_LOCK(m_Mutex);
+
+  const ezTime tNow = ezTime::Now();
+  if (m_Changes.IsEmpty())
+  {
+    m_FirstChangeTime = tNow;
+  }
+  m_LastChangeTime = tNow;
+
+  ezUInt32 uiIndex = 0;
+  if (m_LastChangeForPath.TryGetValue(sPath, uiIndex))
+  {
+    Change& lastChange = m_Changes[uiIndex];
+
+    switch (action)
+    {
+      case ezDirectoryWatcherAction::Modified:
+        // the file was already reported as added or modified in this batch
+        if (lastChange.m_Action == ezDirectoryWatcherAction::Added || lastChange.m_Action == ezDirectoryWatcherAction::Modified)
+          return;
+
+        if (lastChange.m_Action == ezDirectoryWatcherAction::Removed)
+        {
+          // the file was replaced
+          lastChange.m_Action = ezDirectoryWatcherAction::Modified;
+          return;
+        }
+        break;
+
+      case ezDirectoryWatcherAction::Removed:
+        if (lastChange.m_Action == ezDirectoryWatcherAction::Added)
+        {
+          // a temporary file, nobody needs to know about it
+          lastChange.m_Action = ezDirectoryWatcherAction::None;
+          m_LastChangeForPath.Remove(sPath);
+          return;
+        }
+
+        if (lastChange.m_Action == ezDirectoryWatcherAction::Modified)
+        {
+          lastChange.m_Action = ezDirectoryWatcherAction::None;
+        }
+        break;
+
+      case ezDirectoryWatcherAction::Added:
+        // new directories are scanned after their watch was added, so files created in between are seen twice
+        if (lastChange.m_Action == ezDirectoryWatcherAction::Added)
+          return;
+
+        if (lastChange.m_Action == ezDirectoryWatcherAction::Removed)
+        {
+          // the file was replaced
+          lastChange.m_Action = ezDirectoryWatcherAction::Modified;
+          return;
+        }
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  m_LastChangeForPath[sPath] = m_Changes.GetCount();
+
+  Change& change = m_Changes.ExpandAndGetRef();
+  change.m_sPath = sPath;
+  change.m_Action = action;
+}
+
+void ezDirectoryWatcherImpl::AddRename(const ezString& sOldPath, const ezString& sNewPath, bool bNewPathExisted)
+{
+  EZ_LOCK(m_Mutex);
+
+  const ezTime tNow = ezTime::Now();
+  if (m_Changes.IsEmpty())
+  {
+    m_FirstChangeTime = tNow;
+  }
+  m_LastChangeTime = tNow;
+
+  if (bNewPathExisted || m_LastChangeForPath.Contains(sNewPath))
+  {
+    // the usual save pattern: a temporary file is renamed over the original, which is then reported as modified
+    ezUInt32 uiIndex = 0;
+    if (m_LastChangeForPath.TryGetValue(sOldPath, uiIndex) && m_Changes[uiIndex].m_Action == ezDirectoryWatcherAction::Added)
+    {
+      // the temporary file was created in this batch, nobody needs to know about it
+      m_Changes[uiIndex].m_Action = ezDirectoryWatcherAction::None;
+      m_LastChangeForPath.Remove(sOldPath);
+    }
+    else
+    {
+      AddChange(sOldPath, ezDirectoryWatcherAction::Removed);
+    }
+
+    AddChange(sNewPath, ezDirectoryWatcherAction::Modified);
+    return;
+  }
+
+  ezUInt32 uiIndex = 0;
+  if (m_LastChangeForPath.TryGetValue(sOldPath, uiIndex))
+  {
+    Change& lastChange = m_Changes[uiIndex];
+
+    if (lastChange.m_Action == ezDirectoryWatcherAction::Added || lastChange.m_Action == ezDirectoryWatcherAction::RenamedNewName)
+    {
+      // a file that was created under a temporary name, or renamed multiple times, is only reported with its final name
+      lastChange.m_sPath = sNewPath;
+      m_LastChangeForPath.Remove(sOldPath);
+      m_LastChangeForPath[sNewPath] = uiIndex;
+      return;
+    }
+
+    m_LastChangeForPath.Remove(sOldPath);
+  }
+
+  Change& oldName = m_Changes.ExpandAndGetRef();
+  oldName.m_sPath = sOldPath;
+  oldName.m_Action = ezDirectoryWatcherAction::RenamedOldName;
+
+  m_LastChangeForPath[sNewPath] = m_Changes.GetCount();
+
+  Change& newName = m_Changes.ExpandAndGetRef();
+  newName.m_sPath = sNewPath;
+  newName.m_Action = ezDirectoryWatcherAction::RenamedNewName;
+}
@@ -1,6 +1,8 @@
 #include <FoundationPCH.h>
 
+#include <Foundation/Containers/Deque.h>
 #include <Foundation/IO/OSFile.h>
+#include <Foundation/Threading/TaskSystem.h>
 
 ezString64 ezOSFile::s_ApplicationPath;
 ezString64 ezOSFile::s_UserDataPath;
@@ -516,6 +518,118 @@ void ezOSFile::GatherAllItemsInFolder(ezDynamicArray<ezFileStats>& out_ItemList,
   }
 }
 
+namespace
+{
+  struct ezCrawledFolder
+  {
+    ezString m_sPath;
+    ezDynamicArray<ezFileStats> m_Items;
+
+    /// For every folder in m_Items (in the same order) the index of the crawled folder that holds its content, or ezInvalidIndex.
+    ezDynamicArray<ezUInt32> m_SubFolders;
+  };
+
+  void AppendCrawledItems(ezDeque<ezCrawledFolder>& folders, ezUInt32 uiFolder, ezBitflags<ezFileSystemIteratorFlags> flags, ezDynamicArray<ezFileStats>& out_ItemList)
+  {
+    ezCrawledFolder& folder = folders[uiFolder];
+    ezUInt32 uiNextSubFolder = 0;
+
+    for (ezFileStats& item : folder.m_Items)
+    {
+      const ezUInt32 uiSubFolder = item.m_bIsDirectory ? folder.m_SubFolders[uiNextSubFolder++] : ezInvalidIndex;
+
+      if (item.m_bIsDirectory ? flags.IsSet(ezFileSystemIteratorFlags::ReportFolders) : flags.IsSet(ezFileSystemIteratorFlags::ReportFiles))
+      {
+        out_ItemList.PushBack(std::move(item));
+      }
+
+      if (uiSubFolder != ezInvalidIndex)
+      {
+        AppendCrawledItems(folders, uiSubFolder, flags, out_ItemList);
+      }
+    }
+
+    folder.m_Items.Clear();
+    folder.m_Items.Compact();
+  }
+} // namespace
+
+void ezOSFile::GatherAllItemsInFolderParallel(ezDynamicArray<ezFileStats>& out_ItemList, const char* szFolder, ezBitflags<ezFileSystemIteratorFlags> flags /*= ezFileSystemIteratorFlags::Default*/, ezDelegate<bool(const ezFileStats&)> recurseIntoFolder /*= {}*/)
+{
+  if (!flags.IsSet(ezFileSystemIteratorFlags::Recursive))
+  {
+    GatherAllItemsInFolder(out_ItemList, szFolder, flags);
+    return;
+  }
+
+  out_ItemList.Clear();
+
+  // The folders are searched level by level: all folders of one level are read in parallel, without recursion,
+  // and the folders found in them make up the next level. Afterwards the items are put into the order of a serial search.
+  ezDeque<ezCrawledFolder> folders;
+  folders.ExpandAndGetRef().m_sPath = szFolder;
+
+  ezUInt32 uiLevelStart = 0;
+  ezUInt32 uiItemCount = 0;
+  ezStringBuilder sPath;
+
+  while (uiLevelStart < folders.GetCount())
+  {
+    const ezUInt32 uiLevelEnd = folders.GetCount();
+
+    ezParallelForParams params;
+    params.uiBinSize = 1;
+    // the number of items differs a lot between folders, more tasks balance that out better
+    params.uiMaxTasksPerThread = 4;
+
+    ezTaskSystem::ParallelForIndexed(0, uiLevelEnd - uiLevelStart, [&](ezUInt32 uiStart, ezUInt32 uiEnd) {
+      for (ezUInt32 i = uiLevelStart + uiStart; i < uiLevelStart + uiEnd; ++i)
+      {
+        ezCrawledFolder& folder = folders[i];
+
+        ezFileSystemIterator iterator;
+        if (iterator.StartSearch(folder.m_sPath, ezFileSystemIteratorFlags::ReportFiles | ezFileSystemIteratorFlags::ReportFolders).Failed())
+          continue;
+
+        do
+        {
+          folder.m_Items.PushBack(iterator.GetStats());
+        } while (iterator.Next().Succeeded());
+      }
+    },
+      "GatherAllItemsInFolder", params);
+
+    for (ezUInt32 i = uiLevelStart; i < uiLevelEnd; ++i)
+    {
+      uiItemCount += folders[i].m_Items.GetCount();
+
+      for (const ezFileStats& item : folders[i].m_Items)
+      {
+        if (!item.m_bIsDirectory)
+          continue;
+
+        ezUInt32 uiSubFolder = ezInvalidIndex;
+
+        if (!recurseIntoFolder.IsValid() || recurseIntoFolder(item))
+        {
+          item.GetFullPath(sPath);
+
+          uiSubFolder = folders.GetCount();
+          folders.ExpandAndGetRef().m_sPath = sPath;
+        }
+
+        // the deque does not move its elements, so the item reference stays valid
+        folders[i].m_SubFolders.PushBack(uiSubFolder);
+      }
+    }
+
+    uiLevelStart = uiLevelEnd;
+  }
+
+  out_ItemList.Reserve(uiItemCount);
+  AppendCrawledItems(folders, 0, flags, out_ItemList);
+}
+
 ezResult ezOSFile::CopyFolder(const char* szSourceFolder, const char* szDestinationFolder)
 {
   ezDynamicArray<ezFileStats> items;
@@ -2,6 +2,11 @@
 
 #include <Foundation/Basics.h>
 
+#if EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS)
+#  include <Foundation/Containers/HybridArray.h>
+#  include <Foundation/Strings/String.h>
+#endif
+
 // Deactivate Doxygen document generation for the following block.
 /// \cond
 
@@ -15,6 +20,31 @@ struct ezOSFileData
   FILE* m_pFileHandle;
 };
 
+#if EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS)
+
+struct ezFileIterationData
+{
+  struct Directory
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    int m_iFileDescriptor = -1;
+    ezUInt32 m_uiReadPos = 0;
+    ezUInt32 m_uiBytesInBuffer = 0;
+  };
+
+  /// One entry per folder that is currently being iterated, the last one is the innermost folder.
+  ezHybridArray<Directory, 16> m_Directories;
+
+  /// Holds the raw directory entries of all folders in m_Directories, one fixed size block per folder.
+  ezDynamicArray<ezUInt8> m_Buffer;
+
+  /// Only set when the search contains wildcards, used to filter the entries of the start folder.
+  ezString m_sWildcardSearch;
+};
+
+#endif
+
 
 /// \endcond
 
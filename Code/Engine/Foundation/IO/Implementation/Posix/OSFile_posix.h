@@ -30,6 +30,12 @@ EZ_FOUNDATION_INTERNAL_HEADER
 #  include <Foundation/Basics/Platform/Android/AndroidJni.h>
 #endif
 
+#if EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS)
+#  include <fcntl.h>
+#  include <fnmatch.h>
+#  include <sys/syscall.h>
+#endif
+
 #ifndef PATH_MAX
 #  define PATH_MAX 1024
 #endif
@@ -269,6 +275,228 @@ ezResult ezOSFile::InternalGetFileStats(const char* szFileOrFolder, ezFileStats&
 }
 #endif
 
+#if EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS)
+
+// Of the platforms that use the posix file API, only Linux supports file iterators. Folders are read in large blocks with getdents64
+// and sub-folders and the stats of entries are accessed relative to the already open parent folder, so the kernel does not have to
+// resolve the full path of every single entry again.
+
+namespace
+{
+  /// \brief The layout of the entries that getdents64 writes into the buffer.
+  struct ezLinuxDirEntry64
+  {
+    ezUInt64 d_ino;
+    ezInt64 d_off;
+    ezUInt16 d_reclen;
+    ezUInt8 d_type;
+    char d_name[1];
+  };
+
+  constexpr ezUInt32 s_uiFileIterationBufferSize = 32 * 1024;
+
+  void PushIterationDirectory(ezFileIterationData& data, int iFileDescriptor)
+  {
+    ezFileIterationData::Directory& dir = data.m_Directories.ExpandAndGetRef();
+    dir.m_iFileDescriptor = iFileDescriptor;
+    dir.m_uiReadPos = 0;
+    dir.m_uiBytesInBuffer = 0;
+
+    const ezUInt32 uiRequiredBufferSize = data.m_Directories.GetCount() * s_uiFileIterationBufferSize;
+    if (data.m_Buffer.GetCount() < uiRequiredBufferSize)
+    {
+      data.m_Buffer.SetCountUninitialized(uiRequiredBufferSize);
+    }
+  }
+} // namespace
+
+ezFileSystemIterator::ezFileSystemIterator()
+{
+}
+
+ezFileSystemIterator::~ezFileSystemIterator()
+{
+  while (!m_Data.m_Directories.IsEmpty())
+  {
+    close(m_Data.m_Directories.PeekBack().m_iFileDescriptor);
+    m_Data.m_Directories.PopBack();
+  }
+}
+
+bool ezFileSystemIterator::IsValid() const
+{
+  return !m_Data.m_Directories.IsEmpty();
+}
+
+ezResult ezFileSystemIterator::StartSearch(const char* szSearchStart, ezBitflags<ezFileSystemIteratorFlags> flags /*= ezFileSystemIteratorFlags::All*/)
+{
+  EZ_ASSERT_DEV(m_Data.m_Directories.IsEmpty(), "Cannot start another search.");
+
+  ezStringBuilder sSearch = szSearchStart;
+  sSearch.MakeCleanPath();
+
+  // same as just passing in the folder path, so remove this
+  if (sSearch.EndsWith("/*"))
+    sSearch.Shrink(0, 2);
+
+  // keep the slash of the root folder
+  while (sSearch.GetElementCount() > 1 && sSearch.EndsWith("/"))
+    sSearch.Shrink(0, 1);
+
+  // Since the use of wildcard-ed file names will disable recursion, we ensure both are not used simultaneously.
+  const bool bHasWildcard = sSearch.FindLastSubString("*") || sSearch.FindLastSubString("?");
+  EZ_ASSERT_DEV(flags.IsSet(ezFileSystemIteratorFlags::Recursive) == false || bHasWildcard == false, "Recursive file iteration does not support wildcards. Either don't use recursion, or filter the filenames manually.");
+
+  EZ_ASSERT_DEV(sSearch.IsAbsolutePath(), "The path '{0}' is not absolute.", sSearch);
+
+  m_Flags = flags;
+  m_Data.m_sWildcardSearch.Clear();
+
+  int iFileDescriptor = open(sSearch, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+  if (iFileDescriptor >= 0)
+  {
+    // the items INSIDE the folder are reported, not the folder itself
+    m_sCurPath = sSearch;
+  }
+  else
+  {
+    // the last path segment is a file name or a pattern, iterate the parent folder and only report what matches
+    m_sCurPath = sSearch.GetFileDirectory();
+    while (m_sCurPath.GetElementCount() > 1 && m_sCurPath.EndsWith("/"))
+      m_sCurPath.Shrink(0, 1);
+
+    m_Data.m_sWildcardSearch = sSearch.GetFileNameAndExtension();
+
+    iFileDescriptor = open(m_sCurPath, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+    if (iFileDescriptor < 0)
+      return EZ_FAILURE;
+  }
+
+  PushIterationDirectory(m_Data, iFileDescriptor);
+
+  // nothing has been reported yet, so there is nothing to recurse into
+  m_CurFile.m_bIsDirectory = false;
+
+  return Next();
+}
+
+ezResult ezFileSystemIterator::Next()
+{
+  while (true)
+  {
+    const ezInt32 res = InternalNext();
+
+    if (res == EZ_SUCCESS)
+      return EZ_SUCCESS;
+
+    if (res == EZ_FAILURE)
+      return EZ_FAILURE;
+  }
+}
+
+ezInt32 ezFileSystemIterator::InternalNext()
+{
+  constexpr ezInt32 CallInternalNext = 2;
+
+  if (m_Data.m_Directories.IsEmpty())
+    return EZ_FAILURE;
+
+  if (m_Flags.IsSet(ezFileSystemIteratorFlags::Recursive) && m_CurFile.m_bIsDirectory)
+  {
+    const int iFileDescriptor = openat(m_Data.m_Directories.PeekBack().m_iFileDescriptor, m_CurFile.m_sName, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+    // if the recursion did not work, just iterate in this folder further
+    if (iFileDescriptor >= 0)
+    {
+      m_sCurPath.AppendPath(m_CurFile.m_sName);
+      PushIterationDirectory(m_Data, iFileDescriptor);
+    }
+  }
+
+  // entries that are skipped below must not be recursed into by the next call
+  m_CurFile.m_bIsDirectory = false;
+
+  ezFileIterationData::Directory& dir = m_Data.m_Directories.PeekBack();
+  ezUInt8* pBuffer = m_Data.m_Buffer.GetData() + (m_Data.m_Directories.GetCount() - 1) * s_uiFileIterationBufferSize;
+
+  if (dir.m_uiReadPos >= dir.m_uiBytesInBuffer)
+  {
+    const long iBytesRead = syscall(SYS_getdents64, dir.m_iFileDescriptor, pBuffer, s_uiFileIterationBufferSize);
+
+    if (iBytesRead <= 0)
+    {
+      // nothing found in this directory anymore
+      close(dir.m_iFileDescriptor);
+      m_Data.m_Directories.PopBack();
+
+      if (m_Data.m_Directories.IsEmpty())
+        return EZ_FAILURE;
+
+      m_sCurPath.PathParentDirectory();
+
+      return CallInternalNext;
+    }
+
+    dir.m_uiReadPos = 0;
+    dir.m_uiBytesInBuffer = static_cast<ezUInt32>(iBytesRead);
+  }
+
+  const ezLinuxDirEntry64* pEntry = reinterpret_cast<const ezLinuxDirEntry64*>(pBuffer + dir.m_uiReadPos);
+  dir.m_uiReadPos += pEntry->d_reclen;
+
+  const char* szName = pEntry->d_name;
+
+  if ((ezStringUtils::IsEqual(szName, "..")) || (ezStringUtils::IsEqual(szName, ".")))
+    return CallInternalNext;
+
+  if (m_Data.m_Directories.GetCount() == 1 && !m_Data.m_sWildcardSearch.IsEmpty())
+  {
+    if (m_Data.m_sWildcardSearch != szName && fnmatch(m_Data.m_sWildcardSearch, szName, FNM_NOESCAPE) != 0)
+      return CallInternalNext;
+  }
+
+  struct stat info;
+  if (fstatat(dir.m_iFileDescriptor, szName, &info, 0) != 0)
+    return CallInternalNext; // deleted in the meantime or a dangling symlink
+
+  m_CurFile.m_uiFileSize = info.st_size;
+  m_CurFile.m_bIsDirectory = S_ISDIR(info.st_mode);
+  m_CurFile.m_sParentPath = m_sCurPath;
+  m_CurFile.m_sName = szName;
+  m_CurFile.m_LastModificationTime.SetInt64(info.st_mtime, ezSIUnitOfTime::Second);
+
+  if (m_CurFile.m_bIsDirectory)
+  {
+    if (!m_Flags.IsSet(ezFileSystemIteratorFlags::ReportFolders))
+      return CallInternalNext;
+  }
+  else
+  {
+    if (!m_Flags.IsSet(ezFileSystemIteratorFlags::ReportFiles))
+      return CallInternalNext;
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezFileSystemIterator::SkipFolder()
+{
+  EZ_ASSERT_DEBUG(m_Flags.IsSet(ezFileSystemIteratorFlags::Recursive), "SkipFolder has no meaning when the iterator is not set to be recursive.");
+  EZ_ASSERT_DEBUG(m_CurFile.m_bIsDirectory, "SkipFolder can only be called when the current object is a folder.");
+
+  m_Flags.Remove(ezFileSystemIteratorFlags::Recursive);
+
+  const ezResult bRet = Next();
+
+  m_Flags.Add(ezFileSystemIteratorFlags::Recursive);
+
+  return bRet;
+}
+
+#endif
+
 #if EZ_DISABLED(EZ_PLATFORM_WINDOWS_UWP)
 
 const char* ezOSFile::GetApplicationDirectory()
@@ -8,6 +8,7 @@
 #include <Foundation/Threading/AtomicInteger.h>
 #include <Foundation/Threading/Mutex.h>
 #include <Foundation/Time/Timestamp.h>
+#include <Foundation/Types/Delegate.h>
 
 struct ezOSFileData;
 
@@ -241,6 +242,15 @@ public:
   /// \brief Returns the ezFileStats for all files and folders in the given folder
   static void GatherAllItemsInFolder(ezDynamicArray<ezFileStats>& out_ItemList, const char* szFolder, ezBitflags<ezFileSystemIteratorFlags> flags = ezFileSystemIteratorFlags::Default);
 
+  /// \brief Returns the same items as GatherAllItemsInFolder(), but reads the sub-folders in parallel on the task system.
+  ///
+  /// Meant for large folder hierarchies, where a serial search spends most of its time waiting for the file system.
+  /// The items are returned in the same order as GatherAllItemsInFolder() returns them.
+  /// If \a recurseIntoFolder is valid, it is called on the calling thread for every folder that is found and the folder
+  /// is only searched, if it returns true. The folder itself is still reported.
+  static void GatherAllItemsInFolderParallel(ezDynamicArray<ezFileStats>& out_ItemList, const char* szFolder,
+    ezBitflags<ezFileSystemIteratorFlags> flags = ezFileSystemIteratorFlags::Default, ezDelegate<bool(const ezFileStats&)> recurseIntoFolder = {});
+
   /// \brief Copies \a szSourceFolder to \a szDestinationFolder. Overwrites existing files.
   static ezResult CopyFolder(const char* szSourceFolder, const char* szDestinationFolder);
 
@@ -27,6 +27,22 @@ namespace
   };
 
 
+  typedef ezHashTable<const void*, ezMemoryTracker::AllocationInfo, ezHashHelper<const void*>, TrackerDataAllocatorWrapper> AllocationTable;
+
+  /// The allocations of each allocator are distributed over several shards by pointer hash, so that threads that allocate
+  /// from the same allocator at the same time rarely need the same lock.
+  struct AllocationShard
+  {
+    EZ_ALWAYS_INLINE void Lock() { m_Mutex.Lock(); }
+    EZ_ALWAYS_INLINE void Unlock() { m_Mutex.Unlock(); }
+
+    ezMutex m_Mutex;
+    ezAllocatorBase::Stats m_Stats;
+    AllocationTable m_Allocations;
+  };
+
+  static constexpr ezUInt32 s_uiNumAllocationShards = 16;
+
   struct AllocatorData
   {
     EZ_ALWAYS_INLINE AllocatorData() {}
@@ -34,13 +50,28 @@ namespace
     ezHybridString<32, TrackerDataAllocatorWrapper> m_sName;
     ezBitflags<ezMemoryTrackingFlags> m_Flags;
 
+    ezAllocatorId m_Id;
     ezAllocatorId m_ParentId;
 
+    /// For allocators that track their allocations this is the sum of the shard stats, updated in UpdateStats().
     ezAllocatorBase::Stats m_Stats;
 
-    ezHashTable<const void*, ezMemoryTracker::AllocationInfo, ezHashHelper<const void*>, TrackerDataAllocatorWrapper> m_Allocations;
+    AllocationShard m_Shards[s_uiNumAllocationShards];
+
+    EZ_ALWAYS_INLINE AllocationShard& GetShard(const void* ptr)
+    {
+      // Fibonacci hashing, the top bits are well distributed even for pointers that only differ in a few low bits.
+      // This is independent of the hash that selects the bucket inside the shard's hash table.
+      const ezUInt64 uiHash = (static_cast<ezUInt64>(reinterpret_cast<size_t>(ptr)) >> 4) * 0x9E3779B97F4A7C15ull;
+      return m_Shards[uiHash >> 60];
+    }
   };
 
+  EZ_CHECK_AT_COMPILETIME(s_uiNumAllocationShards == 1 << (64 - 60));
+
+  static constexpr ezUInt32 s_uiAllocatorLookupChunkSize = 256;
+  static constexpr ezUInt32 s_uiMaxAllocatorLookupChunks = 256;
+
   struct TrackerData
   {
     EZ_ALWAYS_INLINE void Lock() { m_Mutex.Lock(); }
@@ -48,9 +79,14 @@ namespace
 
     ezMutex m_Mutex;
 
-    typedef ezIdTable<ezAllocatorId, AllocatorData, TrackerDataAllocatorWrapper> AllocatorTable;
+    typedef ezIdTable<ezAllocatorId, AllocatorData*, TrackerDataAllocatorWrapper> AllocatorTable;
     AllocatorTable m_AllocatorData;
 
+    /// Maps the instance index of an allocator id to its data, so that allocations can be tracked without taking m_Mutex.
+    /// Chunks are only added under the lock and never freed. An allocator is always registered before anybody allocates from it,
+    /// so the allocating thread is guaranteed to see its entry.
+    AllocatorData** m_AllocatorLookup[s_uiMaxAllocatorLookupChunks] = {};
+
     ezAllocatorId m_StaticAllocatorId;
   };
 
@@ -84,6 +120,67 @@ namespace
     s_bIsInitializing = false;
   }
 
+  static AllocatorData& GetAllocatorData(ezAllocatorId allocatorId)
+  {
+    const ezUInt32 uiChunk = allocatorId.m_InstanceIndex / s_uiAllocatorLookupChunkSize;
+    if (uiChunk < s_uiMaxAllocatorLookupChunks)
+    {
+      AllocatorData** pChunk = s_pTrackerData->m_AllocatorLookup[uiChunk];
+      if (pChunk != nullptr)
+      {
+        AllocatorData* pData = pChunk[allocatorId.m_InstanceIndex % s_uiAllocatorLookupChunkSize];
+        if (pData != nullptr && pData->m_Id == allocatorId)
+          return *pData;
+      }
+    }
+
+    // more allocators than the lookup table can hold, or an invalid id which will trigger the id table's assert
+    EZ_LOCK(*s_pTrackerData);
+    return *s_pTrackerData->m_AllocatorData[allocatorId];
+  }
+
+  static void SetAllocatorLookup(ezAllocatorId allocatorId, AllocatorData* pData)
+  {
+    const ezUInt32 uiChunk = allocatorId.m_InstanceIndex / s_uiAllocatorLookupChunkSize;
+    if (uiChunk >= s_uiMaxAllocatorLookupChunks)
+      return;
+
+    AllocatorData**& pChunk = s_pTrackerData->m_AllocatorLookup[uiChunk];
+    if (pChunk == nullptr)
+    {
+      if (pData == nullptr)
+        return;
+
+      pChunk = EZ_NEW_RAW_BUFFER(s_pTrackerDataAllocator, AllocatorData*, s_uiAllocatorLookupChunkSize);
+      ezMemoryUtils::ZeroFill(pChunk, s_uiAllocatorLookupChunkSize);
+    }
+
+    pChunk[allocatorId.m_InstanceIndex % s_uiAllocatorLookupChunkSize] = pData;
+  }
+
+  /// Sums up the stats of all shards for allocators that track their allocations.
+  static const ezAllocatorBase::Stats& UpdateStats(AllocatorData& data)
+  {
+    if (data.m_Flags.IsSet(ezMemoryTrackingFlags::EnableAllocationTracking))
+    {
+      ezAllocatorBase::Stats stats;
+
+      for (AllocationShard& shard : data.m_Shards)
+      {
+        EZ_LOCK(shard);
+        stats.m_uiNumAllocations += shard.m_Stats.m_uiNumAllocations;
+        stats.m_uiNumDeallocations += shard.m_Stats.m_uiNumDeallocations;
+        stats.m_uiAllocationSize += shard.m_Stats.m_uiAllocationSize;
+        stats.m_uiPerFrameAllocationSize += shard.m_Stats.m_uiPerFrameAllocationSize;
+        stats.m_PerFrameAllocationTime += shard.m_Stats.m_PerFrameAllocationTime;
+      }
+
+      data.m_Stats = stats;
+    }
+
+    return data.m_Stats;
+  }
+
   static void DumpLeak(const ezMemoryTracker::AllocationInfo& info, const char* szAllocatorName)
   {
     char szBuffer[512];
@@ -111,17 +208,17 @@ ezAllocatorId ezMemoryTracker::Iterator::Id() const
 
 const char* ezMemoryTracker::Iterator::Name() const
 {
-  return CAST_ITER(m_pData)->Value().m_sName.GetData();
+  return CAST_ITER(m_pData)->Value()->m_sName.GetData();
 }
 
 ezAllocatorId ezMemoryTracker::Iterator::ParentId() const
 {
-  return CAST_ITER(m_pData)->Value().m_ParentId;
+  return CAST_ITER(m_pData)->Value()->m_ParentId;
 }
 
 const ezAllocatorBase::Stats& ezMemoryTracker::Iterator::Stats() const
 {
-  return CAST_ITER(m_pData)->Value().m_Stats;
+  return UpdateStats(*CAST_ITER(m_pData)->Value());
 }
 
 void ezMemoryTracker::Iterator::Next()
@@ -149,14 +246,17 @@ ezAllocatorId ezMemoryTracker::RegisterAllocator(const char* szName, ezBitflags<
 
   EZ_LOCK(*s_pTrackerData);
 
-  AllocatorData data;
-  data.m_sName = szName;
-  data.m_Flags = flags;
-  data.m_ParentId = parentId;
+  AllocatorData* pData = EZ_NEW(s_pTrackerDataAllocator, AllocatorData);
+  pData->m_sName = szName;
+  pData->m_Flags = flags;
+  pData->m_ParentId = parentId;
 
-  ezAllocatorId id = s_pTrackerData->m_AllocatorData.Insert(data);
+  ezAllocatorId id = s_pTrackerData->m_AllocatorData.Insert(pData);
+  pData->m_Id = id;
 
-  if (data.m_sName == EZ_STATIC_ALLOCATOR_NAME)
+  SetAllocatorLookup(id, pData);
+
+  if (pData->m_sName == EZ_STATIC_ALLOCATOR_NAME)
   {
     s_pTrackerData->m_StaticAllocatorId = id;
   }
@@ -169,20 +269,28 @@ void ezMemoryTracker::DeregisterAllocator(ezAllocatorId allocatorId)
 {
   EZ_LOCK(*s_pTrackerData);
 
-  const AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
+  AllocatorData* pData = s_pTrackerData->m_AllocatorData[allocatorId];
 
-  ezUInt32 uiLiveAllocations = data.m_Allocations.GetCount();
-  if (uiLiveAllocations != 0)
+  ezUInt32 uiLiveAllocations = 0;
+  for (const AllocationShard& shard : pData->m_Shards)
   {
-    for (auto it = data.m_Allocations.GetIterator(); it.IsValid(); ++it)
+    uiLiveAllocations += shard.m_Allocations.GetCount();
+
+    for (auto it = shard.m_Allocations.GetIterator(); it.IsValid(); ++it)
     {
-      DumpLeak(it.Value(), data.m_sName.GetData());
+      DumpLeak(it.Value(), pData->m_sName.GetData());
     }
+  }
 
-    EZ_REPORT_FAILURE("Allocator '{0}' leaked {1} allocation(s)", data.m_sName.GetData(), uiLiveAllocations);
+  if (uiLiveAllocations != 0)
+  {
+    EZ_REPORT_FAILURE("Allocator '{0}' leaked {1} allocation(s)", pData->m_sName.GetData(), uiLiveAllocations);
   }
 
+  SetAllocatorLookup(allocatorId, nullptr);
   s_pTrackerData->m_AllocatorData.Remove(allocatorId);
+
+  EZ_DELETE(s_pTrackerDataAllocator, pData);
 }
 
 // static
@@ -203,16 +311,18 @@ void ezMemoryTracker::AddAllocation(ezAllocatorId allocatorId, ezBitflags<ezMemo
   }
 
   {
-    EZ_LOCK(*s_pTrackerData);
+    AllocatorData& data = GetAllocatorData(allocatorId);
+    EZ_ASSERT_DEBUG(data.m_Flags == flags, "Given flags have to be identical to allocator flags");
 
-    AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
-    data.m_Stats.m_uiNumAllocations++;
-    data.m_Stats.m_uiAllocationSize += uiSize;
-    data.m_Stats.m_uiPerFrameAllocationSize += uiSize;
-    data.m_Stats.m_PerFrameAllocationTime += allocationTime;
+    AllocationShard& shard = data.GetShard(ptr);
+    EZ_LOCK(shard);
 
-    EZ_ASSERT_DEBUG(data.m_Flags == flags, "Given flags have to be identical to allocator flags");
-    auto pInfo = &data.m_Allocations[ptr];
+    shard.m_Stats.m_uiNumAllocations++;
+    shard.m_Stats.m_uiAllocationSize += uiSize;
+    shard.m_Stats.m_uiPerFrameAllocationSize += uiSize;
+    shard.m_Stats.m_PerFrameAllocationTime += allocationTime;
+
+    auto pInfo = &shard.m_Allocations[ptr];
     pInfo->m_uiSize = uiSize;
     pInfo->m_uiAlignment = (ezUInt16)uiAlign;
     pInfo->SetStackTrace(stackTrace);
@@ -225,15 +335,14 @@ void ezMemoryTracker::RemoveAllocation(ezAllocatorId allocatorId, const void* pt
   ezArrayPtr<void*> stackTrace;
 
   {
-    EZ_LOCK(*s_pTrackerData);
-
-    AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
+    AllocationShard& shard = GetAllocatorData(allocatorId).GetShard(ptr);
+    EZ_LOCK(shard);
 
     AllocationInfo info;
-    if (data.m_Allocations.Remove(ptr, &info))
+    if (shard.m_Allocations.Remove(ptr, &info))
     {
-      data.m_Stats.m_uiNumDeallocations++;
-      data.m_Stats.m_uiAllocationSize -= info.m_uiSize;
+      shard.m_Stats.m_uiNumDeallocations++;
+      shard.m_Stats.m_uiAllocationSize -= info.m_uiSize;
 
       stackTrace = info.GetStackTrace();
     }
@@ -249,17 +358,20 @@ void ezMemoryTracker::RemoveAllocation(ezAllocatorId allocatorId, const void* pt
 // static
 void ezMemoryTracker::RemoveAllAllocations(ezAllocatorId allocatorId)
 {
-  EZ_LOCK(*s_pTrackerData);
-  AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
-  for (auto it = data.m_Allocations.GetIterator(); it.IsValid(); ++it)
+  AllocatorData& data = GetAllocatorData(allocatorId);
+  for (AllocationShard& shard : data.m_Shards)
   {
-    auto& info = it.Value();
-    data.m_Stats.m_uiNumDeallocations++;
-    data.m_Stats.m_uiAllocationSize -= info.m_uiSize;
+    EZ_LOCK(shard);
+    for (auto it = shard.m_Allocations.GetIterator(); it.IsValid(); ++it)
+    {
+      auto& info = it.Value();
+      shard.m_Stats.m_uiNumDeallocations++;
+      shard.m_Stats.m_uiAllocationSize -= info.m_uiSize;
 
-    EZ_DELETE_ARRAY(s_pTrackerDataAllocator, info.GetStackTrace());
+      EZ_DELETE_ARRAY(s_pTrackerDataAllocator, info.GetStackTrace());
+    }
+    shard.m_Allocations.Clear();
   }
-  data.m_Allocations.Clear();
 }
 
 // static
@@ -267,7 +379,7 @@ void ezMemoryTracker::SetAllocatorStats(ezAllocatorId allocatorId, const ezAlloc
 {
   EZ_LOCK(*s_pTrackerData);
 
-  s_pTrackerData->m_AllocatorData[allocatorId].m_Stats = stats;
+  s_pTrackerData->m_AllocatorData[allocatorId]->m_Stats = stats;
 }
 
 // static
@@ -277,9 +389,16 @@ void ezMemoryTracker::ResetPerFrameAllocatorStats()
 
   for (auto it = s_pTrackerData->m_AllocatorData.GetIterator(); it.IsValid(); ++it)
   {
-    AllocatorData& data = it.Value();
+    AllocatorData& data = *it.Value();
     data.m_Stats.m_uiPerFrameAllocationSize = 0;
     data.m_Stats.m_PerFrameAllocationTime.SetZero();
+
+    for (AllocationShard& shard : data.m_Shards)
+    {
+      EZ_LOCK(shard);
+      shard.m_Stats.m_uiPerFrameAllocationSize = 0;
+      shard.m_Stats.m_PerFrameAllocationTime.SetZero();
+    }
   }
 }
 
@@ -288,7 +407,7 @@ const char* ezMemoryTracker::GetAllocatorName(ezAllocatorId allocatorId)
 {
   EZ_LOCK(*s_pTrackerData);
 
-  return s_pTrackerData->m_AllocatorData[allocatorId].m_sName.GetData();
+  return s_pTrackerData->m_AllocatorData[allocatorId]->m_sName.GetData();
 }
 
 // static
@@ -296,7 +415,7 @@ const ezAllocatorBase::Stats& ezMemoryTracker::GetAllocatorStats(ezAllocatorId a
 {
   EZ_LOCK(*s_pTrackerData);
 
-  return s_pTrackerData->m_AllocatorData[allocatorId].m_Stats;
+  return UpdateStats(*s_pTrackerData->m_AllocatorData[allocatorId]);
 }
 
 // static
@@ -304,17 +423,17 @@ ezAllocatorId ezMemoryTracker::GetAllocatorParentId(ezAllocatorId allocatorId)
 {
   EZ_LOCK(*s_pTrackerData);
 
-  return s_pTrackerData->m_AllocatorData[allocatorId].m_ParentId;
+  return s_pTrackerData->m_AllocatorData[allocatorId]->m_ParentId;
 }
 
 // static
 const ezMemoryTracker::AllocationInfo& ezMemoryTracker::GetAllocationInfo(ezAllocatorId allocatorId, const void* ptr)
 {
-  EZ_LOCK(*s_pTrackerData);
+  AllocationShard& shard = GetAllocatorData(allocatorId).GetShard(ptr);
+  EZ_LOCK(shard);
 
-  const AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
   const AllocationInfo* info = nullptr;
-  if (data.m_Allocations.TryGetValue(ptr, info))
+  if (shard.m_Allocations.TryGetValue(ptr, info))
   {
     return *info;
   }
@@ -350,15 +469,18 @@ void ezMemoryTracker::DumpMemoryLeaks()
   // first collect all leaks
   for (auto it = s_pTrackerData->m_AllocatorData.GetIterator(); it.IsValid(); ++it)
   {
-    const AllocatorData& data = it.Value();
-    for (auto it2 = data.m_Allocations.GetIterator(); it2.IsValid(); ++it2)
+    for (AllocationShard& shard : it.Value()->m_Shards)
     {
-      LeakInfo leak;
-      leak.m_AllocatorId = it.Id();
-      leak.m_uiSize = it2.Value().m_uiSize;
-      leak.m_pParentLeak = nullptr;
+      EZ_LOCK(shard);
+      for (auto it2 = shard.m_Allocations.GetIterator(); it2.IsValid(); ++it2)
+      {
+        LeakInfo leak;
+        leak.m_AllocatorId = it.Id();
+        leak.m_uiSize = it2.Value().m_uiSize;
+        leak.m_pParentLeak = nullptr;
 
-      leakTable.Insert(it2.Key(), leak);
+        leakTable.Insert(it2.Key(), leak);
+      }
     }
   }
 
@@ -402,9 +524,9 @@ void ezMemoryTracker::DumpMemoryLeaks()
                      "\n--------------------------------------------------------------------\n\n");
       }
 
-      const AllocatorData& data = s_pTrackerData->m_AllocatorData[leak.m_AllocatorId];
+      AllocatorData& data = *s_pTrackerData->m_AllocatorData[leak.m_AllocatorId];
       ezMemoryTracker::AllocationInfo info;
-      data.m_Allocations.TryGetValue(ptr, info);
+      data.GetShard(ptr).m_Allocations.TryGetValue(ptr, info);
 
       DumpLeak(info, data.m_sName.GetData());
 
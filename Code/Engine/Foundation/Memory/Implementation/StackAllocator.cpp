@@ -0,0 +1,62 @@
+#include <FoundationPCH.h>
+
+#include <Foundation/Memory/StackAllocator.h>
+
+namespace
+{
+  // Plain static data only, this is still used while threads shut down.
+  static ezMutex s_ThreadIndexMutex;
+  static ezUInt32 s_FreeThreadIndices[ezInternal::StackAllocatorMaxThreads];
+  static ezUInt32 s_uiNumFreeThreadIndices = 0;
+  static ezUInt32 s_uiNextThreadIndex = 0;
+
+  struct StackAllocatorThreadIndex
+  {
+    ~StackAllocatorThreadIndex()
+    {
+      if (m_uiIndex != ezInvalidIndex)
+      {
+        EZ_LOCK(s_ThreadIndexMutex);
+        s_FreeThreadIndices[s_uiNumFreeThreadIndices++] = m_uiIndex;
+      }
+    }
+
+    ezUInt32 Acquire()
+    {
+      EZ_LOCK(s_ThreadIndexMutex);
+
+      if (s_uiNumFreeThreadIndices > 0)
+      {
+        m_uiIndex = s_FreeThreadIndices[--s_uiNumFreeThreadIndices];
+      }
+      else if (s_uiNextThreadIndex < ezInternal::StackAllocatorMaxThreads)
+      {
+        m_uiIndex = s_uiNextThreadIndex++;
+      }
+      else
+      {
+        // all indices are in use, this thread falls back to the shared arena
+        m_bExhausted = true;
+      }
+
+      return m_uiIndex;
+    }
+
+    ezUInt32 m_uiIndex = ezInvalidIndex;
+    bool m_bExhausted = false;
+  };
+
+  static thread_local StackAllocatorThreadIndex s_ThreadIndex;
+} // namespace
+
+ezUInt32 ezInternal::GetStackAllocatorThreadIndex()
+{
+  StackAllocatorThreadIndex& threadIndex = s_ThreadIndex;
+
+  if (threadIndex.m_uiIndex != ezInvalidIndex || threadIndex.m_bExhausted)
+    return threadIndex.m_uiIndex;
+
+  return threadIndex.Acquire();
+}
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Memory_Implementation_StackAllocator);
@@ -10,19 +10,75 @@ template <ezUInt32 TrackingFlags>
 ezStackAllocator<TrackingFlags>::~ezStackAllocator()
 {
   Reset();
+
+  for (ezMemoryPolicies::ezStackAllocation* pArena : m_ThreadArenas)
+  {
+    if (pArena != nullptr)
+    {
+      EZ_DELETE(this->GetParent(), pArena);
+    }
+  }
+}
+
+template <ezUInt32 TrackingFlags>
+ezMemoryPolicies::ezStackAllocation* ezStackAllocator<TrackingFlags>::GetThreadArena()
+{
+  const ezUInt32 uiThreadIndex = ezInternal::GetStackAllocatorThreadIndex();
+  if (uiThreadIndex == ezInvalidIndex)
+    return nullptr;
+
+  // only the thread that owns the index ever writes this slot
+  ezMemoryPolicies::ezStackAllocation*& pArena = m_ThreadArenas[uiThreadIndex];
+  if (pArena == nullptr)
+  {
+    pArena = EZ_NEW(this->GetParent(), ezMemoryPolicies::ezStackAllocation, this->GetParent());
+  }
+
+  return pArena;
 }
 
 template <ezUInt32 TrackingFlags>
 void* ezStackAllocator<TrackingFlags>::Allocate(size_t uiSize, size_t uiAlign, ezMemoryUtils::DestructorFunction destructorFunc)
 {
-  EZ_LOCK(m_Mutex);
+  void* ptr = nullptr;
+
+  if (ezMemoryPolicies::ezStackAllocation* pArena = GetThreadArena())
+  {
+    // same behavior as ezAllocatorImpl::Allocate, but on the thread's own arena
+    if (uiSize == 0)
+      return nullptr;
+
+    EZ_ASSERT_DEBUG(ezMath::IsPowerOf2((ezUInt32)uiAlign), "Alignment must be power of two");
+
+    if ((TrackingFlags & ezMemoryTrackingFlags::EnableAllocationTracking) != 0)
+    {
+      const ezTime fAllocationTime = ezTime::Now();
+
+      ptr = pArena->Allocate(uiSize, uiAlign);
 
-  void* ptr = ezAllocator<ezMemoryPolicies::ezStackAllocation, TrackingFlags>::Allocate(uiSize, uiAlign, destructorFunc);
+      ezBitflags<ezMemoryTrackingFlags> flags;
+      flags.SetValue(TrackingFlags);
 
-  if (destructorFunc != nullptr)
+      ezMemoryTracker::AddAllocation(this->m_Id, flags, ptr, uiSize, uiAlign, ezTime::Now() - fAllocationTime);
+    }
+    else
+    {
+      ptr = pArena->Allocate(uiSize, uiAlign);
+    }
+  }
+  else
   {
+    EZ_LOCK(m_Mutex);
+    ptr = ezAllocator<ezMemoryPolicies::ezStackAllocation, TrackingFlags>::Allocate(uiSize, uiAlign, destructorFunc);
+  }
+
+  if (destructorFunc != nullptr && ptr != nullptr)
+  {
+    EZ_LOCK(m_Mutex);
+
     ezUInt32 uiIndex = m_DestructData.GetCount();
     m_PtrToDestructDataIndexTable.Insert(ptr, uiIndex);
+    m_iNumDestructors.Increment();
 
     auto& data = m_DestructData.ExpandAndGetRef();
     data.m_Func = destructorFunc;
@@ -35,17 +91,27 @@ void* ezStackAllocator<TrackingFlags>::Allocate(size_t uiSize, size_t uiAlign, e
 template <ezUInt32 TrackingFlags>
 void ezStackAllocator<TrackingFlags>::Deallocate(void* ptr)
 {
-  EZ_LOCK(m_Mutex);
-
-  ezUInt32 uiIndex;
-  if (m_PtrToDestructDataIndexTable.Remove(ptr, &uiIndex))
+  // If ptr has a destructor registered, the counter can't be zero since the allocation happened before.
+  if (m_iNumDestructors > 0)
   {
-    auto& data = m_DestructData[uiIndex];
-    data.m_Func = nullptr;
-    data.m_Ptr = nullptr;
+    EZ_LOCK(m_Mutex);
+
+    ezUInt32 uiIndex;
+    if (m_PtrToDestructDataIndexTable.Remove(ptr, &uiIndex))
+    {
+      m_iNumDestructors.Decrement();
+
+      auto& data = m_DestructData[uiIndex];
+      data.m_Func = nullptr;
+      data.m_Ptr = nullptr;
+    }
   }
 
-  ezAllocator<ezMemoryPolicies::ezStackAllocation, TrackingFlags>::Deallocate(ptr);
+  // the memory itself is only freed in Reset()
+  if ((TrackingFlags & ezMemoryTrackingFlags::EnableAllocationTracking) != 0)
+  {
+    ezMemoryTracker::RemoveAllocation(this->m_Id, ptr);
+  }
 }
 
 EZ_MSVC_ANALYSIS_WARNING_PUSH
@@ -67,8 +133,17 @@ void ezStackAllocator<TrackingFlags>::Reset()
   }
   m_DestructData.Clear();
   m_PtrToDestructDataIndexTable.Clear();
+  m_iNumDestructors = 0;
 
   this->m_allocator.Reset();
+  for (ezMemoryPolicies::ezStackAllocation* pArena : m_ThreadArenas)
+  {
+    if (pArena != nullptr)
+    {
+      pArena->Reset();
+    }
+  }
+
   if ((TrackingFlags & ezMemoryTrackingFlags::EnableAllocationTracking) != 0)
   {
     ezMemoryTracker::RemoveAllAllocations(this->m_Id);
@@ -78,6 +153,18 @@ void ezStackAllocator<TrackingFlags>::Reset()
     ezAllocatorBase::Stats stats;
     this->m_allocator.FillStats(stats);
 
+    for (ezMemoryPolicies::ezStackAllocation* pArena : m_ThreadArenas)
+    {
+      if (pArena != nullptr)
+      {
+        ezAllocatorBase::Stats arenaStats;
+        pArena->FillStats(arenaStats);
+
+        stats.m_uiNumAllocations += arenaStats.m_uiNumAllocations;
+        stats.m_uiAllocationSize += arenaStats.m_uiAllocationSize;
+      }
+    }
+
     ezMemoryTracker::SetAllocatorStats(this->m_Id, stats);
   }
 }
@@ -4,9 +4,26 @@
 #include <Foundation/Containers/HashTable.h>
 #include <Foundation/Memory/Allocator.h>
 #include <Foundation/Memory/Policies/StackAllocation.h>
+#include <Foundation/Threading/AtomicInteger.h>
 #include <Foundation/Threading/Lock.h>
 #include <Foundation/Threading/Mutex.h>
 
+namespace ezInternal
+{
+  /// \brief Maximum number of threads that can use their own arena in an ezStackAllocator at the same time.
+  static constexpr ezUInt32 StackAllocatorMaxThreads = 64;
+
+  /// \brief Returns an index in [0, StackAllocatorMaxThreads) that is unique among all running threads, or ezInvalidIndex if all indices are in use.
+  ///
+  /// Indices are returned when a thread exits, so a new thread may reuse the arenas of a previous one.
+  EZ_FOUNDATION_DLL ezUInt32 GetStackAllocatorThreadIndex();
+} // namespace ezInternal
+
+/// \brief An allocator that works like a stack, individual deallocations do not free any memory, everything is freed at once with Reset().
+///
+/// Every thread allocates from its own bump arena, so allocating is lock-free as long as no destructor needs to be recorded.
+/// Only allocations of types that are not trivially destructible are registered in a table, so that Reset() can run their destructors.
+/// Reset() must not be called while other threads allocate from the same allocator.
 template <ezUInt32 TrackingFlags = ezMemoryTrackingFlags::Default>
 class ezStackAllocator : public ezAllocator<ezMemoryPolicies::ezStackAllocation, TrackingFlags>
 {
@@ -22,6 +39,9 @@ public:
   void Reset();
 
 private:
+  /// \brief Returns the arena of the calling thread or nullptr if the thread has to use the shared, locked arena.
+  ezMemoryPolicies::ezStackAllocation* GetThreadArena();
+
   struct DestructData
   {
     EZ_DECLARE_POD_TYPE();
@@ -30,9 +50,22 @@ private:
     void* m_Ptr;
   };
 
+  /// \brief The pointers of the per-thread arenas interleave in several sequential runs, which the default pointer hash spreads
+  /// so poorly that the hash table degrades into long probe chains. Mix all bits instead.
+  struct PtrHash
+  {
+    EZ_ALWAYS_INLINE static ezUInt32 Hash(void* ptr) { return ezHashingUtils::MurmurHash32(&ptr, sizeof(ptr)); }
+    EZ_ALWAYS_INLINE static bool Equal(void* a, void* b) { return a == b; }
+  };
+
   ezMutex m_Mutex;
   ezDynamicArray<DestructData> m_DestructData;
-  ezHashTable<void*, ezUInt32> m_PtrToDestructDataIndexTable;
+  ezHashTable<void*, ezUInt32, PtrHash> m_PtrToDestructDataIndexTable;
+
+  /// \brief Number of entries in m_PtrToDestructDataIndexTable, allows Deallocate to skip the lock when there are no destructors at all.
+  ezAtomicInteger32 m_iNumDestructors;
+
+  ezMemoryPolicies::ezStackAllocation* m_ThreadArenas[ezInternal::StackAllocatorMaxThreads] = {};
 };
 
 #include <Foundation/Memory/Implementation/StackAllocator_inl.h>
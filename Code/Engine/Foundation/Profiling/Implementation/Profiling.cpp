@@ -3,9 +3,12 @@
 #include <Foundation/Communication/DataTransfer.h>
 #include <Foundation/Configuration/CVar.h>
 #include <Foundation/Configuration/Startup.h>
+#include <Foundation/Containers/HashTable.h>
 #include <Foundation/Containers/IdTable.h>
 #include <Foundation/Containers/StaticRingBuffer.h>
 #include <Foundation/IO/JSONWriter.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/IO/OSFile.h>
 #include <Foundation/Memory/CommonAllocators.h>
 #include <Foundation/Profiling/Profiling.h>
 #include <Foundation/Threading/ThreadUtils.h>
@@ -74,6 +77,11 @@ namespace
     {
       return m_uiThreadId == s_MainThreadId;
     }
+
+    // All scopes since the last time the stream was flushed, only filled while streaming is active.
+    // The mutex is only contended when the main thread drains the scopes once per frame.
+    ezMutex m_StreamMutex;
+    ezDynamicArray<ezProfilingSystem::CPUScope> m_StreamedScopes;
   };
 
   template <ezUInt32 SizeInBytes>
@@ -114,9 +122,270 @@ namespace
 
   static GPUScopesBuffer* s_GPUScopes;
 
+  //////////////////////////////////////////////////////////////////////////
+  // Streaming
+  //
+  // The stream starts with a header (magic, version, ezUInt32 process ID) followed by a sequence of records.
+  // Each record starts with its ezUInt8 type. Strings are only written once and referenced by their ID afterwards,
+  // times are stored as ezUInt64 nanoseconds.
+
+  constexpr char s_StreamMagic[4] = {'E', 'Z', 'P', 'S'};
+  constexpr ezUInt8 s_uiStreamVersion = 1;
+
+  struct StreamRecord
+  {
+    enum Enum : ezUInt8
+    {
+      String,     ///< ezUInt32 ID, ezUInt32 length, characters
+      ThreadName, ///< ezUInt64 thread ID, ezUInt32 name ID
+      Frame,      ///< ezUInt64 frame counter, ezUInt64 frame start time
+      CPUScopes,  ///< ezUInt64 thread ID, ezUInt32 count, count * (ezUInt32 name ID, ezUInt32 function ID or ezInvalidIndex, ezUInt64 begin, ezUInt64 end)
+      GPUScopes,  ///< ezUInt32 count, count * (ezUInt32 name ID, ezUInt64 begin, ezUInt64 end)
+    };
+  };
+
+  struct StreamStringHashHelper
+  {
+    EZ_ALWAYS_INLINE static ezUInt32 Hash(ezStringView sValue)
+    {
+      return ezHashingUtils::MurmurHash32(sValue.GetStartPointer(), sValue.GetElementCount());
+    }
+
+    EZ_ALWAYS_INLINE static bool Equal(const ezString& a, ezStringView b)
+    {
+      return a == b;
+    }
+  };
+
+  struct StreamingState
+  {
+    StreamingState()
+      : m_Writer(&m_Storage)
+    {
+    }
+
+    ezOSFile m_File;
+    ezMemoryStreamStorage m_Storage;
+    ezMemoryStreamWriter m_Writer;
+
+    ezHashTable<ezString, ezUInt32, StreamStringHashHelper> m_StringIDs;
+    ezHybridArray<ezUInt64, 16> m_WrittenThreadIDs;
+
+    ezDynamicArray<ezProfilingSystem::CPUScope> m_PendingCPUScopes;
+    ezDynamicArray<ezProfilingSystem::GPUScope> m_PendingGPUScopes;
+    ezDynamicArray<ezUInt32> m_PendingStringIDs;
+  };
+
+  static ezAtomicBool s_bStreaming;
+  static ezMutex s_StreamingMutex;
+  static StreamingState* s_pStreamingState = nullptr;
+
+  static ezDynamicArray<ezProfilingSystem::GPUScope> s_StreamedGPUScopes;
+  static ezMutex s_StreamedGPUScopesMutex;
+
+  EZ_ALWAYS_INLINE ezUInt64 ToStreamTime(ezTime t)
+  {
+    return static_cast<ezUInt64>(t.GetNanoseconds());
+  }
+
+  void WriteStreamString(ezStreamWriter& writer, ezStringView sString)
+  {
+    const ezUInt32 uiLength = sString.GetElementCount();
+    writer << uiLength;
+    writer.WriteBytes(sString.GetStartPointer(), uiLength);
+  }
+
+  ezResult ReadStreamString(ezStreamReader& reader, ezStringBuilder& out_sString)
+  {
+    ezUInt32 uiLength = 0;
+    EZ_SUCCEED_OR_RETURN(reader.ReadDWordValue(&uiLength));
+
+    ezHybridArray<char, 256> buffer;
+    buffer.SetCountUninitialized(uiLength + 1);
+    if (reader.ReadBytes(buffer.GetData(), uiLength) != uiLength)
+      return EZ_FAILURE;
+
+    buffer[uiLength] = '\0';
+    out_sString = buffer.GetData();
+    return EZ_SUCCESS;
+  }
+
+  ezUInt32 GetStreamStringID(StreamingState& state, ezStringView sString)
+  {
+    ezUInt32 uiID = 0;
+    if (state.m_StringIDs.TryGetValue(sString, uiID))
+      return uiID;
+
+    uiID = state.m_StringIDs.GetCount();
+    state.m_StringIDs.Insert(ezString(sString), uiID);
+
+    state.m_Writer << static_cast<ezUInt8>(StreamRecord::String);
+    state.m_Writer << uiID;
+    WriteStreamString(state.m_Writer, sString);
+
+    return uiID;
+  }
+
+  /// Moves all scopes that were recorded since the last call into the stream's memory buffer. s_StreamingMutex must be locked.
+  void DrainStreamedScopes(StreamingState& state)
+  {
+    {
+      EZ_LOCK(s_ThreadInfosMutex);
+
+      for (const ezProfilingSystem::ThreadInfo& info : s_ThreadInfos)
+      {
+        if (state.m_WrittenThreadIDs.Contains(info.m_uiThreadId))
+          continue;
+
+        state.m_WrittenThreadIDs.PushBack(info.m_uiThreadId);
+
+        const ezUInt32 uiNameID = GetStreamStringID(state, info.m_sName);
+        state.m_Writer << static_cast<ezUInt8>(StreamRecord::ThreadName);
+        state.m_Writer << info.m_uiThreadId;
+        state.m_Writer << uiNameID;
+      }
+    }
+
+    {
+      EZ_LOCK(s_AllCpuScopesMutex);
+
+      for (CpuScopesBufferBase* pEventBuffer : s_AllCpuScopes)
+      {
+        {
+          // Swapping hands the (cleared) capacity of the previous buffer over to the thread, so this does not allocate in the steady state.
+          EZ_LOCK(pEventBuffer->m_StreamMutex);
+          state.m_PendingCPUScopes.Swap(pEventBuffer->m_StreamedScopes);
+        }
+
+        const ezUInt32 uiNumScopes = state.m_PendingCPUScopes.GetCount();
+        if (uiNumScopes == 0)
+          continue;
+
+        // Strings have to be written before the record that references them.
+        state.m_PendingStringIDs.SetCountUninitialized(uiNumScopes * 2);
+        for (ezUInt32 i = 0; i < uiNumScopes; ++i)
+        {
+          const ezProfilingSystem::CPUScope& scope = state.m_PendingCPUScopes[i];
+          state.m_PendingStringIDs[i * 2 + 0] = GetStreamStringID(state, scope.m_szName);
+          state.m_PendingStringIDs[i * 2 + 1] = scope.m_szFunctionName != nullptr ? GetStreamStringID(state, scope.m_szFunctionName) : ezInvalidIndex;
+        }
+
+        state.m_Writer << static_cast<ezUInt8>(StreamRecord::CPUScopes);
+        state.m_Writer << pEventBuffer->m_uiThreadId;
+        state.m_Writer << uiNumScopes;
+
+        for (ezUInt32 i = 0; i < uiNumScopes; ++i)
+        {
+          const ezProfilingSystem::CPUScope& scope = state.m_PendingCPUScopes[i];
+          state.m_Writer << state.m_PendingStringIDs[i * 2 + 0];
+          state.m_Writer << state.m_PendingStringIDs[i * 2 + 1];
+          state.m_Writer << ToStreamTime(scope.m_BeginTime);
+          state.m_Writer << ToStreamTime(scope.m_EndTime);
+        }
+
+        state.m_PendingCPUScopes.Clear();
+      }
+    }
+
+    {
+      {
+        EZ_LOCK(s_StreamedGPUScopesMutex);
+        state.m_PendingGPUScopes.Swap(s_StreamedGPUScopes);
+      }
+
+      const ezUInt32 uiNumScopes = state.m_PendingGPUScopes.GetCount();
+      if (uiNumScopes > 0)
+      {
+        state.m_PendingStringIDs.SetCountUninitialized(uiNumScopes);
+        for (ezUInt32 i = 0; i < uiNumScopes; ++i)
+        {
+          state.m_PendingStringIDs[i] = GetStreamStringID(state, state.m_PendingGPUScopes[i].m_szName);
+        }
+
+        state.m_Writer << static_cast<ezUInt8>(StreamRecord::GPUScopes);
+        state.m_Writer << uiNumScopes;
+
+        for (ezUInt32 i = 0; i < uiNumScopes; ++i)
+        {
+          const ezProfilingSystem::GPUScope& scope = state.m_PendingGPUScopes[i];
+          state.m_Writer << state.m_PendingStringIDs[i];
+          state.m_Writer << ToStreamTime(scope.m_BeginTime);
+          state.m_Writer << ToStreamTime(scope.m_EndTime);
+        }
+
+        state.m_PendingGPUScopes.Clear();
+      }
+    }
+  }
+
+  /// Writes the stream's memory buffer to the file. Closes the stream if that fails. s_StreamingMutex must be locked.
+  void FlushStream()
+  {
+    StreamingState& state = *s_pStreamingState;
+
+    const ezUInt32 uiNumBytes = state.m_Storage.GetStorageSize();
+    if (uiNumBytes == 0)
+      return;
+
+    if (state.m_File.Write(state.m_Storage.GetData(), uiNumBytes).Failed())
+    {
+      ezLog::Error("Failed to write to profiling stream '{0}', streaming is stopped.", state.m_File.GetOpenFileName());
+
+      s_bStreaming = false;
+      EZ_DEFAULT_DELETE(s_pStreamingState);
+      return;
+    }
+
+    state.m_Storage.Clear();
+    state.m_Writer.SetWritePosition(0);
+  }
+
+  void WriteThreadMetadata(ezJSONWriter& writer, ezUInt32 uiProcessID, ezUInt64 uiThreadID, const char* szName)
+  {
+    writer.BeginObject();
+    writer.AddVariableString("name", "thread_name");
+    writer.AddVariableString("cat", "__metadata");
+    writer.AddVariableUInt32("pid", uiProcessID);
+    writer.AddVariableUInt64("tid", uiThreadID);
+    writer.AddVariableString("ph", "M");
+
+    writer.BeginObject("args");
+    writer.AddVariableString("name", szName);
+    writer.EndObject();
+
+    writer.EndObject();
+  }
+
+  void WriteThreadSortIndexMetadata(ezJSONWriter& writer, ezUInt32 uiProcessID, ezUInt64 uiThreadID, ezInt32 iSortIndex)
+  {
+    writer.BeginObject();
+    writer.AddVariableString("name", "thread_sort_index");
+    writer.AddVariableString("cat", "__metadata");
+    writer.AddVariableUInt32("pid", uiProcessID);
+    writer.AddVariableUInt64("tid", uiThreadID);
+    writer.AddVariableString("ph", "M");
+
+    writer.BeginObject("args");
+    writer.AddVariableInt32("sort_index", iSortIndex);
+    writer.EndObject();
+
+    writer.EndObject();
+  }
+
   static ezEventSubscriptionID s_PluginEventSubscription = 0;
   void PluginEvent(const ezPluginEvent& e)
   {
+    if (e.m_EventType == ezPluginEvent::BeforeUnloading && s_bStreaming)
+    {
+      // The streamed scopes can point to function names inside the plugin, write them out while they are still valid.
+      EZ_LOCK(s_StreamingMutex);
+      if (s_pStreamingState != nullptr)
+      {
+        DrainStreamedScopes(*s_pStreamingState);
+        FlushStream();
+      }
+    }
+
     if (e.m_EventType == ezPluginEvent::AfterUnloading)
     {
       // When a plugin is unloaded we need to clear all profiling data
@@ -138,31 +407,8 @@ ezResult ezProfilingSystem::ProfilingData::Write(ezStreamWriter& outputStream) c
 
     // Frames thread metadata
     {
-      writer.BeginObject();
-      writer.AddVariableString("name", "thread_name");
-      writer.AddVariableString("cat", "__metadata");
-      writer.AddVariableUInt32("pid", m_uiProcessID);
-      writer.AddVariableUInt64("tid", m_uiFramesThreadID);
-      writer.AddVariableString("ph", "M");
-
-      writer.BeginObject("args");
-      writer.AddVariableString("name", "Frames");
-      writer.EndObject();
-
-      writer.EndObject();
-
-      writer.BeginObject();
-      writer.AddVariableString("name", "thread_sort_index");
-      writer.AddVariableString("cat", "__metadata");
-      writer.AddVariableUInt32("pid", m_uiProcessID);
-      writer.AddVariableUInt64("tid", m_uiFramesThreadID);
-      writer.AddVariableString("ph", "M");
-
-      writer.BeginObject("args");
-      writer.AddVariableInt32("sort_index", -1);
-      writer.EndObject();
-
-      writer.EndObject();
+      WriteThreadMetadata(writer, m_uiProcessID, m_uiFramesThreadID, "Frames");
+      WriteThreadSortIndexMetadata(writer, m_uiProcessID, m_uiFramesThreadID, -1);
 
       if (writer.HadWriteError())
       {
@@ -172,31 +418,9 @@ ezResult ezProfilingSystem::ProfilingData::Write(ezStreamWriter& outputStream) c
 
     // GPU thread metadata
     {
-      writer.BeginObject();
-      writer.AddVariableString("name", "thread_name");
-      writer.AddVariableString("cat", "__metadata");
-      writer.AddVariableUInt32("pid", m_uiProcessID);
-      writer.AddVariableUInt64("tid", m_uiGPUThreadID);
-      writer.AddVariableString("ph", "M");
-
-      writer.BeginObject("args");
-      writer.AddVariableString("name", "GPU");
-      writer.EndObject();
-
-      writer.EndObject();
-
-      writer.BeginObject();
-      writer.AddVariableString("name", "thread_sort_index");
-      writer.AddVariableString("cat", "__metadata");
-      writer.AddVariableUInt32("pid", m_uiProcessID);
-      writer.AddVariableUInt64("tid", m_uiGPUThreadID);
-      writer.AddVariableString("ph", "M");
+      WriteThreadMetadata(writer, m_uiProcessID, m_uiGPUThreadID, "GPU");
+      WriteThreadSortIndexMetadata(writer, m_uiProcessID, m_uiGPUThreadID, -2);
 
-      writer.BeginObject("args");
-      writer.AddVariableInt32("sort_index", -2);
-      writer.EndObject();
-
-      writer.EndObject();
       if (writer.HadWriteError())
       {
         return EZ_FAILURE;
@@ -207,18 +431,7 @@ ezResult ezProfilingSystem::ProfilingData::Write(ezStreamWriter& outputStream) c
     {
       for (const ThreadInfo& info : m_ThreadInfos)
       {
-        writer.BeginObject();
-        writer.AddVariableString("name", "thread_name");
-        writer.AddVariableString("cat", "__metadata");
-        writer.AddVariableUInt32("pid", m_uiProcessID);
-        writer.AddVariableUInt64("tid", info.m_uiThreadId + 2);
-        writer.AddVariableString("ph", "M");
-
-        writer.BeginObject("args");
-        writer.AddVariableString("name", info.m_sName);
-        writer.EndObject();
-
-        writer.EndObject();
+        WriteThreadMetadata(writer, m_uiProcessID, info.m_uiThreadId + 2, info.m_sName);
 
         if (writer.HadWriteError())
         {
@@ -349,6 +562,232 @@ ezResult ezProfilingSystem::ProfilingData::Write(ezStreamWriter& outputStream) c
   return writer.HadWriteError() ? EZ_FAILURE : EZ_SUCCESS;
 }
 
+// static
+ezResult ezProfilingSystem::ConvertStreamToTraceEvents(ezStreamReader& inputStream, ezStreamWriter& outputStream)
+{
+  char magic[4] = {};
+  ezUInt8 uiVersion = 0;
+  ezUInt32 uiProcessID = 0;
+
+  if (inputStream.ReadBytes(magic, EZ_ARRAY_SIZE(magic)) != EZ_ARRAY_SIZE(magic) || !ezMemoryUtils::IsEqual(magic, s_StreamMagic, EZ_ARRAY_SIZE(magic)))
+  {
+    ezLog::Error("Input is not a profiling stream.");
+    return EZ_FAILURE;
+  }
+
+  inputStream >> uiVersion;
+  if (uiVersion != s_uiStreamVersion)
+  {
+    ezLog::Error("Unsupported profiling stream version {0}, expected version {1}.", uiVersion, s_uiStreamVersion);
+    return EZ_FAILURE;
+  }
+
+  EZ_SUCCEED_OR_RETURN(inputStream.ReadDWordValue(&uiProcessID));
+
+  // Same thread IDs as in Capture(), CPU threads are offset by 2.
+  const ezUInt64 uiFramesThreadID = 1;
+  const ezUInt64 uiGPUThreadID = 0;
+
+  struct StreamedScope
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiNameID;
+    ezUInt32 m_uiFunctionID;
+    ezUInt64 m_uiBeginTime;
+    ezUInt64 m_uiEndTime;
+  };
+
+  ezStandardJSONWriter writer;
+  writer.SetWhitespaceMode(ezJSONWriter::WhitespaceMode::None);
+  writer.SetOutputStream(&outputStream);
+
+  ezDynamicArray<ezString> strings;
+  ezDynamicArray<StreamedScope> scopes;
+  ezStringBuilder sTemp;
+
+  bool bHasFrame = false;
+  ezUInt64 uiLastFrame = 0;
+  ezUInt64 uiLastFrameStartTime = 0;
+
+  auto ReadScopes = [&](ezUInt32 uiNumScopes, bool bHasFunction) -> ezResult {
+    scopes.SetCountUninitialized(uiNumScopes);
+    for (StreamedScope& scope : scopes)
+    {
+      scope.m_uiFunctionID = ezInvalidIndex;
+
+      EZ_SUCCEED_OR_RETURN(inputStream.ReadDWordValue(&scope.m_uiNameID));
+      if (bHasFunction)
+      {
+        EZ_SUCCEED_OR_RETURN(inputStream.ReadDWordValue(&scope.m_uiFunctionID));
+      }
+      EZ_SUCCEED_OR_RETURN(inputStream.ReadQWordValue(&scope.m_uiBeginTime));
+      EZ_SUCCEED_OR_RETURN(inputStream.ReadQWordValue(&scope.m_uiEndTime));
+
+      if (scope.m_uiNameID >= strings.GetCount() || (scope.m_uiFunctionID != ezInvalidIndex && scope.m_uiFunctionID >= strings.GetCount()))
+        return EZ_FAILURE;
+    }
+
+    // Scopes are recorded when they end, so nested scopes come before their parents.
+    // Sort them by begin time and longest first, so that viewers nest scopes with equal begin times correctly.
+    scopes.Sort([](const StreamedScope& a, const StreamedScope& b) {
+      if (a.m_uiBeginTime != b.m_uiBeginTime)
+        return a.m_uiBeginTime < b.m_uiBeginTime;
+
+      return (a.m_uiEndTime - a.m_uiBeginTime) > (b.m_uiEndTime - b.m_uiBeginTime);
+    });
+
+    return EZ_SUCCESS;
+  };
+
+  auto WriteCompleteEvent = [&](const char* szName, ezUInt64 uiThreadID, ezUInt64 uiBeginTime, ezUInt64 uiEndTime, const char* szFunctionName) {
+    writer.BeginObject();
+    writer.AddVariableString("name", szName);
+    writer.AddVariableUInt32("pid", uiProcessID);
+    writer.AddVariableUInt64("tid", uiThreadID);
+    writer.AddVariableDouble("ts", uiBeginTime / 1000.0);
+    writer.AddVariableDouble("dur", (uiEndTime - uiBeginTime) / 1000.0);
+    writer.AddVariableString("ph", "X");
+
+    if (szFunctionName != nullptr)
+    {
+      writer.BeginObject("args");
+      writer.AddVariableString("function", szFunctionName);
+      writer.EndObject();
+    }
+
+    writer.EndObject();
+  };
+
+  writer.BeginObject();
+  writer.BeginArray("traceEvents");
+
+  WriteThreadMetadata(writer, uiProcessID, uiFramesThreadID, "Frames");
+  WriteThreadSortIndexMetadata(writer, uiProcessID, uiFramesThreadID, -1);
+  WriteThreadMetadata(writer, uiProcessID, uiGPUThreadID, "GPU");
+  WriteThreadSortIndexMetadata(writer, uiProcessID, uiGPUThreadID, -2);
+
+  ezResult result = EZ_SUCCESS;
+
+  while (!writer.HadWriteError())
+  {
+    ezUInt8 uiRecordType = 0;
+    if (inputStream.ReadBytes(&uiRecordType, sizeof(ezUInt8)) != sizeof(ezUInt8))
+      break;
+
+    // A truncated record at the end of the stream, e.g. because the application crashed, ends the conversion but is not an error.
+    bool bTruncated = false;
+
+    switch (uiRecordType)
+    {
+      case StreamRecord::String:
+      {
+        ezUInt32 uiID = 0;
+        bTruncated = inputStream.ReadDWordValue(&uiID).Failed() || ReadStreamString(inputStream, sTemp).Failed();
+        if (!bTruncated)
+        {
+          if (uiID != strings.GetCount())
+          {
+            result = EZ_FAILURE;
+            break;
+          }
+
+          strings.PushBack(sTemp);
+        }
+      }
+      break;
+
+      case StreamRecord::ThreadName:
+      {
+        ezUInt64 uiThreadID = 0;
+        ezUInt32 uiNameID = 0;
+        bTruncated = inputStream.ReadQWordValue(&uiThreadID).Failed() || inputStream.ReadDWordValue(&uiNameID).Failed();
+        if (!bTruncated)
+        {
+          if (uiNameID >= strings.GetCount())
+          {
+            result = EZ_FAILURE;
+            break;
+          }
+
+          WriteThreadMetadata(writer, uiProcessID, uiThreadID + 2, strings[uiNameID]);
+        }
+      }
+      break;
+
+      case StreamRecord::Frame:
+      {
+        ezUInt64 uiFrame = 0;
+        ezUInt64 uiStartTime = 0;
+        bTruncated = inputStream.ReadQWordValue(&uiFrame).Failed() || inputStream.ReadQWordValue(&uiStartTime).Failed();
+        if (!bTruncated)
+        {
+          // A frame ends when the next one starts.
+          if (bHasFrame)
+          {
+            sTemp.Format("Frame {}", uiLastFrame);
+            WriteCompleteEvent(sTemp, uiFramesThreadID, uiLastFrameStartTime, uiStartTime, nullptr);
+          }
+
+          bHasFrame = true;
+          uiLastFrame = uiFrame;
+          uiLastFrameStartTime = uiStartTime;
+        }
+      }
+      break;
+
+      case StreamRecord::CPUScopes:
+      {
+        ezUInt64 uiThreadID = 0;
+        ezUInt32 uiNumScopes = 0;
+        bTruncated = inputStream.ReadQWordValue(&uiThreadID).Failed() || inputStream.ReadDWordValue(&uiNumScopes).Failed() || ReadScopes(uiNumScopes, true).Failed();
+        if (!bTruncated)
+        {
+          for (const StreamedScope& scope : scopes)
+          {
+            const char* szFunctionName = scope.m_uiFunctionID != ezInvalidIndex ? strings[scope.m_uiFunctionID].GetData() : nullptr;
+            WriteCompleteEvent(strings[scope.m_uiNameID], uiThreadID + 2, scope.m_uiBeginTime, scope.m_uiEndTime, szFunctionName);
+          }
+        }
+      }
+      break;
+
+      case StreamRecord::GPUScopes:
+      {
+        ezUInt32 uiNumScopes = 0;
+        bTruncated = inputStream.ReadDWordValue(&uiNumScopes).Failed() || ReadScopes(uiNumScopes, false).Failed();
+        if (!bTruncated)
+        {
+          for (const StreamedScope& scope : scopes)
+          {
+            WriteCompleteEvent(strings[scope.m_uiNameID], uiGPUThreadID, scope.m_uiBeginTime, scope.m_uiEndTime, nullptr);
+          }
+        }
+      }
+      break;
+
+      default:
+        ezLog::Error("Unknown record type {0} in profiling stream.", uiRecordType);
+        result = EZ_FAILURE;
+        break;
+    }
+
+    if (bTruncated || result.Failed())
+      break;
+  }
+
+  writer.EndArray();
+  writer.EndObject();
+
+  if (result.Failed())
+  {
+    ezLog::Error("Profiling stream is corrupted.");
+    return EZ_FAILURE;
+  }
+
+  return writer.HadWriteError() ? EZ_FAILURE : EZ_SUCCESS;
+}
+
 // static
 void ezProfilingSystem::Clear()
 {
@@ -461,12 +900,103 @@ void ezProfilingSystem::StartNewFrame()
 {
   ++s_uiFrameCount;
 
+  const ezTime frameStartTime = ezTime::Now();
+
   if (!s_FrameStartTimes.CanAppend())
   {
     s_FrameStartTimes.PopFront();
   }
 
-  s_FrameStartTimes.PushBack(ezTime::Now());
+  s_FrameStartTimes.PushBack(frameStartTime);
+
+  if (s_bStreaming)
+  {
+    EZ_LOCK(s_StreamingMutex);
+
+    if (s_pStreamingState != nullptr)
+    {
+      DrainStreamedScopes(*s_pStreamingState);
+
+      s_pStreamingState->m_Writer << static_cast<ezUInt8>(StreamRecord::Frame);
+      s_pStreamingState->m_Writer << s_uiFrameCount;
+      s_pStreamingState->m_Writer << ToStreamTime(frameStartTime);
+
+      FlushStream();
+    }
+  }
+}
+
+// static
+ezResult ezProfilingSystem::StartStreaming(const char* szAbsoluteFilePath)
+{
+  StopStreaming();
+
+  EZ_LOCK(s_StreamingMutex);
+
+  StreamingState* pState = EZ_DEFAULT_NEW(StreamingState);
+  if (pState->m_File.Open(szAbsoluteFilePath, ezFileOpenMode::Write).Failed())
+  {
+    ezLog::Error("Failed to open profiling stream '{0}'.", szAbsoluteFilePath);
+    EZ_DEFAULT_DELETE(pState);
+    return EZ_FAILURE;
+  }
+
+#  if EZ_ENABLED(EZ_SUPPORTS_PROCESSES)
+  const ezUInt32 uiProcessID = static_cast<ezUInt32>(ezProcess::GetCurrentProcessID());
+#  else
+  const ezUInt32 uiProcessID = 0;
+#  endif
+
+  pState->m_Writer.WriteBytes(s_StreamMagic, EZ_ARRAY_SIZE(s_StreamMagic));
+  pState->m_Writer << s_uiStreamVersion;
+  pState->m_Writer << uiProcessID;
+
+  // discard anything that was recorded after a previous stream has been stopped
+  {
+    EZ_LOCK(s_AllCpuScopesMutex);
+    for (CpuScopesBufferBase* pEventBuffer : s_AllCpuScopes)
+    {
+      EZ_LOCK(pEventBuffer->m_StreamMutex);
+      pEventBuffer->m_StreamedScopes.Clear();
+    }
+  }
+  {
+    EZ_LOCK(s_StreamedGPUScopesMutex);
+    s_StreamedGPUScopes.Clear();
+  }
+
+  s_pStreamingState = pState;
+  s_bStreaming = true;
+
+  FlushStream();
+
+  return s_bStreaming ? EZ_SUCCESS : EZ_FAILURE;
+}
+
+// static
+void ezProfilingSystem::StopStreaming()
+{
+  EZ_LOCK(s_StreamingMutex);
+
+  if (s_pStreamingState == nullptr)
+    return;
+
+  s_bStreaming = false;
+
+  DrainStreamedScopes(*s_pStreamingState);
+  FlushStream();
+
+  if (s_pStreamingState != nullptr)
+  {
+    s_pStreamingState->m_File.Close();
+    EZ_DEFAULT_DELETE(s_pStreamingState);
+  }
+}
+
+// static
+bool ezProfilingSystem::IsStreaming()
+{
+  return s_bStreaming;
 }
 
 // static
@@ -524,6 +1054,12 @@ void ezProfilingSystem::AddCPUScope(const char* szName, const char* szFunctionNa
 
     pOtherThreadBuffer->m_Data.PushBack(scope);
   }
+
+  if (s_bStreaming)
+  {
+    EZ_LOCK(pScopes->m_StreamMutex);
+    pScopes->m_StreamedScopes.PushBack(scope);
+  }
 }
 
 // static
@@ -539,6 +1075,9 @@ void ezProfilingSystem::Initialize()
 // static
 void ezProfilingSystem::Reset()
 {
+  // write out the scopes of the dead threads before their buffers are deleted
+  StopStreaming();
+
   EZ_LOCK(s_ThreadInfosMutex);
   EZ_LOCK(s_AllCpuScopesMutex);
   for (ezUInt32 i = 0; i < s_DeadThreadIDs.GetCount(); i++)
@@ -615,6 +1154,12 @@ void ezProfilingSystem::AddGPUScope(const char* szName, ezTime beginTime, ezTime
   ezStringUtils::Copy(scope.m_szName, EZ_ARRAY_SIZE(scope.m_szName), szName);
 
   s_GPUScopes->PushBack(scope);
+
+  if (s_bStreaming)
+  {
+    EZ_LOCK(s_StreamedGPUScopesMutex);
+    s_StreamedGPUScopes.PushBack(scope);
+  }
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -685,6 +1230,23 @@ void ezProfilingSystem::SetDiscardThreshold(ezTime threshold) {}
 
 void ezProfilingSystem::StartNewFrame() {}
 
+ezResult ezProfilingSystem::StartStreaming(const char* szAbsoluteFilePath)
+{
+  return EZ_FAILURE;
+}
+
+void ezProfilingSystem::StopStreaming() {}
+
+bool ezProfilingSystem::IsStreaming()
+{
+  return false;
+}
+
+ezResult ezProfilingSystem::ConvertStreamToTraceEvents(ezStreamReader& inputStream, ezStreamWriter& outputStream)
+{
+  return EZ_FAILURE;
+}
+
 void ezProfilingSystem::AddCPUScope(const char* szName, const char* szFunctionName, ezTime beginTime, ezTime endTime) {}
 
 void ezProfilingSystem::Initialize() {}
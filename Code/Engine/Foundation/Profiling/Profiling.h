@@ -6,6 +6,7 @@
 #include <Foundation/System/Process.h>
 #include <Foundation/Time/Time.h>
 
+class ezStreamReader;
 class ezStreamWriter;
 class ezThread;
 
@@ -126,6 +127,27 @@ public:
   /// \brief Adds a new scoped event for the calling thread in the profiling system
   static void AddCPUScope(const char* szName, const char* szFunctionName, ezTime beginTime, ezTime endTime);
 
+  /// \brief Starts continuously streaming all CPU and GPU scopes and the frame start times to the given file.
+  ///
+  /// While streaming is active, StartNewFrame() drains all scopes that were recorded since the previous frame and appends them
+  /// to the file in a compact binary format. In contrast to Capture() no data is lost when the internal ring buffers wrap around,
+  /// which makes this suitable for recording long sessions such as soak tests.
+  /// Use ConvertStreamToTraceEvents() to turn the recorded file into a trace that chrome://tracing or the Perfetto UI can open.
+  ///
+  /// \note The path must be absolute, the file is written through ezOSFile so that it stays independent of the file system setup.
+  static ezResult StartStreaming(const char* szAbsoluteFilePath);
+
+  /// \brief Writes all pending scopes to the stream file and closes it.
+  static void StopStreaming();
+
+  /// \brief Returns whether StartStreaming() has been called without a matching StopStreaming().
+  static bool IsStreaming();
+
+  /// \brief Converts a file that was recorded with StartStreaming() into JSON in the Chrome trace event format.
+  ///
+  /// A stream that ends with an incomplete record, e.g. because the application crashed, is converted up to the last complete record.
+  static ezResult ConvertStreamToTraceEvents(ezStreamReader& inputStream, ezStreamWriter& outputStream);
+
 private:
   EZ_MAKE_SUBSYSTEM_STARTUP_FRIEND(Foundation, ProfilingSystem);
   friend ezUInt32 RunThread(ezThread* pThread);
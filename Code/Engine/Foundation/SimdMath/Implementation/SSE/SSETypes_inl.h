@@ -8,7 +8,17 @@
 #define EZ_SSE_AVX 0x50
 #define EZ_SSE_AVX2 0x51
 
-#define EZ_SSE_LEVEL EZ_SSE_41
+// The SSE level is derived from the instruction sets that the compiler is allowed to use (see EZ_SIMD_LEVEL in CMake).
+// AVX2 is only selected together with FMA, since MulAdd / MulSub use the fused instructions at that level.
+#if !defined(EZ_SSE_LEVEL)
+#  if defined(__AVX2__) && (defined(__FMA__) || EZ_ENABLED(EZ_COMPILER_MSVC))
+#    define EZ_SSE_LEVEL EZ_SSE_AVX2
+#  elif defined(__AVX__)
+#    define EZ_SSE_LEVEL EZ_SSE_AVX
+#  else
+#    define EZ_SSE_LEVEL EZ_SSE_41
+#  endif
+#endif
 
 #if EZ_SSE_LEVEL >= EZ_SSE_20
 #include <emmintrin.h>
@@ -544,9 +544,13 @@ EZ_ALWAYS_INLINE ezSimdFloat ezSimdVec4f::Dot<4>(const ezSimdVec4f& v) const
 
 EZ_ALWAYS_INLINE ezSimdVec4f ezSimdVec4f::CrossRH(const ezSimdVec4f& v) const
 {
-  __m128 a = _mm_mul_ps(m_v, _mm_shuffle_ps(v.m_v, v.m_v, EZ_TO_SHUFFLE(ezSwizzle::YZXW)));
   __m128 b = _mm_mul_ps(v.m_v, _mm_shuffle_ps(m_v, m_v, EZ_TO_SHUFFLE(ezSwizzle::YZXW)));
+#if EZ_SSE_LEVEL >= EZ_SSE_AVX2
+  __m128 c = _mm_fmsub_ps(m_v, _mm_shuffle_ps(v.m_v, v.m_v, EZ_TO_SHUFFLE(ezSwizzle::YZXW)), b);
+#else
+  __m128 a = _mm_mul_ps(m_v, _mm_shuffle_ps(v.m_v, v.m_v, EZ_TO_SHUFFLE(ezSwizzle::YZXW)));
   __m128 c = _mm_sub_ps(a, b);
+#endif
 
   return _mm_shuffle_ps(c, c, EZ_TO_SHUFFLE(ezSwizzle::YZXW));
 }
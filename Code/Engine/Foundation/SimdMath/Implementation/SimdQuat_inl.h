@@ -120,7 +120,7 @@ EZ_ALWAYS_INLINE ezSimdVec4f ezSimdQuat::operator*(const ezSimdVec4f& v) const
 {
   ezSimdVec4f t = m_v.CrossRH(v);
   t += t;
-  return v + t * m_v.w() + m_v.CrossRH(t);
+  return ezSimdVec4f::MulAdd(t, m_v.w(), v) + m_v.CrossRH(t);
 }
 
 EZ_ALWAYS_INLINE ezSimdQuat ezSimdQuat::operator*(const ezSimdQuat& q2) const
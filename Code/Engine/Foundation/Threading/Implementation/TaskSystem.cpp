@@ -53,4 +53,15 @@ void ezTaskSystem::SetTargetFrameTime(ezTime targetFrameTime)
   s_State->m_TargetFrameTime = targetFrameTime;
 }
 
+void ezTaskSystem::SetWorkStealingEnabled(bool bEnable)
+{
+  EZ_LOCK(s_TaskSystemMutex);
+  s_State->m_bWorkStealing = bEnable;
+}
+
+bool ezTaskSystem::IsWorkStealingEnabled()
+{
+  return s_State->m_bWorkStealing;
+}
+
 EZ_STATICLINK_FILE(Foundation, Foundation_Threading_Implementation_TaskSystem);
@@ -146,8 +146,19 @@ void ezTaskSystem::ScheduleGroupTasks(ezTaskGroup* pGroup, bool bHighPriority)
 
   ezInt32 iRemainingTasks = 0;
 
+  // worker threads put the tasks that they schedule themselves into their local queue, from where other threads can steal them
+  ezWorkerThreadType::Enum queueWorkerType;
+  const ezInt32 iQueue = GetLocalQueueIndex(pGroup->m_Priority, queueWorkerType);
+  ezTaskWorkerThread* pLocalWorker = nullptr;
+
+  if (s_State->m_bWorkStealing && iQueue >= 0 && tl_TaskWorkerInfo.m_WorkerType == queueWorkerType)
+  {
+    pLocalWorker = tl_TaskWorkerInfo.m_pWorkerThread;
+  }
+
   // add all the tasks to the task list, so that they will be processed
   {
+    // the lock is still needed for the local queues, CancelTask() relies on m_bTaskIsScheduled being in sync with the group's task list
     EZ_LOCK(s_TaskSystemMutex);
 
 
@@ -174,10 +185,16 @@ void ezTaskSystem::ScheduleGroupTasks(ezTaskGroup* pGroup, bool bHighPriority)
         td.m_pTask->m_bTaskIsScheduled = true;
         td.m_uiInvocation = mult;
 
+        // the local queue is LIFO for its owner, so there is no need to distinguish high priority tasks
+        if (pLocalWorker != nullptr && pLocalWorker->m_LocalQueues[iQueue].PushBottom(td, pTask->m_NestingMode == ezTaskNesting::Never))
+          continue;
+
         if (bHighPriority)
           s_State->m_Tasks[pGroup->m_Priority].PushFront(td);
         else
           s_State->m_Tasks[pGroup->m_Priority].PushBack(td);
+
+        s_State->m_iNumGlobalTasks[pGroup->m_Priority].Increment();
       }
     }
 
@@ -31,4 +31,11 @@ private:
 
   // The lists of all scheduled tasks, for each priority.
   ezList<ezTaskSystem::TaskData> m_Tasks[ezTaskPriority::ENUM_COUNT];
+
+  // The number of tasks in each of m_Tasks. Only modified while holding the task system mutex,
+  // but read without it, so that threads only need to take the lock when there is actually something to get.
+  ezAtomicInteger32 m_iNumGlobalTasks[ezTaskPriority::ENUM_COUNT];
+
+  // Whether worker threads put the tasks that they schedule themselves into their local work-stealing queues.
+  bool m_bWorkStealing = true;
 };
@@ -69,35 +69,140 @@ void ezTaskSystem::TaskHasFinished(ezTask* pTask, ezTaskGroup* pGroup)
   }
 }
 
-ezTaskSystem::TaskData ezTaskSystem::GetNextTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, ezAtomicInteger32* pWorkerState)
+ezInt32 ezTaskSystem::GetLocalQueueIndex(ezTaskPriority::Enum Priority, ezWorkerThreadType::Enum& out_WorkerType)
 {
-  // this is the central function that selects tasks for the worker threads to work on
-
-  EZ_ASSERT_DEV(FirstPriority >= ezTaskPriority::EarlyThisFrame && LastPriority < ezTaskPriority::ENUM_COUNT, "Priority Range is invalid: {0} to {1}", FirstPriority, LastPriority);
+  // only priorities that are exclusively executed by worker threads (and helping threads) use local queues
+  // 'next frame' tasks need to be re-prioritized at the end of the frame, which is only possible in the global lists
+  // 'this frame' tasks in local queues keep their priority when the frame ends, but FinishFrameTasks() helps to execute them anyway
+  switch (Priority)
+  {
+    case ezTaskPriority::EarlyThisFrame:
+    case ezTaskPriority::ThisFrame:
+    case ezTaskPriority::LateThisFrame:
+      out_WorkerType = ezWorkerThreadType::ShortTasks;
+      return Priority - ezTaskPriority::EarlyThisFrame;
+
+    case ezTaskPriority::LongRunningHighPriority:
+    case ezTaskPriority::LongRunning:
+      out_WorkerType = ezWorkerThreadType::LongTasks;
+      return Priority - ezTaskPriority::LongRunningHighPriority;
+
+    default:
+      out_WorkerType = ezWorkerThreadType::Unknown;
+      return -1;
+  }
+}
 
-  EZ_LOCK(s_TaskSystemMutex);
+bool ezTaskSystem::TryGetNextTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, TaskData& out_Task)
+{
+  ezTaskWorkerThread* pThisWorker = tl_TaskWorkerInfo.m_pWorkerThread;
 
   // go through all the task lists that this thread is willing to work on
   for (ezUInt32 prio = FirstPriority; prio <= (ezUInt32)LastPriority; ++prio)
   {
-    for (auto it = s_State->m_Tasks[prio].GetIterator(); it.IsValid(); ++it)
+    ezWorkerThreadType::Enum queueWorkerType;
+    const ezInt32 iQueue = GetLocalQueueIndex((ezTaskPriority::Enum)prio, queueWorkerType);
+
+    // prefer the tasks that this thread scheduled itself, their data is most likely still in the cache
+    if (iQueue >= 0 && pThisWorker != nullptr && tl_TaskWorkerInfo.m_WorkerType == queueWorkerType)
+    {
+      if (pThisWorker->m_LocalQueues[iQueue].TryPopBottom(out_Task, bOnlyTasksThatNeverWait, WaitingForGroup.m_pTaskGroup))
+        return true;
+    }
+
+    // only take the lock, if there is anything in the global list
+    if (s_State->m_iNumGlobalTasks[prio] > 0)
+    {
+      EZ_LOCK(s_TaskSystemMutex);
+
+      for (auto it = s_State->m_Tasks[prio].GetIterator(); it.IsValid(); ++it)
+      {
+        if (!bOnlyTasksThatNeverWait || (it->m_pTask->m_NestingMode == ezTaskNesting::Never) || it->m_pBelongsToGroup == WaitingForGroup.m_pTaskGroup)
+        {
+          out_Task = *it;
+
+          s_State->m_Tasks[prio].Remove(it);
+          s_State->m_iNumGlobalTasks[prio].Decrement();
+          return true;
+        }
+      }
+    }
+
+    // finally try to steal work from the other workers
+    if (iQueue >= 0)
     {
-      if (!bOnlyTasksThatNeverWait || (it->m_pTask->m_NestingMode == ezTaskNesting::Never) || it->m_pBelongsToGroup == WaitingForGroup.m_pTaskGroup)
+      const ezUInt32 uiNumWorkers = s_ThreadState->m_iAllocatedWorkers[queueWorkerType];
+
+      // start with different victims on different threads, to spread the contention
+      const ezUInt32 uiFirstVictim = (ezUInt32)(tl_TaskWorkerInfo.m_iWorkerIndex + 1);
+
+      for (ezUInt32 i = 0; i < uiNumWorkers; ++i)
       {
-        TaskData td = *it;
+        ezTaskWorkerThread* pVictim = s_ThreadState->m_Workers[queueWorkerType][(uiFirstVictim + i) % uiNumWorkers];
+
+        if (pVictim == pThisWorker)
+          continue;
 
-        s_State->m_Tasks[prio].Remove(it);
-        return td;
+        if (pVictim->m_LocalQueues[iQueue].TrySteal(out_Task, bOnlyTasksThatNeverWait, WaitingForGroup.m_pTaskGroup))
+          return true;
       }
     }
   }
 
-  if (pWorkerState)
+  return false;
+}
+
+bool ezTaskSystem::HasQueuedTasks(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority)
+{
+  for (ezUInt32 prio = FirstPriority; prio <= (ezUInt32)LastPriority; ++prio)
   {
-    EZ_VERIFY(pWorkerState->Set((int)ezTaskWorkerState::Idle) == (int)ezTaskWorkerState::Active, "Corrupt Worker State");
+    if (s_State->m_iNumGlobalTasks[prio] > 0)
+      return true;
+
+    ezWorkerThreadType::Enum queueWorkerType;
+    const ezInt32 iQueue = GetLocalQueueIndex((ezTaskPriority::Enum)prio, queueWorkerType);
+
+    if (iQueue < 0)
+      continue;
+
+    const ezUInt32 uiNumWorkers = s_ThreadState->m_iAllocatedWorkers[queueWorkerType];
+
+    for (ezUInt32 i = 0; i < uiNumWorkers; ++i)
+    {
+      if (!s_ThreadState->m_Workers[queueWorkerType][i]->m_LocalQueues[iQueue].IsEmpty())
+        return true;
+    }
   }
 
-  return TaskData();
+  return false;
+}
+
+ezTaskSystem::TaskData ezTaskSystem::GetNextTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, ezAtomicInteger32* pWorkerState)
+{
+  // this is the central function that selects tasks for the worker threads to work on
+
+  EZ_ASSERT_DEV(FirstPriority >= ezTaskPriority::EarlyThisFrame && LastPriority < ezTaskPriority::ENUM_COUNT, "Priority Range is invalid: {0} to {1}", FirstPriority, LastPriority);
+
+  while (true)
+  {
+    TaskData td;
+    if (TryGetNextTask(FirstPriority, LastPriority, bOnlyTasksThatNeverWait, WaitingForGroup, td))
+      return td;
+
+    if (pWorkerState == nullptr)
+      return TaskData();
+
+    EZ_VERIFY(pWorkerState->Set((int)ezTaskWorkerState::Idle) == (int)ezTaskWorkerState::Active, "Corrupt Worker State");
+
+    // tasks may have been scheduled after we looked for them, but before we went idle
+    // in that case nobody may have been woken up, because this thread still counted as active, so check again
+    if (!HasQueuedTasks(FirstPriority, LastPriority))
+      return TaskData();
+
+    // if someone else woke us up in the meantime, the wake-up signal is already raised and the thread won't go to sleep
+    if (!pWorkerState->TestAndSet((int)ezTaskWorkerState::Idle, (int)ezTaskWorkerState::Active))
+      return TaskData();
+  }
 }
 
 bool ezTaskSystem::ExecuteTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, ezAtomicInteger32* pWorkerState)
@@ -163,13 +268,16 @@ ezResult ezTaskSystem::CancelTask(ezTask* pTask, ezOnTaskRunning::Enum OnTaskRun
         {
           if (it->m_pTask == pTask)
           {
+            const TaskData td = *it;
+
             s_State->m_Tasks[i].Remove(it);
+            s_State->m_iNumGlobalTasks[i].Decrement();
 
             // we set the task to finished, even though it was not executed
             pTask->m_iRemainingRuns = 0;
 
             // tell the system that one task of that group is 'finished', to ensure its dependencies will get scheduled
-            TaskHasFinished(it->m_pTask, it->m_pBelongsToGroup);
+            TaskHasFinished(td.m_pTask, td.m_pBelongsToGroup);
             return EZ_SUCCESS;
           }
 
@@ -179,7 +287,7 @@ ezResult ezTaskSystem::CancelTask(ezTask* pTask, ezOnTaskRunning::Enum OnTaskRun
     }
   }
 
-  // if we made it here, the task was already running
+  // if we made it here, the task was already running or it sits in a worker local queue, from which it cannot be removed
   // thus we just wait for it to finish
 
   if (OnTaskRunning == ezOnTaskRunning::WaitTillFinished)
@@ -255,6 +363,11 @@ void ezTaskSystem::ReprioritizeFrameTasks()
     // remove the tasks from their current queue
     s_State->m_Tasks[i].Clear();
   }
+
+  for (ezUInt32 i = 0; i < ezTaskPriority::ENUM_COUNT; ++i)
+  {
+    s_State->m_iNumGlobalTasks[i] = (ezInt32)s_State->m_Tasks[i].GetCount();
+  }
 }
 
 void ezTaskSystem::ExecuteSomeFrameTasks(ezUInt32 uiSomeFrameTasks, ezTime smoothFrameTime)
@@ -93,6 +93,45 @@ void ezTaskSystem::StopWorkerThreads()
     for (ezUInt32 i = 0; i < uiNumWorkers; ++i)
     {
       s_ThreadState->m_Workers[type][i]->Join();
+    }
+  }
+
+  {
+    EZ_LOCK(s_TaskSystemMutex);
+
+    // tasks that are still in the local queues of the workers must not get lost, so move them into the global lists
+    for (ezUInt32 type = 0; type < ezWorkerThreadType::ENUM_COUNT; ++type)
+    {
+      const ezUInt32 uiNumWorkers = s_ThreadState->m_iAllocatedWorkers[type];
+
+      for (ezUInt32 i = 0; i < uiNumWorkers; ++i)
+      {
+        for (ezUInt32 prio = 0; prio < ezTaskPriority::ENUM_COUNT; ++prio)
+        {
+          ezWorkerThreadType::Enum queueWorkerType;
+          const ezInt32 iQueue = GetLocalQueueIndex((ezTaskPriority::Enum)prio, queueWorkerType);
+
+          if (iQueue < 0 || queueWorkerType != type)
+            continue;
+
+          TaskData td;
+          while (s_ThreadState->m_Workers[type][i]->m_LocalQueues[iQueue].TryPopBottom(td, false, nullptr))
+          {
+            // popping returns the newest task first
+            s_State->m_Tasks[prio].PushFront(td);
+            s_State->m_iNumGlobalTasks[prio].Increment();
+          }
+        }
+      }
+    }
+  }
+
+  for (ezUInt32 type = 0; type < ezWorkerThreadType::ENUM_COUNT; ++type)
+  {
+    const ezUInt32 uiNumWorkers = s_ThreadState->m_iAllocatedWorkers[type];
+
+    for (ezUInt32 i = 0; i < uiNumWorkers; ++i)
+    {
       EZ_DEFAULT_DELETE(s_ThreadState->m_Workers[type][i]);
     }
 
@@ -0,0 +1,104 @@
+#include <FoundationPCH.h>
+
+#include <Foundation/Threading/Implementation/TaskWorkStealingQueue.h>
+
+// The implementation follows "Dynamic Circular Work-Stealing Deque" (Chase, Lev 2005), with a fixed capacity instead of a growable buffer.
+// All index accesses go through ezAtomicUtils, which act as full memory barriers, so no additional fences are required.
+
+EZ_CHECK_AT_COMPILETIME_MSG((ezTaskWorkStealingQueue::Capacity & (ezTaskWorkStealingQueue::Capacity - 1)) == 0, "Capacity must be a power of two");
+
+ezTaskWorkStealingQueue::ezTaskWorkStealingQueue() = default;
+ezTaskWorkStealingQueue::~ezTaskWorkStealingQueue() = default;
+
+bool ezTaskWorkStealingQueue::IsSuitable(const Entry& entry, bool bOnlyTasksThatNeverWait, const ezTaskGroup* pWaitingForGroup)
+{
+  return !bOnlyTasksThatNeverWait || entry.m_bNeverWaits || entry.m_Task.m_pBelongsToGroup == pWaitingForGroup;
+}
+
+bool ezTaskWorkStealingQueue::PushBottom(const ezTaskSystem::TaskData& td, bool bNeverWaits)
+{
+  const ezInt64 b = m_iBottom;
+  const ezInt64 t = m_iTop;
+
+  // top can only grow concurrently, so this check is conservative
+  if (b - t >= (ezInt64)Capacity)
+    return false;
+
+  Entry& entry = m_Entries[b & (Capacity - 1)];
+  entry.m_Task = td;
+  entry.m_bNeverWaits = bNeverWaits;
+
+  // publish the entry
+  m_iBottom.Set(b + 1);
+  return true;
+}
+
+bool ezTaskWorkStealingQueue::TryPopBottom(ezTaskSystem::TaskData& out_Task, bool bOnlyTasksThatNeverWait, const ezTaskGroup* pWaitingForGroup)
+{
+  ezInt64 b = m_iBottom;
+
+  {
+    const ezInt64 t = m_iTop;
+    if (t >= b)
+      return false;
+
+    // only the owner writes entries, so peeking at the bottom one is safe
+    if (!IsSuitable(m_Entries[(b - 1) & (Capacity - 1)], bOnlyTasksThatNeverWait, pWaitingForGroup))
+      return false;
+  }
+
+  b = b - 1;
+  m_iBottom.Set(b);
+
+  // reading top is a full barrier, thieves that have not yet incremented top will now see the reduced bottom
+  const ezInt64 t = m_iTop;
+
+  if (t > b)
+  {
+    // a thief took the last task in the meantime
+    m_iBottom.Set(b + 1);
+    return false;
+  }
+
+  out_Task = m_Entries[b & (Capacity - 1)].m_Task;
+
+  if (t == b)
+  {
+    // this was the last task, race with the thieves for it
+    const bool bWon = m_iTop.TestAndSet(t, t + 1);
+    m_iBottom.Set(b + 1);
+    return bWon;
+  }
+
+  return true;
+}
+
+bool ezTaskWorkStealingQueue::TrySteal(ezTaskSystem::TaskData& out_Task, bool bOnlyTasksThatNeverWait, const ezTaskGroup* pWaitingForGroup)
+{
+  const ezInt64 t = m_iTop;
+  const ezInt64 b = m_iBottom;
+
+  if (t >= b)
+    return false;
+
+  // the entry may get overwritten by the owner once another thief took it, in that case the TestAndSet below fails and the copy is discarded
+  const Entry entry = m_Entries[t & (Capacity - 1)];
+
+  if (!IsSuitable(entry, bOnlyTasksThatNeverWait, pWaitingForGroup))
+    return false;
+
+  if (!m_iTop.TestAndSet(t, t + 1))
+    return false;
+
+  out_Task = entry.m_Task;
+  return true;
+}
+
+ezUInt32 ezTaskWorkStealingQueue::GetCount() const
+{
+  const ezInt64 t = m_iTop;
+  const ezInt64 b = m_iBottom;
+  return (ezUInt32)ezMath::Max<ezInt64>(b - t, 0);
+}
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Threading_Implementation_TaskWorkStealingQueue);
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <Foundation/Threading/AtomicInteger.h>
+#include <Foundation/Threading/TaskSystem.h>
+
+/// \internal A fixed-size Chase-Lev work-stealing deque that holds the tasks that a worker thread scheduled itself.
+///
+/// Only the owning worker thread may call PushBottom() and TryPopBottom(), which work on the 'bottom' end of the deque in LIFO order.
+/// Any other thread may call TrySteal(), which takes tasks from the 'top' end in FIFO order.
+/// Neither operation takes a lock, threads only synchronize through atomic operations on the top and bottom indices.
+///
+/// The capacity is fixed. If the deque is full, PushBottom() fails and the caller has to put the task into the global (locked) task lists instead.
+class ezTaskWorkStealingQueue
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezTaskWorkStealingQueue);
+
+public:
+  /// \brief The number of tasks that fit into a single deque. Must be a power of two.
+  static constexpr ezUInt32 Capacity = 1024;
+
+  ezTaskWorkStealingQueue();
+  ~ezTaskWorkStealingQueue();
+
+  /// \brief Adds a task at the bottom end. Returns false, if the deque is full. May only be called by the owning thread.
+  ///
+  /// \a bNeverWaits has to state whether the task uses ezTaskNesting::Never.
+  bool PushBottom(const ezTaskSystem::TaskData& td, bool bNeverWaits);
+
+  /// \brief Removes the most recently pushed task. May only be called by the owning thread.
+  ///
+  /// If \a bOnlyTasksThatNeverWait is true, the task is only taken, if it never waits on other tasks or if it belongs to \a pWaitingForGroup.
+  /// Otherwise the deque is left unmodified and false is returned.
+  bool TryPopBottom(ezTaskSystem::TaskData& out_Task, bool bOnlyTasksThatNeverWait, const ezTaskGroup* pWaitingForGroup);
+
+  /// \brief Removes the oldest task. May be called by any thread.
+  ///
+  /// Returns false if the deque is empty, the top task is not suitable (see TryPopBottom()) or another thread took the task first.
+  bool TrySteal(ezTaskSystem::TaskData& out_Task, bool bOnlyTasksThatNeverWait, const ezTaskGroup* pWaitingForGroup);
+
+  /// \brief Returns the number of tasks in the deque. The value is only a snapshot and may be outdated immediately.
+  ezUInt32 GetCount() const;
+
+  /// \brief Returns whether the deque is currently empty. The value is only a snapshot and may be outdated immediately.
+  bool IsEmpty() const { return GetCount() == 0; }
+
+private:
+  struct Entry
+  {
+    ezTaskSystem::TaskData m_Task;
+
+    // copied from the task when pushing, such that thieves never need to dereference a task before they own it
+    bool m_bNeverWaits = false;
+  };
+
+  static bool IsSuitable(const Entry& entry, bool bOnlyTasksThatNeverWait, const ezTaskGroup* pWaitingForGroup);
+
+  // only modified by thieves (and the owner when it takes the very last task)
+  ezAtomicInteger64 m_iTop;
+
+  // only modified by the owner
+  ezAtomicInteger64 m_iBottom;
+
+  Entry m_Entries[Capacity];
+};
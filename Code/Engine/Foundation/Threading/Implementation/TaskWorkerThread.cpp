@@ -47,6 +47,7 @@ ezUInt32 ezTaskWorkerThread::Run()
   tl_TaskWorkerInfo.m_WorkerType = m_WorkerType;
   tl_TaskWorkerInfo.m_iWorkerIndex = m_uiWorkerThreadNumber;
   tl_TaskWorkerInfo.m_pWorkerState = &m_WorkerState;
+  tl_TaskWorkerInfo.m_pWorkerThread = this;
 
   const bool bIsReserve = m_uiWorkerThreadNumber >= ezTaskSystem::s_ThreadState->m_uiMaxWorkersToUse[m_WorkerType];
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Foundation/Threading/Implementation/TaskSystemDeclarations.h>
+#include <Foundation/Threading/Implementation/TaskWorkStealingQueue.h>
 
 #include <Foundation/Threading/Thread.h>
 #include <Foundation/Threading/ThreadSignal.h>
@@ -77,6 +78,21 @@ private:
   ezAtomicInteger32 m_WorkerState; // ezTaskWorkerState
 
   ///@}
+
+  /// \name Local Task Queues
+  ///@{
+
+public:
+  /// \brief The maximum number of task priorities that use worker local queues, see ezTaskSystem::GetLocalQueueIndex().
+  static constexpr ezUInt32 MaxLocalQueues = 3;
+
+private:
+  friend class ezTaskSystem;
+
+  // Tasks that this thread scheduled itself. Only this thread pushes into and pops from the bottom, all other threads may steal from the top.
+  ezTaskWorkStealingQueue m_LocalQueues[MaxLocalQueues];
+
+  ///@}
 };
 
 /// \internal Thread local state used by the task system (and for better debugging)
@@ -87,6 +103,7 @@ struct ezTaskWorkerInfo
   bool m_bAllowNestedTasks = true;
   const char* m_szTaskName = nullptr;
   ezAtomicInteger32* m_pWorkerState = nullptr;
+  ezTaskWorkerThread* m_pWorkerThread = nullptr;
 };
 
 extern thread_local ezTaskWorkerInfo tl_TaskWorkerInfo;
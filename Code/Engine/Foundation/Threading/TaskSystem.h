@@ -82,6 +82,17 @@ private:
   /// \brief Searches for a task of priority between \a FirstPriority and \a LastPriority (inclusive).
   static TaskData GetNextTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, ezAtomicInteger32* pWorkerState);
 
+  /// \brief Takes a task from the worker local queue, the global task lists or other worker's queues, in that order, for each priority. Does not change the worker state.
+  static bool TryGetNextTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, TaskData& out_Task);
+
+  /// \brief Returns whether any task of priority between \a FirstPriority and \a LastPriority (inclusive) is queued anywhere. The result is only a snapshot.
+  static bool HasQueuedTasks(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority);
+
+  /// \brief Returns the index of the worker local queue that tasks with the given priority use, or -1 if they are always put into the global task lists.
+  ///
+  /// \a out_WorkerType is set to the type of worker thread that owns such queues.
+  static ezInt32 GetLocalQueueIndex(ezTaskPriority::Enum Priority, ezWorkerThreadType::Enum& out_WorkerType);
+
   /// \brief Executes some task of priority between \a FirstPriority and \a LastPriority (inclusive). Returns true, if any such task was available.
   static bool ExecuteTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, ezAtomicInteger32* pWorkerState);
 
@@ -284,6 +295,19 @@ public:
   /// \see FinishFrameTasks() for more details.
   static void SetTargetFrameTime(ezTime targetFrameTime = ezTime::Seconds(1.0 / 40.0) /* 40 FPS -> 25 ms */);
 
+  /// \brief Enables or disables the worker local task queues (enabled by default).
+  ///
+  /// When enabled, tasks that a worker thread schedules itself (e.g. through ParallelFor() or when finishing a task group that others depend on)
+  /// are put into a lock-free queue owned by that worker. Idle threads steal from these queues, such that the work is still distributed.
+  /// This only applies to 'this frame' and 'long running' priorities, all other tasks always go through the global task lists.
+  /// When disabled, all tasks are put into the global task lists, which are protected by a single mutex.
+  ///
+  /// Tasks that are already in a local queue cannot be removed through CancelTask() anymore, they are treated as if they were already running.
+  static void SetWorkStealingEnabled(bool bEnable);
+
+  /// \brief Returns whether worker local task queues are used. See SetWorkStealingEnabled().
+  static bool IsWorkStealingEnabled();
+
 private:
   EZ_MAKE_SUBSYSTEM_STARTUP_FRIEND(Foundation, TaskSystem);
 
@@ -3,9 +3,11 @@
 #include <Core/ResourceManager/Resource.h>
 #include <Foundation/Containers/ArrayMap.h>
 #include <Foundation/Strings/HashedString.h>
+#include <RendererCore/AnimationSystem/CompressedAnimationClip.h>
 #include <RendererCore/RendererCoreDLL.h>
 
 class ezAnimationPose;
+class ezLocalSpaceAnimationPose;
 class ezSkeleton;
 
 struct EZ_RENDERERCORE_DLL ezAnimationClipResourceDescriptor
@@ -25,9 +27,19 @@ public:
   /// \brief returns ezInvalidJointIndex if no joint with the given name is known
   ezUInt16 FindJointIndexByName(const ezTempHashedString& sJointName) const;
 
-  ezArrayPtr<const ezTransform> GetJointKeyframes(ezUInt16 uiJoint) const;
+  /// \brief Returns the keyframes of a single joint for editing. Only available as long as the keyframes are not compressed.
   ezArrayPtr<ezTransform> GetJointKeyframes(ezUInt16 uiJoint);
 
+  /// \brief Returns a single keyframe of a single joint, regardless of whether the keyframes are compressed.
+  ezTransform GetJointKeyframe(ezUInt16 uiJoint, ezUInt16 uiKeyframe) const;
+
+  /// \brief Converts the keyframes into the compact format that is used at runtime and frees the uncompressed keyframes.
+  ///
+  /// This is done automatically when a clip is loaded. Afterwards GetJointKeyframes() can't be used anymore.
+  void CompressKeyframes();
+
+  bool IsCompressed() const { return !m_CompressedKeyframes.IsEmpty(); }
+
   void Save(ezStreamWriter& stream) const;
   void Load(ezStreamReader& stream);
 
@@ -42,6 +54,11 @@ public:
   void SetPoseToKeyframe(ezAnimationPose& pose, const ezSkeleton& skeleton, ezUInt16 uiKeyframe) const;
   void SetPoseToBlendedKeyframe(ezAnimationPose& pose, const ezSkeleton& skeleton, ezUInt16 uiKeyframe0, float fBlendToKeyframe1) const;
 
+  /// \brief Samples all joints in \a jointMapping between \a uiKeyframe0 and the following keyframe and writes the local space transforms into \a out_Pose.
+  ///
+  /// Unlike SetPoseToBlendedKeyframe() this doesn't look up joints by name, so the mapping should be created once and reused.
+  void SamplePose(const ezJointMapping& jointMapping, ezUInt16 uiKeyframe0, float fBlendToKeyframe1, ezLocalSpaceAnimationPose& out_Pose) const;
+
 private:
   ezUInt16 m_uiNumJoints = 0;
   ezUInt16 m_uiNumFrames = 0;
@@ -50,6 +67,7 @@ private:
   ezTime m_Duration;
 
   ezDynamicArray<ezTransform> m_JointTransforms;
+  ezCompressedAnimationClip m_CompressedKeyframes;
   ezArrayMap<ezHashedString, ezUInt16> m_JointNameToIndex;
 };
 
@@ -174,14 +174,12 @@ ezTransform ezAnimationClipSampler::ComputeRootMotion(const ezAnimationClipResou
   double fAnimLerpLast = 0;
   const ezUInt32 uiLastFrame = animDesc.GetFrameAt(tNow, fAnimLerpLast);
 
-  ezArrayPtr<const ezTransform> pKeyframes = animDesc.GetJointKeyframes(uiRootMotionJoint);
-
   ezTransform res;
   res.SetIdentity();
 
   if (uiFirstFrame == uiLastFrame)
   {
-    const ezTransform rm = pKeyframes[uiFirstFrame];
+    const ezTransform rm = animDesc.GetJointKeyframe(uiRootMotionJoint, uiFirstFrame);
 
     const float fFraction = (float)(fAnimLerpLast - fAnimLerpFirst);
 
@@ -191,7 +189,7 @@ ezTransform ezAnimationClipSampler::ComputeRootMotion(const ezAnimationClipResou
   else
   {
     {
-      const ezTransform rm = pKeyframes[uiFirstFrame];
+      const ezTransform rm = animDesc.GetJointKeyframe(uiRootMotionJoint, uiFirstFrame);
 
       const float fFraction = (float)(1.0 - fAnimLerpFirst);
 
@@ -201,7 +199,7 @@ ezTransform ezAnimationClipSampler::ComputeRootMotion(const ezAnimationClipResou
 
     for (ezUInt32 i = uiFirstFrame + 1; i < uiLastFrame; ++i)
     {
-      const ezTransform rm = pKeyframes[i];
+      const ezTransform rm = animDesc.GetJointKeyframe(uiRootMotionJoint, i);
 
       res.m_vPosition += rm.m_vPosition;
       // rotation
@@ -209,7 +207,7 @@ ezTransform ezAnimationClipSampler::ComputeRootMotion(const ezAnimationClipResou
 
 
     {
-      const ezTransform rm = pKeyframes[uiLastFrame];
+      const ezTransform rm = animDesc.GetJointKeyframe(uiRootMotionJoint, uiLastFrame);
 
       const float fFraction = (float)fAnimLerpLast;
 
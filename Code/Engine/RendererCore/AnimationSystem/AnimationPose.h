@@ -5,6 +5,7 @@
 #include <Foundation/Containers/Bitfield.h>
 #include <Foundation/Containers/DynamicArray.h>
 #include <Foundation/Math/Transform.h>
+#include <Foundation/SimdMath/SimdTransform.h>
 
 class ezSkeleton;
 class ezDebugRendererContext;
@@ -80,6 +81,8 @@ public:
   void VisualizePose(const ezDebugRendererContext& context, const ezSkeleton& skeleton, const ezTransform& objectTransform, float fJointSizeRatio = 1.0f / 6.0f, ezUInt16 uiStartJoint = ezInvalidJointIndex) const;
 
 private:
+  friend class ezLocalSpaceAnimationPose;
+
   // TODO: would be nicer to use ezTransform or ezShaderTransform for this data
 
   // use an aligned allocator to make sure this can be uploaded to the GPU
@@ -87,3 +90,40 @@ private:
   ezDynamicBitfield m_TransformsValid;
 };
 
+
+/// \brief Stores the local space transforms of all joints of a skeleton, with positions, rotations and scales in separate arrays.
+///
+/// This is the format that ezCompressedAnimationClip samples into. Blending or modifying local transforms is cheaper in this form than on matrices,
+/// and ConvertToObjectSpace() computes all object space matrices in a single pass with SIMD math.
+class EZ_RENDERERCORE_DLL ezLocalSpaceAnimationPose
+{
+public:
+  ezLocalSpaceAnimationPose();
+  ~ezLocalSpaceAnimationPose();
+
+  /// \brief Allocates storage for all joints of the skeleton and sets them to the local bind pose.
+  void Configure(const ezSkeleton& skeleton);
+
+  /// \brief Sets all transforms to the local bind pose of the skeleton.
+  void SetToBindPose(const ezSkeleton& skeleton);
+
+  /// \brief Returns the number of transforms in the pose.
+  ezUInt16 GetTransformCount() const { return static_cast<ezUInt16>(m_Positions.GetCount()); }
+
+  ezSimdTransform GetTransform(ezUInt16 uiIndex) const { return ezSimdTransform(m_Positions[uiIndex], m_Rotations[uiIndex], m_Scales[uiIndex]); }
+
+  void SetTransform(ezUInt16 uiIndex, const ezSimdTransform& transform);
+
+  /// \brief Concatenates the parent transforms of all joints and writes the resulting object space matrices into \a out_Pose.
+  ///
+  /// This gives the same result as writing the local transforms into \a out_Pose and calling ezAnimationPose::ConvertFromLocalSpaceToObjectSpace(),
+  /// but without the intermediate matrices. All transforms of \a out_Pose are marked as valid.
+  void ConvertToObjectSpace(const ezSkeleton& skeleton, ezAnimationPose& out_Pose) const;
+
+private:
+  friend class ezCompressedAnimationClip;
+
+  ezDynamicArray<ezSimdVec4f, ezAlignedAllocatorWrapper> m_Positions;
+  ezDynamicArray<ezSimdQuat, ezAlignedAllocatorWrapper> m_Rotations;
+  ezDynamicArray<ezSimdVec4f, ezAlignedAllocatorWrapper> m_Scales;
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <RendererCore/AnimationSystem/Declarations.h>
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Math/Transform.h>
+#include <Foundation/SimdMath/SimdTransform.h>
+#include <RendererCore/AnimationSystem/JointMapping.h>
+
+class ezStreamWriter;
+class ezStreamReader;
+class ezLocalSpaceAnimationPose;
+
+/// \brief Stores the keyframes of all joints of an animation clip in a quantized format.
+///
+/// Rotations are stored with the 'smallest three' encoding in 48 bits, positions and scales with 16 bits per component,
+/// relative to the range that the joint covers over the whole clip. Channels that don't change over the whole clip are only stored once.
+/// All animated channels of one keyframe are stored next to each other, so sampling a pose only touches two small, contiguous blocks of memory.
+///
+/// Typically this needs less than a fourth of the memory of the uncompressed ezTransform keyframes.
+/// The maximum rotation error is around 0.01 degrees, the maximum position and scale error is 1/65535th of the range of the joint.
+class EZ_RENDERERCORE_DLL ezCompressedAnimationClip
+{
+public:
+  /// \brief Compresses the given keyframes. \a jointTransforms contains uiNumFrames transforms for every joint, one joint after the other.
+  void Compress(ezUInt16 uiNumJoints, ezUInt16 uiNumFrames, ezArrayPtr<const ezTransform> jointTransforms);
+
+  /// \brief Removes all data.
+  void Clear();
+
+  bool IsEmpty() const { return m_Joints.IsEmpty(); }
+
+  ezUInt16 GetNumJoints() const { return static_cast<ezUInt16>(m_Joints.GetCount()); }
+  ezUInt16 GetNumFrames() const { return m_uiNumFrames; }
+
+  /// \brief Decompresses a single keyframe of a single joint.
+  ezTransform GetKeyframe(ezUInt16 uiJoint, ezUInt16 uiFrame) const;
+
+  /// \brief Returns the transform of the joint interpolated between keyframe \a uiFrame0 and the following keyframe.
+  ///
+  /// Rotations are interpolated with a normalized lerp, which is very close to a slerp for the small angles between two keyframes.
+  ezSimdTransform SampleJoint(ezUInt16 uiJoint, ezUInt16 uiFrame0, float fLerp) const;
+
+  /// \brief Samples all mapped joints between keyframe \a uiFrame0 and the following keyframe and writes the local space transforms into \a out_Pose.
+  void SampleLocalPose(ezUInt16 uiFrame0, float fLerp, ezArrayPtr<const ezJointMapping::Mapping> jointMapping, ezLocalSpaceAnimationPose& out_Pose) const;
+
+  void Save(ezStreamWriter& stream) const;
+  void Load(ezStreamReader& stream);
+
+  ezUInt64 GetHeapMemoryUsage() const;
+
+private:
+  struct JointInfo
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    /// \brief Only used when the rotation is constant.
+    ezQuat m_qConstantRotation;
+
+    /// \brief A position component is decoded as min + step * value. A constant position is stored in min.
+    ezVec3 m_vPositionMin;
+    ezVec3 m_vPositionStep;
+    ezVec3 m_vScaleMin;
+    ezVec3 m_vScaleStep;
+
+    /// \brief Offsets of the animated channels inside one frame in ezUInt16 units, ezInvalidIndex for constant channels.
+    ezUInt32 m_uiRotationOffset;
+    ezUInt32 m_uiPositionOffset;
+    ezUInt32 m_uiScaleOffset;
+  };
+
+  static void EncodeRotation(const ezQuat& qRotation, ezUInt16* pFrameData);
+  static ezSimdQuat DecodeRotation(const JointInfo& joint, const ezUInt16* pFrameData);
+  static ezSimdVec4f DecodeVector(ezUInt32 uiOffset, const ezVec3& vMin, const ezVec3& vStep, const ezUInt16* pFrameData);
+  static ezSimdTransform SampleJoint(const JointInfo& joint, const ezUInt16* pFrame0, const ezUInt16* pFrame1, const ezSimdFloat& fLerp);
+
+  ezUInt16 m_uiNumFrames = 0;
+  ezUInt32 m_uiFrameStride = 0;
+  ezDynamicArray<JointInfo> m_Joints;
+  ezDynamicArray<ezUInt16> m_FrameData;
+};
@@ -1,6 +1,7 @@
 #include <RendererCorePCH.h>
 
 #include <Core/Assets/AssetFileHeader.h>
+#include <Foundation/SimdMath/SimdConversion.h>
 #include <RendererCore/AnimationSystem/AnimationClipResource.h>
 #include <RendererCore/AnimationSystem/Skeleton.h>
 #include <RendererCore/AnimationSystem/AnimationPose.h>
@@ -12,6 +13,18 @@ EZ_END_DYNAMIC_REFLECTED_TYPE;
 EZ_RESOURCE_IMPLEMENT_COMMON_CODE(ezAnimationClipResource);
 // clang-format on
 
+namespace
+{
+  ezTransform BlendKeyframes(const ezTransform& keyframe0, const ezTransform& keyframe1, float fBlendToKeyframe1)
+  {
+    ezTransform res;
+    res.m_vPosition = ezMath::Lerp(keyframe0.m_vPosition, keyframe1.m_vPosition, fBlendToKeyframe1);
+    res.m_qRotation.SetSlerp(keyframe0.m_qRotation, keyframe1.m_qRotation, fBlendToKeyframe1);
+    res.m_vScale = ezMath::Lerp(keyframe0.m_vScale, keyframe1.m_vScale, fBlendToKeyframe1);
+    return res;
+  }
+} // namespace
+
 ezAnimationClipResource::ezAnimationClipResource()
     : ezResource(DoUpdate::OnAnyThread, 1)
 {
@@ -98,6 +111,7 @@ void ezAnimationClipResourceDescriptor::Configure(ezUInt16 uiNumJoints, ezUInt16
     AddJointName(name);
   }
 
+  m_CompressedKeyframes.Clear();
   m_JointTransforms.SetCount(uiNumTransforms);
 }
 
@@ -135,26 +149,55 @@ ezUInt16 ezAnimationClipResourceDescriptor::FindJointIndexByName(const ezTempHas
   return m_JointNameToIndex.GetValue(uiIndex);
 }
 
-ezArrayPtr<const ezTransform> ezAnimationClipResourceDescriptor::GetJointKeyframes(ezUInt16 uiJoint) const
+ezArrayPtr<ezTransform> ezAnimationClipResourceDescriptor::GetJointKeyframes(ezUInt16 uiJoint)
 {
-  return ezArrayPtr<const ezTransform>(&m_JointTransforms[uiJoint * m_uiNumFrames], m_uiNumFrames);
+  EZ_ASSERT_DEV(!IsCompressed(), "The keyframes of a compressed animation clip can't be edited");
+
+  return ezArrayPtr<ezTransform>(&m_JointTransforms[uiJoint * m_uiNumFrames], m_uiNumFrames);
 }
 
-ezArrayPtr<ezTransform> ezAnimationClipResourceDescriptor::GetJointKeyframes(ezUInt16 uiJoint)
+ezTransform ezAnimationClipResourceDescriptor::GetJointKeyframe(ezUInt16 uiJoint, ezUInt16 uiKeyframe) const
 {
-  return ezArrayPtr<ezTransform>(&m_JointTransforms[uiJoint * m_uiNumFrames], m_uiNumFrames);
+  if (IsCompressed())
+  {
+    return m_CompressedKeyframes.GetKeyframe(uiJoint, uiKeyframe);
+  }
+
+  return m_JointTransforms[uiJoint * m_uiNumFrames + uiKeyframe];
+}
+
+void ezAnimationClipResourceDescriptor::CompressKeyframes()
+{
+  if (m_JointTransforms.IsEmpty())
+    return;
+
+  const ezUInt16 uiNumKeyframeJoints = static_cast<ezUInt16>(m_JointTransforms.GetCount() / m_uiNumFrames);
+  m_CompressedKeyframes.Compress(uiNumKeyframeJoints, m_uiNumFrames, m_JointTransforms);
+
+  m_JointTransforms.Clear();
+  m_JointTransforms.Compact();
 }
 
 void ezAnimationClipResourceDescriptor::Save(ezStreamWriter& stream) const
 {
-  const ezUInt8 uiVersion = 2;
+  const ezUInt8 uiVersion = 3;
   stream << uiVersion;
 
   stream << m_uiNumJoints;
   stream << m_uiNumFrames;
   stream << m_uiFramesPerSecond;
 
-  stream.WriteArray(m_JointTransforms);
+  // version 3: keyframes are always stored compressed
+  if (IsCompressed() || m_JointTransforms.IsEmpty())
+  {
+    m_CompressedKeyframes.Save(stream);
+  }
+  else
+  {
+    ezCompressedAnimationClip compressedKeyframes;
+    compressedKeyframes.Compress(static_cast<ezUInt16>(m_JointTransforms.GetCount() / m_uiNumFrames), m_uiNumFrames, m_JointTransforms);
+    compressedKeyframes.Save(stream);
+  }
 
   // version 2
   {
@@ -178,7 +221,16 @@ void ezAnimationClipResourceDescriptor::Load(ezStreamReader& stream)
   stream >> m_uiNumFrames;
   stream >> m_uiFramesPerSecond;
 
-  stream.ReadArray(m_JointTransforms);
+  if (uiVersion >= 3)
+  {
+    m_JointTransforms.Clear();
+    m_CompressedKeyframes.Load(stream);
+  }
+  else
+  {
+    m_CompressedKeyframes.Clear();
+    stream.ReadArray(m_JointTransforms);
+  }
 
   m_Duration = ezTime::Seconds((double)(m_uiNumFrames-1) / (double)m_uiFramesPerSecond);
 
@@ -203,12 +255,15 @@ void ezAnimationClipResourceDescriptor::Load(ezStreamReader& stream)
     // should do nothing
     m_JointNameToIndex.Sort();
   }
+
+  // clips from older versions get compressed after loading
+  CompressKeyframes();
 }
 
 
 ezUInt64 ezAnimationClipResourceDescriptor::GetHeapMemoryUsage() const
 {
-  return m_JointTransforms.GetHeapMemoryUsage();
+  return m_JointTransforms.GetHeapMemoryUsage() + m_CompressedKeyframes.GetHeapMemoryUsage();
 }
 
 bool ezAnimationClipResourceDescriptor::HasRootMotion() const
@@ -242,9 +297,7 @@ void ezAnimationClipResourceDescriptor::SetPoseToKeyframe(ezAnimationPose& pose,
     const ezUInt16 uiSkeletonJointIdx = skeleton.FindJointByName(sJointName);
     if (uiSkeletonJointIdx != ezInvalidJointIndex)
     {
-      ezArrayPtr<const ezTransform> pTransforms = GetJointKeyframes(uiAnimJointIdx);
-
-      pose.SetTransform(uiSkeletonJointIdx, pTransforms[uiKeyframe].GetAsMat4());
+      pose.SetTransform(uiSkeletonJointIdx, GetJointKeyframe(uiAnimJointIdx, uiKeyframe).GetAsMat4());
     }
   }
 }
@@ -256,22 +309,43 @@ void ezAnimationClipResourceDescriptor::SetPoseToBlendedKeyframe(ezAnimationPose
   for (ezUInt32 b = 0; b < m_JointNameToIndex.GetCount(); ++b)
   {
     const ezHashedString& sJointName = m_JointNameToIndex.GetKey(b);
-    const ezUInt32 uiAnimJointIdx = m_JointNameToIndex.GetValue(b);
+    const ezUInt16 uiAnimJointIdx = m_JointNameToIndex.GetValue(b);
 
     const ezUInt16 uiSkeletonJointIdx = skeleton.FindJointByName(sJointName);
     if (uiSkeletonJointIdx != ezInvalidJointIndex)
     {
-      ezArrayPtr<const ezTransform> pTransforms = GetJointKeyframes(uiAnimJointIdx);
-      const ezTransform jointTransform1 = pTransforms[uiKeyframe0];
-      const ezTransform jointTransform2 = pTransforms[uiKeyframe0 + 1];
+      if (IsCompressed())
+      {
+        ezMat4 mTransform;
+        m_CompressedKeyframes.SampleJoint(uiAnimJointIdx, uiKeyframe0, fBlendToKeyframe1).GetAsMat4().GetAsArray(mTransform.m_fElementsCM, ezMatrixLayout::ColumnMajor);
+
+        pose.SetTransform(uiSkeletonJointIdx, mTransform);
+      }
+      else
+      {
+        const ezTransform res = BlendKeyframes(GetJointKeyframe(uiAnimJointIdx, uiKeyframe0), GetJointKeyframe(uiAnimJointIdx, uiKeyframe0 + 1), fBlendToKeyframe1);
+
+        pose.SetTransform(uiSkeletonJointIdx, res.GetAsMat4());
+      }
+    }
+  }
+}
 
-      ezTransform res;
-      res.m_vPosition = ezMath::Lerp(jointTransform1.m_vPosition, jointTransform2.m_vPosition, fBlendToKeyframe1);
-      res.m_qRotation.SetSlerp(jointTransform1.m_qRotation, jointTransform2.m_qRotation, fBlendToKeyframe1);
-      res.m_vScale = ezMath::Lerp(jointTransform1.m_vScale, jointTransform2.m_vScale, fBlendToKeyframe1);
+void ezAnimationClipResourceDescriptor::SamplePose(const ezJointMapping& jointMapping, ezUInt16 uiKeyframe0, float fBlendToKeyframe1, ezLocalSpaceAnimationPose& out_Pose) const
+{
+  if (IsCompressed())
+  {
+    m_CompressedKeyframes.SampleLocalPose(uiKeyframe0, fBlendToKeyframe1, jointMapping.GetAllMappings(), out_Pose);
+    return;
+  }
 
-      pose.SetTransform(uiSkeletonJointIdx, res.GetAsMat4());
-    }
+  const ezUInt16 uiKeyframe1 = ezMath::Min<ezUInt16>(uiKeyframe0 + 1, m_uiNumFrames - 1);
+
+  for (const ezJointMapping::Mapping& mapping : jointMapping.GetAllMappings())
+  {
+    const ezTransform res = BlendKeyframes(GetJointKeyframe(mapping.m_uiJointInAnimation, uiKeyframe0), GetJointKeyframe(mapping.m_uiJointInAnimation, uiKeyframe1), fBlendToKeyframe1);
+
+    out_Pose.SetTransform(mapping.m_uiJointInSkeleton, ezSimdConversion::ToTransform(res));
   }
 }
 
@@ -4,6 +4,8 @@
 #include <RendererCore/AnimationSystem/Skeleton.h>
 #include <RendererCore/Debug/DebugRenderer.h>
 
+#include <Foundation/SimdMath/SimdConversion.h>
+
 EZ_IMPLEMENT_MESSAGE_TYPE(ezMsgAnimationPoseUpdated);
 EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezMsgAnimationPoseUpdated, 1, ezRTTIDefaultAllocator<ezMsgAnimationPoseUpdated>)
 EZ_END_DYNAMIC_REFLECTED_TYPE;
@@ -202,7 +204,67 @@ void ezAnimationPose::SetValidityOfAllTransforms(bool bValid)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////
+
+ezLocalSpaceAnimationPose::ezLocalSpaceAnimationPose() = default;
+ezLocalSpaceAnimationPose::~ezLocalSpaceAnimationPose() = default;
+
+void ezLocalSpaceAnimationPose::Configure(const ezSkeleton& skeleton)
+{
+  EZ_ASSERT_DEV(skeleton.GetJointCount() > 0, "Animation pose needs a valid skeleton which also has at least one joint!");
 
+  m_Positions.SetCountUninitialized(skeleton.GetJointCount());
+  m_Rotations.SetCountUninitialized(skeleton.GetJointCount());
+  m_Scales.SetCountUninitialized(skeleton.GetJointCount());
+
+  SetToBindPose(skeleton);
+}
+
+void ezLocalSpaceAnimationPose::SetToBindPose(const ezSkeleton& skeleton)
+{
+  EZ_ASSERT_DEV(skeleton.GetJointCount() == GetTransformCount(), "Pose and skeleton have different joint count!");
+
+  const ezUInt16 numTransforms = GetTransformCount();
+  for (ezUInt16 i = 0; i < numTransforms; ++i)
+  {
+    SetTransform(i, ezSimdConversion::ToTransform(skeleton.GetJointByIndex(i).GetBindPoseLocalTransform()));
+  }
+}
+
+void ezLocalSpaceAnimationPose::SetTransform(ezUInt16 uiIndex, const ezSimdTransform& transform)
+{
+  m_Positions[uiIndex] = transform.m_Position;
+  m_Rotations[uiIndex] = transform.m_Rotation;
+  m_Scales[uiIndex] = transform.m_Scale;
+}
+
+void ezLocalSpaceAnimationPose::ConvertToObjectSpace(const ezSkeleton& skeleton, ezAnimationPose& out_Pose) const
+{
+  const ezUInt16 numTransforms = GetTransformCount();
+
+  EZ_ASSERT_DEV(skeleton.GetJointCount() == numTransforms, "Pose and skeleton have different joint count!");
+  EZ_ASSERT_DEV(out_Pose.GetTransformCount() == numTransforms, "Target pose has a different joint count!");
+
+  ezMat4* pObjectSpace = out_Pose.m_Transforms.GetData();
+
+  // joints are sorted such that parents always come before their children, so the parent's object space matrix is always final already
+  for (ezUInt16 i = 0; i < numTransforms; ++i)
+  {
+    ezSimdMat4f mTransform = ezSimdTransform(m_Positions[i], m_Rotations[i], m_Scales[i]).GetAsMat4();
+
+    const ezSkeletonJoint& joint = skeleton.GetJointByIndex(i);
+    if (!joint.IsRootJoint())
+    {
+      ezSimdMat4f mParent;
+      mParent.SetFromArray(pObjectSpace[joint.GetParentIndex()].m_fElementsCM, ezMatrixLayout::ColumnMajor);
+      mTransform = mParent * mTransform;
+    }
+
+    mTransform.GetAsArray(pObjectSpace[i].m_fElementsCM, ezMatrixLayout::ColumnMajor);
+  }
+
+  out_Pose.SetValidityOfAllTransforms(true);
+}
 
 EZ_STATICLINK_FILE(RendererCore, RendererCore_AnimationSystem_Implementation_AnimationPose);
 
@@ -0,0 +1,379 @@
+#include <RendererCorePCH.h>
+
+#include <Foundation/IO/Stream.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/SimdMath/SimdVec4i.h>
+#include <RendererCore/AnimationSystem/AnimationPose.h>
+#include <RendererCore/AnimationSystem/CompressedAnimationClip.h>
+
+namespace
+{
+  // all but the largest component of a normalized quaternion are within [-1/sqrt(2); 1/sqrt(2)]
+  constexpr float s_fRotationComponentRange = 0.70710678118f;
+  constexpr ezUInt32 s_uiMaxRotationValue = 0x7FFF;
+  constexpr ezUInt32 s_uiMaxVectorValue = 0xFFFF;
+
+  // the largest angle between a quantized rotation and the original one, see EncodeRotation()
+  constexpr float s_fMaxRotationErrorDegree = 0.01f;
+
+  // channels that change less than this over the whole clip are stored only once
+  constexpr float s_fConstantVectorEpsilon = 1e-5f;
+
+  EZ_ALWAYS_INLINE ezUInt16 Quantize(float fValue01, ezUInt32 uiMaxValue)
+  {
+    return static_cast<ezUInt16>(ezMath::Clamp<ezInt32>(static_cast<ezInt32>(fValue01 * uiMaxValue + 0.5f), 0, uiMaxValue));
+  }
+
+  void ComputeVectorRange(const ezVec3& vMin, const ezVec3& vMax, ezVec3& out_vMin, ezVec3& out_vStep, bool& out_bConstant)
+  {
+    const ezVec3 vRange = vMax - vMin;
+
+    out_bConstant = vRange.x <= s_fConstantVectorEpsilon && vRange.y <= s_fConstantVectorEpsilon && vRange.z <= s_fConstantVectorEpsilon;
+
+    if (out_bConstant)
+    {
+      out_vMin = (vMin + vMax) * 0.5f;
+      out_vStep.SetZero();
+    }
+    else
+    {
+      out_vMin = vMin;
+      out_vStep = vRange / static_cast<float>(s_uiMaxVectorValue);
+    }
+  }
+
+  void EncodeVector(const ezVec3& v, const ezVec3& vMin, const ezVec3& vStep, ezUInt16* pFrameData)
+  {
+    for (ezUInt32 i = 0; i < 3; ++i)
+    {
+      const float fStep = vStep.GetData()[i];
+      const float fValue = fStep > 0.0f ? (v.GetData()[i] - vMin.GetData()[i]) / (fStep * s_uiMaxVectorValue) : 0.0f;
+      pFrameData[i] = Quantize(fValue, s_uiMaxVectorValue);
+    }
+  }
+} // namespace
+
+void ezCompressedAnimationClip::Compress(ezUInt16 uiNumJoints, ezUInt16 uiNumFrames, ezArrayPtr<const ezTransform> jointTransforms)
+{
+  EZ_ASSERT_DEV(jointTransforms.GetCount() == static_cast<ezUInt32>(uiNumJoints) * uiNumFrames, "Invalid number of keyframes");
+
+  Clear();
+
+  m_uiNumFrames = uiNumFrames;
+  m_Joints.SetCountUninitialized(uiNumJoints);
+
+  // a rotation is only stored once if that doesn't introduce a larger error than quantizing it
+  const float fMaxConstantRotationSin = ezMath::Sin(ezAngle::Degree(s_fMaxRotationErrorDegree * 0.5f));
+  const float fMaxConstantRotationSinSquared = fMaxConstantRotationSin * fMaxConstantRotationSin;
+
+  // figure out which channels are animated and which value range they cover
+  ezUInt32 uiStride = 0;
+  for (ezUInt16 uiJoint = 0; uiJoint < uiNumJoints; ++uiJoint)
+  {
+    JointInfo& joint = m_Joints[uiJoint];
+    const ezArrayPtr<const ezTransform> keyframes = jointTransforms.GetSubArray(uiJoint * uiNumFrames, uiNumFrames);
+
+    if (keyframes.IsEmpty())
+    {
+      joint.m_qConstantRotation.SetIdentity();
+      joint.m_vPositionMin.SetZero();
+      joint.m_vPositionStep.SetZero();
+      joint.m_vScaleMin.Set(1.0f);
+      joint.m_vScaleStep.SetZero();
+      joint.m_uiRotationOffset = ezInvalidIndex;
+      joint.m_uiPositionOffset = ezInvalidIndex;
+      joint.m_uiScaleOffset = ezInvalidIndex;
+      continue;
+    }
+
+    const ezQuat& qFirst = keyframes[0].m_qRotation;
+    const ezQuat qInvFirst = -qFirst;
+    bool bConstantRotation = true;
+
+    ezVec3 vPositionMin = keyframes[0].m_vPosition;
+    ezVec3 vPositionMax = keyframes[0].m_vPosition;
+    ezVec3 vScaleMin = keyframes[0].m_vScale;
+    ezVec3 vScaleMax = keyframes[0].m_vScale;
+
+    for (const ezTransform& keyframe : keyframes)
+    {
+      // the vector part of the rotation from the first keyframe to this one has the length sin(angle / 2)
+      if ((keyframe.m_qRotation * qInvFirst).v.GetLengthSquared() > fMaxConstantRotationSinSquared)
+      {
+        bConstantRotation = false;
+      }
+
+      vPositionMin = vPositionMin.CompMin(keyframe.m_vPosition);
+      vPositionMax = vPositionMax.CompMax(keyframe.m_vPosition);
+      vScaleMin = vScaleMin.CompMin(keyframe.m_vScale);
+      vScaleMax = vScaleMax.CompMax(keyframe.m_vScale);
+    }
+
+    bool bConstantPosition, bConstantScale;
+    ComputeVectorRange(vPositionMin, vPositionMax, joint.m_vPositionMin, joint.m_vPositionStep, bConstantPosition);
+    ComputeVectorRange(vScaleMin, vScaleMax, joint.m_vScaleMin, joint.m_vScaleStep, bConstantScale);
+
+    joint.m_qConstantRotation = qFirst;
+    joint.m_uiRotationOffset = bConstantRotation ? ezInvalidIndex : uiStride;
+    uiStride += bConstantRotation ? 0 : 3;
+
+    joint.m_uiPositionOffset = bConstantPosition ? ezInvalidIndex : uiStride;
+    uiStride += bConstantPosition ? 0 : 3;
+
+    joint.m_uiScaleOffset = bConstantScale ? ezInvalidIndex : uiStride;
+    uiStride += bConstantScale ? 0 : 3;
+  }
+
+  m_uiFrameStride = uiStride;
+  m_FrameData.SetCountUninitialized(m_uiFrameStride * uiNumFrames);
+
+  // store all animated channels of one frame next to each other
+  for (ezUInt16 uiFrame = 0; uiFrame < uiNumFrames; ++uiFrame)
+  {
+    ezUInt16* pFrameData = m_FrameData.GetData() + uiFrame * m_uiFrameStride;
+
+    for (ezUInt16 uiJoint = 0; uiJoint < uiNumJoints; ++uiJoint)
+    {
+      const JointInfo& joint = m_Joints[uiJoint];
+      const ezTransform& keyframe = jointTransforms[uiJoint * uiNumFrames + uiFrame];
+
+      if (joint.m_uiRotationOffset != ezInvalidIndex)
+      {
+        EncodeRotation(keyframe.m_qRotation, pFrameData + joint.m_uiRotationOffset);
+      }
+
+      if (joint.m_uiPositionOffset != ezInvalidIndex)
+      {
+        EncodeVector(keyframe.m_vPosition, joint.m_vPositionMin, joint.m_vPositionStep, pFrameData + joint.m_uiPositionOffset);
+      }
+
+      if (joint.m_uiScaleOffset != ezInvalidIndex)
+      {
+        EncodeVector(keyframe.m_vScale, joint.m_vScaleMin, joint.m_vScaleStep, pFrameData + joint.m_uiScaleOffset);
+      }
+    }
+  }
+}
+
+void ezCompressedAnimationClip::Clear()
+{
+  m_uiNumFrames = 0;
+  m_uiFrameStride = 0;
+  m_Joints.Clear();
+  m_FrameData.Clear();
+}
+
+ezTransform ezCompressedAnimationClip::GetKeyframe(ezUInt16 uiJoint, ezUInt16 uiFrame) const
+{
+  const JointInfo& joint = m_Joints[uiJoint];
+  const ezUInt16* pFrameData = m_FrameData.GetData() + uiFrame * m_uiFrameStride;
+
+  const ezSimdTransform t(DecodeVector(joint.m_uiPositionOffset, joint.m_vPositionMin, joint.m_vPositionStep, pFrameData),
+    DecodeRotation(joint, pFrameData), DecodeVector(joint.m_uiScaleOffset, joint.m_vScaleMin, joint.m_vScaleStep, pFrameData));
+
+  return ezSimdConversion::ToTransform(t);
+}
+
+ezSimdTransform ezCompressedAnimationClip::SampleJoint(ezUInt16 uiJoint, ezUInt16 uiFrame0, float fLerp) const
+{
+  const ezUInt16 uiFrame1 = ezMath::Min<ezUInt16>(uiFrame0 + 1, m_uiNumFrames - 1);
+
+  const ezUInt16* pFrame0 = m_FrameData.GetData() + uiFrame0 * m_uiFrameStride;
+  const ezUInt16* pFrame1 = m_FrameData.GetData() + uiFrame1 * m_uiFrameStride;
+
+  return SampleJoint(m_Joints[uiJoint], pFrame0, pFrame1, fLerp);
+}
+
+void ezCompressedAnimationClip::SampleLocalPose(ezUInt16 uiFrame0, float fLerp, ezArrayPtr<const ezJointMapping::Mapping> jointMapping, ezLocalSpaceAnimationPose& out_Pose) const
+{
+  const ezUInt16 uiFrame1 = ezMath::Min<ezUInt16>(uiFrame0 + 1, m_uiNumFrames - 1);
+
+  const ezUInt16* pFrame0 = m_FrameData.GetData() + uiFrame0 * m_uiFrameStride;
+  const ezUInt16* pFrame1 = m_FrameData.GetData() + uiFrame1 * m_uiFrameStride;
+  const ezSimdFloat fSimdLerp = fLerp;
+
+  for (const ezJointMapping::Mapping& mapping : jointMapping)
+  {
+    const ezSimdTransform t = SampleJoint(m_Joints[mapping.m_uiJointInAnimation], pFrame0, pFrame1, fSimdLerp);
+
+    const ezUInt16 uiPoseJoint = mapping.m_uiJointInSkeleton;
+    out_Pose.m_Positions[uiPoseJoint] = t.m_Position;
+    out_Pose.m_Rotations[uiPoseJoint] = t.m_Rotation;
+    out_Pose.m_Scales[uiPoseJoint] = t.m_Scale;
+  }
+}
+
+void ezCompressedAnimationClip::Save(ezStreamWriter& stream) const
+{
+  const ezUInt8 uiVersion = 1;
+  stream << uiVersion;
+
+  const ezUInt16 uiNumJoints = GetNumJoints();
+  stream << uiNumJoints;
+  stream << m_uiNumFrames;
+  stream << m_uiFrameStride;
+
+  for (const JointInfo& joint : m_Joints)
+  {
+    stream << joint.m_qConstantRotation;
+    stream << joint.m_vPositionMin;
+    stream << joint.m_vPositionStep;
+    stream << joint.m_vScaleMin;
+    stream << joint.m_vScaleStep;
+    stream << joint.m_uiRotationOffset;
+    stream << joint.m_uiPositionOffset;
+    stream << joint.m_uiScaleOffset;
+  }
+
+  stream.WriteBytes(m_FrameData.GetData(), m_FrameData.GetCount() * sizeof(ezUInt16));
+}
+
+void ezCompressedAnimationClip::Load(ezStreamReader& stream)
+{
+  Clear();
+
+  ezUInt8 uiVersion = 0;
+  stream >> uiVersion;
+
+  EZ_ASSERT_DEV(uiVersion == 1, "Invalid compressed animation clip version {0}", uiVersion);
+
+  ezUInt16 uiNumJoints = 0;
+  stream >> uiNumJoints;
+  stream >> m_uiNumFrames;
+  stream >> m_uiFrameStride;
+
+  m_Joints.SetCountUninitialized(uiNumJoints);
+  for (JointInfo& joint : m_Joints)
+  {
+    stream >> joint.m_qConstantRotation;
+    stream >> joint.m_vPositionMin;
+    stream >> joint.m_vPositionStep;
+    stream >> joint.m_vScaleMin;
+    stream >> joint.m_vScaleStep;
+    stream >> joint.m_uiRotationOffset;
+    stream >> joint.m_uiPositionOffset;
+    stream >> joint.m_uiScaleOffset;
+  }
+
+  m_FrameData.SetCountUninitialized(m_uiFrameStride * m_uiNumFrames);
+  stream.ReadBytes(m_FrameData.GetData(), m_FrameData.GetCount() * sizeof(ezUInt16));
+}
+
+ezUInt64 ezCompressedAnimationClip::GetHeapMemoryUsage() const
+{
+  return m_Joints.GetHeapMemoryUsage() + m_FrameData.GetHeapMemoryUsage();
+}
+
+// static
+void ezCompressedAnimationClip::EncodeRotation(const ezQuat& qRotation, ezUInt16* pFrameData)
+{
+  const float fComponents[4] = {qRotation.v.x, qRotation.v.y, qRotation.v.z, qRotation.w};
+
+  ezUInt32 uiLargest = 0;
+  for (ezUInt32 i = 1; i < 4; ++i)
+  {
+    if (ezMath::Abs(fComponents[i]) > ezMath::Abs(fComponents[uiLargest]))
+      uiLargest = i;
+  }
+
+  // q and -q are the same rotation, flip it such that the largest component is positive and can be reconstructed from the others
+  const float fSign = fComponents[uiLargest] < 0.0f ? -1.0f : 1.0f;
+
+  ezUInt16 uiValues[3];
+  ezUInt32 uiNumValues = 0;
+  for (ezUInt32 i = 0; i < 4; ++i)
+  {
+    if (i != uiLargest)
+    {
+      const float fValue01 = (fComponents[i] * fSign / s_fRotationComponentRange) * 0.5f + 0.5f;
+      uiValues[uiNumValues++] = Quantize(fValue01, s_uiMaxRotationValue);
+    }
+  }
+
+  // the index of the largest component is stored in the top bits of the first two values
+  pFrameData[0] = uiValues[0] | static_cast<ezUInt16>((uiLargest & 1) << 15);
+  pFrameData[1] = uiValues[1] | static_cast<ezUInt16>((uiLargest >> 1) << 15);
+  pFrameData[2] = uiValues[2];
+}
+
+// static
+ezSimdQuat ezCompressedAnimationClip::DecodeRotation(const JointInfo& joint, const ezUInt16* pFrameData)
+{
+  if (joint.m_uiRotationOffset == ezInvalidIndex)
+    return ezSimdConversion::ToQuat(joint.m_qConstantRotation);
+
+  pFrameData += joint.m_uiRotationOffset;
+
+  const ezSimdVec4i packed(pFrameData[0], pFrameData[1], pFrameData[2], 0);
+  const ezSimdVec4f fScale(2.0f * s_fRotationComponentRange / s_uiMaxRotationValue);
+  const ezSimdVec4f fOffset(-s_fRotationComponentRange);
+
+  ezSimdVec4f q = ezSimdVec4f::MulAdd((packed & ezSimdVec4i(s_uiMaxRotationValue)).ToFloat(), fScale, fOffset);
+  const ezSimdFloat fLargest = (ezSimdFloat(1.0f) - q.Dot<3>(q)).Max(ezSimdFloat::Zero()).GetSqrt();
+  q.SetW(fLargest);
+
+  const ezUInt32 uiLargest = (pFrameData[0] >> 15) | ((pFrameData[1] >> 15) << 1);
+  switch (uiLargest)
+  {
+    case 0:
+      return ezSimdQuat(q.Get<ezSwizzle::WXYZ>());
+    case 1:
+      return ezSimdQuat(q.Get<ezSwizzle::XWYZ>());
+    case 2:
+      return ezSimdQuat(q.Get<ezSwizzle::XYWZ>());
+    default:
+      return ezSimdQuat(q);
+  }
+}
+
+// static
+ezSimdVec4f ezCompressedAnimationClip::DecodeVector(ezUInt32 uiOffset, const ezVec3& vMin, const ezVec3& vStep, const ezUInt16* pFrameData)
+{
+  if (uiOffset == ezInvalidIndex)
+    return ezSimdConversion::ToVec3(vMin);
+
+  pFrameData += uiOffset;
+
+  const ezSimdVec4i packed(pFrameData[0], pFrameData[1], pFrameData[2], 0);
+  return ezSimdVec4f::MulAdd(packed.ToFloat(), ezSimdConversion::ToVec3(vStep), ezSimdConversion::ToVec3(vMin));
+}
+
+// static
+ezSimdTransform ezCompressedAnimationClip::SampleJoint(const JointInfo& joint, const ezUInt16* pFrame0, const ezUInt16* pFrame1, const ezSimdFloat& fLerp)
+{
+  const ezSimdVec4f vLerp(fLerp);
+
+  ezSimdTransform result;
+
+  if (joint.m_uiRotationOffset == ezInvalidIndex)
+  {
+    result.m_Rotation = ezSimdConversion::ToQuat(joint.m_qConstantRotation);
+  }
+  else
+  {
+    const ezSimdQuat q0 = DecodeRotation(joint, pFrame0);
+    const ezSimdQuat q1 = DecodeRotation(joint, pFrame1);
+
+    // normalized lerp along the shorter arc, the angle between two keyframes is small enough that this is very close to a slerp
+    ezSimdVec4f v1 = q1.m_v;
+    if (q0.m_v.Dot<4>(v1) < ezSimdFloat::Zero())
+    {
+      v1 = -v1;
+    }
+
+    result.m_Rotation = ezSimdQuat(ezSimdVec4f::Lerp(q0.m_v, v1, vLerp));
+    result.m_Rotation.Normalize();
+  }
+
+  const ezSimdVec4f vPosition0 = DecodeVector(joint.m_uiPositionOffset, joint.m_vPositionMin, joint.m_vPositionStep, pFrame0);
+  const ezSimdVec4f vPosition1 = DecodeVector(joint.m_uiPositionOffset, joint.m_vPositionMin, joint.m_vPositionStep, pFrame1);
+  result.m_Position = ezSimdVec4f::Lerp(vPosition0, vPosition1, vLerp);
+
+  const ezSimdVec4f vScale0 = DecodeVector(joint.m_uiScaleOffset, joint.m_vScaleMin, joint.m_vScaleStep, pFrame0);
+  const ezSimdVec4f vScale1 = DecodeVector(joint.m_uiScaleOffset, joint.m_vScaleMin, joint.m_vScaleStep, pFrame1);
+  result.m_Scale = ezSimdVec4f::Lerp(vScale0, vScale1, vLerp);
+
+  return result;
+}
+
+EZ_STATICLINK_FILE(RendererCore, RendererCore_AnimationSystem_Implementation_CompressedAnimationClip);
@@ -6,7 +6,7 @@
 
 class ezSkeleton;
 
-class ezJointMapping
+class EZ_RENDERERCORE_DLL ezJointMapping
 {
 public:
   struct Mapping
@@ -65,6 +65,9 @@ public:
   void AddRenderData(const ezRenderData* pRenderData, ezRenderData::Category category);
   void AddFrameData(const ezRenderData* pFrameData);
 
+  /// \brief Sorts the render data of every category by sorting key and batch id and groups consecutive render data into batches.
+  ///
+  /// The categories are processed concurrently, large categories are additionally radix sorted and batched with multiple tasks.
   void SortAndBatch();
 
   void Clear();
@@ -85,8 +88,12 @@ private:
   {
     ezDynamicArray< ezRenderDataBatch > m_Batches;
     ezDynamicArray< ezRenderDataBatch::SortableRenderData > m_SortableRenderData;
+    ezDynamicArray< ezRenderDataBatch::SortableRenderData > m_SortScratch; ///< Second buffer for the radix sort, kept to avoid allocations every frame.
   };
 
+  static void SortRenderData(DataPerCategory& dataPerCategory);
+  static void BatchRenderData(DataPerCategory& dataPerCategory);
+
   ezCamera m_Camera;
   ezViewData m_ViewData;
   ezTime m_WorldTime;
@@ -1,6 +1,9 @@
 #include <RendererCorePCH.h>
 
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/Lock.h>
+#include <Foundation/Threading/Mutex.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <RendererCore/Pipeline/ExtractedRenderData.h>
 
 ezExtractedRenderData::ezExtractedRenderData() {}
@@ -19,10 +22,219 @@ void ezExtractedRenderData::AddFrameData(const ezRenderData* pFrameData)
   m_FrameData.PushBack(pFrameData);
 }
 
+namespace
+{
+  // The render data is sorted by 8 radix digits of the sorting key. The 4 digits of the batch id are sorted first, which makes it the tie
+  // breaker for equal sorting keys.
+  constexpr ezUInt32 s_uiNumRadixDigits = 12;
+  constexpr ezUInt32 s_uiNumRadixBuckets = 256;
+
+  /// Small categories are sorted faster with a comparison sort than by building histograms.
+  constexpr ezUInt32 s_uiMinRenderDataForRadixSort = 512;
+
+  /// The radix sort and the batching split the render data of one category into this many consecutive chunks at most,
+  /// each chunk holds at least s_uiMinRenderDataPerChunk render data.
+  constexpr ezUInt32 s_uiMaxChunks = 32;
+  constexpr ezUInt32 s_uiMinRenderDataPerChunk = 8 * 1024;
+
+  struct Chunks
+  {
+    Chunks(ezUInt32 uiCount)
+      : m_uiCount(uiCount)
+    {
+      m_uiNumChunks = ezMath::Clamp(uiCount / s_uiMinRenderDataPerChunk, 1u, s_uiMaxChunks);
+      m_uiChunkSize = (uiCount + m_uiNumChunks - 1) / m_uiNumChunks;
+    }
+
+    EZ_ALWAYS_INLINE ezUInt32 GetStart(ezUInt32 uiChunk) const { return ezMath::Min(uiChunk * m_uiChunkSize, m_uiCount); }
+    EZ_ALWAYS_INLINE ezUInt32 GetEnd(ezUInt32 uiChunk) const { return ezMath::Min((uiChunk + 1) * m_uiChunkSize, m_uiCount); }
+
+    /// Calls func(uiChunk) for all chunks, in parallel if there is more than one.
+    template <typename Func>
+    void ForEach(const Func& func, const char* szTaskName) const
+    {
+      if (m_uiNumChunks == 1)
+      {
+        func(0);
+        return;
+      }
+
+      ezParallelForParams params;
+      params.uiBinSize = 1;
+
+      ezTaskSystem::ParallelForIndexed(0, m_uiNumChunks,
+        [&func](ezUInt32 uiStartChunk, ezUInt32 uiEndChunk) {
+          for (ezUInt32 uiChunk = uiStartChunk; uiChunk < uiEndChunk; ++uiChunk)
+          {
+            func(uiChunk);
+          }
+        },
+        szTaskName, params);
+    }
+
+    ezUInt32 m_uiCount;
+    ezUInt32 m_uiNumChunks;
+    ezUInt32 m_uiChunkSize;
+  };
+
+  template <typename SortableRenderData>
+  EZ_ALWAYS_INLINE ezUInt32 GetRadixDigit(const SortableRenderData& data, ezUInt32 uiDigit)
+  {
+    if (uiDigit < 4)
+    {
+      return (data.m_pRenderData->m_uiBatchId >> (uiDigit * 8)) & 0xFF;
+    }
+
+    return static_cast<ezUInt32>(data.m_uiSortingKey >> ((uiDigit - 4) * 8)) & 0xFF;
+  }
+
+  /// \brief Stable least significant digit radix sort. Every pass histograms the chunks in parallel and then scatters them in parallel,
+  /// each chunk into its own precomputed ranges of the target buckets.
+  template <typename SortableRenderData>
+  void RadixSort(ezDynamicArray<SortableRenderData>& data, ezDynamicArray<SortableRenderData>& scratch)
+  {
+    const Chunks chunks(data.GetCount());
+
+    // The total histograms don't depend on the order, so they are computed once for all digits.
+    // They tell which digits are the same for all render data, sorting by those would not change the order.
+    ezUInt32 totalHistograms[s_uiNumRadixDigits][s_uiNumRadixBuckets] = {};
+    ezMutex histogramMutex;
+
+    chunks.ForEach(
+      [&](ezUInt32 uiChunk) {
+        ezUInt32 histograms[s_uiNumRadixDigits][s_uiNumRadixBuckets] = {};
+
+        for (ezUInt32 i = chunks.GetStart(uiChunk); i < chunks.GetEnd(uiChunk); ++i)
+        {
+          for (ezUInt32 uiDigit = 0; uiDigit < s_uiNumRadixDigits; ++uiDigit)
+          {
+            ++histograms[uiDigit][GetRadixDigit(data[i], uiDigit)];
+          }
+        }
+
+        EZ_LOCK(histogramMutex);
+        for (ezUInt32 uiDigit = 0; uiDigit < s_uiNumRadixDigits; ++uiDigit)
+        {
+          for (ezUInt32 uiBucket = 0; uiBucket < s_uiNumRadixBuckets; ++uiBucket)
+          {
+            totalHistograms[uiDigit][uiBucket] += histograms[uiDigit][uiBucket];
+          }
+        }
+      },
+      "SortAndBatch::Histogram");
+
+    scratch.SetCountUninitialized(data.GetCount());
+
+    // offsets of every bucket in every chunk, chunk after chunk
+    ezHybridArray<ezUInt32, s_uiNumRadixBuckets> chunkOffsets;
+    chunkOffsets.SetCountUninitialized(chunks.m_uiNumChunks * s_uiNumRadixBuckets);
+
+    SortableRenderData* pSource = data.GetData();
+    SortableRenderData* pTarget = scratch.GetData();
+
+    for (ezUInt32 uiDigit = 0; uiDigit < s_uiNumRadixDigits; ++uiDigit)
+    {
+      if (totalHistograms[uiDigit][GetRadixDigit(pSource[0], uiDigit)] == chunks.m_uiCount)
+        continue;
+
+      if (chunks.m_uiNumChunks == 1)
+      {
+        ezMemoryUtils::Copy(chunkOffsets.GetData(), totalHistograms[uiDigit], s_uiNumRadixBuckets);
+      }
+      else
+      {
+        chunks.ForEach(
+          [&](ezUInt32 uiChunk) {
+            ezUInt32* pHistogram = chunkOffsets.GetData() + uiChunk * s_uiNumRadixBuckets;
+            ezMemoryUtils::ZeroFill(pHistogram, s_uiNumRadixBuckets);
+
+            for (ezUInt32 i = chunks.GetStart(uiChunk); i < chunks.GetEnd(uiChunk); ++i)
+            {
+              ++pHistogram[GetRadixDigit(pSource[i], uiDigit)];
+            }
+          },
+          "SortAndBatch::Histogram");
+      }
+
+      // Exclusive prefix sum over the buckets and within each bucket over the chunks, which keeps the sort stable.
+      ezUInt32 uiOffset = 0;
+      for (ezUInt32 uiBucket = 0; uiBucket < s_uiNumRadixBuckets; ++uiBucket)
+      {
+        for (ezUInt32 uiChunk = 0; uiChunk < chunks.m_uiNumChunks; ++uiChunk)
+        {
+          ezUInt32& uiChunkOffset = chunkOffsets[uiChunk * s_uiNumRadixBuckets + uiBucket];
+          const ezUInt32 uiNumInChunk = uiChunkOffset;
+          uiChunkOffset = uiOffset;
+          uiOffset += uiNumInChunk;
+        }
+      }
+
+      chunks.ForEach(
+        [&](ezUInt32 uiChunk) {
+          ezUInt32* pOffsets = chunkOffsets.GetData() + uiChunk * s_uiNumRadixBuckets;
+
+          for (ezUInt32 i = chunks.GetStart(uiChunk); i < chunks.GetEnd(uiChunk); ++i)
+          {
+            pTarget[pOffsets[GetRadixDigit(pSource[i], uiDigit)]++] = pSource[i];
+          }
+        },
+        "SortAndBatch::Scatter");
+
+      ezMath::Swap(pSource, pTarget);
+    }
+
+    if (pSource != data.GetData())
+    {
+      data.Swap(scratch);
+    }
+  }
+
+  template <typename SortableRenderData>
+  EZ_ALWAYS_INLINE bool IsBatchStart(const SortableRenderData* pData, ezUInt32 uiIndex)
+  {
+    if (uiIndex == 0)
+      return true;
+
+    const ezRenderData* pPrevious = pData[uiIndex - 1].m_pRenderData;
+    const ezRenderData* pCurrent = pData[uiIndex].m_pRenderData;
+
+    return pCurrent->m_uiBatchId != pPrevious->m_uiBatchId || pCurrent->GetDynamicRTTI() != pPrevious->GetDynamicRTTI();
+  }
+} // namespace
+
 void ezExtractedRenderData::SortAndBatch()
 {
   EZ_PROFILE_SCOPE("SortAndBatch");
 
+  ezParallelForParams params;
+  params.uiBinSize = 1;
+
+  ezTaskSystem::ParallelForIndexed(0, m_DataPerCategory.GetCount(),
+    [this](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+      for (ezUInt32 uiCategory = uiStartIndex; uiCategory < uiEndIndex; ++uiCategory)
+      {
+        auto& dataPerCategory = m_DataPerCategory[uiCategory];
+        if (dataPerCategory.m_SortableRenderData.IsEmpty())
+          continue;
+
+        SortRenderData(dataPerCategory);
+        BatchRenderData(dataPerCategory);
+      }
+    },
+    "SortAndBatch", params);
+}
+
+// static
+void ezExtractedRenderData::SortRenderData(DataPerCategory& dataPerCategory)
+{
+  auto& data = dataPerCategory.m_SortableRenderData;
+
+  if (data.GetCount() >= s_uiMinRenderDataForRadixSort)
+  {
+    RadixSort(data, dataPerCategory.m_SortScratch);
+    return;
+  }
+
   struct RenderDataComparer
   {
     EZ_FORCE_INLINE bool Less(const ezRenderDataBatch::SortableRenderData& a, const ezRenderDataBatch::SortableRenderData& b) const
@@ -36,38 +248,72 @@ void ezExtractedRenderData::SortAndBatch()
     }
   };
 
-  for (auto& dataPerCategory : m_DataPerCategory)
-  {
-    if (dataPerCategory.m_SortableRenderData.IsEmpty())
-      continue;
+  data.Sort(RenderDataComparer());
+}
 
-    auto& data = dataPerCategory.m_SortableRenderData;
+// static
+void ezExtractedRenderData::BatchRenderData(DataPerCategory& dataPerCategory)
+{
+  auto& data = dataPerCategory.m_SortableRenderData;
+  auto& batches = dataPerCategory.m_Batches;
 
-    // Sort
-    data.Sort(RenderDataComparer());
+  const Chunks chunks(data.GetCount());
 
-    // Find batches
-    ezUInt32 uiCurrentBatchId = data[0].m_pRenderData->m_uiBatchId;
-    ezUInt32 uiCurrentBatchStartIndex = 0;
-    const ezRTTI* pCurrentBatchType = data[0].m_pRenderData->GetDynamicRTTI();
+  // Count the batches that start in every chunk, which gives every chunk its range in the batch array.
+  ezHybridArray<ezUInt32, s_uiMaxChunks + 1> firstBatchInChunk;
+  firstBatchInChunk.SetCount(chunks.m_uiNumChunks + 1);
 
-    for (ezUInt32 i = 1; i < data.GetCount(); ++i)
+  chunks.ForEach(
+    [&](ezUInt32 uiChunk) {
+      ezUInt32 uiNumBatches = 0;
+      for (ezUInt32 i = chunks.GetStart(uiChunk); i < chunks.GetEnd(uiChunk); ++i)
+      {
+        uiNumBatches += IsBatchStart(data.GetData(), i) ? 1 : 0;
+      }
+
+      firstBatchInChunk[uiChunk + 1] = uiNumBatches;
+    },
+    "SortAndBatch::CountBatches");
+
+  for (ezUInt32 uiChunk = 0; uiChunk < chunks.m_uiNumChunks; ++uiChunk)
+  {
+    firstBatchInChunk[uiChunk + 1] += firstBatchInChunk[uiChunk];
+  }
+
+  const ezUInt32 uiNumBatches = firstBatchInChunk[chunks.m_uiNumChunks];
+  batches.SetCount(uiNumBatches);
+
+  // Every batch ends where the next one starts, which might be in the next chunk.
+  auto GetBatchEnd = [&](ezUInt32 uiBatchStart) {
+    ezUInt32 uiBatchEnd = uiBatchStart + 1;
+    while (uiBatchEnd < data.GetCount() && !IsBatchStart(data.GetData(), uiBatchEnd))
     {
-      auto pRenderData = data[i].m_pRenderData;
+      ++uiBatchEnd;
+    }
+    return uiBatchEnd;
+  };
 
-      if (pRenderData->m_uiBatchId != uiCurrentBatchId || pRenderData->GetDynamicRTTI() != pCurrentBatchType)
+  chunks.ForEach(
+    [&](ezUInt32 uiChunk) {
+      ezUInt32 uiBatch = firstBatchInChunk[uiChunk];
+      const ezUInt32 uiChunkEnd = chunks.GetEnd(uiChunk);
+
+      ezUInt32 uiBatchStart = chunks.GetStart(uiChunk);
+      while (uiBatchStart < uiChunkEnd && !IsBatchStart(data.GetData(), uiBatchStart))
       {
-        dataPerCategory.m_Batches.ExpandAndGetRef().m_Data = ezMakeArrayPtr(&data[uiCurrentBatchStartIndex], i - uiCurrentBatchStartIndex);
+        ++uiBatchStart;
+      }
 
-        uiCurrentBatchId = pRenderData->m_uiBatchId;
-        uiCurrentBatchStartIndex = i;
-        pCurrentBatchType = pRenderData->GetDynamicRTTI();
+      while (uiBatchStart < uiChunkEnd)
+      {
+        const ezUInt32 uiBatchEnd = GetBatchEnd(uiBatchStart);
+        batches[uiBatch++].m_Data = ezMakeArrayPtr(&data[uiBatchStart], uiBatchEnd - uiBatchStart);
+        uiBatchStart = uiBatchEnd;
       }
-    }
 
-    dataPerCategory.m_Batches.ExpandAndGetRef().m_Data =
-        ezMakeArrayPtr(&data[uiCurrentBatchStartIndex], data.GetCount() - uiCurrentBatchStartIndex);
-  }
+      EZ_ASSERT_DEBUG(uiBatch == firstBatchInChunk[uiChunk + 1], "Inconsistent number of batches");
+    },
+    "SortAndBatch::FindBatches");
 }
 
 void ezExtractedRenderData::Clear()
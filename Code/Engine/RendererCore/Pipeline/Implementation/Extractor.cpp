@@ -5,6 +5,7 @@
 #include <RendererCore/Debug/DebugRenderer.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
 #include <Core/World/World.h>
+#include <Core/World/SpatialSystem_Bvh.h>
 #include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Foundation/Configuration/CVar.h>
 #include <RendererCore/Pipeline/ExtractedRenderData.h>
@@ -28,17 +29,22 @@ namespace
     if (CVarVisSpatialData && CVarVisObjectName.GetValue().IsEmpty() && !CVarVisObjectSelection)
     {
       const ezSpatialSystem& spatialSystem = *view.GetWorld()->GetSpatialSystem();
+      ezSpatialData::Category filterCategory = ezSpatialData::FindCategory(CVarVisSpatialCategory.GetValue());
+
+      ezHybridArray<ezBoundingBox, 16> boxes;
       if (auto pSpatialSystemGrid = ezDynamicCast<const ezSpatialSystem_RegularGrid*>(&spatialSystem))
       {
-        ezSpatialData::Category filterCategory = ezSpatialData::FindCategory(CVarVisSpatialCategory.GetValue());
-
-        ezHybridArray<ezBoundingBox, 16> boxes;
         pSpatialSystemGrid->GetAllCellBoxes(boxes, filterCategory);
+      }
+      else if (auto pSpatialSystemBvh = ezDynamicCast<const ezSpatialSystem_Bvh*>(&spatialSystem))
+      {
+        // the lower levels of the tree are too dense to be useful
+        pSpatialSystemBvh->GetAllNodeBoxes(boxes, filterCategory, 8);
+      }
 
-        for (auto& box : boxes)
-        {
-          ezDebugRenderer::DrawLineBox(view.GetHandle(), box, ezColor::Cyan);
-        }
+      for (auto& box : boxes)
+      {
+        ezDebugRenderer::DrawLineBox(view.GetHandle(), box, ezColor::Cyan);
       }
     }
   }
@@ -970,6 +970,9 @@ void ezRenderPipeline::FindVisibleObjects(const ezView& view)
 
     sb.Format("Time Taken: {0}ms", m_AverageCullingTime.GetMilliseconds());
     ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 280), ezColor::LimeGreen);
+
+    sb.Format("Num Tasks: {0}", stats.m_uiNumTasks);
+    ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 300), ezColor::LimeGreen);
   }
 #else
   view.GetWorld()->GetSpatialSystem().FindVisibleObjects(frustum, m_visibleObjects, nullptr);
@@ -0,0 +1,1515 @@
+#include <TexturePCH.h>
+
+#include <Foundation/Math/Color16f.h>
+#include <Foundation/SimdMath/SimdVec4f.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Texture/Image/Conversions/DXTConversions.h>
+#include <Texture/Image/Conversions/PixelConversions.h>
+#include <Texture/Image/ImageConversion.h>
+
+// All encoders in this file work the same way: the endpoints of a block are initialized with the extents of the pixels along their
+// principal axis, then every pixel picks the closest entry of the palette that the decoder derives from the quantized endpoints.
+// Depending on the quality, the endpoints are then refined with a least squares fit to the chosen indices, keeping the best result.
+// The partitioned BC6H and BC7 modes rank all partitions by how well their subsets fit a line and only encode the best candidates.
+// Pixels are stored in ezSimdVec4f, so fitting and distance computations handle all channels at once.
+
+namespace
+{
+  constexpr ezUInt32 s_uiNumPixelsPerBlock = 16;
+
+  /// Number of least squares refinement steps per quality level.
+  constexpr ezUInt32 s_uiRefinementSteps[] = {0, 1, 3};
+
+  constexpr ezInt32 s_iBC67Weights2[] = {0, 21, 43, 64};
+  constexpr ezInt32 s_iBC67Weights3[] = {0, 9, 18, 27, 37, 46, 55, 64};
+  constexpr ezInt32 s_iBC67Weights4[] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+  /// Writes bits in the order in which the BC6H and BC7 decoders read them.
+  struct BitWriter
+  {
+    explicit BitWriter(ezUInt8* pTarget)
+      : m_pTarget(pTarget)
+    {
+      ezMemoryUtils::ZeroFill(pTarget, 16);
+    }
+
+    void Write(ezUInt32 uiValue, ezUInt32 uiNumBits)
+    {
+      for (ezUInt32 i = 0; i < uiNumBits; ++i, ++m_uiBit)
+      {
+        m_pTarget[m_uiBit >> 3] |= static_cast<ezUInt8>(((uiValue >> i) & 1u) << (m_uiBit & 7));
+      }
+    }
+
+    ezUInt8* m_pTarget;
+    ezUInt32 m_uiBit = 0;
+  };
+
+  ezSimdVec4f ToVector(ezInt32 r, ezInt32 g, ezInt32 b, ezInt32 a)
+  {
+    return ezSimdVec4f(static_cast<float>(r), static_cast<float>(g), static_cast<float>(b), static_cast<float>(a));
+  }
+
+  ezInt32 RoundAndClamp(float f, ezInt32 iMax)
+  {
+    return ezMath::Clamp(static_cast<ezInt32>(ezMath::Floor(f + 0.5f)), 0, iMax);
+  }
+
+  /// Computes the endpoints as the extents of the pixels along the axis of largest variance, which is found with a few power iterations.
+  void FitEndpoints(const ezSimdVec4f* pPixels, ezUInt32 uiNumPixels, ezSimdVec4f& out_vEndpoint0, ezSimdVec4f& out_vEndpoint1)
+  {
+    ezSimdVec4f vMin = pPixels[0];
+    ezSimdVec4f vMax = pPixels[0];
+    ezSimdVec4f vMean = ezSimdVec4f::ZeroVector();
+
+    for (ezUInt32 i = 0; i < uiNumPixels; ++i)
+    {
+      vMin = vMin.CompMin(pPixels[i]);
+      vMax = vMax.CompMax(pPixels[i]);
+      vMean += pPixels[i];
+    }
+
+    vMean /= ezSimdFloat(static_cast<float>(uiNumPixels));
+
+    ezSimdVec4f vAxis = vMax - vMin;
+    if (vAxis.IsZero<4>())
+    {
+      out_vEndpoint0 = vMean;
+      out_vEndpoint1 = vMean;
+      return;
+    }
+
+    for (ezUInt32 uiIteration = 0; uiIteration < 4; ++uiIteration)
+    {
+      ezSimdVec4f vNextAxis = ezSimdVec4f::ZeroVector();
+
+      for (ezUInt32 i = 0; i < uiNumPixels; ++i)
+      {
+        const ezSimdVec4f vDiff = pPixels[i] - vMean;
+        vNextAxis = ezSimdVec4f::MulAdd(vDiff, vDiff.Dot<4>(vAxis), vNextAxis);
+      }
+
+      if (vNextAxis.GetLengthSquared<4>() < 1e-6f)
+        break;
+
+      vAxis = vNextAxis;
+      vAxis.Normalize<4>();
+    }
+
+    vAxis.NormalizeIfNotZero<4>();
+
+    ezSimdFloat fMin(ezMath::MaxValue<float>());
+    ezSimdFloat fMax(-ezMath::MaxValue<float>());
+
+    for (ezUInt32 i = 0; i < uiNumPixels; ++i)
+    {
+      const ezSimdFloat t = (pPixels[i] - vMean).Dot<4>(vAxis);
+      fMin = fMin.Min(t);
+      fMax = fMax.Max(t);
+    }
+
+    out_vEndpoint0 = ezSimdVec4f::MulAdd(vAxis, fMin, vMean);
+    out_vEndpoint1 = ezSimdVec4f::MulAdd(vAxis, fMax, vMean);
+  }
+
+  /// Computes the endpoints that minimize the squared error when every pixel is interpolated with the given weight between them.
+  /// Returns false if the weights don't determine the endpoints, e.g. when all pixels use the same palette entry.
+  bool RefineEndpoints(const ezSimdVec4f* pPixels, const float* pWeights, ezUInt32 uiNumPixels, ezSimdVec4f& out_vEndpoint0, ezSimdVec4f& out_vEndpoint1)
+  {
+    float fA = 0.0f;
+    float fB = 0.0f;
+    float fC = 0.0f;
+    ezSimdVec4f vX0 = ezSimdVec4f::ZeroVector();
+    ezSimdVec4f vX1 = ezSimdVec4f::ZeroVector();
+
+    for (ezUInt32 i = 0; i < uiNumPixels; ++i)
+    {
+      const float t = pWeights[i];
+      const float s = 1.0f - t;
+
+      fA += s * s;
+      fB += s * t;
+      fC += t * t;
+      vX0 = ezSimdVec4f::MulAdd(pPixels[i], ezSimdFloat(s), vX0);
+      vX1 = ezSimdVec4f::MulAdd(pPixels[i], ezSimdFloat(t), vX1);
+    }
+
+    const float fDet = fA * fC - fB * fB;
+    if (ezMath::Abs(fDet) < 1e-4f)
+      return false;
+
+    const ezSimdFloat fInvDet(1.0f / fDet);
+    out_vEndpoint0 = (vX0 * ezSimdFloat(fC) - vX1 * ezSimdFloat(fB)) * fInvDet;
+    out_vEndpoint1 = (vX1 * ezSimdFloat(fA) - vX0 * ezSimdFloat(fB)) * fInvDet;
+    return true;
+  }
+
+  /// Picks the closest palette entry for every pixel and returns the summed squared error.
+  float AssignIndices(const ezSimdVec4f* pPixels, ezUInt32 uiNumPixels, const ezSimdVec4f* pPalette, ezUInt32 uiPaletteSize, ezUInt8* out_pIndices)
+  {
+    float fError = 0.0f;
+
+    for (ezUInt32 i = 0; i < uiNumPixels; ++i)
+    {
+      ezSimdFloat fBestDistance = (pPixels[i] - pPalette[0]).GetLengthSquared<4>();
+      ezUInt8 uiBestIndex = 0;
+
+      for (ezUInt32 p = 1; p < uiPaletteSize; ++p)
+      {
+        const ezSimdFloat fDistance = (pPixels[i] - pPalette[p]).GetLengthSquared<4>();
+        if (fDistance < fBestDistance)
+        {
+          fBestDistance = fDistance;
+          uiBestIndex = static_cast<ezUInt8>(p);
+        }
+      }
+
+      out_pIndices[i] = uiBestIndex;
+      fError += static_cast<float>(fBestDistance);
+    }
+
+    return fError;
+  }
+
+  /// Interpolates between two endpoints with a weight in [0; 64], like the BC6H and BC7 decoders.
+  ezSimdVec4f InterpolateBC67(const ezInt32* pEndpoint0, const ezInt32* pEndpoint1, ezInt32 iWeight)
+  {
+    ezInt32 result[4];
+    for (ezUInt32 c = 0; c < 4; ++c)
+    {
+      result[c] = ((64 - iWeight) * pEndpoint0[c] + iWeight * pEndpoint1[c] + 32) >> 6;
+    }
+
+    return ToVector(result[0], result[1], result[2], result[3]);
+  }
+
+  ezUInt32 GatherSubset(const ezSimdVec4f* pPixels, ezUInt32 uiNumSubsets, ezUInt32 uiShape, ezUInt32 uiSubset, ezSimdVec4f* out_pPixels, ezUInt8* out_pPositions)
+  {
+    const ezUInt8* pPartition = ezInternal::s_bc67PartitionTable[uiNumSubsets - 1][uiShape];
+    ezUInt32 uiNumPixels = 0;
+
+    for (ezUInt32 i = 0; i < s_uiNumPixelsPerBlock; ++i)
+    {
+      if (pPartition[i] == uiSubset)
+      {
+        out_pPixels[uiNumPixels] = pPixels[i];
+        out_pPositions[uiNumPixels] = static_cast<ezUInt8>(i);
+        ++uiNumPixels;
+      }
+    }
+
+    return uiNumPixels;
+  }
+
+  /// Estimates how well a partition fits the block by the distance of the pixels to the principal axis of their subset.
+  /// This ignores quantization, but is a lot cheaper than encoding every partition.
+  float EstimatePartitionError(const ezSimdVec4f* pPixels, ezUInt32 uiNumSubsets, ezUInt32 uiShape)
+  {
+    ezSimdFloat fError = ezSimdFloat::Zero();
+
+    for (ezUInt32 uiSubset = 0; uiSubset < uiNumSubsets; ++uiSubset)
+    {
+      ezSimdVec4f subsetPixels[s_uiNumPixelsPerBlock];
+      ezUInt8 positions[s_uiNumPixelsPerBlock];
+      const ezUInt32 uiNumPixels = GatherSubset(pPixels, uiNumSubsets, uiShape, uiSubset, subsetPixels, positions);
+
+      ezSimdVec4f vEndpoint0, vEndpoint1;
+      FitEndpoints(subsetPixels, uiNumPixels, vEndpoint0, vEndpoint1);
+
+      ezSimdVec4f vAxis = vEndpoint1 - vEndpoint0;
+      vAxis.NormalizeIfNotZero<4>();
+
+      for (ezUInt32 i = 0; i < uiNumPixels; ++i)
+      {
+        const ezSimdVec4f vDiff = subsetPixels[i] - vEndpoint0;
+        const ezSimdFloat fAlongAxis = vDiff.Dot<4>(vAxis);
+        fError += vDiff.GetLengthSquared<4>() - fAlongAxis * fAlongAxis;
+      }
+    }
+
+    return fError;
+  }
+
+  constexpr ezUInt32 s_uiMaxCandidatePartitions = 4;
+
+  /// Returns the partitions with the lowest estimated error, sorted by their error.
+  ezUInt32 FindBestPartitions(const ezSimdVec4f* pPixels, ezUInt32 uiNumSubsets, ezUInt32 uiNumShapes, ezUInt32 uiNumCandidates, ezUInt32* out_pShapes, float* out_pErrors)
+  {
+    EZ_ASSERT_DEBUG(uiNumCandidates <= s_uiMaxCandidatePartitions, "Too many candidate partitions");
+
+    ezUInt32 uiNumFound = 0;
+
+    for (ezUInt32 uiShape = 0; uiShape < uiNumShapes; ++uiShape)
+    {
+      const float fError = EstimatePartitionError(pPixels, uiNumSubsets, uiShape);
+
+      ezUInt32 uiPos = uiNumFound;
+      while (uiPos > 0 && out_pErrors[uiPos - 1] > fError)
+      {
+        if (uiPos < uiNumCandidates)
+        {
+          out_pShapes[uiPos] = out_pShapes[uiPos - 1];
+          out_pErrors[uiPos] = out_pErrors[uiPos - 1];
+        }
+        --uiPos;
+      }
+
+      if (uiPos < uiNumCandidates)
+      {
+        out_pShapes[uiPos] = uiShape;
+        out_pErrors[uiPos] = fError;
+        uiNumFound = ezMath::Min(uiNumFound + 1, uiNumCandidates);
+      }
+    }
+
+    return uiNumFound;
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // BC1
+
+  ezUInt16 QuantizeB5G6R5(const ezSimdVec4f& vColor)
+  {
+    float f[4];
+    vColor.Store<4>(f);
+
+    const ezInt32 r = RoundAndClamp(f[0] * (31.0f / 255.0f), 31);
+    const ezInt32 g = RoundAndClamp(f[1] * (63.0f / 255.0f), 63);
+    const ezInt32 b = RoundAndClamp(f[2] * (31.0f / 255.0f), 31);
+    return static_cast<ezUInt16>((r << 11) | (g << 5) | b);
+  }
+
+  /// Builds the palette exactly like ezDecompressBlockBC1 and returns the number of distinct opaque entries.
+  ezUInt32 GetPaletteBC1(ezUInt16 uiColor0, ezUInt16 uiColor1, bool bFourColorMode, ezSimdVec4f* out_pPalette)
+  {
+    const ezColorBaseUB c0 = ezDecompressB5G6R5(uiColor0);
+    const ezColorBaseUB c1 = ezDecompressB5G6R5(uiColor1);
+
+    out_pPalette[0] = ToVector(c0.r, c0.g, c0.b, 0);
+    out_pPalette[1] = ToVector(c1.r, c1.g, c1.b, 0);
+
+    if (uiColor0 == uiColor1)
+      return 1;
+
+    if (bFourColorMode)
+    {
+      out_pPalette[2] = ToVector((2 * c0.r + c1.r + 1) / 3, (2 * c0.g + c1.g + 1) / 3, (2 * c0.b + c1.b + 1) / 3, 0);
+      out_pPalette[3] = ToVector((c0.r + 2 * c1.r + 1) / 3, (c0.g + 2 * c1.g + 1) / 3, (c0.b + 2 * c1.b + 1) / 3, 0);
+      return 4;
+    }
+
+    // index 3 is transparent black
+    out_pPalette[2] = ToVector((c0.r + c1.r) / 2, (c0.g + c1.g) / 2, (c0.b + c1.b) / 2, 0);
+    return 3;
+  }
+
+  /// Encodes the color part of a BC1, BC2 or BC3 block. With punch through alpha, transparent pixels force the three color mode.
+  void CompressColorBlock(const ezColorBaseUB* pSource, ezUInt8* pTarget, bool bPunchThroughAlpha, ezBlockCompressionQuality::Enum quality)
+  {
+    static const float s_fFourColorWeights[] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+    static const float s_fThreeColorWeights[] = {0.0f, 1.0f, 0.5f, 0.0f};
+
+    ezSimdVec4f pixels[s_uiNumPixelsPerBlock];
+    ezUInt8 pixelPositions[s_uiNumPixelsPerBlock];
+    ezUInt32 uiNumPixels = 0;
+
+    for (ezUInt32 i = 0; i < s_uiNumPixelsPerBlock; ++i)
+    {
+      if (!bPunchThroughAlpha || pSource[i].a >= 128)
+      {
+        pixels[uiNumPixels] = ToVector(pSource[i].r, pSource[i].g, pSource[i].b, 0);
+        pixelPositions[uiNumPixels] = static_cast<ezUInt8>(i);
+        ++uiNumPixels;
+      }
+    }
+
+    ezUInt16 uiColor0 = 0;
+    ezUInt16 uiColor1 = 0;
+
+    // transparent pixels keep index 3
+    ezUInt32 uiIndexBits = 0xFFFFFFFFu;
+
+    if (uiNumPixels > 0)
+    {
+      const bool bFourColorMode = uiNumPixels == s_uiNumPixelsPerBlock;
+      const float* pWeights = bFourColorMode ? s_fFourColorWeights : s_fThreeColorWeights;
+
+      ezSimdVec4f vEndpoint0, vEndpoint1;
+      FitEndpoints(pixels, uiNumPixels, vEndpoint0, vEndpoint1);
+
+      float fBestError = ezMath::MaxValue<float>();
+      ezUInt8 bestIndices[s_uiNumPixelsPerBlock];
+
+      for (ezUInt32 uiStep = 0;; ++uiStep)
+      {
+        ezUInt16 uiQuantized0 = QuantizeB5G6R5(vEndpoint0);
+        ezUInt16 uiQuantized1 = QuantizeB5G6R5(vEndpoint1);
+
+        // the decoder selects the mode by comparing the endpoints
+        if (bFourColorMode ? uiQuantized0 < uiQuantized1 : uiQuantized0 > uiQuantized1)
+        {
+          ezMath::Swap(uiQuantized0, uiQuantized1);
+          ezMath::Swap(vEndpoint0, vEndpoint1);
+        }
+
+        ezSimdVec4f palette[4];
+        const ezUInt32 uiPaletteSize = GetPaletteBC1(uiQuantized0, uiQuantized1, bFourColorMode, palette);
+
+        ezUInt8 indices[s_uiNumPixelsPerBlock];
+        const float fError = AssignIndices(pixels, uiNumPixels, palette, uiPaletteSize, indices);
+
+        if (fError < fBestError)
+        {
+          fBestError = fError;
+          uiColor0 = uiQuantized0;
+          uiColor1 = uiQuantized1;
+          ezMemoryUtils::Copy(bestIndices, indices, uiNumPixels);
+        }
+
+        if (uiStep == s_uiRefinementSteps[quality] || fError == 0.0f)
+          break;
+
+        float weights[s_uiNumPixelsPerBlock];
+        for (ezUInt32 i = 0; i < uiNumPixels; ++i)
+        {
+          weights[i] = pWeights[indices[i]];
+        }
+
+        if (!RefineEndpoints(pixels, weights, uiNumPixels, vEndpoint0, vEndpoint1))
+          break;
+      }
+
+      for (ezUInt32 i = 0; i < uiNumPixels; ++i)
+      {
+        const ezUInt32 uiShift = 2 * pixelPositions[i];
+        uiIndexBits = (uiIndexBits & ~(3u << uiShift)) | (static_cast<ezUInt32>(bestIndices[i]) << uiShift);
+      }
+    }
+
+    pTarget[0] = static_cast<ezUInt8>(uiColor0 & 0xFF);
+    pTarget[1] = static_cast<ezUInt8>(uiColor0 >> 8);
+    pTarget[2] = static_cast<ezUInt8>(uiColor1 & 0xFF);
+    pTarget[3] = static_cast<ezUInt8>(uiColor1 >> 8);
+    pTarget[4] = static_cast<ezUInt8>(uiIndexBits >> 0);
+    pTarget[5] = static_cast<ezUInt8>(uiIndexBits >> 8);
+    pTarget[6] = static_cast<ezUInt8>(uiIndexBits >> 16);
+    pTarget[7] = static_cast<ezUInt8>(uiIndexBits >> 24);
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // BC4
+
+  ezUInt32 EvaluateBC4(ezUInt32 a0, ezUInt32 a1, const ezInt32* pValues, ezUInt8* out_pIndices)
+  {
+    ezUInt32 palette[8];
+    ezUnpackPaletteBC4(a0, a1, palette);
+
+    ezUInt32 uiError = 0;
+
+    for (ezUInt32 i = 0; i < s_uiNumPixelsPerBlock; ++i)
+    {
+      ezUInt32 uiBestDistance = 0xFFFFFFFFu;
+
+      for (ezUInt32 p = 0; p < 8; ++p)
+      {
+        const ezInt32 iDiff = pValues[i] - static_cast<ezInt32>(palette[p]);
+        const ezUInt32 uiDistance = static_cast<ezUInt32>(iDiff * iDiff);
+
+        if (uiDistance < uiBestDistance)
+        {
+          uiBestDistance = uiDistance;
+          out_pIndices[i] = static_cast<ezUInt8>(p);
+        }
+      }
+
+      uiError += uiBestDistance;
+    }
+
+    return uiError;
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // BC6H
+
+  ezInt32 UnquantizeBC6(ezInt32 iValue)
+  {
+    // same as bc6Unquantize for unsigned 10 bit endpoints
+    if (iValue == 0)
+      return 0;
+    if (iValue == 1023)
+      return 0xFFFF;
+    return ((iValue << 16) + 0x8000) >> 10;
+  }
+
+  ezInt32 QuantizeBC6(float fValue)
+  {
+    const ezInt32 iGuess = RoundAndClamp((fValue - 32.0f) / 64.0f, 1023);
+
+    ezInt32 iBest = iGuess;
+    float fBestDistance = ezMath::Abs(static_cast<float>(UnquantizeBC6(iGuess)) - fValue);
+
+    for (ezInt32 iCandidate = ezMath::Max(iGuess - 1, 0); iCandidate <= ezMath::Min(iGuess + 1, 1023); ++iCandidate)
+    {
+      const float fDistance = ezMath::Abs(static_cast<float>(UnquantizeBC6(iCandidate)) - fValue);
+      if (fDistance < fBestDistance)
+      {
+        fBestDistance = fDistance;
+        iBest = iCandidate;
+      }
+    }
+
+    return iBest;
+  }
+
+  /// Maps a half float to the unquantized integer domain in which the BC6H decoder interpolates.
+  /// The decoder scales the interpolated values by 31/64 to get the bits of the final half float.
+  float HalfToBC6Domain(ezFloat16 value)
+  {
+    ezUInt16 uiBits = value.GetRawData();
+
+    if (uiBits & 0x8000u)
+    {
+      // negative values can't be represented in the unsigned format
+      uiBits = 0;
+    }
+    else if ((uiBits & 0x7C00u) == 0x7C00u)
+    {
+      // clamp infinity to the largest finite value, NaN becomes zero
+      uiBits = (uiBits & 0x03FFu) ? 0 : 0x7BFFu;
+    }
+
+    return static_cast<float>(uiBits) * (64.0f / 31.0f);
+  }
+
+  /// Mode 11: a single region with 10 bit endpoints and 4 bit indices. It has no delta encoding, so it can represent any block.
+  float CompressBlockBC6Mode11(const ezSimdVec4f* pPixels, ezBlockCompressionQuality::Enum quality, ezUInt8* pTarget)
+  {
+    ezSimdVec4f vEndpoint0, vEndpoint1;
+    FitEndpoints(pPixels, s_uiNumPixelsPerBlock, vEndpoint0, vEndpoint1);
+
+    float fBestError = ezMath::MaxValue<float>();
+    ezInt32 bestEndpoints[2][4] = {};
+    ezUInt8 bestIndices[s_uiNumPixelsPerBlock];
+
+    for (ezUInt32 uiStep = 0;; ++uiStep)
+    {
+      float f0[4], f1[4];
+      vEndpoint0.Store<4>(f0);
+      vEndpoint1.Store<4>(f1);
+
+      ezInt32 endpoints[2][4] = {};
+      ezInt32 unquantized[2][4] = {};
+      for (ezUInt32 c = 0; c < 3; ++c)
+      {
+        endpoints[0][c] = QuantizeBC6(f0[c]);
+        endpoints[1][c] = QuantizeBC6(f1[c]);
+        unquantized[0][c] = UnquantizeBC6(endpoints[0][c]);
+        unquantized[1][c] = UnquantizeBC6(endpoints[1][c]);
+      }
+
+      ezSimdVec4f palette[16];
+      for (ezUInt32 p = 0; p < 16; ++p)
+      {
+        palette[p] = InterpolateBC67(unquantized[0], unquantized[1], s_iBC67Weights4[p]);
+      }
+
+      ezUInt8 indices[s_uiNumPixelsPerBlock];
+      const float fError = AssignIndices(pPixels, s_uiNumPixelsPerBlock, palette, 16, indices);
+
+      if (fError < fBestError)
+      {
+        fBestError = fError;
+        ezMemoryUtils::Copy(&bestEndpoints[0][0], &endpoints[0][0], 8);
+        ezMemoryUtils::Copy(bestIndices, indices, s_uiNumPixelsPerBlock);
+      }
+
+      if (uiStep == s_uiRefinementSteps[quality] || fError == 0.0f)
+        break;
+
+      float weights[s_uiNumPixelsPerBlock];
+      for (ezUInt32 i = 0; i < s_uiNumPixelsPerBlock; ++i)
+      {
+        weights[i] = s_iBC67Weights4[indices[i]] / 64.0f;
+      }
+
+      if (!RefineEndpoints(pPixels, weights, s_uiNumPixelsPerBlock, vEndpoint0, vEndpoint1))
+        break;
+    }
+
+    if (bestIndices[0] >= 8)
+    {
+      for (ezUInt32 c = 0; c < 3; ++c)
+      {
+        ezMath::Swap(bestEndpoints[0][c], bestEndpoints[1][c]);
+      }
+
+      for (ezUInt32 i = 0; i < s_uiNumPixelsPerBlock; ++i)
+      {
+        bestIndices[i] = static_cast<ezUInt8>(15 - bestIndices[i]);
+      }
+    }
+
+    BitWriter writer(pTarget);
+    writer.Write(0x03, 5);
+
+    for (ezUInt32 e = 0; e < 2; ++e)
+    {
+      for (ezUInt32 c = 0; c < 3; ++c)
+      {
+        writer.Write(bestEndpoints[e][c], 10);
+      }
+    }
+
+    for (ezUInt32 i = 0; i < s_uiNumPixelsPerBlock; ++i)
+    {
+      writer.Write(bestIndices[i], i == 0 ? 3 : 4);
+    }
+
+    return fBestError;
+  }
+
+  /// The order of the header bits of BC6H mode 1, see s_bc6ModeDescs in DXTConversions.cpp. W and X are the endpoints of the first region,
+  /// Y and Z those of the second one.
+  struct BC6Mode1Header
+  {
+    enum Field : ezUInt8
+    {
+      RW, GW, BW, RX, GX, BX, RY, GY, BY, RZ, GZ, BZ, M, D
+    };
+
+    static constexpr ezUInt8 s_Layout[82][2] = {
+      {M, 0},  {M, 1},  {GY, 4}, {BY, 4}, {BZ, 4}, {RW, 0}, {RW, 1}, {RW, 2}, {RW, 3}, {RW, 4}, {RW, 5}, {RW, 6}, {RW, 7}, {RW, 8},
+      {RW, 9}, {GW, 0}, {GW, 1}, {GW, 2}, {GW, 3}, {GW, 4}, {GW, 5}, {GW, 6}, {GW, 7}, {GW, 8}, {GW, 9}, {BW, 0}, {BW, 1}, {BW, 2},
+      {BW, 3}, {BW, 4}, {BW, 5}, {BW, 6}, {BW, 7}, {BW, 8}, {BW, 9}, {RX, 0}, {RX, 1}, {RX, 2}, {RX, 3}, {RX, 4}, {GZ, 4}, {GY, 0},
+      {GY, 1}, {GY, 2}, {GY, 3}, {GX, 0}, {GX, 1}, {GX, 2}, {GX, 3}, {GX, 4}, {BZ, 0}, {GZ, 0}, {GZ, 1}, {GZ, 2}, {GZ, 3}, {BX, 0},
+      {BX, 1}, {BX, 2}, {BX, 3}, {BX, 4}, {BZ, 1}, {BY, 0}, {BY, 1}, {BY, 2}, {BY, 3}, {RY, 0}, {RY, 1}, {RY, 2}, {RY, 3}, {RY, 4},
+      {BZ, 2}, {RZ, 0}, {RZ, 1}, {RZ, 2}, {RZ, 3}, {RZ, 4}, {BZ, 3}, {D, 0},  {D, 1},  {D, 2},  {D, 3},  {D, 4},
+    };
+  };
+
+  /// Mode 1: two regions, the first endpoint is stored with 10 bits and the other three as signed 5 bit deltas to it.
+  /// Endpoints that are too far from the first one are clamped, so the returned error always matches the encoded block.
+  float CompressBlockBC6Mode1(const ezSimdVec4f* pPixels, ezUInt32 uiShape, ezBlockCompressionQuality::Enum quality, ezUInt8* pTarget)
+  {
+    const ezUInt8* pPartition = ezInternal::s_bc67PartitionTable[1][uiShape];
+    const ezUInt32 uiAnchor1 = ezInternal::s_bc67FixUp[1][uiShape][1];
+
+    ezSimdVec4f regionPixels[2][s_uiNumPixelsPerBlock];
+    ezUInt8 positions[2][s_uiNumPixelsPerBlock];
+    ezUInt32 uiNumPixels[2];
+    ezSimdVec4f vEndpoints[2][2];
+
+    for (ezUInt32 r = 0; r < 2; ++r)
+    {
+      uiNumPixels[r] = GatherSubset(pPixels, 2, uiShape, r, regionPixels[r], positions[r]);
+      FitEndpoints(regionPixels[r], uiNumPixels[r], vEndpoints[r][0], vEndpoints[r][1]);
+    }
+
+    float fBestError = ezMath::MaxValue<float>();
+    ezInt32 bestEndpoints[4][3] = {};
+    ezUInt8 bestIndices[s_uiNumPixelsPerBlock] = {};
+
+    for (ezUInt32 uiStep = 0;; ++uiStep)
+    {
+      // endpoints in the order W, X, Y, Z
+      ezInt32 endpoints[4][3];
+      for (ezUInt32 e = 0; e < 4; ++e)
+      {
+        float f[4];
+        vEndpoints[e / 2][e % 2].Store<4>(f);
+
+        for (ezUInt32 c = 0; c < 3; ++c)
+        {
+          endpoints[e][c] = QuantizeBC6(f[c]);
+
+          if (e > 0)
+          {
+            endpoints[e][c] = ezMath::Clamp(endpoints[e][c], ezMath::Max(endpoints[0][c] - 16, 0), ezMath::Min(endpoints[0][c] + 15, 1023));
+          }
+        }
+      }
+
+      float fError = 0.0f;
+      ezUInt8 indices[2][s_uiNumPixelsPerBlock];
+
+      for (ezUInt32 r = 0; r < 2; ++r)
+      {
+        ezInt32 unquantized[2][4] = {};
+        for (ezUInt32 c = 0; c < 3; ++c)
+        {
+          unquantized[0][c] = UnquantizeBC6(endpoints[2 * r][c]);
+          unquantized[1][c] = UnquantizeBC6(endpoints[2 * r + 1][c]);
+        }
+
+        ezSimdVec4f palette[8];
+        for (ezUInt32 p = 0; p < 8; ++p)
+        {
+          palette[p] = InterpolateBC67(unquantized[0], unquantized[1], s_iBC67Weights3[p]);
+        }
+
+        fError += AssignIndices(regionPixels[r], uiNumPixels[r], palette, 8, indices[r]);
+      }
+
+      if (fError < fBestError)
+      {
+        fBestError = fError;
+        ezMemoryUtils::Copy(&bestEndpoints[0][0], &endpoints[0][0], 12);
+
+        for (ezUInt32 r = 0; r < 2; ++r)
+        {
+          for (ezUInt32 i = 0; i < uiNumPixels[r]; ++i)
+          {
+            bestIndices[positions[r][i]] = indices[r][i];
+          }
+        }
+      }
+
+      if (uiStep == s_uiRefinementSteps[quality] || fError == 0.0f)
+        break;
+
+      for (ezUInt32 r = 0; r < 2; ++r)
+      {
+        float weights[s_uiNumPixelsPerBlock];
+        for (ezUInt32 i = 0; i < uiNumPixels[r]; ++i)
+        {
+          weights[i] = s_iBC67Weights3[indices[r][i]] / 64.0f;
+        }
+
+        RefineEndpoints(regionPixels[r], weights, uiNumPixels[r], vEndpoints[r][0], vEndpoints[r][1]);
+      }
+    }
+
+    // the anchor indices have no most significant bit, swapping the endpoints of a region inverts its indices
+    for (ezUInt32 r = 0; r < 2; ++r)
+    {
+      if (bestIndices[r == 0 ? 0 : uiAnchor1] < 4)
+        continue;
+
+      for (ezUInt32 c = 0; c < 3; ++c)
+      {
+        ezMath::Swap(bestEndpoints[2 * r][c], bestEndpoints[2 * r + 1][c]);
+      }
+
+      for (ezUInt32 i = 0; i < s_uiNumPixelsPerBlock; ++i)
+      {
+        if (pPartition[i] == r)
+        {
+          bestIndices[i] = static_cast<ezUInt8>(7 - bestIndices[i]);
+        }
+      }
+    }
+
+    // swapping the first region changes the base endpoint, which may not leave the deltas in range
+    ezInt32 fields[BC6Mode1Header::M + 1] = {};
+    for (ezUInt32 e = 0; e < 4; ++e)
+    {
+      for (ezUInt32 c = 0; c < 3; ++c)
+      {
+        const ezInt32 iValue = e == 0 ? bestEndpoints[0][c] : bestEndpoints[e][c] - bestEndpoints[0][c];
+        if (e > 0 && (iValue < -16 || iValue > 15))
+          return ezMath::MaxValue<float>();
+
+        fields[3 * e + c] = iValue;
+      }
+    }
+
+    BitWriter writer(pTarget);
+
+    for (const ezUInt8* pBit : BC6Mode1Header::s_Layout)
+    {
+      const ezInt32 iValue = pBit[0] == BC6Mode1Header::D ? static_cast<ezInt32>(uiShape) : fields[pBit[0]];
+      writer.Write(static_cast<ezUInt32>(iValue >> pBit[1]) & 1u, 1);
+    }
+
+    for (ezUInt32 i = 0; i < s_uiNumPixelsPerBlock; ++i)
+    {
+      writer.Write(bestIndices[i], (i == 0 || i == uiAnchor1) ? 2 : 3);
+    }
+
+    return fBestError;
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // BC7
+
+  /// Describes the BC7 modes that interpolate all channels with the same indices, which are all modes except 4 and 5.
+  struct BC7ModeDesc
+  {
+    ezUInt8 m_uiMode;
+    ezUInt8 m_uiNumSubsets;
+    ezUInt8 m_uiPartitionBits;
+    ezUInt8 m_uiColorBits;      ///< Without the p-bit.
+    ezUInt8 m_uiAlphaBits;      ///< Zero for the modes that always decode alpha as 255.
+    ezUInt8 m_uiPBitsPerSubset; ///< Zero, one p-bit that is shared by both endpoints or one p-bit per endpoint.
+    ezUInt8 m_uiIndexBits;
+  };
+
+  constexpr BC7ModeDesc s_BC7Mode0 = {0, 3, 4, 4, 0, 2, 3};
+  constexpr BC7ModeDesc s_BC7Mode1 = {1, 2, 6, 6, 0, 1, 3};
+  constexpr BC7ModeDesc s_BC7Mode2 = {2, 3, 6, 5, 0, 0, 2};
+  constexpr BC7ModeDesc s_BC7Mode3 = {3, 2, 6, 7, 0, 2, 2};
+  constexpr BC7ModeDesc s_BC7Mode6 = {6, 1, 0, 7, 7, 2, 4};
+  constexpr BC7ModeDesc s_BC7Mode7 = {7, 2, 6, 5, 5, 2, 2};
+
+  struct BC7Block
+  {
+    ezInt32 m_Endpoints[6][4] = {};
+    ezUInt32 m_PBits[6] = {};
+    ezUInt8 m_Indices[s_uiNumPixelsPerBlock] = {};
+  };
+
+  const ezInt32* GetBC67Weights(ezUInt32 uiIndexBits)
+  {
+    return uiIndexBits == 2 ? s_iBC67Weights2 : (uiIndexBits == 3 ? s_iBC67Weights3 : s_iBC67Weights4);
+  }
+
+  /// Quantizes one endpoint channel to uiBits bits and returns the value that bc7Unquantize in DXTConversions.cpp reconstructs from it.
+  ezInt32 QuantizeBC7(float fValue, ezUInt32 uiBits, bool bHasPBit, ezUInt32 uiPBit, ezInt32& out_iQuantized)
+  {
+    const ezUInt32 uiPrecision = bHasPBit ? uiBits + 1 : uiBits;
+    const float fScaled = fValue * static_cast<float>((1 << uiPrecision) - 1) / 255.0f;
+
+    out_iQuantized = RoundAndClamp(bHasPBit ? (fScaled - static_cast<float>(uiPBit)) * 0.5f : fScaled, (1 << uiBits) - 1);
+
+    ezInt32 iValue = bHasPBit ? (out_iQuantized << 1) | static_cast<ezInt32>(uiPBit) : out_iQuantized;
+    iValue <<= 8 - uiPrecision;
+    return iValue | (iValue >> uiPrecision);
+  }
+
+  /// Encodes the pixels of one subset and returns their squared error. All p-bit combinations are evaluated after every refinement step.
+  float CompressSubsetBC7(const ezSimdVec4f* pPixels, const ezUInt8* pPositions, ezUInt32 uiNumPixels, const BC7ModeDesc& mode, ezUInt32 uiSubset,
+    ezBlockCompressionQuality::Enum quality, BC7Block& inout_Block)
+  {
+    const ezInt32* pWeights = GetBC67Weights(mode.m_uiIndexBits);
+    const ezUInt32 uiPaletteSize = 1u << mode.m_uiIndexBits;
+    const ezUInt32 uiNumChannels = mode.m_uiAlphaBits > 0 ? 4 : 3;
+
+    ezSimdVec4f vEndpoint0, vEndpoint1;
+    FitEndpoints(pPixels, uiNumPixels, vEndpoint0, vEndpoint1);
+
+    float fBestError = ezMath::MaxValue<float>();
+
+    for (ezUInt32 uiStep = 0;; ++uiStep)
+    {
+      float f[2][4];
+      vEndpoint0.Store<4>(f[0]);
+      vEndpoint1.Store<4>(f[1]);
+
+      float fBestStepError = ezMath::MaxValue<float>();
+      ezUInt8 bestStepIndices[s_uiNumPixelsPerBlock];
+
+      for (ezUInt32 uiPBits = 0; uiPBits < (1u << mode.m_uiPBitsPerSubset); ++uiPBits)
+      {
+        ezInt32 endpoints[2][4] = {};
+        ezInt32 unquantized[2][4] = {{255, 255, 255, 255}, {255, 255, 255, 255}};
+        ezUInt32 pBits[2];
+
+        for (ezUInt32 e = 0; e < 2; ++e)
+        {
+          pBits[e] = mode.m_uiPBitsPerSubset == 2 ? (uiPBits >> e) & 1u : uiPBits;
+
+          for (ezUInt32 c = 0; c < uiNumChannels; ++c)
+          {
+            const ezUInt32 uiBits = c < 3 ? mode.m_uiColorBits : mode.m_uiAlphaBits;
+            unquantized[e][c] = QuantizeBC7(f[e][c], uiBits, mode.m_uiPBitsPerSubset > 0, pBits[e], endpoints[e][c]);
+          }
+        }
+
+        ezSimdVec4f palette[16];
+        for (ezUInt32 p = 0; p < uiPaletteSize; ++p)
+        {
+          palette[p] = InterpolateBC67(unquantized[0], unquantized[1], pWeights[p]);
+        }
+
+        ezUInt8 indices[s_uiNumPixelsPerBlock];
+        const float fError = AssignIndices(pPixels, uiNumPixels, palette, uiPaletteSize, indices);
+
+        if (fError < fBestStepError)
+        {
+          fBestStepError = fError;
+          ezMemoryUtils::Copy(bestStepIndices, indices, uiNumPixels);
+        }
+
+        if (fError < fBestError)
+        {
+          fBestError = fError;
+
+          for (ezUInt32 e = 0; e < 2; ++e)
+          {
+            ezMemoryUtils::Copy(inout_Block.m_Endpoints[2 * uiSubset + e], endpoints[e], 4);
+            inout_Block.m_PBits[2 * uiSubset + e] = pBits[e];
+          }
+
+          for (ezUInt32 i = 0; i < uiNumPixels; ++i)
+          {
+            inout_Block.m_Indices[pPositions[i]] = indices[i];
+          }
+        }
+      }
+
+      if (uiStep == s_uiRefinementSteps[quality] || fBestStepError == 0.0f)
+        break;
+
+      float weights[s_uiNumPixelsPerBlock];
+      for (ezUInt32 i = 0; i < uiNumPixels; ++i)
+      {
+        weights[i] = pWeights[bestStepIndices[i]] / 64.0f;
+      }
+
+      if (!RefineEndpoints(pPixels, weights, uiNumPixels, vEndpoint0, vEndpoint1))
+        break;
+    }
+
+    return fBestError;
+  }
+
+  void WriteBlockBC7(const BC7ModeDesc& mode, ezUInt32 uiShape, BC7Block& block, ezUInt8* pTarget)
+  {
+    const ezUInt8* pPartition = ezInternal::s_bc67PartitionTable[mode.m_uiNumSubsets - 1][uiShape];
+    const ezUInt8* pAnchors = ezInternal::s_bc67FixUp[mode.m_uiNumSubsets - 1][uiShape];
+    const ezUInt32 uiMaxIndex = (1u << mode.m_uiIndexBits) - 1;
+    const ezUInt32 uiNumEndpoints = 2 * mode.m_uiNumSubsets;
+
+    // the index of an anchor pixel has no most significant bit, the weights are symmetric so swapping the endpoints inverts the indices
+    for (ezUInt32 uiSubset = 0; uiSubset < mode.m_uiNumSubsets; ++uiSubset)
+    {
+      if (block.m_Indices[pAnchors[uiSubset]] <= uiMaxIndex / 2)
+        continue;
+
+      for (ezUInt32 c = 0; c < 4; ++c)
+      {
+        ezMath::Swap(block.m_Endpoints[2 * uiSubset][c], block.m_Endpoints[2 * uiSubset + 1][c]);
+      }
+
+      ezMath::Swap(block.m_PBits[2 * uiSubset], block.m_PBits[2 * uiSubset + 1]);
+
+      for (ezUInt32 i = 0; i < s_uiNumPixelsPerBlock; ++i)
+      {
+        if (pPartition[i] == uiSubset)
+        {
+          block.m_Indices[i] = static_cast<ezUInt8>(uiMaxIndex - block.m_Indices[i]);
+        }
+      }
+    }
+
+    BitWriter writer(pTarget);
+    writer.Write(1u << mode.m_uiMode, mode.m_uiMode + 1);
+    writer.Write(uiShape, mode.m_uiPartitionBits);
+
+    for (ezUInt32 c = 0; c < (mode.m_uiAlphaBits > 0 ? 4u : 3u); ++c)
+    {
+      for (ezUInt32 e = 0; e < uiNumEndpoints; ++e)
+      {
+        writer.Write(block.m_Endpoints[e][c], c < 3 ? mode.m_uiColorBits : mode.m_uiAlphaBits);
+      }
+    }
+
+    // shared p-bits are stored once per subset
+    for (ezUInt32 e = 0; e < uiNumEndpoints && mode.m_uiPBitsPerSubset > 0; e += 3 - mode.m_uiPBitsPerSubset)
+    {
+      writer.Write(block.m_PBits[e], 1);
+    }
+
+    for (ezUInt32 i = 0; i < s_uiNumPixelsPerBlock; ++i)
+    {
+      bool bIsAnchor = false;
+      for (ezUInt32 uiSubset = 0; uiSubset < mode.m_uiNumSubsets; ++uiSubset)
+      {
+        bIsAnchor = bIsAnchor || pAnchors[uiSubset] == i;
+      }
+
+      writer.Write(block.m_Indices[i], bIsAnchor ? mode.m_uiIndexBits - 1 : mode.m_uiIndexBits);
+    }
+  }
+
+  float CompressBlockBC7(const ezSimdVec4f* pPixels, const BC7ModeDesc& mode, ezUInt32 uiShape, ezBlockCompressionQuality::Enum quality, ezUInt8* pTarget)
+  {
+    BC7Block block;
+    float fError = 0.0f;
+
+    for (ezUInt32 uiSubset = 0; uiSubset < mode.m_uiNumSubsets; ++uiSubset)
+    {
+      ezSimdVec4f subsetPixels[s_uiNumPixelsPerBlock];
+      ezUInt8 positions[s_uiNumPixelsPerBlock];
+      const ezUInt32 uiNumPixels = GatherSubset(pPixels, mode.m_uiNumSubsets, uiShape, uiSubset, subsetPixels, positions);
+
+      fError += CompressSubsetBC7(subsetPixels, positions, uiNumPixels, mode, uiSubset, quality, block);
+    }
+
+    WriteBlockBC7(mode, uiShape, block, pTarget);
+    return fError;
+  }
+
+  /// Fully encodes the partitions with the lowest estimated error and keeps the result if it is better than the current block.
+  void TryPartitionedModeBC7(const ezSimdVec4f* pPixels, const BC7ModeDesc& mode, ezUInt32 uiNumCandidates, ezBlockCompressionQuality::Enum quality,
+    ezUInt8* pTarget, float& inout_fBestError)
+  {
+    ezUInt32 candidateShapes[s_uiMaxCandidatePartitions];
+    float candidateErrors[s_uiMaxCandidatePartitions];
+    const ezUInt32 uiNumFound = FindBestPartitions(pPixels, mode.m_uiNumSubsets, 1u << mode.m_uiPartitionBits, uiNumCandidates, candidateShapes, candidateErrors);
+
+    for (ezUInt32 i = 0; i < uiNumFound; ++i)
+    {
+      if (candidateErrors[i] >= inout_fBestError)
+        break;
+
+      ezUInt8 candidate[16];
+      const float fError = CompressBlockBC7(pPixels, mode, candidateShapes[i], quality, candidate);
+
+      if (fError < inout_fBestError)
+      {
+        inout_fBestError = fError;
+        ezMemoryUtils::Copy(pTarget, candidate, 16);
+      }
+    }
+  }
+
+  /// Mode 5: RGB with 7 bit endpoints and a separate 8 bit alpha channel, each with their own 2 bit indices.
+  /// The rotation swaps one of the color channels with alpha, which helps blocks where that channel doesn't correlate with the others.
+  float CompressBlockBC7Mode5(const ezColorBaseUB* pSource, ezUInt32 uiRotation, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality)
+  {
+    ezSimdVec4f colors[s_uiNumPixelsPerBlock];
+    ezInt32 alphas[s_uiNumPixelsPerBlock];
+
+    for (ezUInt32 i = 0; i < s_uiNumPixelsPerBlock; ++i)
+    {
+      ezColorBaseUB pixel = pSource[i];
+      if (uiRotation > 0)
+      {
+        ezMath::Swap(pixel.GetData()[uiRotation - 1], pixel.a);
+      }
+
+      colors[i] = ToVector(pixel.r, pixel.g, pixel.b, 0);
+      alphas[i] = pixel.a;
+    }
+
+    // color
+    ezSimdVec4f vEndpoint0, vEndpoint1;
+    FitEndpoints(colors, s_uiNumPixelsPerBlock, vEndpoint0, vEndpoint1);
+
+    float fBestColorError = ezMath::MaxValue<float>();
+    ezInt32 bestColorEndpoints[2][4] = {};
+    ezUInt8 bestColorIndices[s_uiNumPixelsPerBlock];
+
+    for (ezUInt32 uiStep = 0;; ++uiStep)
+    {
+      float f0[4], f1[4];
+      vEndpoint0.Store<4>(f0);
+      vEndpoint1.Store<4>(f1);
+
+      ezInt32 endpoints[2][4] = {};
+      ezInt32 unquantized[2][4] = {};
+      for (ezUInt32 c = 0; c < 3; ++c)
+      {
+        endpoints[0][c] = RoundAndClamp(f0[c] * (127.0f / 255.0f), 127);
+        endpoints[1][c] = RoundAndClamp(f1[c] * (127.0f / 255.0f), 127);
+        unquantized[0][c] = (endpoints[0][c] << 1) | (endpoints[0][c] >> 6);
+        unquantized[1][c] = (endpoints[1][c] << 1) | (endpoints[1][c] >> 6);
+      }
+
+      ezSimdVec4f palette[4];
+      for (ezUInt32 p = 0; p < 4; ++p)
+      {
+        palette[p] = InterpolateBC67(unquantized[0], unquantized[1], s_iBC67Weights2[p]);
+      }
+
+      ezUInt8 indices[s_uiNumPixelsPerBlock];
+      const float fError = AssignIndices(colors, s_uiNumPixelsPerBlock, palette, 4, indices);
+
+      if (fError < fBestColorError)
+      {
+        fBestColorError = fError;
+        ezMemoryUtils::Copy(&bestColorEndpoints[0][0], &endpoints[0][0], 8);
+        ezMemoryUtils::Copy(bestColorIndices, indices, s_uiNumPixelsPerBlock);
+      }
+
+      if (uiStep == s_uiRefinementSteps[quality] || fError == 0.0f)
+        break;
+
+      float weights[s_uiNumPixelsPerBlock];
+      for (ezUInt32 i = 0; i < s_uiNumPixelsPerBlock; ++i)
+      {
+        weights[i] = s_iBC67Weights2[indices[i]] / 64.0f;
+      }
+
+      if (!RefineEndpoints(colors, weights, s_uiNumPixelsPerBlock, vEndpoint0, vEndpoint1))
+        break;
+    }
+
+    // alpha, the 8 bit endpoints can represent the extents exactly
+    ezInt32 alphaEndpoints[2] = {255, 0};
+    for (ezUInt32 i = 0; i < s_uiNumPixelsPerBlock; ++i)
+    {
+      alphaEndpoints[0] = ezMath::Min(alphaEndpoints[0], alphas[i]);
+      alphaEndpoints[1] = ezMath::Max(alphaEndpoints[1], alphas[i]);
+    }
+
+    ezInt32 alphaPalette[4];
+    for (ezUInt32 p = 0; p < 4; ++p)
+    {
+      alphaPalette[p] = ((64 - s_iBC67Weights2[p]) * alphaEndpoints[0] + s_iBC67Weights2[p] * alphaEndpoints[1] + 32) >> 6;
+    }
+
+    float fAlphaError = 0.0f;
+    ezUInt8 alphaIndices[s_uiNumPixelsPerBlock];
+    for (ezUInt32 i = 0; i < s_uiNumPixelsPerBlock; ++i)
+    {
+      ezInt32 iBestDistance = 0x7FFFFFFF;
+      for (ezUInt32 p = 0; p < 4; ++p)
+      {
+        const ezInt32 iDistance = (alphas[i] - alphaPalette[p]) * (alphas[i] - alphaPalette[p]);
+        if (iDistance < iBestDistance)
+        {
+          iBestDistance = iDistance;
+          alphaIndices[i] = static_cast<ezUInt8>(p);
+        }
+      }
+
+      fAlphaError += static_cast<float>(iBestDistance);
+    }
+
+    // both index sets have an anchor at the first pixel
+    if (bestColorIndices[0] >= 2)
+    {
+      for (ezUInt32 c = 0; c < 3; ++c)
+      {
+        ezMath::Swap(bestColorEndpoints[0][c], bestColorEndpoints[1][c]);
+      }
+
+      for (ezUInt32 i = 0; i < s_uiNumPixelsPerBlock; ++i)
+      {
+        bestColorIndices[i] = static_cast<ezUInt8>(3 - bestColorIndices[i]);
+      }
+    }
+
+    if (alphaIndices[0] >= 2)
+    {
+      ezMath::Swap(alphaEndpoints[0], alphaEndpoints[1]);
+
+      for (ezUInt32 i = 0; i < s_uiNumPixelsPerBlock; ++i)
+      {
+        alphaIndices[i] = static_cast<ezUInt8>(3 - alphaIndices[i]);
+      }
+    }
+
+    BitWriter writer(pTarget);
+    writer.Write(1u << 5, 6);
+    writer.Write(uiRotation, 2);
+
+    for (ezUInt32 c = 0; c < 3; ++c)
+    {
+      writer.Write(bestColorEndpoints[0][c], 7);
+      writer.Write(bestColorEndpoints[1][c], 7);
+    }
+
+    writer.Write(alphaEndpoints[0], 8);
+    writer.Write(alphaEndpoints[1], 8);
+
+    for (ezUInt32 i = 0; i < s_uiNumPixelsPerBlock; ++i)
+    {
+      writer.Write(bestColorIndices[i], i == 0 ? 1 : 2);
+    }
+
+    for (ezUInt32 i = 0; i < s_uiNumPixelsPerBlock; ++i)
+    {
+      writer.Write(alphaIndices[i], i == 0 ? 1 : 2);
+    }
+
+    return fBestColorError + fAlphaError;
+  }
+} // namespace
+
+void ezCompressBlockBC1(const ezColorBaseUB* pSource, ezUInt8* pTarget, bool bAllowPunchThroughAlpha, ezBlockCompressionQuality::Enum quality)
+{
+  CompressColorBlock(pSource, pTarget, bAllowPunchThroughAlpha, quality);
+}
+
+void ezCompressBlockBC3(const ezColorBaseUB* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality)
+{
+  ezCompressBlockBC4(reinterpret_cast<const ezUInt8*>(pSource) + 3, 4, pTarget, 0, quality);
+
+  // BC3 always decodes the color block in four color mode
+  CompressColorBlock(pSource, pTarget + 8, false, quality);
+}
+
+void ezCompressBlockBC4(const ezUInt8* pSource, ezUInt32 uiStride, ezUInt8* pTarget, ezUInt8 bias, ezBlockCompressionQuality::Enum quality)
+{
+  ezInt32 values[s_uiNumPixelsPerBlock];
+  ezInt32 iMin = 255;
+  ezInt32 iMax = 0;
+
+  for (ezUInt32 i = 0; i < s_uiNumPixelsPerBlock; ++i)
+  {
+    values[i] = ezUInt8(pSource[i * uiStride] + bias);
+    iMin = ezMath::Min(iMin, values[i]);
+    iMax = ezMath::Max(iMax, values[i]);
+  }
+
+  // eight value mode (a0 > a1) spanning the whole range of the block
+  ezUInt32 a0 = iMax;
+  ezUInt32 a1 = iMin;
+  ezUInt8 indices[s_uiNumPixelsPerBlock];
+  ezUInt32 uiBestError = EvaluateBC4(a0, a1, values, indices);
+
+  if (quality >= ezBlockCompressionQuality::Balanced && uiBestError > 0)
+  {
+    // palette entry i >= 2 interpolates with weight (i - 1) / 7 from a0 to a1
+    static const float s_fWeights[] = {0.0f, 1.0f, 1.0f / 7.0f, 2.0f / 7.0f, 3.0f / 7.0f, 4.0f / 7.0f, 5.0f / 7.0f, 6.0f / 7.0f};
+
+    ezSimdVec4f pixels[s_uiNumPixelsPerBlock];
+    for (ezUInt32 i = 0; i < s_uiNumPixelsPerBlock; ++i)
+    {
+      pixels[i] = ToVector(values[i], 0, 0, 0);
+    }
+
+    ezUInt8 candidateIndices[s_uiNumPixelsPerBlock];
+    ezMemoryUtils::Copy(candidateIndices, indices, s_uiNumPixelsPerBlock);
+
+    for (ezUInt32 uiStep = 0; uiStep < s_uiRefinementSteps[quality]; ++uiStep)
+    {
+      float weights[s_uiNumPixelsPerBlock];
+      for (ezUInt32 i = 0; i < s_uiNumPixelsPerBlock; ++i)
+      {
+        weights[i] = s_fWeights[candidateIndices[i]];
+      }
+
+      ezSimdVec4f vEndpoint0, vEndpoint1;
+      if (!RefineEndpoints(pixels, weights, s_uiNumPixelsPerBlock, vEndpoint0, vEndpoint1))
+        break;
+
+      const ezUInt32 c0 = RoundAndClamp(static_cast<float>(vEndpoint0.x()), 255);
+      const ezUInt32 c1 = RoundAndClamp(static_cast<float>(vEndpoint1.x()), 255);
+
+      if (c0 <= c1)
+        break;
+
+      const ezUInt32 uiError = EvaluateBC4(c0, c1, values, candidateIndices);
+      if (uiError >= uiBestError)
+        break;
+
+      uiBestError = uiError;
+      a0 = c0;
+      a1 = c1;
+      ezMemoryUtils::Copy(indices, candidateIndices, s_uiNumPixelsPerBlock);
+    }
+
+    // six value mode (a0 <= a1), which has exact 0 and 255 entries, so those values don't need to be covered by the endpoints
+    ezInt32 iInnerMin = 255;
+    ezInt32 iInnerMax = 0;
+    for (ezUInt32 i = 0; i < s_uiNumPixelsPerBlock; ++i)
+    {
+      if (values[i] != 0 && values[i] != 255)
+      {
+        iInnerMin = ezMath::Min(iInnerMin, values[i]);
+        iInnerMax = ezMath::Max(iInnerMax, values[i]);
+      }
+    }
+
+    if (iInnerMin > iInnerMax)
+    {
+      iInnerMin = 0;
+      iInnerMax = 0;
+    }
+
+    const ezUInt32 uiError = EvaluateBC4(iInnerMin, iInnerMax, values, candidateIndices);
+    if (uiError < uiBestError)
+    {
+      uiBestError = uiError;
+      a0 = iInnerMin;
+      a1 = iInnerMax;
+      ezMemoryUtils::Copy(indices, candidateIndices, s_uiNumPixelsPerBlock);
+    }
+  }
+
+  // Undo biasing for signed formats by shifting palette upper and lower bound back into signed range
+  pTarget[0] = ezUInt8(a0 - bias);
+  pTarget[1] = ezUInt8(a1 - bias);
+
+  for (ezUInt32 uiTripleIdx = 0; uiTripleIdx < 2; ++uiTripleIdx)
+  {
+    ezUInt32 uiIndices = 0;
+    for (ezUInt32 i = 0; i < 8; ++i)
+    {
+      uiIndices |= static_cast<ezUInt32>(indices[8 * uiTripleIdx + i]) << (3 * i);
+    }
+
+    pTarget[2 + uiTripleIdx * 3 + 0] = static_cast<ezUInt8>(uiIndices >> 0);
+    pTarget[2 + uiTripleIdx * 3 + 1] = static_cast<ezUInt8>(uiIndices >> 8);
+    pTarget[2 + uiTripleIdx * 3 + 2] = static_cast<ezUInt8>(uiIndices >> 16);
+  }
+}
+
+void ezCompressBlockBC6(const ezColorLinear16f* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality)
+{
+  ezSimdVec4f pixels[s_uiNumPixelsPerBlock];
+  for (ezUInt32 i = 0; i < s_uiNumPixelsPerBlock; ++i)
+  {
+    pixels[i] = ezSimdVec4f(HalfToBC6Domain(pSource[i].r), HalfToBC6Domain(pSource[i].g), HalfToBC6Domain(pSource[i].b), 0.0f);
+  }
+
+  float fBestError = CompressBlockBC6Mode11(pixels, quality, pTarget);
+
+  if (quality == ezBlockCompressionQuality::Fast || fBestError == 0.0f)
+    return;
+
+  // the two region mode fixes blocks with distinct colors, as long as their endpoints are close enough for the delta encoding
+  ezUInt32 candidateShapes[s_uiMaxCandidatePartitions];
+  float candidateErrors[s_uiMaxCandidatePartitions];
+  const ezUInt32 uiNumCandidates = quality == ezBlockCompressionQuality::High ? s_uiMaxCandidatePartitions : 1;
+  const ezUInt32 uiNumFound = FindBestPartitions(pixels, 2, 32, uiNumCandidates, candidateShapes, candidateErrors);
+
+  for (ezUInt32 i = 0; i < uiNumFound && candidateErrors[i] < fBestError; ++i)
+  {
+    ezUInt8 candidate[16];
+    const float fError = CompressBlockBC6Mode1(pixels, candidateShapes[i], quality, candidate);
+
+    if (fError < fBestError)
+    {
+      fBestError = fError;
+      ezMemoryUtils::Copy(pTarget, candidate, 16);
+    }
+  }
+}
+
+void ezCompressBlockBC7(const ezColorBaseUB* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality)
+{
+  ezSimdVec4f pixels[s_uiNumPixelsPerBlock];
+  bool bIsOpaque = true;
+
+  for (ezUInt32 i = 0; i < s_uiNumPixelsPerBlock; ++i)
+  {
+    pixels[i] = ToVector(pSource[i].r, pSource[i].g, pSource[i].b, pSource[i].a);
+    bIsOpaque = bIsOpaque && pSource[i].a == 255;
+  }
+
+  // mode 6 handles all blocks reasonably well, whose channels are correlated
+  float fBestError = CompressBlockBC7(pixels, s_BC7Mode6, 0, quality, pTarget);
+
+  if (quality == ezBlockCompressionQuality::Fast || fBestError == 0.0f)
+    return;
+
+  // the modes with two or three subsets fix blocks with several distinct colors, only mode 7 stores alpha
+  const ezUInt32 uiNumCandidates = quality == ezBlockCompressionQuality::High ? 4 : 1;
+
+  if (bIsOpaque)
+  {
+    TryPartitionedModeBC7(pixels, s_BC7Mode1, uiNumCandidates, quality, pTarget, fBestError);
+
+    if (quality == ezBlockCompressionQuality::High)
+    {
+      TryPartitionedModeBC7(pixels, s_BC7Mode3, uiNumCandidates, quality, pTarget, fBestError);
+      TryPartitionedModeBC7(pixels, s_BC7Mode0, uiNumCandidates, quality, pTarget, fBestError);
+      TryPartitionedModeBC7(pixels, s_BC7Mode2, uiNumCandidates, quality, pTarget, fBestError);
+    }
+  }
+  else
+  {
+    TryPartitionedModeBC7(pixels, s_BC7Mode7, uiNumCandidates, quality, pTarget, fBestError);
+  }
+
+  if (quality == ezBlockCompressionQuality::High)
+  {
+    for (ezUInt32 uiRotation = 0; uiRotation < 4; ++uiRotation)
+    {
+      ezUInt8 candidate[16];
+      const float fError = CompressBlockBC7Mode5(pSource, uiRotation, candidate, quality);
+
+      if (fError < fBestError)
+      {
+        fBestError = fError;
+        ezMemoryUtils::Copy(pTarget, candidate, 16);
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+class ezImageConversion_CompressBlocksPortable : public ezImageConversionStepCompressBlocks
+{
+public:
+  ezImageConversion_CompressBlocksPortable()
+  {
+    for (ezImageConversionEntry& entry : m_SupportedConversions)
+    {
+#if EZ_ENABLED(EZ_PLATFORM_WINDOWS_DESKTOP)
+      // DirectXTex on a hardware device is preferred, but these encoders are faster than its software fallback
+      entry.m_additionalPenalty = 1000.0f;
+#else
+      // the exhaustive SSE BC4 / BC5 compressors are preferred where they are available
+      const bool bIsBC4Or5 = ezImageFormat::GetNumChannels(entry.m_targetFormat) <= 2;
+      entry.m_additionalPenalty = bIsBC4Or5 ? 1000.0f : 0.0f;
+#endif
+    }
+  }
+
+  virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override { return m_SupportedConversions; }
+
+  virtual ezResult CompressBlocks(ezConstByteBlobPtr source, ezByteBlobPtr target, ezUInt32 numBlocksX, ezUInt32 numBlocksY,
+    ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat, ezBlockCompressionQuality::Enum quality) const override
+  {
+    CompressionJob job;
+    job.m_pSource = static_cast<const ezUInt8*>(source.GetPtr());
+    job.m_pTarget = static_cast<ezUInt8*>(target.GetPtr());
+    job.m_uiSourceRowPitch = ezImageFormat::GetRowPitch(sourceFormat, 4 * numBlocksX);
+    job.m_uiSourcePixelStride = ezImageFormat::GetBitsPerPixel(sourceFormat) / 8;
+    job.m_uiTargetBlockStride = ezImageFormat::GetBitsPerBlock(targetFormat) / 8;
+    job.m_uiNumBlocksX = numBlocksX;
+    job.m_SourceFormat = sourceFormat;
+    job.m_TargetFormat = targetFormat;
+    job.m_Quality = quality;
+
+    // Bias to shift signed data into unsigned range so we can treat it the same as unsigned
+    job.m_uiBias = ezImageFormat::GetDataType(targetFormat) == ezImageFormatDataType::SNORM ? 128 : 0;
+
+    // every task compresses whole rows of blocks
+    ezTaskSystem::ParallelForIndexed(
+      0, numBlocksY,
+      [&job](ezUInt32 uiStartRow, ezUInt32 uiEndRow) {
+        for (ezUInt32 uiBlockY = uiStartRow; uiBlockY < uiEndRow; ++uiBlockY)
+        {
+          CompressBlockRow(job, uiBlockY);
+        }
+      },
+      "CompressBlocks");
+
+    return EZ_SUCCESS;
+  }
+
+private:
+  struct CompressionJob
+  {
+    const ezUInt8* m_pSource;
+    ezUInt8* m_pTarget;
+    ezUInt64 m_uiSourceRowPitch;
+    ezUInt32 m_uiSourcePixelStride;
+    ezUInt32 m_uiTargetBlockStride;
+    ezUInt32 m_uiNumBlocksX;
+    ezImageFormat::Enum m_SourceFormat;
+    ezImageFormat::Enum m_TargetFormat;
+    ezBlockCompressionQuality::Enum m_Quality;
+    ezUInt8 m_uiBias;
+  };
+
+  static void CompressBlockRow(const CompressionJob& job, ezUInt32 uiBlockY)
+  {
+    for (ezUInt32 uiBlockX = 0; uiBlockX < job.m_uiNumBlocksX; ++uiBlockX)
+    {
+      const ezUInt8* pSource = job.m_pSource + 4 * uiBlockY * job.m_uiSourceRowPitch + 4 * uiBlockX * job.m_uiSourcePixelStride;
+      ezUInt8* pTarget = job.m_pTarget + (uiBlockY * job.m_uiNumBlocksX + uiBlockX) * job.m_uiTargetBlockStride;
+
+      switch (job.m_TargetFormat)
+      {
+        case ezImageFormat::BC1_UNORM:
+        case ezImageFormat::BC1_UNORM_SRGB:
+        {
+          ezColorBaseUB pixels[s_uiNumPixelsPerBlock];
+          GatherBlock(job, pSource, pixels);
+          ezCompressBlockBC1(pixels, pTarget, true, job.m_Quality);
+          break;
+        }
+
+        case ezImageFormat::BC3_UNORM:
+        case ezImageFormat::BC3_UNORM_SRGB:
+        {
+          ezColorBaseUB pixels[s_uiNumPixelsPerBlock];
+          GatherBlock(job, pSource, pixels);
+          ezCompressBlockBC3(pixels, pTarget, job.m_Quality);
+          break;
+        }
+
+        case ezImageFormat::BC7_UNORM:
+        case ezImageFormat::BC7_UNORM_SRGB:
+        {
+          ezColorBaseUB pixels[s_uiNumPixelsPerBlock];
+          GatherBlock(job, pSource, pixels);
+          ezCompressBlockBC7(pixels, pTarget, job.m_Quality);
+          break;
+        }
+
+        case ezImageFormat::BC4_UNORM:
+        case ezImageFormat::BC4_SNORM:
+        case ezImageFormat::BC5_UNORM:
+        case ezImageFormat::BC5_SNORM:
+        {
+          const ezUInt32 uiNumChannels = job.m_uiTargetBlockStride / 8;
+
+          for (ezUInt32 uiChannel = 0; uiChannel < uiNumChannels; ++uiChannel)
+          {
+            ezUInt8 values[s_uiNumPixelsPerBlock];
+            for (ezUInt32 y = 0; y < 4; ++y)
+            {
+              for (ezUInt32 x = 0; x < 4; ++x)
+              {
+                values[4 * y + x] = pSource[y * job.m_uiSourceRowPitch + x * job.m_uiSourcePixelStride + uiChannel];
+              }
+            }
+
+            ezCompressBlockBC4(values, 1, pTarget + 8 * uiChannel, job.m_uiBias, job.m_Quality);
+          }
+          break;
+        }
+
+        case ezImageFormat::BC6H_UF16:
+        {
+          ezColorLinear16f pixels[s_uiNumPixelsPerBlock];
+          for (ezUInt32 y = 0; y < 4; ++y)
+          {
+            const ezUInt8* pRow = pSource + y * job.m_uiSourceRowPitch;
+
+            for (ezUInt32 x = 0; x < 4; ++x)
+            {
+              if (job.m_SourceFormat == ezImageFormat::R32G32B32A32_FLOAT)
+              {
+                pixels[4 * y + x] = *reinterpret_cast<const ezColor*>(pRow + x * job.m_uiSourcePixelStride);
+              }
+              else
+              {
+                pixels[4 * y + x] = *reinterpret_cast<const ezColorLinear16f*>(pRow + x * job.m_uiSourcePixelStride);
+              }
+            }
+          }
+
+          ezCompressBlockBC6(pixels, pTarget, job.m_Quality);
+          break;
+        }
+
+        default:
+          EZ_ASSERT_NOT_IMPLEMENTED;
+      }
+    }
+  }
+
+  static void GatherBlock(const CompressionJob& job, const ezUInt8* pSource, ezColorBaseUB* out_pPixels)
+  {
+    for (ezUInt32 y = 0; y < 4; ++y)
+    {
+      ezMemoryUtils::Copy(out_pPixels + 4 * y, reinterpret_cast<const ezColorBaseUB*>(pSource + y * job.m_uiSourceRowPitch), 4);
+    }
+  }
+
+  ezImageConversionEntry m_SupportedConversions[18] = {
+    ezImageConversionEntry(ezImageFormat::R8G8B8A8_UNORM, ezImageFormat::BC1_UNORM, ezImageConversionFlags::Default),
+    ezImageConversionEntry(ezImageFormat::R8G8B8A8_UNORM_SRGB, ezImageFormat::BC1_UNORM_SRGB, ezImageConversionFlags::Default),
+    ezImageConversionEntry(ezImageFormat::R8G8B8A8_UNORM, ezImageFormat::BC3_UNORM, ezImageConversionFlags::Default),
+    ezImageConversionEntry(ezImageFormat::R8G8B8A8_UNORM_SRGB, ezImageFormat::BC3_UNORM_SRGB, ezImageConversionFlags::Default),
+    ezImageConversionEntry(ezImageFormat::R8G8B8A8_UNORM, ezImageFormat::BC7_UNORM, ezImageConversionFlags::Default),
+    ezImageConversionEntry(ezImageFormat::R8G8B8A8_UNORM_SRGB, ezImageFormat::BC7_UNORM_SRGB, ezImageConversionFlags::Default),
+    ezImageConversionEntry(ezImageFormat::R32G32B32A32_FLOAT, ezImageFormat::BC6H_UF16, ezImageConversionFlags::Default),
+    ezImageConversionEntry(ezImageFormat::R16G16B16A16_FLOAT, ezImageFormat::BC6H_UF16, ezImageConversionFlags::Default),
+    ezImageConversionEntry(ezImageFormat::R8_UNORM, ezImageFormat::BC4_UNORM, ezImageConversionFlags::Default),
+    ezImageConversionEntry(ezImageFormat::R8_SNORM, ezImageFormat::BC4_SNORM, ezImageConversionFlags::Default),
+    ezImageConversionEntry(ezImageFormat::R8G8_UNORM, ezImageFormat::BC4_UNORM, ezImageConversionFlags::Default),
+    ezImageConversionEntry(ezImageFormat::R8G8_SNORM, ezImageFormat::BC4_SNORM, ezImageConversionFlags::Default),
+    ezImageConversionEntry(ezImageFormat::R8G8B8A8_UNORM, ezImageFormat::BC4_UNORM, ezImageConversionFlags::Default),
+    ezImageConversionEntry(ezImageFormat::R8G8B8A8_SNORM, ezImageFormat::BC4_SNORM, ezImageConversionFlags::Default),
+    ezImageConversionEntry(ezImageFormat::R8G8_UNORM, ezImageFormat::BC5_UNORM, ezImageConversionFlags::Default),
+    ezImageConversionEntry(ezImageFormat::R8G8_SNORM, ezImageFormat::BC5_SNORM, ezImageConversionFlags::Default),
+    ezImageConversionEntry(ezImageFormat::R8G8B8A8_UNORM, ezImageFormat::BC5_UNORM, ezImageConversionFlags::Default),
+    ezImageConversionEntry(ezImageFormat::R8G8B8A8_SNORM, ezImageFormat::BC5_SNORM, ezImageConversionFlags::Default),
+  };
+};
+
+static ezImageConversion_CompressBlocksPortable s_conversion_compressBlocksPortable;
+
+EZ_STATICLINK_FILE(Texture, Texture_Image_Conversions_BCCompression);
@@ -400,7 +400,10 @@ namespace
   static const int s_bc67InterpolationWeights2[] = {0, 21, 43, 64};
   static const int s_bc67InterpolationWeights3[] = {0, 9, 18, 27, 37, 46, 55, 64};
   static const int s_bc67InterpolationWeights4[] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+} // namespace
 
+namespace ezInternal
+{
   // Partition, Shape, Pixel (index into 4x4 block)
   const ezUInt8 s_bc67PartitionTable[3][64][16] = {
       {// 1 Region case has no subsets (all 0)
@@ -576,7 +579,7 @@ namespace
       }};
 
   // Partition, Shape, Fixup
-  static const ezUInt8 s_bc67FixUp[3][64][3] = {
+  const ezUInt8 s_bc67FixUp[3][64][3] = {
       {// No fix-ups for 1st subset for BC6H or BC7
        {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0},
        {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0},
@@ -661,6 +664,12 @@ namespace
        {0, 15, 6},  {0, 3, 15},  {0, 15, 8}, {0, 5, 15}, {0, 15, 3}, {0, 15, 6},  {0, 15, 6}, {0, 15, 8},  {0, 3, 15}, {0, 15, 3},
        {0, 5, 15},  {0, 5, 15},  {0, 5, 15}, {0, 8, 15}, {0, 5, 15}, {0, 10, 15}, {0, 5, 15}, {0, 10, 15}, {0, 8, 15}, {0, 13, 15},
        {0, 15, 3},  {0, 12, 15}, {0, 3, 15}, {0, 3, 8}}};
+} // namespace ezInternal
+
+namespace
+{
+  using ezInternal::s_bc67FixUp;
+  using ezInternal::s_bc67PartitionTable;
 
   static const ezUInt32 s_bc6MaxRegions = 2;
   static const ezUInt32 s_bc6MaxIndices = 16;
@@ -1997,7 +2006,7 @@ class ezImageConversion_CompressBC4 : public ezImageConversionStepCompressBlocks
   }
 
   virtual ezResult CompressBlocks(ezConstByteBlobPtr source, ezByteBlobPtr target, ezUInt32 numBlocksX, ezUInt32 numBlocksY,
-                                  ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat) const override
+                                  ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat, ezBlockCompressionQuality::Enum quality) const override
   {
     ezUInt32 stride = ezImageFormat::GetBitsPerPixel(sourceFormat) / 8;
     ezUInt64 rowPitch = ezImageFormat::GetRowPitch(sourceFormat, 4 * numBlocksX);
@@ -2054,7 +2063,7 @@ class ezImageConversion_CompressBC5 : public ezImageConversionStepCompressBlocks
   }
 
   virtual ezResult CompressBlocks(ezConstByteBlobPtr source, ezByteBlobPtr target, ezUInt32 numBlocksX, ezUInt32 numBlocksY,
-                                  ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat) const override
+                                  ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat, ezBlockCompressionQuality::Enum quality) const override
   {
     ezUInt32 stride = ezImageFormat::GetBitsPerPixel(sourceFormat) / 8;
     ezUInt64 rowPitch = ezImageFormat::GetRowPitch(sourceFormat, 4 * numBlocksX);
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <Texture/Image/Image.h>
+#include <Texture/Image/ImageConversion.h>
 
 class ezColorLinear16f;
 
@@ -11,3 +11,23 @@ EZ_TEXTURE_DLL void ezDecompressBlockBC7(const ezUInt8* pSource, ezColorBaseUB*
 
 EZ_TEXTURE_DLL void ezUnpackPaletteBC4(ezUInt32 a0, ezUInt32 a1, ezUInt32* alphas);
 
+namespace ezInternal
+{
+  /// \brief The subset of every pixel of the BC6H and BC7 partitions, indexed by [number of subsets - 1][shape][pixel].
+  EZ_TEXTURE_DLL extern const ezUInt8 s_bc67PartitionTable[3][64][16];
+
+  /// \brief The anchor pixel of every subset, whose index is stored with one bit less. Indexed like s_bc67PartitionTable.
+  EZ_TEXTURE_DLL extern const ezUInt8 s_bc67FixUp[3][64][3];
+} // namespace ezInternal
+
+/// \brief Compresses 16 pixels (in row order) into a BC1 block. Pixels with alpha below 128 are encoded as transparent if \a bAllowPunchThroughAlpha is set.
+EZ_TEXTURE_DLL void ezCompressBlockBC1(const ezColorBaseUB* pSource, ezUInt8* pTarget, bool bAllowPunchThroughAlpha, ezBlockCompressionQuality::Enum quality);
+EZ_TEXTURE_DLL void ezCompressBlockBC3(const ezColorBaseUB* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality);
+
+/// \brief Compresses 16 values that are \a uiStride bytes apart into a BC4 block. A bias of 128 encodes signed data, like in ezDecompressBlockBC4.
+EZ_TEXTURE_DLL void ezCompressBlockBC4(const ezUInt8* pSource, ezUInt32 uiStride, ezUInt8* pTarget, ezUInt8 bias, ezBlockCompressionQuality::Enum quality);
+
+/// \brief Compresses 16 pixels into an unsigned BC6H block. Negative values and NaNs are stored as zero.
+EZ_TEXTURE_DLL void ezCompressBlockBC6(const ezColorLinear16f* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality);
+EZ_TEXTURE_DLL void ezCompressBlockBC7(const ezColorBaseUB* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality);
+
@@ -322,7 +322,7 @@ public:
   }
 
   virtual ezResult CompressBlocks(ezConstByteBlobPtr source, ezByteBlobPtr target, ezUInt32 numBlocksX, ezUInt32 numBlocksY,
-    ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat) const override
+    ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat, ezBlockCompressionQuality::Enum quality) const override
   {
     const ezUInt32 targetWidth = numBlocksX * ezImageFormat::GetBlockWidth(targetFormat);
     const ezUInt32 targetHeight = numBlocksY * ezImageFormat::GetBlockHeight(targetFormat);
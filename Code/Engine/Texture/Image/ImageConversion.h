@@ -8,6 +8,21 @@
 
 EZ_DECLARE_FLAGS(ezUInt8, ezImageConversionFlags, InPlace);
 
+/// \brief Selects how much time the portable block compressors spend on searching for good endpoints.
+struct ezBlockCompressionQuality
+{
+  using StorageType = ezUInt8;
+
+  enum Enum
+  {
+    Fast,     ///< Endpoints are only derived from the principal axis of the block colors, BC6H and BC7 only use a single subset.
+    Balanced, ///< Endpoints are refined with a least squares fit. BC6H and BC7 also try the best fitting partition into two subsets.
+    High,     ///< More refinement steps and candidate partitions, BC7 additionally tries the three subset modes and mode 5.
+
+    Default = Balanced
+  };
+};
+
 /// A structure describing the pairs of source/target format that may be converted using the conversion routine.
 struct ezImageConversionEntry
 {
@@ -70,9 +85,9 @@ public:
 class EZ_TEXTURE_DLL ezImageConversionStepCompressBlocks : public ezImageConversionStep
 {
 public:
-  /// \brief Compresses the given number of blocks.
+  /// \brief Compresses the given number of blocks. Steps that don't support different quality levels ignore \a quality.
   virtual ezResult CompressBlocks(ezConstByteBlobPtr source, ezByteBlobPtr target, ezUInt32 numBlocksX, ezUInt32 numBlocksY,
-                                  ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat) const = 0;
+                                  ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat, ezBlockCompressionQuality::Enum quality) const = 0;
 };
 
 
@@ -119,10 +134,14 @@ public:
                             ezHybridArray<ConversionPathNode, 16>& path_out, ezUInt32& numScratchBuffers_out);
 
   /// \brief  Converts the source image into a target image with the given format. Source and target may be the same.
-  static ezResult Convert(const ezImageView& source, ezImage& target, ezImageFormat::Enum targetFormat);
+  ///
+  /// \a quality is only used when the target format is block compressed.
+  static ezResult Convert(const ezImageView& source, ezImage& target, ezImageFormat::Enum targetFormat,
+                          ezBlockCompressionQuality::Enum quality = ezBlockCompressionQuality::Default);
 
   /// \brief Converts the source image into a target image using a precomputed conversion path.
-  static ezResult Convert(const ezImageView& source, ezImage& target, ezArrayPtr<ConversionPathNode> path, ezUInt32 numScratchBuffers);
+  static ezResult Convert(const ezImageView& source, ezImage& target, ezArrayPtr<ConversionPathNode> path, ezUInt32 numScratchBuffers,
+                          ezBlockCompressionQuality::Enum quality = ezBlockCompressionQuality::Default);
 
   /// \brief Converts the raw source data into a target data buffer with the given format. Source and target may be the same.
   static ezResult ConvertRaw(ezConstByteBlobPtr source, ezByteBlobPtr target, ezUInt32 numElements, ezImageFormat::Enum sourceFormat,
@@ -137,13 +156,14 @@ private:
   ezImageConversion(const ezImageConversion&);
 
   static ezResult ConvertSingleStep(const ezImageConversionStep* pStep, const ezImageView& source, ezImage& target,
-                                    ezImageFormat::Enum targetFormat);
+                                    ezImageFormat::Enum targetFormat, ezBlockCompressionQuality::Enum quality);
 
   static ezResult ConvertSingleStepDecompress(const ezImageView& source, ezImage& target, ezImageFormat::Enum sourceFormat,
                                               ezImageFormat::Enum targetFormat, const ezImageConversionStep* pStep);
 
   static ezResult ConvertSingleStepCompress(const ezImageView& source, ezImage& target, ezImageFormat::Enum sourceFormat,
-                                            ezImageFormat::Enum targetFormat, const ezImageConversionStep* pStep);
+                                            ezImageFormat::Enum targetFormat, const ezImageConversionStep* pStep,
+                                            ezBlockCompressionQuality::Enum quality);
 
   static void RebuildConversionTable();
 };
@@ -364,7 +364,8 @@ void ezImageConversion::RebuildConversionTable()
   s_conversionTableValid = true;
 }
 
-ezResult ezImageConversion::Convert(const ezImageView& source, ezImage& target, ezImageFormat::Enum targetFormat)
+ezResult ezImageConversion::Convert(const ezImageView& source, ezImage& target, ezImageFormat::Enum targetFormat,
+                                    ezBlockCompressionQuality::Enum quality)
 {
   ezImageFormat::Enum sourceFormat = source.GetImageFormat();
 
@@ -386,11 +387,11 @@ ezResult ezImageConversion::Convert(const ezImageView& source, ezImage& target,
     return EZ_FAILURE;
   }
 
-  return Convert(source, target, path, numScratchBuffers);
+  return Convert(source, target, path, numScratchBuffers, quality);
 }
 
 ezResult ezImageConversion::Convert(const ezImageView& source, ezImage& target, ezArrayPtr<ConversionPathNode> path,
-                                    ezUInt32 numScratchBuffers)
+                                    ezUInt32 numScratchBuffers, ezBlockCompressionQuality::Enum quality)
 {
   EZ_ASSERT_DEV(path.GetCount() > 0, "Invalid conversion path");
   EZ_ASSERT_DEV(path[0].m_sourceFormat == source.GetImageFormat(), "Invalid conversion path");
@@ -406,7 +407,7 @@ ezResult ezImageConversion::Convert(const ezImageView& source, ezImage& target,
 
     ezImage* pTarget = targetIndex == 0 ? &target : &intermediates[targetIndex - 1];
 
-    if (ConvertSingleStep(path[i].m_step, *pSource, *pTarget, path[i].m_targetFormat).Failed())
+    if (ConvertSingleStep(path[i].m_step, *pSource, *pTarget, path[i].m_targetFormat, quality).Failed())
     {
       return EZ_FAILURE;
     }
@@ -504,7 +505,7 @@ ezResult ezImageConversion::ConvertRaw(ezConstByteBlobPtr source, ezByteBlobPtr
 }
 
 ezResult ezImageConversion::ConvertSingleStep(const ezImageConversionStep* pStep, const ezImageView& source, ezImage& target,
-                                              ezImageFormat::Enum targetFormat)
+                                              ezImageFormat::Enum targetFormat, ezBlockCompressionQuality::Enum quality)
 {
   if (!pStep)
   {
@@ -530,7 +531,7 @@ ezResult ezImageConversion::ConvertSingleStep(const ezImageConversionStep* pStep
     }
     else
     {
-      return ConvertSingleStepCompress(source, target, sourceFormat, targetFormat, pStep);
+      return ConvertSingleStepCompress(source, target, sourceFormat, targetFormat, pStep, quality);
     }
   }
   else
@@ -604,7 +605,8 @@ ezResult ezImageConversion::ConvertSingleStepDecompress(const ezImageView& sourc
 }
 
 ezResult ezImageConversion::ConvertSingleStepCompress(const ezImageView& source, ezImage& target, ezImageFormat::Enum sourceFormat,
-                                                      ezImageFormat::Enum targetFormat, const ezImageConversionStep* pStep)
+                                                      ezImageFormat::Enum targetFormat, const ezImageConversionStep* pStep,
+                                                      ezBlockCompressionQuality::Enum quality)
 {
   for (ezUInt32 arrayIndex = 0; arrayIndex < source.GetNumArrayIndices(); arrayIndex++)
   {
@@ -651,7 +653,7 @@ ezResult ezImageConversion::ConvertSingleStepCompress(const ezImageView& source,
 
           ezResult result = static_cast<const ezImageConversionStepCompressBlocks*>(pStep)->CompressBlocks(
               paddedSlice.GetByteBlobPtr(), target.GetSliceView(mipLevel, face, arrayIndex, slice).GetByteBlobPtr(), numBlocksX, numBlocksY,
-              sourceFormat, targetFormat);
+              sourceFormat, targetFormat, quality);
 
           if (result.Failed())
           {
@@ -3,6 +3,7 @@
 #include <Texture/Image/ImageUtils.h>
 
 #include <Foundation/SimdMath/SimdVec4f.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Texture/Image/ImageConversion.h>
 #include <Texture/Image/ImageEnums.h>
 #include <Texture/Image/ImageFilter.h>
@@ -648,6 +649,29 @@ inline static void FilterLine(ezUInt32 numSourceElements, const ezSimdVec4f* __r
   }
 }
 
+/// \brief Calls filterLine(lineIndex) for all lines of one separable filter pass, distributed over the task system.
+///
+/// The lines of a pass are independent of each other, so they are split into ranges of whole lines. Small images (e.g. the last mip levels)
+/// don't carry enough work to make up for the task overhead and are filtered on the calling thread.
+template <typename LineCallback>
+static void FilterLinesParallel(ezUInt32 numLines, ezUInt32 numSamplesPerLine, const LineCallback& filterLine)
+{
+  constexpr ezUInt32 minSamplesPerTask = 16 * 1024;
+
+  ezParallelForParams params;
+  params.uiBinSize = ezMath::Max(1u, minSamplesPerTask / ezMath::Max(1u, numSamplesPerLine));
+
+  ezTaskSystem::ParallelForIndexed(
+    0, numLines,
+    [&filterLine](ezUInt32 startLine, ezUInt32 endLine) {
+      for (ezUInt32 line = startLine; line < endLine; ++line)
+      {
+        filterLine(line);
+      }
+    },
+    "ezImageUtils::Scale", params);
+}
+
 static void DownScaleFastLine(
   ezUInt32 pixelStride, const ezUInt8* src, ezUInt8* dest, ezUInt32 lengthIn, ezUInt32 strideIn, ezUInt32 lengthOut, ezUInt32 strideOut)
 {
@@ -697,17 +721,15 @@ static void DownScaleFast(const ezImageView& image, ezImage& out_Result, ezUInt3
   ezImage intermediate;
   intermediate.ResetAndAlloc(intermediateHeader);
 
-  for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; arrayIndex++)
-  {
-    for (ezUInt32 face = 0; face < numFaces; face++)
-    {
-      for (ezUInt32 row = 0; row < originalHeight; row++)
-      {
-        DownScaleFastLine(pixelStride, image.GetPixelPointer<ezUInt8>(0, face, arrayIndex, 0, row),
-          intermediate.GetPixelPointer<ezUInt8>(0, face, arrayIndex, 0, row), originalWidth, pixelStride, width, pixelStride);
-      }
-    }
-  }
+  FilterLinesParallel(numArrayElements * numFaces * originalHeight, originalWidth * pixelStride, [&](ezUInt32 line) {
+    const ezUInt32 row = line % originalHeight;
+    line /= originalHeight;
+    const ezUInt32 face = line % numFaces;
+    const ezUInt32 arrayIndex = line / numFaces;
+
+    DownScaleFastLine(pixelStride, image.GetPixelPointer<ezUInt8>(0, face, arrayIndex, 0, row),
+      intermediate.GetPixelPointer<ezUInt8>(0, face, arrayIndex, 0, row), originalWidth, pixelStride, width, pixelStride);
+  });
 
   // input and output images may be the same, so we can't access the original image below this point
 
@@ -715,7 +737,7 @@ static void DownScaleFast(const ezImageView& image, ezImage& out_Result, ezUInt3
   outHeader.SetWidth(width);
   outHeader.SetHeight(height);
   outHeader.SetNumArrayIndices(numArrayElements);
-  outHeader.SetNumArrayIndices(numFaces);
+  outHeader.SetNumFaces(numFaces);
   outHeader.SetImageFormat(format);
 
   out_Result.ResetAndAlloc(outHeader);
@@ -723,18 +745,16 @@ static void DownScaleFast(const ezImageView& image, ezImage& out_Result, ezUInt3
   EZ_ASSERT_DEBUG(intermediate.GetRowPitch() < ezMath::MaxValue<ezUInt32>(), "Row pitch exceeds ezUInt32 max value.");
   EZ_ASSERT_DEBUG(out_Result.GetRowPitch() < ezMath::MaxValue<ezUInt32>(), "Row pitch exceeds ezUInt32 max value.");
 
-  for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; arrayIndex++)
-  {
-    for (ezUInt32 face = 0; face < numFaces; face++)
-    {
-      for (ezUInt32 col = 0; col < width; col++)
-      {
-        DownScaleFastLine(pixelStride, intermediate.GetPixelPointer<ezUInt8>(0, face, arrayIndex, col),
-          out_Result.GetPixelPointer<ezUInt8>(0, face, arrayIndex, col), originalHeight, static_cast<ezUInt32>(intermediate.GetRowPitch()), height,
-          static_cast<ezUInt32>(out_Result.GetRowPitch()));
-      }
-    }
-  }
+  FilterLinesParallel(numArrayElements * numFaces * width, originalHeight * pixelStride, [&](ezUInt32 line) {
+    const ezUInt32 col = line % width;
+    line /= width;
+    const ezUInt32 face = line % numFaces;
+    const ezUInt32 arrayIndex = line / numFaces;
+
+    DownScaleFastLine(pixelStride, intermediate.GetPixelPointer<ezUInt8>(0, face, arrayIndex, col),
+      out_Result.GetPixelPointer<ezUInt8>(0, face, arrayIndex, col), originalHeight, static_cast<ezUInt32>(intermediate.GetRowPitch()), height,
+      static_cast<ezUInt32>(out_Result.GetRowPitch()));
+  });
 }
 
 static float EvaluateAverageCoverage(ezBlobPtr<const ezColor> colors, float alphaThreshold)
@@ -912,6 +932,8 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
     stepSource = &conversionScratch;
   };
 
+  const ezSimdVec4f simdBorderColor(borderColor.r, borderColor.g, borderColor.b, borderColor.a);
+
   ezHybridArray<ezInt32, 256> firstSampleIndices;
   firstSampleIndices.Reserve(ezMath::Max(width, height, depth));
 
@@ -938,22 +960,19 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
     stepHeader.SetWidth(width);
     stepTarget->ResetAndAlloc(stepHeader);
 
-    for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; ++arrayIndex)
-    {
-      for (ezUInt32 face = 0; face < numFaces; ++face)
-      {
-        for (ezUInt32 z = 0; z < originalDepth; ++z)
-        {
-          for (ezUInt32 y = 0; y < originalHeight; ++y)
-          {
-            const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
-            ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
-            FilterLine(originalWidth, filterSource, filterTarget, 1, weights, firstSampleIndices, addressModeU,
-              ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
-          }
-        }
-      }
-    }
+    // one line per row of every slice, face and array element
+    FilterLinesParallel(numArrayElements * numFaces * originalDepth * originalHeight, width * weights.GetNumWeights(), [&](ezUInt32 line) {
+      const ezUInt32 y = line % originalHeight;
+      line /= originalHeight;
+      const ezUInt32 z = line % originalDepth;
+      line /= originalDepth;
+      const ezUInt32 face = line % numFaces;
+      const ezUInt32 arrayIndex = line / numFaces;
+
+      const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
+      ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
+      FilterLine(originalWidth, filterSource, filterTarget, 1, weights, firstSampleIndices, addressModeU, simdBorderColor);
+    });
 
     releaseScratch(*stepSource);
     stepSource = stepTarget;
@@ -982,22 +1001,19 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
     stepHeader.SetHeight(height);
     stepTarget->ResetAndAlloc(stepHeader);
 
-    for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; ++arrayIndex)
-    {
-      for (ezUInt32 face = 0; face < numFaces; ++face)
-      {
-        for (ezUInt32 z = 0; z < originalDepth; ++z)
-        {
-          for (ezUInt32 x = 0; x < width; ++x)
-          {
-            const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, 0, z);
-            ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, 0, z);
-            FilterLine(originalHeight, filterSource, filterTarget, width, weights, firstSampleIndices, addressModeV,
-              ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
-          }
-        }
-      }
-    }
+    // one line per column of every slice, face and array element
+    FilterLinesParallel(numArrayElements * numFaces * originalDepth * width, height * weights.GetNumWeights(), [&](ezUInt32 line) {
+      const ezUInt32 x = line % width;
+      line /= width;
+      const ezUInt32 z = line % originalDepth;
+      line /= originalDepth;
+      const ezUInt32 face = line % numFaces;
+      const ezUInt32 arrayIndex = line / numFaces;
+
+      const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, 0, z);
+      ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, 0, z);
+      FilterLine(originalHeight, filterSource, filterTarget, width, weights, firstSampleIndices, addressModeV, simdBorderColor);
+    });
 
     releaseScratch(*stepSource);
     stepSource = stepTarget;
@@ -1026,22 +1042,19 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
     stepHeader.SetDepth(depth);
     stepTarget->ResetAndAlloc(stepHeader);
 
-    for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; ++arrayIndex)
-    {
-      for (ezUInt32 face = 0; face < numFaces; ++face)
-      {
-        for (ezUInt32 y = 0; y < height; ++y)
-        {
-          for (ezUInt32 x = 0; x < width; ++x)
-          {
-            const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, y, 0);
-            ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, y, 0);
-            FilterLine(originalHeight, filterSource, filterTarget, width * height, weights, firstSampleIndices, addressModeW,
-              ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
-          }
-        }
-      }
-    }
+    // one line per pixel of every face and array element
+    FilterLinesParallel(numArrayElements * numFaces * height * width, depth * weights.GetNumWeights(), [&](ezUInt32 line) {
+      const ezUInt32 x = line % width;
+      line /= width;
+      const ezUInt32 y = line % height;
+      line /= height;
+      const ezUInt32 face = line % numFaces;
+      const ezUInt32 arrayIndex = line / numFaces;
+
+      const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, y, 0);
+      ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, y, 0);
+      FilterLine(originalDepth, filterSource, filterTarget, width * height, weights, firstSampleIndices, addressModeW, simdBorderColor);
+    });
 
     releaseScratch(*stepSource);
     stepSource = stepTarget;
@@ -1079,60 +1092,67 @@ void ezImageUtils::GenerateMipMaps(const ezImageView& source, ezImage& target, c
 
   target.ResetAndAlloc(header);
 
-  for (ezUInt32 arrayIndex = 0; arrayIndex < source.GetNumArrayIndices(); arrayIndex++)
-  {
-    for (ezUInt32 face = 0; face < source.GetNumFaces(); face++)
-    {
-      ezImageHeader currentMipMapHeader = header;
-      currentMipMapHeader.SetNumMipLevels(1);
-      currentMipMapHeader.SetNumFaces(1);
-      currentMipMapHeader.SetNumArrayIndices(1);
-
-      auto sourceView = source.GetSubImageView(0, face, arrayIndex).GetByteBlobPtr();
-      auto targetView = target.GetSubImageView(0, face, arrayIndex).GetByteBlobPtr();
-
-      memcpy(targetView.GetPtr(), sourceView.GetPtr(), targetView.GetCount());
-
-      float targetCoverage = 0.0f;
-      if (mipMapOptions.m_preserveCoverage)
-      {
-        targetCoverage =
-          EvaluateAverageCoverage(source.GetSubImageView(0, face, arrayIndex).GetBlobPtr<ezColor>(), mipMapOptions.m_alphaThreshold);
-      }
-
-      for (ezUInt32 mipMapLevel = 0; mipMapLevel < numMipMaps - 1; mipMapLevel++)
+  // the mip chains of all faces and array slices are independent of each other
+  const ezUInt32 numFaces = source.GetNumFaces();
+  ezTaskSystem::ParallelForIndexed(
+    0, source.GetNumArrayIndices() * numFaces,
+    [&](ezUInt32 startIndex, ezUInt32 endIndex) {
+      for (ezUInt32 subImage = startIndex; subImage < endIndex; ++subImage)
       {
-        ezImageHeader nextMipMapHeader = currentMipMapHeader;
-        nextMipMapHeader.SetWidth(ezMath::Max(1u, nextMipMapHeader.GetWidth() / 2));
-        nextMipMapHeader.SetHeight(ezMath::Max(1u, nextMipMapHeader.GetHeight() / 2));
-        nextMipMapHeader.SetDepth(ezMath::Max(1u, nextMipMapHeader.GetDepth() / 2));
+        const ezUInt32 face = subImage % numFaces;
+        const ezUInt32 arrayIndex = subImage / numFaces;
 
-        auto sourceData = target.GetSubImageView(mipMapLevel, face, arrayIndex).GetByteBlobPtr();
-        ezImage currentMipMap;
-        currentMipMap.ResetAndUseExternalStorage(currentMipMapHeader, sourceData);
+        ezImageHeader currentMipMapHeader = header;
+        currentMipMapHeader.SetNumMipLevels(1);
+        currentMipMapHeader.SetNumFaces(1);
+        currentMipMapHeader.SetNumArrayIndices(1);
 
-        auto dstData = target.GetSubImageView(mipMapLevel + 1, face, arrayIndex).GetByteBlobPtr();
-        ezImage nextMipMap;
-        nextMipMap.ResetAndUseExternalStorage(nextMipMapHeader, dstData);
+        auto sourceView = source.GetSubImageView(0, face, arrayIndex).GetByteBlobPtr();
+        auto targetView = target.GetSubImageView(0, face, arrayIndex).GetByteBlobPtr();
 
-        ezImageUtils::Scale3D(currentMipMap, nextMipMap, nextMipMapHeader.GetWidth(), nextMipMapHeader.GetHeight(),
-          nextMipMapHeader.GetDepth(), mipMapOptions.m_filter, mipMapOptions.m_addressModeU, mipMapOptions.m_addressModeV,
-          mipMapOptions.m_addressModeW, mipMapOptions.m_borderColor);
+        memcpy(targetView.GetPtr(), sourceView.GetPtr(), targetView.GetCount());
 
+        float targetCoverage = 0.0f;
         if (mipMapOptions.m_preserveCoverage)
         {
-          NormalizeCoverage(nextMipMap.GetBlobPtr<ezColor>(), mipMapOptions.m_alphaThreshold, targetCoverage);
+          targetCoverage =
+            EvaluateAverageCoverage(source.GetSubImageView(0, face, arrayIndex).GetBlobPtr<ezColor>(), mipMapOptions.m_alphaThreshold);
         }
 
-        if (mipMapOptions.m_renormalizeNormals)
+        for (ezUInt32 mipMapLevel = 0; mipMapLevel < numMipMaps - 1; mipMapLevel++)
         {
-          RenormalizeNormalMap(nextMipMap);
-        }
+          ezImageHeader nextMipMapHeader = currentMipMapHeader;
+          nextMipMapHeader.SetWidth(ezMath::Max(1u, nextMipMapHeader.GetWidth() / 2));
+          nextMipMapHeader.SetHeight(ezMath::Max(1u, nextMipMapHeader.GetHeight() / 2));
+          nextMipMapHeader.SetDepth(ezMath::Max(1u, nextMipMapHeader.GetDepth() / 2));
 
-        currentMipMapHeader = nextMipMapHeader;
+          auto sourceData = target.GetSubImageView(mipMapLevel, face, arrayIndex).GetByteBlobPtr();
+          ezImage currentMipMap;
+          currentMipMap.ResetAndUseExternalStorage(currentMipMapHeader, sourceData);
+
+          auto dstData = target.GetSubImageView(mipMapLevel + 1, face, arrayIndex).GetByteBlobPtr();
+          ezImage nextMipMap;
+          nextMipMap.ResetAndUseExternalStorage(nextMipMapHeader, dstData);
+
+          ezImageUtils::Scale3D(currentMipMap, nextMipMap, nextMipMapHeader.GetWidth(), nextMipMapHeader.GetHeight(),
+            nextMipMapHeader.GetDepth(), mipMapOptions.m_filter, mipMapOptions.m_addressModeU, mipMapOptions.m_addressModeV,
+            mipMapOptions.m_addressModeW, mipMapOptions.m_borderColor);
+
+          if (mipMapOptions.m_preserveCoverage)
+          {
+            NormalizeCoverage(nextMipMap.GetBlobPtr<ezColor>(), mipMapOptions.m_alphaThreshold, targetCoverage);
+          }
+
+          if (mipMapOptions.m_renormalizeNormals)
+          {
+            RenormalizeNormalMap(nextMipMap);
+          }
+
+          currentMipMapHeader = nextMipMapHeader;
+        }
       }
-    }
-  }
+    },
+    "ezImageUtils::GenerateMipMaps");
 }
 
 void ezImageUtils::ReconstructNormalZ(ezImage& image)
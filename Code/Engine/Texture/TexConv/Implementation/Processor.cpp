@@ -126,11 +126,11 @@ ezResult ezTexConvProcessor::DetectNumChannels(ezArrayPtr<const ezTexConvSliceCh
   return EZ_SUCCESS;
 }
 
-ezResult ezTexConvProcessor::GenerateOutput(ezImage&& src, ezImage& dst, ezEnum<ezImageFormat> format)
+ezResult ezTexConvProcessor::GenerateOutput(ezImage&& src, ezImage& dst, ezEnum<ezImageFormat> format) const
 {
   dst.ResetAndMove(std::move(src));
 
-  if (dst.Convert(format).Failed())
+  if (ezImageConversion::Convert(dst, dst, format, m_Descriptor.m_CompressionQuality).Failed())
   {
     ezLog::Error("Failed to convert result image to output format '{}'", ezImageFormat::GetName(format));
     return EZ_FAILURE;
@@ -7,6 +7,7 @@
 #include <Foundation/Strings/String.h>
 #include <Foundation/Types/UniquePtr.h>
 #include <Texture/Image/Image.h>
+#include <Texture/Image/ImageConversion.h>
 #include <Texture/Image/ImageEnums.h>
 
 struct ezTexConvChannelMapping
@@ -52,6 +53,7 @@ public:
   // Format / Compression
   ezEnum<ezTexConvUsage> m_Usage;
   ezEnum<ezTexConvCompressionMode> m_CompressionMode;
+  ezEnum<ezBlockCompressionQuality> m_CompressionQuality;
 
   // resolution clamp and downscale
   ezUInt32 m_uiMinResolution = 16;
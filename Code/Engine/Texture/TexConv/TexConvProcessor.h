@@ -66,7 +66,7 @@ private:
   //////////////////////////////////////////////////////////////////////////
   // Output Generation
 
-  static ezResult GenerateOutput(ezImage&& src, ezImage& dst, ezEnum<ezImageFormat> format);
+  ezResult GenerateOutput(ezImage&& src, ezImage& dst, ezEnum<ezImageFormat> format) const;
   static ezResult GenerateThumbnailOutput(const ezImage& srcImg, ezImage& dstImg, ezUInt32 uiTargetRes);
   static ezResult GenerateLowResOutput(const ezImage& srcImg, ezImage& dstImg, ezUInt32 uiLowResMip);
 
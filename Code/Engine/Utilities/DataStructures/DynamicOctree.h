@@ -1,5 +1,8 @@
 #pragma once
 
+#include <Foundation/SimdMath/SimdBBox.h>
+#include <Foundation/Threading/AtomicInteger.h>
+#include <Foundation/Threading/Mutex.h>
 #include <Utilities/DataStructures/Implementation/DynamicTree.h>
 
 /// \brief A loose Octree implementation that is very lightweight on RAM.
@@ -27,7 +30,13 @@
 /// types of objects in the same tree.\n
 /// Once objects are inserted, you can do range queries to find all objects in some location.
 /// Since removal is usually O(1) and insertion is O(d) the tree can be used for very dynamic
-/// data that changes frequently at run-time.
+/// data that changes frequently at run-time.\n
+/// \n
+/// For queries, the occupied nodes are copied into flat arrays in depth-first order, with precomputed SIMD bounding boxes.
+/// A query then is a single loop over these arrays that skips or returns whole subtrees at once.\n
+/// Rebuilding these arrays is O(n), so after a modification queries traverse the tree recursively instead. The arrays are only
+/// rebuilt once the queries since the last modification have visited about as many nodes as there are objects, thus a tree that
+/// is modified every frame never pays for the rebuild.
 class EZ_UTILITIES_DLL ezDynamicOctree
 {
   /// \brief The amount that cells overlap (this is a loose octree). Typically set to 10%.
@@ -50,7 +59,8 @@ public:
   /// \param fMinNodeSize
   ///   The length of the cell's edges at the finest level. For a typical game world, where your level might
   ///   have extents of 100 to 1000 meters, the min node size should not be smaller than 1 meter.
-  ///   The smaller the node size, the more cells the tree has. The limit of nodes in the tree is 2^32.
+  ///   The smaller the node size, the more cells the tree has. The limit of nodes in the tree is 2^32, so the tree is never subdivided
+  ///   more than 10 times, even if that means the finest cells are larger than fMinNodeSize.
   ///   A tree with 100 meters extents in X, Y and Z direction and a min node size of 1 meter, will have 1000000 nodes
   ///   on the finest level (and roughly 1500000 nodes in total).
   void CreateTree(const ezVec3& vCenter, const ezVec3& vHalfExtents, float fMinNodeSize); // [tested]
@@ -75,12 +85,20 @@ public:
   /// purposes.
   void FindVisibleObjects(const ezFrustum& Viewfrustum, EZ_VISIBLE_OBJ_CALLBACK Callback, void* pPassThrough) const;
 
+  /// \brief Appends all objects that are located in a node that overlaps with the View-frustum to out_Objects.
+  ///
+  /// This is faster than the callback variant, since whole subtrees are copied at once.
+  void FindVisibleObjects(const ezFrustum& Viewfrustum, ezDynamicArray<ezDynamicTree::ezObjectData>& out_Objects) const;
+
   /// \brief Returns all objects that are located in a node that overlaps with the given point.
   ///
   /// \note This function will most likely also return objects that do not overlap with the point itself, because they are located
   /// in a node that overlaps with the point. You might need to do more thorough overlap checks to filter those out.
   void FindObjectsInRange(const ezVec3& vPoint, EZ_VISIBLE_OBJ_CALLBACK Callback, void* pPassThrough = nullptr) const; // [tested]
 
+  /// \brief Same as the callback variant, but appends the objects to out_Objects.
+  void FindObjectsInRange(const ezVec3& vPoint, ezDynamicArray<ezDynamicTree::ezObjectData>& out_Objects) const; // [tested]
+
   /// \brief Returns all objects that are located in a node that overlaps with the rectangle with center vPoint and half edge length
   /// fRadius.
   ///
@@ -89,6 +107,9 @@ public:
   void FindObjectsInRange(const ezVec3& vPoint, float fRadius, EZ_VISIBLE_OBJ_CALLBACK Callback,
                           void* pPassThrough = nullptr) const; // [tested]
 
+  /// \brief Same as the callback variant, but appends the objects to out_Objects.
+  void FindObjectsInRange(const ezVec3& vPoint, float fRadius, ezDynamicArray<ezDynamicTree::ezObjectData>& out_Objects) const; // [tested]
+
   /// \brief Removes the given Object. Attention: This is an O(n) operation.
   void RemoveObject(ezInt32 iObjectType, ezInt32 iObjectInstance); // [tested]
 
@@ -103,6 +124,7 @@ public:
   {
     m_NodeMap.Clear();
     m_uiMultiMapCounter = 1;
+    InvalidateFlatNodes();
   } // [tested]
 
   /// \brief Returns the tree's adjusted (square) AABB.
@@ -114,20 +136,59 @@ private:
                     float miny, float maxy, float minz, float maxz, ezUInt32 uiNodeID, ezUInt32 uiAddID, ezUInt32 uiSubAddID,
                     ezDynamicTreeObject* out_Object);
 
-  /// \brief Recursively checks which nodes are visible and calls the callback for each object at those nodes.
-  void FindVisibleObjects(const ezFrustum& Viewfrustum, EZ_VISIBLE_OBJ_CALLBACK Callback, void* pPassThrough, float minx, float maxx,
-                          float miny, float maxy, float minz, float maxz, ezUInt32 uiNodeID, ezUInt32 uiAddID, ezUInt32 uiSubAddID,
-                          ezUInt32 uiNextNodeID) const;
+  /// \brief The ID and bounds of a node, computed the same way as in InsertObject.
+  struct NodeDesc
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiNodeID;
+    ezUInt32 m_uiAddID;
+    ezUInt32 m_uiSubAddID;
+    ezUInt32 m_uiNextNodeID; ///< The ID of the first node after this subtree.
+    float minx, maxx, miny, maxy, minz, maxz;
+  };
+
+  NodeDesc GetRootNode() const;
+  static NodeDesc GetChildNode(const NodeDesc& parent, ezUInt32 uiChild);
 
-  /// \brief Recursively checks in which node a point is located and calls the callback for all objects at those nodes.
-  bool FindObjectsInRange(const ezVec3& vPoint, EZ_VISIBLE_OBJ_CALLBACK Callback, void* pPassThrough, float minx, float maxx, float miny,
-                          float maxy, float minz, float maxz, ezUInt32 uiNodeID, ezUInt32 uiAddID, ezUInt32 uiSubAddID,
-                          ezUInt32 uiNextNodeID) const;
+  /// \brief A node that contains objects itself or in its subtree.
+  ///
+  /// The nodes are stored in depth-first order, so the nodes and objects of a subtree are contiguous ranges in the flat arrays.
+  struct FlatNode
+  {
+    ezSimdBBox m_Box;
+    ezUInt32 m_uiFirstObject;   ///< Index of the first object of this node in m_FlatObjects.
+    ezUInt32 m_uiNumObjects;    ///< Number of objects stored at this node itself.
+    ezUInt32 m_uiSubtreeEnd;    ///< One past the last object of the whole subtree.
+    ezUInt32 m_uiNextNode;      ///< Index of the first node after this subtree.
+  };
+
+  /// \brief Marks the flat arrays as outdated, must be called after every modification.
+  void InvalidateFlatNodes()
+  {
+    m_bFlatNodesDirty = true;
+    m_iNodeVisitsSinceModification = 0;
+  }
+
+  /// \brief Returns whether the flat arrays are up to date, rebuilding them from m_NodeMap if enough queries happened since the last
+  /// modification.
+  bool UpdateFlatNodes() const;
 
-  /// \brief Recursively checks which node(s) a circle touches and calls the callback for all objects at those nodes.
-  bool FindObjectsInRange(const ezVec3& vPoint, float fRadius, EZ_VISIBLE_OBJ_CALLBACK Callback, void* pPassThrough, float minx, float maxx,
-                          float miny, float maxy, float minz, float maxz, ezUInt32 uiNodeID, ezUInt32 uiAddID, ezUInt32 uiSubAddID,
-                          ezUInt32 uiNextNodeID) const;
+  /// \brief Calls visitor(uiFirstObject, uiEndObject) for all object ranges in nodes that classifier(box) does not report as outside.
+  /// Stops and returns false as soon as the visitor returns false.
+  template <typename Classifier, typename Visitor>
+  bool TraverseFlatNodes(Classifier classifier, Visitor visitor) const;
+
+  /// \brief Calls visitor(iterator) for all objects in nodes that classifier(box) does not report as outside, by traversing m_NodeMap.
+  /// Visits the objects in the same order as TraverseFlatNodes. Stops and returns false as soon as the visitor returns false.
+  template <typename Classifier, typename Visitor>
+  bool TraverseNodeMap(Classifier classifier, Visitor visitor) const;
+
+  template <typename Classifier, typename Visitor>
+  bool TraverseNodeMap(const NodeDesc& node, Classifier& classifier, Visitor& visitor, ezUInt32& inout_uiNumVisitedNodes) const;
+
+  /// \brief Calls the callback for every object in the given range of m_FlatObjects.
+  bool CallCallback(ezUInt32 uiFirstObject, ezUInt32 uiEndObject, EZ_VISIBLE_OBJ_CALLBACK Callback, void* pPassThrough) const;
 
   /// \brief The tree depth, used for finding a nodes unique ID
   ezUInt32 m_uiMaxTreeDepth;
@@ -146,5 +207,12 @@ private:
 
   /// \brief Every node has a unique index, the map allows to store many objects at each node, using that index
   ezMap<ezDynamicTree::ezMultiMapKey, ezDynamicTree::ezObjectData> m_NodeMap;
+
+  mutable ezAtomicBool m_bFlatNodesDirty = true;
+  mutable ezAtomicInteger32 m_iNodeVisitsSinceModification;
+  mutable ezMutex m_FlatNodesMutex;
+  mutable ezDynamicArray<FlatNode, ezAlignedAllocatorWrapper> m_FlatNodes;
+  mutable ezDynamicArray<ezDynamicTree::ezObjectData> m_FlatObjects;
+  mutable ezDynamicArray<ezDynamicTreeObjectConst> m_FlatObjectIterators;
 };
 
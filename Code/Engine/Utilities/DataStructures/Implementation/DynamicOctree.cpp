@@ -1,5 +1,6 @@
 #include <UtilitiesPCH.h>
 
+#include <Foundation/SimdMath/SimdMat4f.h>
 #include <Utilities/DataStructures/DynamicOctree.h>
 
 const float ezDynamicOctree::s_LooseOctreeFactor = 1.1f;
@@ -15,6 +16,7 @@ void ezDynamicOctree::CreateTree(const ezVec3& vCenter, const ezVec3& vHalfExten
   m_uiMultiMapCounter = 1;
 
   m_NodeMap.Clear();
+  InvalidateFlatNodes();
 
   // the real bounding box might be long and thing -> bad node-size
   // but still it can be used to reject inserting objects that are entirely outside the world
@@ -32,8 +34,11 @@ void ezDynamicOctree::CreateTree(const ezVec3& vCenter, const ezVec3& vHalfExten
 
   float fLength = fMax * 2.0f;
 
+  // with more levels the node ids would not fit into 32 bits anymore
+  const ezUInt32 uiMaxTreeDepth = 10;
+
   m_uiMaxTreeDepth = 0;
-  while (fLength > fMinNodeSize)
+  while (fLength > fMinNodeSize && m_uiMaxTreeDepth < uiMaxTreeDepth)
   {
     ++m_uiMaxTreeDepth;
     fLength = (fLength / 2.0f) * s_LooseOctreeFactor;
@@ -91,6 +96,7 @@ ezResult ezDynamicOctree::InsertObject(const ezVec3& vCenter, const ezVec3& vHal
       mmk.m_uiCounter = m_uiMultiMapCounter++;
 
       auto key = m_NodeMap.Insert(mmk, oData);
+      InvalidateFlatNodes();
 
       if (out_Object)
         *out_Object = key;
@@ -162,6 +168,7 @@ bool ezDynamicOctree::InsertObject(const ezVec3& vCenter, const ezVec3& vHalfExt
   mmk.m_uiCounter = m_uiMultiMapCounter++;
 
   auto key = m_NodeMap.Insert(mmk, Obj);
+  InvalidateFlatNodes();
 
   if (out_Object)
     *out_Object = key;
@@ -169,232 +176,343 @@ bool ezDynamicOctree::InsertObject(const ezVec3& vCenter, const ezVec3& vHalfExt
   return true;
 }
 
-void ezDynamicOctree::FindObjectsInRange(const ezVec3& vPoint, EZ_VISIBLE_OBJ_CALLBACK Callback, void* pPassThrough) const
+namespace
 {
-  if (m_NodeMap.IsEmpty())
-    return;
+  /// \brief The six frustum planes transposed, so that a box can be tested against four planes at once.
+  struct OctreeFrustumPlanes
+  {
+    OctreeFrustumPlanes(const ezFrustum& frustum)
+    {
+      ezSimdVec4f planes[ezFrustum::PLANE_COUNT];
+      for (ezUInt32 i = 0; i < ezFrustum::PLANE_COUNT; ++i)
+      {
+        const ezPlane& plane = frustum.GetPlane(i);
+        planes[i] = ezSimdVec4f(plane.m_vNormal.x, plane.m_vNormal.y, plane.m_vNormal.z, plane.m_fNegDistance);
+      }
 
-  if (!m_BBox.Contains(vPoint))
-    return;
+      ezSimdMat4f helperMat;
+      helperMat.SetRows(planes[0], planes[1], planes[2], planes[3]);
 
-  FindObjectsInRange(vPoint, Callback, pPassThrough, m_BBox.m_vMin.x, m_BBox.m_vMax.x, m_BBox.m_vMin.y, m_BBox.m_vMax.y, m_BBox.m_vMin.z,
-                     m_BBox.m_vMax.z, 0, m_uiAddIDTopLevel, ezMath::Pow(8, m_uiMaxTreeDepth - 1), 0xFFFFFFFF);
-}
+      m_x0123 = helperMat.m_col0;
+      m_y0123 = helperMat.m_col1;
+      m_z0123 = helperMat.m_col2;
+      m_w0123 = helperMat.m_col3;
 
-void ezDynamicOctree::FindVisibleObjects(const ezFrustum& Viewfrustum, EZ_VISIBLE_OBJ_CALLBACK Callback, void* pPassThrough) const
-{
-  EZ_ASSERT_DEV(m_uiMaxTreeDepth > 0, "ezDynamicOctree::FindVisibleObjects: You have to first create the tree.");
+      helperMat.SetRows(planes[4], planes[5], planes[4], planes[5]);
 
-  if (m_NodeMap.IsEmpty())
-    return;
+      m_x4545 = helperMat.m_col0;
+      m_y4545 = helperMat.m_col1;
+      m_z4545 = helperMat.m_col2;
+      m_w4545 = helperMat.m_col3;
+    }
 
-  FindVisibleObjects(Viewfrustum, Callback, pPassThrough, m_BBox.m_vMin.x, m_BBox.m_vMax.x, m_BBox.m_vMin.y, m_BBox.m_vMax.y,
-                     m_BBox.m_vMin.z, m_BBox.m_vMax.z, 0, m_uiAddIDTopLevel, ezMath::Pow(4, m_uiMaxTreeDepth - 1), 0xFFFFFFFF);
-}
+    EZ_FORCE_INLINE ezVolumePosition::Enum Classify(const ezSimdBBox& box) const
+    {
+      const ezSimdVec4f center = box.GetCenter();
+      const ezSimdVec4f halfExtents = box.GetHalfExtents();
 
-void ezDynamicOctree::FindVisibleObjects(const ezFrustum& Viewfrustum, EZ_VISIBLE_OBJ_CALLBACK Callback, void* pPassThrough, float minx,
-                                         float maxx, float miny, float maxy, float minz, float maxz, ezUInt32 uiNodeID, ezUInt32 uiAddID,
-                                         ezUInt32 uiSubAddID, ezUInt32 uiNextNodeID) const
-{
-  ezVec3 v[8];
-  v[0].Set(minx, miny, minz);
-  v[1].Set(minx, miny, maxz);
-  v[2].Set(minx, maxy, minz);
-  v[3].Set(minx, maxy, maxz);
-  v[4].Set(maxx, miny, minz);
-  v[5].Set(maxx, miny, maxz);
-  v[6].Set(maxx, maxy, minz);
-  v[7].Set(maxx, maxy, maxz);
-
-  ezVolumePosition::Enum pos = Viewfrustum.GetObjectPosition(&v[0], 8);
+      const ezSimdVec4f cx = center.Get<ezSwizzle::XXXX>();
+      const ezSimdVec4f cy = center.Get<ezSwizzle::YYYY>();
+      const ezSimdVec4f cz = center.Get<ezSwizzle::ZZZZ>();
+      const ezSimdVec4f hx = halfExtents.Get<ezSwizzle::XXXX>();
+      const ezSimdVec4f hy = halfExtents.Get<ezSwizzle::YYYY>();
+      const ezSimdVec4f hz = halfExtents.Get<ezSwizzle::ZZZZ>();
 
-  if (pos == ezVolumePosition::Outside)
-    return;
+      ezSimdVec4f dist_0123 = ezSimdVec4f::MulAdd(cx, m_x0123, m_w0123);
+      dist_0123 = ezSimdVec4f::MulAdd(cy, m_y0123, dist_0123);
+      dist_0123 = ezSimdVec4f::MulAdd(cz, m_z0123, dist_0123);
 
-  ezDynamicTree::ezMultiMapKey mmk;
-  mmk.m_uiKey = uiNodeID;
+      ezSimdVec4f dist_4545 = ezSimdVec4f::MulAdd(cx, m_x4545, m_w4545);
+      dist_4545 = ezSimdVec4f::MulAdd(cy, m_y4545, dist_4545);
+      dist_4545 = ezSimdVec4f::MulAdd(cz, m_z4545, dist_4545);
 
-  ezDynamicTreeObjectConst it1 = m_NodeMap.LowerBound(mmk);
+      // projected radius of the box onto the plane normals
+      ezSimdVec4f radius_0123 = hx.CompMul(m_x0123.Abs());
+      radius_0123 = ezSimdVec4f::MulAdd(hy, m_y0123.Abs(), radius_0123);
+      radius_0123 = ezSimdVec4f::MulAdd(hz, m_z0123.Abs(), radius_0123);
 
-  if ((!it1.IsValid()) || (it1.Key().m_uiKey >= uiNextNodeID))
-    return;
+      ezSimdVec4f radius_4545 = hx.CompMul(m_x4545.Abs());
+      radius_4545 = ezSimdVec4f::MulAdd(hy, m_y4545.Abs(), radius_4545);
+      radius_4545 = ezSimdVec4f::MulAdd(hz, m_z4545.Abs(), radius_4545);
 
-  if (pos == ezVolumePosition::Inside)
-  {
-    mmk.m_uiKey = uiNextNodeID;
+      // the plane normals point out of the frustum
+      if ((dist_0123 > radius_0123 || dist_4545 > radius_4545).AnySet<4>())
+        return ezVolumePosition::Outside;
 
-    while (it1.IsValid())
-    {
-      // first increase the iterator, the user could erase it in the callback
-      ezDynamicTreeObjectConst temp = it1;
-      ++it1;
+      if ((dist_0123 <= -radius_0123 && dist_4545 <= -radius_4545).AllSet<4>())
+        return ezVolumePosition::Inside;
 
-      Callback(pPassThrough, temp);
+      return ezVolumePosition::Intersecting;
     }
 
-    return;
-  }
-  else if (pos == ezVolumePosition::Intersecting)
-  {
-    mmk.m_uiKey = uiNodeID + 1;
+    ezSimdVec4f m_x0123, m_y0123, m_z0123, m_w0123;
+    ezSimdVec4f m_x4545, m_y4545, m_z4545, m_w4545;
+  };
 
-    while (it1.IsValid())
+  struct OctreeRangeBox
+  {
+    OctreeRangeBox(const ezVec3& vPoint, float fRadius)
     {
-      // first increase the iterator, the user could erase it in the callback
-      ezDynamicTreeObjectConst temp = it1;
-      ++it1;
-
-      Callback(pPassThrough, temp);
+      // same rounding as comparing (vPoint.x + fRadius < minx) etc.
+      m_Box.m_Min = ezSimdVec4f(vPoint.x - fRadius, vPoint.y - fRadius, vPoint.z - fRadius);
+      m_Box.m_Max = ezSimdVec4f(vPoint.x + fRadius, vPoint.y + fRadius, vPoint.z + fRadius);
     }
 
-    if (uiAddID > 0)
+    EZ_FORCE_INLINE ezVolumePosition::Enum Classify(const ezSimdBBox& box) const
     {
-      const float lx = ((maxx - minx) * 0.5f) * s_LooseOctreeFactor;
-      const float ly = ((maxy - miny) * 0.5f) * s_LooseOctreeFactor;
-      const float lz = ((maxz - minz) * 0.5f) * s_LooseOctreeFactor;
-
-      const ezUInt32 uiNodeIDBase = uiNodeID + 1;
-      const ezUInt32 uiAddIDChild = uiAddID - uiSubAddID;
-      const ezUInt32 uiSubAddIDChild = uiSubAddID >> 3;
-
-      FindVisibleObjects(Viewfrustum, Callback, pPassThrough, minx, minx + lx, miny, miny + ly, minz, minz + lz, uiNodeIDBase + uiAddID * 0,
-                         uiAddIDChild, uiSubAddIDChild, uiNodeIDBase + uiAddID * 1);
-      FindVisibleObjects(Viewfrustum, Callback, pPassThrough, minx, minx + lx, miny, miny + ly, maxz - lz, maxz, uiNodeIDBase + uiAddID * 1,
-                         uiAddIDChild, uiSubAddIDChild, uiNodeIDBase + uiAddID * 2);
-      FindVisibleObjects(Viewfrustum, Callback, pPassThrough, minx, minx + lx, maxy - ly, maxy, minz, minz + lz, uiNodeIDBase + uiAddID * 2,
-                         uiAddIDChild, uiSubAddIDChild, uiNodeIDBase + uiAddID * 3);
-      FindVisibleObjects(Viewfrustum, Callback, pPassThrough, minx, minx + lx, maxy - ly, maxy, maxz - lz, maxz, uiNodeIDBase + uiAddID * 3,
-                         uiAddIDChild, uiSubAddIDChild, uiNodeIDBase + uiAddID * 4);
-      FindVisibleObjects(Viewfrustum, Callback, pPassThrough, maxx - lx, maxx, miny, miny + ly, minz, minz + lz, uiNodeIDBase + uiAddID * 4,
-                         uiAddIDChild, uiSubAddIDChild, uiNodeIDBase + uiAddID * 5);
-      FindVisibleObjects(Viewfrustum, Callback, pPassThrough, maxx - lx, maxx, miny, miny + ly, maxz - lz, maxz, uiNodeIDBase + uiAddID * 5,
-                         uiAddIDChild, uiSubAddIDChild, uiNodeIDBase + uiAddID * 6);
-      FindVisibleObjects(Viewfrustum, Callback, pPassThrough, maxx - lx, maxx, maxy - ly, maxy, minz, minz + lz, uiNodeIDBase + uiAddID * 6,
-                         uiAddIDChild, uiSubAddIDChild, uiNodeIDBase + uiAddID * 7);
-      FindVisibleObjects(Viewfrustum, Callback, pPassThrough, maxx - lx, maxx, maxy - ly, maxy, maxz - lz, maxz, uiNodeIDBase + uiAddID * 7,
-                         uiAddIDChild, uiSubAddIDChild, uiNextNodeID);
+      if ((box.m_Min > m_Box.m_Max || box.m_Max < m_Box.m_Min).AnySet<3>())
+        return ezVolumePosition::Outside;
+
+      if ((box.m_Min >= m_Box.m_Min && box.m_Max <= m_Box.m_Max).AllSet<3>())
+        return ezVolumePosition::Inside;
+
+      return ezVolumePosition::Intersecting;
     }
-  }
+
+    ezSimdBBox m_Box;
+  };
+} // namespace
+
+ezDynamicOctree::NodeDesc ezDynamicOctree::GetRootNode() const
+{
+  NodeDesc root;
+  root.m_uiNodeID = 0;
+  root.m_uiAddID = m_uiAddIDTopLevel;
+  root.m_uiSubAddID = ezMath::Pow(8, m_uiMaxTreeDepth - 1);
+  root.m_uiNextNodeID = 0xFFFFFFFF;
+  root.minx = m_BBox.m_vMin.x;
+  root.maxx = m_BBox.m_vMax.x;
+  root.miny = m_BBox.m_vMin.y;
+  root.maxy = m_BBox.m_vMax.y;
+  root.minz = m_BBox.m_vMin.z;
+  root.maxz = m_BBox.m_vMax.z;
+  return root;
 }
 
-void ezDynamicOctree::RemoveObject(ezDynamicTreeObject obj)
+// static
+ezDynamicOctree::NodeDesc ezDynamicOctree::GetChildNode(const NodeDesc& parent, ezUInt32 uiChild)
 {
-  m_NodeMap.Remove(obj);
+  // the boxes are computed exactly like in InsertObject
+  const float lx = ((parent.maxx - parent.minx) * 0.5f) * s_LooseOctreeFactor;
+  const float ly = ((parent.maxy - parent.miny) * 0.5f) * s_LooseOctreeFactor;
+  const float lz = ((parent.maxz - parent.minz) * 0.5f) * s_LooseOctreeFactor;
+
+  const ezUInt32 uiNodeIDBase = parent.m_uiNodeID + 1;
+
+  NodeDesc child;
+  child.m_uiNodeID = uiNodeIDBase + parent.m_uiAddID * uiChild;
+  child.m_uiAddID = parent.m_uiAddID - parent.m_uiSubAddID;
+  child.m_uiSubAddID = parent.m_uiSubAddID >> 3;
+  child.m_uiNextNodeID = (uiChild < 7) ? uiNodeIDBase + parent.m_uiAddID * (uiChild + 1) : parent.m_uiNextNodeID;
+  child.minx = (uiChild & 4) ? parent.maxx - lx : parent.minx;
+  child.maxx = (uiChild & 4) ? parent.maxx : parent.minx + lx;
+  child.miny = (uiChild & 2) ? parent.maxy - ly : parent.miny;
+  child.maxy = (uiChild & 2) ? parent.maxy : parent.miny + ly;
+  child.minz = (uiChild & 1) ? parent.maxz - lz : parent.minz;
+  child.maxz = (uiChild & 1) ? parent.maxz : parent.minz + lz;
+  return child;
 }
 
-void ezDynamicOctree::RemoveObject(ezInt32 iObjectType, ezInt32 iObjectInstance)
+bool ezDynamicOctree::UpdateFlatNodes() const
 {
-  for (ezDynamicTreeObject it = m_NodeMap.GetIterator(); it.IsValid(); ++it)
+  if (!m_bFlatNodesDirty)
+    return true;
+
+  // only pay for the rebuild once the recursive queries have done about as much work as the rebuild would
+  if (static_cast<ezUInt32>(static_cast<ezInt32>(m_iNodeVisitsSinceModification)) < m_NodeMap.GetCount())
+    return false;
+
+  EZ_LOCK(m_FlatNodesMutex);
+
+  if (!m_bFlatNodesDirty)
+    return true;
+
+  m_FlatNodes.Clear();
+  m_FlatObjects.Clear();
+  m_FlatObjectIterators.Clear();
+
+  m_FlatObjects.Reserve(m_NodeMap.GetCount());
+  m_FlatObjectIterators.Reserve(m_NodeMap.GetCount());
+
+  // The node ids are assigned in depth-first order, so iterating the map visits the nodes in the same order as a recursive
+  // traversal would. The stack holds the path from the root to the current node.
+  struct OpenNode
   {
-    if ((it.Value().m_iObjectInstance == iObjectInstance) && (it.Value().m_iObjectType == iObjectType))
+    EZ_DECLARE_POD_TYPE();
+
+    NodeDesc m_Node;
+    ezUInt32 m_uiFlatNode;
+  };
+
+  ezHybridArray<OpenNode, 32> openNodes;
+
+  auto pushNode = [&](const NodeDesc& node) {
+    FlatNode& flatNode = m_FlatNodes.ExpandAndGetRef();
+    flatNode.m_Box.m_Min = ezSimdVec4f(node.minx, node.miny, node.minz);
+    flatNode.m_Box.m_Max = ezSimdVec4f(node.maxx, node.maxy, node.maxz);
+    flatNode.m_uiFirstObject = m_FlatObjects.GetCount();
+    flatNode.m_uiNumObjects = 0;
+
+    OpenNode& openNode = openNodes.ExpandAndGetRef();
+    openNode.m_Node = node;
+    openNode.m_uiFlatNode = m_FlatNodes.GetCount() - 1;
+  };
+
+  auto popNode = [&]() {
+    FlatNode& flatNode = m_FlatNodes[openNodes.PeekBack().m_uiFlatNode];
+    flatNode.m_uiSubtreeEnd = m_FlatObjects.GetCount();
+    flatNode.m_uiNextNode = m_FlatNodes.GetCount();
+
+    openNodes.PopBack();
+  };
+
+  pushNode(GetRootNode());
+
+  for (ezDynamicTreeObjectConst it = m_NodeMap.GetIterator(); it.IsValid(); ++it)
+  {
+    const ezUInt32 uiNodeID = it.Key().m_uiKey;
+
+    while (uiNodeID >= openNodes.PeekBack().m_Node.m_uiNextNodeID)
     {
-      m_NodeMap.Remove(it);
-      return;
+      popNode();
     }
+
+    // descend to the node
+    while (openNodes.PeekBack().m_Node.m_uiNodeID != uiNodeID)
+    {
+      const NodeDesc& parent = openNodes.PeekBack().m_Node;
+      const ezUInt32 uiChild = (uiNodeID - (parent.m_uiNodeID + 1)) / parent.m_uiAddID;
+
+      pushNode(GetChildNode(parent, uiChild));
+    }
+
+    ++m_FlatNodes[openNodes.PeekBack().m_uiFlatNode].m_uiNumObjects;
+
+    m_FlatObjects.PushBack(it.Value());
+    m_FlatObjectIterators.PushBack(it);
+  }
+
+  while (!openNodes.IsEmpty())
+  {
+    popNode();
   }
+
+  m_bFlatNodesDirty = false;
+  return true;
 }
 
-void ezDynamicOctree::RemoveObjectsOfType(ezInt32 iObjectType)
+template <typename Classifier, typename Visitor>
+bool ezDynamicOctree::TraverseFlatNodes(Classifier classifier, Visitor visitor) const
 {
-  for (ezDynamicTreeObject it = m_NodeMap.GetIterator(); it.IsValid();)
+  const FlatNode* pNodes = m_FlatNodes.GetData();
+  const ezUInt32 uiNumNodes = m_FlatNodes.GetCount();
+
+  ezUInt32 uiNode = 0;
+  while (uiNode < uiNumNodes)
   {
-    if (it.Value().m_iObjectType == iObjectType)
+    const FlatNode& node = pNodes[uiNode];
+
+    const ezVolumePosition::Enum pos = classifier(node.m_Box);
+
+    if (pos == ezVolumePosition::Outside)
     {
-      ezDynamicTreeObject itold = it;
-      ++it;
+      uiNode = node.m_uiNextNode;
+    }
+    else if (pos == ezVolumePosition::Inside)
+    {
+      // the whole subtree is inside, return all of its objects at once
+      if (!visitor(node.m_uiFirstObject, node.m_uiSubtreeEnd))
+        return false;
 
-      m_NodeMap.Remove(itold);
+      uiNode = node.m_uiNextNode;
     }
     else
-      ++it;
+    {
+      if (node.m_uiNumObjects > 0 && !visitor(node.m_uiFirstObject, node.m_uiFirstObject + node.m_uiNumObjects))
+        return false;
+
+      ++uiNode;
+    }
   }
+
+  return true;
 }
 
+template <typename Classifier, typename Visitor>
+bool ezDynamicOctree::TraverseNodeMap(Classifier classifier, Visitor visitor) const
+{
+  ezUInt32 uiNumVisitedNodes = 0;
+  const bool bResult = TraverseNodeMap(GetRootNode(), classifier, visitor, uiNumVisitedNodes);
 
+  m_iNodeVisitsSinceModification.Add(static_cast<ezInt32>(uiNumVisitedNodes));
+  return bResult;
+}
 
-bool ezDynamicOctree::FindObjectsInRange(const ezVec3& vPoint, EZ_VISIBLE_OBJ_CALLBACK Callback, void* pPassThrough, float minx, float maxx,
-                                         float miny, float maxy, float minz, float maxz, ezUInt32 uiNodeID, ezUInt32 uiAddID,
-                                         ezUInt32 uiSubAddID, ezUInt32 uiNextNodeID) const
+template <typename Classifier, typename Visitor>
+bool ezDynamicOctree::TraverseNodeMap(const NodeDesc& node, Classifier& classifier, Visitor& visitor, ezUInt32& inout_uiNumVisitedNodes) const
 {
-  if (vPoint.x < minx)
-    return true;
-  if (vPoint.x > maxx)
-    return true;
-  if (vPoint.y < miny)
-    return true;
-  if (vPoint.y > maxy)
-    return true;
-  if (vPoint.z < minz)
-    return true;
-  if (vPoint.z > maxz)
-    return true;
+  ++inout_uiNumVisitedNodes;
 
   ezDynamicTree::ezMultiMapKey mmk;
-  mmk.m_uiKey = uiNodeID;
+  mmk.m_uiKey = node.m_uiNodeID;
 
-  ezDynamicTreeObjectConst it1 = m_NodeMap.LowerBound(mmk);
+  ezDynamicTreeObjectConst it = m_NodeMap.LowerBound(mmk);
 
-  if ((!it1.IsValid()) || (it1.Key().m_uiKey >= uiNextNodeID))
+  // if the whole subtree doesn't contain any data, no need to check further
+  if (!it.IsValid() || it.Key().m_uiKey >= node.m_uiNextNodeID)
     return true;
 
-  {
-    {
-      ezDynamicTree::ezMultiMapKey mmk2;
-      mmk2.m_uiKey = uiNodeID + 1;
+  ezSimdBBox box;
+  box.m_Min = ezSimdVec4f(node.minx, node.miny, node.minz);
+  box.m_Max = ezSimdVec4f(node.maxx, node.maxy, node.maxz);
 
-      const ezDynamicTreeObjectConst itlast = m_NodeMap.LowerBound(mmk2);
+  const ezVolumePosition::Enum pos = classifier(box);
 
-      while (it1 != itlast)
-      {
-        // first increase the iterator, the user could erase it in the callback
-        ezDynamicTreeObjectConst temp = it1;
-        ++it1;
+  if (pos == ezVolumePosition::Outside)
+    return true;
 
-        if (!Callback(pPassThrough, temp))
-          return false;
-      }
-    }
+  // if the whole subtree is inside, return all of its objects at once, otherwise only the objects stored at this node
+  const ezUInt32 uiEndNodeID = (pos == ezVolumePosition::Inside) ? node.m_uiNextNodeID : node.m_uiNodeID + 1;
 
-    if (uiAddID > 0)
-    {
-      const float lx = ((maxx - minx) * 0.5f) * s_LooseOctreeFactor;
-      const float ly = ((maxy - miny) * 0.5f) * s_LooseOctreeFactor;
-      const float lz = ((maxz - minz) * 0.5f) * s_LooseOctreeFactor;
+  for (; it.IsValid() && it.Key().m_uiKey < uiEndNodeID; ++it)
+  {
+    if (!visitor(it))
+      return false;
+  }
 
-      const ezUInt32 uiNodeIDBase = uiNodeID + 1;
-      const ezUInt32 uiAddIDChild = uiAddID - uiSubAddID;
-      const ezUInt32 uiSubAddIDChild = uiSubAddID >> 3;
+  if (pos == ezVolumePosition::Inside || node.m_uiAddID == 0)
+    return true;
 
-      if (!FindObjectsInRange(vPoint, Callback, pPassThrough, minx, minx + lx, miny, miny + ly, minz, minz + lz, uiNodeIDBase + uiAddID * 0,
-                              uiAddIDChild, uiSubAddIDChild, uiNodeIDBase + uiAddID * 1))
-        return false;
-      if (!FindObjectsInRange(vPoint, Callback, pPassThrough, minx, minx + lx, miny, miny + ly, maxz - lz, maxz, uiNodeIDBase + uiAddID * 1,
-                              uiAddIDChild, uiSubAddIDChild, uiNodeIDBase + uiAddID * 2))
-        return false;
-      if (!FindObjectsInRange(vPoint, Callback, pPassThrough, minx, minx + lx, maxy - ly, maxy, minz, minz + lz, uiNodeIDBase + uiAddID * 2,
-                              uiAddIDChild, uiSubAddIDChild, uiNodeIDBase + uiAddID * 3))
-        return false;
-      if (!FindObjectsInRange(vPoint, Callback, pPassThrough, minx, minx + lx, maxy - ly, maxy, maxz - lz, maxz, uiNodeIDBase + uiAddID * 3,
-                              uiAddIDChild, uiSubAddIDChild, uiNodeIDBase + uiAddID * 4))
-        return false;
-      if (!FindObjectsInRange(vPoint, Callback, pPassThrough, maxx - lx, maxx, miny, miny + ly, minz, minz + lz, uiNodeIDBase + uiAddID * 4,
-                              uiAddIDChild, uiSubAddIDChild, uiNodeIDBase + uiAddID * 5))
-        return false;
-      if (!FindObjectsInRange(vPoint, Callback, pPassThrough, maxx - lx, maxx, miny, miny + ly, maxz - lz, maxz, uiNodeIDBase + uiAddID * 5,
-                              uiAddIDChild, uiSubAddIDChild, uiNodeIDBase + uiAddID * 6))
-        return false;
-      if (!FindObjectsInRange(vPoint, Callback, pPassThrough, maxx - lx, maxx, maxy - ly, maxy, minz, minz + lz, uiNodeIDBase + uiAddID * 6,
-                              uiAddIDChild, uiSubAddIDChild, uiNodeIDBase + uiAddID * 7))
-        return false;
-      if (!FindObjectsInRange(vPoint, Callback, pPassThrough, maxx - lx, maxx, maxy - ly, maxy, maxz - lz, maxz, uiNodeIDBase + uiAddID * 7,
-                              uiAddIDChild, uiSubAddIDChild, uiNextNodeID))
-        return false;
-    }
+  for (ezUInt32 uiChild = 0; uiChild < 8; ++uiChild)
+  {
+    if (!TraverseNodeMap(GetChildNode(node, uiChild), classifier, visitor, inout_uiNumVisitedNodes))
+      return false;
   }
 
   return true;
 }
 
+bool ezDynamicOctree::CallCallback(ezUInt32 uiFirstObject, ezUInt32 uiEndObject, EZ_VISIBLE_OBJ_CALLBACK Callback, void* pPassThrough) const
+{
+  for (ezUInt32 i = uiFirstObject; i < uiEndObject; ++i)
+  {
+    if (!Callback(pPassThrough, m_FlatObjectIterators[i]))
+      return false;
+  }
+
+  return true;
+}
+
+void ezDynamicOctree::FindObjectsInRange(const ezVec3& vPoint, EZ_VISIBLE_OBJ_CALLBACK Callback, void* pPassThrough) const
+{
+  FindObjectsInRange(vPoint, 0.0f, Callback, pPassThrough);
+}
+
+void ezDynamicOctree::FindObjectsInRange(const ezVec3& vPoint, ezDynamicArray<ezDynamicTree::ezObjectData>& out_Objects) const
+{
+  FindObjectsInRange(vPoint, 0.0f, out_Objects);
+}
+
 void ezDynamicOctree::FindObjectsInRange(const ezVec3& vPoint, float fRadius, EZ_VISIBLE_OBJ_CALLBACK Callback, void* pPassThrough) const
 {
   EZ_ASSERT_DEV(m_uiMaxTreeDepth > 0, "ezDynamicOctree::FindObjectsInRange: You have to first create the tree.");
@@ -402,93 +520,129 @@ void ezDynamicOctree::FindObjectsInRange(const ezVec3& vPoint, float fRadius, EZ
   if (m_NodeMap.IsEmpty())
     return;
 
-  FindObjectsInRange(vPoint, fRadius, Callback, pPassThrough, m_BBox.m_vMin.x, m_BBox.m_vMax.x, m_BBox.m_vMin.y, m_BBox.m_vMax.y,
-                     m_BBox.m_vMin.z, m_BBox.m_vMax.z, 0, m_uiAddIDTopLevel, ezMath::Pow(8, m_uiMaxTreeDepth - 1), 0xFFFFFFFF);
+  const OctreeRangeBox range(vPoint, fRadius);
+  auto classifier = [&](const ezSimdBBox& box) { return range.Classify(box); };
+
+  if (UpdateFlatNodes())
+  {
+    TraverseFlatNodes(classifier,
+      [&](ezUInt32 uiFirstObject, ezUInt32 uiEndObject) { return CallCallback(uiFirstObject, uiEndObject, Callback, pPassThrough); });
+  }
+  else
+  {
+    TraverseNodeMap(classifier, [&](ezDynamicTreeObjectConst it) { return Callback(pPassThrough, it); });
+  }
 }
 
-bool ezDynamicOctree::FindObjectsInRange(const ezVec3& vPoint, float fRadius, EZ_VISIBLE_OBJ_CALLBACK Callback, void* pPassThrough,
-                                         float minx, float maxx, float miny, float maxy, float minz, float maxz, ezUInt32 uiNodeID,
-                                         ezUInt32 uiAddID, ezUInt32 uiSubAddID, ezUInt32 uiNextNodeID) const
+void ezDynamicOctree::FindObjectsInRange(const ezVec3& vPoint, float fRadius, ezDynamicArray<ezDynamicTree::ezObjectData>& out_Objects) const
 {
-  if (vPoint.x + fRadius < minx)
-    return true;
-  if (vPoint.x - fRadius > maxx)
-    return true;
-  if (vPoint.y + fRadius < miny)
-    return true;
-  if (vPoint.y - fRadius > maxy)
-    return true;
-  if (vPoint.z + fRadius < minz)
-    return true;
-  if (vPoint.z - fRadius > maxz)
-    return true;
+  EZ_ASSERT_DEV(m_uiMaxTreeDepth > 0, "ezDynamicOctree::FindObjectsInRange: You have to first create the tree.");
 
-  ezDynamicTree::ezMultiMapKey mmk;
-  mmk.m_uiKey = uiNodeID;
+  if (m_NodeMap.IsEmpty())
+    return;
 
-  ezDynamicTreeObjectConst it1 = m_NodeMap.LowerBound(mmk);
+  const OctreeRangeBox range(vPoint, fRadius);
+  auto classifier = [&](const ezSimdBBox& box) { return range.Classify(box); };
 
-  // if the whole sub-tree doesn't contain any data, no need to check further
-  if ((!it1.IsValid()) || (it1.Key().m_uiKey >= uiNextNodeID))
-    return true;
+  if (UpdateFlatNodes())
+  {
+    TraverseFlatNodes(classifier, [&](ezUInt32 uiFirstObject, ezUInt32 uiEndObject) {
+      out_Objects.PushBackRange(m_FlatObjects.GetArrayPtr().GetSubArray(uiFirstObject, uiEndObject - uiFirstObject));
+      return true;
+    });
+  }
+  else
+  {
+    TraverseNodeMap(classifier, [&](ezDynamicTreeObjectConst it) {
+      out_Objects.PushBack(it.Value());
+      return true;
+    });
+  }
+}
+
+void ezDynamicOctree::FindVisibleObjects(const ezFrustum& Viewfrustum, EZ_VISIBLE_OBJ_CALLBACK Callback, void* pPassThrough) const
+{
+  EZ_ASSERT_DEV(m_uiMaxTreeDepth > 0, "ezDynamicOctree::FindVisibleObjects: You have to first create the tree.");
+
+  if (m_NodeMap.IsEmpty())
+    return;
 
+  const OctreeFrustumPlanes planes(Viewfrustum);
+  auto classifier = [&](const ezSimdBBox& box) { return planes.Classify(box); };
+
+  if (UpdateFlatNodes())
+  {
+    TraverseFlatNodes(classifier,
+      [&](ezUInt32 uiFirstObject, ezUInt32 uiEndObject) { return CallCallback(uiFirstObject, uiEndObject, Callback, pPassThrough); });
+  }
+  else
   {
+    TraverseNodeMap(classifier, [&](ezDynamicTreeObjectConst it) { return Callback(pPassThrough, it); });
+  }
+}
 
-    // return all objects stored at this node
-    {
-      while (it1.IsValid() && (it1.Key().m_uiKey == uiNodeID))
-      {
-        // first increase the iterator, the user could erase it in the callback
-        ezDynamicTreeObjectConst temp = it1;
-        ++it1;
+void ezDynamicOctree::FindVisibleObjects(const ezFrustum& Viewfrustum, ezDynamicArray<ezDynamicTree::ezObjectData>& out_Objects) const
+{
+  EZ_ASSERT_DEV(m_uiMaxTreeDepth > 0, "ezDynamicOctree::FindVisibleObjects: You have to first create the tree.");
 
-        if (!Callback(pPassThrough, temp))
-          return false;
-      }
-    }
+  if (m_NodeMap.IsEmpty())
+    return;
 
-    // if the node has children
-    if (uiAddID > 0)
-    {
-      const float lx = ((maxx - minx) * 0.5f) * s_LooseOctreeFactor;
-      const float ly = ((maxy - miny) * 0.5f) * s_LooseOctreeFactor;
-      const float lz = ((maxz - minz) * 0.5f) * s_LooseOctreeFactor;
+  const OctreeFrustumPlanes planes(Viewfrustum);
+  auto classifier = [&](const ezSimdBBox& box) { return planes.Classify(box); };
 
-      const ezUInt32 uiNodeIDBase = uiNodeID + 1;
-      const ezUInt32 uiAddIDChild = uiAddID - uiSubAddID;
-      const ezUInt32 uiSubAddIDChild = uiSubAddID >> 3;
+  if (UpdateFlatNodes())
+  {
+    TraverseFlatNodes(classifier, [&](ezUInt32 uiFirstObject, ezUInt32 uiEndObject) {
+      out_Objects.PushBackRange(m_FlatObjects.GetArrayPtr().GetSubArray(uiFirstObject, uiEndObject - uiFirstObject));
+      return true;
+    });
+  }
+  else
+  {
+    TraverseNodeMap(classifier, [&](ezDynamicTreeObjectConst it) {
+      out_Objects.PushBack(it.Value());
+      return true;
+    });
+  }
+}
 
-      if (!FindObjectsInRange(vPoint, fRadius, Callback, pPassThrough, minx, minx + lx, miny, miny + ly, minz, minz + lz,
-                              uiNodeIDBase + uiAddID * 0, uiAddIDChild, uiSubAddIDChild, uiNodeIDBase + uiAddID * 1))
-        return false;
-      if (!FindObjectsInRange(vPoint, fRadius, Callback, pPassThrough, minx, minx + lx, miny, miny + ly, maxz - lz, maxz,
-                              uiNodeIDBase + uiAddID * 1, uiAddIDChild, uiSubAddIDChild, uiNodeIDBase + uiAddID * 2))
-        return false;
-      if (!FindObjectsInRange(vPoint, fRadius, Callback, pPassThrough, minx, minx + lx, maxy - ly, maxy, minz, minz + lz,
-                              uiNodeIDBase + uiAddID * 2, uiAddIDChild, uiSubAddIDChild, uiNodeIDBase + uiAddID * 3))
-        return false;
-      if (!FindObjectsInRange(vPoint, fRadius, Callback, pPassThrough, minx, minx + lx, maxy - ly, maxy, maxz - lz, maxz,
-                              uiNodeIDBase + uiAddID * 3, uiAddIDChild, uiSubAddIDChild, uiNodeIDBase + uiAddID * 4))
-        return false;
-      if (!FindObjectsInRange(vPoint, fRadius, Callback, pPassThrough, maxx - lx, maxx, miny, miny + ly, minz, minz + lz,
-                              uiNodeIDBase + uiAddID * 4, uiAddIDChild, uiSubAddIDChild, uiNodeIDBase + uiAddID * 5))
-        return false;
-      if (!FindObjectsInRange(vPoint, fRadius, Callback, pPassThrough, maxx - lx, maxx, miny, miny + ly, maxz - lz, maxz,
-                              uiNodeIDBase + uiAddID * 5, uiAddIDChild, uiSubAddIDChild, uiNodeIDBase + uiAddID * 6))
-        return false;
-      if (!FindObjectsInRange(vPoint, fRadius, Callback, pPassThrough, maxx - lx, maxx, maxy - ly, maxy, minz, minz + lz,
-                              uiNodeIDBase + uiAddID * 6, uiAddIDChild, uiSubAddIDChild, uiNodeIDBase + uiAddID * 7))
-        return false;
-      if (!FindObjectsInRange(vPoint, fRadius, Callback, pPassThrough, maxx - lx, maxx, maxy - ly, maxy, maxz - lz, maxz,
-                              uiNodeIDBase + uiAddID * 7, uiAddIDChild, uiSubAddIDChild, uiNextNodeID))
-        return false;
+void ezDynamicOctree::RemoveObject(ezDynamicTreeObject obj)
+{
+  m_NodeMap.Remove(obj);
+  InvalidateFlatNodes();
+}
+
+void ezDynamicOctree::RemoveObject(ezInt32 iObjectType, ezInt32 iObjectInstance)
+{
+  for (ezDynamicTreeObject it = m_NodeMap.GetIterator(); it.IsValid(); ++it)
+  {
+    if ((it.Value().m_iObjectInstance == iObjectInstance) && (it.Value().m_iObjectType == iObjectType))
+    {
+      m_NodeMap.Remove(it);
+      InvalidateFlatNodes();
+      return;
     }
   }
+}
 
-  return true;
+void ezDynamicOctree::RemoveObjectsOfType(ezInt32 iObjectType)
+{
+  for (ezDynamicTreeObject it = m_NodeMap.GetIterator(); it.IsValid();)
+  {
+    if (it.Value().m_iObjectType == iObjectType)
+    {
+      ezDynamicTreeObject itold = it;
+      ++it;
+
+      m_NodeMap.Remove(itold);
+      InvalidateFlatNodes();
+    }
+    else
+      ++it;
+  }
 }
 
 
 
 EZ_STATICLINK_FILE(Utilities, Utilities_DataStructures_Implementation_DynamicOctree);
-
@@ -10,6 +10,8 @@ struct ezDynamicTree
 {
   struct ezObjectData
   {
+    EZ_DECLARE_POD_TYPE();
+
     ezInt32 m_iObjectType;
     ezInt32 m_iObjectInstance;
   };
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <Foundation/Containers/Deque.h>
+#include <Foundation/Containers/DynamicArray.h>
 #include <Foundation/Math/Math.h>
 #include <Utilities/UtilitiesDLL.h>
 #include <Utilities/PathFinding/PathState.h>
@@ -11,6 +13,9 @@
 ///
 /// PathStateType must be derived from ezPathState and can be used for keeping track of certain state along a path and to modify
 /// the path search dynamically.
+///
+/// The nodes that still need to be expanded are kept in a binary heap, ordered by their estimated costs. All internal storage is kept
+/// between searches, so reusing the same ezPathSearch object for many queries avoids most allocations.
 template <typename PathStateType>
 class ezPathSearch
 {
@@ -56,16 +61,54 @@ public:
   /// \brief Needs to be called by the used ezPathStateGenerator to add nodes to evaluate.
   void AddPathNode(ezInt64 iNodeIndex, const PathStateType& NewState);
 
+  /// \brief Tells the path search that all node indices are in the range [0; uiNumNodes), e.g. the cell indices of a grid.
+  ///
+  /// The visited nodes are then looked up in a flat array instead of a hash table, which does not need to be cleared between searches.
+  /// This needs 8 bytes per node. Pass 0 to go back to the hash table, which is the default and works with arbitrary node indices.
+  void SetNodeIndexRange(ezUInt32 uiNumNodes);
+
 private:
+  struct NodeData
+  {
+    PathStateType m_State;
+    ezInt64 m_iNodeIndex;
+
+    /// The position of this node in m_OpenList, ezInvalidIndex if it is not (or not anymore) in the open list.
+    ezUInt32 m_uiOpenListIndex;
+  };
+
+  struct OpenListEntry
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    float m_fEstimatedCostToTarget;
+    ezUInt32 m_uiNodeData;
+  };
+
   void ClearPathStates();
-  ezInt64 FindBestNodeToExpand(PathStateType*& out_pPathState);
-  void FillOutPathResult(ezInt64 iEndNodeIndex, ezDeque<PathResultData>& out_Path);
+  ezUInt32 FindNodeData(ezInt64 iNodeIndex) const;
+  ezUInt32 AddNodeData(ezInt64 iNodeIndex);
+  void StartWithNode(ezInt64 iStartNodeIndex, const PathStateType& StartState);
+  ezUInt32 FindBestNodeToExpand();
+  void MoveUpInOpenList(ezUInt32 uiOpenListIndex);
+  void MoveDownInOpenList(ezUInt32 uiOpenListIndex);
+  void FillOutPathResult(ezUInt32 uiEndNodeData, ezDeque<PathResultData>& out_Path);
 
   ezPathStateGenerator<PathStateType>* m_pStateGenerator;
 
-  ezHashTable<ezInt64, PathStateType> m_PathStates;
+  /// All nodes visited during the current search, in the order they were reached.
+  ezDynamicArray<NodeData> m_NodeData;
+
+  /// Maps node indices to m_NodeData, used when no node index range is set.
+  ezHashTable<ezInt64, ezUInt32> m_NodeIndexToData;
+
+  /// Used instead of m_NodeIndexToData when a node index range is set. An entry is only valid if the search ID matches the current one.
+  ezDynamicArray<ezUInt32> m_NodeIndexToDataDense;
+  ezDynamicArray<ezUInt32> m_NodeIndexSearchID;
+  ezUInt32 m_uiSearchID = 0;
 
-  ezDeque<ezInt64> m_StateQueue;
+  /// Binary min-heap of the nodes that still need to be expanded.
+  ezDynamicArray<OpenListEntry> m_OpenList;
 
   ezInt64 m_iCurNodeIndex;
   PathStateType m_CurState;
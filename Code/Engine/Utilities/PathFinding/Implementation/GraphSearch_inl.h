@@ -1,60 +1,173 @@
 #pragma once
 
 template <typename PathStateType>
-void ezPathSearch<PathStateType>::ClearPathStates()
+void ezPathSearch<PathStateType>::SetNodeIndexRange(ezUInt32 uiNumNodes)
 {
-  m_PathStates.Clear();
-  m_StateQueue.Clear();
+  m_NodeIndexToDataDense.Clear();
+  m_NodeIndexSearchID.Clear();
+
+  m_NodeIndexToDataDense.SetCountUninitialized(uiNumNodes);
+  m_NodeIndexSearchID.SetCount(uiNumNodes, 0);
+  m_uiSearchID = 0;
 }
 
 template <typename PathStateType>
-ezInt64 ezPathSearch<PathStateType>::FindBestNodeToExpand(PathStateType*& out_pPathState)
+void ezPathSearch<PathStateType>::ClearPathStates()
 {
-  float fLowestEstimation = ezMath::Infinity<float>();
-  out_pPathState = nullptr;
-  ezUInt32 iBestInQueue = 0;
+  m_NodeData.Clear();
+  m_OpenList.Clear();
 
-  for (ezUInt32 i = 0; i < m_StateQueue.GetCount(); ++i)
+  if (m_NodeIndexSearchID.IsEmpty())
   {
-    const ezInt64 iNodeIndex = m_StateQueue[i];
-
-    PathStateType* pState = &m_PathStates[iNodeIndex];
+    m_NodeIndexToData.Clear();
+  }
+  else
+  {
+    ++m_uiSearchID;
 
-    if (pState->m_fEstimatedCostToTarget < fLowestEstimation)
+    // all search IDs have been used up, reset the stamps once
+    if (m_uiSearchID == 0)
     {
-      fLowestEstimation = pState->m_fEstimatedCostToTarget;
-      out_pPathState = pState;
-      iBestInQueue = i;
+      m_NodeIndexSearchID.SetCount(0);
+      m_NodeIndexSearchID.SetCount(m_NodeIndexToDataDense.GetCount(), 0);
+      m_uiSearchID = 1;
     }
   }
+}
 
-  EZ_ASSERT_DEV(out_pPathState != nullptr, "Implementation Error");
+template <typename PathStateType>
+ezUInt32 ezPathSearch<PathStateType>::FindNodeData(ezInt64 iNodeIndex) const
+{
+  if (m_NodeIndexSearchID.IsEmpty())
+  {
+    ezUInt32 uiNodeData = ezInvalidIndex;
+    m_NodeIndexToData.TryGetValue(iNodeIndex, uiNodeData);
+    return uiNodeData;
+  }
 
-  const ezInt64 iBestNodeIndex = m_StateQueue[iBestInQueue];
-  m_StateQueue.RemoveAtAndSwap(iBestInQueue);
+  EZ_ASSERT_DEBUG(iNodeIndex >= 0 && iNodeIndex < (ezInt64)m_NodeIndexSearchID.GetCount(), "Node index {0} is outside the node index range", iNodeIndex);
 
-  return iBestNodeIndex;
+  if (m_NodeIndexSearchID[(ezUInt32)iNodeIndex] != m_uiSearchID)
+    return ezInvalidIndex;
+
+  return m_NodeIndexToDataDense[(ezUInt32)iNodeIndex];
 }
 
 template <typename PathStateType>
-void ezPathSearch<PathStateType>::FillOutPathResult(ezInt64 iEndNodeIndex, ezDeque<PathResultData>& out_Path)
+ezUInt32 ezPathSearch<PathStateType>::AddNodeData(ezInt64 iNodeIndex)
+{
+  const ezUInt32 uiNodeData = m_NodeData.GetCount();
+
+  NodeData& data = m_NodeData.ExpandAndGetRef();
+  data.m_iNodeIndex = iNodeIndex;
+  data.m_uiOpenListIndex = ezInvalidIndex;
+
+  if (m_NodeIndexSearchID.IsEmpty())
+  {
+    m_NodeIndexToData.Insert(iNodeIndex, uiNodeData);
+  }
+  else
+  {
+    EZ_ASSERT_DEBUG(iNodeIndex >= 0 && iNodeIndex < (ezInt64)m_NodeIndexSearchID.GetCount(), "Node index {0} is outside the node index range", iNodeIndex);
+
+    m_NodeIndexSearchID[(ezUInt32)iNodeIndex] = m_uiSearchID;
+    m_NodeIndexToDataDense[(ezUInt32)iNodeIndex] = uiNodeData;
+  }
+
+  return uiNodeData;
+}
+
+template <typename PathStateType>
+void ezPathSearch<PathStateType>::MoveUpInOpenList(ezUInt32 uiOpenListIndex)
+{
+  const OpenListEntry entry = m_OpenList[uiOpenListIndex];
+
+  while (uiOpenListIndex > 0)
+  {
+    const ezUInt32 uiParentIndex = (uiOpenListIndex - 1) / 2;
+    const OpenListEntry& parent = m_OpenList[uiParentIndex];
+
+    if (parent.m_fEstimatedCostToTarget <= entry.m_fEstimatedCostToTarget)
+      break;
+
+    m_OpenList[uiOpenListIndex] = parent;
+    m_NodeData[parent.m_uiNodeData].m_uiOpenListIndex = uiOpenListIndex;
+    uiOpenListIndex = uiParentIndex;
+  }
+
+  m_OpenList[uiOpenListIndex] = entry;
+  m_NodeData[entry.m_uiNodeData].m_uiOpenListIndex = uiOpenListIndex;
+}
+
+template <typename PathStateType>
+void ezPathSearch<PathStateType>::MoveDownInOpenList(ezUInt32 uiOpenListIndex)
+{
+  const OpenListEntry entry = m_OpenList[uiOpenListIndex];
+  const ezUInt32 uiCount = m_OpenList.GetCount();
+
+  while (true)
+  {
+    ezUInt32 uiChildIndex = uiOpenListIndex * 2 + 1;
+    if (uiChildIndex >= uiCount)
+      break;
+
+    // pick the cheaper one of the two children
+    if (uiChildIndex + 1 < uiCount && m_OpenList[uiChildIndex + 1].m_fEstimatedCostToTarget < m_OpenList[uiChildIndex].m_fEstimatedCostToTarget)
+      ++uiChildIndex;
+
+    const OpenListEntry& child = m_OpenList[uiChildIndex];
+
+    if (entry.m_fEstimatedCostToTarget <= child.m_fEstimatedCostToTarget)
+      break;
+
+    m_OpenList[uiOpenListIndex] = child;
+    m_NodeData[child.m_uiNodeData].m_uiOpenListIndex = uiOpenListIndex;
+    uiOpenListIndex = uiChildIndex;
+  }
+
+  m_OpenList[uiOpenListIndex] = entry;
+  m_NodeData[entry.m_uiNodeData].m_uiOpenListIndex = uiOpenListIndex;
+}
+
+template <typename PathStateType>
+ezUInt32 ezPathSearch<PathStateType>::FindBestNodeToExpand()
+{
+  EZ_ASSERT_DEV(!m_OpenList.IsEmpty(), "Implementation Error");
+
+  const ezUInt32 uiBestNodeData = m_OpenList[0].m_uiNodeData;
+  m_NodeData[uiBestNodeData].m_uiOpenListIndex = ezInvalidIndex;
+
+  const OpenListEntry last = m_OpenList.PeekBack();
+  m_OpenList.PopBack();
+
+  if (!m_OpenList.IsEmpty())
+  {
+    m_OpenList[0] = last;
+    MoveDownInOpenList(0);
+  }
+
+  return uiBestNodeData;
+}
+
+template <typename PathStateType>
+void ezPathSearch<PathStateType>::FillOutPathResult(ezUInt32 uiEndNodeData, ezDeque<PathResultData>& out_Path)
 {
   out_Path.Clear();
 
   while (true)
   {
-    const PathStateType* pCurState = &m_PathStates[iEndNodeIndex];
+    const NodeData& curNode = m_NodeData[uiEndNodeData];
 
     PathResultData r;
-    r.m_iNodeIndex = iEndNodeIndex;
-    r.m_pPathState = pCurState;
+    r.m_iNodeIndex = curNode.m_iNodeIndex;
+    r.m_pPathState = &curNode.m_State;
 
     out_Path.PushFront(r);
 
-    if (iEndNodeIndex == pCurState->m_iReachedThroughNode)
+    if (curNode.m_iNodeIndex == curNode.m_State.m_iReachedThroughNode)
       return;
 
-    iEndNodeIndex = pCurState->m_iReachedThroughNode;
+    uiEndNodeData = FindNodeData(curNode.m_State.m_iReachedThroughNode);
   }
 }
 
@@ -69,28 +182,57 @@ void ezPathSearch<PathStateType>::AddPathNode(ezInt64 iNodeIndex, const PathStat
   // ezArgF(m_pCurPathState->m_fEstimatedCostToTarget, 2), ezArgF(NewState.m_fEstimatedCostToTarget, 2));
   EZ_ASSERT_DEV(NewState.m_fEstimatedCostToTarget >= NewState.m_fCostToNode, "Unrealistic expectations will get you nowhere.");
 
-  PathStateType* pExistingState;
+  ezUInt32 uiNodeData = FindNodeData(iNodeIndex);
 
-  if (m_PathStates.TryGetValue(iNodeIndex, pExistingState))
+  if (uiNodeData != ezInvalidIndex)
   {
-    // state already exists in the hash table, and has a lower cost -> ignore the new state
-    if (pExistingState->m_fCostToNode <= NewState.m_fCostToNode)
+    NodeData& existingNode = m_NodeData[uiNodeData];
+
+    // state already exists, and has a lower cost -> ignore the new state
+    if (existingNode.m_State.m_fCostToNode <= NewState.m_fCostToNode)
       return;
 
     // incoming state is better than the existing state -> update existing state
-    *pExistingState = NewState;
-    pExistingState->m_iReachedThroughNode = m_iCurNodeIndex;
+    existingNode.m_State = NewState;
+    existingNode.m_State.m_iReachedThroughNode = m_iCurNodeIndex;
+
+    // if it still waits to be expanded, move it to its new place in the queue
+    const ezUInt32 uiOpenListIndex = existingNode.m_uiOpenListIndex;
+    if (uiOpenListIndex != ezInvalidIndex)
+    {
+      m_OpenList[uiOpenListIndex].m_fEstimatedCostToTarget = NewState.m_fEstimatedCostToTarget;
+      MoveUpInOpenList(uiOpenListIndex);
+      MoveDownInOpenList(existingNode.m_uiOpenListIndex);
+    }
+
     return;
   }
 
   // the state has not been reached before -> insert it
-  pExistingState = &m_PathStates[iNodeIndex];
+  uiNodeData = AddNodeData(iNodeIndex);
 
-  *pExistingState = NewState;
-  pExistingState->m_iReachedThroughNode = m_iCurNodeIndex;
+  NodeData& newNode = m_NodeData[uiNodeData];
+  newNode.m_State = NewState;
+  newNode.m_State.m_iReachedThroughNode = m_iCurNodeIndex;
 
   // put it into the queue of states that still need to be expanded
-  m_StateQueue.PushBack(iNodeIndex);
+  m_OpenList.PushBack({NewState.m_fEstimatedCostToTarget, uiNodeData});
+  MoveUpInOpenList(m_OpenList.GetCount() - 1);
+}
+
+template <typename PathStateType>
+void ezPathSearch<PathStateType>::StartWithNode(ezInt64 iStartNodeIndex, const PathStateType& StartState)
+{
+  const ezUInt32 uiNodeData = AddNodeData(iStartNodeIndex);
+  NodeData& firstNode = m_NodeData[uiNodeData];
+
+  // make sure the first state references itself, as that is a termination criterion
+  firstNode.m_State = StartState;
+  firstNode.m_State.m_iReachedThroughNode = iStartNodeIndex;
+
+  // put the start state into the to-be-expanded queue
+  m_OpenList.PushBack({StartState.m_fEstimatedCostToTarget, uiNodeData});
+  firstNode.m_uiOpenListIndex = 0;
 }
 
 template <typename PathStateType>
@@ -103,13 +245,12 @@ ezResult ezPathSearch<PathStateType>::FindPath(ezInt64 iStartNodeIndex, const Pa
 
   if (iStartNodeIndex == iTargetNodeIndex)
   {
-    m_PathStates.Reserve(1);
-
-    m_PathStates[iTargetNodeIndex] = StartState;
+    const ezUInt32 uiNodeData = AddNodeData(iTargetNodeIndex);
+    m_NodeData[uiNodeData].m_State = StartState;
 
     PathResultData r;
     r.m_iNodeIndex = iTargetNodeIndex;
-    r.m_pPathState = &m_PathStates[iTargetNodeIndex];
+    r.m_pPathState = &m_NodeData[uiNodeData].m_State;
 
     out_Path.Clear();
     out_Path.PushBack(r);
@@ -117,29 +258,21 @@ ezResult ezPathSearch<PathStateType>::FindPath(ezInt64 iStartNodeIndex, const Pa
     return EZ_SUCCESS;
   }
 
-  m_PathStates.Reserve(10000);
+  StartWithNode(iStartNodeIndex, StartState);
 
-  PathStateType& FirstState = m_PathStates[iStartNodeIndex];
-
-  m_pStateGenerator->StartSearch(iStartNodeIndex, &FirstState, iTargetNodeIndex);
-
-  // make sure the first state references itself, as that is a termination criterion
-  FirstState = StartState;
-  FirstState.m_iReachedThroughNode = iStartNodeIndex;
-
-  // put the start state into the to-be-expanded queue
-  m_StateQueue.PushBack(iStartNodeIndex);
+  m_pStateGenerator->StartSearch(iStartNodeIndex, &m_NodeData[0].m_State, iTargetNodeIndex);
 
   // while the queue is not empty, expand the next node and see where that gets us
-  while (!m_StateQueue.IsEmpty())
+  while (!m_OpenList.IsEmpty())
   {
-    PathStateType* pCurState;
-    m_iCurNodeIndex = FindBestNodeToExpand(pCurState);
+    const ezUInt32 uiCurNodeData = FindBestNodeToExpand();
+    const PathStateType* pCurState = &m_NodeData[uiCurNodeData].m_State;
+    m_iCurNodeIndex = m_NodeData[uiCurNodeData].m_iNodeIndex;
 
     // we have reached the target node, generate the final path result
     if (m_iCurNodeIndex == iTargetNodeIndex)
     {
-      FillOutPathResult(m_iCurNodeIndex, out_Path);
+      FillOutPathResult(uiCurNodeData, out_Path);
       m_pStateGenerator->SearchFinished(EZ_SUCCESS);
       return EZ_SUCCESS;
     }
@@ -153,6 +286,7 @@ ezResult ezPathSearch<PathStateType>::FindPath(ezInt64 iStartNodeIndex, const Pa
       return EZ_FAILURE;
     }
 
+    // copy the state, adding nodes may move the node data around
     m_CurState = *pCurState;
 
     // let the generate append all the nodes that we can reach from here
@@ -172,29 +306,21 @@ ezResult ezPathSearch<PathStateType>::FindClosest(ezInt64 iStartNodeIndex, const
 
   ClearPathStates();
 
-  m_PathStates.Reserve(10000);
+  StartWithNode(iStartNodeIndex, StartState);
 
-  PathStateType& FirstState = m_PathStates[iStartNodeIndex];
-
-  m_pStateGenerator->StartSearchForClosest(iStartNodeIndex, &FirstState);
-
-  // make sure the first state references itself, as that is a termination criterion
-  FirstState = StartState;
-  FirstState.m_iReachedThroughNode = iStartNodeIndex;
-
-  // put the start state into the to-be-expanded queue
-  m_StateQueue.PushBack(iStartNodeIndex);
+  m_pStateGenerator->StartSearchForClosest(iStartNodeIndex, &m_NodeData[0].m_State);
 
   // while the queue is not empty, expand the next node and see where that gets us
-  while (!m_StateQueue.IsEmpty())
+  while (!m_OpenList.IsEmpty())
   {
-    PathStateType* pCurState;
-    m_iCurNodeIndex = FindBestNodeToExpand(pCurState);
+    const ezUInt32 uiCurNodeData = FindBestNodeToExpand();
+    const PathStateType* pCurState = &m_NodeData[uiCurNodeData].m_State;
+    m_iCurNodeIndex = m_NodeData[uiCurNodeData].m_iNodeIndex;
 
     // we have reached the target node, generate the final path result
     if (Callback(m_iCurNodeIndex, *pCurState))
     {
-      FillOutPathResult(m_iCurNodeIndex, out_Path);
+      FillOutPathResult(uiCurNodeData, out_Path);
       m_pStateGenerator->SearchFinished(EZ_SUCCESS);
       return EZ_SUCCESS;
     }
@@ -208,6 +334,7 @@ ezResult ezPathSearch<PathStateType>::FindClosest(ezInt64 iStartNodeIndex, const
       return EZ_FAILURE;
     }
 
+    // copy the state, adding nodes may move the node data around
     m_CurState = *pCurState;
 
     // let the generate append all the nodes that we can reach from here
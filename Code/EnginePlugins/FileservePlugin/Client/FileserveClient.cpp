@@ -9,6 +9,7 @@
 #include <Foundation/Logging/Log.h>
 #include <Foundation/Types/ScopeExit.h>
 #include <Foundation/Utilities/CommandLineUtils.h>
+#include <Foundation/Utilities/Compression.h>
 
 EZ_IMPLEMENT_SINGLETON(ezFileserveClient);
 
@@ -74,6 +75,9 @@ void ezFileserveClient::ClearState()
   m_CurFileRequestGuid = ezUuid();
   m_sCurFileRequest.Clear();
   m_Download.Clear();
+  m_PrefetchBatches.Clear();
+  m_PendingPrefetches.Clear();
+  m_PrefetchDownload.Clear();
 }
 
 ezResult ezFileserveClient::EnsureConnected(ezTime timeout)
@@ -171,6 +175,66 @@ void ezFileserveClient::AddServerAddressToTry(const char* szAddress)
   m_sServerConnectionAddress = szAddress;
 }
 
+void ezFileserveClient::PrefetchFiles(ezArrayPtr<const ezString> files)
+{
+  EZ_LOCK(m_Mutex);
+  if (m_Network == nullptr || !m_Network->IsConnectedToServer() || m_MountedDataDirs.IsEmpty())
+    return;
+
+  PrefetchBatch batch;
+  ezHybridArray<ezUInt16, 64> dataDirs;
+
+  for (const ezString& sFile : files)
+  {
+    if (sFile.IsEmpty() || m_PendingPrefetches.Contains(sFile))
+      continue;
+
+    bool bCachedYet = false;
+    auto itFileDataDir = m_FileDataDir.FindOrAdd(sFile, &bCachedYet);
+    if (!bCachedYet)
+    {
+      FillFileStatusCache(sFile);
+    }
+
+    const ezUInt16 uiDataDirID = itFileDataDir.Value();
+    if (!m_MountedDataDirs[uiDataDirID].m_bMounted)
+      continue;
+
+    // same as in DownloadFile, recently checked files are not requested again
+    if (m_CurrentTime - m_MountedDataDirs[uiDataDirID].m_CacheStatus[sFile].m_LastCheck < ezTime::Seconds(5.0f))
+      continue;
+
+    batch.m_Files.PushBack(sFile);
+    dataDirs.PushBack(uiDataDirID);
+  }
+
+  if (batch.m_Files.IsEmpty())
+    return;
+
+  batch.m_BatchGuid.CreateNewUuid();
+  batch.m_uiNumPending = batch.m_Files.GetCount();
+
+  ezRemoteMessage msg('FSRV', 'MANI');
+  msg.GetWriter() << batch.m_BatchGuid;
+  msg.GetWriter() << batch.m_Files.GetCount();
+
+  for (ezUInt32 i = 0; i < batch.m_Files.GetCount(); ++i)
+  {
+    const FileCacheStatus& CacheStatus = m_MountedDataDirs[dataDirs[i]].m_CacheStatus[batch.m_Files[i]];
+
+    msg.GetWriter() << dataDirs[i];
+    msg.GetWriter() << batch.m_Files[i];
+    msg.GetWriter() << CacheStatus.m_TimeStamp;
+    msg.GetWriter() << CacheStatus.m_FileHash;
+
+    m_PendingPrefetches.Insert(batch.m_Files[i]);
+  }
+
+  m_Network->Send(ezRemoteTransmitMode::Reliable, msg);
+
+  m_PrefetchBatches.PushBack(std::move(batch));
+}
+
 void ezFileserveClient::UploadFile(ezUInt16 uiDataDirID, const char* szFile, const ezDynamicArray<ezUInt8>& fileContent)
 {
   EZ_LOCK(m_Mutex);
@@ -345,6 +409,24 @@ void ezFileserveClient::NetworkMsgHandler(ezRemoteMessage& msg)
     return;
   }
 
+  if (msg.GetMessageID() == 'MAND')
+  {
+    HandleManifestDataMsg(msg);
+    return;
+  }
+
+  if (msg.GetMessageID() == 'MANF')
+  {
+    HandleManifestFileFinishedMsg(msg);
+    return;
+  }
+
+  if (msg.GetMessageID() == 'MANR')
+  {
+    HandleManifestResultsMsg(msg);
+    return;
+  }
+
   static bool s_bReloadResources = false;
 
   if (msg.GetMessageID() == 'RLDR')
@@ -497,13 +579,183 @@ void ezFileserveClient::HandleFileTransferFinishedMsg(ezRemoteMessage& msg)
   ezUInt16 uiFoundInDataDir = 0;
   msg.GetReader() >> uiFoundInDataDir;
 
+  UpdateCachedFile(m_sCurFileRequest, fileState, iFileTimeStamp, uiFileHash, uiFoundInDataDir, m_Download);
+}
+
+void ezFileserveClient::HandleManifestDataMsg(ezRemoteMessage& msg)
+{
+  EZ_LOCK(m_Mutex);
+  {
+    ezUuid batchGuid;
+    msg.GetReader() >> batchGuid;
+
+    if (FindPrefetchBatch(batchGuid) == ezInvalidIndex)
+    {
+      // ezLog::Debug("Fileserver is answering someone else");
+      return;
+    }
+  }
+
+  ezUInt16 uiChunkSize = 0;
+  msg.GetReader() >> uiChunkSize;
+
+  // the server sends one file after the other, so all chunks belong to the next 'MANF'
+  if (uiChunkSize > 0)
+  {
+    const ezUInt32 uiStartPos = m_PrefetchDownload.GetCount();
+    m_PrefetchDownload.SetCountUninitialized(uiStartPos + uiChunkSize);
+    msg.GetReader().ReadBytes(&m_PrefetchDownload[uiStartPos], uiChunkSize);
+  }
+}
+
+void ezFileserveClient::HandleManifestFileFinishedMsg(ezRemoteMessage& msg)
+{
+  EZ_LOCK(m_Mutex);
+  EZ_SCOPE_EXIT(m_PrefetchDownload.Clear());
+
+  ezUInt32 uiBatch = ezInvalidIndex;
+  {
+    ezUuid batchGuid;
+    msg.GetReader() >> batchGuid;
+
+    uiBatch = FindPrefetchBatch(batchGuid);
+    if (uiBatch == ezInvalidIndex)
+    {
+      // ezLog::Debug("Fileserver is answering someone else");
+      return;
+    }
+  }
+
+  ezUInt32 uiEntry = 0;
+  msg.GetReader() >> uiEntry;
+
+  ezFileserveFileState fileState;
+  {
+    ezInt8 iFileStatus = 0;
+    msg.GetReader() >> iFileStatus;
+    fileState = (ezFileserveFileState)iFileStatus;
+  }
+
+  ezInt64 iFileTimeStamp = 0;
+  msg.GetReader() >> iFileTimeStamp;
+
+  ezUInt64 uiFileHash = 0;
+  msg.GetReader() >> uiFileHash;
+
+  ezUInt16 uiFoundInDataDir = 0;
+  msg.GetReader() >> uiFoundInDataDir;
+
+  bool bCompressed = false;
+  msg.GetReader() >> bCompressed;
+
+  ezArrayPtr<const ezUInt8> fileContent = m_PrefetchDownload;
+
+  if (bCompressed)
+  {
+    if (ezCompressionUtils::Decompress(m_PrefetchDownload, ezCompressionMethod::ZStd, m_PrefetchDecompressed).Failed())
+    {
+      ezLog::Error("Failed to decompress a prefetched file, it will be requested again when it is accessed");
+
+      // leaves the cache state as it is, so the file is still considered to be outdated
+      fileState = ezFileserveFileState::None;
+    }
+
+    fileContent = m_PrefetchDecompressed;
+  }
+
+  FinishPrefetch(uiBatch, uiEntry, fileState, iFileTimeStamp, uiFileHash, uiFoundInDataDir, fileContent);
+}
+
+void ezFileserveClient::HandleManifestResultsMsg(ezRemoteMessage& msg)
+{
+  EZ_LOCK(m_Mutex);
+
+  ezUInt32 uiBatch = ezInvalidIndex;
+  {
+    ezUuid batchGuid;
+    msg.GetReader() >> batchGuid;
+
+    uiBatch = FindPrefetchBatch(batchGuid);
+    if (uiBatch == ezInvalidIndex)
+    {
+      // ezLog::Debug("Fileserver is answering someone else");
+      return;
+    }
+  }
+
+  ezUInt32 uiNumResults = 0;
+  msg.GetReader() >> uiNumResults;
+
+  // none of these files need to be transferred
+  for (ezUInt32 i = 0; i < uiNumResults; ++i)
+  {
+    ezUInt32 uiEntry = 0;
+    msg.GetReader() >> uiEntry;
+
+    ezInt8 iFileStatus = 0;
+    msg.GetReader() >> iFileStatus;
+
+    ezInt64 iFileTimeStamp = 0;
+    msg.GetReader() >> iFileTimeStamp;
+
+    ezUInt64 uiFileHash = 0;
+    msg.GetReader() >> uiFileHash;
+
+    ezUInt16 uiFoundInDataDir = 0;
+    msg.GetReader() >> uiFoundInDataDir;
+
+    FinishPrefetch(uiBatch, uiEntry, (ezFileserveFileState)iFileStatus, iFileTimeStamp, uiFileHash, uiFoundInDataDir, ezArrayPtr<const ezUInt8>());
+  }
+}
+
+ezUInt32 ezFileserveClient::FindPrefetchBatch(const ezUuid& batchGuid) const
+{
+  for (ezUInt32 i = 0; i < m_PrefetchBatches.GetCount(); ++i)
+  {
+    if (m_PrefetchBatches[i].m_BatchGuid == batchGuid)
+      return i;
+  }
+
+  return ezInvalidIndex;
+}
+
+void ezFileserveClient::FinishPrefetch(ezUInt32 uiBatch, ezUInt32 uiEntry, ezFileserveFileState fileState, ezInt64 iFileTimeStamp,
+                                       ezUInt64 uiFileHash, ezUInt16 uiFoundInDataDir, ezArrayPtr<const ezUInt8> fileContent)
+{
+  PrefetchBatch& batch = m_PrefetchBatches[uiBatch];
+
+  if (uiEntry >= batch.m_Files.GetCount() || !m_PendingPrefetches.Remove(batch.m_Files[uiEntry]))
+  {
+    ezLog::Error("Invalid fileserve prefetch answer for entry {0}", uiEntry);
+    return;
+  }
+
+  if (fileState != ezFileserveFileState::None)
+  {
+    UpdateCachedFile(batch.m_Files[uiEntry], fileState, iFileTimeStamp, uiFileHash, uiFoundInDataDir, fileContent);
+  }
+
+  --batch.m_uiNumPending;
+
+  // the batch is only looked up through its GUID, so the order does not matter
+  if (batch.m_uiNumPending == 0)
+  {
+    m_PrefetchBatches.RemoveAtAndSwap(uiBatch);
+  }
+}
+
+void ezFileserveClient::UpdateCachedFile(const char* szFile, ezFileserveFileState fileState, ezInt64 iFileTimeStamp, ezUInt64 uiFileHash,
+                                         ezUInt16 uiFoundInDataDir, ezArrayPtr<const ezUInt8> fileContent)
+{
+  EZ_LOCK(m_Mutex);
+
   if (uiFoundInDataDir == 0xffff) // file does not exist on server in any data dir
   {
-    m_FileDataDir[m_sCurFileRequest] = 0; // placeholder
+    m_FileDataDir[szFile] = 0; // placeholder
 
     for (ezUInt32 i = 0; i < m_MountedDataDirs.GetCount(); ++i)
     {
-      auto& ref = m_MountedDataDirs[i].m_CacheStatus[m_sCurFileRequest];
+      auto& ref = m_MountedDataDirs[i].m_CacheStatus[szFile];
       ref.m_FileHash = 0;
       ref.m_TimeStamp = 0;
       ref.m_LastCheck = m_CurrentTime;
@@ -513,9 +765,9 @@ void ezFileserveClient::HandleFileTransferFinishedMsg(ezRemoteMessage& msg)
   }
   else
   {
-    m_FileDataDir[m_sCurFileRequest] = uiFoundInDataDir;
+    m_FileDataDir[szFile] = uiFoundInDataDir;
 
-    auto& ref = m_MountedDataDirs[uiFoundInDataDir].m_CacheStatus[m_sCurFileRequest];
+    auto& ref = m_MountedDataDirs[uiFoundInDataDir].m_CacheStatus[szFile];
     ref.m_FileHash = uiFileHash;
     ref.m_TimeStamp = iFileTimeStamp;
     ref.m_LastCheck = m_CurrentTime;
@@ -527,7 +779,7 @@ void ezFileserveClient::HandleFileTransferFinishedMsg(ezRemoteMessage& msg)
 
   const ezString& sMountPoint = m_MountedDataDirs[uiFoundInDataDir].m_sMountPoint;
   ezStringBuilder sCachedFile, sCachedMetaFile;
-  BuildPathInCache(m_sCurFileRequest, sMountPoint, sCachedFile, sCachedMetaFile);
+  BuildPathInCache(szFile, sMountPoint, sCachedFile, sCachedMetaFile);
 
   if (fileState == ezFileserveFileState::NonExistant)
   {
@@ -545,7 +797,7 @@ void ezFileserveClient::HandleFileTransferFinishedMsg(ezRemoteMessage& msg)
 
   if (fileState == ezFileserveFileState::Different)
   {
-    WriteDownloadToDisk(sCachedFile);
+    WriteDownloadToDisk(sCachedFile, fileContent);
     WriteMetaFile(sCachedMetaFile, iFileTimeStamp, uiFileHash);
   }
 }
@@ -567,14 +819,13 @@ void ezFileserveClient::WriteMetaFile(ezStringBuilder sCachedMetaFile, ezInt64 i
   }
 }
 
-void ezFileserveClient::WriteDownloadToDisk(ezStringBuilder sCachedFile)
+void ezFileserveClient::WriteDownloadToDisk(ezStringBuilder sCachedFile, ezArrayPtr<const ezUInt8> fileContent)
 {
-  EZ_LOCK(m_Mutex);
   ezOSFile file;
   if (file.Open(sCachedFile, ezFileOpenMode::Write).Succeeded())
   {
-    if (!m_Download.IsEmpty())
-      file.Write(m_Download.GetData(), m_Download.GetCount());
+    if (!fileContent.IsEmpty())
+      file.Write(fileContent.GetPtr(), fileContent.GetCount());
 
     file.Close();
   }
@@ -600,6 +851,13 @@ ezResult ezFileserveClient::DownloadFile(ezUInt16 uiDataDirID, const char* szFil
   if (!m_Network->IsConnectedToServer())
     return EZ_FAILURE;
 
+  // the file was already requested through PrefetchFiles(), its answer updates the cache status below
+  while (m_PendingPrefetches.Contains(szFile) && m_Network->IsConnectedToServer())
+  {
+    m_Network->UpdateRemoteInterface();
+    m_Network->ExecuteAllMessageHandlers();
+  }
+
   bool bCachedYet = false;
   auto itFileDataDir = m_FileDataDir.FindOrAdd(szFile, &bCachedYet);
   if (!bCachedYet)
@@ -879,6 +1137,44 @@ EZ_ON_GLOBAL_EVENT(GameApp_UpdatePlugins)
   }
 }
 
+// broadcast by ezResourceManager, we cannot have a link dependency on Core
+EZ_ON_GLOBAL_EVENT(ezResourceManager_ResourcesQueuedForLoading)
+{
+  ezFileserveClient* pClient = ezFileserveClient::GetSingleton();
+  if (pClient == nullptr || !param0.IsA<ezVariantArray>())
+    return;
+
+  const ezVariantArray& resourceIDs = param0.Get<ezVariantArray>();
+
+  ezDynamicArray<ezString> files;
+  files.Reserve(resourceIDs.GetCount());
+
+  ezStringBuilder sPath, sRelativePath;
+  for (const ezVariant& id : resourceIDs)
+  {
+    if (!id.IsA<ezString>())
+      continue;
+
+    // same as in FileserveType::OpenFileToRead, the server cannot resolve asset GUIDs
+    ezFileSystem::ResolveAssetRedirection(id.Get<ezString>(), sPath);
+    if (sPath.IsEmpty() || ezConversionUtils::IsStringUuid(sPath) || ezPathUtils::IsAbsolutePath(sPath))
+      continue;
+
+    if (sPath.StartsWith(":"))
+    {
+      // rooted paths can be resolved without touching any file
+      if (ezFileSystem::ResolvePath(sPath, nullptr, &sRelativePath).Failed())
+        continue;
+
+      sPath = sRelativePath;
+    }
+
+    files.PushBack(sPath);
+  }
+
+  pClient->PrefetchFiles(files);
+}
+
 
 
 EZ_STATICLINK_FILE(FileservePlugin, FileservePlugin_Client_FileserveClient);
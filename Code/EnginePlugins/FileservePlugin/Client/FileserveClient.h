@@ -2,8 +2,10 @@
 
 #include <FileservePlugin/FileservePluginDLL.h>
 
+#include <FileservePlugin/Fileserver/ClientContext.h>
 #include <Foundation/Communication/RemoteInterface.h>
 #include <Foundation/Configuration/Singleton.h>
+#include <Foundation/Containers/HashSet.h>
 #include <Foundation/Types/UniquePtr.h>
 #include <Foundation/Types/Uuid.h>
 
@@ -60,6 +62,11 @@ public:
   /// Also achieved through the command line argument "-fs_off"
   static void DisabledFileserveClient() { s_bEnableFileserve = false; }
 
+  /// \brief Enables the file serving functionality again, after it was disabled.
+  ///
+  /// Creating an ezFileserver disables the client. This allows to run both in the same process anyway, e.g. for testing.
+  static void EnableFileserveClient() { s_bEnableFileserve = true; }
+
   /// \brief Returns the address through which the Fileserve client tried to connect with the server last.
   const char* GetServerConnectionAddress() { return m_sServerConnectionAddress; }
 
@@ -79,6 +86,16 @@ public:
   /// \brief Adds an address that should be tried for connecting with the server.
   void AddServerAddressToTry(const char* szAddress);
 
+  /// \brief Hints that the given files are going to be read soon. Does not block.
+  ///
+  /// All files whose cache state is not known to be up to date are validated with a single request to the server. The server
+  /// answers all files that did not change in bulk and sends the changed ones compressed and back to back, so that the transfer
+  /// only costs a single round trip. Reading one of these files afterwards waits for its answer instead of sending a request of its own.
+  ///
+  /// The paths are relative to the mounted data directories, just like regular file accesses they are looked up in all of them.
+  /// The client automatically does this for all resources that ezResourceManager queues for loading.
+  void PrefetchFiles(ezArrayPtr<const ezString> files);
+
 private:
   friend class ezDataDirectory::FileserveType;
 
@@ -102,6 +119,13 @@ private:
     ezMap<ezString, FileCacheStatus> m_CacheStatus;
   };
 
+  struct PrefetchBatch
+  {
+    ezUuid m_BatchGuid;
+    ezDynamicArray<ezString> m_Files; // indexed by the entries of the manifest
+    ezUInt32 m_uiNumPending = 0;
+  };
+
   void DeleteFile(ezUInt16 uiDataDir, const char* szFile);
   ezUInt16 MountDataDirectory(const char* szDataDir, const char* szRootName);
   void UnmountDataDirectory(ezUInt16 uiDataDir);
@@ -112,8 +136,16 @@ private:
   void NetworkMsgHandler(ezRemoteMessage& msg);
   void HandleFileTransferMsg(ezRemoteMessage& msg);
   void HandleFileTransferFinishedMsg(ezRemoteMessage& msg);
+  void HandleManifestDataMsg(ezRemoteMessage& msg);
+  void HandleManifestFileFinishedMsg(ezRemoteMessage& msg);
+  void HandleManifestResultsMsg(ezRemoteMessage& msg);
+  ezUInt32 FindPrefetchBatch(const ezUuid& batchGuid) const;
+  void FinishPrefetch(ezUInt32 uiBatch, ezUInt32 uiEntry, ezFileserveFileState fileState, ezInt64 iFileTimeStamp, ezUInt64 uiFileHash,
+                      ezUInt16 uiFoundInDataDir, ezArrayPtr<const ezUInt8> fileContent);
+  void UpdateCachedFile(const char* szFile, ezFileserveFileState fileState, ezInt64 iFileTimeStamp, ezUInt64 uiFileHash,
+                        ezUInt16 uiFoundInDataDir, ezArrayPtr<const ezUInt8> fileContent);
   static void WriteMetaFile(ezStringBuilder sCachedMetaFile, ezInt64 iFileTimeStamp, ezUInt64 uiFileHash);
-  void WriteDownloadToDisk(ezStringBuilder sCachedFile);
+  static void WriteDownloadToDisk(ezStringBuilder sCachedFile, ezArrayPtr<const ezUInt8> fileContent);
   ezResult DownloadFile(ezUInt16 uiDataDirID, const char* szFile, bool bForceThisDataDir);
   void DetermineCacheStatus(ezUInt16 uiDataDirID, const char* szFile, FileCacheStatus& out_Status) const;
   void UploadFile(ezUInt16 uiDataDirID, const char* szFile, const ezDynamicArray<ezUInt8>& fileContent);
@@ -140,4 +172,9 @@ private:
 
   ezMap<ezString, ezUInt16> m_FileDataDir;
   ezHybridArray<DataDir, 8> m_MountedDataDirs;
+
+  ezHybridArray<PrefetchBatch, 4> m_PrefetchBatches;
+  ezHashSet<ezString> m_PendingPrefetches;
+  ezDynamicArray<ezUInt8> m_PrefetchDownload;
+  ezDynamicArray<ezUInt8> m_PrefetchDecompressed;
 };
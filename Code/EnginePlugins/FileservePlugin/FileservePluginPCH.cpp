@@ -10,7 +10,5 @@ EZ_STATICLINK_LIBRARY(FileservePlugin)
   EZ_STATICLINK_REFERENCE(FileservePlugin_Fileserver_ClientContext);
   EZ_STATICLINK_REFERENCE(FileservePlugin_Fileserver_Fileserver);
   EZ_STATICLINK_REFERENCE(FileservePlugin_Main);
-  EZ_STATICLINK_REFERENCE(FileservePlugin_Network_NetworkInterface);
-  EZ_STATICLINK_REFERENCE(FileservePlugin_Network_NetworkMessage);
 }
 
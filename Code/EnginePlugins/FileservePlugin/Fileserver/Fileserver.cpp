@@ -6,6 +6,7 @@
 #include <Foundation/Communication/RemoteInterfaceEnet.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/Utilities/CommandLineUtils.h>
+#include <Foundation/Utilities/Compression.h>
 
 EZ_IMPLEMENT_SINGLETON(ezFileserver);
 
@@ -102,6 +103,12 @@ void ezFileserver::NetworkMsgHandler(ezRemoteMessage& msg)
     return;
   }
 
+  if (msg.GetMessageID() == 'MANI')
+  {
+    HandleManifestRequest(client, msg);
+    return;
+  }
+
   if (msg.GetMessageID() == 'UPLH')
   {
     HandleUploadFileHeader(client, msg);
@@ -334,6 +341,139 @@ void ezFileserver::HandleFileRequest(ezFileserveClientContext& client, ezRemoteM
   }
 }
 
+void ezFileserver::HandleManifestRequest(ezFileserveClientContext& client, ezRemoteMessage& msg)
+{
+  ezUuid batchGuid;
+  msg.GetReader() >> batchGuid;
+
+  ezUInt32 uiNumEntries = 0;
+  msg.GetReader() >> uiNumEntries;
+
+  m_ManifestResults.Clear();
+
+  ezStringBuilder sRequestedFile;
+
+  for (ezUInt32 uiEntry = 0; uiEntry < uiNumEntries; ++uiEntry)
+  {
+    ezUInt16 uiDataDirID = 0;
+    msg.GetReader() >> uiDataDirID;
+    msg.GetReader() >> sRequestedFile;
+
+    ezFileserveClientContext::FileStatus status;
+    msg.GetReader() >> status.m_iTimestamp;
+    msg.GetReader() >> status.m_uiHash;
+
+    ezFileserverEvent e;
+    e.m_uiClientID = client.m_uiApplicationID;
+    e.m_szPath = sRequestedFile;
+    e.m_uiSentTotal = 0;
+
+    const ezFileserveFileState filestate = client.GetFileStatus(uiDataDirID, sRequestedFile, status, m_SendToClient, false);
+
+    {
+      e.m_Type = ezFileserverEvent::Type::FileDownloadRequest;
+      e.m_uiSizeTotal = m_SendToClient.GetCount();
+      e.m_FileState = filestate;
+      m_Events.Broadcast(e);
+    }
+
+    if (filestate != ezFileserveFileState::Different)
+    {
+      // the client already has the latest state of the file, these are all sent back in one message
+      auto& result = m_ManifestResults.ExpandAndGetRef();
+      result.m_uiEntry = uiEntry;
+      result.m_FileState = filestate;
+      result.m_iTimestamp = status.m_iTimestamp;
+      result.m_uiHash = status.m_uiHash;
+      result.m_uiDataDirID = uiDataDirID;
+    }
+    else
+    {
+      // don't let the client wait for the files that were already validated, while this one is transferred
+      SendManifestResults(batchGuid);
+
+      bool bCompressed = false;
+      ezArrayPtr<const ezUInt8> data = m_SendToClient;
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+      if (ezCompressionUtils::Compress(m_SendToClient, ezCompressionMethod::ZStd, m_CompressedSendToClient).Succeeded() &&
+          m_CompressedSendToClient.GetCount() < m_SendToClient.GetCount())
+      {
+        bCompressed = true;
+        data = m_CompressedSendToClient;
+      }
+#endif
+
+      // unlike with 'READ', the chunks of all files are sent without waiting for the client in between
+      ezUInt32 uiNextByte = 0;
+      while (uiNextByte < data.GetCount())
+      {
+        const ezUInt16 uiChunkSize = (ezUInt16)ezMath::Min<ezUInt32>(16 * 1024, data.GetCount() - uiNextByte);
+
+        ezRemoteMessage ret('FSRV', 'MAND');
+        ret.GetWriter() << batchGuid;
+        ret.GetWriter() << uiChunkSize;
+        ret.GetWriter().WriteBytes(data.GetPtr() + uiNextByte, uiChunkSize);
+
+        m_Network->Send(ezRemoteTransmitMode::Reliable, ret);
+
+        uiNextByte += uiChunkSize;
+
+        // reuse previous values, progress is reported in uncompressed bytes
+        {
+          e.m_Type = ezFileserverEvent::Type::FileDownloading;
+          e.m_uiSentTotal = (ezUInt32)((ezUInt64)uiNextByte * m_SendToClient.GetCount() / data.GetCount());
+          m_Events.Broadcast(e);
+        }
+      }
+
+      {
+        ezRemoteMessage ret('FSRV', 'MANF');
+        ret.GetWriter() << batchGuid;
+        ret.GetWriter() << uiEntry;
+        ret.GetWriter() << (ezInt8)filestate;
+        ret.GetWriter() << status.m_iTimestamp;
+        ret.GetWriter() << status.m_uiHash;
+        ret.GetWriter() << uiDataDirID;
+        ret.GetWriter() << bCompressed;
+
+        m_Network->Send(ezRemoteTransmitMode::Reliable, ret);
+      }
+    }
+
+    // reuse previous values
+    {
+      e.m_Type = ezFileserverEvent::Type::FileDownloadFinished;
+      m_Events.Broadcast(e);
+    }
+  }
+
+  SendManifestResults(batchGuid);
+}
+
+void ezFileserver::SendManifestResults(const ezUuid& batchGuid)
+{
+  if (m_ManifestResults.IsEmpty())
+    return;
+
+  ezRemoteMessage ret('FSRV', 'MANR');
+  ret.GetWriter() << batchGuid;
+  ret.GetWriter() << m_ManifestResults.GetCount();
+
+  for (const auto& result : m_ManifestResults)
+  {
+    ret.GetWriter() << result.m_uiEntry;
+    ret.GetWriter() << (ezInt8)result.m_FileState;
+    ret.GetWriter() << result.m_iTimestamp;
+    ret.GetWriter() << result.m_uiHash;
+    ret.GetWriter() << result.m_uiDataDirID;
+  }
+
+  m_Network->Send(ezRemoteTransmitMode::Reliable, ret);
+
+  m_ManifestResults.Clear();
+}
+
 void ezFileserver::HandleDeleteFileRequest(ezFileserveClientContext& client, ezRemoteMessage& msg)
 {
   ezUInt16 uiDataDirID = 0xffff;
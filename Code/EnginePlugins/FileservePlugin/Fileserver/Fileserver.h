@@ -94,14 +94,28 @@ private:
   void HandleMountRequest(ezFileserveClientContext& client, ezRemoteMessage &msg);
   void HandleUnmountRequest(ezFileserveClientContext& client, ezRemoteMessage &msg);
   void HandleFileRequest(ezFileserveClientContext& client, ezRemoteMessage &msg);
+  void HandleManifestRequest(ezFileserveClientContext& client, ezRemoteMessage &msg);
   void HandleDeleteFileRequest(ezFileserveClientContext& client, ezRemoteMessage &msg);
   void HandleUploadFileHeader(ezFileserveClientContext& client, ezRemoteMessage &msg);
   void HandleUploadFileTransfer(ezFileserveClientContext& client, ezRemoteMessage &msg);
   void HandleUploadFileFinished(ezFileserveClientContext& client, ezRemoteMessage &msg);
 
+  struct ManifestResult
+  {
+    ezUInt32 m_uiEntry = 0;
+    ezFileserveFileState m_FileState = ezFileserveFileState::None;
+    ezInt64 m_iTimestamp = 0;
+    ezUInt64 m_uiHash = 0;
+    ezUInt16 m_uiDataDirID = 0;
+  };
+
+  void SendManifestResults(const ezUuid& batchGuid);
+
   ezHashTable<ezUInt32, ezFileserveClientContext> m_Clients;
   ezUniquePtr<ezRemoteInterface> m_Network;
   ezDynamicArray<ezUInt8> m_SendToClient; // ie. 'downloads' from server to client
+  ezDynamicArray<ezUInt8> m_CompressedSendToClient;
+  ezDynamicArray<ManifestResult> m_ManifestResults; // manifest entries that are answered without sending file data
   ezDynamicArray<ezUInt8> m_SentFromClient; // ie. 'uploads' from client to server
   ezStringBuilder m_sCurFileUpload;
   ezUuid m_FileUploadGuid;
@@ -1,6 +1,7 @@
 #include <ParticlePluginPCH.h>
 
 #include <Core/WorldSerializer/ResourceHandleStreamOperations.h>
+#include <Foundation/DataProcessing/Stream/ProcessingStreamChunkIterator.h>
 #include <Foundation/DataProcessing/Stream/ProcessingStreamIterator.h>
 #include <Foundation/Math/Color16f.h>
 #include <Foundation/Profiling/Profiling.h>
@@ -106,11 +107,11 @@ void ezParticleBehavior_ColorGradient::CreateRequiredStreams()
 
   if (m_GradientMode == ezParticleColorGradientMode::Age)
   {
-    CreateStream("LifeTime", ezProcessingStream::DataType::Half2, &m_pStreamLifeTime, false);
+    CreateStream("LifeTime", ezProcessingStream::DataType::Float2, &m_pStreamLifeTime, false, ezProcessingStream::DataLayout::SoA);
   }
   else if (m_GradientMode == ezParticleColorGradientMode::Speed)
   {
-    CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false);
+    CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false, ezProcessingStream::DataLayout::SoA);
   }
 }
 
@@ -175,69 +176,70 @@ void ezParticleBehavior_ColorGradient::Process(ezUInt64 uiNumElements)
 
   const ezColorGradient& gradient = pGradient->GetDescriptor().m_Gradient;
 
-  ezProcessingStreamIterator<ezColorLinear16f> itColor(m_pStreamColor, uiNumElements, 0);
+  ezColorLinear16f* pColor = m_pStreamColor->GetWritableData<ezColorLinear16f>();
 
-  // skip the first n particles
-  itColor.Advance(m_uiFirstToUpdate);
+  EZ_ALIGN_16(float fGradientPos[ezProcessingStreamChunkIterator::ChunkSize]);
+
+  // sampling the color gradient is pretty expensive, so this is done per particle, only the lookup position is computed per chunk
+  auto EvaluateGradient = [&](const ezProcessingStreamChunkIterator& it) {
+    ezColorLinear16f* pChunkColor = pColor + it.GetCurrentIndex();
+    const ezUInt32 uiNumValid = it.GetNumValidElements();
+
+    for (ezUInt32 i = 0; i < uiNumValid; ++i)
+    {
+      ezColor rgba;
+      ezUInt8 alpha;
+      gradient.EvaluateColor(fGradientPos[i], rgba);
+      gradient.EvaluateAlpha(fGradientPos[i], alpha);
+      rgba.a = ezMath::ColorByteToFloat(alpha);
+
+      pChunkColor[i] = rgba * m_TintColor;
+    }
+  };
 
   if (m_GradientMode == ezParticleColorGradientMode::Age)
   {
-    ezProcessingStreamIterator<ezFloat16Vec2> itLifeTime(m_pStreamLifeTime, uiNumElements, 0);
+    ezProcessingStreamChunkIterator itLifeTime(m_pStreamLifeTime, uiNumElements, 0);
 
-    // skip the first n particles
+    // skip the first n chunks of particles
     itLifeTime.Advance(m_uiFirstToUpdate);
 
     while (!itLifeTime.HasReachedEnd())
     {
-      // if (itLifeTime.Current().y > 0)
-      {
-        const float fLifeTimeFraction = itLifeTime.Current().x * itLifeTime.Current().y;
-        const float posx = 1.0f - fLifeTimeFraction;
-
-        ezColor rgba;
-        ezUInt8 alpha;
-        gradient.EvaluateColor(posx, rgba);
-        gradient.EvaluateAlpha(posx, alpha);
-        rgba.a = ezMath::ColorByteToFloat(alpha);
-
-        itColor.Current() = rgba * m_TintColor;
-      }
-
-      // skip the next n items
-      // this is to reduce the number of particles that need to be fully evaluated,
-      // since sampling the color gradient is pretty expensive
+      const ezSimdVec4f posx = ezSimdVec4f(1.0f) - itLifeTime.Load(0).CompMul(itLifeTime.Load(1));
+      posx.Store<4>(fGradientPos);
+
+      EvaluateGradient(itLifeTime);
+
+      // skip the next n chunks
+      // this is to reduce the number of particles that need to be fully evaluated
       itLifeTime.Advance(m_uiCurrentUpdateInterval);
-      itColor.Advance(m_uiCurrentUpdateInterval);
     }
   }
   else if (m_GradientMode == ezParticleColorGradientMode::Speed)
   {
-    ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
+    ezProcessingStreamChunkIterator itVelocity(m_pStreamVelocity, uiNumElements, 0);
 
-    // skip the first n particles
+    // skip the first n chunks of particles
     itVelocity.Advance(m_uiFirstToUpdate);
 
+    const ezSimdFloat fInvMaxSpeed = 1.0f / m_fMaxSpeed;
+
     while (!itVelocity.HasReachedEnd())
     {
-      // if (itLifeTime.Current().y > 0)
-      {
-        const float fSpeed = itVelocity.Current().GetLength();
-        const float posx = fSpeed / m_fMaxSpeed; // no need to clamp the range, the color lookup will already do that
-
-        ezColor rgba;
-        ezUInt8 alpha;
-        gradient.EvaluateColor(posx, rgba);
-        gradient.EvaluateAlpha(posx, alpha);
-        rgba.a = ezMath::ColorByteToFloat(alpha);
-
-        itColor.Current() = rgba * m_TintColor;
-      }
-
-      // skip the next n items
-      // this is to reduce the number of particles that need to be fully evaluated,
-      // since sampling the color gradient is pretty expensive
+      const ezSimdVec4f vx = itVelocity.Load(0);
+      const ezSimdVec4f vy = itVelocity.Load(1);
+      const ezSimdVec4f vz = itVelocity.Load(2);
+
+      // no need to clamp the range, the color lookup will already do that
+      const ezSimdVec4f posx = (vx.CompMul(vx) + vy.CompMul(vy) + vz.CompMul(vz)).GetSqrt() * fInvMaxSpeed;
+      posx.Store<4>(fGradientPos);
+
+      EvaluateGradient(itVelocity);
+
+      // skip the next n chunks
+      // this is to reduce the number of particles that need to be fully evaluated
       itVelocity.Advance(m_uiCurrentUpdateInterval);
-      itColor.Advance(m_uiCurrentUpdateInterval);
     }
   }
 
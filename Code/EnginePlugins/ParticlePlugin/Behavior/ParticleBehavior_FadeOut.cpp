@@ -1,6 +1,6 @@
 #include <ParticlePluginPCH.h>
 
-#include <Foundation/DataProcessing/Stream/ProcessingStreamIterator.h>
+#include <Foundation/DataProcessing/Stream/ProcessingStreamChunkIterator.h>
 #include <Foundation/Math/Color16f.h>
 #include <Foundation/Profiling/Profiling.h>
 #include <ParticlePlugin/Behavior/ParticleBehavior_FadeOut.h>
@@ -55,7 +55,7 @@ void ezParticleBehaviorFactory_FadeOut::Load(ezStreamReader& stream)
 
 void ezParticleBehavior_FadeOut::CreateRequiredStreams()
 {
-  CreateStream("LifeTime", ezProcessingStream::DataType::Half2, &m_pStreamLifeTime, false);
+  CreateStream("LifeTime", ezProcessingStream::DataType::Float2, &m_pStreamLifeTime, false, ezProcessingStream::DataLayout::SoA);
   CreateStream("Color", ezProcessingStream::DataType::Half4, &m_pStreamColor, false);
 }
 
@@ -72,50 +72,39 @@ void ezParticleBehavior_FadeOut::Process(ezUInt64 uiNumElements)
 
   EZ_PROFILE_SCOPE("PFX: Fade Out");
 
-  ezProcessingStreamIterator<ezFloat16Vec2> itLifeTime(m_pStreamLifeTime, uiNumElements, 0);
-  ezProcessingStreamIterator<ezColorLinear16f> itColor(m_pStreamColor, uiNumElements, 0);
+  ezColorLinear16f* pColor = m_pStreamColor->GetWritableData<ezColorLinear16f>();
 
-  // skip the first n particles
+  ezProcessingStreamChunkIterator itLifeTime(m_pStreamLifeTime, uiNumElements, 0);
+
+  // skip the first n chunks of particles
   {
-    for (ezUInt32 i = 0; i < m_uiFirstToUpdate; ++i)
-    {
-      itLifeTime.Advance();
-      itColor.Advance();
-    }
+    itLifeTime.Advance(m_uiFirstToUpdate);
 
     ++m_uiFirstToUpdate;
     if (m_uiFirstToUpdate >= m_uiCurrentUpdateInterval)
       m_uiFirstToUpdate = 0;
   }
 
-  if (m_fStartAlpha <= 1.0f)
-  {
-    while (!itLifeTime.HasReachedEnd())
-    {
-      const float fLifeTimeFraction = itLifeTime.Current().x * itLifeTime.Current().y;
-      itColor.Current().a = m_fStartAlpha * ezMath::Pow(fLifeTimeFraction, m_fExponent);
-
-      for (ezUInt32 i = 0; i < m_uiCurrentUpdateInterval; ++i)
-      {
-        itLifeTime.Advance();
-        itColor.Advance();
-      }
-    }
-  }
-  else
+  // this case has to clamp alpha to 1
+  const float fMaxAlpha = m_fStartAlpha <= 1.0f ? m_fStartAlpha : 1.0f;
+
+  EZ_ALIGN_16(float fLifeTimeFraction[ezProcessingStreamChunkIterator::ChunkSize]);
+
+  while (!itLifeTime.HasReachedEnd())
   {
-    // this case has to clamp alpha to 1
-    while (!itLifeTime.HasReachedEnd())
+    const ezSimdVec4f lifeTimeFraction = itLifeTime.Load(0).CompMul(itLifeTime.Load(1));
+    lifeTimeFraction.Store<4>(fLifeTimeFraction);
+
+    ezColorLinear16f* pChunkColor = pColor + itLifeTime.GetCurrentIndex();
+    const ezUInt32 uiNumValid = itLifeTime.GetNumValidElements();
+
+    for (ezUInt32 i = 0; i < uiNumValid; ++i)
     {
-      const float fLifeTimeFraction = itLifeTime.Current().x * itLifeTime.Current().y;
-      itColor.Current().a = ezMath::Min(1.0f, m_fStartAlpha * ezMath::Pow(fLifeTimeFraction, m_fExponent));
-
-      for (ezUInt32 i = 0; i < m_uiCurrentUpdateInterval; ++i)
-      {
-        itLifeTime.Advance();
-        itColor.Advance();
-      }
+      pChunkColor[i].a = ezMath::Min(fMaxAlpha, m_fStartAlpha * ezMath::Pow(fLifeTimeFraction[i], m_fExponent));
     }
+
+    // skip the next n chunks
+    itLifeTime.Advance(m_uiCurrentUpdateInterval);
   }
 
   /// \todo Use level of detail to reduce the update interval further
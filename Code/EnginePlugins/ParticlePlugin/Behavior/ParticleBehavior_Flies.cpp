@@ -87,7 +87,7 @@ void ezParticleBehaviorFactory_Flies::Load(ezStreamReader& stream)
 void ezParticleBehavior_Flies::CreateRequiredStreams()
 {
   CreateStream("Position", ezProcessingStream::DataType::Float4, &m_pStreamPosition, false);
-  CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false);
+  CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false, ezProcessingStream::DataLayout::SoA);
 
   m_TimeToChangeDir.SetZero();
 }
@@ -108,17 +108,20 @@ void ezParticleBehavior_Flies::Process(ezUInt64 uiNumElements)
   const float fMaxDistanceToEmitterSquared = ezMath::Square(m_fMaxEmitterDistance);
 
   ezProcessingStreamIterator<ezVec4> itPosition(m_pStreamPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
+  float* pVelocityX = m_pStreamVelocity->GetWritableComponentData<float>(0);
+  float* pVelocityY = m_pStreamVelocity->GetWritableComponentData<float>(1);
+  float* pVelocityZ = m_pStreamVelocity->GetWritableComponentData<float>(2);
 
   ezQuat qRot;
 
-  while (!itPosition.HasReachedEnd())
+  for (ezUInt64 i = 0; i < uiNumElements; ++i)
   {
     // if (pLifeArray[i] == pMaxLifeArray[i])
 
     const ezVec3 vPartToEm = vEmitterPos - itPosition.Current().GetAsVec3();
     const float fDist = vPartToEm.GetLengthSquared();
-    const ezVec3 vVelocity = itVelocity.Current();
+    const ezVec3 vVelocity(pVelocityX[i], pVelocityY[i], pVelocityZ[i]);
+    ezVec3 vNewVelocity;
     ezVec3 vDir = vVelocity;
     vDir.NormalizeIfNotZero();
 
@@ -130,14 +133,17 @@ void ezParticleBehavior_Flies::Process(ezUInt64 uiNumElements)
 
       qRot.SetFromAxisAndAngle(vPivot, m_MaxSteeringAngle);
 
-      itVelocity.Current() = qRot * vVelocity;
+      vNewVelocity = qRot * vVelocity;
     }
     else
     {
-      itVelocity.Current() = ezVec3::CreateRandomDeviation(GetRNG(), m_MaxSteeringAngle, vDir) * m_fSpeed;
+      vNewVelocity = ezVec3::CreateRandomDeviation(GetRNG(), m_MaxSteeringAngle, vDir) * m_fSpeed;
     }
 
+    pVelocityX[i] = vNewVelocity.x;
+    pVelocityY[i] = vNewVelocity.y;
+    pVelocityZ[i] = vNewVelocity.z;
+
     itPosition.Advance();
-    itVelocity.Advance();
   }
 }
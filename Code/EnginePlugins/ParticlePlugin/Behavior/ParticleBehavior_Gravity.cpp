@@ -2,7 +2,7 @@
 
 #include <Core/World/World.h>
 #include <Core/World/WorldModule.h>
-#include <Foundation/DataProcessing/Stream/ProcessingStreamIterator.h>
+#include <Foundation/DataProcessing/Stream/ProcessingStreamChunkIterator.h>
 #include <Foundation/Profiling/Profiling.h>
 #include <Foundation/Time/Clock.h>
 #include <GameEngine/Interfaces/PhysicsWorldModule.h>
@@ -70,7 +70,7 @@ void ezParticleBehaviorFactory_Gravity::QueryFinalizerDependencies(ezSet<const e
 
 void ezParticleBehavior_Gravity::CreateRequiredStreams()
 {
-  CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false);
+  CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false, ezProcessingStream::DataLayout::SoA);
 }
 
 void ezParticleBehavior_Gravity::Process(ezUInt64 uiNumElements)
@@ -82,11 +82,17 @@ void ezParticleBehavior_Gravity::Process(ezUInt64 uiNumElements)
   const float tDiff = (float)m_TimeDiff.GetSeconds();
   const ezVec3 addGravity = vGravity * m_fGravityFactor * tDiff;
 
-  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
+  const ezSimdVec4f addGravityX(addGravity.x);
+  const ezSimdVec4f addGravityY(addGravity.y);
+  const ezSimdVec4f addGravityZ(addGravity.z);
+
+  ezProcessingStreamChunkIterator itVelocity(m_pStreamVelocity, uiNumElements, 0);
 
   while (!itVelocity.HasReachedEnd())
   {
-    itVelocity.Current() += addGravity;
+    itVelocity.Store(itVelocity.Load(0) + addGravityX, 0);
+    itVelocity.Store(itVelocity.Load(1) + addGravityY, 1);
+    itVelocity.Store(itVelocity.Load(2) + addGravityZ, 2);
 
     itVelocity.Advance();
   }
@@ -118,7 +118,7 @@ void ezParticleBehavior_Raycast::CreateRequiredStreams()
 {
   CreateStream("Position", ezProcessingStream::DataType::Float4, &m_pStreamPosition, false);
   CreateStream("LastPosition", ezProcessingStream::DataType::Float3, &m_pStreamLastPosition, false);
-  CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false);
+  CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false, ezProcessingStream::DataLayout::SoA);
 }
 
 void ezParticleBehavior_Raycast::Process(ezUInt64 uiNumElements)
@@ -129,7 +129,9 @@ void ezParticleBehavior_Raycast::Process(ezUInt64 uiNumElements)
 
   ezProcessingStreamIterator<ezVec4> itPosition(m_pStreamPosition, uiNumElements, 0);
   ezProcessingStreamIterator<const ezVec3> itLastPosition(m_pStreamLastPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
+  float* pVelocityX = m_pStreamVelocity->GetWritableComponentData<float>(0);
+  float* pVelocityY = m_pStreamVelocity->GetWritableComponentData<float>(1);
+  float* pVelocityZ = m_pStreamVelocity->GetWritableComponentData<float>(2);
 
   ezPhysicsCastResult hitResult;
 
@@ -156,7 +158,10 @@ void ezParticleBehavior_Raycast::Process(ezUInt64 uiNumElements)
             const ezVec3 vNewDir = vChange.GetReflectedVector(hitResult.m_vNormal) * m_fBounceFactor;
 
             itPosition.Current() = ezVec3(hitResult.m_vPosition + hitResult.m_vNormal * 0.05f + vNewDir).GetAsVec4(0);
-            itVelocity.Current() = vNewDir / tDiff;
+            const ezVec3 vNewVelocity = vNewDir / tDiff;
+            pVelocityX[i] = vNewVelocity.x;
+            pVelocityY[i] = vNewVelocity.y;
+            pVelocityZ[i] = vNewVelocity.z;
           }
           else if (m_Reaction == ezParticleRaycastHitReaction::Die)
           {
@@ -165,7 +170,9 @@ void ezParticleBehavior_Raycast::Process(ezUInt64 uiNumElements)
           }
           else if (m_Reaction == ezParticleRaycastHitReaction::Stop)
           {
-            itVelocity.Current().SetZero();
+            pVelocityX[i] = 0.0f;
+            pVelocityY[i] = 0.0f;
+            pVelocityZ[i] = 0.0f;
           }
 
           if (m_sOnCollideEvent.GetHash() != 0)
@@ -184,7 +191,6 @@ void ezParticleBehavior_Raycast::Process(ezUInt64 uiNumElements)
 
     itPosition.Advance();
     itLastPosition.Advance();
-    itVelocity.Advance();
 
     ++i;
   }
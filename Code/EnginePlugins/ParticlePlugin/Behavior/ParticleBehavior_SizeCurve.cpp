@@ -1,6 +1,7 @@
 #include <ParticlePluginPCH.h>
 
 #include <Core/WorldSerializer/ResourceHandleStreamOperations.h>
+#include <Foundation/DataProcessing/Stream/ProcessingStreamChunkIterator.h>
 #include <Foundation/DataProcessing/Stream/ProcessingStreamIterator.h>
 #include <Foundation/Math/Float16.h>
 #include <Foundation/Profiling/Profiling.h>
@@ -81,7 +82,7 @@ const char* ezParticleBehaviorFactory_SizeCurve::GetSizeCurveFile() const
 
 void ezParticleBehavior_SizeCurve::CreateRequiredStreams()
 {
-  CreateStream("LifeTime", ezProcessingStream::DataType::Half2, &m_pStreamLifeTime, false);
+  CreateStream("LifeTime", ezProcessingStream::DataType::Float2, &m_pStreamLifeTime, false, ezProcessingStream::DataLayout::SoA);
   CreateStream("Size", ezProcessingStream::DataType::Half, &m_pStreamSize, false);
 }
 
@@ -113,8 +114,8 @@ void ezParticleBehavior_SizeCurve::Process(ezUInt64 uiNumElements)
 
   EZ_PROFILE_SCOPE("PFX: Size Curve");
 
-  ezProcessingStreamIterator<ezFloat16Vec2> itLifeTime(m_pStreamLifeTime, uiNumElements, 0);
-  ezProcessingStreamIterator<ezFloat16> itSize(m_pStreamSize, uiNumElements, 0);
+  ezProcessingStreamChunkIterator itLifeTime(m_pStreamLifeTime, uiNumElements, 0);
+  ezFloat16* pSize = m_pStreamSize->GetWritableData<ezFloat16>();
 
   ezResourceLock<ezCurve1DResource> pCurve(m_hCurve, ezResourceAcquireMode::BlockTillLoaded);
 
@@ -129,40 +130,38 @@ void ezParticleBehavior_SizeCurve::Process(ezUInt64 uiNumElements)
   double fMinX, fMaxX;
   curve.QueryExtents(fMinX, fMaxX);
 
-  // skip the first n particles
+  // skip the first n chunks of particles
   {
-    for (ezUInt32 i = 0; i < m_uiFirstToUpdate; ++i)
-    {
-      itLifeTime.Advance();
-      itSize.Advance();
-    }
+    itLifeTime.Advance(m_uiFirstToUpdate);
 
     ++m_uiFirstToUpdate;
     if (m_uiFirstToUpdate >= m_uiCurrentUpdateInterval)
       m_uiFirstToUpdate = 0;
   }
 
+  EZ_ALIGN_16(float fLifeTimeFraction[ezProcessingStreamChunkIterator::ChunkSize]);
+
   while (!itLifeTime.HasReachedEnd())
   {
-    // if (itLifeTime.Current().y > 0)
-    {
-      const float fLifeTimeFraction = 1.0f - (itLifeTime.Current().x * itLifeTime.Current().y);
+    const ezSimdVec4f lifeTimeFraction = ezSimdVec4f(1.0f) - itLifeTime.Load(0).CompMul(itLifeTime.Load(1));
+    lifeTimeFraction.Store<4>(fLifeTimeFraction);
 
-      const double evalPos = curve.ConvertNormalizedPos(fLifeTimeFraction);
+    ezFloat16* pChunkSize = pSize + itLifeTime.GetCurrentIndex();
+    const ezUInt32 uiNumValid = itLifeTime.GetNumValidElements();
+
+    for (ezUInt32 i = 0; i < uiNumValid; ++i)
+    {
+      const double evalPos = curve.ConvertNormalizedPos(fLifeTimeFraction[i]);
       double val = curve.Evaluate(evalPos);
       val = curve.NormalizeValue(val);
 
-      itSize.Current() = m_fBaseSize + (float)val * m_fCurveScale;
+      pChunkSize[i] = m_fBaseSize + (float)val * m_fCurveScale;
     }
 
-    // skip the next n items
+    // skip the next n chunks
     // this is to reduce the number of particles that need to be fully evaluated,
     // since sampling the curve is expensive
-    for (ezUInt32 i = 0; i < m_uiCurrentUpdateInterval; ++i)
-    {
-      itLifeTime.Advance();
-      itSize.Advance();
-    }
+    itLifeTime.Advance(m_uiCurrentUpdateInterval);
   }
 }
 
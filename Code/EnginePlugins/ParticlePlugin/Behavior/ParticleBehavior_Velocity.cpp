@@ -2,6 +2,7 @@
 
 #include <Core/World/World.h>
 #include <Core/World/WorldModule.h>
+#include <Foundation/DataProcessing/Stream/ProcessingStreamChunkIterator.h>
 #include <Foundation/DataProcessing/Stream/ProcessingStreamIterator.h>
 #include <Foundation/Profiling/Profiling.h>
 #include <Foundation/Time/Clock.h>
@@ -102,7 +103,7 @@ void ezParticleBehaviorFactory_Velocity::QueryFinalizerDependencies(ezSet<const
 void ezParticleBehavior_Velocity::CreateRequiredStreams()
 {
   CreateStream("Position", ezProcessingStream::DataType::Float4, &m_pStreamPosition, false);
-  CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false);
+  CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false, ezProcessingStream::DataLayout::SoA);
 }
 
 void ezParticleBehavior_Velocity::Process(ezUInt64 uiNumElements)
@@ -125,17 +126,24 @@ void ezParticleBehavior_Velocity::Process(ezUInt64 uiNumElements)
   vAddPos.Load<3>(&vAddPos0.x);
 
   const float fFriction = ezMath::Clamp(m_fFriction, 0.0f, 100.0f);
-  const float fFrictionFactor = ezMath::Pow(0.5f, tDiff * fFriction);
+  const ezSimdFloat fFrictionFactor = ezMath::Pow(0.5f, tDiff * fFriction);
 
   ezProcessingStreamIterator<ezSimdVec4f> itPosition(m_pStreamPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
 
   while (!itPosition.HasReachedEnd())
   {
     itPosition.Current() += vAddPos;
-    itVelocity.Current() *= fFrictionFactor;
-
     itPosition.Advance();
+  }
+
+  ezProcessingStreamChunkIterator itVelocity(m_pStreamVelocity, uiNumElements, 0);
+
+  while (!itVelocity.HasReachedEnd())
+  {
+    itVelocity.Store(itVelocity.Load(0) * fFrictionFactor, 0);
+    itVelocity.Store(itVelocity.Load(1) * fFrictionFactor, 1);
+    itVelocity.Store(itVelocity.Load(2) * fFrictionFactor, 2);
+
     itVelocity.Advance();
   }
 }
@@ -1,8 +1,7 @@
 #include <ParticlePluginPCH.h>
 
 #include <Core/World/World.h>
-#include <Foundation/DataProcessing/Stream/ProcessingStreamIterator.h>
-#include <Foundation/Math/Float16.h>
+#include <Foundation/DataProcessing/Stream/ProcessingStreamChunkIterator.h>
 #include <Foundation/Profiling/Profiling.h>
 #include <ParticlePlugin/Effect/ParticleEffectInstance.h>
 #include <ParticlePlugin/Events/ParticleEvent.h>
@@ -57,7 +56,7 @@ ezParticleFinalizer_Age::~ezParticleFinalizer_Age()
 
 void ezParticleFinalizer_Age::CreateRequiredStreams()
 {
-  CreateStream("LifeTime", ezProcessingStream::DataType::Half2, &m_pStreamLifeTime, true);
+  CreateStream("LifeTime", ezProcessingStream::DataType::Float2, &m_pStreamLifeTime, true, ezProcessingStream::DataLayout::SoA);
 
   m_pStreamPosition = nullptr;
   m_pStreamVelocity = nullptr;
@@ -65,7 +64,7 @@ void ezParticleFinalizer_Age::CreateRequiredStreams()
   if (m_sOnDeathEvent.GetHash() != 0)
   {
     CreateStream("Position", ezProcessingStream::DataType::Float4, &m_pStreamPosition, false);
-    CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false);
+    CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false, ezProcessingStream::DataLayout::SoA);
   }
 }
 
@@ -73,7 +72,8 @@ void ezParticleFinalizer_Age::InitializeElements(ezUInt64 uiStartIndex, ezUInt64
 {
   EZ_PROFILE_SCOPE("PFX: Age Init");
 
-  ezFloat16Vec2* pLifeTime = m_pStreamLifeTime->GetWritableData<ezFloat16Vec2>();
+  float* pLifeTime = m_pStreamLifeTime->GetWritableComponentData<float>(0);
+  float* pInvLifeTime = m_pStreamLifeTime->GetWritableComponentData<float>(1);
   const float fLifeScale = ezMath::Clamp(GetOwnerEffect()->GetFloatParameter(m_sLifeScaleParameter, 1.0f), 0.0f, 2.0f);
 
   if (m_LifeTime.m_fVariance == 0)
@@ -83,8 +83,8 @@ void ezParticleFinalizer_Age::InitializeElements(ezUInt64 uiStartIndex, ezUInt64
 
     for (ezUInt64 i = uiStartIndex; i < uiStartIndex + uiNumElements; ++i)
     {
-      pLifeTime[i].x = tLifeTime;
-      pLifeTime[i].y = tInvLifeTime;
+      pLifeTime[i] = tLifeTime;
+      pInvLifeTime[i] = tInvLifeTime;
     }
   }
   else // random range
@@ -97,8 +97,8 @@ void ezParticleFinalizer_Age::InitializeElements(ezUInt64 uiStartIndex, ezUInt64
                               0.01f; // make sure it's not zero
       const float tInvLifeTime = 1.0f / tLifeTime;
 
-      pLifeTime[i].x = tLifeTime;
-      pLifeTime[i].y = tInvLifeTime;
+      pLifeTime[i] = tLifeTime;
+      pInvLifeTime[i] = tInvLifeTime;
     }
   }
 }
@@ -107,33 +107,47 @@ void ezParticleFinalizer_Age::Process(ezUInt64 uiNumElements)
 {
   EZ_PROFILE_SCOPE("PFX: Age");
 
-  ezFloat16Vec2* pLifeTime = m_pStreamLifeTime->GetWritableData<ezFloat16Vec2>();
+  const ezSimdVec4f tDiff((float)m_TimeDiff.GetSeconds());
+  const ezSimdVec4f vZero = ezSimdVec4f::ZeroVector();
 
-  const float tDiff = (float)m_TimeDiff.GetSeconds();
+  ezProcessingStreamChunkIterator itLifeTime(m_pStreamLifeTime, uiNumElements, 0);
 
-  for (ezUInt32 i = 0; i < uiNumElements; ++i)
+  while (!itLifeTime.HasReachedEnd())
   {
-    pLifeTime[i].x = pLifeTime[i].x - tDiff;
+    const ezSimdVec4f remaining = (itLifeTime.Load(0) - tDiff).CompMax(vZero);
+    itLifeTime.Store(remaining, 0);
 
-    if (pLifeTime[i].x <= 0)
+    // only look at the individual particles, if any of them died
+    if ((remaining <= vZero).AnySet())
     {
-      pLifeTime[i].x = 0;
-
-      /// \todo Get current element index from iterator ?
-      m_pStreamGroup->RemoveElement(i);
+      const float* pRemaining = itLifeTime.GetComponent<float>(0);
+      const ezUInt32 uiNumValid = itLifeTime.GetNumValidElements();
+
+      for (ezUInt32 i = 0; i < uiNumValid; ++i)
+      {
+        if (pRemaining[i] <= 0)
+        {
+          m_pStreamGroup->RemoveElement(itLifeTime.GetCurrentIndex() + i);
+        }
+      }
     }
+
+    itLifeTime.Advance();
   }
 }
 
 void ezParticleFinalizer_Age::OnParticleDeath(const ezStreamGroupElementRemovedEvent& e)
 {
   const ezVec4* pPosition = m_pStreamPosition->GetData<ezVec4>();
-  const ezVec3* pVelocity = m_pStreamVelocity->GetData<ezVec3>();
+  const float* pVelocityX = m_pStreamVelocity->GetComponentData<float>(0);
+  const float* pVelocityY = m_pStreamVelocity->GetComponentData<float>(1);
+  const float* pVelocityZ = m_pStreamVelocity->GetComponentData<float>(2);
+  const ezUInt64 uiIndex = e.m_uiElementIndex;
 
   ezParticleEvent pe;
   pe.m_EventType = m_sOnDeathEvent;
-  pe.m_vPosition = pPosition[e.m_uiElementIndex].GetAsVec3();
-  pe.m_vDirection = pVelocity[e.m_uiElementIndex];
+  pe.m_vPosition = pPosition[uiIndex].GetAsVec3();
+  pe.m_vDirection.Set(pVelocityX[uiIndex], pVelocityY[uiIndex], pVelocityZ[uiIndex]);
   pe.m_vNormal.SetZero();
 
   GetOwnerEffect()->AddParticleEvent(pe);
@@ -1,9 +1,10 @@
 #include <ParticlePluginPCH.h>
 
 #include <Core/World/World.h>
-#include <Foundation/DataProcessing/Stream/ProcessingStreamIterator.h>
+#include <Foundation/DataProcessing/Stream/ProcessingStreamChunkIterator.h>
 #include <Foundation/Math/Declarations.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/SimdMath/SimdMat4f.h>
 #include <ParticlePlugin/Finalizer/ParticleFinalizer_ApplyVelocity.h>
 
 // clang-format off
@@ -33,25 +34,36 @@ ezParticleFinalizer_ApplyVelocity::~ezParticleFinalizer_ApplyVelocity() {}
 void ezParticleFinalizer_ApplyVelocity::CreateRequiredStreams()
 {
   CreateStream("Position", ezProcessingStream::DataType::Float4, &m_pStreamPosition, false);
-  CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false);
+  CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false, ezProcessingStream::DataLayout::SoA);
 }
 
 void ezParticleFinalizer_ApplyVelocity::Process(ezUInt64 uiNumElements)
 {
   EZ_PROFILE_SCOPE("PFX: ApplyVelocity");
 
-  const float tDiff = (float)m_TimeDiff.GetSeconds();
+  const ezSimdFloat tDiff = (float)m_TimeDiff.GetSeconds();
 
-  ezProcessingStreamIterator<ezVec4> itPosition(m_pStreamPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
+  ezSimdVec4f* pPosition = m_pStreamPosition->GetWritableData<ezSimdVec4f>();
 
-  while (!itPosition.HasReachedEnd())
+  ezProcessingStreamChunkIterator itVelocity(m_pStreamVelocity, uiNumElements, 0);
+
+  while (!itVelocity.HasReachedEnd())
   {
-    ezVec3& pos = reinterpret_cast<ezVec3&>(itPosition.Current());
+    // the positions are stored as AoS, so transpose the SoA velocity of four particles into one vector per particle
+    ezSimdMat4f velocity;
+    velocity.m_col0 = itVelocity.Load(0) * tDiff;
+    velocity.m_col1 = itVelocity.Load(1) * tDiff;
+    velocity.m_col2 = itVelocity.Load(2) * tDiff;
+    velocity.m_col3.SetZero();
+    velocity.Transpose();
 
-    pos += itVelocity.Current() * tDiff;
+    // the padding elements of the position stream can be written, too
+    ezSimdVec4f* pChunkPosition = pPosition + itVelocity.GetCurrentIndex();
+    pChunkPosition[0] += velocity.m_col0;
+    pChunkPosition[1] += velocity.m_col1;
+    pChunkPosition[2] += velocity.m_col2;
+    pChunkPosition[3] += velocity.m_col3;
 
-    itPosition.Advance();
     itVelocity.Advance();
   }
 }
@@ -146,7 +146,7 @@ void ezParticleInitializer_SpherePosition::CreateRequiredStreams()
 
   if (m_bSetVelocity)
   {
-    CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, true);
+    CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, true, ezProcessingStream::DataLayout::SoA);
   }
 }
 
@@ -157,7 +157,9 @@ void ezParticleInitializer_SpherePosition::InitializeElements(ezUInt64 uiStartIn
   const ezVec3 startVel = GetOwnerSystem()->GetParticleStartVelocity();
 
   ezVec4* pPosition = m_pStreamPosition->GetWritableData<ezVec4>();
-  ezVec3* pVelocity = m_bSetVelocity ? m_pStreamVelocity->GetWritableData<ezVec3>() : nullptr;
+  float* pVelocityX = m_bSetVelocity ? m_pStreamVelocity->GetWritableComponentData<float>(0) : nullptr;
+  float* pVelocityY = m_bSetVelocity ? m_pStreamVelocity->GetWritableComponentData<float>(1) : nullptr;
+  float* pVelocityZ = m_bSetVelocity ? m_pStreamVelocity->GetWritableComponentData<float>(2) : nullptr;
 
   ezRandom& rng = GetRNG();
 
@@ -182,7 +184,10 @@ void ezParticleInitializer_SpherePosition::InitializeElements(ezUInt64 uiStartIn
     {
       const float fSpeed = (float)rng.DoubleVariance(m_Speed.m_Value, m_Speed.m_fVariance);
 
-      pVelocity[i] = startVel + trans.m_qRotation * normalPos * fSpeed;
+      const ezVec3 vVelocity = startVel + trans.m_qRotation * normalPos * fSpeed;
+      pVelocityX[i] = vVelocity.x;
+      pVelocityY[i] = vVelocity.y;
+      pVelocityZ[i] = vVelocity.z;
     }
 
     pPosition[i] = (trans * pos).GetAsVec4(0);
@@ -75,7 +75,7 @@ void ezParticleInitializerFactory_VelocityCone::QueryFinalizerDependencies(ezSet
 
 void ezParticleInitializer_VelocityCone::CreateRequiredStreams()
 {
-  CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, true);
+  CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, true, ezProcessingStream::DataLayout::SoA);
 }
 
 void ezParticleInitializer_VelocityCone::InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
@@ -84,7 +84,9 @@ void ezParticleInitializer_VelocityCone::InitializeElements(ezUInt64 uiStartInde
 
   const ezVec3 startVel = GetOwnerSystem()->GetParticleStartVelocity();
 
-  ezVec3* pVelocity = m_pStreamVelocity->GetWritableData<ezVec3>();
+  float* pVelocityX = m_pStreamVelocity->GetWritableComponentData<float>(0);
+  float* pVelocityY = m_pStreamVelocity->GetWritableComponentData<float>(1);
+  float* pVelocityZ = m_pStreamVelocity->GetWritableComponentData<float>(2);
 
   ezRandom& rng = GetRNG();
 
@@ -111,7 +113,10 @@ void ezParticleInitializer_VelocityCone::InitializeElements(ezUInt64 uiStartInde
 
     const float fSpeed = (float)rng.DoubleVariance(m_Speed.m_Value, m_Speed.m_fVariance);
 
-    pVelocity[i] = startVel + GetOwnerSystem()->GetTransform().m_qRotation * dir * fSpeed;
+    const ezVec3 vVelocity = startVel + GetOwnerSystem()->GetTransform().m_qRotation * dir * fSpeed;
+    pVelocityX[i] = vVelocity.x;
+    pVelocityY[i] = vVelocity.y;
+    pVelocityZ[i] = vVelocity.z;
   }
 }
 
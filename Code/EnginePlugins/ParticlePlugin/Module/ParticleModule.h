@@ -42,9 +42,10 @@ protected:
   /// \brief Called by Reset()
   virtual void OnReset() {}
 
-  void CreateStream(const char* szName, ezProcessingStream::DataType Type, ezProcessingStream** ppStream, bool bWillInitializeStream)
+  void CreateStream(const char* szName, ezProcessingStream::DataType Type, ezProcessingStream** ppStream, bool bWillInitializeStream,
+                    ezProcessingStream::DataLayout Layout = ezProcessingStream::DataLayout::AoS)
   {
-    m_pOwnerSystem->CreateStream(szName, Type, ppStream, m_StreamBinding, bWillInitializeStream);
+    m_pOwnerSystem->CreateStream(szName, Type, ppStream, m_StreamBinding, bWillInitializeStream, Layout);
   }
 
   virtual ezResult UpdateStreamBindings() final override
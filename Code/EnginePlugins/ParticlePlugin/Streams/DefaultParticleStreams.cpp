@@ -113,7 +113,7 @@ EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezParticleStream_Velocity, 1, ezRTTIDefaultAlloc
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 
 ezParticleStreamFactory_Velocity::ezParticleStreamFactory_Velocity()
-    : ezParticleStreamFactory("Velocity", ezProcessingStream::DataType::Float3, ezGetStaticRTTI<ezParticleStream_Velocity>())
+    : ezParticleStreamFactory("Velocity", ezProcessingStream::DataType::Float3, ezGetStaticRTTI<ezParticleStream_Velocity>(), ezProcessingStream::DataLayout::SoA)
 {
 }
 
@@ -124,14 +124,17 @@ void ezParticleStream_Velocity::Initialize(ezParticleSystemInstance* pOwner)
 
 void ezParticleStream_Velocity::InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
 {
-  ezProcessingStreamIterator<ezVec3> itData(m_pStream, uiNumElements, uiStartIndex);
-
   const ezVec3 startVel = m_pOwner->GetParticleStartVelocity();
 
-  while (!itData.HasReachedEnd())
+  for (ezUInt32 uiComponent = 0; uiComponent < 3; ++uiComponent)
   {
-    itData.Current() = startVel;
-    itData.Advance();
+    float* pData = m_pStream->GetWritableComponentData<float>(uiComponent);
+    const float fValue = startVel.GetData()[uiComponent];
+
+    for (ezUInt64 i = uiStartIndex; i < uiStartIndex + uiNumElements; ++i)
+    {
+      pData[i] = fValue;
+    }
   }
 }
 
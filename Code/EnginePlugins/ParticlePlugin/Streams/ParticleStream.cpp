@@ -14,10 +14,11 @@ EZ_END_DYNAMIC_REFLECTED_TYPE;
 // clang-format on
 
 ezParticleStreamFactory::ezParticleStreamFactory(const char* szStreamName, ezProcessingStream::DataType dataType,
-                                                 const ezRTTI* pStreamTypeToCreate)
+                                                 const ezRTTI* pStreamTypeToCreate, ezProcessingStream::DataLayout dataLayout)
 {
   m_szStreamName = szStreamName;
   m_DataType = dataType;
+  m_DataLayout = dataLayout;
   m_pStreamTypeToCreate = pStreamTypeToCreate;
 }
 
@@ -31,6 +32,11 @@ ezProcessingStream::DataType ezParticleStreamFactory::GetStreamDataType() const
   return m_DataType;
 }
 
+ezProcessingStream::DataLayout ezParticleStreamFactory::GetStreamDataLayout() const
+{
+  return m_DataLayout;
+}
+
 const char* ezParticleStreamFactory::GetStreamName() const
 {
   return m_szStreamName;
@@ -49,7 +55,7 @@ ezParticleStream* ezParticleStreamFactory::CreateParticleStream(ezParticleSystem
 
   ezParticleStream* pStream = pRtti->GetAllocator()->Allocate<ezParticleStream>();
 
-  pOwner->CreateStream(GetStreamName(), GetStreamDataType(), &pStream->m_pStream, pStream->m_StreamBinding, true);
+  pOwner->CreateStream(GetStreamName(), GetStreamDataType(), &pStream->m_pStream, pStream->m_StreamBinding, true, GetStreamDataLayout());
   pStream->Initialize(pOwner);
 
   return pStream;
@@ -71,6 +77,19 @@ ezResult ezParticleStream::UpdateStreamBindings()
 
 void ezParticleStream::InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
 {
+  if (m_pStream->GetDataLayout() == ezProcessingStream::DataLayout::SoA)
+  {
+    const ezUInt64 uiComponentSize = m_pStream->GetComponentSize();
+
+    for (ezUInt32 uiComponent = 0; uiComponent < m_pStream->GetComponentCount(); ++uiComponent)
+    {
+      ezUInt8* pComponentData = m_pStream->GetWritableComponentData<ezUInt8>(uiComponent);
+      ezMemoryUtils::ZeroFill<ezUInt8>(pComponentData + uiStartIndex * uiComponentSize, static_cast<size_t>(uiNumElements * uiComponentSize));
+    }
+
+    return;
+  }
+
   const ezUInt64 uiElementSize = m_pStream->GetElementSize();
   const ezUInt64 uiElementStride = m_pStream->GetElementStride();
 
@@ -15,10 +15,12 @@ class EZ_PARTICLEPLUGIN_DLL ezParticleStreamFactory : public ezReflectedClass
   EZ_ADD_DYNAMIC_REFLECTION(ezParticleStreamFactory, ezReflectedClass);
 
 public:
-  ezParticleStreamFactory(const char* szStreamName, ezProcessingStream::DataType dataType, const ezRTTI* pStreamTypeToCreate);
+  ezParticleStreamFactory(const char* szStreamName, ezProcessingStream::DataType dataType, const ezRTTI* pStreamTypeToCreate,
+                          ezProcessingStream::DataLayout dataLayout = ezProcessingStream::DataLayout::AoS);
 
   const ezRTTI* GetParticleStreamType() const;
   ezProcessingStream::DataType GetStreamDataType() const;
+  ezProcessingStream::DataLayout GetStreamDataLayout() const;
   const char* GetStreamName() const;
 
   static void GetFullStreamName(const char* szName, ezProcessingStream::DataType type, ezStringBuilder& out_Result);
@@ -28,6 +30,7 @@ public:
 private:
   const char* m_szStreamName = nullptr;
   ezProcessingStream::DataType m_DataType = ezProcessingStream::DataType::Float;
+  ezProcessingStream::DataLayout m_DataLayout = ezProcessingStream::DataLayout::AoS;
   const ezRTTI* m_pStreamTypeToCreate = nullptr;
 };
 
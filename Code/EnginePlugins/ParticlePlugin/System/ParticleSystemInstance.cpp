@@ -465,7 +465,7 @@ const ezProcessingStream* ezParticleSystemInstance::QueryStream(const char* szNa
 }
 
 void ezParticleSystemInstance::CreateStream(const char* szName, ezProcessingStream::DataType Type, ezProcessingStream** ppStream,
-  ezParticleStreamBinding& binding, bool bWillInitializeElements)
+  ezParticleStreamBinding& binding, bool bWillInitializeElements, ezProcessingStream::DataLayout Layout)
 {
   EZ_ASSERT_DEV(ppStream != nullptr, "The pointer to the stream pointer must not be null");
 
@@ -477,7 +477,7 @@ void ezParticleSystemInstance::CreateStream(const char* szName, ezProcessingStre
   ezProcessingStream* pStream = m_StreamGroup.GetStreamByName(fullName);
   if (pStream == nullptr)
   {
-    pStream = m_StreamGroup.AddStream(fullName, Type);
+    pStream = m_StreamGroup.AddStream(fullName, Type, Layout);
 
     pInfo = &m_StreamInfo.ExpandAndGetRef();
     pInfo->m_sName = fullName;
@@ -501,6 +501,7 @@ void ezParticleSystemInstance::CreateStream(const char* szName, ezProcessingStre
     pInfo->m_bGetsInitialized = true;
 
   EZ_ASSERT_DEV(pStream != nullptr, "Stream creation failed ('{0}' -> '{1}')", szName, fullName);
+  EZ_ASSERT_DEV(pStream->GetDataLayout() == Layout, "Particle stream '{0}' is used with different data layouts", szName);
   *ppStream = pStream;
 
   {
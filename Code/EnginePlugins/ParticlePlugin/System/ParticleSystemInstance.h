@@ -53,8 +53,10 @@ public:
   const ezProcessingStream* QueryStream(const char* szName, ezProcessingStream::DataType Type) const;
 
   /// \brief Returns the desired stream, if it already exists, creates it otherwise.
+  ///
+  /// All modules that use the same stream have to request the same layout.
   void CreateStream(const char* szName, ezProcessingStream::DataType Type, ezProcessingStream** ppStream, ezParticleStreamBinding& binding,
-                    bool bExpectInitializedValue);
+                    bool bExpectInitializedValue, ezProcessingStream::DataLayout Layout = ezProcessingStream::DataLayout::AoS);
 
   void ProcessEventQueue(ezParticleEventQueue queue);
 
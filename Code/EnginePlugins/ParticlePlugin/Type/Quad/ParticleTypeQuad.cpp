@@ -152,7 +152,7 @@ ezParticleTypeQuad::~ezParticleTypeQuad() = default;
 
 void ezParticleTypeQuad::CreateRequiredStreams()
 {
-  CreateStream("LifeTime", ezProcessingStream::DataType::Half2, &m_pStreamLifeTime, false);
+  CreateStream("LifeTime", ezProcessingStream::DataType::Float2, &m_pStreamLifeTime, false, ezProcessingStream::DataLayout::SoA);
   CreateStream("Position", ezProcessingStream::DataType::Float4, &m_pStreamPosition, false);
   CreateStream("Size", ezProcessingStream::DataType::Half, &m_pStreamSize, false);
   CreateStream("Color", ezProcessingStream::DataType::Half4, &m_pStreamColor, false);
@@ -177,7 +177,7 @@ void ezParticleTypeQuad::CreateRequiredStreams()
 
   if (m_Orientation == ezQuadParticleOrientation::FixedAxis_ParticleDir)
   {
-    CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false);
+    CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false, ezProcessingStream::DataLayout::SoA);
   }
 }
 
@@ -269,7 +269,8 @@ void ezParticleTypeQuad::CreateExtractedData(const ezView& view, ezExtractedRend
   const ezTime tCur = GetOwnerEffect()->GetTotalEffectLifeTime();
   const ezColor tintColor = GetOwnerEffect()->GetColorParameter(m_sTintColorParameter, ezColor::White);
 
-  const ezFloat16Vec2* pLifeTime = m_pStreamLifeTime->GetData<ezFloat16Vec2>();
+  const float* pLifeTime = m_pStreamLifeTime->GetComponentData<float>(0);
+  const float* pInvLifeTime = m_pStreamLifeTime->GetComponentData<float>(1);
   const ezVec4* pPosition = m_pStreamPosition->GetData<ezVec4>();
   const ezFloat16* pSize = m_pStreamSize->GetData<ezFloat16>();
   const ezColorLinear16f* pColor = m_pStreamColor->GetData<ezColorLinear16f>();
@@ -277,7 +278,9 @@ void ezParticleTypeQuad::CreateExtractedData(const ezView& view, ezExtractedRend
   const ezFloat16* pRotationOffset = m_pStreamRotationOffset->GetData<ezFloat16>();
   const ezVec3* pAxis = m_pStreamAxis ? m_pStreamAxis->GetData<ezVec3>() : nullptr;
   const ezUInt32* pVariation = m_pStreamVariation ? m_pStreamVariation->GetData<ezUInt32>() : nullptr;
-  const ezVec3* pVelocity = m_pStreamVelocity ? m_pStreamVelocity->GetData<ezVec3>() : nullptr;
+  const float* pVelocityX = m_pStreamVelocity ? m_pStreamVelocity->GetComponentData<float>(0) : nullptr;
+  const float* pVelocityY = m_pStreamVelocity ? m_pStreamVelocity->GetComponentData<float>(1) : nullptr;
+  const float* pVelocityZ = m_pStreamVelocity ? m_pStreamVelocity->GetComponentData<float>(2) : nullptr;
 
   // this will automatically be deallocated at the end of the frame
   m_BaseParticleData = EZ_NEW_ARRAY(ezFrameAllocator::GetCurrentAllocator(), ezBaseParticleShaderData, numParticles);
@@ -288,7 +291,7 @@ void ezParticleTypeQuad::CreateExtractedData(const ezView& view, ezExtractedRend
 
     m_BaseParticleData[dstIdx].Size = pSize[srcIdx];
     m_BaseParticleData[dstIdx].Color = pColor[srcIdx].ToLinearFloat() * tintColor;
-    m_BaseParticleData[dstIdx].Life = pLifeTime[srcIdx].x * pLifeTime[srcIdx].y;
+    m_BaseParticleData[dstIdx].Life = pLifeTime[srcIdx] * pInvLifeTime[srcIdx];
     m_BaseParticleData[dstIdx].Variation = (pVariation != nullptr) ? pVariation[srcIdx] : 0;
   };
 
@@ -350,7 +353,7 @@ void ezParticleTypeQuad::CreateExtractedData(const ezView& view, ezExtractedRend
   auto SetTangentDataAligned_ParticleDir = [&](ezUInt32 dstIdx, ezUInt32 srcIdx) {
 
     m_TangentParticleData[dstIdx].Position = pPosition[srcIdx].GetAsVec3();
-    m_TangentParticleData[dstIdx].TangentX = pVelocity[srcIdx];
+    m_TangentParticleData[dstIdx].TangentX = ezVec3(pVelocityX[srcIdx], pVelocityY[srcIdx], pVelocityZ[srcIdx]);
     m_TangentParticleData[dstIdx].TangentZ.x = m_fStretch;
   };
 
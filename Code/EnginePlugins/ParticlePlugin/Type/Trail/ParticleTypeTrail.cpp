@@ -175,7 +175,7 @@ ezParticleTypeTrail::~ezParticleTypeTrail()
 
 void ezParticleTypeTrail::CreateRequiredStreams()
 {
-  CreateStream("LifeTime", ezProcessingStream::DataType::Half2, &m_pStreamLifeTime, false);
+  CreateStream("LifeTime", ezProcessingStream::DataType::Float2, &m_pStreamLifeTime, false, ezProcessingStream::DataLayout::SoA);
   CreateStream("Position", ezProcessingStream::DataType::Float4, &m_pStreamPosition, false);
   CreateStream("Size", ezProcessingStream::DataType::Half, &m_pStreamSize, false);
   CreateStream("Color", ezProcessingStream::DataType::Half4, &m_pStreamColor, false);
@@ -212,7 +212,8 @@ void ezParticleTypeTrail::ExtractTypeRenderData(const ezView& view, ezExtractedR
     const ezFloat16* pSize = m_pStreamSize->GetData<ezFloat16>();
     const ezColorLinear16f* pColor = m_pStreamColor->GetData<ezColorLinear16f>();
     const TrailData* pTrailData = m_pStreamTrailData->GetData<TrailData>();
-    const ezFloat16Vec2* pLifeTime = m_pStreamLifeTime->GetData<ezFloat16Vec2>();
+    const float* pLifeTime = m_pStreamLifeTime->GetComponentData<float>(0);
+    const float* pInvLifeTime = m_pStreamLifeTime->GetComponentData<float>(1);
     const ezUInt32* pVariation = m_pStreamVariation ? m_pStreamVariation->GetData<ezUInt32>() : nullptr;
 
     const ezUInt32 uiBucketSize = ComputeTrailPointBucketSize(m_uiMaxPoints);
@@ -229,7 +230,7 @@ void ezParticleTypeTrail::ExtractTypeRenderData(const ezView& view, ezExtractedR
     {
       m_BaseParticleData[p].Size = pSize[p];
       m_BaseParticleData[p].Color = pColor[p].ToLinearFloat() * tintColor;
-      m_BaseParticleData[p].Life = pLifeTime[p].x * pLifeTime[p].y;
+      m_BaseParticleData[p].Life = pLifeTime[p] * pInvLifeTime[p];
       m_BaseParticleData[p].Variation = (pVariation != nullptr) ? pVariation[p] : 0;
 
       m_TrailParticleData[p].NumPoints = pTrailData[p].m_uiNumPoints;
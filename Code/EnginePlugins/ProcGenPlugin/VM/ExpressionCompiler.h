@@ -10,14 +10,34 @@ public:
   ezExpressionCompiler();
   ~ezExpressionCompiler();
 
-  ezResult Compile(ezExpressionAST& ast, ezExpressionByteCode& out_byteCode);
+  /// \brief Compiles the given AST to byte code. If bOptimize is set, the AST is optimized in place first.
+  ///
+  /// The optimization folds constant subtrees, merges identical subexpressions and removes outputs that are overwritten by a later output
+  /// with the same name. Folded constants are computed with the same SIMD operations as the VM, so the results are bit-identical.
+  ezResult Compile(ezExpressionAST& ast, ezExpressionByteCode& out_byteCode, bool bOptimize = true);
 
 private:
+  ezResult OptimizeAST(ezExpressionAST& ast);
+  ezExpressionAST::Node* FoldConstants(ezExpressionAST& ast, ezExpressionAST::Node* pNode);
+  ezExpressionAST::Node* MergeCommonSubexpression(ezExpressionAST::Node* pNode);
+
   ezResult BuildNodeInstructions(const ezExpressionAST& ast);
   ezResult UpdateRegisterLifetime(const ezExpressionAST& ast);
   ezResult AssignRegisters();
   ezResult GenerateByteCode(const ezExpressionAST& ast, ezExpressionByteCode& out_byteCode);
 
+  struct OptimizeStackEntry
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezExpressionAST::Node* m_pNode;
+    bool m_bChildrenVisited;
+  };
+
+  ezHybridArray<OptimizeStackEntry, 64> m_OptimizeStack;
+  ezHashTable<ezExpressionAST::Node*, ezExpressionAST::Node*> m_NodeReplacements;
+  ezHashTable<ezUInt32, ezHybridArray<ezExpressionAST::Node*, 2>> m_NodesByHash;
+
   ezHybridArray<const ezExpressionAST::Node*, 64> m_NodeStack;
   ezHybridArray<const ezExpressionAST::Node*, 64> m_NodeInstructions;
   ezHashTable<const ezExpressionAST::Node*, ezUInt32> m_NodeToRegisterIndex;
@@ -1,5 +1,6 @@
 #include <ProcGenPluginPCH.h>
 
+#include <Foundation/SimdMath/SimdMath.h>
 #include <ProcGenPlugin/VM/ExpressionByteCode.h>
 #include <ProcGenPlugin/VM/ExpressionCompiler.h>
 
@@ -45,13 +46,148 @@ namespace
         return ezExpressionByteCode::OpCode::FirstUnary;
     }
   }
+
+  // These need to use exactly the same operations as ezExpressionVM::Execute, otherwise folded constants would differ from the values
+  // the VM computes at runtime.
+  static bool EvaluateUnaryOperator(ezExpressionAST::NodeType::Enum nodeType, const ezSimdVec4f& x, ezSimdVec4f& out_result)
+  {
+    switch (nodeType)
+    {
+      case ezExpressionAST::NodeType::Absolute:
+        out_result = x.Abs();
+        return true;
+      case ezExpressionAST::NodeType::Sqrt:
+        out_result = x.GetSqrt();
+        return true;
+
+      case ezExpressionAST::NodeType::Sin:
+        out_result = ezSimdMath::Sin(x);
+        return true;
+      case ezExpressionAST::NodeType::Cos:
+        out_result = ezSimdMath::Cos(x);
+        return true;
+      case ezExpressionAST::NodeType::Tan:
+        out_result = ezSimdMath::Tan(x);
+        return true;
+
+      case ezExpressionAST::NodeType::ASin:
+        out_result = ezSimdMath::ASin(x);
+        return true;
+      case ezExpressionAST::NodeType::ACos:
+        out_result = ezSimdMath::ACos(x);
+        return true;
+      case ezExpressionAST::NodeType::ATan:
+        out_result = ezSimdMath::ATan(x);
+        return true;
+
+      default:
+        return false;
+    }
+  }
+
+  static bool EvaluateBinaryOperator(ezExpressionAST::NodeType::Enum nodeType, const ezSimdVec4f& a, const ezSimdVec4f& b, ezSimdVec4f& out_result)
+  {
+    switch (nodeType)
+    {
+      case ezExpressionAST::NodeType::Add:
+        out_result = a + b;
+        return true;
+      case ezExpressionAST::NodeType::Subtract:
+        out_result = a - b;
+        return true;
+      case ezExpressionAST::NodeType::Multiply:
+        out_result = a.CompMul(b);
+        return true;
+      case ezExpressionAST::NodeType::Divide:
+        out_result = a.CompDiv(b);
+        return true;
+      case ezExpressionAST::NodeType::Min:
+        out_result = a.CompMin(b);
+        return true;
+      case ezExpressionAST::NodeType::Max:
+        out_result = a.CompMax(b);
+        return true;
+
+      default:
+        return false;
+    }
+  }
+
+  static ezUInt32 GetConstantBits(const ezExpressionAST::Node* pNode)
+  {
+    const float fValue = static_cast<const ezExpressionAST::Constant*>(pNode)->m_Value.Get<float>();
+    return *reinterpret_cast<const ezUInt32*>(&fValue);
+  }
+
+  static ezUInt32 GetNodeHash(const ezExpressionAST::Node* pNode)
+  {
+    ezHybridArray<ezUInt64, 16> values;
+    values.PushBack(pNode->m_Type.GetValue());
+
+    ezExpressionAST::NodeType::Enum nodeType = pNode->m_Type;
+    if (ezExpressionAST::NodeType::IsConstant(nodeType))
+    {
+      values.PushBack(GetConstantBits(pNode));
+    }
+    else if (ezExpressionAST::NodeType::IsInput(nodeType))
+    {
+      values.PushBack(static_cast<const ezExpressionAST::Input*>(pNode)->m_sName.GetHash());
+    }
+    else if (nodeType == ezExpressionAST::NodeType::FunctionCall)
+    {
+      values.PushBack(static_cast<const ezExpressionAST::FunctionCall*>(pNode)->m_sName.GetHash());
+    }
+
+    for (auto pChild : ezExpressionAST::GetChildren(pNode))
+    {
+      values.PushBack(reinterpret_cast<ezUInt64>(pChild));
+    }
+
+    return ezHashingUtils::xxHash32(values.GetData(), values.GetCount() * sizeof(ezUInt64));
+  }
+
+  // Children are expected to be merged already, so they can be compared by pointer.
+  static bool IsEquivalent(const ezExpressionAST::Node* pNodeA, const ezExpressionAST::Node* pNodeB)
+  {
+    if (pNodeA->m_Type != pNodeB->m_Type)
+      return false;
+
+    ezExpressionAST::NodeType::Enum nodeType = pNodeA->m_Type;
+    if (ezExpressionAST::NodeType::IsConstant(nodeType))
+    {
+      // compare the bits, not the values, so +0 and -0 are not merged
+      return GetConstantBits(pNodeA) == GetConstantBits(pNodeB);
+    }
+    else if (ezExpressionAST::NodeType::IsInput(nodeType))
+    {
+      return static_cast<const ezExpressionAST::Input*>(pNodeA)->m_sName == static_cast<const ezExpressionAST::Input*>(pNodeB)->m_sName;
+    }
+    else if (ezExpressionAST::NodeType::IsOutput(nodeType))
+    {
+      // outputs have side effects and are never merged
+      return false;
+    }
+    else if (nodeType == ezExpressionAST::NodeType::FunctionCall)
+    {
+      // expression functions are required to be state-less, so identical calls return identical results
+      if (static_cast<const ezExpressionAST::FunctionCall*>(pNodeA)->m_sName != static_cast<const ezExpressionAST::FunctionCall*>(pNodeB)->m_sName)
+        return false;
+    }
+
+    auto childrenA = ezExpressionAST::GetChildren(pNodeA);
+    auto childrenB = ezExpressionAST::GetChildren(pNodeB);
+    return childrenA == childrenB;
+  }
 } // namespace
 
 ezExpressionCompiler::ezExpressionCompiler() = default;
 ezExpressionCompiler::~ezExpressionCompiler() = default;
 
-ezResult ezExpressionCompiler::Compile(ezExpressionAST& ast, ezExpressionByteCode& out_byteCode)
+ezResult ezExpressionCompiler::Compile(ezExpressionAST& ast, ezExpressionByteCode& out_byteCode, bool bOptimize /*= true*/)
 {
+  if (bOptimize && OptimizeAST(ast).Failed())
+    return EZ_FAILURE;
+
   if (BuildNodeInstructions(ast).Failed())
     return EZ_FAILURE;
 
@@ -67,6 +203,148 @@ ezResult ezExpressionCompiler::Compile(ezExpressionAST& ast, ezExpressionByteCod
   return EZ_SUCCESS;
 }
 
+ezResult ezExpressionCompiler::OptimizeAST(ezExpressionAST& ast)
+{
+  // Dead code elimination: if there are multiple outputs with the same name, only the one that is written last is visible.
+  // BuildNodeInstructions emits the outputs in reverse order, so that is the first one in the list.
+  // Nodes that no output depends on are never reached by the traversal below or in BuildNodeInstructions.
+  {
+    ezHashSet<ezHashedString> writtenOutputs;
+
+    for (ezUInt32 i = 0; i < ast.m_OutputNodes.GetCount();)
+    {
+      auto pOutputNode = ast.m_OutputNodes[i];
+      if (pOutputNode == nullptr || writtenOutputs.Insert(pOutputNode->m_sName))
+      {
+        ast.m_OutputNodes.RemoveAtAndCopy(i);
+      }
+      else
+      {
+        ++i;
+      }
+    }
+  }
+
+  m_OptimizeStack.Clear();
+  m_NodeReplacements.Clear();
+  m_NodesByHash.Clear();
+
+  // Post order traversal, every node is visited once after all its children have been replaced by their optimized version.
+  for (ezExpressionAST::Output* pOutputNode : ast.m_OutputNodes)
+  {
+    m_OptimizeStack.PushBack({pOutputNode, false});
+
+    while (!m_OptimizeStack.IsEmpty())
+    {
+      auto& currentEntry = m_OptimizeStack.PeekBack();
+      ezExpressionAST::Node* pCurrentNode = currentEntry.m_pNode;
+
+      if (m_NodeReplacements.Contains(pCurrentNode))
+      {
+        m_OptimizeStack.PopBack();
+        continue;
+      }
+
+      if (!currentEntry.m_bChildrenVisited)
+      {
+        currentEntry.m_bChildrenVisited = true;
+
+        for (auto pChild : ezExpressionAST::GetChildren(pCurrentNode))
+        {
+          if (pChild == nullptr)
+          {
+            // invalid AST, BuildNodeInstructions reports this
+            return EZ_SUCCESS;
+          }
+
+          if (!m_NodeReplacements.Contains(pChild))
+          {
+            m_OptimizeStack.PushBack({pChild, false});
+          }
+        }
+
+        continue;
+      }
+
+      m_OptimizeStack.PopBack();
+
+      for (auto& pChild : ezExpressionAST::GetChildren(pCurrentNode))
+      {
+        pChild = m_NodeReplacements[pChild];
+      }
+
+      ezExpressionAST::Node* pNewNode = FoldConstants(ast, pCurrentNode);
+      pNewNode = MergeCommonSubexpression(pNewNode);
+
+      m_NodeReplacements.Insert(pCurrentNode, pNewNode);
+    }
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezExpressionAST::Node* ezExpressionCompiler::FoldConstants(ezExpressionAST& ast, ezExpressionAST::Node* pNode)
+{
+  ezExpressionAST::NodeType::Enum nodeType = pNode->m_Type;
+  ezSimdVec4f result;
+
+  if (ezExpressionAST::NodeType::IsUnary(nodeType))
+  {
+    auto pUnary = static_cast<ezExpressionAST::UnaryOperator*>(pNode);
+    if (ezExpressionAST::NodeType::IsConstant(pUnary->m_pOperand->m_Type))
+    {
+      const float fValue = static_cast<const ezExpressionAST::Constant*>(pUnary->m_pOperand)->m_Value.Get<float>();
+      if (EvaluateUnaryOperator(nodeType, ezSimdVec4f(fValue), result))
+      {
+        return ast.CreateConstant(static_cast<float>(result.x()));
+      }
+    }
+  }
+  else if (ezExpressionAST::NodeType::IsBinary(nodeType))
+  {
+    auto pBinary = static_cast<ezExpressionAST::BinaryOperator*>(pNode);
+    const bool bLeftIsConstant = ezExpressionAST::NodeType::IsConstant(pBinary->m_pLeftOperand->m_Type);
+    const bool bRightIsConstant = ezExpressionAST::NodeType::IsConstant(pBinary->m_pRightOperand->m_Type);
+
+    if (bLeftIsConstant && bRightIsConstant)
+    {
+      const float fLeftValue = static_cast<const ezExpressionAST::Constant*>(pBinary->m_pLeftOperand)->m_Value.Get<float>();
+      const float fRightValue = static_cast<const ezExpressionAST::Constant*>(pBinary->m_pRightOperand)->m_Value.Get<float>();
+      if (EvaluateBinaryOperator(nodeType, ezSimdVec4f(fLeftValue), ezSimdVec4f(fRightValue), result))
+      {
+        return ast.CreateConstant(static_cast<float>(result.x()));
+      }
+    }
+    else if (bRightIsConstant && (nodeType == ezExpressionAST::NodeType::Add || nodeType == ezExpressionAST::NodeType::Multiply))
+    {
+      // The VM only has constant versions of binary operators that take the constant as left operand.
+      // Add and multiply are commutative, so swap the operands to save the separate mov instruction for the constant.
+      // Min and max are not, since the result differs for NaN and signed zero inputs.
+      ezMath::Swap(pBinary->m_pLeftOperand, pBinary->m_pRightOperand);
+    }
+  }
+
+  return pNode;
+}
+
+ezExpressionAST::Node* ezExpressionCompiler::MergeCommonSubexpression(ezExpressionAST::Node* pNode)
+{
+  if (ezExpressionAST::NodeType::IsOutput(pNode->m_Type))
+    return pNode;
+
+  auto& nodes = m_NodesByHash[GetNodeHash(pNode)];
+  for (auto pExistingNode : nodes)
+  {
+    if (IsEquivalent(pExistingNode, pNode))
+    {
+      return pExistingNode;
+    }
+  }
+
+  nodes.PushBack(pNode);
+  return pNode;
+}
+
 ezResult ezExpressionCompiler::BuildNodeInstructions(const ezExpressionAST& ast)
 {
   m_NodeStack.Clear();
@@ -2,9 +2,12 @@
 
 #include <Core/Utils/WorldGeoExtractionUtil.h>
 #include <Core/World/World.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Time/Stopwatch.h>
 #include <Foundation/Types/ScopeExit.h>
 #include <Foundation/Utilities/Progress.h>
+#include <Recast/DetourCommon.h>
 #include <Recast/DetourNavMesh.h>
 #include <Recast/DetourNavMeshBuilder.h>
 #include <Recast/Recast.h>
@@ -12,7 +15,7 @@
 #include <RecastPlugin/Resources/RecastNavMeshResource.h>
 
 // clang-format off
-EZ_BEGIN_STATIC_REFLECTED_TYPE(ezRecastConfig, ezNoBase, 1, ezRTTIDefaultAllocator<ezRecastConfig>)
+EZ_BEGIN_STATIC_REFLECTED_TYPE(ezRecastConfig, ezNoBase, 2, ezRTTIDefaultAllocator<ezRecastConfig>)
 {
   EZ_BEGIN_PROPERTIES
   {
@@ -28,6 +31,7 @@ EZ_BEGIN_STATIC_REFLECTED_TYPE(ezRecastConfig, ezNoBase, 1, ezRTTIDefaultAllocat
     EZ_MEMBER_PROPERTY("SampleErrorFactor", m_fDetailMeshSampleErrorFactor)->AddAttributes(new ezDefaultValueAttribute(1.0f)),
     EZ_MEMBER_PROPERTY("MaxSimplification", m_fMaxSimplificationError)->AddAttributes(new ezDefaultValueAttribute(1.3f)),
     EZ_MEMBER_PROPERTY("MaxEdgeLength", m_fMaxEdgeLength)->AddAttributes(new ezDefaultValueAttribute(4.0f)),
+    EZ_MEMBER_PROPERTY("TileSize", m_fTileSize)->AddAttributes(new ezDefaultValueAttribute(32.0f), new ezClampValueAttribute(4.0f, ezVariant())),
   }
   EZ_END_PROPERTIES;
 }
@@ -61,16 +65,19 @@ protected:
   }
 };
 
+static ezUInt64 GetTileKey(ezInt32 iTileX, ezInt32 iTileY)
+{
+  return (static_cast<ezUInt64>(static_cast<ezUInt32>(iTileX)) << 32) | static_cast<ezUInt32>(iTileY);
+}
+
 ezRecastNavMeshBuilder::ezRecastNavMeshBuilder() = default;
 ezRecastNavMeshBuilder::~ezRecastNavMeshBuilder() = default;
 
 void ezRecastNavMeshBuilder::Clear()
 {
-  m_BoundingBox.SetInvalid();
   m_Vertices.Clear();
   m_Triangles.Clear();
-  m_TriangleAreaIDs.Clear();
-  m_pRecastContext = nullptr;
+  m_Tiles.Clear();
 }
 
 ezResult ezRecastNavMeshBuilder::ExtractWorldGeometry(const ezWorld& world, ezWorldGeoExtractionUtil::Geometry& out_worldGeo)
@@ -81,21 +88,16 @@ ezResult ezRecastNavMeshBuilder::ExtractWorldGeometry(const ezWorld& world, ezWo
 }
 
 ezResult ezRecastNavMeshBuilder::Build(const ezRecastConfig& config, const ezWorldGeoExtractionUtil::Geometry& geo,
-  ezRecastNavMeshResourceDescriptor& out_NavMeshDesc, ezProgress& progress)
+  ezRecastNavMeshResourceDescriptor& inout_NavMeshDesc, ezProgress& progress)
 {
   EZ_LOG_BLOCK("ezRecastNavMeshBuilder::Build");
 
-  ezProgressRange pg("Generating NavMesh", 4, true, &progress);
+  ezProgressRange pg("Generating NavMesh", 3, true, &progress);
   pg.SetStepWeighting(0, 0.1f);
   pg.SetStepWeighting(1, 0.1f);
-  pg.SetStepWeighting(2, 0.6f);
-  pg.SetStepWeighting(3, 0.2f);
+  pg.SetStepWeighting(2, 0.8f);
 
   Clear();
-  out_NavMeshDesc.Clear();
-
-  ezUniquePtr<ezRcBuildContext> recastContext = EZ_DEFAULT_NEW(ezRcBuildContext);
-  m_pRecastContext = recastContext.Borrow();
 
   if (!pg.BeginNextStep("Triangulate Mesh"))
     return EZ_FAILURE;
@@ -105,27 +107,115 @@ ezResult ezRecastNavMeshBuilder::Build(const ezRecastConfig& config, const ezWor
   if (m_Vertices.IsEmpty())
   {
     ezLog::Debug("Navmesh is empty");
+    inout_NavMeshDesc.Clear();
     return EZ_SUCCESS;
   }
 
-  if (!pg.BeginNextStep("Compute AABB"))
+  if (!pg.BeginNextStep("Sort Into Tiles"))
     return EZ_FAILURE;
 
-  ComputeBoundingBox();
+  rcConfig cfg;
+  FillOutConfig(cfg, config);
+
+  SortTrianglesIntoTiles(cfg);
 
-  if (!pg.BeginNextStep("Build Poly Mesh"))
+  if (!pg.BeginNextStep("Build Tiles"))
     return EZ_FAILURE;
 
-  out_NavMeshDesc.m_pNavMeshPolygons = EZ_DEFAULT_NEW(rcPolyMesh);
+  ezUInt64 uiConfigHash = 0;
+  {
+    ezMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+    config.Serialize(writer);
 
-  if (BuildRecastPolyMesh(config, *out_NavMeshDesc.m_pNavMeshPolygons, progress).Failed())
-    return EZ_FAILURE;
+    uiConfigHash = ezHashingUtils::xxHash64(storage.GetData(), storage.GetStorageSize());
+  }
+
+  // tiles of a previous build can only be reused if they are on the same grid
+  const float fTileSize = cfg.tileSize * cfg.cs;
+  ezHashTable<ezUInt64, ezUInt32> previousTiles;
+
+  if (inout_NavMeshDesc.m_fTileSize == fTileSize)
+  {
+    for (ezUInt32 i = 0; i < inout_NavMeshDesc.m_Tiles.GetCount(); ++i)
+    {
+      const auto& tile = inout_NavMeshDesc.m_Tiles[i];
+      previousTiles.Insert(GetTileKey(tile.m_iTileX, tile.m_iTileY), i);
+    }
+  }
+
+  ezDynamicArray<ezRecastNavMeshTile> tiles;
+  tiles.SetCount(m_Tiles.GetCount());
+
+  ezAtomicInteger32 iNumBuiltTiles;
+  ezAtomicInteger32 iNumFailedTiles;
+
+  ezParallelForParams params;
+  params.uiBinSize = 1;
 
-  if (!pg.BeginNextStep("Build NavMesh"))
+  ezTaskSystem::ParallelForIndexed(0, m_Tiles.GetCount(),
+    [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+      for (ezUInt32 uiTile = uiStartIndex; uiTile < uiEndIndex; ++uiTile)
+      {
+        const TileInput& input = m_Tiles[uiTile];
+        ezRecastNavMeshTile& tile = tiles[uiTile];
+
+        const ezUInt64 uiInputHash = ComputeTileInputHash(input, uiConfigHash);
+
+        ezUInt32 uiPreviousTile;
+        if (previousTiles.TryGetValue(GetTileKey(input.m_iTileX, input.m_iTileY), uiPreviousTile) &&
+            inout_NavMeshDesc.m_Tiles[uiPreviousTile].m_uiInputHash == uiInputHash)
+        {
+          // nothing in this tile has changed, every previous tile is only looked at by the one task that builds its coordinates
+          tile = std::move(inout_NavMeshDesc.m_Tiles[uiPreviousTile]);
+          continue;
+        }
+
+        if (progress.WasCanceled())
+          return;
+
+        tile.m_iTileX = input.m_iTileX;
+        tile.m_iTileY = input.m_iTileY;
+        tile.m_uiInputHash = uiInputHash;
+
+        ezRcBuildContext context;
+        if (BuildTile(config, cfg, input, &context, tile).Failed())
+        {
+          iNumFailedTiles.Increment();
+        }
+
+        iNumBuiltTiles.Increment();
+      }
+    },
+    "BuildNavMeshTiles", params);
+
+  if (progress.WasCanceled() || iNumFailedTiles > 0)
     return EZ_FAILURE;
 
-  if (BuildDetourNavMeshData(config, *out_NavMeshDesc.m_pNavMeshPolygons, out_NavMeshDesc.m_DetourNavmeshData).Failed())
+  ezInt32 iMaxPolysPerTile = 1;
+  for (const auto& tile : tiles)
+  {
+    if (tile.m_pNavMeshPolygons != nullptr)
+    {
+      iMaxPolysPerTile = ezMath::Max(iMaxPolysPerTile, tile.m_pNavMeshPolygons->npolys);
+    }
+  }
+
+  // Detour stores the tile and polygon index together with a salt in a 32 bit polygon reference
+  const ezUInt32 uiTileBits = dtIlog2(dtNextPow2(tiles.GetCount()));
+  const ezUInt32 uiPolyBits = dtIlog2(dtNextPow2(iMaxPolysPerTile));
+  if (uiTileBits + uiPolyBits > 22)
+  {
+    ezLog::Error("NavMesh has too many tiles ({0}) or polygons per tile ({1}). Increase the tile size or the cell size.", tiles.GetCount(),
+      iMaxPolysPerTile);
     return EZ_FAILURE;
+  }
+
+  ezLog::Debug("Built {0} of {1} navmesh tiles", iNumBuiltTiles, tiles.GetCount());
+
+  inout_NavMeshDesc.Clear();
+  inout_NavMeshDesc.m_fTileSize = fTileSize;
+  inout_NavMeshDesc.m_Tiles = std::move(tiles);
 
   return EZ_SUCCESS;
 }
@@ -140,7 +230,6 @@ void ezRecastNavMeshBuilder::ReserveMemory(const ezWorldGeoExtractionUtil::Geome
   const ezUInt32 uiVertices = uiBoxVertices + desc.m_Vertices.GetCount();
 
   m_Triangles.Reserve(uiTriangles);
-  m_TriangleAreaIDs.Reserve(uiTriangles);
   m_Vertices.Reserve(uiVertices);
 }
 
@@ -149,7 +238,6 @@ void ezRecastNavMeshBuilder::GenerateTriangleMeshFromDescription(const ezWorldGe
   EZ_LOG_BLOCK("ezRecastNavMeshBuilder::GenerateTriangleMesh");
 
   m_Triangles.Clear();
-  m_TriangleAreaIDs.Clear();
   m_Vertices.Clear();
 
   ReserveMemory(desc);
@@ -220,30 +308,82 @@ void ezRecastNavMeshBuilder::GenerateTriangleMeshFromDescription(const ezWorldGe
     }
   }
 
-  // initialize the IDs to zero
-  m_TriangleAreaIDs.SetCount(m_Triangles.GetCount());
-
   ezLog::Debug("Vertices: {0}, Triangles: {1}", m_Vertices.GetCount(), m_Triangles.GetCount());
 }
 
 
-void ezRecastNavMeshBuilder::ComputeBoundingBox()
+void ezRecastNavMeshBuilder::SortTrianglesIntoTiles(const rcConfig& cfg)
+{
+  EZ_LOG_BLOCK("ezRecastNavMeshBuilder::SortTrianglesIntoTiles");
+
+  // Every tile gets all triangles that overlap it including its border, so that tiles can be built independently of each other.
+  // The grid starts at the origin, so tiles stay in place when geometry elsewhere in the world changes.
+  const float fTileSize = cfg.tileSize * cfg.cs;
+  const float fBorderSize = cfg.borderSize * cfg.cs;
+
+  ezHashTable<ezUInt64, ezUInt32> tileIndices;
+
+  for (ezUInt32 uiTriangle = 0; uiTriangle < m_Triangles.GetCount(); ++uiTriangle)
+  {
+    const Triangle& tri = m_Triangles[uiTriangle];
+    const ezVec3& v0 = m_Vertices[tri.m_VertexIdx[0]];
+    const ezVec3& v1 = m_Vertices[tri.m_VertexIdx[1]];
+    const ezVec3& v2 = m_Vertices[tri.m_VertexIdx[2]];
+
+    if (!v0.IsValid() || !v1.IsValid() || !v2.IsValid())
+      continue;
+
+    // recast convention, the tiles are on the XZ plane
+    const float fMinX = ezMath::Min(v0.x, v1.x, v2.x) - fBorderSize;
+    const float fMaxX = ezMath::Max(v0.x, v1.x, v2.x) + fBorderSize;
+    const float fMinZ = ezMath::Min(v0.z, v1.z, v2.z) - fBorderSize;
+    const float fMaxZ = ezMath::Max(v0.z, v1.z, v2.z) + fBorderSize;
+
+    const ezInt32 iMinTileX = (ezInt32)ezMath::Floor(fMinX / fTileSize);
+    const ezInt32 iMaxTileX = (ezInt32)ezMath::Floor(fMaxX / fTileSize);
+    const ezInt32 iMinTileY = (ezInt32)ezMath::Floor(fMinZ / fTileSize);
+    const ezInt32 iMaxTileY = (ezInt32)ezMath::Floor(fMaxZ / fTileSize);
+
+    for (ezInt32 y = iMinTileY; y <= iMaxTileY; ++y)
+    {
+      for (ezInt32 x = iMinTileX; x <= iMaxTileX; ++x)
+      {
+        ezUInt32 uiTileIndex;
+        if (!tileIndices.TryGetValue(GetTileKey(x, y), uiTileIndex))
+        {
+          uiTileIndex = m_Tiles.GetCount();
+          tileIndices.Insert(GetTileKey(x, y), uiTileIndex);
+
+          TileInput& tile = m_Tiles.ExpandAndGetRef();
+          tile.m_iTileX = x;
+          tile.m_iTileY = y;
+        }
+
+        m_Tiles[uiTileIndex].m_Triangles.PushBack(tri);
+      }
+    }
+  }
+
+  ezLog::Debug("Tiles: {0}", m_Tiles.GetCount());
+}
+
+ezUInt64 ezRecastNavMeshBuilder::ComputeTileInputHash(const TileInput& tile, ezUInt64 uiConfigHash) const
 {
-  if (!m_Vertices.IsEmpty())
+  ezInt32 tileCoords[2] = {tile.m_iTileX, tile.m_iTileY};
+  ezUInt64 uiHash = ezHashingUtils::xxHash64(tileCoords, sizeof(tileCoords), uiConfigHash);
+
+  for (const Triangle& tri : tile.m_Triangles)
   {
-    m_BoundingBox.SetFromPoints(m_Vertices.GetData(), m_Vertices.GetCount());
+    ezVec3 positions[3] = {m_Vertices[tri.m_VertexIdx[0]], m_Vertices[tri.m_VertexIdx[1]], m_Vertices[tri.m_VertexIdx[2]]};
+    uiHash = ezHashingUtils::xxHash64(positions, sizeof(positions), uiHash);
   }
+
+  return uiHash;
 }
 
-void ezRecastNavMeshBuilder::FillOutConfig(rcConfig& cfg, const ezRecastConfig& config, const ezBoundingBox& bbox)
+void ezRecastNavMeshBuilder::FillOutConfig(rcConfig& cfg, const ezRecastConfig& config)
 {
   ezMemoryUtils::ZeroFill(&cfg, 1);
-  cfg.bmin[0] = bbox.m_vMin.x;
-  cfg.bmin[1] = bbox.m_vMin.y;
-  cfg.bmin[2] = bbox.m_vMin.z;
-  cfg.bmax[0] = bbox.m_vMax.x;
-  cfg.bmax[1] = bbox.m_vMax.y;
-  cfg.bmax[2] = bbox.m_vMax.z;
   cfg.ch = config.m_fCellHeight;
   cfg.cs = config.m_fCellSize;
   cfg.walkableSlopeAngle = config.m_WalkableSlope.GetDegree();
@@ -258,43 +398,78 @@ void ezRecastNavMeshBuilder::FillOutConfig(rcConfig& cfg, const ezRecastConfig&
   cfg.detailSampleDist = config.m_fDetailMeshSampleDistanceFactor < 0.9f ? 0 : cfg.cs * config.m_fDetailMeshSampleDistanceFactor;
   cfg.detailSampleMaxError = cfg.ch * config.m_fDetailMeshSampleDistanceFactor;
 
-  rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
+  // the border needs to be large enough that the tiles match up after eroding the walkable area
+  cfg.tileSize = ezMath::Max((int)(config.m_fTileSize / cfg.cs), 8);
+  cfg.borderSize = cfg.walkableRadius + 3;
+  cfg.width = cfg.tileSize + cfg.borderSize * 2;
+  cfg.height = cfg.tileSize + cfg.borderSize * 2;
 }
 
-ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& config, rcPolyMesh& out_PolyMesh, ezProgress& progress)
+ezResult ezRecastNavMeshBuilder::BuildTile(
+  const ezRecastConfig& config, const rcConfig& cfg, const TileInput& tile, ezRcBuildContext* pContext, ezRecastNavMeshTile& out_Tile) const
 {
-  ezProgressRange pgRange("Build Poly Mesh", 13, true, &progress);
+  rcConfig tileCfg = cfg;
 
-  rcConfig cfg;
-  FillOutConfig(cfg, config, m_BoundingBox);
+  const float fTileSize = cfg.tileSize * cfg.cs;
+  const float fBorderSize = cfg.borderSize * cfg.cs;
 
-  ezRcBuildContext* pContext = m_pRecastContext;
+  tileCfg.bmin[0] = tile.m_iTileX * fTileSize - fBorderSize;
+  tileCfg.bmin[2] = tile.m_iTileY * fTileSize - fBorderSize;
+  tileCfg.bmax[0] = (tile.m_iTileX + 1) * fTileSize + fBorderSize;
+  tileCfg.bmax[2] = (tile.m_iTileY + 1) * fTileSize + fBorderSize;
+
+  tileCfg.bmin[1] = ezMath::MaxValue<float>();
+  tileCfg.bmax[1] = -ezMath::MaxValue<float>();
+
+  for (const Triangle& tri : tile.m_Triangles)
+  {
+    for (ezUInt32 i = 0; i < 3; ++i)
+    {
+      tileCfg.bmin[1] = ezMath::Min(tileCfg.bmin[1], m_Vertices[tri.m_VertexIdx[i]].y);
+      tileCfg.bmax[1] = ezMath::Max(tileCfg.bmax[1], m_Vertices[tri.m_VertexIdx[i]].y);
+    }
+  }
+
+  ezUniquePtr<rcPolyMesh> pPolyMesh = EZ_DEFAULT_NEW(rcPolyMesh);
+
+  EZ_SUCCEED_OR_RETURN(BuildRecastPolyMesh(tileCfg, tile.m_Triangles, pContext, *pPolyMesh));
+
+  if (pPolyMesh->npolys == 0)
+  {
+    // no walkable area in this tile
+    return EZ_SUCCESS;
+  }
+
+  EZ_SUCCEED_OR_RETURN(BuildDetourNavMeshData(config, *pPolyMesh, tile.m_iTileX, tile.m_iTileY, out_Tile.m_DetourNavmeshData));
+
+  out_Tile.m_pNavMeshPolygons = pPolyMesh.Release();
+  return EZ_SUCCESS;
+}
+
+ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(
+  const rcConfig& cfg, const ezDynamicArray<Triangle>& triangles, ezRcBuildContext* pContext, rcPolyMesh& out_PolyMesh) const
+{
   const float* pVertices = &m_Vertices[0].x;
-  const ezInt32* pTriangles = &m_Triangles[0].m_VertexIdx[0];
+  const ezInt32* pTriangles = &triangles[0].m_VertexIdx[0];
+
+  // initialize the IDs to zero
+  ezDynamicArray<ezUInt8> triangleAreaIDs;
+  triangleAreaIDs.SetCount(triangles.GetCount());
 
   rcHeightfield* heightfield = rcAllocHeightfield();
   EZ_SCOPE_EXIT(rcFreeHeightField(heightfield));
 
-  if (!pgRange.BeginNextStep("Creating Heightfield"))
-    return EZ_FAILURE;
-
   if (!rcCreateHeightfield(pContext, *heightfield, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch))
   {
     pContext->log(RC_LOG_ERROR, "Could not create solid heightfield");
     return EZ_FAILURE;
   }
 
-  if (!pgRange.BeginNextStep("Mark Walkable Area"))
-    return EZ_FAILURE;
-
   // TODO Instead of this, it should use area IDs and then clear the non-walkable triangles
   rcMarkWalkableTriangles(
-    pContext, cfg.walkableSlopeAngle, pVertices, m_Vertices.GetCount(), pTriangles, m_Triangles.GetCount(), m_TriangleAreaIDs.GetData());
+    pContext, cfg.walkableSlopeAngle, pVertices, m_Vertices.GetCount(), pTriangles, triangles.GetCount(), triangleAreaIDs.GetData());
 
-  if (!pgRange.BeginNextStep("Rasterize Triangles"))
-    return EZ_FAILURE;
-
-  if (!rcRasterizeTriangles(pContext, pVertices, m_Vertices.GetCount(), pTriangles, m_TriangleAreaIDs.GetData(), m_Triangles.GetCount(),
+  if (!rcRasterizeTriangles(pContext, pVertices, m_Vertices.GetCount(), pTriangles, triangleAreaIDs.GetData(), triangles.GetCount(),
         *heightfield, cfg.walkableClimb))
   {
     pContext->log(RC_LOG_ERROR, "Could not rasterize triangles");
@@ -303,28 +478,16 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
 
   // Optional stuff
   {
-    if (!pgRange.BeginNextStep("Filter Low Hanging Obstacles"))
-      return EZ_FAILURE;
-
     // if (m_filterLowHangingObstacles)
     rcFilterLowHangingWalkableObstacles(pContext, cfg.walkableClimb, *heightfield);
 
-    if (!pgRange.BeginNextStep("Filter Ledge Spans"))
-      return EZ_FAILURE;
-
     // if (m_filterLedgeSpans)
     rcFilterLedgeSpans(pContext, cfg.walkableHeight, cfg.walkableClimb, *heightfield);
 
-    if (!pgRange.BeginNextStep("Filter Low Height Spans"))
-      return EZ_FAILURE;
-
     // if (m_filterWalkableLowHeightSpans)
     rcFilterWalkableLowHeightSpans(pContext, cfg.walkableHeight, *heightfield);
   }
 
-  if (!pgRange.BeginNextStep("Build Compact Heightfield"))
-    return EZ_FAILURE;
-
   rcCompactHeightfield* compactHeightfield = rcAllocCompactHeightfield();
   EZ_SCOPE_EXIT(rcFreeCompactHeightfield(compactHeightfield));
 
@@ -334,9 +497,6 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
     return EZ_FAILURE;
   }
 
-  if (!pgRange.BeginNextStep("Erode Walkable Area"))
-    return EZ_FAILURE;
-
   if (!rcErodeWalkableArea(pContext, cfg.walkableRadius, *compactHeightfield))
   {
     pContext->log(RC_LOG_ERROR, "Could not erode with character radius");
@@ -357,9 +517,6 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
   {
     // PARTITION_WATERSHED
     {
-      if (!pgRange.BeginNextStep("Build Distance Field"))
-        return EZ_FAILURE;
-
       // Prepare for region partitioning, by calculating distance field along the walkable surface.
       if (!rcBuildDistanceField(pContext, *compactHeightfield))
       {
@@ -367,11 +524,8 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
         return EZ_FAILURE;
       }
 
-      if (!pgRange.BeginNextStep("Build Regions"))
-        return EZ_FAILURE;
-
       // Partition the walkable surface into simple regions without holes.
-      if (!rcBuildRegions(pContext, *compactHeightfield, 0, cfg.minRegionArea, cfg.mergeRegionArea))
+      if (!rcBuildRegions(pContext, *compactHeightfield, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
       {
         pContext->log(RC_LOG_ERROR, "Could not build watershed regions.");
         return EZ_FAILURE;
@@ -382,7 +536,7 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
     //{
     //  // Partition the walkable surface into simple regions without holes.
     //  // Monotone partitioning does not need distance field.
-    //  if (!rcBuildRegionsMonotone(pContext, *compactHeightfield, 0, cfg.minRegionArea, cfg.mergeRegionArea))
+    //  if (!rcBuildRegionsMonotone(pContext, *compactHeightfield, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
     //  {
     //    pContext->log(RC_LOG_ERROR, "Could not build monotone regions.");
     //    return EZ_FAILURE;
@@ -392,7 +546,7 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
     //// PARTITION_LAYERS
     //{
     //  // Partition the walkable surface into simple regions without holes.
-    //  if (!rcBuildLayerRegions(pContext, *compactHeightfield, 0, cfg.minRegionArea))
+    //  if (!rcBuildLayerRegions(pContext, *compactHeightfield, cfg.borderSize, cfg.minRegionArea))
     //  {
     //    pContext->log(RC_LOG_ERROR, "Could not build layer regions.");
     //    return EZ_FAILURE;
@@ -400,9 +554,6 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
     //}
   }
 
-  if (!pgRange.BeginNextStep("Build Contours"))
-    return EZ_FAILURE;
-
   rcContourSet* contourSet = rcAllocContourSet();
   EZ_SCOPE_EXIT(rcFreeContourSet(contourSet));
 
@@ -412,8 +563,11 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
     return EZ_FAILURE;
   }
 
-  if (!pgRange.BeginNextStep("Build Poly Mesh"))
-    return EZ_FAILURE;
+  if (contourSet->nconts == 0)
+  {
+    // nothing walkable
+    return EZ_SUCCESS;
+  }
 
   if (!rcBuildPolyMesh(pContext, *contourSet, cfg.maxVertsPerPoly, out_PolyMesh))
   {
@@ -424,9 +578,6 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
   //////////////////////////////////////////////////////////////////////////
   // Detour Navmesh
 
-  if (!pgRange.BeginNextStep("Set Area Flags"))
-    return EZ_FAILURE;
-
   // TODO modify area IDs and flags
 
   for (int i = 0; i < out_PolyMesh.npolys; ++i)
@@ -440,7 +591,8 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
   return EZ_SUCCESS;
 }
 
-ezResult ezRecastNavMeshBuilder::BuildDetourNavMeshData(const ezRecastConfig& config, const rcPolyMesh& polyMesh, ezDataBuffer& NavmeshData)
+ezResult ezRecastNavMeshBuilder::BuildDetourNavMeshData(
+  const ezRecastConfig& config, const rcPolyMesh& polyMesh, ezInt32 iTileX, ezInt32 iTileY, ezDataBuffer& NavmeshData)
 {
   dtNavMeshCreateParams params;
   ezMemoryUtils::ZeroFill(&params, 1);
@@ -457,6 +609,9 @@ ezResult ezRecastNavMeshBuilder::BuildDetourNavMeshData(const ezRecastConfig& co
   params.walkableClimb = config.m_fAgentClimbHeight;
   rcVcopy(params.bmin, polyMesh.bmin);
   rcVcopy(params.bmax, polyMesh.bmax);
+  params.tileX = iTileX;
+  params.tileY = iTileY;
+  params.tileLayer = 0;
   params.cs = config.m_fCellSize;
   params.ch = config.m_fCellHeight;
   params.buildBvTree = true;
@@ -479,7 +634,7 @@ ezResult ezRecastNavMeshBuilder::BuildDetourNavMeshData(const ezRecastConfig& co
 
 ezResult ezRecastConfig::Serialize(ezStreamWriter& stream) const
 {
-  stream.WriteVersion(1);
+  stream.WriteVersion(2);
 
   stream << m_fAgentHeight;
   stream << m_fAgentRadius;
@@ -493,13 +648,14 @@ ezResult ezRecastConfig::Serialize(ezStreamWriter& stream) const
   stream << m_fRegionMergeSize;
   stream << m_fDetailMeshSampleDistanceFactor;
   stream << m_fDetailMeshSampleErrorFactor;
+  stream << m_fTileSize;
 
   return EZ_SUCCESS;
 }
 
 ezResult ezRecastConfig::Deserialize(ezStreamReader& stream)
 {
-  stream.ReadVersion(1);
+  const ezTypeVersion version = stream.ReadVersion(2);
 
   stream >> m_fAgentHeight;
   stream >> m_fAgentRadius;
@@ -514,5 +670,10 @@ ezResult ezRecastConfig::Deserialize(ezStreamReader& stream)
   stream >> m_fDetailMeshSampleDistanceFactor;
   stream >> m_fDetailMeshSampleErrorFactor;
 
+  if (version >= 2)
+  {
+    stream >> m_fTileSize;
+  }
+
   return EZ_SUCCESS;
 }
@@ -6,11 +6,13 @@
 #include <RecastPlugin/RecastPluginDLL.h>
 
 class ezRcBuildContext;
+struct rcConfig;
 struct rcPolyMesh;
 struct rcPolyMeshDetail;
 class ezWorld;
 class dtNavMesh;
 struct ezRecastNavMeshResourceDescriptor;
+struct ezRecastNavMeshTile;
 class ezProgress;
 class ezStreamWriter;
 class ezStreamReader;
@@ -29,6 +31,7 @@ struct EZ_RECASTPLUGIN_DLL ezRecastConfig
   float m_fRegionMergeSize = 20.0f;
   float m_fDetailMeshSampleDistanceFactor = 1.0f;
   float m_fDetailMeshSampleErrorFactor = 1.0f;
+  float m_fTileSize = 32.0f;
 
   ezResult Serialize(ezStreamWriter& stream) const;
   ezResult Deserialize(ezStreamReader& stream);
@@ -38,6 +41,11 @@ EZ_DECLARE_REFLECTABLE_TYPE(EZ_RECASTPLUGIN_DLL, ezRecastConfig);
 
 
 
+/// \brief Builds a tiled Recast / Detour navmesh from extracted world geometry
+///
+/// The geometry is sorted into square tiles of ezRecastConfig::m_fTileSize on a fixed grid, and every tile is built as an
+/// independent task. Each tile remembers a hash of its input, so when an existing navmesh is passed to Build(), only the tiles whose
+/// geometry or config changed are rebuilt.
 class EZ_RECASTPLUGIN_DLL ezRecastNavMeshBuilder
 {
 public:
@@ -46,21 +54,36 @@ public:
 
   static ezResult ExtractWorldGeometry(const ezWorld& world, ezWorldGeoExtractionUtil::Geometry& out_worldGeo);
 
+  /// \brief Builds the navmesh tiles for the given geometry.
+  ///
+  /// Tiles that are already in \a inout_NavMeshDesc and whose input did not change since they were built are kept as they are.
+  /// All other tiles are rebuilt, and tiles that do not contain any geometry anymore are removed.
+  /// Pass an empty descriptor to build everything from scratch.
   ezResult Build(const ezRecastConfig& config, const ezWorldGeoExtractionUtil::Geometry& worldGeo,
-    ezRecastNavMeshResourceDescriptor& out_NavMeshDesc, ezProgress& progress);
+    ezRecastNavMeshResourceDescriptor& inout_NavMeshDesc, ezProgress& progress);
 
 private:
-  static void FillOutConfig(struct rcConfig& cfg, const ezRecastConfig& config, const ezBoundingBox& bbox);
+  struct Triangle;
+  struct TileInput;
+
+  static void FillOutConfig(rcConfig& cfg, const ezRecastConfig& config);
 
   void Clear();
   void ReserveMemory(const ezWorldGeoExtractionUtil::Geometry& desc);
   void GenerateTriangleMeshFromDescription(const ezWorldGeoExtractionUtil::Geometry& desc);
-  void ComputeBoundingBox();
-  ezResult BuildRecastPolyMesh(const ezRecastConfig& config, rcPolyMesh& out_PolyMesh, ezProgress& progress);
-  static ezResult BuildDetourNavMeshData(const ezRecastConfig& config, const rcPolyMesh& polyMesh, ezDataBuffer& NavmeshData);
+  void SortTrianglesIntoTiles(const rcConfig& cfg);
+  ezUInt64 ComputeTileInputHash(const TileInput& tile, ezUInt64 uiConfigHash) const;
+  ezResult BuildTile(const ezRecastConfig& config, const rcConfig& cfg, const TileInput& tile, ezRcBuildContext* pContext,
+    ezRecastNavMeshTile& out_Tile) const;
+  ezResult BuildRecastPolyMesh(
+    const rcConfig& cfg, const ezDynamicArray<Triangle>& triangles, ezRcBuildContext* pContext, rcPolyMesh& out_PolyMesh) const;
+  static ezResult BuildDetourNavMeshData(
+    const ezRecastConfig& config, const rcPolyMesh& polyMesh, ezInt32 iTileX, ezInt32 iTileY, ezDataBuffer& NavmeshData);
 
   struct Triangle
   {
+    EZ_DECLARE_POD_TYPE();
+
     Triangle() {}
     Triangle(ezInt32 a, ezInt32 b, ezInt32 c)
     {
@@ -72,9 +95,14 @@ private:
     ezInt32 m_VertexIdx[3];
   };
 
-  ezBoundingBox m_BoundingBox;
+  struct TileInput
+  {
+    ezInt32 m_iTileX = 0;
+    ezInt32 m_iTileY = 0;
+    ezDynamicArray<Triangle> m_Triangles;
+  };
+
   ezDynamicArray<ezVec3> m_Vertices;
   ezDynamicArray<Triangle> m_Triangles;
-  ezDynamicArray<ezUInt8> m_TriangleAreaIDs;
-  ezRcBuildContext* m_pRecastContext = nullptr;
+  ezDynamicArray<TileInput> m_Tiles;
 };
@@ -16,26 +16,31 @@ EZ_RESOURCE_IMPLEMENT_COMMON_CODE(ezRecastNavMeshResource);
 
 //////////////////////////////////////////////////////////////////////////
 
-ezRecastNavMeshResourceDescriptor::ezRecastNavMeshResourceDescriptor() = default;
-ezRecastNavMeshResourceDescriptor::ezRecastNavMeshResourceDescriptor(ezRecastNavMeshResourceDescriptor&& rhs)
+ezRecastNavMeshTile::ezRecastNavMeshTile() = default;
+ezRecastNavMeshTile::ezRecastNavMeshTile(ezRecastNavMeshTile&& rhs)
 {
   *this = std::move(rhs);
 }
 
-ezRecastNavMeshResourceDescriptor::~ezRecastNavMeshResourceDescriptor()
+ezRecastNavMeshTile::~ezRecastNavMeshTile()
 {
   Clear();
 }
 
-void ezRecastNavMeshResourceDescriptor::operator=(ezRecastNavMeshResourceDescriptor&& rhs)
+void ezRecastNavMeshTile::operator=(ezRecastNavMeshTile&& rhs)
 {
+  Clear();
+
+  m_iTileX = rhs.m_iTileX;
+  m_iTileY = rhs.m_iTileY;
+  m_uiInputHash = rhs.m_uiInputHash;
   m_DetourNavmeshData = std::move(rhs.m_DetourNavmeshData);
 
   m_pNavMeshPolygons = rhs.m_pNavMeshPolygons;
   rhs.m_pNavMeshPolygons = nullptr;
 }
 
-void ezRecastNavMeshResourceDescriptor::Clear()
+void ezRecastNavMeshTile::Clear()
 {
   m_DetourNavmeshData.Clear();
   EZ_DEFAULT_DELETE(m_pNavMeshPolygons);
@@ -43,19 +48,41 @@ void ezRecastNavMeshResourceDescriptor::Clear()
 
 //////////////////////////////////////////////////////////////////////////
 
-ezResult ezRecastNavMeshResourceDescriptor::Serialize(ezStreamWriter& stream) const
+ezRecastNavMeshResourceDescriptor::ezRecastNavMeshResourceDescriptor() = default;
+ezRecastNavMeshResourceDescriptor::ezRecastNavMeshResourceDescriptor(ezRecastNavMeshResourceDescriptor&& rhs)
 {
-  stream.WriteVersion(1);
-  EZ_SUCCEED_OR_RETURN(stream.WriteArray(m_DetourNavmeshData));
+  *this = std::move(rhs);
+}
 
-  const bool hasPolygons = m_pNavMeshPolygons != nullptr;
+ezRecastNavMeshResourceDescriptor::~ezRecastNavMeshResourceDescriptor()
+{
+  Clear();
+}
+
+void ezRecastNavMeshResourceDescriptor::operator=(ezRecastNavMeshResourceDescriptor&& rhs)
+{
+  m_fTileSize = rhs.m_fTileSize;
+  m_Tiles = std::move(rhs.m_Tiles);
+}
+
+void ezRecastNavMeshResourceDescriptor::Clear()
+{
+  m_fTileSize = 0.0f;
+  m_Tiles.Clear();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+static ezResult WritePolyMesh(ezStreamWriter& stream, const rcPolyMesh* pMesh)
+{
+  const bool hasPolygons = pMesh != nullptr;
   stream << hasPolygons;
 
   if (hasPolygons)
   {
     EZ_CHECK_AT_COMPILETIME_MSG(sizeof(rcPolyMesh) == sizeof(void*) * 5 + sizeof(int) * 14, "rcPolyMesh data structure has changed");
 
-    const auto& mesh = *m_pNavMeshPolygons;
+    const auto& mesh = *pMesh;
 
     stream << (int)mesh.nverts;
     stream << (int)mesh.npolys;
@@ -84,13 +111,8 @@ ezResult ezRecastNavMeshResourceDescriptor::Serialize(ezStreamWriter& stream) co
   return EZ_SUCCESS;
 }
 
-ezResult ezRecastNavMeshResourceDescriptor::Deserialize(ezStreamReader& stream)
+static ezResult ReadPolyMesh(ezStreamReader& stream, rcPolyMesh*& out_pMesh)
 {
-  Clear();
-
-  const ezTypeVersion version = stream.ReadVersion(1);
-  EZ_SUCCEED_OR_RETURN(stream.ReadArray(m_DetourNavmeshData));
-
   bool hasPolygons = false;
   stream >> hasPolygons;
 
@@ -98,9 +120,9 @@ ezResult ezRecastNavMeshResourceDescriptor::Deserialize(ezStreamReader& stream)
   {
     EZ_CHECK_AT_COMPILETIME_MSG(sizeof(rcPolyMesh) == sizeof(void*) * 5 + sizeof(int) * 14, "rcPolyMesh data structure has changed");
 
-    m_pNavMeshPolygons = EZ_DEFAULT_NEW(rcPolyMesh);
+    out_pMesh = EZ_DEFAULT_NEW(rcPolyMesh);
 
-    auto& mesh = *m_pNavMeshPolygons;
+    auto& mesh = *out_pMesh;
 
     stream >> mesh.nverts;
     stream >> mesh.npolys;
@@ -122,6 +144,7 @@ ezResult ezRecastNavMeshResourceDescriptor::Deserialize(ezStreamReader& stream)
     mesh.verts = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.nverts * 3, RC_ALLOC_PERM);
     mesh.polys = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.maxpolys * mesh.nvp * 2, RC_ALLOC_PERM);
     mesh.regs = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.maxpolys, RC_ALLOC_PERM);
+    mesh.flags = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.maxpolys, RC_ALLOC_PERM);
     mesh.areas = (ezUInt8*)rcAlloc(sizeof(ezUInt8) * mesh.maxpolys, RC_ALLOC_PERM);
 
     stream.ReadBytes(mesh.verts, sizeof(ezUInt16) * mesh.nverts * 3);
@@ -134,6 +157,58 @@ ezResult ezRecastNavMeshResourceDescriptor::Deserialize(ezStreamReader& stream)
   return EZ_SUCCESS;
 }
 
+ezResult ezRecastNavMeshResourceDescriptor::Serialize(ezStreamWriter& stream) const
+{
+  stream.WriteVersion(2);
+
+  stream << m_fTileSize;
+  stream << m_Tiles.GetCount();
+
+  for (const auto& tile : m_Tiles)
+  {
+    stream << tile.m_iTileX;
+    stream << tile.m_iTileY;
+    stream << tile.m_uiInputHash;
+    EZ_SUCCEED_OR_RETURN(stream.WriteArray(tile.m_DetourNavmeshData));
+    EZ_SUCCEED_OR_RETURN(WritePolyMesh(stream, tile.m_pNavMeshPolygons));
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezRecastNavMeshResourceDescriptor::Deserialize(ezStreamReader& stream)
+{
+  Clear();
+
+  const ezTypeVersion version = stream.ReadVersion(2);
+
+  if (version == 1)
+  {
+    // a single navmesh that covers everything
+    auto& tile = m_Tiles.ExpandAndGetRef();
+    EZ_SUCCEED_OR_RETURN(stream.ReadArray(tile.m_DetourNavmeshData));
+    EZ_SUCCEED_OR_RETURN(ReadPolyMesh(stream, tile.m_pNavMeshPolygons));
+    return EZ_SUCCESS;
+  }
+
+  ezUInt32 uiNumTiles = 0;
+  stream >> m_fTileSize;
+  stream >> uiNumTiles;
+
+  m_Tiles.SetCount(uiNumTiles);
+
+  for (auto& tile : m_Tiles)
+  {
+    stream >> tile.m_iTileX;
+    stream >> tile.m_iTileY;
+    stream >> tile.m_uiInputHash;
+    EZ_SUCCEED_OR_RETURN(stream.ReadArray(tile.m_DetourNavmeshData));
+    EZ_SUCCEED_OR_RETURN(ReadPolyMesh(stream, tile.m_pNavMeshPolygons));
+  }
+
+  return EZ_SUCCESS;
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 ezRecastNavMeshResource::ezRecastNavMeshResource()
@@ -155,9 +230,9 @@ ezResourceLoadDesc ezRecastNavMeshResource::UnloadData(Unload WhatToUnload)
   res.m_uiQualityLevelsLoadable = 0;
   res.m_State = ezResourceState::Unloaded;
 
-  m_DetourNavmeshData.Clear();
   EZ_DEFAULT_DELETE(m_pNavMesh);
   EZ_DEFAULT_DELETE(m_pNavMeshPolygons);
+  m_DetourTileData.Clear();
 
   return res;
 }
@@ -194,7 +269,12 @@ ezResourceLoadDesc ezRecastNavMeshResource::UpdateContent(ezStreamReader* Stream
 void ezRecastNavMeshResource::UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage)
 {
   out_NewMemoryUsage.m_uiMemoryCPU = sizeof(ezRecastNavMeshResource);
-  out_NewMemoryUsage.m_uiMemoryCPU += m_DetourNavmeshData.GetHeapMemoryUsage();
+  out_NewMemoryUsage.m_uiMemoryCPU += m_DetourTileData.GetHeapMemoryUsage();
+  for (const auto& data : m_DetourTileData)
+  {
+    out_NewMemoryUsage.m_uiMemoryCPU += data.GetHeapMemoryUsage();
+  }
+
   out_NewMemoryUsage.m_uiMemoryCPU += m_pNavMesh != nullptr ? sizeof(dtNavMesh) : 0;
   out_NewMemoryUsage.m_uiMemoryCPU += m_pNavMeshPolygons != nullptr ? sizeof(rcPolyMesh) : 0;
   out_NewMemoryUsage.m_uiMemoryGPU = 0;
@@ -207,16 +287,96 @@ ezResourceLoadDesc ezRecastNavMeshResource::CreateResource(ezRecastNavMeshResour
   res.m_uiQualityLevelsLoadable = 0;
   res.m_State = ezResourceState::Loaded;
 
-  m_pNavMeshPolygons = descriptor.m_pNavMeshPolygons;
-  descriptor.m_pNavMeshPolygons = nullptr;
-
-  m_DetourNavmeshData = std::move(descriptor.m_DetourNavmeshData);
-
   m_pNavMesh = EZ_DEFAULT_NEW(dtNavMesh);
 
   // the dtNavMesh does not need to free the data, the resource owns it
   const int dtMeshFlags = 0;
-  m_pNavMesh->init(m_DetourNavmeshData.GetData(), m_DetourNavmeshData.GetCount(), dtMeshFlags);
+
+  if (descriptor.m_fTileSize <= 0.0f)
+  {
+    // navmesh that was built as a single tile
+    if (!descriptor.m_Tiles.IsEmpty())
+    {
+      m_DetourTileData.PushBack(std::move(descriptor.m_Tiles[0].m_DetourNavmeshData));
+      m_pNavMesh->init(m_DetourTileData[0].GetData(), m_DetourTileData[0].GetCount(), dtMeshFlags);
+    }
+  }
+  else
+  {
+    ezInt32 iMaxPolysPerTile = 1;
+
+    for (auto& tile : descriptor.m_Tiles)
+    {
+      if (tile.m_DetourNavmeshData.IsEmpty())
+        continue;
+
+      const dtMeshHeader* pHeader = reinterpret_cast<const dtMeshHeader*>(tile.m_DetourNavmeshData.GetData());
+      iMaxPolysPerTile = ezMath::Max(iMaxPolysPerTile, pHeader->polyCount);
+
+      m_DetourTileData.PushBack(std::move(tile.m_DetourNavmeshData));
+    }
+
+    dtNavMeshParams params;
+    params.orig[0] = 0.0f;
+    params.orig[1] = 0.0f;
+    params.orig[2] = 0.0f;
+    params.tileWidth = descriptor.m_fTileSize;
+    params.tileHeight = descriptor.m_fTileSize;
+    params.maxTiles = ezMath::Max(m_DetourTileData.GetCount(), 1u);
+    params.maxPolys = iMaxPolysPerTile;
+
+    if (dtStatusFailed(m_pNavMesh->init(&params)))
+    {
+      ezLog::Error("NavMesh has too many tiles ({0}) or polygons per tile ({1})", params.maxTiles, params.maxPolys);
+    }
+    else
+    {
+      for (auto& data : m_DetourTileData)
+      {
+        if (dtStatusFailed(m_pNavMesh->addTile(data.GetData(), data.GetCount(), dtMeshFlags, 0, nullptr)))
+        {
+          ezLog::Error("Failed to add navmesh tile");
+        }
+      }
+    }
+  }
+
+  // merge the polygons of all tiles into one mesh for visualization and points of interest
+  {
+    ezHybridArray<ezRecastNavMeshTile*, 64> tilesWithPolygons;
+    for (auto& tile : descriptor.m_Tiles)
+    {
+      if (tile.m_pNavMeshPolygons != nullptr && tile.m_pNavMeshPolygons->npolys > 0)
+      {
+        tilesWithPolygons.PushBack(&tile);
+      }
+    }
+
+    if (tilesWithPolygons.GetCount() == 1)
+    {
+      m_pNavMeshPolygons = tilesWithPolygons[0]->m_pNavMeshPolygons;
+      tilesWithPolygons[0]->m_pNavMeshPolygons = nullptr;
+    }
+    else if (tilesWithPolygons.GetCount() > 1)
+    {
+      ezHybridArray<rcPolyMesh*, 64> polyMeshes;
+      for (auto pTile : tilesWithPolygons)
+      {
+        polyMeshes.PushBack(pTile->m_pNavMeshPolygons);
+      }
+
+      rcContext context(false);
+      m_pNavMeshPolygons = EZ_DEFAULT_NEW(rcPolyMesh);
+
+      if (!rcMergePolyMeshes(&context, polyMeshes.GetData(), polyMeshes.GetCount(), *m_pNavMeshPolygons))
+      {
+        ezLog::Warning("NavMesh polygons could not be merged, the navmesh will not be visualized");
+        EZ_DEFAULT_DELETE(m_pNavMeshPolygons);
+      }
+    }
+  }
+
+  descriptor.Clear();
 
   return res;
 }
@@ -8,6 +8,31 @@ class dtNavMesh;
 
 typedef ezTypedResourceHandle<class ezRecastNavMeshResource> ezRecastNavMeshResourceHandle;
 
+/// \brief A single tile of a navmesh, as created by ezRecastNavMeshBuilder
+struct EZ_RECASTPLUGIN_DLL ezRecastNavMeshTile
+{
+  ezRecastNavMeshTile();
+  ezRecastNavMeshTile(const ezRecastNavMeshTile& rhs) = delete;
+  ezRecastNavMeshTile(ezRecastNavMeshTile&& rhs);
+  ~ezRecastNavMeshTile();
+  void operator=(ezRecastNavMeshTile&& rhs);
+  void operator=(const ezRecastNavMeshTile& rhs) = delete;
+
+  ezInt32 m_iTileX = 0;
+  ezInt32 m_iTileY = 0;
+
+  /// \brief Hash of the geometry and config that the tile was built from. Tiles whose input hash did not change are not rebuilt.
+  ezUInt64 m_uiInputHash = 0;
+
+  /// \brief Data that was created by dtCreateNavMeshData() and will be added to the dtNavMesh. Empty if the tile has no walkable area.
+  ezDataBuffer m_DetourNavmeshData;
+
+  /// \brief Optional, if available the navmesh can be visualized at runtime
+  rcPolyMesh* m_pNavMeshPolygons = nullptr;
+
+  void Clear();
+};
+
 struct EZ_RECASTPLUGIN_DLL ezRecastNavMeshResourceDescriptor
 {
   ezRecastNavMeshResourceDescriptor();
@@ -17,11 +42,10 @@ struct EZ_RECASTPLUGIN_DLL ezRecastNavMeshResourceDescriptor
   void operator=(ezRecastNavMeshResourceDescriptor&& rhs);
   void operator=(const ezRecastNavMeshResourceDescriptor& rhs) = delete;
 
-  /// \brief Data that was created by dtCreateNavMeshData() and will be used for dtNavMesh::init()
-  ezDataBuffer m_DetourNavmeshData;
+  /// \brief The size of each tile in world units, or zero if the navmesh consists of a single tile that covers everything.
+  float m_fTileSize = 0.0f;
 
-  /// \brief Optional, if available the navmesh can be visualized at runtime
-  rcPolyMesh* m_pNavMeshPolygons = nullptr;
+  ezDynamicArray<ezRecastNavMeshTile> m_Tiles;
 
   void Clear();
 
@@ -40,6 +64,9 @@ public:
   ~ezRecastNavMeshResource();
 
   const dtNavMesh* GetNavMesh() const { return m_pNavMesh; }
+
+  /// \brief The polygons of all tiles merged into one mesh. May be null, if the navmesh was built without polygons or is too large to be
+  /// merged.
   const rcPolyMesh* GetNavMeshPolygons() const { return m_pNavMeshPolygons; }
 
 private:
@@ -47,7 +74,7 @@ private:
   virtual ezResourceLoadDesc UpdateContent(ezStreamReader* Stream) override;
   virtual void UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage) override;
 
-  ezDataBuffer m_DetourNavmeshData;
+  ezDynamicArray<ezDataBuffer> m_DetourTileData;
   dtNavMesh* m_pNavMesh = nullptr;
   rcPolyMesh* m_pNavMeshPolygons = nullptr;
 };
@@ -60,7 +60,11 @@ void ezRecastWorldModule::UpdateNavMesh(const UpdateContext& ctxt)
     m_pDetourNavMesh = pNavMesh->GetNavMesh();
 
     m_pNavMeshPointsOfInterest = EZ_DEFAULT_NEW(ezNavMeshPointOfInterestGraph);
-    m_pNavMeshPointsOfInterest->ExtractInterestPointsFromMesh(*pNavMesh->GetNavMeshPolygons());
+
+    if (pNavMesh->GetNavMeshPolygons() != nullptr)
+    {
+      m_pNavMeshPointsOfInterest->ExtractInterestPointsFromMesh(*pNavMesh->GetNavMeshPolygons());
+    }
   }
 
   if (m_pNavMeshPointsOfInterest)
@@ -52,6 +52,8 @@ ezResult ezTexConv::ParseCommandLine()
     ezLog::Info("");
     PrintOptionValuesHelp("  -compression", m_AllowedCompressionModes);
     ezLog::Info("     Compression strength for output format.");
+    PrintOptionValuesHelp("  -compressionQuality", m_AllowedCompressionQualities);
+    ezLog::Info("     How much time to spend on finding the best block compression. Only used when the compressor supports it.");
     ezLog::Info("");
     PrintOptionValuesHelp("  -usage", m_AllowedUsages);
     ezLog::Info("     What type of data the image contains. Affects which final output format is used and how mipmaps are generated.");
@@ -331,6 +333,10 @@ ezResult ezTexConv::ParseCompressionMode()
   EZ_SUCCEED_OR_RETURN(ParseStringOption("-compression", m_AllowedCompressionModes, value));
 
   m_Processor.m_Descriptor.m_CompressionMode = static_cast<ezTexConvCompressionMode::Enum>(value);
+
+  EZ_SUCCEED_OR_RETURN(ParseStringOption("-compressionQuality", m_AllowedCompressionQualities, value));
+
+  m_Processor.m_Descriptor.m_CompressionQuality = static_cast<ezBlockCompressionQuality::Enum>(value);
   return EZ_SUCCESS;
 }
 
@@ -48,6 +48,13 @@ ezTexConv::ezTexConv()
     m_AllowedCompressionModes.PushBack({"None", ezTexConvCompressionMode::None});
   }
 
+  // compression qualities
+  {
+    m_AllowedCompressionQualities.PushBack({"Balanced", ezBlockCompressionQuality::Balanced});
+    m_AllowedCompressionQualities.PushBack({"Fast", ezBlockCompressionQuality::Fast});
+    m_AllowedCompressionQualities.PushBack({"High", ezBlockCompressionQuality::High});
+  }
+
   // wrap modes
   {
     m_AllowedWrapModes.PushBack({"Repeat", ezImageAddressMode::Repeat});
@@ -80,6 +80,7 @@ private:
   ezDynamicArray<KeyEnumValuePair> m_AllowedMimapModes;
   ezDynamicArray<KeyEnumValuePair> m_AllowedPlatforms;
   ezDynamicArray<KeyEnumValuePair> m_AllowedCompressionModes;
+  ezDynamicArray<KeyEnumValuePair> m_AllowedCompressionQualities;
   ezDynamicArray<KeyEnumValuePair> m_AllowedWrapModes;
   ezDynamicArray<KeyEnumValuePair> m_AllowedFilterModes;
   ezDynamicArray<KeyEnumValuePair> m_AllowedBumpMapFilters;
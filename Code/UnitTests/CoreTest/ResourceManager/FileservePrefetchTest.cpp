@@ -0,0 +1,300 @@
+#include <CoreTestPCH.h>
+
+#ifdef BUILDSYSTEM_FILESERVEPLUGIN_PRESENT
+
+#  include <FileservePlugin/Client/FileserveClient.h>
+#  include <FileservePlugin/Fileserver/Fileserver.h>
+#  include <Foundation/Communication/GlobalEvent.h>
+#  include <Foundation/IO/FileSystem/FileReader.h>
+#  include <Foundation/IO/FileSystem/FileSystem.h>
+#  include <Foundation/IO/OSFile.h>
+#  include <Foundation/Threading/AtomicInteger.h>
+#  include <Foundation/Threading/Thread.h>
+#  include <Foundation/Threading/ThreadUtils.h>
+#  include <Foundation/Time/Time.h>
+
+namespace FileservePrefetchTestDetail
+{
+  static constexpr ezUInt16 s_uiPort = 1142;
+  static constexpr ezUInt32 s_uiNumFiles = 64;
+  static constexpr ezUInt32 s_uiFileSize = 16 * 1024;
+
+  /// The client blocks while it waits for an answer, so the server needs to run on its own thread.
+  class ServerThread : public ezThread
+  {
+  public:
+    ServerThread()
+      : ezThread("Fileserve Test Server")
+    {
+    }
+
+    volatile bool m_bStop = false;
+
+  private:
+    virtual ezUInt32 Run() override
+    {
+      while (!m_bStop)
+      {
+        if (!ezFileserver::GetSingleton()->UpdateServer())
+        {
+          ezThreadUtils::Sleep(ezTime::Milliseconds(1));
+        }
+      }
+
+      return 0;
+    }
+  };
+
+  void GetFileName(ezUInt32 uiFile, ezStringBuilder& out_sName) { out_sName.Format("File{0}.txt", uiFile); }
+
+  void GetFileContent(ezUInt32 uiFile, ezUInt32 uiVersion, ezStringBuilder& out_sContent)
+  {
+    // compresses well, just like most text based asset data
+    out_sContent.Clear();
+    while (out_sContent.GetElementCount() < s_uiFileSize)
+    {
+      out_sContent.AppendFormat("File {0}, version {1}, line {2}\n", uiFile, uiVersion, out_sContent.GetElementCount());
+    }
+  }
+
+  ezResult WriteServerFile(const char* szServerDir, ezUInt32 uiFile, ezUInt32 uiVersion)
+  {
+    ezStringBuilder sPath = szServerDir, sName, sContent;
+    GetFileName(uiFile, sName);
+    GetFileContent(uiFile, uiVersion, sContent);
+    sPath.AppendPath(sName);
+
+    ezOSFile file;
+    EZ_SUCCEED_OR_RETURN(file.Open(sPath, ezFileOpenMode::Write));
+    return file.Write(sContent.GetData(), sContent.GetElementCount());
+  }
+
+  /// Fileserve only detects changes through the file timestamp, which may only have a resolution of seconds.
+  ezResult ChangeServerFile(const char* szServerDir, ezUInt32 uiFile, ezUInt32 uiVersion)
+  {
+    ezStringBuilder sPath = szServerDir, sName;
+    GetFileName(uiFile, sName);
+    sPath.AppendPath(sName);
+
+    ezFileStats statsBefore, statsAfter;
+    EZ_SUCCEED_OR_RETURN(ezOSFile::GetFileStats(sPath, statsBefore));
+
+    for (ezUInt32 i = 0; i < 50; ++i)
+    {
+      EZ_SUCCEED_OR_RETURN(WriteServerFile(szServerDir, uiFile, uiVersion));
+      EZ_SUCCEED_OR_RETURN(ezOSFile::GetFileStats(sPath, statsAfter));
+
+      if (!statsAfter.m_LastModificationTime.Compare(statsBefore.m_LastModificationTime, ezTimestamp::CompareMode::Identical))
+        return EZ_SUCCESS;
+
+      ezThreadUtils::Sleep(ezTime::Milliseconds(50));
+    }
+
+    return EZ_FAILURE;
+  }
+
+  bool ReadAndCheckFile(ezUInt32 uiFile, ezUInt32 uiVersion)
+  {
+    ezStringBuilder sPath = ":fsprefetch/", sName, sExpected;
+    GetFileName(uiFile, sName);
+    GetFileContent(uiFile, uiVersion, sExpected);
+    sPath.Append(sName.GetData());
+
+    ezFileReader file;
+    if (file.Open(sPath).Failed())
+      return false;
+
+    ezDynamicArray<ezUInt8> content;
+    content.SetCountUninitialized((ezUInt32)file.GetFileSize());
+    if (file.ReadBytes(content.GetData(), content.GetCount()) != content.GetCount())
+      return false;
+
+    return content.GetCount() == sExpected.GetElementCount() && ezMemoryUtils::IsEqual(content.GetData(), (const ezUInt8*)sExpected.GetData(), content.GetCount());
+  }
+
+  ezResult MountDataDir()
+  {
+    ezStringBuilder sAddress;
+    sAddress.Format("localhost:{0}", s_uiPort);
+
+    ezFileserveClient::GetSingleton()->AddServerAddressToTry(sAddress);
+    EZ_SUCCEED_OR_RETURN(ezFileserveClient::GetSingleton()->EnsureConnected(ezTime::Seconds(10)));
+
+    return ezFileSystem::AddDataDirectory(">fileserveprefetchtest/", "FileservePrefetchTest", "fsprefetch");
+  }
+} // namespace FileservePrefetchTestDetail
+
+EZ_CREATE_SIMPLE_TEST(ResourceManager, FileservePrefetch)
+{
+  using namespace FileservePrefetchTestDetail;
+
+  ezStringBuilder sServerDir = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sServerDir.AppendPath("FileservePrefetch");
+
+  ezOSFile::DeleteFolder(sServerDir);
+  if (EZ_TEST_BOOL(ezOSFile::CreateDirectoryStructure(sServerDir).Succeeded()).Failed())
+    return;
+
+  for (ezUInt32 i = 0; i < s_uiNumFiles; ++i)
+  {
+    EZ_TEST_BOOL(WriteServerFile(sServerDir, i, 0).Succeeded());
+  }
+
+  ezFileSystem::SetSpecialDirectory("fileserveprefetchtest", sServerDir);
+
+  // the server is only reached over loopback, but otherwise it is the same as with a remote device
+  ezFileserver server;
+  server.SetPort(s_uiPort);
+  server.StartServer();
+
+  ezAtomicInteger32 iNumRequests = 0;
+  ezAtomicInteger32 iNumAnswers = 0;
+  ezAtomicInteger32 iNumTransferred = 0;
+  ezAtomicInteger32 iNumSameHash = 0;
+  server.m_Events.AddEventHandler([&](const ezFileserverEvent& e) {
+    if (e.m_Type == ezFileserverEvent::Type::FileDownloadRequest)
+    {
+      iNumRequests.Increment();
+
+      if (e.m_FileState == ezFileserveFileState::Different)
+        iNumTransferred.Increment();
+      if (e.m_FileState == ezFileserveFileState::SameHash)
+        iNumSameHash.Increment();
+    }
+
+    if (e.m_Type == ezFileserverEvent::Type::FileDownloadFinished)
+      iNumAnswers.Increment();
+  });
+
+  ServerThread serverThread;
+  serverThread.Start();
+
+  // creating the server disabled the client
+  ezFileserveClient::EnableFileserveClient();
+
+  ezUInt32 uiFirstClientSeconds = 0;
+
+  {
+    ezFileserveClient client;
+
+    const ezResult mountResult = MountDataDir();
+    uiFirstClientSeconds = (ezUInt32)ezTime::Now().GetSeconds();
+
+    if (EZ_TEST_BOOL(mountResult.Succeeded()).Succeeded())
+    {
+      // start with an empty cache
+      ezStringBuilder sCacheDir = ezFileSystem::FindDataDirectoryWithRoot("fsprefetch")->GetRedirectedDataDirectoryPath();
+      EZ_TEST_BOOL(sCacheDir != sServerDir);
+      ezOSFile::DeleteFolder(sCacheDir);
+
+      const ezUInt32 uiHalf = s_uiNumFiles / 2;
+
+      EZ_TEST_BLOCK(ezTestBlock::Enabled, "One file at a time")
+      {
+        const ezTime tStart = ezTime::Now();
+
+        for (ezUInt32 i = 0; i < uiHalf; ++i)
+        {
+          EZ_TEST_BOOL(ReadAndCheckFile(i, 0));
+        }
+
+        ezLog::Info("[test]Downloaded {0} files one at a time: {1}ms", uiHalf, ezArgF((ezTime::Now() - tStart).GetMilliseconds(), 2));
+      }
+
+      EZ_TEST_BLOCK(ezTestBlock::Enabled, "Prefetch Through Resource Manager Hint")
+      {
+        const ezTime tStart = ezTime::Now();
+        const ezInt32 iRequestsBefore = iNumRequests;
+        const ezInt32 iAnswersBefore = iNumAnswers;
+
+        ezVariantArray resourceIDs;
+        ezStringBuilder sID, sName;
+        for (ezUInt32 i = uiHalf; i < s_uiNumFiles; ++i)
+        {
+          GetFileName(i, sName);
+          sID.Set(":fsprefetch/", sName);
+          resourceIDs.PushBack(ezString(sID));
+        }
+
+        // the client answers this event with a single request for all files, without blocking
+        EZ_BROADCAST_EVENT(ezResourceManager_ResourcesQueuedForLoading, resourceIDs);
+
+        for (ezUInt32 i = 0; i < 1000 && iNumAnswers - iAnswersBefore < (ezInt32)uiHalf; ++i)
+        {
+          ezThreadUtils::Sleep(ezTime::Milliseconds(10));
+        }
+
+        EZ_TEST_INT(iNumRequests - iRequestsBefore, uiHalf);
+
+        // all files are already on their way, reading them must not cause any further requests
+        for (ezUInt32 i = uiHalf; i < s_uiNumFiles; ++i)
+        {
+          EZ_TEST_BOOL(ReadAndCheckFile(i, 0));
+        }
+
+        EZ_TEST_INT(iNumRequests - iRequestsBefore, uiHalf);
+
+        ezLog::Info("[test]Downloaded {0} prefetched files: {1}ms", s_uiNumFiles - uiHalf, ezArgF((ezTime::Now() - tStart).GetMilliseconds(), 2));
+      }
+    }
+
+    ezFileSystem::RemoveDataDirectoryGroup("FileservePrefetchTest");
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Validate Cache")
+  {
+    // one file changed, one was written again without changes, everything else must be validated without a transfer
+    EZ_TEST_BOOL(ChangeServerFile(sServerDir, 0, 1).Succeeded());
+    EZ_TEST_BOOL(ChangeServerFile(sServerDir, 1, 0).Succeeded());
+
+    // the server tells clients apart by an ID that is derived from the time in seconds
+    while ((ezUInt32)ezTime::Now().GetSeconds() == uiFirstClientSeconds)
+    {
+      ezThreadUtils::Sleep(ezTime::Milliseconds(50));
+    }
+
+    // a new client only knows what is in the cache on disk
+    ezFileserveClient client;
+
+    if (EZ_TEST_BOOL(MountDataDir().Succeeded()).Succeeded())
+    {
+      iNumRequests.Set(0);
+      iNumAnswers.Set(0);
+      iNumTransferred.Set(0);
+      iNumSameHash.Set(0);
+
+      const ezTime tStart = ezTime::Now();
+
+      ezDynamicArray<ezString> files;
+      ezStringBuilder sName;
+      for (ezUInt32 i = 0; i < s_uiNumFiles; ++i)
+      {
+        GetFileName(i, sName);
+        files.PushBack(sName);
+      }
+
+      client.PrefetchFiles(files);
+
+      for (ezUInt32 i = 0; i < s_uiNumFiles; ++i)
+      {
+        EZ_TEST_BOOL(ReadAndCheckFile(i, i == 0 ? 1 : 0));
+      }
+
+      ezLog::Info("[test]Validated {0} cached files: {1}ms", s_uiNumFiles, ezArgF((ezTime::Now() - tStart).GetMilliseconds(), 2));
+
+      EZ_TEST_INT(iNumRequests, s_uiNumFiles);
+      EZ_TEST_INT(iNumTransferred, 1);
+      EZ_TEST_INT(iNumSameHash, 1);
+    }
+
+    ezFileSystem::RemoveDataDirectoryGroup("FileservePrefetchTest");
+  }
+
+  serverThread.m_bStop = true;
+  serverThread.Join();
+
+  server.StopServer();
+  ezOSFile::DeleteFolder(sServerDir);
+}
+
+#endif
@@ -1,6 +1,10 @@
 #include <CoreTestPCH.h>
 
 #include <Core/ResourceManager/ResourceManager.h>
+#include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/IO/OSFile.h>
+#include <Foundation/Time/Stopwatch.h>
 #include <Foundation/Types/ScopeExit.h>
 
 EZ_CREATE_SIMPLE_TEST_GROUP(ResourceManager);
@@ -129,6 +133,84 @@ namespace
   EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(TestResource, 1, ezRTTIDefaultAllocator<TestResource>)
   EZ_END_DYNAMIC_REFLECTED_TYPE;
 
+  typedef ezTypedResourceHandle<class TestFileResource> TestFileResourceHandle;
+
+  /// Loaded through the default file loader, to measure the whole pipeline from disk to a loaded resource.
+  class TestFileResource : public ezResource
+  {
+    EZ_ADD_DYNAMIC_REFLECTION(TestFileResource, ezResource);
+    EZ_RESOURCE_DECLARE_COMMON_CODE(TestFileResource);
+
+  public:
+    TestFileResource()
+      : ezResource(ezResource::DoUpdate::OnAnyThread, 1)
+    {
+    }
+
+    ezUInt32 GetChecksum() const { return m_uiChecksum; }
+
+  protected:
+    virtual ezResourceLoadDesc UnloadData(Unload WhatToUnload) override
+    {
+      ezResourceLoadDesc ld;
+      ld.m_State = ezResourceState::Unloaded;
+      ld.m_uiQualityLevelsDiscardable = 0;
+      ld.m_uiQualityLevelsLoadable = 0;
+
+      return ld;
+    }
+
+    virtual ezResourceLoadDesc UpdateContent(ezStreamReader* Stream) override
+    {
+      ezResourceLoadDesc ld;
+      ld.m_uiQualityLevelsDiscardable = 0;
+      ld.m_uiQualityLevelsLoadable = 0;
+
+      if (Stream == nullptr)
+      {
+        ld.m_State = ezResourceState::LoadedResourceMissing;
+        return ld;
+      }
+
+      // the file loader puts the absolute path in front of the file content
+      ezStringBuilder sAbsFilePath;
+      (*Stream) >> sAbsFilePath;
+
+      ezUInt32 uiNumElements = 0;
+      (*Stream) >> uiNumElements;
+
+      m_uiChecksum = 0;
+      for (ezUInt32 i = 0; i < uiNumElements; ++i)
+      {
+        ezUInt32 uiValue = 0;
+        (*Stream) >> uiValue;
+        m_uiChecksum += uiValue;
+      }
+
+      ld.m_State = ezResourceState::Loaded;
+      return ld;
+    }
+
+    virtual void UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage) override
+    {
+      out_NewMemoryUsage.m_uiMemoryCPU = sizeof(TestFileResource);
+      out_NewMemoryUsage.m_uiMemoryGPU = 0;
+    }
+
+  private:
+    ezUInt32 m_uiChecksum = 0;
+  };
+
+  EZ_RESOURCE_IMPLEMENT_COMMON_CODE(TestFileResource);
+  EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(TestFileResource, 1, ezRTTIDefaultAllocator<TestFileResource>)
+  EZ_END_DYNAMIC_REFLECTED_TYPE;
+
+  // loaded resources are finalized on the main thread, so the main thread has to help with the tasks while waiting for them
+  void WaitForLoadingToFinish()
+  {
+    ezTaskSystem::WaitForCondition([]() -> bool { return !ezResourceManager::IsAnyLoadingInProgress(); });
+  }
+
 } // namespace
 
 EZ_CREATE_SIMPLE_TEST(ResourceManager, Basics)
@@ -176,6 +258,8 @@ EZ_CREATE_SIMPLE_TEST(ResourceManager, Basics)
 
     hResources.Clear();
 
+    WaitForLoadingToFinish();
+
     ezUInt32 uiUnloaded = 0;
 
     for (ezUInt32 tries = 0; tries < 3; ++tries)
@@ -236,6 +320,8 @@ EZ_CREATE_SIMPLE_TEST(ResourceManager, NestedLoading)
 
     hResources.Clear();
 
+    WaitForLoadingToFinish();
+
     ezResourceManager::FreeAllUnusedResources();
     EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
   }
@@ -277,10 +363,7 @@ EZ_CREATE_SIMPLE_TEST(ResourceManager, NestedLoading)
 
     hResources.Clear();
 
-    while (ezResourceManager::IsAnyLoadingInProgress())
-    {
-      ezThreadUtils::Sleep(ezTime::Milliseconds(100));
-    }
+    WaitForLoadingToFinish();
 
     ezResourceManager::FreeAllUnusedResources();
     ezThreadUtils::Sleep(ezTime::Milliseconds(100));
@@ -289,3 +372,95 @@ EZ_CREATE_SIMPLE_TEST(ResourceManager, NestedLoading)
     EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(ResourceManager, Profile_LoadFromDisk)
+{
+  const ezUInt32 uiNumResources = 4000;
+  const ezUInt32 uiNumElements = 256;
+
+  ezStringBuilder sOutputDir = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sOutputDir.AppendPath("ResourceLoading");
+
+  if (EZ_TEST_RESULT(ezOSFile::CreateDirectoryStructure(sOutputDir)).Failed())
+    return;
+
+  // the data directory is removed first, so that no file is open anymore when the folder gets deleted
+  EZ_SCOPE_EXIT(ezOSFile::DeleteFolder(sOutputDir));
+
+  if (EZ_TEST_RESULT(ezFileSystem::AddDataDirectory(sOutputDir, "ResourceLoadingTest", "resload", ezFileSystem::AllowWrites)).Failed())
+    return;
+
+  EZ_SCOPE_EXIT(ezFileSystem::RemoveDataDirectoryGroup("ResourceLoadingTest"));
+
+  const ezUInt32 uiExpectedChecksum = uiNumElements * (uiNumElements - 1) / 2;
+
+  ezStringBuilder sResourceID;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Write Files")
+  {
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      sResourceID.Format(":resload/Resource-{}.bin", i);
+
+      ezFileWriter file;
+      if (EZ_TEST_RESULT(file.Open(sResourceID)).Failed())
+        return;
+
+      file << uiNumElements;
+
+      for (ezUInt32 e = 0; e < uiNumElements; ++e)
+      {
+        file << e;
+      }
+    }
+  }
+
+  const ezUInt32 uiDefaultBatchSize = ezResourceManager::GetDataLoadBatchSize();
+  EZ_SCOPE_EXIT(ezResourceManager::SetDataLoadBatchSize(uiDefaultBatchSize));
+
+  const ezUInt32 batchSizes[] = {1, uiDefaultBatchSize};
+
+  for (ezUInt32 uiBatchSize : batchSizes)
+  {
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "Load Files")
+    {
+      ezResourceManager::SetDataLoadBatchSize(uiBatchSize);
+
+      ezDynamicArray<TestFileResourceHandle> hResources;
+      hResources.Reserve(uiNumResources);
+
+      ezStopwatch sw;
+
+      for (ezUInt32 i = 0; i < uiNumResources; ++i)
+      {
+        sResourceID.Format(":resload/Resource-{}.bin", i);
+        hResources.PushBack(ezResourceManager::LoadResource<TestFileResource>(sResourceID));
+      }
+
+      for (ezUInt32 i = 0; i < uiNumResources; ++i)
+      {
+        ezResourceManager::PreloadResource(hResources[i]);
+      }
+
+      // wait from the back, so that the loading order is not influenced by resources being requested with the highest priority
+      for (ezUInt32 i = uiNumResources; i > 0; --i)
+      {
+        ezResourceLock<TestFileResource> pResource(hResources[i - 1], ezResourceAcquireMode::BlockTillLoaded_NeverFail);
+
+        EZ_TEST_BOOL(pResource.GetAcquireResult() == ezResourceAcquireResult::Final);
+        EZ_TEST_INT(pResource->GetChecksum(), uiExpectedChecksum);
+      }
+
+      const ezTime tDuration = sw.GetRunningTotal();
+
+      ezLog::Info("[test]Batch size {0}: loaded {1} resources in {2} ms ({3} resources/sec)", uiBatchSize, uiNumResources, ezArgF(tDuration.GetMilliseconds(), 1), ezArgF(uiNumResources / tDuration.GetSeconds(), 0));
+
+      hResources.Clear();
+
+      WaitForLoadingToFinish();
+
+      ezResourceManager::FreeAllUnusedResources();
+      EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestFileResource>()->GetCount(), 0);
+    }
+  }
+}
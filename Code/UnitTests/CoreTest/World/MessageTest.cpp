@@ -2,6 +2,7 @@
 
 #include <Core/World/World.h>
 #include <Foundation/Memory/FrameAllocator.h>
+#include <Foundation/Threading/Thread.h>
 #include <Foundation/Time/Clock.h>
 
 namespace
@@ -61,12 +62,17 @@ namespace
     virtual void SerializeComponent(ezWorldWriter& stream) const override {}
     virtual void DeserializeComponent(ezWorldReader& stream) override {}
 
-    void OnTestMessage(TestMessage1& msg) { m_iSomeData += msg.m_iValue; }
+    void OnTestMessage(TestMessage1& msg)
+    {
+      m_iSomeData += msg.m_iValue;
+      m_ReceivedValues.PushBack(msg.m_iValue);
+    }
 
     void OnTestMessage2(TestMessage2& msg) { m_iSomeData2 += 2 * msg.m_iValue; }
 
     ezInt32 m_iSomeData;
     ezInt32 m_iSomeData2;
+    ezHybridArray<ezInt32, 32> m_ReceivedValues;
   };
 
   // clang-format off
@@ -82,6 +88,38 @@ namespace
   EZ_END_COMPONENT_TYPE;
   // clang-format on
 
+  class PostMessageThread : public ezThread
+  {
+  public:
+    PostMessageThread(ezGameObjectHandle hReceiver, const ezWorld* pWorld, ezInt32 iFirstValue, ezUInt32 uiNumMessages)
+      : ezThread("PostMessageThread")
+      , m_hReceiver(hReceiver)
+      , m_pWorld(pWorld)
+      , m_iFirstValue(iFirstValue)
+      , m_uiNumMessages(uiNumMessages)
+    {
+    }
+
+  private:
+    virtual ezUInt32 Run() override
+    {
+      TestMessage1 msg;
+
+      for (ezUInt32 i = 0; i < m_uiNumMessages; ++i)
+      {
+        msg.m_iValue = m_iFirstValue + i;
+        m_pWorld->PostMessage(m_hReceiver, msg, ezObjectMsgQueueType::NextFrame);
+      }
+
+      return 0;
+    }
+
+    ezGameObjectHandle m_hReceiver;
+    const ezWorld* m_pWorld;
+    ezInt32 m_iFirstValue;
+    ezUInt32 m_uiNumMessages;
+  };
+
   void ResetComponents(ezGameObject& object)
   {
     TestComponentMsg* pComponent = nullptr;
@@ -89,6 +127,7 @@ namespace
     {
       pComponent->m_iSomeData = 1;
       pComponent->m_iSomeData2 = 2;
+      pComponent->m_ReceivedValues.Clear();
     }
 
     for (auto it = object.GetChildren(); it.IsValid(); ++it)
@@ -235,4 +274,104 @@ EZ_CREATE_SIMPLE_TEST(World, Messaging)
 
     ezFrameAllocator::Reset();
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Queuing with delay - Order")
+  {
+    ResetComponents(*pRoot);
+
+    world.GetClock().SetFixedTimeStep(ezTime::Seconds(0.5));
+    const ezTime startTime = world.GetClock().GetAccumulatedTime();
+
+    // post in an order that is unrelated to the due time, messages posted in later frames are due before earlier ones
+    for (ezUInt32 uiFrame = 0; uiFrame < 2; ++uiFrame)
+    {
+      for (ezUInt32 i = 0; i < 8; ++i)
+      {
+        const ezInt32 iValue = ((i * 5) % 8) * 2 + (1 - uiFrame);
+
+        TestMessage1 msg;
+        msg.m_iValue = iValue;
+        pRoot->PostMessage(msg, ezObjectMsgQueueType::NextFrame, startTime + ezTime::Seconds(iValue + 1) - world.GetClock().GetAccumulatedTime());
+      }
+
+      world.Update();
+    }
+
+    for (ezUInt32 i = 0; i < 40; ++i)
+    {
+      world.Update();
+    }
+
+    TestComponentMsg* pComponent2 = nullptr;
+    pRoot->TryGetComponentOfBaseType(pComponent2);
+
+    if (EZ_TEST_INT(pComponent2->m_ReceivedValues.GetCount(), 16).Succeeded())
+    {
+      for (ezUInt32 i = 0; i < 16; ++i)
+      {
+        EZ_TEST_INT(pComponent2->m_ReceivedValues[i], i);
+      }
+    }
+
+    ezFrameAllocator::Reset();
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Posting from multiple threads")
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    const ezUInt32 uiMessagesPerThread = 20000;
+#else
+    const ezUInt32 uiMessagesPerThread = 200000;
+#endif
+    const ezUInt32 uiNumThreads = 8;
+
+    ezDynamicArray<ezInt32> firstRunOrder;
+
+    for (ezUInt32 uiRun = 0; uiRun < 2; ++uiRun)
+    {
+      ResetComponents(*pRoot);
+
+      ezDynamicArray<ezUniquePtr<PostMessageThread>> threads;
+      for (ezUInt32 i = 0; i < uiNumThreads; ++i)
+      {
+        threads.PushBack(EZ_DEFAULT_NEW(PostMessageThread, pRoot->GetHandle(), &world, i * uiMessagesPerThread, uiMessagesPerThread));
+      }
+
+      const ezTime tStart = ezTime::Now();
+
+      for (auto& pThread : threads)
+      {
+        pThread->Start();
+      }
+
+      for (auto& pThread : threads)
+      {
+        pThread->Join();
+      }
+
+      const ezTime tPost = ezTime::Now() - tStart;
+
+      world.Update();
+
+      const ezUInt32 uiNumMessages = uiNumThreads * uiMessagesPerThread;
+      ezLog::Info("[test]Posting {0} messages from {1} threads: {2} M messages/sec", uiNumMessages, uiNumThreads, ezArgF(uiNumMessages / tPost.GetSeconds() / 1000000.0, 2));
+
+      TestComponentMsg* pComponent2 = nullptr;
+      pRoot->TryGetComponentOfBaseType(pComponent2);
+
+      EZ_TEST_INT(pComponent2->m_ReceivedValues.GetCount(), uiNumMessages);
+
+      // the processing order must not depend on which thread posted a message when
+      if (uiRun == 0)
+      {
+        firstRunOrder = pComponent2->m_ReceivedValues;
+      }
+      else
+      {
+        EZ_TEST_BOOL(firstRunOrder == pComponent2->m_ReceivedValues);
+      }
+
+      ezFrameAllocator::Reset();
+    }
+  }
 }
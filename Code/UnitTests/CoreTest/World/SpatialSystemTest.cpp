@@ -1,12 +1,17 @@
 #include <CoreTestPCH.h>
 
 #include <Core/Messages/UpdateLocalBoundsMessage.h>
+#include <Core/World/SpatialSystem_Bvh.h>
 #include <Core/World/World.h>
+#include <Foundation/Configuration/CVar.h>
 #include <Foundation/Containers/HashSet.h>
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Stopwatch.h>
 
 namespace
 {
@@ -23,14 +28,21 @@ namespace
 
     void OnUpdateLocalBounds(ezMsgUpdateLocalBounds& msg)
     {
-      auto& rng = GetWorld()->GetRandomNumberGenerator();
+      ezBoundingBox bounds;
+      if (m_fHalfExtents > 0.0f)
+      {
+        bounds.SetCenterAndHalfExtents(ezVec3::ZeroVector(), ezVec3(m_fHalfExtents));
+      }
+      else
+      {
+        auto& rng = GetWorld()->GetRandomNumberGenerator();
 
-      float x = (float)rng.DoubleMinMax(1.0, 100.0);
-      float y = (float)rng.DoubleMinMax(1.0, 100.0);
-      float z = (float)rng.DoubleMinMax(1.0, 100.0);
+        float x = (float)rng.DoubleMinMax(1.0, 100.0);
+        float y = (float)rng.DoubleMinMax(1.0, 100.0);
+        float z = (float)rng.DoubleMinMax(1.0, 100.0);
 
-      ezBoundingBox bounds;
-      bounds.SetCenterAndHalfExtents(ezVec3::ZeroVector(), ezVec3(x, y, z));
+        bounds.SetCenterAndHalfExtents(ezVec3::ZeroVector(), ezVec3(x, y, z));
+      }
 
       ezSpatialData::Category category = m_SpecialCategory;
       if (category == ezInvalidSpatialDataCategory)
@@ -42,6 +54,7 @@ namespace
     }
 
     ezSpatialData::Category m_SpecialCategory = ezInvalidSpatialDataCategory;
+    float m_fHalfExtents = 0.0f; ///< random extents are used if not set
   };
 
   // clang-format off
@@ -55,13 +68,36 @@ namespace
   }
   EZ_END_COMPONENT_TYPE;
   // clang-format on
+
+  void CheckObjectsInSphere(ezWorld& world, const ezBoundingSphere& testSphere, ezUInt32 uiCategoryBitmask, bool bDynamic)
+  {
+    ezDynamicArray<ezGameObject*> objectsInSphere;
+    ezHashSet<ezGameObject*> uniqueObjects;
+    world.GetSpatialSystem()->FindObjectsInSphere(testSphere, uiCategoryBitmask, objectsInSphere);
+
+    for (auto pObject : objectsInSphere)
+    {
+      ezBoundingSphere objSphere = pObject->GetGlobalBounds().GetSphere();
+
+      EZ_TEST_BOOL(testSphere.Overlaps(objSphere));
+      EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
+      EZ_TEST_BOOL(pObject->IsDynamic() == bDynamic);
+    }
+
+    // Check for missing objects
+    for (auto it = world.GetObjects(); it.IsValid(); ++it)
+    {
+      ezBoundingSphere objSphere = it->GetGlobalBounds().GetSphere();
+      if (testSphere.Overlaps(objSphere))
+      {
+        EZ_TEST_BOOL(it->IsDynamic() != bDynamic || uniqueObjects.Contains(it));
+      }
+    }
+  }
 } // namespace
 
-EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
+static void TestSpatialSystem(ezWorldDesc& worldDesc)
 {
-  ezWorldDesc worldDesc("Test");
-  worldDesc.m_uiRandomNumberGeneratorSeed = 5;
-
   ezWorld world(worldDesc);
   EZ_LOCK(world.GetWriteMarker());
 
@@ -207,6 +243,65 @@ EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
     }
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindVisibleObjects")
+  {
+    ezFrustum frustum;
+    frustum.SetFrustum(ezVec3(100.0f, 60.0f, 400.0f), ezVec3(1.0f, 0.5f, 0.0f).GetNormalized(), ezVec3(0.0f, 0.0f, 1.0f), ezAngle::Degree(90.0f),
+      ezAngle::Degree(60.0f), 0.1f, 8000.0f);
+
+    ezDynamicArray<const ezGameObject*> visibleObjects;
+    ezHashSet<const ezGameObject*> uniqueObjects;
+    world.GetSpatialSystem()->FindVisibleObjects(frustum, uiCategoryBitmask, visibleObjects);
+
+    EZ_TEST_BOOL(!visibleObjects.IsEmpty());
+
+    for (auto pObject : visibleObjects)
+    {
+      ezBoundingSphere objSphere = pObject->GetGlobalBounds().GetSphere();
+
+      EZ_TEST_BOOL(frustum.Overlaps(ezSimdConversion::ToBSphere(objSphere)));
+      EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
+      EZ_TEST_BOOL(pObject->IsStatic());
+    }
+
+    // Check for missing objects
+    for (auto it = world.GetObjects(); it.IsValid(); ++it)
+    {
+      ezBoundingSphere objSphere = it->GetGlobalBounds().GetSphere();
+      if (frustum.Overlaps(ezSimdConversion::ToBSphere(objSphere)))
+      {
+        EZ_TEST_BOOL(it->IsDynamic() || uniqueObjects.Contains(it));
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Move objects")
+  {
+    // small movements and teleports
+    for (ezUInt32 i = 500; i < objects.GetCount(); ++i)
+    {
+      ezGameObject* pObject = objects[i];
+      if (i % 2 == 0)
+      {
+        pObject->SetLocalPosition(pObject->GetLocalPosition() + ezVec3(1.0f, -2.0f, 0.5f));
+      }
+      else
+      {
+        float x = (float)rng.DoubleMinMax(-range, range);
+        float y = (float)rng.DoubleMinMax(-range, range);
+        float z = (float)rng.DoubleMinMax(-range, range);
+        pObject->SetLocalPosition(ezVec3(x, y, z));
+      }
+    }
+
+    world.Update();
+
+    const ezUInt32 uiDynamicCategoryBitmask = ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
+    CheckObjectsInSphere(world, ezBoundingSphere(ezVec3(100.0f, 60.0f, 400.0f), 3000.0f), uiDynamicCategoryBitmask, true);
+    CheckObjectsInSphere(world, ezBoundingSphere(ezVec3(-4000.0f, 2000.0f, 0.0f), 5000.0f), uiDynamicCategoryBitmask, true);
+    CheckObjectsInSphere(world, ezBoundingSphere(ezVec3(-4000.0f, 2000.0f, 0.0f), 5000.0f), uiCategoryBitmask, false);
+  }
+
   if (false)
   {
     ezStringBuilder outputPath = ezTestFramework::GetInstance()->GetAbsOutputPath();
@@ -248,3 +343,275 @@ EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
 
   world.Update();
 }
+
+/// Fills the world with enough objects that a large visibility query is split into tasks, and checks that the result is the same
+/// as with the parallel culling switched off through the given cvar.
+static void TestParallelVisibility(ezWorldDesc& worldDesc, const char* szParallelCullingCVar)
+{
+  ezCVarBool* pParallelCulling = static_cast<ezCVarBool*>(ezCVar::FindCVarByName(szParallelCullingCVar));
+  if (EZ_TEST_BOOL(pParallelCulling != nullptr).Failed())
+    return;
+
+  const bool bPrevParallelCulling = *pParallelCulling;
+
+  ezWorld world(worldDesc);
+  EZ_LOCK(world.GetWriteMarker());
+
+  ezRandom rng;
+  rng.Initialize(23);
+
+  for (ezUInt32 i = 0; i < 20000; ++i)
+  {
+    ezGameObjectDesc desc;
+    desc.m_bDynamic = (i % 4 == 0);
+    desc.m_LocalPosition = ezVec3(rng.FloatMinMax(-4000.0f, 4000.0f), rng.FloatMinMax(-4000.0f, 4000.0f), rng.FloatMinMax(-50.0f, 50.0f));
+
+    ezGameObject* pObject = nullptr;
+    world.CreateObject(desc, pObject);
+
+    TestBoundsComponent* pComponent = nullptr;
+    TestBoundsComponent::CreateComponent(pObject, pComponent);
+    pComponent->m_fHalfExtents = rng.FloatMinMax(0.5f, 20.0f);
+  }
+
+  world.Update();
+
+  const ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() | ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
+
+  for (ezUInt32 uiQuery = 0; uiQuery < 8; ++uiQuery)
+  {
+    const ezAngle direction = ezAngle::Degree(45.0f * uiQuery + 10.0f);
+
+    ezFrustum frustum;
+    frustum.SetFrustum(ezVec3(0.0f, 0.0f, 20.0f), ezVec3(ezMath::Cos(direction), ezMath::Sin(direction), 0.0f), ezVec3(0.0f, 0.0f, 1.0f),
+      ezAngle::Degree(90.0f), ezAngle::Degree(60.0f), 0.1f, 6000.0f);
+
+    ezDynamicArray<const ezGameObject*> parallelObjects;
+    ezSpatialSystem::QueryStats parallelStats;
+    *pParallelCulling = true;
+    world.GetSpatialSystem()->FindVisibleObjects(frustum, uiCategoryBitmask, parallelObjects, &parallelStats);
+
+    ezDynamicArray<const ezGameObject*> serialObjects;
+    ezSpatialSystem::QueryStats serialStats;
+    *pParallelCulling = false;
+    world.GetSpatialSystem()->FindVisibleObjects(frustum, uiCategoryBitmask, serialObjects, &serialStats);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    // only makes sense if the query actually took the parallel path
+    if (ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks) > 0)
+    {
+      EZ_TEST_BOOL(parallelStats.m_uiNumTasks > 1);
+    }
+    EZ_TEST_INT(serialStats.m_uiNumTasks, 0);
+    EZ_TEST_INT(parallelStats.m_uiNumObjectsTested, serialStats.m_uiNumObjectsTested);
+    EZ_TEST_INT(parallelStats.m_uiNumObjectsPassed, serialStats.m_uiNumObjectsPassed);
+#endif
+
+    // the parallel path merges its partial results in order, so even the order has to match
+    if (EZ_TEST_INT(parallelObjects.GetCount(), serialObjects.GetCount()).Succeeded())
+    {
+      for (ezUInt32 i = 0; i < parallelObjects.GetCount(); ++i)
+      {
+        if (EZ_TEST_BOOL(parallelObjects[i] == serialObjects[i]).Failed())
+          break;
+      }
+    }
+
+    // and both have to match the brute force result
+    ezHashSet<const ezGameObject*> uniqueObjects;
+    for (auto pObject : parallelObjects)
+    {
+      EZ_TEST_BOOL(frustum.Overlaps(ezSimdConversion::ToBSphere(pObject->GetGlobalBounds().GetSphere())));
+      EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
+    }
+
+    for (auto it = world.GetObjects(); it.IsValid(); ++it)
+    {
+      if (frustum.Overlaps(ezSimdConversion::ToBSphere(it->GetGlobalBounds().GetSphere())))
+      {
+        EZ_TEST_BOOL(uniqueObjects.Contains(it));
+      }
+    }
+  }
+
+  *pParallelCulling = bPrevParallelCulling;
+}
+
+EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
+{
+  ezWorldDesc worldDesc("Test");
+  worldDesc.m_uiRandomNumberGeneratorSeed = 5;
+
+  TestSpatialSystem(worldDesc);
+}
+
+EZ_CREATE_SIMPLE_TEST(World, SpatialSystem_ParallelCulling)
+{
+  ezWorldDesc worldDesc("Test");
+  worldDesc.m_uiRandomNumberGeneratorSeed = 5;
+
+  TestParallelVisibility(worldDesc, "g_ParallelVisibilityCulling");
+}
+
+EZ_CREATE_SIMPLE_TEST(World, SpatialSystem_Bvh)
+{
+  ezWorldDesc worldDesc("Test");
+  worldDesc.m_uiRandomNumberGeneratorSeed = 5;
+  worldDesc.m_pSpatialSystem = EZ_NEW(ezFoundation::GetAlignedAllocator(), ezSpatialSystem_Bvh);
+
+  TestSpatialSystem(worldDesc);
+}
+
+EZ_CREATE_SIMPLE_TEST(World, SpatialSystem_Bvh_ParallelCulling)
+{
+  ezWorldDesc worldDesc("Test");
+  worldDesc.m_uiRandomNumberGeneratorSeed = 5;
+  worldDesc.m_pSpatialSystem = EZ_NEW(ezFoundation::GetAlignedAllocator(), ezSpatialSystem_Bvh);
+
+  TestParallelVisibility(worldDesc, "g_ParallelBvhCulling");
+}
+
+EZ_CREATE_SIMPLE_TEST(World, Profile_SpatialSystem)
+{
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+  const ezUInt32 uiNumObjects = 20000;
+#else
+  const ezUInt32 uiNumObjects = 200000;
+#endif
+  const ezUInt32 uiNumQueries = 100;
+  const ezUInt32 uiNumFrames = 10;
+  const ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() | ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
+
+  for (const char* szSystem : {"RegularGrid", "Bvh"})
+  {
+    ezWorldDesc worldDesc(szSystem);
+    worldDesc.m_uiRandomNumberGeneratorSeed = 11;
+    if (ezStringUtils::IsEqual(szSystem, "Bvh"))
+    {
+      worldDesc.m_pSpatialSystem = EZ_NEW(ezFoundation::GetAlignedAllocator(), ezSpatialSystem_Bvh);
+    }
+
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    ezRandom rng;
+    rng.Initialize(42);
+
+    // Most objects are small and clustered in a few towns, a few are huge like terrain patches or buildings
+    ezDynamicArray<ezGameObject*> dynamicObjects;
+    for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+    {
+      ezGameObjectDesc desc;
+      desc.m_bDynamic = (i % 4 == 0);
+
+      float fHalfExtents;
+      if (i % 100 == 0)
+      {
+        desc.m_LocalPosition = ezVec3(rng.FloatMinMax(-4000.0f, 4000.0f), rng.FloatMinMax(-4000.0f, 4000.0f), rng.FloatMinMax(-50.0f, 50.0f));
+        fHalfExtents = rng.FloatMinMax(200.0f, 1000.0f);
+      }
+      else
+      {
+        const ezUInt32 uiCluster = rng.UIntInRange(16);
+        const ezVec3 vClusterCenter((uiCluster % 4) * 2000.0f - 3000.0f, (uiCluster / 4) * 2000.0f - 3000.0f, 0.0f);
+        desc.m_LocalPosition = vClusterCenter + ezVec3(rng.FloatMinMax(-300.0f, 300.0f), rng.FloatMinMax(-300.0f, 300.0f), rng.FloatMinMax(0.0f, 50.0f));
+        fHalfExtents = rng.FloatMinMax(0.5f, 4.0f);
+      }
+
+      ezGameObject* pObject = nullptr;
+      world.CreateObject(desc, pObject);
+
+      TestBoundsComponent* pComponent = nullptr;
+      TestBoundsComponent::CreateComponent(pObject, pComponent);
+      pComponent->m_fHalfExtents = fHalfExtents;
+
+      if (desc.m_bDynamic)
+      {
+        dynamicObjects.PushBack(pObject);
+      }
+    }
+
+    {
+      ezStopwatch sw;
+      world.Update();
+      ezTestFramework::Output(ezTestOutput::Duration, "%s: Inserting %u objects: %.2fms", szSystem, uiNumObjects, sw.GetRunningTotal().GetMilliseconds());
+    }
+
+    const ezSpatialSystem& spatialSystem = *world.GetSpatialSystem();
+    ezUInt32 uiNumFound = 0;
+
+    {
+      ezStopwatch sw;
+      for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+      {
+        const ezBoundingSphere sphere(ezVec3(rng.FloatMinMax(-3500.0f, 3500.0f), rng.FloatMinMax(-3500.0f, 3500.0f), 0.0f), 100.0f);
+        spatialSystem.FindObjectsInSphere(sphere, uiCategoryBitmask, [&](ezGameObject*) {
+          ++uiNumFound;
+          return ezVisitorExecution::Continue;
+        });
+      }
+      ezTestFramework::Output(ezTestOutput::Duration, "%s: %u sphere queries: %.2fms", szSystem, uiNumQueries, sw.GetRunningTotal().GetMilliseconds());
+    }
+
+    {
+      ezStopwatch sw;
+      for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+      {
+        ezBoundingBox box;
+        box.SetCenterAndHalfExtents(ezVec3(rng.FloatMinMax(-3500.0f, 3500.0f), rng.FloatMinMax(-3500.0f, 3500.0f), 0.0f), ezVec3(100.0f));
+        spatialSystem.FindObjectsInBox(box, uiCategoryBitmask, [&](ezGameObject*) {
+          ++uiNumFound;
+          return ezVisitorExecution::Continue;
+        });
+      }
+      ezTestFramework::Output(ezTestOutput::Duration, "%s: %u box queries: %.2fms", szSystem, uiNumQueries, sw.GetRunningTotal().GetMilliseconds());
+    }
+
+    {
+      ezDynamicArray<const ezGameObject*> visibleObjects;
+
+      ezStopwatch sw;
+      for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+      {
+        const ezAngle direction = ezAngle::Degree(360.0f * i / uiNumQueries);
+
+        ezFrustum frustum;
+        frustum.SetFrustum(ezVec3(0.0f, 0.0f, 20.0f), ezVec3(ezMath::Cos(direction), ezMath::Sin(direction), 0.0f), ezVec3(0.0f, 0.0f, 1.0f),
+          ezAngle::Degree(90.0f), ezAngle::Degree(60.0f), 0.1f, 3000.0f);
+
+        visibleObjects.Clear();
+        spatialSystem.FindVisibleObjects(frustum, uiCategoryBitmask, visibleObjects);
+        uiNumFound += visibleObjects.GetCount();
+      }
+      ezTestFramework::Output(ezTestOutput::Duration, "%s: %u visibility queries: %.2fms", szSystem, uiNumQueries, sw.GetRunningTotal().GetMilliseconds());
+    }
+
+    {
+      ezTime tTotal;
+      for (ezUInt32 uiFrame = 0; uiFrame < uiNumFrames; ++uiFrame)
+      {
+        // most objects move a little, every frame some of them are teleported
+        for (ezUInt32 i = 0; i < dynamicObjects.GetCount(); ++i)
+        {
+          ezGameObject* pObject = dynamicObjects[i];
+          if ((i + uiFrame) % 32 == 0)
+          {
+            pObject->SetLocalPosition(ezVec3(rng.FloatMinMax(-3000.0f, 3000.0f), rng.FloatMinMax(-3000.0f, 3000.0f), 0.0f));
+          }
+          else
+          {
+            pObject->SetLocalPosition(pObject->GetLocalPosition() + ezVec3(rng.FloatMinMax(-0.5f, 0.5f), rng.FloatMinMax(-0.5f, 0.5f), 0.0f));
+          }
+        }
+
+        ezStopwatch sw;
+        world.Update();
+        tTotal += sw.GetRunningTotal();
+      }
+      ezTestFramework::Output(ezTestOutput::Duration, "%s: Updating %u dynamic objects: %.2fms per frame", szSystem, dynamicObjects.GetCount(),
+        tTotal.GetMilliseconds() / uiNumFrames);
+    }
+
+    EZ_TEST_BOOL(uiNumFound > 0);
+  }
+}
@@ -56,6 +56,19 @@ namespace
   EZ_END_COMPONENT_TYPE;
   // clang-format on
 
+  struct ezMsgTestDelayed : public ezMessage
+  {
+    EZ_DECLARE_MESSAGE_TYPE(ezMsgTestDelayed, ezMessage);
+
+    ezUInt32 m_uiValue;
+  };
+
+  // clang-format off
+  EZ_IMPLEMENT_MESSAGE_TYPE(ezMsgTestDelayed);
+  EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezMsgTestDelayed, 1, ezRTTIDefaultAllocator<ezMsgTestDelayed>)
+  EZ_END_DYNAMIC_REFLECTED_TYPE;
+  // clang-format on
+
   void AddObjectsToWorld(ezWorld& world, bool bDynamic, ezUInt32 uiNumObjects, ezUInt32 uiTreeLevelNumNodeDiv, ezUInt32 uiTreeDepth, ezInt32 iAttachCompsDepth,
                        ezGameObjectHandle hParent = ezGameObjectHandle())
   {
@@ -288,3 +301,56 @@ EZ_CREATE_SIMPLE_TEST(World, Profile_Update)
     }
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(World, Profile_DelayedMessages)
+{
+  EZ_TEST_BLOCK(EnableInRelease, "Process 100,000 pending delayed messages")
+  {
+    ezWorldDesc worldDesc("Test");
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    ezGameObjectDesc gd;
+    ezGameObjectHandle hObjects[100];
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(hObjects); ++i)
+    {
+      hObjects[i] = world.CreateObject(gd);
+    }
+
+    world.GetClock().SetFixedTimeStep(ezTime::Seconds(1.0 / 60.0));
+    world.Update();
+
+    ezRandom rng;
+    rng.Initialize(42);
+
+    ezMsgTestDelayed msg;
+
+    // gameplay timers that are mostly seconds away
+    const ezUInt32 uiNumMessages = 100000;
+    for (ezUInt32 i = 0; i < uiNumMessages; ++i)
+    {
+      msg.m_uiValue = i;
+      world.PostMessage(hObjects[i % EZ_ARRAY_SIZE(hObjects)], msg, ezObjectMsgQueueType::NextFrame, ezTime::Seconds(rng.DoubleMinMax(0.1, 30.0)));
+    }
+
+    ezStopwatch sw;
+
+    const ezUInt32 uiNumFrames = 300;
+    for (ezUInt32 i = 0; i < uiNumFrames; ++i)
+    {
+      // keep a steady stream of new timers coming in
+      for (ezUInt32 j = 0; j < 100; ++j)
+      {
+        msg.m_uiValue = j;
+        world.PostMessage(hObjects[j], msg, ezObjectMsgQueueType::NextFrame, ezTime::Seconds(rng.DoubleMinMax(0.1, 30.0)));
+      }
+
+      world.Update();
+    }
+
+    const ezTime tDiff = sw.Checkpoint();
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Updating %u frames with %u pending delayed messages: %.2fms (%.3fms per frame)", uiNumFrames,
+      uiNumMessages, tDiff.GetMilliseconds(), tDiff.GetMilliseconds() / uiNumFrames);
+  }
+}
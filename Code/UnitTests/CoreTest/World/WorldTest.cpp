@@ -3,6 +3,7 @@
 #include <Core/World/World.h>
 #include <Foundation/Time/Clock.h>
 #include <Foundation/Utilities/GraphicsUtils.h>
+#include <Foundation/Utilities/Stats.h>
 
 EZ_CREATE_SIMPLE_TEST_GROUP(World);
 
@@ -167,6 +168,56 @@ EZ_CREATE_SIMPLE_TEST(World, World)
     TestTransforms(o, offset);
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Transforms dynamic incremental")
+  {
+    ezWorldDesc worldDesc("IncrementalTransforms");
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    TestWorldObjects o = CreateTestWorld(world, true);
+
+    auto GetNumTransformsUpdated = []() -> ezUInt32 {
+      return ezStats::GetStat("World Update/IncrementalTransforms/Transforms Updated").ConvertTo<ezUInt32>();
+    };
+
+    // newly created objects are always updated
+    world.Update();
+    EZ_TEST_INT(GetNumTransformsUpdated(), 4);
+    TestTransforms(o);
+
+    // nothing changed
+    world.Update();
+    EZ_TEST_INT(GetNumTransformsUpdated(), 0);
+    TestTransforms(o);
+
+    // only the moved parent and its child are updated
+    ezVec3 offset = ezVec3(200.0f, 0.0f, 0.0f);
+    o.pParent1->SetLocalPosition(offset);
+
+    world.Update();
+    EZ_TEST_INT(GetNumTransformsUpdated(), 2);
+    EZ_TEST_VEC3(o.pParent2->GetGlobalPosition(), ezVec3(100.0f, 0.0f, 0.0f), 0);
+    EZ_TEST_VEC3(o.pParent1->GetGlobalPosition(), offset, 0);
+    EZ_TEST_VEC3(o.pChild11->GetGlobalPosition(), offset + ezVec3(0.0f, 150.0f, 0.0f), ezMath::DefaultEpsilon<float>() * 2.0f);
+
+    // a child can be moved without its parent
+    o.pChild21->SetLocalPosition(ezVec3(0.0f, 0.0f, 0.0f));
+
+    world.Update();
+    EZ_TEST_INT(GetNumTransformsUpdated(), 1);
+    EZ_TEST_VEC3(o.pChild21->GetGlobalPosition(), ezVec3(100.0f, 0.0f, 0.0f), 0);
+
+#if EZ_ENABLED(EZ_GAMEOBJECT_VELOCITY)
+    // the velocity of an object that stops moving goes back to zero
+    o.pParent2->SetLocalPosition(offset);
+
+    world.Update();
+    world.Update();
+    EZ_TEST_VEC3(o.pParent2->GetVelocity(), ezVec3::ZeroVector(), 0);
+    EZ_TEST_VEC3(o.pChild21->GetVelocity(), ezVec3::ZeroVector(), 0);
+#endif
+  }
+
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "Transforms static")
   {
     ezWorldDesc worldDesc("Test");
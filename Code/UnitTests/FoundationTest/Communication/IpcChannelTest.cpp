@@ -0,0 +1,185 @@
+#include <FoundationTestPCH.h>
+
+#include <Foundation/Communication/IpcChannel.h>
+#include <Foundation/Communication/RemoteMessage.h>
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Threading/ThreadUtils.h>
+#include <Foundation/Time/Time.h>
+#include <Foundation/Utilities/CommandLineUtils.h>
+
+#if EZ_ENABLED(EZ_PLATFORM_LINUX)
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+class ezIpcTestMessage : public ezProcessMessage
+{
+  EZ_ADD_DYNAMIC_REFLECTION(ezIpcTestMessage, ezProcessMessage);
+
+public:
+  ezUInt32 m_uiIndex = 0;
+  ezString m_sPayload;
+};
+
+// clang-format off
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezIpcTestMessage, 1, ezRTTIDefaultAllocator<ezIpcTestMessage>)
+{
+  EZ_BEGIN_PROPERTIES
+  {
+    EZ_MEMBER_PROPERTY("Index", m_uiIndex),
+    EZ_MEMBER_PROPERTY("Payload", m_sPayload),
+  }
+  EZ_END_PROPERTIES;
+}
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+// clang-format on
+
+namespace IpcChannelTestDetail
+{
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+  static constexpr ezUInt32 s_uiNumRoundTrips = 1000;
+  static constexpr ezUInt32 s_uiNumBulkMessages = 128;
+#else
+  static constexpr ezUInt32 s_uiNumRoundTrips = 10000;
+  static constexpr ezUInt32 s_uiNumBulkMessages = 1024;
+#endif
+  static constexpr ezUInt32 s_uiBulkPayloadSize = 64 * 1024;
+
+  /// Launches a second FoundationTest process, which connects to the channel and echoes all messages.
+  pid_t LaunchEchoProcess(const char* szAddress, bool bSharedMemory)
+  {
+    const ezStringBuilder sPathToSelf = ezCommandLineUtils::GetGlobalInstance()->GetParameter(0);
+
+    // everything is prepared up front, the child may only call async-signal-safe functions before exec
+    const char* args[] = {sPathToSelf.GetData(), "-ipcecho", "-ipc", szAddress, bSharedMemory ? "-sharedmemory" : nullptr, nullptr};
+
+    const pid_t pid = fork();
+    if (pid == 0)
+    {
+      execv("/proc/self/exe", const_cast<char* const*>(args));
+      _exit(127);
+    }
+
+    return pid;
+  }
+
+  void RunChannelTest(bool bSharedMemory)
+  {
+    const char* szName = bSharedMemory ? "Shared Memory" : "Pipe";
+
+    ezStringBuilder sAddress;
+    sAddress.Format("ezIpcChannelTest_{0}_{1}", (ezUInt32)getpid(), bSharedMemory ? "shm" : "pipe");
+
+    ezIpcChannel* pChannel = bSharedMemory ? ezIpcChannel::CreateSharedMemoryChannel(sAddress, ezIpcChannel::Mode::Server)
+                                           : ezIpcChannel::CreatePipeChannel(sAddress, ezIpcChannel::Mode::Server);
+    if (EZ_TEST_BOOL(pChannel != nullptr).Failed())
+      return;
+
+    ezUInt32 uiNumReceived = 0;
+    ezUInt32 uiNumInvalid = 0;
+    ezUInt32 uiExpectedPayloadSize = 0;
+
+    pChannel->m_MessageEvent.AddEventHandler([&](const ezProcessMessage* pMsg) {
+      const ezIpcTestMessage* pTestMsg = ezDynamicCast<const ezIpcTestMessage*>(pMsg);
+      if (pTestMsg == nullptr || pTestMsg->m_uiIndex != uiNumReceived || pTestMsg->m_sPayload.GetElementCount() != uiExpectedPayloadSize)
+      {
+        ++uiNumInvalid;
+      }
+      ++uiNumReceived;
+    });
+
+    pChannel->Connect();
+    const pid_t child = LaunchEchoProcess(sAddress, bSharedMemory);
+    EZ_TEST_BOOL(child > 0);
+
+    for (ezUInt32 i = 0; i < 1000 && !pChannel->IsConnected(); ++i)
+    {
+      ezThreadUtils::Sleep(ezTime::Milliseconds(10));
+    }
+
+    if (EZ_TEST_BOOL(pChannel->IsConnected()).Succeeded())
+    {
+      ezIpcTestMessage msg;
+
+      // latency: send one small message and wait for its echo before sending the next one
+      {
+        const ezTime tStart = ezTime::Now();
+
+        for (ezUInt32 i = 0; i < s_uiNumRoundTrips && pChannel->IsConnected(); ++i)
+        {
+          msg.m_uiIndex = i;
+          pChannel->Send(&msg);
+
+          while (uiNumReceived <= i && pChannel->IsConnected())
+          {
+            pChannel->WaitForMessages();
+          }
+        }
+
+        const ezTime tDuration = ezTime::Now() - tStart;
+
+        EZ_TEST_INT(uiNumReceived, s_uiNumRoundTrips);
+        ezLog::Info("[test]{0} channel round trip: {1}us", szName, ezArgF(tDuration.GetMicroseconds() / s_uiNumRoundTrips, 2));
+      }
+
+      // throughput: stream large messages without waiting and wait for all of them to come back
+      {
+        uiNumReceived = 0;
+        uiExpectedPayloadSize = s_uiBulkPayloadSize;
+
+        ezStringBuilder sPayload;
+        for (ezUInt32 i = 0; i < s_uiBulkPayloadSize / 64; ++i)
+        {
+          sPayload.Append("0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef");
+        }
+        msg.m_sPayload = sPayload;
+
+        const ezTime tStart = ezTime::Now();
+
+        for (ezUInt32 i = 0; i < s_uiNumBulkMessages; ++i)
+        {
+          msg.m_uiIndex = i;
+          pChannel->Send(&msg);
+        }
+
+        while (uiNumReceived < s_uiNumBulkMessages && pChannel->IsConnected())
+        {
+          pChannel->WaitForMessages();
+        }
+
+        const ezTime tDuration = ezTime::Now() - tStart;
+
+        EZ_TEST_INT(uiNumReceived, s_uiNumBulkMessages);
+        const double fMegaBytes = (double)s_uiNumBulkMessages * s_uiBulkPayloadSize / (1024.0 * 1024.0);
+        ezLog::Info("[test]{0} channel throughput: {1}MB/s", szName, ezArgF(fMegaBytes / tDuration.GetSeconds(), 1));
+      }
+
+      EZ_TEST_INT(uiNumInvalid, 0);
+    }
+
+    // closing the channel ends the echo process
+    EZ_DEFAULT_DELETE(pChannel);
+
+    if (child > 0)
+    {
+      int iStatus = -1;
+      EZ_TEST_INT(waitpid(child, &iStatus, 0), child);
+      EZ_TEST_BOOL(WIFEXITED(iStatus) && WEXITSTATUS(iStatus) == 0);
+    }
+  }
+} // namespace IpcChannelTestDetail
+
+EZ_CREATE_SIMPLE_TEST(Communication, IpcChannel)
+{
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Pipe Channel")
+  {
+    IpcChannelTestDetail::RunChannelTest(false);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Shared Memory Channel")
+  {
+    IpcChannelTestDetail::RunChannelTest(true);
+  }
+}
+
+#endif
@@ -2,10 +2,13 @@
 #include <FoundationTestPCH.h>
 
 #include <Foundation/DataProcessing/Stream/DefaultImplementations/ZeroInitializer.h>
+#include <Foundation/DataProcessing/Stream/ProcessingStreamChunkIterator.h>
 #include <Foundation/DataProcessing/Stream/ProcessingStreamGroup.h>
 #include <Foundation/DataProcessing/Stream/ProcessingStreamIterator.h>
 #include <Foundation/DataProcessing/Stream/ProcessingStreamProcessor.h>
 #include <Foundation/Reflection/Reflection.h>
+#include <Foundation/SimdMath/SimdMat4f.h>
+#include <Foundation/Time/Time.h>
 
 EZ_CREATE_SIMPLE_TEST_GROUP(DataProcessing);
 
@@ -157,3 +160,286 @@ EZ_CREATE_SIMPLE_TEST(DataProcessing, ProcessingStream)
     }
   }
 }
+
+namespace ProcessingStreamTestDetail
+{
+  ezProcessingStream* AddZeroInitializedStream(ezProcessingStreamGroup& group, const char* szName, ezProcessingStream::DataType type, ezProcessingStream::DataLayout layout)
+  {
+    ezProcessingStream* pStream = group.AddStream(szName, type, layout);
+
+    ezProcessingStreamSpawnerZeroInitialized* pSpawner = EZ_DEFAULT_NEW(ezProcessingStreamSpawnerZeroInitialized);
+    pSpawner->SetStreamName(pStream->GetName());
+    group.AddProcessor(pSpawner);
+
+    return pStream;
+  }
+
+  /// \brief Sets up the same streams as a particle system, only the layout of the velocity differs.
+  struct ParticleStreams
+  {
+    ParticleStreams(ezUInt64 uiNumParticles, ezProcessingStream::DataLayout velocityLayout)
+    {
+      m_pPosition = AddZeroInitializedStream(m_Group, "Position", ezProcessingStream::DataType::Float4, ezProcessingStream::DataLayout::AoS);
+      m_pVelocity = AddZeroInitializedStream(m_Group, "Velocity", ezProcessingStream::DataType::Float3, velocityLayout);
+
+      m_Group.SetSize(uiNumParticles);
+      m_Group.InitializeElements(uiNumParticles);
+      m_Group.Process();
+    }
+
+    ezProcessingStreamGroup m_Group;
+    ezProcessingStream* m_pPosition;
+    ezProcessingStream* m_pVelocity;
+  };
+
+  static const ezVec3 s_vGravity(0.0f, 0.0f, -10.0f);
+  static const float s_fTimeDiff = 1.0f / 60.0f;
+  static const float s_fFrictionFactor = 0.99f;
+
+  // same work as the gravity and velocity behaviors and the apply velocity finalizer of the particle system
+  void UpdateParticlesAoS(ParticleStreams& streams)
+  {
+    const ezUInt64 uiNumElements = streams.m_Group.GetNumActiveElements();
+    const ezVec3 vAddVelocity = s_vGravity * s_fTimeDiff;
+
+    {
+      ezProcessingStreamIterator<ezVec3> itVelocity(streams.m_pVelocity, uiNumElements, 0);
+      while (!itVelocity.HasReachedEnd())
+      {
+        itVelocity.Current() += vAddVelocity;
+        itVelocity.Advance();
+      }
+    }
+
+    {
+      ezProcessingStreamIterator<ezVec3> itVelocity(streams.m_pVelocity, uiNumElements, 0);
+      while (!itVelocity.HasReachedEnd())
+      {
+        itVelocity.Current() *= s_fFrictionFactor;
+        itVelocity.Advance();
+      }
+    }
+
+    {
+      ezProcessingStreamIterator<ezVec4> itPosition(streams.m_pPosition, uiNumElements, 0);
+      ezProcessingStreamIterator<ezVec3> itVelocity(streams.m_pVelocity, uiNumElements, 0);
+      while (!itPosition.HasReachedEnd())
+      {
+        reinterpret_cast<ezVec3&>(itPosition.Current()) += itVelocity.Current() * s_fTimeDiff;
+        itPosition.Advance();
+        itVelocity.Advance();
+      }
+    }
+  }
+
+  void UpdateParticlesSoA(ParticleStreams& streams)
+  {
+    const ezUInt64 uiNumElements = streams.m_Group.GetNumActiveElements();
+    const ezSimdVec4f vAddVelocity = ezSimdVec4f(s_vGravity.x, s_vGravity.y, s_vGravity.z, 0.0f) * s_fTimeDiff;
+
+    {
+      const ezSimdVec4f vAddX(vAddVelocity.x()), vAddY(vAddVelocity.y()), vAddZ(vAddVelocity.z());
+
+      ezProcessingStreamChunkIterator itVelocity(streams.m_pVelocity, uiNumElements, 0);
+      while (!itVelocity.HasReachedEnd())
+      {
+        itVelocity.Store(itVelocity.Load(0) + vAddX, 0);
+        itVelocity.Store(itVelocity.Load(1) + vAddY, 1);
+        itVelocity.Store(itVelocity.Load(2) + vAddZ, 2);
+        itVelocity.Advance();
+      }
+    }
+
+    {
+      const ezSimdFloat fFrictionFactor = s_fFrictionFactor;
+
+      ezProcessingStreamChunkIterator itVelocity(streams.m_pVelocity, uiNumElements, 0);
+      while (!itVelocity.HasReachedEnd())
+      {
+        itVelocity.Store(itVelocity.Load(0) * fFrictionFactor, 0);
+        itVelocity.Store(itVelocity.Load(1) * fFrictionFactor, 1);
+        itVelocity.Store(itVelocity.Load(2) * fFrictionFactor, 2);
+        itVelocity.Advance();
+      }
+    }
+
+    {
+      const ezSimdFloat fTimeDiff = s_fTimeDiff;
+      ezSimdVec4f* pPosition = streams.m_pPosition->GetWritableData<ezSimdVec4f>();
+
+      ezProcessingStreamChunkIterator itVelocity(streams.m_pVelocity, uiNumElements, 0);
+      while (!itVelocity.HasReachedEnd())
+      {
+        ezSimdMat4f velocity;
+        velocity.m_col0 = itVelocity.Load(0) * fTimeDiff;
+        velocity.m_col1 = itVelocity.Load(1) * fTimeDiff;
+        velocity.m_col2 = itVelocity.Load(2) * fTimeDiff;
+        velocity.m_col3.SetZero();
+        velocity.Transpose();
+
+        ezSimdVec4f* pChunkPosition = pPosition + itVelocity.GetCurrentIndex();
+        pChunkPosition[0] += velocity.m_col0;
+        pChunkPosition[1] += velocity.m_col1;
+        pChunkPosition[2] += velocity.m_col2;
+        pChunkPosition[3] += velocity.m_col3;
+
+        itVelocity.Advance();
+      }
+    }
+  }
+} // namespace ProcessingStreamTestDetail
+
+EZ_CREATE_SIMPLE_TEST(DataProcessing, ProcessingStreamSoA)
+{
+  using namespace ProcessingStreamTestDetail;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Layout")
+  {
+    ezProcessingStreamGroup Group;
+    ezProcessingStream* pStream = AddZeroInitializedStream(Group, "Stream", ezProcessingStream::DataType::Float3, ezProcessingStream::DataLayout::SoA);
+
+    Group.SetSize(21);
+    Group.InitializeElements(21);
+    Group.Process();
+
+    EZ_TEST_BOOL(pStream->GetDataLayout() == ezProcessingStream::DataLayout::SoA);
+    EZ_TEST_INT(pStream->GetComponentCount(), 3);
+    EZ_TEST_INT(pStream->GetComponentSize(), 4);
+    EZ_TEST_INT(pStream->GetElementStride(), 4);
+    EZ_TEST_INT(pStream->GetNumPaddedElements(), 32);
+    EZ_TEST_BOOL(pStream->GetComponentData<float>(1) == pStream->GetComponentData<float>(0) + 32);
+    EZ_TEST_BOOL(pStream->GetComponentData<float>(2) == pStream->GetComponentData<float>(0) + 64);
+    EZ_TEST_BOOL(((size_t)pStream->GetComponentData<float>(1) % 64) == 0);
+
+    for (ezUInt32 c = 0; c < 3; ++c)
+    {
+      for (ezUInt32 i = 0; i < 32; ++i)
+      {
+        EZ_TEST_FLOAT(pStream->GetComponentData<float>(c)[i], 0.0f, 0.0f);
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Chunk Iterator")
+  {
+    ezProcessingStreamGroup Group;
+    ezProcessingStream* pStream = AddZeroInitializedStream(Group, "Stream", ezProcessingStream::DataType::Float2, ezProcessingStream::DataLayout::SoA);
+
+    Group.SetSize(16);
+    Group.InitializeElements(10);
+    Group.Process();
+
+    ezUInt32 uiNumChunks = 0;
+    ezUInt32 uiNumValid = 0;
+
+    ezProcessingStreamChunkIterator it(pStream, Group.GetNumActiveElements(), 0);
+    while (!it.HasReachedEnd())
+    {
+      const float fIndex = (float)it.GetCurrentIndex();
+      it.Store(ezSimdVec4f(fIndex, fIndex + 1, fIndex + 2, fIndex + 3), 0);
+      it.Store(ezSimdVec4f(-fIndex, -fIndex - 1, -fIndex - 2, -fIndex - 3), 1);
+
+      uiNumValid += it.GetNumValidElements();
+      ++uiNumChunks;
+      it.Advance();
+    }
+
+    EZ_TEST_INT(uiNumChunks, 3);
+    EZ_TEST_INT(uiNumValid, 10);
+
+    ezProcessingStreamChunkIterator itLast(pStream, Group.GetNumActiveElements() - 8, 8);
+    const ezSimdVec4b validMask = itLast.GetValidMask();
+    EZ_TEST_BOOL(validMask.x() && validMask.y() && !validMask.z() && !validMask.w());
+
+    for (ezUInt32 i = 0; i < 12; ++i)
+    {
+      EZ_TEST_FLOAT(pStream->GetComponentData<float>(0)[i], (float)i, 0.0f);
+      EZ_TEST_FLOAT(pStream->GetComponentData<float>(1)[i], -(float)i, 0.0f);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Remove Elements")
+  {
+    ezProcessingStreamGroup Group;
+    ezProcessingStream* pStream = AddZeroInitializedStream(Group, "Stream", ezProcessingStream::DataType::Float3, ezProcessingStream::DataLayout::SoA);
+
+    Group.SetSize(16);
+    Group.InitializeElements(8);
+    Group.Process();
+
+    for (ezUInt32 c = 0; c < 3; ++c)
+    {
+      for (ezUInt32 i = 0; i < 8; ++i)
+      {
+        pStream->GetWritableComponentData<float>(c)[i] = (float)(c * 100 + i);
+      }
+    }
+
+    Group.RemoveElement(2);
+    Group.RemoveElement(7);
+    Group.RemoveElement(3);
+    Group.Process();
+
+    EZ_TEST_INT(Group.GetNumActiveElements(), 5);
+
+    // 3 is replaced by the last element (7) first, which is removed as well, then 6 moves to 3 and 5 moves to 2
+    const float expected[] = {0, 1, 5, 6, 4};
+    for (ezUInt32 c = 0; c < 3; ++c)
+    {
+      for (ezUInt32 i = 0; i < 5; ++i)
+      {
+        EZ_TEST_FLOAT(pStream->GetComponentData<float>(c)[i], c * 100 + expected[i], 0.0f);
+      }
+    }
+
+    // new elements are zero initialized in all components
+    Group.InitializeElements(2);
+    Group.Process();
+
+    for (ezUInt32 c = 0; c < 3; ++c)
+    {
+      EZ_TEST_FLOAT(pStream->GetComponentData<float>(c)[5], 0.0f, 0.0f);
+      EZ_TEST_FLOAT(pStream->GetComponentData<float>(c)[6], 0.0f, 0.0f);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Benchmark")
+  {
+    const ezUInt64 uiNumParticles = 1000 * 1000 + 3;
+    const ezUInt32 uiNumFrames = 10;
+
+    ParticleStreams aos(uiNumParticles, ezProcessingStream::DataLayout::AoS);
+    ParticleStreams soa(uiNumParticles, ezProcessingStream::DataLayout::SoA);
+
+    ezTime tAoS, tSoA;
+
+    for (ezUInt32 uiFrame = 0; uiFrame < uiNumFrames; ++uiFrame)
+    {
+      ezTime tStart = ezTime::Now();
+      UpdateParticlesAoS(aos);
+      tAoS += ezTime::Now() - tStart;
+
+      tStart = ezTime::Now();
+      UpdateParticlesSoA(soa);
+      tSoA += ezTime::Now() - tStart;
+    }
+
+    ezLog::Info("[test]Updating {0} particles (AoS): {1}ms", uiNumParticles, ezArgF(tAoS.GetMilliseconds() / uiNumFrames, 2));
+    ezLog::Info("[test]Updating {0} particles (SoA): {1}ms", uiNumParticles, ezArgF(tSoA.GetMilliseconds() / uiNumFrames, 2));
+
+    // both layouts must produce the same results
+    const ezVec4* pPosAoS = aos.m_pPosition->GetData<ezVec4>();
+    const ezVec4* pPosSoA = soa.m_pPosition->GetData<ezVec4>();
+    const ezVec3* pVelAoS = aos.m_pVelocity->GetData<ezVec3>();
+    const float* pVelSoA[3] = {soa.m_pVelocity->GetComponentData<float>(0), soa.m_pVelocity->GetComponentData<float>(1), soa.m_pVelocity->GetComponentData<float>(2)};
+
+    for (ezUInt64 i = 0; i < uiNumParticles; i += 9973)
+    {
+      EZ_TEST_VEC4(pPosAoS[i], pPosSoA[i], 0.0001f);
+      EZ_TEST_VEC3(pVelAoS[i], ezVec3(pVelSoA[0][i], pVelSoA[1][i], pVelSoA[2][i]), 0.0001f);
+    }
+
+    EZ_TEST_VEC4(pPosAoS[uiNumParticles - 1], pPosSoA[uiNumParticles - 1], 0.0001f);
+    EZ_TEST_BOOL(pPosSoA[uiNumParticles - 1].z < 0.0f);
+  }
+}
@@ -9,7 +9,8 @@
 #include <Foundation/System/Process.h>
 #include <Foundation/Utilities/CommandLineUtils.h>
 
-#if (EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS) && EZ_ENABLED(EZ_SUPPORTS_FILE_STATS) && defined(BUILDSYSTEM_HAS_ARCHIVE_TOOL))
+// launches ArchiveTool.exe through ezProcess, which is only implemented on Windows
+#if (EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS) && EZ_ENABLED(EZ_SUPPORTS_FILE_STATS) && defined(BUILDSYSTEM_HAS_ARCHIVE_TOOL) && EZ_ENABLED(EZ_PLATFORM_WINDOWS_DESKTOP))
 
 EZ_CREATE_SIMPLE_TEST(IO, Archive)
 {
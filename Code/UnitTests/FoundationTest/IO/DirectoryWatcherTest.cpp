@@ -0,0 +1,202 @@
+#include <FoundationTestPCH.h>
+
+#include <Foundation/IO/DirectoryWatcher.h>
+#include <Foundation/IO/OSFile.h>
+#include <Foundation/Threading/ThreadUtils.h>
+
+#if EZ_ENABLED(EZ_PLATFORM_LINUX)
+
+#include <ftw.h>
+#include <stdio.h>
+
+namespace DirectoryWatcherTestDetail
+{
+  struct ExpectedChange
+  {
+    const char* m_szPath;
+    ezDirectoryWatcherAction m_Action;
+  };
+
+  int RemoveItem(const char* szPath, const struct stat*, int, FTW*)
+  {
+    return remove(szPath);
+  }
+
+  // ezOSFile::DeleteFolder does not remove the folders themselves
+  void DeleteFolder(const char* szFolder)
+  {
+    nftw(szFolder, RemoveItem, 16, FTW_DEPTH | FTW_PHYS);
+  }
+
+  void WriteFile(const char* szRoot, const char* szFile, const char* szContent)
+  {
+    ezStringBuilder sPath = szRoot;
+    sPath.AppendPath(szFile);
+
+    ezOSFile file;
+    EZ_TEST_BOOL(file.Open(sPath, ezFileOpenMode::Write) == EZ_SUCCESS);
+    EZ_TEST_BOOL(file.Write(szContent, ezStringUtils::GetStringElementCount(szContent)) == EZ_SUCCESS);
+  }
+
+  void CheckChanges(ezDirectoryWatcher& watcher, const ezArrayPtr<const ExpectedChange>& expected)
+  {
+    struct Change
+    {
+      ezString m_sPath;
+      ezDirectoryWatcherAction m_Action;
+    };
+
+    ezDynamicArray<Change> changes;
+
+    // changes are only handed out once no new change arrived for the coalescing window
+    for (ezUInt32 i = 0; i < 200 && changes.IsEmpty(); ++i)
+    {
+      ezThreadUtils::Sleep(ezTime::Milliseconds(10));
+      watcher.EnumerateChanges([&](const char* szFilename, ezDirectoryWatcherAction action) {
+        changes.PushBack({szFilename, action});
+      });
+    }
+
+    if (EZ_TEST_INT(changes.GetCount(), expected.GetCount()).Failed())
+      return;
+
+    for (ezUInt32 i = 0; i < expected.GetCount(); ++i)
+    {
+      EZ_TEST_STRING(changes[i].m_sPath, expected[i].m_szPath);
+      EZ_TEST_BOOL(changes[i].m_Action == expected[i].m_Action);
+    }
+  }
+} // namespace DirectoryWatcherTestDetail
+
+EZ_CREATE_SIMPLE_TEST(IO, DirectoryWatcher)
+{
+  using namespace DirectoryWatcherTestDetail;
+
+  ezStringBuilder sRoot = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sRoot.MakeCleanPath();
+  sRoot.AppendPath("IO", "DirectoryWatcher");
+
+  DeleteFolder(sRoot);
+  EZ_TEST_BOOL(ezOSFile::CreateDirectoryStructure(sRoot) == EZ_SUCCESS);
+
+  ezDirectoryWatcher watcher;
+  watcher.SetCoalescingWindow(ezTime::Milliseconds(50));
+  EZ_TEST_BOOL(watcher.OpenDirectory(sRoot, ezDirectoryWatcher::Watch::Writes | ezDirectoryWatcher::Watch::Creates |
+                                              ezDirectoryWatcher::Watch::Renames | ezDirectoryWatcher::Watch::Subdirectories) == EZ_SUCCESS);
+
+  ezStringBuilder sPath, sPath2;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Create")
+  {
+    WriteFile(sRoot, "a.txt", "a");
+    WriteFile(sRoot, "a.txt", "aa");
+
+    const ExpectedChange expected[] = {{"a.txt", ezDirectoryWatcherAction::Added}};
+    CheckChanges(watcher, expected);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Modify")
+  {
+    for (ezUInt32 i = 0; i < 10; ++i)
+    {
+      WriteFile(sRoot, "a.txt", "modified");
+    }
+
+    const ExpectedChange expected[] = {{"a.txt", ezDirectoryWatcherAction::Modified}};
+    CheckChanges(watcher, expected);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Rename")
+  {
+    sPath = sRoot;
+    sPath.AppendPath("a.txt");
+    sPath2 = sRoot;
+    sPath2.AppendPath("b.txt");
+    EZ_TEST_INT(rename(sPath, sPath2), 0);
+
+    const ExpectedChange expected[] = {{"a.txt", ezDirectoryWatcherAction::RenamedOldName}, {"b.txt", ezDirectoryWatcherAction::RenamedNewName}};
+    CheckChanges(watcher, expected);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Temporary File")
+  {
+    // the usual save pattern: write a temporary file and rename it over the original.
+    // The temporary file never shows up, the file that it replaced is reported as modified.
+    WriteFile(sRoot, "b.txt.tmp", "saved");
+    sPath = sRoot;
+    sPath.AppendPath("b.txt.tmp");
+    sPath2 = sRoot;
+    sPath2.AppendPath("b.txt");
+    EZ_TEST_INT(rename(sPath, sPath2), 0);
+
+    WriteFile(sRoot, "c.txt", "c");
+    sPath = sRoot;
+    sPath.AppendPath("c.txt");
+    EZ_TEST_BOOL(ezOSFile::DeleteFile(sPath) == EZ_SUCCESS);
+
+    const ExpectedChange expected[] = {{"b.txt", ezDirectoryWatcherAction::Modified}};
+    CheckChanges(watcher, expected);
+
+    // without an original, the file is new
+    WriteFile(sRoot, "e.txt.tmp", "saved");
+    sPath = sRoot;
+    sPath.AppendPath("e.txt.tmp");
+    sPath2 = sRoot;
+    sPath2.AppendPath("e.txt");
+    EZ_TEST_INT(rename(sPath, sPath2), 0);
+
+    const ExpectedChange expected2[] = {{"e.txt", ezDirectoryWatcherAction::Added}};
+    CheckChanges(watcher, expected2);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Subdirectories")
+  {
+    sPath = sRoot;
+    sPath.AppendPath("sub", "inner");
+    EZ_TEST_BOOL(ezOSFile::CreateDirectoryStructure(sPath) == EZ_SUCCESS);
+    WriteFile(sRoot, "sub/inner/d.txt", "d");
+
+    const ExpectedChange expected[] = {
+      {"sub", ezDirectoryWatcherAction::Added}, {"sub/inner", ezDirectoryWatcherAction::Added}, {"sub/inner/d.txt", ezDirectoryWatcherAction::Added}};
+    CheckChanges(watcher, expected);
+
+    // the new directories are watched as well
+    WriteFile(sRoot, "sub/inner/d.txt", "dd");
+
+    const ExpectedChange expected2[] = {{"sub/inner/d.txt", ezDirectoryWatcherAction::Modified}};
+    CheckChanges(watcher, expected2);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Rename Directory")
+  {
+    sPath = sRoot;
+    sPath.AppendPath("sub");
+    sPath2 = sRoot;
+    sPath2.AppendPath("sub2");
+    EZ_TEST_INT(rename(sPath, sPath2), 0);
+
+    const ExpectedChange expected[] = {{"sub", ezDirectoryWatcherAction::RenamedOldName}, {"sub2", ezDirectoryWatcherAction::RenamedNewName}};
+    CheckChanges(watcher, expected);
+
+    // the watches follow the renamed directory
+    WriteFile(sRoot, "sub2/inner/d.txt", "ddd");
+
+    const ExpectedChange expected2[] = {{"sub2/inner/d.txt", ezDirectoryWatcherAction::Modified}};
+    CheckChanges(watcher, expected2);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Remove")
+  {
+    sPath = sRoot;
+    sPath.AppendPath("b.txt");
+    EZ_TEST_BOOL(ezOSFile::DeleteFile(sPath) == EZ_SUCCESS);
+
+    const ExpectedChange expected[] = {{"b.txt", ezDirectoryWatcherAction::Removed}};
+    CheckChanges(watcher, expected);
+  }
+
+  watcher.CloseDirectory();
+  DeleteFolder(sRoot);
+}
+
+#endif
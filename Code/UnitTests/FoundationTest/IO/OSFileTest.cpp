@@ -157,11 +157,10 @@ Only concrete and clocks.\n\
 
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "File Iterator")
   {
-    // It is not really possible to test this stuff (with a guaranteed result), as long as we do not have
-    // a test data folder with deterministic content
-    // Therefore I tested it manually, and leave the code in, such that it is at least a 'does it compile and link' test.
+    // The output folder contains at least the folders and files written above.
+    // The application directory used to be searched here, but it does not contain sub-folders on every platform.
 
-    ezStringBuilder sOutputFolder = ezOSFile::GetApplicationDirectory();
+    ezStringBuilder sOutputFolder = ezTestFramework::GetInstance()->GetAbsOutputPath();
     sOutputFolder.AppendPath("*");
 
     ezStringBuilder sFullPath;
@@ -204,6 +203,76 @@ Only concrete and clocks.\n\
     EZ_TEST_BOOL(uiFiles > 0);
   }
 
+#  if EZ_ENABLED(EZ_SUPPORTS_FILE_STATS)
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "GatherAllItemsInFolderParallel")
+  {
+    ezStringBuilder sFolder = ezTestFramework::GetInstance()->GetAbsOutputPath();
+    sFolder.MakeCleanPath();
+    sFolder.AppendPath("IO", "GatherAllItems");
+
+    ezStringBuilder sPath;
+    for (ezUInt32 a = 0; a < 4; ++a)
+    {
+      for (ezUInt32 b = 0; b < 3; ++b)
+      {
+        for (ezUInt32 c = 0; c < 5; ++c)
+        {
+          sPath.Format("{0}/Folder{1}/Sub{2}/File{3}.txt", sFolder, a, b, c);
+
+          ezOSFile f;
+          EZ_TEST_BOOL(f.Open(sPath, ezFileOpenMode::Write) == EZ_SUCCESS);
+        }
+      }
+    }
+
+    ezDynamicArray<ezFileStats> serialItems;
+    ezDynamicArray<ezFileStats> parallelItems;
+
+    ezOSFile::GatherAllItemsInFolder(serialItems, sFolder);
+    ezOSFile::GatherAllItemsInFolderParallel(parallelItems, sFolder);
+
+    // 4 folders with 3 sub-folders with 5 files each
+    EZ_TEST_INT(serialItems.GetCount(), 4 + 4 * 3 + 4 * 3 * 5);
+
+    if (EZ_TEST_INT(parallelItems.GetCount(), serialItems.GetCount()).Succeeded())
+    {
+      ezStringBuilder sSerialPath, sParallelPath;
+      for (ezUInt32 i = 0; i < serialItems.GetCount(); ++i)
+      {
+        serialItems[i].GetFullPath(sSerialPath);
+        parallelItems[i].GetFullPath(sParallelPath);
+
+        EZ_TEST_STRING(sParallelPath, sSerialPath);
+        EZ_TEST_BOOL(parallelItems[i].m_bIsDirectory == serialItems[i].m_bIsDirectory);
+        EZ_TEST_BOOL(parallelItems[i].m_LastModificationTime.Compare(serialItems[i].m_LastModificationTime, ezTimestamp::CompareMode::Identical));
+      }
+    }
+
+    ezOSFile::GatherAllItemsInFolderParallel(parallelItems, sFolder, ezFileSystemIteratorFlags::ReportFilesRecursive);
+    EZ_TEST_INT(parallelItems.GetCount(), 4 * 3 * 5);
+
+    ezOSFile::GatherAllItemsInFolderParallel(parallelItems, sFolder, ezFileSystemIteratorFlags::Default, [](const ezFileStats& folder) { return folder.m_sName != "Sub1"; });
+    EZ_TEST_INT(parallelItems.GetCount(), 4 + 4 * 3 + 4 * 2 * 5);
+
+    sPath.Format("{0}/Folder0/Sub0/*.txt", sFolder);
+    ezOSFile::GatherAllItemsInFolder(serialItems, sPath, ezFileSystemIteratorFlags::ReportFiles);
+    EZ_TEST_INT(serialItems.GetCount(), 5);
+
+    sPath.Format("{0}/Folder0/Sub0/File3.txt", sFolder);
+    ezOSFile::GatherAllItemsInFolder(serialItems, sPath, ezFileSystemIteratorFlags::ReportFiles);
+    if (EZ_TEST_INT(serialItems.GetCount(), 1).Succeeded())
+    {
+      EZ_TEST_STRING(serialItems[0].m_sName, "File3.txt");
+    }
+
+    EZ_TEST_BOOL(ezOSFile::DeleteFolder(sFolder) == EZ_SUCCESS);
+    ezOSFile::GatherAllItemsInFolder(serialItems, sFolder, ezFileSystemIteratorFlags::ReportFilesRecursive);
+    EZ_TEST_BOOL(serialItems.IsEmpty());
+  }
+
+#  endif
+
 #endif
 
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "Delete File")
@@ -0,0 +1,326 @@
+#include <FoundationTestPCH.h>
+
+#include <Foundation/Math/Color16f.h>
+#include <Foundation/Math/Random.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <Texture/Image/Conversions/DXTConversions.h>
+#include <Texture/Image/Image.h>
+#include <Texture/Image/ImageConversion.h>
+
+namespace
+{
+  constexpr ezUInt32 s_uiImageSize = 64;
+
+  /// Smooth gradients, hard edges between unrelated colors, noise and thin stripes, one in each quadrant.
+  void CreateTestImage(bool bWithAlpha, ezDynamicArray<ezColorBaseUB>& out_Pixels)
+  {
+    ezRandom rnd;
+    rnd.Initialize(42);
+
+    out_Pixels.SetCountUninitialized(s_uiImageSize * s_uiImageSize);
+
+    for (ezUInt32 y = 0; y < s_uiImageSize; ++y)
+    {
+      for (ezUInt32 x = 0; x < s_uiImageSize; ++x)
+      {
+        const bool bLeft = x < s_uiImageSize / 2;
+        const bool bTop = y < s_uiImageSize / 2;
+
+        ezColorBaseUB color(static_cast<ezUInt8>(x * 4), static_cast<ezUInt8>(y * 4), 128, static_cast<ezUInt8>(255 - 2 * x));
+
+        if (!bLeft && bTop)
+        {
+          const bool bChecker = ((x / 3) + (y / 3)) % 2 == 0;
+          color = bChecker ? ezColorBaseUB(200, 30, 40, 255) : ezColorBaseUB(20, 180, 220, 0);
+        }
+        else if (bLeft && !bTop)
+        {
+          color.r = static_cast<ezUInt8>(ezMath::Clamp<ezInt32>(color.r + rnd.IntMinMax(-16, 16), 0, 255));
+          color.g = static_cast<ezUInt8>(ezMath::Clamp<ezInt32>(color.g + rnd.IntMinMax(-16, 16), 0, 255));
+          color.b = static_cast<ezUInt8>(ezMath::Clamp<ezInt32>(color.b + rnd.IntMinMax(-16, 16), 0, 255));
+        }
+        else if (!bLeft && !bTop)
+        {
+          static const ezColorBaseUB s_Stripes[] = {ezColorBaseUB(250, 220, 10, 255), ezColorBaseUB(60, 20, 160, 128), ezColorBaseUB(10, 120, 30, 200)};
+          color = s_Stripes[(x + y / 2) / 5 % 3];
+        }
+
+        if (!bWithAlpha)
+        {
+          color.a = 255;
+        }
+
+        out_Pixels[y * s_uiImageSize + x] = color;
+      }
+    }
+  }
+
+  void GatherBlock(const ezDynamicArray<ezColorBaseUB>& pixels, ezUInt32 uiBlockX, ezUInt32 uiBlockY, ezColorBaseUB* out_pBlock)
+  {
+    for (ezUInt32 y = 0; y < 4; ++y)
+    {
+      for (ezUInt32 x = 0; x < 4; ++x)
+      {
+        out_pBlock[y * 4 + x] = pixels[(uiBlockY * 4 + y) * s_uiImageSize + uiBlockX * 4 + x];
+      }
+    }
+  }
+
+  double ComputePSNR(double fSquaredError, ezUInt32 uiNumValues)
+  {
+    const double fMSE = ezMath::Max(fSquaredError / uiNumValues, 1e-6);
+    return 10.0 * ezMath::Log10(static_cast<float>(255.0 * 255.0 / fMSE));
+  }
+
+  /// Compresses every block of the test image with the given function, decompresses it again and returns the PSNR over the given number of channels.
+  template <typename CompressFunc, typename DecompressFunc>
+  double MeasureColorPSNR(bool bWithAlpha, ezUInt32 uiNumChannels, CompressFunc compress, DecompressFunc decompress)
+  {
+    ezDynamicArray<ezColorBaseUB> pixels;
+    CreateTestImage(bWithAlpha, pixels);
+
+    double fSquaredError = 0.0;
+
+    for (ezUInt32 uiBlockY = 0; uiBlockY < s_uiImageSize / 4; ++uiBlockY)
+    {
+      for (ezUInt32 uiBlockX = 0; uiBlockX < s_uiImageSize / 4; ++uiBlockX)
+      {
+        ezColorBaseUB source[16];
+        GatherBlock(pixels, uiBlockX, uiBlockY, source);
+
+        ezUInt8 block[16];
+        compress(source, block);
+
+        ezColorBaseUB decoded[16];
+        decompress(block, decoded);
+
+        for (ezUInt32 i = 0; i < 16; ++i)
+        {
+          for (ezUInt32 c = 0; c < uiNumChannels; ++c)
+          {
+            const double fDiff = static_cast<double>(source[i].GetData()[c]) - static_cast<double>(decoded[i].GetData()[c]);
+            fSquaredError += fDiff * fDiff;
+          }
+        }
+      }
+    }
+
+    return ComputePSNR(fSquaredError, s_uiImageSize * s_uiImageSize * uiNumChannels);
+  }
+
+  /// Scales the test image into [0; 16] and compares the tone mapped values, so that errors in bright areas don't dominate.
+  double MeasureHDRPSNR(ezBlockCompressionQuality::Enum quality)
+  {
+    ezDynamicArray<ezColorBaseUB> pixels;
+    CreateTestImage(false, pixels);
+
+    auto toneMap = [](float f) { return 255.0 * f / (1.0 + f); };
+
+    double fSquaredError = 0.0;
+
+    for (ezUInt32 uiBlockY = 0; uiBlockY < s_uiImageSize / 4; ++uiBlockY)
+    {
+      for (ezUInt32 uiBlockX = 0; uiBlockX < s_uiImageSize / 4; ++uiBlockX)
+      {
+        ezColorBaseUB block8[16];
+        GatherBlock(pixels, uiBlockX, uiBlockY, block8);
+
+        ezColorLinear16f source[16];
+        for (ezUInt32 i = 0; i < 16; ++i)
+        {
+          const float fScale = 16.0f / 255.0f;
+          source[i] = ezColorLinear16f(block8[i].r * fScale, block8[i].g * fScale, block8[i].b * fScale, 1.0f);
+        }
+
+        ezUInt8 block[16];
+        ezCompressBlockBC6(source, block, quality);
+
+        ezColorLinear16f decoded[16];
+        ezDecompressBlockBC6(block, decoded, false);
+
+        for (ezUInt32 i = 0; i < 16; ++i)
+        {
+          const ezColorLinear16f& a = source[i];
+          const ezColorLinear16f& b = decoded[i];
+
+          const double fDiffR = toneMap(a.r) - toneMap(b.r);
+          const double fDiffG = toneMap(a.g) - toneMap(b.g);
+          const double fDiffB = toneMap(a.b) - toneMap(b.b);
+          fSquaredError += fDiffR * fDiffR + fDiffG * fDiffG + fDiffB * fDiffB;
+        }
+      }
+    }
+
+    return ComputePSNR(fSquaredError, s_uiImageSize * s_uiImageSize * 3);
+  }
+
+  const char* GetQualityName(ezBlockCompressionQuality::Enum quality)
+  {
+    switch (quality)
+    {
+      case ezBlockCompressionQuality::Fast:
+        return "Fast";
+      case ezBlockCompressionQuality::Balanced:
+        return "Balanced";
+      default:
+        return "High";
+    }
+  }
+
+  /// Checks the PSNR of every quality level against its minimum and that higher qualities never get worse.
+  template <typename MeasureFunc>
+  void TestQualityLevels(const char* szFormat, const double* pMinPSNR, MeasureFunc measure)
+  {
+    double fPreviousPSNR = 0.0;
+
+    for (ezUInt32 q = 0; q < 3; ++q)
+    {
+      const ezBlockCompressionQuality::Enum quality = static_cast<ezBlockCompressionQuality::Enum>(q);
+
+      ezStopwatch sw;
+      const double fPSNR = measure(quality);
+      const ezTime tDuration = sw.GetRunningTotal();
+
+      ezLog::Info("[test]{0} {1}: {2} dB, {3} ms", szFormat, GetQualityName(quality), ezArgF(fPSNR, 2), ezArgF(tDuration.GetMilliseconds(), 1));
+
+      EZ_TEST_BOOL_MSG(fPSNR >= pMinPSNR[q], "%s %s: PSNR of %.2f dB is below %.2f dB", szFormat, GetQualityName(quality), fPSNR, pMinPSNR[q]);
+      EZ_TEST_BOOL_MSG(fPSNR >= fPreviousPSNR - 0.01, "%s %s is worse than the lower quality level", szFormat, GetQualityName(quality));
+
+      fPreviousPSNR = fPSNR;
+    }
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Image, BlockCompression)
+{
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "BC1")
+  {
+    const double fMinPSNR[] = {34.0, 34.0, 34.0};
+    TestQualityLevels("BC1", fMinPSNR, [](ezBlockCompressionQuality::Enum quality) {
+      return MeasureColorPSNR(
+        false, 3, [=](const ezColorBaseUB* pSource, ezUInt8* pTarget) { ezCompressBlockBC1(pSource, pTarget, false, quality); },
+        [](const ezUInt8* pSource, ezColorBaseUB* pTarget) { ezDecompressBlockBC1(pSource, pTarget, false); });
+    });
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "BC1 Punch Through Alpha")
+  {
+    ezColorBaseUB source[16];
+    for (ezUInt32 i = 0; i < 16; ++i)
+    {
+      source[i] = ezColorBaseUB(static_cast<ezUInt8>(i * 16), 100, 50, (i % 3) == 0 ? 0 : 255);
+    }
+
+    ezUInt8 block[8];
+    ezCompressBlockBC1(source, block, true, ezBlockCompressionQuality::Default);
+
+    ezColorBaseUB decoded[16];
+    ezDecompressBlockBC1(block, decoded, false);
+
+    for (ezUInt32 i = 0; i < 16; ++i)
+    {
+      EZ_TEST_BOOL((decoded[i].a == 0) == (source[i].a == 0));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "BC3")
+  {
+    const double fMinPSNR[] = {35.0, 35.5, 35.5};
+    TestQualityLevels("BC3", fMinPSNR, [](ezBlockCompressionQuality::Enum quality) {
+      return MeasureColorPSNR(
+        true, 4, [=](const ezColorBaseUB* pSource, ezUInt8* pTarget) { ezCompressBlockBC3(pSource, pTarget, quality); },
+        [](const ezUInt8* pSource, ezColorBaseUB* pTarget) {
+          ezDecompressBlockBC1(pSource + 8, pTarget, true);
+          ezDecompressBlockBC4(pSource, &pTarget->a, 4, 0);
+        });
+    });
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "BC4")
+  {
+    const double fMinPSNR[] = {49.5, 50.0, 50.0};
+    TestQualityLevels("BC4", fMinPSNR, [](ezBlockCompressionQuality::Enum quality) {
+      return MeasureColorPSNR(
+        false, 1, [=](const ezColorBaseUB* pSource, ezUInt8* pTarget) { ezCompressBlockBC4(&pSource->r, 4, pTarget, 0, quality); },
+        [](const ezUInt8* pSource, ezColorBaseUB* pTarget) { ezDecompressBlockBC4(pSource, &pTarget->r, 4, 0); });
+    });
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "BC6H")
+  {
+    const double fMinPSNR[] = {37.5, 38.0, 38.0};
+    TestQualityLevels("BC6H", fMinPSNR, [](ezBlockCompressionQuality::Enum quality) { return MeasureHDRPSNR(quality); });
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "BC7")
+  {
+    const double fMinPSNROpaque[] = {35.5, 38.5, 39.5};
+    TestQualityLevels("BC7 Opaque", fMinPSNROpaque, [](ezBlockCompressionQuality::Enum quality) {
+      return MeasureColorPSNR(
+        false, 3, [=](const ezColorBaseUB* pSource, ezUInt8* pTarget) { ezCompressBlockBC7(pSource, pTarget, quality); },
+        [](const ezUInt8* pSource, ezColorBaseUB* pTarget) { ezDecompressBlockBC7(pSource, pTarget); });
+    });
+
+    const double fMinPSNRAlpha[] = {36.5, 38.5, 40.0};
+    TestQualityLevels("BC7 Alpha", fMinPSNRAlpha, [](ezBlockCompressionQuality::Enum quality) {
+      return MeasureColorPSNR(
+        true, 4, [=](const ezColorBaseUB* pSource, ezUInt8* pTarget) { ezCompressBlockBC7(pSource, pTarget, quality); },
+        [](const ezUInt8* pSource, ezColorBaseUB* pTarget) { ezDecompressBlockBC7(pSource, pTarget); });
+    });
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Image Conversion")
+  {
+    // BC3 is always compressed by the portable encoder, the size is not a multiple of the block size
+    ezImageHeader header;
+    header.SetImageFormat(ezImageFormat::R8G8B8A8_UNORM);
+    header.SetWidth(s_uiImageSize - 2);
+    header.SetHeight(s_uiImageSize - 1);
+
+    ezDynamicArray<ezColorBaseUB> pixels;
+    CreateTestImage(true, pixels);
+
+    ezImage source;
+    source.ResetAndAlloc(header);
+
+    for (ezUInt32 y = 0; y < header.GetHeight(); ++y)
+    {
+      for (ezUInt32 x = 0; x < header.GetWidth(); ++x)
+      {
+        *source.GetPixelPointer<ezColorBaseUB>(0, 0, 0, x, y) = pixels[y * s_uiImageSize + x];
+      }
+    }
+
+    ezImage compressed, decompressed;
+    EZ_TEST_BOOL(ezImageConversion::Convert(source, compressed, ezImageFormat::BC3_UNORM).Succeeded());
+    EZ_TEST_BOOL(ezImageConversion::Convert(compressed, decompressed, ezImageFormat::R8G8B8A8_UNORM).Succeeded());
+    EZ_TEST_INT(decompressed.GetWidth(), header.GetWidth());
+    EZ_TEST_INT(decompressed.GetHeight(), header.GetHeight());
+
+    double fSquaredError = 0.0;
+    for (ezUInt32 y = 0; y < header.GetHeight(); ++y)
+    {
+      for (ezUInt32 x = 0; x < header.GetWidth(); ++x)
+      {
+        const ezColorBaseUB a = *source.GetPixelPointer<ezColorBaseUB>(0, 0, 0, x, y);
+        const ezColorBaseUB b = *decompressed.GetPixelPointer<ezColorBaseUB>(0, 0, 0, x, y);
+
+        for (ezUInt32 c = 0; c < 4; ++c)
+        {
+          const double fDiff = static_cast<double>(a.GetData()[c]) - static_cast<double>(b.GetData()[c]);
+          fSquaredError += fDiff * fDiff;
+        }
+      }
+    }
+
+    EZ_TEST_BOOL(ComputePSNR(fSquaredError, header.GetWidth() * header.GetHeight() * 4) > 33.0);
+
+    // the quality is passed through to the compressor
+    ezImage compressedFast, compressedHigh;
+    EZ_TEST_BOOL(ezImageConversion::Convert(source, compressedFast, ezImageFormat::BC3_UNORM, ezBlockCompressionQuality::Fast).Succeeded());
+    EZ_TEST_BOOL(ezImageConversion::Convert(source, compressedHigh, ezImageFormat::BC3_UNORM, ezBlockCompressionQuality::High).Succeeded());
+    EZ_TEST_INT(compressedFast.GetByteBlobPtr().GetCount(), compressedHigh.GetByteBlobPtr().GetCount());
+    EZ_TEST_BOOL(ezMemoryUtils::Compare(compressedFast.GetByteBlobPtr().GetPtr(), compressedHigh.GetByteBlobPtr().GetPtr(),
+                   compressedFast.GetByteBlobPtr().GetCount()) != 0);
+  }
+}
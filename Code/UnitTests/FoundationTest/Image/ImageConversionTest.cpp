@@ -206,11 +206,18 @@ private:
 
     ezFileSystem::AddDataDirectory(">eztest/", "ImageComparisonDataDir", "imgout", ezFileSystem::AllowWrites);
 
+#if EZ_DISABLED(EZ_PLATFORM_WINDOWS_DESKTOP)
+    // Without DirectXTex, BC1, BC6H and BC7 are compressed by the portable encoders, which produce different blocks
+    ezTestFramework::GetInstance()->SetImageReferenceOverrideFolderName("Images_Reference_Portable");
+#endif
+
     return EZ_SUCCESS;
   }
 
   virtual ezResult DeInitializeTest() override
   {
+    ezTestFramework::GetInstance()->SetImageReferenceOverrideFolderName("");
+
     ezFileSystem::RemoveDataDirectoryGroup("ImageConversionTest");
     ezFileSystem::RemoveDataDirectoryGroup("ImageComparisonDataDir");
 
@@ -3,8 +3,53 @@
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Foundation/Math/Random.h>
+#include <Texture/Image/ImageFilter.h>
 #include <Texture/Image/ImageUtils.h>
 
+namespace
+{
+  void FillRandom(ezImage& image, ezUInt32 uiSeed)
+  {
+    ezRandom rnd;
+    rnd.Initialize(uiSeed);
+
+    for (float& value : image.GetBlobPtr<float>())
+    {
+      value = static_cast<float>(rnd.DoubleZeroToOneInclusive());
+    }
+  }
+
+  /// Straightforward non-separable convolution with clamped addressing, used as the reference for ezImageUtils::Scale3D.
+  ezColor SampleReference(const ezImage& source, ezUInt32 uiArrayIndex, const ezImageFilterWeights& weightsX, const ezImageFilterWeights& weightsY,
+    const ezImageFilterWeights& weightsZ, ezUInt32 x, ezUInt32 y, ezUInt32 z)
+  {
+    ezColor result(0, 0, 0, 0);
+
+    for (ezUInt32 k = 0; k < weightsZ.GetNumWeights(); ++k)
+    {
+      const ezInt32 sz = ezMath::Clamp<ezInt32>(weightsZ.GetFirstSourceSampleIndex(z) + k, 0, source.GetDepth() - 1);
+      const float wz = weightsZ.GetWeight(z, k);
+
+      for (ezUInt32 j = 0; j < weightsY.GetNumWeights(); ++j)
+      {
+        const ezInt32 sy = ezMath::Clamp<ezInt32>(weightsY.GetFirstSourceSampleIndex(y) + j, 0, source.GetHeight() - 1);
+        const float wy = weightsY.GetWeight(y, j);
+
+        for (ezUInt32 i = 0; i < weightsX.GetNumWeights(); ++i)
+        {
+          const ezInt32 sx = ezMath::Clamp<ezInt32>(weightsX.GetFirstSourceSampleIndex(x) + i, 0, source.GetWidth() - 1);
+          const float wx = weightsX.GetWeight(x, i);
+
+          result += *source.GetPixelPointer<ezColor>(0, 0, uiArrayIndex, sx, sy, sz) * (wx * wy * wz);
+        }
+      }
+    }
+
+    return result;
+  }
+} // namespace
+
 
 EZ_CREATE_SIMPLE_TEST(Image, ImageUtils)
 {
@@ -116,5 +161,96 @@ EZ_CREATE_SIMPLE_TEST(Image, ImageUtils)
     EZ_TEST_INT(uiError, 1433);
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Scale3D")
+  {
+    // large enough that all three passes are split into several tasks
+    ezImageHeader header;
+    header.SetImageFormat(ezImageFormat::R32G32B32A32_FLOAT);
+    header.SetWidth(53);
+    header.SetHeight(37);
+    header.SetDepth(9);
+    header.SetNumArrayIndices(2);
+
+    ezImage source;
+    source.ResetAndAlloc(header);
+    FillRandom(source, 7);
+
+    const ezUInt32 uiWidth = 71;
+    const ezUInt32 uiHeight = 16;
+    const ezUInt32 uiDepth = 4;
+
+    ezImageFilterSincWithKaiserWindow filter;
+
+    ezImage scaled;
+    EZ_TEST_BOOL(ezImageUtils::Scale3D(source, scaled, uiWidth, uiHeight, uiDepth, &filter).Succeeded());
+    EZ_TEST_INT(scaled.GetWidth(), uiWidth);
+    EZ_TEST_INT(scaled.GetHeight(), uiHeight);
+    EZ_TEST_INT(scaled.GetDepth(), uiDepth);
+    EZ_TEST_INT(scaled.GetNumArrayIndices(), 2);
+
+    const ezImageFilterWeights weightsX(filter, source.GetWidth(), uiWidth);
+    const ezImageFilterWeights weightsY(filter, source.GetHeight(), uiHeight);
+    const ezImageFilterWeights weightsZ(filter, source.GetDepth(), uiDepth);
+
+    float fMaxError = 0.0f;
+    for (ezUInt32 uiArrayIndex = 0; uiArrayIndex < 2; ++uiArrayIndex)
+    {
+      for (ezUInt32 z = 0; z < uiDepth; ++z)
+      {
+        for (ezUInt32 y = 0; y < uiHeight; ++y)
+        {
+          for (ezUInt32 x = 0; x < uiWidth; ++x)
+          {
+            const ezColor expected = SampleReference(source, uiArrayIndex, weightsX, weightsY, weightsZ, x, y, z);
+            const ezColor actual = *scaled.GetPixelPointer<ezColor>(0, 0, uiArrayIndex, x, y, z);
+
+            const ezColor diff = expected - actual;
+            fMaxError = ezMath::Max(fMaxError, ezMath::Abs(diff.r), ezMath::Abs(diff.g), ezMath::Abs(diff.b));
+            fMaxError = ezMath::Max(fMaxError, ezMath::Abs(diff.a));
+          }
+        }
+      }
+    }
+
+    EZ_TEST_FLOAT(fMaxError, 0.0f, 0.0001f);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "GenerateMipMaps Cubemap")
+  {
+    ezImageHeader header;
+    header.SetImageFormat(ezImageFormat::R32G32B32A32_FLOAT);
+    header.SetWidth(128);
+    header.SetHeight(128);
+    header.SetNumFaces(6);
+
+    ezImage cubemap;
+    cubemap.ResetAndAlloc(header);
+    FillRandom(cubemap, 11);
+
+    ezImageUtils::MipMapOptions options;
+    options.m_preserveCoverage = true;
+
+    ezImage cubemapMips;
+    ezImageUtils::GenerateMipMaps(cubemap, cubemapMips, options);
+    EZ_TEST_INT(cubemapMips.GetNumMipLevels(), 8);
+
+    // the faces are processed in parallel, each one must match the mip chain of the face on its own
+    for (ezUInt32 uiFace = 0; uiFace < 6; ++uiFace)
+    {
+      ezImage face, faceMips;
+      face.ResetAndCopy(cubemap.GetSubImageView(0, uiFace, 0));
+      ezImageUtils::GenerateMipMaps(face, faceMips, options);
+
+      for (ezUInt32 uiMip = 0; uiMip < faceMips.GetNumMipLevels(); ++uiMip)
+      {
+        auto expected = faceMips.GetSubImageView(uiMip, 0, 0).GetByteBlobPtr();
+        auto actual = cubemapMips.GetSubImageView(uiMip, uiFace, 0).GetByteBlobPtr();
+
+        EZ_TEST_INT(actual.GetCount(), expected.GetCount());
+        EZ_TEST_BOOL(ezMemoryUtils::IsEqual(actual.GetPtr(), expected.GetPtr(), static_cast<size_t>(expected.GetCount())));
+      }
+    }
+  }
+
   ezFileSystem::RemoveDataDirectoryGroup("ImageTest");
 }
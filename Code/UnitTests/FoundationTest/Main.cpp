@@ -1,5 +1,7 @@
 #include <FoundationTestPCH.h>
 
+#include <Foundation/Communication/IpcChannel.h>
+#include <Foundation/Configuration/Startup.h>
 #include <Foundation/Utilities/CommandLineUtils.h>
 #include <TestFramework/Framework/TestFramework.h>
 #include <TestFramework/Utilities/TestSetup.h>
@@ -45,5 +47,38 @@ EZ_TESTFRAMEWORK_ENTRY_POINT_BEGIN("FoundationTest", "Foundation Tests")
     ezTestSetup::DeInitTestFramework(true);
     return cmd.GetIntOption("-exitcode");
   }
+
+  // if the -ipcecho switch is set, FoundationTest.exe connects to the IPC channel given with -ipc and sends every message back
+  // this is used to test IPC channels between two processes (e.g. ezIpcChannel)
+  if (cmd.GetBoolOption("-ipcecho"))
+  {
+    ezStartup::StartupCoreSystems();
+
+    const char* szAddress = cmd.GetStringOption("-ipc");
+    ezIpcChannel* pChannel = cmd.GetBoolOption("-sharedmemory") ? ezIpcChannel::CreateSharedMemoryChannel(szAddress, ezIpcChannel::Mode::Client)
+                                                                : ezIpcChannel::CreatePipeChannel(szAddress, ezIpcChannel::Mode::Client);
+
+    pChannel->m_MessageEvent.AddEventHandler([pChannel](const ezProcessMessage* pMsg) { pChannel->Send(const_cast<ezProcessMessage*>(pMsg)); });
+    pChannel->Connect();
+
+    for (ezUInt32 i = 0; i < 500 && !pChannel->IsConnected(); ++i)
+    {
+      ezThreadUtils::Sleep(ezTime::Milliseconds(10));
+    }
+
+    const bool bConnected = pChannel->IsConnected();
+
+    // the server closing the connection ends the echo
+    while (pChannel->IsConnected())
+    {
+      pChannel->WaitForMessages();
+    }
+
+    EZ_DEFAULT_DELETE(pChannel);
+    ezStartup::ShutdownCoreSystems();
+
+    ezTestSetup::DeInitTestFramework(true);
+    return bConnected ? 0 : 1;
+  }
 }
 EZ_TESTFRAMEWORK_ENTRY_POINT_END()
@@ -3,6 +3,7 @@
 #include <Foundation/Memory/CommonAllocators.h>
 #include <Foundation/Memory/LargeBlockAllocator.h>
 #include <Foundation/Memory/StackAllocator.h>
+#include <Foundation/Threading/TaskSystem.h>
 
 struct EZ_ALIGN(NonAlignedVector, EZ_ALIGNMENT_MINIMUM)
 {
@@ -235,4 +236,53 @@ EZ_CREATE_SIMPLE_TEST(Memory, Allocator)
 
     EZ_TEST_BOOL(ezConstructionCounter::HasDestructed(50));
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "StackAllocator multi-threaded")
+  {
+    ezStackAllocator<ezMemoryTrackingFlags::RegisterAllocator> allocator("TestStackAllocator", ezFoundation::GetAlignedAllocator());
+
+    constexpr ezUInt32 uiNumItems = 256;
+    constexpr ezUInt32 uiBlocksPerItem = 64;
+    ezAtomicInteger32 iNumErrors;
+
+    for (ezUInt32 uiFrame = 0; uiFrame < 3; ++uiFrame)
+    {
+      ezTaskSystem::ParallelForIndexed(0, uiNumItems, [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        for (ezUInt32 uiItem = uiStartIndex; uiItem < uiEndIndex; ++uiItem)
+        {
+          ezUInt32* blocks[uiBlocksPerItem];
+          for (ezUInt32 i = 0; i < uiBlocksPerItem; ++i)
+          {
+            const ezUInt32 uiCount = 1 + (i % 16);
+            blocks[i] = EZ_NEW_RAW_BUFFER(&allocator, ezUInt32, uiCount);
+            for (ezUInt32 j = 0; j < uiCount; ++j)
+            {
+              blocks[i][j] = uiItem * uiBlocksPerItem + i;
+            }
+          }
+
+          // blocks must not overlap with blocks of other threads
+          for (ezUInt32 i = 0; i < uiBlocksPerItem; ++i)
+          {
+            const ezUInt32 uiCount = 1 + (i % 16);
+            for (ezUInt32 j = 0; j < uiCount; ++j)
+            {
+              if (blocks[i][j] != uiItem * uiBlocksPerItem + i)
+                iNumErrors.Increment();
+            }
+          }
+
+          EZ_NEW(&allocator, ezConstructionCounter);
+        }
+      });
+
+      EZ_TEST_INT(iNumErrors, 0);
+      EZ_TEST_BOOL(ezConstructionCounter::HasConstructed(uiNumItems));
+
+      allocator.Reset();
+
+      EZ_TEST_BOOL(ezConstructionCounter::HasDestructed(uiNumItems));
+      EZ_TEST_BOOL(allocator.GetStats().m_uiAllocationSize > 0);
+    }
+  }
 }
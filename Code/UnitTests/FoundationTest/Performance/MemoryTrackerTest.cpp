@@ -0,0 +1,102 @@
+#include <FoundationTestPCH.h>
+
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Memory/CommonAllocators.h>
+#include <Foundation/Threading/Thread.h>
+#include <Foundation/Time/Time.h>
+
+namespace
+{
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+  static constexpr ezUInt32 s_uiNumAllocationRounds = 2000;
+#else
+  static constexpr ezUInt32 s_uiNumAllocationRounds = 20000;
+#endif
+  static constexpr ezUInt32 s_uiAllocationsPerRound = 64;
+
+  typedef ezAllocator<ezMemoryPolicies::ezHeapAllocation, ezMemoryTrackingFlags::RegisterAllocator | ezMemoryTrackingFlags::EnableAllocationTracking> TrackedAllocator;
+  typedef ezAllocator<ezMemoryPolicies::ezHeapAllocation, ezMemoryTrackingFlags::None> UntrackedAllocator;
+
+  class AllocationThread : public ezThread
+  {
+  public:
+    AllocationThread(ezAllocatorBase* pAllocator)
+      : ezThread("AllocationThread")
+      , m_pAllocator(pAllocator)
+    {
+    }
+
+  private:
+    virtual ezUInt32 Run() override
+    {
+      void* allocations[s_uiAllocationsPerRound];
+
+      for (ezUInt32 uiRound = 0; uiRound < s_uiNumAllocationRounds; ++uiRound)
+      {
+        for (ezUInt32 i = 0; i < s_uiAllocationsPerRound; ++i)
+        {
+          allocations[i] = m_pAllocator->Allocate(16 + (i % 8) * 16, EZ_ALIGNMENT_MINIMUM);
+        }
+
+        for (ezUInt32 i = 0; i < s_uiAllocationsPerRound; ++i)
+        {
+          m_pAllocator->Deallocate(allocations[i]);
+        }
+      }
+
+      return 0;
+    }
+
+    ezAllocatorBase* m_pAllocator;
+  };
+
+  /// Returns the number of allocations per second over all threads.
+  double MeasureAllocationRate(ezAllocatorBase* pAllocator, ezUInt32 uiNumThreads)
+  {
+    ezDynamicArray<ezUniquePtr<AllocationThread>> threads;
+    for (ezUInt32 i = 0; i < uiNumThreads; ++i)
+    {
+      threads.PushBack(EZ_DEFAULT_NEW(AllocationThread, pAllocator));
+    }
+
+    const ezTime t0 = ezTime::Now();
+
+    for (auto& pThread : threads)
+    {
+      pThread->Start();
+    }
+
+    for (auto& pThread : threads)
+    {
+      pThread->Join();
+    }
+
+    const ezTime t1 = ezTime::Now();
+
+    const double fNumAllocations = static_cast<double>(uiNumThreads) * s_uiNumAllocationRounds * s_uiAllocationsPerRound;
+    return fNumAllocations / (t1 - t0).GetSeconds();
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Performance, MemoryTracker)
+{
+  TrackedAllocator trackedAllocator("TrackedAllocator", ezFoundation::GetDefaultAllocator());
+  UntrackedAllocator untrackedAllocator("UntrackedAllocator", ezFoundation::GetDefaultAllocator());
+
+  const ezUInt32 threadCounts[] = {1, 2, 4, 8};
+
+  for (ezUInt32 uiNumThreads : threadCounts)
+  {
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "Allocations")
+    {
+      const double fUntrackedRate = MeasureAllocationRate(&untrackedAllocator, uiNumThreads);
+      const double fTrackedRate = MeasureAllocationRate(&trackedAllocator, uiNumThreads);
+
+      ezLog::Info("[test]{0} thread(s), tracking off: {1} M allocations/sec", uiNumThreads, ezArgF(fUntrackedRate / 1000000.0, 2));
+      ezLog::Info("[test]{0} thread(s), tracking on:  {1} M allocations/sec", uiNumThreads, ezArgF(fTrackedRate / 1000000.0, 2));
+
+      EZ_TEST_INT(trackedAllocator.GetStats().m_uiNumAllocations, trackedAllocator.GetStats().m_uiNumDeallocations);
+      EZ_TEST_INT(trackedAllocator.GetStats().m_uiAllocationSize, 0);
+    }
+  }
+}
@@ -0,0 +1,85 @@
+#include <FoundationTestPCH.h>
+
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Threading/DelegateTask.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Time.h>
+
+namespace
+{
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+  static constexpr ezUInt32 s_uiNumSpawnerTasks = 32;
+  static constexpr ezUInt32 s_uiNumParallelFors = 16;
+  static constexpr ezUInt32 s_uiNumParallelForItems = 1024;
+#else
+  static constexpr ezUInt32 s_uiNumSpawnerTasks = 64;
+  static constexpr ezUInt32 s_uiNumParallelFors = 64;
+  static constexpr ezUInt32 s_uiNumParallelForItems = 4096;
+#endif
+
+  /// Starts a number of tasks that each run many fine-grained ParallelFor loops. This way all worker threads schedule and pick
+  /// a lot of very small tasks at the same time, which is where the contention on the task system happens.
+  ezTime RunNestedParallelFor(bool bWorkStealing, ezUInt32& out_uiSum)
+  {
+    ezTaskSystem::SetWorkStealingEnabled(bWorkStealing);
+
+    ezAtomicInteger32 iSum;
+
+    auto OuterFunc = [&iSum]() {
+      ezParallelForParams params;
+      params.uiBinSize = 1;
+      params.uiMaxTasksPerThread = 16;
+
+      for (ezUInt32 i = 0; i < s_uiNumParallelFors; ++i)
+      {
+        ezTaskSystem::ParallelForIndexed(0, s_uiNumParallelForItems, [&iSum](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) { iSum.Add(uiEndIndex - uiStartIndex); }, "Contention", params);
+      }
+    };
+
+    ezDynamicArray<ezUniquePtr<ezDelegateTask<void>>> tasks;
+
+    const ezTime t0 = ezTime::Now();
+
+    ezTaskGroupID group = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+
+    for (ezUInt32 i = 0; i < s_uiNumSpawnerTasks; ++i)
+    {
+      tasks.PushBack(EZ_DEFAULT_NEW(ezDelegateTask<void>, "Spawner", OuterFunc));
+      tasks.PeekBack()->ConfigureTask("Spawner", ezTaskNesting::Maybe);
+      ezTaskSystem::AddTaskToGroup(group, tasks.PeekBack().Borrow());
+    }
+
+    ezTaskSystem::StartTaskGroup(group);
+    ezTaskSystem::WaitForGroup(group);
+
+    const ezTime t1 = ezTime::Now();
+
+    out_uiSum = iSum;
+    return t1 - t0;
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Performance, TaskSystem)
+{
+  const bool bWorkStealingBefore = ezTaskSystem::IsWorkStealingEnabled();
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Nested ParallelFor Contention")
+  {
+    ezUInt32 uiSum = 0;
+
+    // warm up, so that all worker threads exist
+    RunNestedParallelFor(true, uiSum);
+
+    const ezTime tLocked = RunNestedParallelFor(false, uiSum);
+    EZ_TEST_INT(uiSum, s_uiNumSpawnerTasks * s_uiNumParallelFors * s_uiNumParallelForItems);
+
+    const ezTime tStealing = RunNestedParallelFor(true, uiSum);
+    EZ_TEST_INT(uiSum, s_uiNumSpawnerTasks * s_uiNumParallelFors * s_uiNumParallelForItems);
+
+    const ezUInt32 uiNumWorkers = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks);
+    ezLog::Info("[test]Task contention with {0} workers, locked task lists: {1}ms", uiNumWorkers, ezArgF(tLocked.GetMilliseconds(), 2));
+    ezLog::Info("[test]Task contention with {0} workers, work stealing: {1}ms", uiNumWorkers, ezArgF(tStealing.GetMilliseconds(), 2));
+  }
+
+  ezTaskSystem::SetWorkStealingEnabled(bWorkStealingBefore);
+}
@@ -2,8 +2,12 @@
 
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/IO/JSONReader.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/IO/OSFile.h>
 #include <Foundation/Profiling/Profiling.h>
 #include <Foundation/Threading/ThreadUtils.h>
+#include <TestFramework/Utilities/TestLogInterface.h>
 
 namespace
 {
@@ -20,6 +24,37 @@ namespace
       ezLog::Info("Profiling capture saved to '{0}'.", fileWriter.GetFilePathAbsolute().GetData());
     }
   }
+
+  void BusyWait(ezTime duration)
+  {
+    const ezTime endTime = ezTime::Now() + duration;
+    while (ezTime::Now() < endTime)
+    {
+    }
+  }
+
+  ezUInt32 CountTraceEvents(const ezVariantDictionary& trace, const char* szName, const char* szPhase)
+  {
+    ezUInt32 uiCount = 0;
+
+    const ezVariant* pEvents = nullptr;
+    if (trace.TryGetValue("traceEvents", pEvents) && pEvents->IsA<ezVariantArray>())
+    {
+      for (const ezVariant& event : pEvents->Get<ezVariantArray>())
+      {
+        const ezVariantDictionary& dict = event.Get<ezVariantDictionary>();
+
+        const ezVariant* pName = nullptr;
+        const ezVariant* pPhase = nullptr;
+        if (dict.TryGetValue("name", pName) && dict.TryGetValue("ph", pPhase) && pName->Get<ezString>().StartsWith(szName) && pPhase->Get<ezString>() == szPhase)
+        {
+          ++uiCount;
+        }
+      }
+    }
+
+    return uiCount;
+  }
 }
 
 EZ_CREATE_SIMPLE_TEST_GROUP(Profiling);
@@ -52,3 +87,117 @@ EZ_CREATE_SIMPLE_TEST(Profiling, Profiling)
     WriteOutProfilingCapture(":output/profilingScopes.json");
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(Profiling, Streaming)
+{
+  ezStringBuilder sStreamPath = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sStreamPath.AppendPath("profilingStream.ezProfiling");
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Stream and convert")
+  {
+    EZ_TEST_BOOL(ezProfilingSystem::StartStreaming(sStreamPath).Succeeded());
+    EZ_TEST_BOOL(ezProfilingSystem::IsStreaming());
+
+    ezProfilingSystem::StartNewFrame();
+
+    for (ezUInt32 i = 0; i < 3; ++i)
+    {
+      {
+        EZ_PROFILE_SCOPE("Stream outer scope");
+
+        {
+          EZ_PROFILE_SCOPE("Stream inner scope");
+          BusyWait(ezTime::Milliseconds(1));
+        }
+      }
+
+      ezProfilingSystem::StartNewFrame();
+    }
+
+    // scopes that are still pending are written when the stream is stopped
+    {
+      EZ_PROFILE_SCOPE("Stream last scope");
+      BusyWait(ezTime::Milliseconds(1));
+    }
+
+    ezProfilingSystem::StopStreaming();
+    EZ_TEST_BOOL(!ezProfilingSystem::IsStreaming());
+
+    // not streamed anymore
+    {
+      EZ_PROFILE_SCOPE("Stream last scope");
+      BusyWait(ezTime::Milliseconds(1));
+    }
+
+    ezDynamicArray<ezUInt8> streamData;
+    {
+      ezOSFile file;
+      EZ_TEST_BOOL(file.Open(sStreamPath, ezFileOpenMode::Read).Succeeded());
+      streamData.SetCountUninitialized(static_cast<ezUInt32>(file.GetFileSize()));
+      EZ_TEST_INT(file.Read(streamData.GetData(), streamData.GetCount()), streamData.GetCount());
+    }
+
+    ezMemoryStreamStorage traceStorage;
+    {
+      ezRawMemoryStreamReader reader(streamData);
+      ezMemoryStreamWriter writer(&traceStorage);
+      EZ_TEST_BOOL(ezProfilingSystem::ConvertStreamToTraceEvents(reader, writer).Succeeded());
+    }
+
+    ezJSONReader json;
+    {
+      ezMemoryStreamReader reader(&traceStorage);
+      EZ_TEST_BOOL(json.Parse(reader).Succeeded());
+    }
+
+    EZ_TEST_INT(CountTraceEvents(json.GetTopLevelObject(), "Stream outer scope", "X"), 3);
+    EZ_TEST_INT(CountTraceEvents(json.GetTopLevelObject(), "Stream inner scope", "X"), 3);
+    EZ_TEST_INT(CountTraceEvents(json.GetTopLevelObject(), "Stream last scope", "X"), 1);
+    EZ_TEST_INT(CountTraceEvents(json.GetTopLevelObject(), "Frame ", "X"), 3);
+    EZ_TEST_INT(CountTraceEvents(json.GetTopLevelObject(), "thread_name", "M") >= 3, true);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Truncated stream")
+  {
+    ezDynamicArray<ezUInt8> streamData;
+    {
+      ezOSFile file;
+      EZ_TEST_BOOL(file.Open(sStreamPath, ezFileOpenMode::Read).Succeeded());
+      streamData.SetCountUninitialized(static_cast<ezUInt32>(file.GetFileSize()));
+      EZ_TEST_INT(file.Read(streamData.GetData(), streamData.GetCount()), streamData.GetCount());
+    }
+
+    // cut off the middle of the last record, everything before it must still be converted
+    streamData.SetCount(streamData.GetCount() - 5);
+
+    ezMemoryStreamStorage traceStorage;
+    {
+      ezRawMemoryStreamReader reader(streamData);
+      ezMemoryStreamWriter writer(&traceStorage);
+      EZ_TEST_BOOL(ezProfilingSystem::ConvertStreamToTraceEvents(reader, writer).Succeeded());
+    }
+
+    ezJSONReader json;
+    {
+      ezMemoryStreamReader reader(&traceStorage);
+      EZ_TEST_BOOL(json.Parse(reader).Succeeded());
+    }
+
+    EZ_TEST_INT(CountTraceEvents(json.GetTopLevelObject(), "Stream outer scope", "X"), 3);
+    EZ_TEST_INT(CountTraceEvents(json.GetTopLevelObject(), "Stream last scope", "X"), 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Invalid stream")
+  {
+    const char szNoStream[] = "{ \"traceEvents\": [] }";
+
+    ezTestLogInterface log;
+    ezTestLogSystemScope logSystemScope(&log);
+    log.ExpectMessage("Input is not a profiling stream", ezLogMsgType::ErrorMsg);
+
+    ezRawMemoryStreamReader reader(szNoStream, sizeof(szNoStream));
+    ezMemoryStreamStorage traceStorage;
+    ezMemoryStreamWriter writer(&traceStorage);
+    EZ_TEST_BOOL(ezProfilingSystem::ConvertStreamToTraceEvents(reader, writer).Failed());
+  }
+}
@@ -30,8 +30,9 @@ EZ_CREATE_SIMPLE_TEST(SimdMath, SimdFloat)
 
     // Make sure all components are set to the same value
 #if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE
-    EZ_TEST_BOOL(vInit1F.m_v.m128_f32[0] == 2.0f && vInit1F.m_v.m128_f32[1] == 2.0f && vInit1F.m_v.m128_f32[2] == 2.0f &&
-                 vInit1F.m_v.m128_f32[3] == 2.0f);
+    float EZ_ALIGN_16(vals[4]);
+    _mm_store_ps(vals, vInit1F.m_v);
+    EZ_TEST_BOOL(vals[0] == 2.0f && vals[1] == 2.0f && vals[2] == 2.0f && vals[3] == 2.0f);
 #endif
 
     ezSimdFloat vInit1I(1);
@@ -39,8 +40,8 @@ EZ_CREATE_SIMPLE_TEST(SimdMath, SimdFloat)
 
     // Make sure all components are set to the same value
 #if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE
-    EZ_TEST_BOOL(vInit1I.m_v.m128_f32[0] == 1.0f && vInit1I.m_v.m128_f32[1] == 1.0f && vInit1I.m_v.m128_f32[2] == 1.0f &&
-                 vInit1I.m_v.m128_f32[3] == 1.0f);
+    _mm_store_ps(vals, vInit1I.m_v);
+    EZ_TEST_BOOL(vals[0] == 1.0f && vals[1] == 1.0f && vals[2] == 1.0f && vals[3] == 1.0f);
 #endif
 
     ezSimdFloat vInit1U(4553u);
@@ -48,8 +49,8 @@ EZ_CREATE_SIMPLE_TEST(SimdMath, SimdFloat)
 
     // Make sure all components are set to the same value
 #if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE
-    EZ_TEST_BOOL(vInit1U.m_v.m128_f32[0] == 4553.0f && vInit1U.m_v.m128_f32[1] == 4553.0f && vInit1U.m_v.m128_f32[2] == 4553.0f &&
-                 vInit1U.m_v.m128_f32[3] == 4553.0f);
+    _mm_store_ps(vals, vInit1U.m_v);
+    EZ_TEST_BOOL(vals[0] == 4553.0f && vals[1] == 4553.0f && vals[2] == 4553.0f && vals[3] == 4553.0f);
 #endif
 
     ezSimdFloat z = ezSimdFloat::Zero();
@@ -57,7 +58,8 @@ EZ_CREATE_SIMPLE_TEST(SimdMath, SimdFloat)
 
     // Make sure all components are set to the same value
 #if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE
-    EZ_TEST_BOOL(z.m_v.m128_f32[0] == 0.0f && z.m_v.m128_f32[1] == 0.0f && z.m_v.m128_f32[2] == 0.0f && z.m_v.m128_f32[3] == 0.0f);
+    _mm_store_ps(vals, z.m_v);
+    EZ_TEST_BOOL(vals[0] == 0.0f && vals[1] == 0.0f && vals[2] == 0.0f && vals[3] == 0.0f);
 #endif
   }
 
@@ -24,8 +24,9 @@ EZ_CREATE_SIMPLE_TEST(SimdMath, SimdVec4b)
 
     // Make sure all components have the correct value
 #if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE
-    EZ_TEST_BOOL(vInit1B.m_v.m128_u32[0] == 0xFFFFFFFF && vInit1B.m_v.m128_u32[1] == 0xFFFFFFFF && vInit1B.m_v.m128_u32[2] == 0xFFFFFFFF &&
-                 vInit1B.m_v.m128_u32[3] == 0xFFFFFFFF);
+    ezUInt32 EZ_ALIGN_16(vals[4]);
+    _mm_store_ps(reinterpret_cast<float*>(vals), vInit1B.m_v);
+    EZ_TEST_BOOL(vals[0] == 0xFFFFFFFF && vals[1] == 0xFFFFFFFF && vals[2] == 0xFFFFFFFF && vals[3] == 0xFFFFFFFF);
 #endif
 
     ezSimdVec4b vInit4B(false, true, false, true);
@@ -33,8 +34,8 @@ EZ_CREATE_SIMPLE_TEST(SimdMath, SimdVec4b)
 
     // Make sure all components have the correct value
 #if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE
-    EZ_TEST_BOOL(vInit4B.m_v.m128_u32[0] == 0 && vInit4B.m_v.m128_u32[1] == 0xFFFFFFFF && vInit4B.m_v.m128_u32[2] == 0 &&
-                 vInit4B.m_v.m128_u32[3] == 0xFFFFFFFF);
+    _mm_store_ps(reinterpret_cast<float*>(vals), vInit4B.m_v);
+    EZ_TEST_BOOL(vals[0] == 0 && vals[1] == 0xFFFFFFFF && vals[2] == 0 && vals[3] == 0xFFFFFFFF);
 #endif
 
     ezSimdVec4b vCopy(vInit4B);
@@ -31,7 +31,9 @@ EZ_CREATE_SIMPLE_TEST(SimdMath, SimdVec4i)
 
     // Make sure all components have the correct values
 #if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE
-    EZ_TEST_BOOL(b.m_v.m128i_i32[0] == 1 && b.m_v.m128i_i32[1] == 2 && b.m_v.m128i_i32[2] == 3 && b.m_v.m128i_i32[3] == 4);
+    ezInt32 EZ_ALIGN_16(vals[4]);
+    _mm_store_si128(reinterpret_cast<__m128i*>(vals), b.m_v);
+    EZ_TEST_BOOL(vals[0] == 1 && vals[1] == 2 && vals[2] == 3 && vals[3] == 4);
 #endif
 
     ezSimdVec4i copy(b);
@@ -31,7 +31,9 @@ EZ_CREATE_SIMPLE_TEST(SimdMath, SimdVec4u)
 
     // Make sure all components have the correct values
 #if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE
-    EZ_TEST_BOOL(b.m_v.m128i_u32[0] == 1 && b.m_v.m128i_u32[1] == 2 && b.m_v.m128i_u32[2] == 3 && b.m_v.m128i_u32[3] == 0xFFFFFFFFu);
+    ezUInt32 EZ_ALIGN_16(vals[4]);
+    _mm_store_si128(reinterpret_cast<__m128i*>(vals), b.m_v);
+    EZ_TEST_BOOL(vals[0] == 1 && vals[1] == 2 && vals[2] == 3 && vals[3] == 0xFFFFFFFFu);
 #endif
 
     ezSimdVec4u copy(b);
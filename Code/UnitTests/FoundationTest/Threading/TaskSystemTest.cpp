@@ -2,6 +2,7 @@
 
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/Threading/DelegateTask.h>
 #include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Time/Time.h>
 #include <Foundation/Utilities/DGMLWriter.h>
@@ -521,6 +522,65 @@ EZ_CREATE_SIMPLE_TEST(Threading, TaskSystem)
     EZ_TEST_BOOL(t[2].IsMultiplicityDone());
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Nested Tasks (Work Stealing)")
+  {
+    EZ_TEST_BOOL(ezTaskSystem::IsWorkStealingEnabled());
+
+    for (ezUInt32 iRun = 0; iRun < 2; ++iRun)
+    {
+      // the second run uses the global task lists only
+      ezTaskSystem::SetWorkStealingEnabled(iRun == 0);
+
+      ezAtomicInteger32 iSum;
+      ezTestTask t[8];
+      ezTaskGroupID tg[8];
+
+      for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(t); ++i)
+      {
+        t[i].m_uiIterations = 1;
+        t[i].SetMultiplicity(64);
+      }
+
+      // the tasks of the dependent groups are scheduled by the worker that finishes the dependency, ie. into its local queue
+      tg[0] = ezTaskSystem::StartSingleTask(&t[0], ezTaskPriority::ThisFrame);
+      for (ezUInt32 i = 1; i < EZ_ARRAY_SIZE(t); ++i)
+      {
+        tg[i] = ezTaskSystem::StartSingleTask(&t[i], (i % 2) == 0 ? ezTaskPriority::EarlyThisFrame : ezTaskPriority::LongRunning, tg[i - 1]);
+      }
+
+      // ParallelFor inside a task schedules into the local queue of the executing worker and waits for it there
+      auto OuterFunc = [&]() {
+        ezParallelForParams params;
+        params.uiMaxTasksPerThread = 8;
+
+        ezTaskSystem::ParallelForIndexed(0, 256, [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) { iSum.Add(uiEndIndex - uiStartIndex); }, "Inner", params);
+      };
+
+      ezDynamicArray<ezUniquePtr<ezDelegateTask<void>>> outerTasks;
+      ezTaskGroupID outerGroup = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+
+      for (ezUInt32 i = 0; i < 16; ++i)
+      {
+        outerTasks.PushBack(EZ_DEFAULT_NEW(ezDelegateTask<void>, "Outer", OuterFunc));
+        outerTasks.PeekBack()->ConfigureTask("Outer", ezTaskNesting::Maybe);
+        ezTaskSystem::AddTaskToGroup(outerGroup, outerTasks.PeekBack().Borrow());
+      }
+
+      ezTaskSystem::StartTaskGroup(outerGroup);
+      ezTaskSystem::WaitForGroup(outerGroup);
+
+      for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(t); ++i)
+      {
+        ezTaskSystem::WaitForGroup(tg[i]);
+        EZ_TEST_BOOL(t[i].IsMultiplicityDone());
+      }
+
+      EZ_TEST_INT(iSum, 16 * 256);
+    }
+
+    ezTaskSystem::SetWorkStealingEnabled(true);
+  }
+
   // capture profiling info for testing
   /*ezStringBuilder sOutputPath = ezTestFramework::GetInstance()->GetAbsOutputPath();
 
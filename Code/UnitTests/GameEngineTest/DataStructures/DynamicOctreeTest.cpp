@@ -1,6 +1,8 @@
 #include <GameEngineTestPCH.h>
 
 #include <Foundation/Containers/Deque.h>
+#include <Foundation/Math/Random.h>
+#include <Foundation/Time/Stopwatch.h>
 #include <Utilities/DataStructures/DynamicOctree.h>
 
 EZ_CREATE_SIMPLE_TEST_GROUP(DataStructures);
@@ -23,6 +25,35 @@ namespace DynamicOctreeTestDetail
     // let it give us all the objects in range and count how many that are
     return true;
   }
+
+  static bool CollectObject(void* pPassThrough, ezDynamicTreeObjectConst Object)
+  {
+    static_cast<ezDynamicArray<ezDynamicTree::ezObjectData>*>(pPassThrough)->PushBack(Object.Value());
+    return true;
+  }
+
+  static bool IsSameResult(const ezDynamicArray<ezDynamicTree::ezObjectData>& a, const ezDynamicArray<ezDynamicTree::ezObjectData>& b)
+  {
+    if (a.GetCount() != b.GetCount())
+      return false;
+
+    for (ezUInt32 i = 0; i < a.GetCount(); ++i)
+    {
+      if (a[i].m_iObjectType != b[i].m_iObjectType || a[i].m_iObjectInstance != b[i].m_iObjectInstance)
+        return false;
+    }
+
+    return true;
+  }
+
+  static void CreateRandomFrustum(ezRandom& rng, float fRange, ezFrustum& out_Frustum)
+  {
+    const ezVec3 vPos((float)rng.DoubleMinMax(-fRange, fRange), (float)rng.DoubleMinMax(-fRange, fRange), (float)rng.DoubleMinMax(-10, 10));
+    ezVec3 vDir((float)rng.DoubleMinMax(-1, 1), (float)rng.DoubleMinMax(-1, 1), (float)rng.DoubleMinMax(-0.2, 0.2));
+    vDir.NormalizeIfNotZero(ezVec3(1, 0, 0));
+
+    out_Frustum.SetFrustum(vPos, vDir, ezVec3(0, 0, 1), ezAngle::Degree(90), ezAngle::Degree(60), 0.1f, fRange * 0.3f);
+  }
 }
 
 EZ_CREATE_SIMPLE_TEST(DataStructures, DynamicOctree)
@@ -212,6 +243,162 @@ EZ_CREATE_SIMPLE_TEST(DataStructures, DynamicOctree)
     }
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindObjectsInRange(Array)")
+  {
+    ezDynamicOctree o;
+    o.CreateTree(ezVec3::ZeroVector(), ezVec3(100), 1.0f);
+
+    for (ezUInt32 i = 0; i < Objects.GetCount(); ++i)
+    {
+      EZ_TEST_BOOL(o.InsertObject(Objects[i].m_vPos, Objects[i].m_vExtents, 0, i, &Objects[i].m_hObject, false) == EZ_SUCCESS);
+    }
+
+    ezDynamicArray<ezDynamicTree::ezObjectData> fromCallback;
+    ezDynamicArray<ezDynamicTree::ezObjectData> fromArray;
+
+    for (ezUInt32 i = 0; i < Objects.GetCount(); ++i)
+    {
+      fromCallback.Clear();
+      fromArray.Clear();
+      o.FindObjectsInRange(Objects[i].m_vPos, DynamicOctreeTestDetail::CollectObject, &fromCallback);
+      o.FindObjectsInRange(Objects[i].m_vPos, fromArray);
+      EZ_TEST_BOOL(!fromArray.IsEmpty());
+      EZ_TEST_BOOL(DynamicOctreeTestDetail::IsSameResult(fromCallback, fromArray));
+
+      fromCallback.Clear();
+      fromArray.Clear();
+      o.FindObjectsInRange(Objects[i].m_vPos, 30.0f, DynamicOctreeTestDetail::CollectObject, &fromCallback);
+      o.FindObjectsInRange(Objects[i].m_vPos, 30.0f, fromArray);
+      EZ_TEST_BOOL(!fromArray.IsEmpty());
+      EZ_TEST_BOOL(DynamicOctreeTestDetail::IsSameResult(fromCallback, fromArray));
+    }
+
+    // the results must be up to date after the tree was modified
+    o.RemoveObject(Objects[0].m_hObject);
+
+    fromArray.Clear();
+    o.FindObjectsInRange(Objects[0].m_vPos, 1.0f, fromArray);
+    for (const auto& obj : fromArray)
+    {
+      EZ_TEST_BOOL(obj.m_iObjectInstance != 0);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindVisibleObjects")
+  {
+    ezDynamicOctree o;
+    o.CreateTree(ezVec3::ZeroVector(), ezVec3(100), 1.0f);
+
+    ezRandom rng;
+    rng.Initialize(7);
+
+    ezDynamicArray<ezBoundingBox> boxes;
+    for (ezUInt32 i = 0; i < 2000; ++i)
+    {
+      const ezVec3 vPos((float)rng.DoubleMinMax(-100, 100), (float)rng.DoubleMinMax(-100, 100), (float)rng.DoubleMinMax(-20, 20));
+      const ezVec3 vExtents((float)rng.DoubleMinMax(0.1, (i % 50 == 0) ? 30.0 : 2.0));
+
+      boxes.ExpandAndGetRef().SetCenterAndHalfExtents(vPos, vExtents);
+      EZ_TEST_BOOL(o.InsertObject(vPos, vExtents, 0, i, nullptr, false) == EZ_SUCCESS);
+    }
+
+    ezDynamicArray<ezDynamicTree::ezObjectData> fromCallback;
+    ezDynamicArray<ezDynamicTree::ezObjectData> fromArray;
+    ezDynamicArray<ezUInt32> numFound;
+
+    for (ezUInt32 uiFrustum = 0; uiFrustum < 20; ++uiFrustum)
+    {
+      ezFrustum frustum;
+      DynamicOctreeTestDetail::CreateRandomFrustum(rng, 100.0f, frustum);
+
+      fromCallback.Clear();
+      fromArray.Clear();
+      o.FindVisibleObjects(frustum, DynamicOctreeTestDetail::CollectObject, &fromCallback);
+      o.FindVisibleObjects(frustum, fromArray);
+      EZ_TEST_BOOL(DynamicOctreeTestDetail::IsSameResult(fromCallback, fromArray));
+
+      numFound.Clear();
+      numFound.SetCount(boxes.GetCount());
+      for (const auto& obj : fromArray)
+      {
+        ++numFound[obj.m_iObjectInstance];
+      }
+
+      // every object that overlaps the frustum has to be returned exactly once
+      for (ezUInt32 i = 0; i < boxes.GetCount(); ++i)
+      {
+        EZ_TEST_BOOL(numFound[i] <= 1);
+
+        if (frustum.GetObjectPosition(boxes[i]) != ezVolumePosition::Outside)
+        {
+          EZ_TEST_INT(numFound[i], 1);
+        }
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Queries before and after the rebuild")
+  {
+    ezDynamicOctree o;
+    o.CreateTree(ezVec3::ZeroVector(), ezVec3(100), 1.0f);
+
+    ezRandom rng;
+    rng.Initialize(11);
+
+    ezDynamicArray<ezDynamicTreeObject> handles;
+    for (ezUInt32 i = 0; i < 2000; ++i)
+    {
+      const ezVec3 vPos((float)rng.DoubleMinMax(-100, 100), (float)rng.DoubleMinMax(-100, 100), (float)rng.DoubleMinMax(-20, 20));
+      EZ_TEST_BOOL(o.InsertObject(vPos, ezVec3((float)rng.DoubleMinMax(0.1, 2.0)), 0, i, &handles.ExpandAndGetRef(), false) == EZ_SUCCESS);
+    }
+
+    ezFrustum frustum;
+    DynamicOctreeTestDetail::CreateRandomFrustum(rng, 100.0f, frustum);
+
+    ezDynamicArray<ezDynamicTree::ezObjectData> reference;
+    ezDynamicArray<ezDynamicTree::ezObjectData> fromCallback;
+    ezDynamicArray<ezDynamicTree::ezObjectData> fromArray;
+
+    // the first queries after a modification traverse the tree, the later ones use the rebuilt arrays,
+    // both have to return the same objects in the same order
+    for (ezUInt32 uiRound = 0; uiRound < 2; ++uiRound)
+    {
+      reference.Clear();
+      o.FindVisibleObjects(frustum, reference);
+      EZ_TEST_BOOL(!reference.IsEmpty());
+
+      for (ezUInt32 i = 0; i < 200; ++i)
+      {
+        fromCallback.Clear();
+        fromArray.Clear();
+        o.FindVisibleObjects(frustum, DynamicOctreeTestDetail::CollectObject, &fromCallback);
+        o.FindVisibleObjects(frustum, fromArray);
+
+        EZ_TEST_BOOL(DynamicOctreeTestDetail::IsSameResult(reference, fromCallback));
+        EZ_TEST_BOOL(DynamicOctreeTestDetail::IsSameResult(reference, fromArray));
+      }
+
+      if (uiRound > 0)
+        break;
+
+      // remove an object that is not visible, so the result stays the same
+      for (ezUInt32 i = 0; i < handles.GetCount(); ++i)
+      {
+        bool bVisible = false;
+        for (const auto& obj : reference)
+        {
+          bVisible |= obj.m_iObjectInstance == (ezInt32)i;
+        }
+
+        if (!bVisible)
+        {
+          o.RemoveObject(handles[i]);
+          break;
+        }
+      }
+    }
+  }
+
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "RemoveObject(handle)")
   {
     ezDynamicOctree o;
@@ -332,3 +519,144 @@ EZ_CREATE_SIMPLE_TEST(DataStructures, DynamicOctree)
     EZ_TEST_INT(o.GetCount(), 0);
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(DataStructures, Profile_DynamicOctree)
+{
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+  const ezUInt32 uiNumObjects = 10000;
+#else
+  const ezUInt32 uiNumObjects = 100000;
+#endif
+  const ezUInt32 uiNumRangeQueries = 1000;
+  const ezUInt32 uiNumFrustumQueries = 100;
+
+  ezRandom rng;
+  rng.Initialize(42);
+
+  ezDynamicOctree o;
+  o.CreateTree(ezVec3::ZeroVector(), ezVec3(1000), 8.0f);
+
+  {
+    ezStopwatch sw;
+
+    for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+    {
+      const ezVec3 vPos((float)rng.DoubleMinMax(-1000, 1000), (float)rng.DoubleMinMax(-1000, 1000), (float)rng.DoubleMinMax(-100, 100));
+      const ezVec3 vExtents((float)((i % 100 == 0) ? rng.DoubleMinMax(20, 100) : rng.DoubleMinMax(0.5, 3)));
+
+      o.InsertObject(vPos, vExtents, 0, i, nullptr, false);
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Inserting %u objects: %.2fms", uiNumObjects, sw.GetRunningTotal().GetMilliseconds());
+  }
+
+  ezDynamicArray<ezVec3> points;
+  for (ezUInt32 i = 0; i < uiNumRangeQueries; ++i)
+  {
+    points.PushBack(ezVec3((float)rng.DoubleMinMax(-1000, 1000), (float)rng.DoubleMinMax(-1000, 1000), (float)rng.DoubleMinMax(-50, 50)));
+  }
+
+  ezDynamicArray<ezFrustum> frustums;
+  for (ezUInt32 i = 0; i < uiNumFrustumQueries; ++i)
+  {
+    DynamicOctreeTestDetail::CreateRandomFrustum(rng, 1000.0f, frustums.ExpandAndGetRef());
+  }
+
+  {
+    // the first query after a modification builds the flat node arrays
+    ezStopwatch sw;
+    DynamicOctreeTestDetail::g_iReturned = 0;
+    o.FindObjectsInRange(points[0], 20.0f, DynamicOctreeTestDetail::ObjectFound, nullptr);
+    ezTestFramework::Output(ezTestOutput::Duration, "First query: %.2fms", sw.GetRunningTotal().GetMilliseconds());
+  }
+
+  ezDynamicArray<ezDynamicTree::ezObjectData> objects;
+
+  {
+    ezStopwatch sw;
+    DynamicOctreeTestDetail::g_iReturned = 0;
+    for (const ezVec3& vPoint : points)
+    {
+      o.FindObjectsInRange(vPoint, 20.0f, DynamicOctreeTestDetail::ObjectFound, nullptr);
+    }
+    ezTestFramework::Output(ezTestOutput::Duration, "%u range queries (callback, %u objects): %.2fms", uiNumRangeQueries,
+      DynamicOctreeTestDetail::g_iReturned, sw.GetRunningTotal().GetMilliseconds());
+  }
+
+  {
+    ezStopwatch sw;
+    ezUInt32 uiNumFound = 0;
+    for (const ezVec3& vPoint : points)
+    {
+      objects.Clear();
+      o.FindObjectsInRange(vPoint, 20.0f, objects);
+      uiNumFound += objects.GetCount();
+    }
+    ezTestFramework::Output(
+      ezTestOutput::Duration, "%u range queries (array, %u objects): %.2fms", uiNumRangeQueries, uiNumFound, sw.GetRunningTotal().GetMilliseconds());
+    EZ_TEST_INT(uiNumFound, DynamicOctreeTestDetail::g_iReturned);
+  }
+
+  {
+    ezStopwatch sw;
+    DynamicOctreeTestDetail::g_iReturned = 0;
+    for (const ezFrustum& frustum : frustums)
+    {
+      o.FindVisibleObjects(frustum, DynamicOctreeTestDetail::ObjectFound, nullptr);
+    }
+    ezTestFramework::Output(ezTestOutput::Duration, "%u frustum queries (callback, %u objects): %.2fms", uiNumFrustumQueries,
+      DynamicOctreeTestDetail::g_iReturned, sw.GetRunningTotal().GetMilliseconds());
+  }
+
+  {
+    ezStopwatch sw;
+    ezUInt32 uiNumFound = 0;
+    for (const ezFrustum& frustum : frustums)
+    {
+      objects.Clear();
+      o.FindVisibleObjects(frustum, objects);
+      uiNumFound += objects.GetCount();
+    }
+    ezTestFramework::Output(ezTestOutput::Duration, "%u frustum queries (array, %u objects): %.2fms", uiNumFrustumQueries, uiNumFound,
+      sw.GetRunningTotal().GetMilliseconds());
+    EZ_TEST_INT(uiNumFound, DynamicOctreeTestDetail::g_iReturned);
+  }
+
+  // a typical frame: a few objects move, then the tree is queried a few times
+  const ezUInt32 uiNumFrames = 100;
+  const ezUInt32 uiNumQueriesPerFrame = 10;
+
+  for (bool bModify : {false, true})
+  {
+    ezDynamicTreeObject movingObject;
+    o.InsertObject(points[0], ezVec3(1.0f), 1, 0, &movingObject);
+
+    ezStopwatch sw;
+    ezUInt32 uiNumFound = 0;
+
+    for (ezUInt32 uiFrame = 0; uiFrame < uiNumFrames; ++uiFrame)
+    {
+      if (bModify)
+      {
+        o.RemoveObject(movingObject);
+        o.InsertObject(points[uiFrame % uiNumRangeQueries], ezVec3(1.0f), 1, 0, &movingObject);
+      }
+
+      for (ezUInt32 i = 0; i < uiNumQueriesPerFrame; ++i)
+      {
+        objects.Clear();
+        o.FindObjectsInRange(points[(uiFrame * uiNumQueriesPerFrame + i) % uiNumRangeQueries], 20.0f, objects);
+        uiNumFound += objects.GetCount();
+      }
+
+      objects.Clear();
+      o.FindVisibleObjects(frustums[uiFrame % uiNumFrustumQueries], objects);
+      uiNumFound += objects.GetCount();
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%u frames with %s and %u queries each (%u objects): %.2fms", uiNumFrames,
+      bModify ? "one moving object" : "no modification", uiNumQueriesPerFrame + 1, uiNumFound, sw.GetRunningTotal().GetMilliseconds());
+
+    o.RemoveObject(movingObject);
+  }
+}
@@ -0,0 +1,246 @@
+#include <GameEngineTestPCH.h>
+
+#include <Foundation/Math/Random.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <Utilities/DataStructures/GameGrid.h>
+#include <Utilities/PathFinding/GraphSearch.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(PathFinding);
+
+namespace
+{
+  struct GridPathState : public ezPathState
+  {
+  };
+
+  /// 4-neighborhood with uniform costs and the manhattan distance as the heuristic, so A* finds the shortest path.
+  class GridPathStateGenerator : public ezPathStateGenerator<GridPathState>
+  {
+  public:
+    GridPathStateGenerator(const ezGameGrid<ezUInt8>& grid)
+      : m_Grid(grid)
+    {
+    }
+
+    virtual void StartSearch(ezInt64 iStartNodeIndex, const GridPathState* pStartState, ezInt64 iTargetNodeIndex) override
+    {
+      m_TargetCoord = m_Grid.ConvertCellIndexToCoordinate((ezUInt32)iTargetNodeIndex);
+    }
+
+    virtual void GenerateAdjacentStates(ezInt64 iNodeIndex, const GridPathState& StartState, ezPathSearch<GridPathState>* pPathSearch) override
+    {
+      const ezVec2I32 coord = m_Grid.ConvertCellIndexToCoordinate((ezUInt32)iNodeIndex);
+      const ezVec2I32 neighbors[4] = {ezVec2I32(coord.x - 1, coord.y), ezVec2I32(coord.x + 1, coord.y), ezVec2I32(coord.x, coord.y - 1), ezVec2I32(coord.x, coord.y + 1)};
+
+      for (const ezVec2I32& neighbor : neighbors)
+      {
+        if (!m_Grid.IsValidCellCoordinate(neighbor) || m_Grid.GetCell(neighbor) != 0)
+          continue;
+
+        GridPathState state;
+        state.m_fCostToNode = StartState.m_fCostToNode + 1.0f;
+        state.m_fEstimatedCostToTarget = state.m_fCostToNode + (float)(ezMath::Abs(neighbor.x - m_TargetCoord.x) + ezMath::Abs(neighbor.y - m_TargetCoord.y));
+
+        pPathSearch->AddPathNode(m_Grid.ConvertCellCoordinateToIndex(neighbor), state);
+      }
+    }
+
+  private:
+    const ezGameGrid<ezUInt8>& m_Grid;
+    ezVec2I32 m_TargetCoord;
+  };
+
+  void CreateGrid(ezGameGrid<ezUInt8>& grid, ezUInt16 uiSize, ezUInt32 uiSeed)
+  {
+    grid.CreateGrid(uiSize, uiSize);
+
+    ezRandom rng;
+    rng.Initialize(uiSeed);
+
+    // roughly 25% blocked cells, clustered into short walls so the search has to go around them
+    for (ezUInt32 i = 0; i < grid.GetNumCells() / 16; ++i)
+    {
+      const ezUInt32 x = rng.UIntInRange(uiSize);
+      const ezUInt32 y = rng.UIntInRange(uiSize);
+      const bool bHorizontal = rng.Bool();
+
+      for (ezUInt32 j = 0; j < 4; ++j)
+      {
+        const ezVec2I32 coord(bHorizontal ? x + j : x, bHorizontal ? y : y + j);
+        if (grid.IsValidCellCoordinate(coord))
+          grid.GetCell(coord) = 1;
+      }
+    }
+  }
+
+  /// Breadth first search for the reference path length, -1 if unreachable.
+  ezInt32 GetShortestPathLength(const ezGameGrid<ezUInt8>& grid, ezUInt32 uiStart, ezUInt32 uiTarget)
+  {
+    ezDynamicArray<ezInt32> distances;
+    distances.SetCount(grid.GetNumCells(), -1);
+
+    ezDeque<ezUInt32> queue;
+    queue.PushBack(uiStart);
+    distances[uiStart] = 0;
+
+    while (!queue.IsEmpty())
+    {
+      const ezUInt32 uiCell = queue.PeekFront();
+      queue.PopFront();
+
+      if (uiCell == uiTarget)
+        return distances[uiCell];
+
+      const ezVec2I32 coord = grid.ConvertCellIndexToCoordinate(uiCell);
+      const ezVec2I32 neighbors[4] = {ezVec2I32(coord.x - 1, coord.y), ezVec2I32(coord.x + 1, coord.y), ezVec2I32(coord.x, coord.y - 1), ezVec2I32(coord.x, coord.y + 1)};
+
+      for (const ezVec2I32& neighbor : neighbors)
+      {
+        if (!grid.IsValidCellCoordinate(neighbor) || grid.GetCell(neighbor) != 0)
+          continue;
+
+        const ezUInt32 uiNeighbor = grid.ConvertCellCoordinateToIndex(neighbor);
+        if (distances[uiNeighbor] < 0)
+        {
+          distances[uiNeighbor] = distances[uiCell] + 1;
+          queue.PushBack(uiNeighbor);
+        }
+      }
+    }
+
+    return -1;
+  }
+
+  ezUInt32 GetRandomFreeCell(const ezGameGrid<ezUInt8>& grid, ezRandom& rng)
+  {
+    while (true)
+    {
+      const ezUInt32 uiCell = rng.UIntInRange(grid.GetNumCells());
+      if (grid.GetCell(uiCell) == 0)
+        return uiCell;
+    }
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(PathFinding, PathSearch)
+{
+  ezGameGrid<ezUInt8> grid;
+  CreateGrid(grid, 64, 42);
+
+  GridPathStateGenerator generator(grid);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindPath")
+  {
+    ezPathSearch<GridPathState> hashedSearch;
+    hashedSearch.SetPathStateGenerator(&generator);
+
+    ezPathSearch<GridPathState> denseSearch;
+    denseSearch.SetPathStateGenerator(&generator);
+    denseSearch.SetNodeIndexRange(grid.GetNumCells());
+
+    ezRandom rng;
+    rng.Initialize(7);
+
+    ezDeque<ezPathSearch<GridPathState>::PathResultData> path;
+
+    for (ezUInt32 i = 0; i < 50; ++i)
+    {
+      const ezUInt32 uiStart = GetRandomFreeCell(grid, rng);
+      const ezUInt32 uiTarget = GetRandomFreeCell(grid, rng);
+
+      const ezInt32 iExpectedLength = GetShortestPathLength(grid, uiStart, uiTarget);
+
+      for (ezPathSearch<GridPathState>* pSearch : {&hashedSearch, &denseSearch})
+      {
+        const ezResult res = pSearch->FindPath(uiStart, GridPathState(), uiTarget, path);
+
+        if (iExpectedLength < 0)
+        {
+          EZ_TEST_BOOL(res.Failed());
+          continue;
+        }
+
+        if (EZ_TEST_BOOL(res.Succeeded()).Failed())
+          continue;
+
+        EZ_TEST_INT(path.GetCount(), iExpectedLength + 1);
+        EZ_TEST_INT(path[0].m_iNodeIndex, uiStart);
+        EZ_TEST_INT(path.PeekBack().m_iNodeIndex, uiTarget);
+        EZ_TEST_FLOAT(path.PeekBack().m_pPathState->m_fCostToNode, (float)iExpectedLength, 0.0f);
+
+        for (ezUInt32 p = 1; p < path.GetCount(); ++p)
+        {
+          const ezVec2I32 prev = grid.ConvertCellIndexToCoordinate((ezUInt32)path[p - 1].m_iNodeIndex);
+          const ezVec2I32 cur = grid.ConvertCellIndexToCoordinate((ezUInt32)path[p].m_iNodeIndex);
+          EZ_TEST_INT(ezMath::Abs(prev.x - cur.x) + ezMath::Abs(prev.y - cur.y), 1);
+          EZ_TEST_INT(grid.GetCell(cur), 0);
+        }
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Max Path Cost")
+  {
+    ezPathSearch<GridPathState> search;
+    search.SetPathStateGenerator(&generator);
+
+    ezDeque<ezPathSearch<GridPathState>::PathResultData> path;
+
+    const ezUInt32 uiStart = grid.ConvertCellCoordinateToIndex(ezVec2I32(0, 0));
+    const ezUInt32 uiTarget = grid.ConvertCellCoordinateToIndex(ezVec2I32(63, 63));
+    grid.GetCell(uiStart) = 0;
+    grid.GetCell(uiTarget) = 0;
+
+    EZ_TEST_BOOL(search.FindPath(uiStart, GridPathState(), uiTarget, path, 20.0f).Failed());
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(PathFinding, Profile_LargeGrid)
+{
+  ezGameGrid<ezUInt8> grid;
+  CreateGrid(grid, 1024, 13);
+
+  GridPathStateGenerator generator(grid);
+
+  ezRandom rng;
+  rng.Initialize(17);
+
+  const ezUInt32 uiNumQueries = 20;
+  ezHybridArray<ezUInt32, uiNumQueries * 2> queries;
+  for (ezUInt32 i = 0; i < uiNumQueries * 2; ++i)
+  {
+    queries.PushBack(GetRandomFreeCell(grid, rng));
+  }
+
+  for (ezUInt32 uiNodeIndexRange : {0u, grid.GetNumCells()})
+  {
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindPath")
+    {
+      ezPathSearch<GridPathState> search;
+      search.SetPathStateGenerator(&generator);
+      search.SetNodeIndexRange(uiNodeIndexRange);
+
+      ezDeque<ezPathSearch<GridPathState>::PathResultData> path;
+      ezUInt32 uiNumFound = 0;
+      ezUInt64 uiTotalPathLength = 0;
+
+      ezStopwatch sw;
+
+      for (ezUInt32 i = 0; i < uiNumQueries; ++i)
+      {
+        if (search.FindPath(queries[i * 2], GridPathState(), queries[i * 2 + 1], path).Succeeded())
+        {
+          ++uiNumFound;
+          uiTotalPathLength += path.GetCount();
+        }
+      }
+
+      const ezTime tDuration = sw.GetRunningTotal();
+
+      ezLog::Info("[test]1024x1024 grid, {0} lookup: {1} paths ({2} found, avg. length {3}) in {4} ms", uiNodeIndexRange > 0 ? "flat" : "hashed",
+        uiNumQueries, uiNumFound, uiNumFound > 0 ? uiTotalPathLength / uiNumFound : 0, ezArgF(tDuration.GetMilliseconds(), 1));
+
+      EZ_TEST_BOOL(uiNumFound > 0);
+    }
+  }
+}
@@ -0,0 +1,151 @@
+#include <GameEngineTestPCH.h>
+
+#include <ProcGenPlugin/VM/ExpressionByteCode.h>
+#include <ProcGenPlugin/VM/ExpressionCompiler.h>
+#include <ProcGenPlugin/VM/ExpressionVM.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(ProcGen);
+
+namespace
+{
+  static ezHashedString s_sInputX = ezMakeHashedString("x");
+  static ezHashedString s_sInputY = ezMakeHashedString("y");
+  static ezHashedString s_sOutputA = ezMakeHashedString("a");
+  static ezHashedString s_sOutputB = ezMakeHashedString("b");
+  static ezHashedString s_sRandom = ezMakeHashedString("Random");
+
+  typedef void (*BuildASTFunc)(ezExpressionAST& ast);
+
+  // a = (sin(x) * (2 * 3)) + abs(y - sqrt(16)), every subtree is created twice to give CSE something to do
+  void BuildConstantsAndDuplicates(ezExpressionAST& ast)
+  {
+    auto pScale = ast.CreateBinaryOperator(ezExpressionAST::NodeType::Multiply, ast.CreateConstant(2.0f), ast.CreateConstant(3.0f));
+    auto pSinX = ast.CreateUnaryOperator(ezExpressionAST::NodeType::Sin, ast.CreateInput(s_sInputX));
+    auto pLeft = ast.CreateBinaryOperator(ezExpressionAST::NodeType::Multiply, pSinX, pScale);
+
+    auto pSqrt = ast.CreateUnaryOperator(ezExpressionAST::NodeType::Sqrt, ast.CreateConstant(16.0f));
+    auto pRight = ast.CreateUnaryOperator(ezExpressionAST::NodeType::Absolute,
+      ast.CreateBinaryOperator(ezExpressionAST::NodeType::Subtract, ast.CreateInput(s_sInputY), pSqrt));
+
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(s_sOutputA, ast.CreateBinaryOperator(ezExpressionAST::NodeType::Add, pLeft, pRight)));
+
+    // b = sin(x) * 6 + 0.5, built from new nodes
+    auto pSinX2 = ast.CreateUnaryOperator(ezExpressionAST::NodeType::Sin, ast.CreateInput(s_sInputX));
+    auto pScale2 = ast.CreateBinaryOperator(ezExpressionAST::NodeType::Add, ast.CreateConstant(1.0f), ast.CreateConstant(5.0f));
+    auto pLeft2 = ast.CreateBinaryOperator(ezExpressionAST::NodeType::Multiply, pSinX2, pScale2);
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(s_sOutputB, ast.CreateBinaryOperator(ezExpressionAST::NodeType::Add, pLeft2, ast.CreateConstant(0.5f))));
+  }
+
+  // Two identical random calls, a fully constant output and an output that is overwritten later
+  void BuildFunctionsAndDeadOutputs(ezExpressionAST& ast)
+  {
+    auto CreateRandom = [&]() {
+      auto pSeed = ast.CreateBinaryOperator(ezExpressionAST::NodeType::Add, ast.CreateInput(s_sInputX), ast.CreateConstant(17.0f));
+      auto pFunctionCall = ast.CreateFunctionCall(s_sRandom);
+      pFunctionCall->m_Arguments.PushBack(pSeed);
+      return pFunctionCall;
+    };
+
+    auto pValue = ast.CreateBinaryOperator(ezExpressionAST::NodeType::Max, CreateRandom(), ast.CreateInput(s_sInputY));
+    pValue = ast.CreateBinaryOperator(ezExpressionAST::NodeType::Divide, pValue, CreateRandom());
+    pValue = ast.CreateBinaryOperator(ezExpressionAST::NodeType::Min, pValue, ast.CreateConstant(0.25f));
+
+    auto pConstant = ast.CreateUnaryOperator(ezExpressionAST::NodeType::ATan, ast.CreateUnaryOperator(ezExpressionAST::NodeType::Cos, ast.CreateConstant(0.3f)));
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(s_sOutputB, pConstant));
+
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(s_sOutputA, pValue));
+
+    // outputs are written in reverse order, so this one is overwritten by the first output with the same name
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(s_sOutputA, ast.CreateUnaryOperator(ezExpressionAST::NodeType::Cos, ast.CreateInput(s_sInputY))));
+  }
+
+  void Execute(const ezExpressionByteCode& byteCode, ezArrayPtr<const float> inputX, ezArrayPtr<const float> inputY, ezDynamicArray<float>& out_a, ezDynamicArray<float>& out_b)
+  {
+    const ezUInt32 uiNumInstances = inputX.GetCount();
+
+    out_a.Clear();
+    out_a.SetCount(uiNumInstances);
+    out_b.Clear();
+    out_b.SetCount(uiNumInstances);
+
+    ezHybridArray<ezExpression::Stream, 2> inputs;
+    inputs.PushBack(ezExpression::MakeStream(ezArrayPtr<float>(const_cast<float*>(inputX.GetPtr()), uiNumInstances), 0, s_sInputX));
+    inputs.PushBack(ezExpression::MakeStream(ezArrayPtr<float>(const_cast<float*>(inputY.GetPtr()), uiNumInstances), 0, s_sInputY));
+
+    ezHybridArray<ezExpression::Stream, 2> outputs;
+    outputs.PushBack(ezExpression::MakeStream(out_a.GetArrayPtr(), 0, s_sOutputA));
+    outputs.PushBack(ezExpression::MakeStream(out_b.GetArrayPtr(), 0, s_sOutputB));
+
+    ezExpressionVM vm;
+    vm.RegisterDefaultFunctions();
+    EZ_TEST_BOOL(vm.Execute(byteCode, inputs, outputs, uiNumInstances).Succeeded());
+  }
+
+  void CompareOptimized(const char* szName, BuildASTFunc buildFunc)
+  {
+    const ezUInt32 uiNumInstances = 1021;
+
+    ezDynamicArray<float> inputX;
+    ezDynamicArray<float> inputY;
+    for (ezUInt32 i = 0; i < uiNumInstances; ++i)
+    {
+      inputX.PushBack(i * 0.37f - 100.0f);
+      inputY.PushBack(ezMath::Sin(ezAngle::Radian(i * 0.11f)) * 10.0f);
+    }
+
+    ezExpressionCompiler compiler;
+
+    ezExpressionAST ast;
+    buildFunc(ast);
+    ezExpressionByteCode byteCode;
+    EZ_TEST_BOOL(compiler.Compile(ast, byteCode, false).Succeeded());
+
+    ezExpressionAST optimizedAst;
+    buildFunc(optimizedAst);
+    ezExpressionByteCode optimizedByteCode;
+    EZ_TEST_BOOL(compiler.Compile(optimizedAst, optimizedByteCode).Succeeded());
+
+    ezLog::Info("[test]{0}: {1} instructions, {2} registers -> {3} instructions, {4} registers", szName, byteCode.GetNumInstructions(),
+      byteCode.GetNumTempRegisters(), optimizedByteCode.GetNumInstructions(), optimizedByteCode.GetNumTempRegisters());
+
+    EZ_TEST_BOOL(optimizedByteCode.GetNumInstructions() < byteCode.GetNumInstructions());
+
+    ezDynamicArray<float> a, b, optimizedA, optimizedB;
+    Execute(byteCode, inputX, inputY, a, b);
+    Execute(optimizedByteCode, inputX, inputY, optimizedA, optimizedB);
+
+    // bit-identical, not just close
+    EZ_TEST_BOOL(ezMemoryUtils::IsEqual(reinterpret_cast<const ezUInt32*>(a.GetData()), reinterpret_cast<const ezUInt32*>(optimizedA.GetData()), uiNumInstances));
+    EZ_TEST_BOOL(ezMemoryUtils::IsEqual(reinterpret_cast<const ezUInt32*>(b.GetData()), reinterpret_cast<const ezUInt32*>(optimizedB.GetData()), uiNumInstances));
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(ProcGen, ExpressionCompiler)
+{
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Constant folding and CSE")
+  {
+    CompareOptimized("Constants and duplicates", &BuildConstantsAndDuplicates);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Functions and dead outputs")
+  {
+    CompareOptimized("Functions and dead outputs", &BuildFunctionsAndDeadOutputs);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Fully constant")
+  {
+    ezExpressionAST ast;
+    auto pValue = ast.CreateBinaryOperator(ezExpressionAST::NodeType::Multiply, ast.CreateConstant(4.0f), ast.CreateConstant(0.5f));
+    pValue = ast.CreateBinaryOperator(ezExpressionAST::NodeType::Subtract, pValue, ast.CreateConstant(1.0f));
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(s_sOutputA, pValue));
+
+    ezExpressionCompiler compiler;
+    ezExpressionByteCode byteCode;
+    EZ_TEST_BOOL(compiler.Compile(ast, byteCode).Succeeded());
+
+    // one mov for the constant and one for the output
+    EZ_TEST_INT(byteCode.GetNumInstructions(), 2);
+    EZ_TEST_BOOL(ast.m_OutputNodes[0]->m_pExpression->m_Type == ezExpressionAST::NodeType::FloatConstant);
+    EZ_TEST_FLOAT(static_cast<ezExpressionAST::Constant*>(ast.m_OutputNodes[0]->m_pExpression)->m_Value.Get<float>(), 1.0f, 0.0f);
+  }
+}
@@ -0,0 +1,303 @@
+#include <RendererCoreTestPCH.h>
+
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/Math/Random.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <RendererCore/AnimationSystem/AnimationClipResource.h>
+#include <RendererCore/AnimationSystem/AnimationPose.h>
+#include <RendererCore/AnimationSystem/JointMapping.h>
+#include <RendererCore/AnimationSystem/Skeleton.h>
+#include <RendererCore/AnimationSystem/SkeletonBuilder.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Animation);
+
+namespace
+{
+  constexpr ezUInt16 s_uiNumJoints = 60;
+  constexpr ezUInt16 s_uiNumFrames = 90;
+
+  /// This joint rotates by less than 0.05 degrees over the whole clip, which is still more than the quantization error.
+  constexpr ezUInt16 s_uiSlowJoint = 5;
+  constexpr float s_fSlowJointDegree = 0.04f;
+
+  /// Every joint is attached to one of the previous joints, so the hierarchy has several long chains.
+  void CreateSkeleton(ezSkeleton& out_Skeleton)
+  {
+    ezSkeletonBuilder builder;
+    ezStringBuilder sName;
+
+    for (ezUInt32 uiJoint = 0; uiJoint < s_uiNumJoints; ++uiJoint)
+    {
+      sName.Format("Joint{0}", uiJoint);
+
+      const ezTransform bindPose(ezVec3(0, 0, 0.1f));
+      builder.AddJoint(sName.GetData(), bindPose, uiJoint == 0 ? 0xFFFFFFFFu : uiJoint / 2);
+    }
+
+    builder.BuildSkeleton(out_Skeleton);
+  }
+
+  /// Creates smooth keyframes for all joints. Some joints have constant rotations, positions or scales, like typical animation data.
+  void CreateAnimationClip(ezAnimationClipResourceDescriptor& out_Clip)
+  {
+    ezRandom rnd;
+    rnd.Initialize(42);
+
+    out_Clip.Configure(s_uiNumJoints, s_uiNumFrames, 30, false);
+
+    ezStringBuilder sName;
+    for (ezUInt16 uiJoint = 0; uiJoint < s_uiNumJoints; ++uiJoint)
+    {
+      sName.Format("Joint{0}", uiJoint);
+
+      ezHashedString sJointName;
+      sJointName.Assign(sName.GetData());
+      const ezUInt16 uiAnimJoint = out_Clip.AddJointName(sJointName);
+
+      const ezVec3 vAxis = ezVec3((float)rnd.DoubleMinMax(-1, 1), (float)rnd.DoubleMinMax(-1, 1), 1.0f).GetNormalized();
+      float fSpeed = (float)rnd.DoubleMinMax(-5.0, 5.0);
+      const ezVec3 vOffset((float)rnd.DoubleMinMax(-0.5, 0.5), (float)rnd.DoubleMinMax(-0.5, 0.5), (float)rnd.DoubleMinMax(-0.5, 0.5));
+
+      if (uiJoint == s_uiSlowJoint)
+      {
+        fSpeed = s_fSlowJointDegree / (s_uiNumFrames - 1);
+      }
+
+      ezArrayPtr<ezTransform> keyframes = out_Clip.GetJointKeyframes(uiAnimJoint);
+      for (ezUInt16 uiFrame = 0; uiFrame < s_uiNumFrames; ++uiFrame)
+      {
+        ezTransform& keyframe = keyframes[uiFrame];
+        keyframe.SetIdentity();
+        keyframe.m_vPosition.Set(0, 0, 0.1f);
+
+        if (uiJoint % 4 != 0)
+        {
+          keyframe.m_qRotation.SetFromAxisAndAngle(vAxis, ezAngle::Degree(fSpeed * uiFrame));
+        }
+
+        if (uiJoint % 3 == 0)
+        {
+          keyframe.m_vPosition += vOffset * ezMath::Sin(ezAngle::Degree(4.0f * uiFrame));
+        }
+
+        if (uiJoint % 7 == 0)
+        {
+          keyframe.m_vScale.Set(1.0f + 0.2f * ezMath::Cos(ezAngle::Degree(6.0f * uiFrame)));
+        }
+      }
+    }
+  }
+
+  /// Returns the angle between the two rotations in degrees.
+  float GetRotationError(const ezQuat& q0, const ezQuat& q1)
+  {
+    const float fSign = (q0.v.Dot(q1.v) + q0.w * q1.w) < 0.0f ? -1.0f : 1.0f;
+    const ezVec4 vDiff(q0.v.x - fSign * q1.v.x, q0.v.y - fSign * q1.v.y, q0.v.z - fSign * q1.v.z, q0.w - fSign * q1.w);
+
+    // the chord length between unit quaternions is 2 * sin(angle / 4)
+    return 4.0f * ezMath::ASin(ezMath::Min(vDiff.GetLength() * 0.5f, 1.0f)).GetDegree();
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Animation, CompressedAnimationClip)
+{
+  ezSkeleton skeleton;
+  CreateSkeleton(skeleton);
+
+  ezAnimationClipResourceDescriptor uncompressed;
+  CreateAnimationClip(uncompressed);
+
+  ezAnimationClipResourceDescriptor compressed = uncompressed;
+  compressed.CompressKeyframes();
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "CompressKeyframes")
+  {
+    EZ_TEST_BOOL(!uncompressed.IsCompressed());
+    EZ_TEST_BOOL(compressed.IsCompressed());
+
+    float fMaxPositionError = 0.0f;
+    float fMaxScaleError = 0.0f;
+    float fMaxRotationError = 0.0f;
+    float fMaxSlowJointError = 0.0f;
+
+    for (ezUInt16 uiJoint = 0; uiJoint < s_uiNumJoints; ++uiJoint)
+    {
+      for (ezUInt16 uiFrame = 0; uiFrame < s_uiNumFrames; ++uiFrame)
+      {
+        const ezTransform original = uncompressed.GetJointKeyframe(uiJoint, uiFrame);
+        const ezTransform decompressed = compressed.GetJointKeyframe(uiJoint, uiFrame);
+
+        fMaxPositionError = ezMath::Max(fMaxPositionError, (original.m_vPosition - decompressed.m_vPosition).GetLength());
+        fMaxScaleError = ezMath::Max(fMaxScaleError, (original.m_vScale - decompressed.m_vScale).GetLength());
+        const float fRotationError = GetRotationError(original.m_qRotation, decompressed.m_qRotation);
+        fMaxRotationError = ezMath::Max(fMaxRotationError, fRotationError);
+
+        if (uiJoint == s_uiSlowJoint)
+        {
+          fMaxSlowJointError = ezMath::Max(fMaxSlowJointError, fRotationError);
+        }
+      }
+    }
+
+    ezLog::Info("[test]Max error: position {0}, scale {1}, rotation {2} degrees", ezArgF(fMaxPositionError, 6), ezArgF(fMaxScaleError, 6), ezArgF(fMaxRotationError, 4));
+
+    EZ_TEST_BOOL(fMaxPositionError < 0.0001f);
+    EZ_TEST_BOOL(fMaxScaleError < 0.0001f);
+    EZ_TEST_BOOL(fMaxRotationError < 0.02f);
+
+    // a slow rotation must not be stored as a constant, that would be off by the whole angle at the end of the clip
+    EZ_TEST_BOOL(fMaxSlowJointError < 0.02f);
+    EZ_TEST_BOOL(GetRotationError(uncompressed.GetJointKeyframe(s_uiSlowJoint, 0).m_qRotation, uncompressed.GetJointKeyframe(s_uiSlowJoint, s_uiNumFrames - 1).m_qRotation) > 0.03f);
+
+    const ezUInt64 uiUncompressedSize = uncompressed.GetHeapMemoryUsage();
+    const ezUInt64 uiCompressedSize = compressed.GetHeapMemoryUsage();
+
+    ezLog::Info("[test]Keyframe memory: {0} bytes uncompressed, {1} bytes compressed", uiUncompressedSize, uiCompressedSize);
+
+    EZ_TEST_BOOL(uiCompressedSize * 3 < uiUncompressedSize);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Save / Load")
+  {
+    ezMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+    ezMemoryStreamReader reader(&storage);
+
+    // uncompressed clips are compressed when they are written
+    uncompressed.Save(writer);
+    compressed.Save(writer);
+
+    ezAnimationClipResourceDescriptor loaded0, loaded1;
+    loaded0.Load(reader);
+    loaded1.Load(reader);
+
+    EZ_TEST_BOOL(loaded0.IsCompressed());
+    EZ_TEST_BOOL(loaded1.IsCompressed());
+    EZ_TEST_INT(loaded0.GetNumFrames(), s_uiNumFrames);
+    EZ_TEST_INT(loaded0.GetAllJointIndices().GetCount(), s_uiNumJoints);
+
+    for (ezUInt16 uiJoint = 0; uiJoint < s_uiNumJoints; ++uiJoint)
+    {
+      for (ezUInt16 uiFrame = 0; uiFrame < s_uiNumFrames; ++uiFrame)
+      {
+        const ezTransform expected = compressed.GetJointKeyframe(uiJoint, uiFrame);
+
+        EZ_TEST_BOOL(loaded0.GetJointKeyframe(uiJoint, uiFrame).IsEqual(expected, 0.0f));
+        EZ_TEST_BOOL(loaded1.GetJointKeyframe(uiJoint, uiFrame).IsEqual(expected, 0.0f));
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "SamplePose")
+  {
+    ezJointMapping jointMapping;
+    jointMapping.CreateMapping(skeleton, compressed);
+    EZ_TEST_INT(jointMapping.GetAllMappings().GetCount(), s_uiNumJoints);
+
+    ezLocalSpaceAnimationPose localPose;
+    localPose.Configure(skeleton);
+
+    ezAnimationPose pose, referencePose;
+    pose.Configure(skeleton);
+    referencePose.Configure(skeleton);
+
+    const float fLerps[] = {0.0f, 0.3f, 0.75f};
+
+    for (ezUInt16 uiFrame = 0; uiFrame + 1 < s_uiNumFrames; uiFrame += 7)
+    {
+      for (float fLerp : fLerps)
+      {
+        uncompressed.SetPoseToBlendedKeyframe(referencePose, skeleton, uiFrame, fLerp);
+        referencePose.ConvertFromLocalSpaceToObjectSpace(skeleton);
+
+        compressed.SamplePose(jointMapping, uiFrame, fLerp, localPose);
+        localPose.ConvertToObjectSpace(skeleton, pose);
+
+        for (ezUInt16 uiJoint = 0; uiJoint < s_uiNumJoints; ++uiJoint)
+        {
+          EZ_TEST_BOOL(pose.IsTransformValid(uiJoint));
+          EZ_TEST_BOOL(pose.GetTransform(uiJoint).IsEqual(referencePose.GetTransform(uiJoint), 0.005f));
+        }
+      }
+    }
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(Animation, Profile_SampleCrowd)
+{
+  ezSkeleton skeleton;
+  CreateSkeleton(skeleton);
+
+  ezAnimationClipResourceDescriptor uncompressed;
+  CreateAnimationClip(uncompressed);
+
+  ezAnimationClipResourceDescriptor compressed = uncompressed;
+  compressed.CompressKeyframes();
+
+  ezJointMapping jointMapping;
+  jointMapping.CreateMapping(skeleton, compressed);
+
+  ezLocalSpaceAnimationPose localPose;
+  localPose.Configure(skeleton);
+
+  ezAnimationPose pose;
+  pose.Configure(skeleton);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+  const ezUInt32 uiNumCharacters = 100;
+#else
+  const ezUInt32 uiNumCharacters = 2000;
+#endif
+
+  // every character plays the clip at a different time, each stage is timed separately to see which one dominates
+  ezStopwatch swSampleByName, swConvertMatrices, swSampleCompressed, swConvertSoA;
+  swSampleByName.Pause();
+  swConvertMatrices.Pause();
+  swSampleCompressed.Pause();
+  swConvertSoA.Pause();
+
+  for (ezUInt32 i = 0; i < uiNumCharacters; ++i)
+  {
+    const ezUInt16 uiFrame = static_cast<ezUInt16>(i % (s_uiNumFrames - 1));
+
+    swSampleByName.Resume();
+    uncompressed.SetPoseToBlendedKeyframe(pose, skeleton, uiFrame, 0.5f);
+    swSampleByName.Pause();
+
+    swConvertMatrices.Resume();
+    pose.ConvertFromLocalSpaceToObjectSpace(skeleton);
+    swConvertMatrices.Pause();
+
+    swSampleCompressed.Resume();
+    compressed.SamplePose(jointMapping, uiFrame, 0.5f, localPose);
+    swSampleCompressed.Pause();
+
+    swConvertSoA.Resume();
+    localPose.ConvertToObjectSpace(skeleton, pose);
+    swConvertSoA.Pause();
+  }
+
+  // the part of sampling by name that only looks up the joints, which the joint mapping replaces
+  ezStopwatch swLookUpByName;
+  ezUInt32 uiNumFound = 0;
+  for (ezUInt32 i = 0; i < uiNumCharacters; ++i)
+  {
+    for (ezUInt16 uiJoint = 0; uiJoint < s_uiNumJoints; ++uiJoint)
+    {
+      uiNumFound += skeleton.FindJointByName(skeleton.GetJointByIndex(uiJoint).GetName()) != ezInvalidJointIndex ? 1 : 0;
+    }
+  }
+  const ezTime tLookUpByName = swLookUpByName.GetRunningTotal();
+  EZ_TEST_INT(uiNumFound, uiNumCharacters * s_uiNumJoints);
+
+  const ezTime tOld = swSampleByName.GetRunningTotal() + swConvertMatrices.GetRunningTotal();
+  const ezTime tNew = swSampleCompressed.GetRunningTotal() + swConvertSoA.GetRunningTotal();
+
+  ezLog::Info("[test]{0} characters with {1} joints, by name with matrices: {2} ms (sampling {3} ms, of which {4} ms joint look-up, "
+              "conversion {5} ms)",
+    uiNumCharacters, s_uiNumJoints, ezArgF(tOld.GetMilliseconds(), 2), ezArgF(swSampleByName.GetRunningTotal().GetMilliseconds(), 2),
+    ezArgF(tLookUpByName.GetMilliseconds(), 2), ezArgF(swConvertMatrices.GetRunningTotal().GetMilliseconds(), 2));
+  ezLog::Info("[test]{0} characters with {1} joints, compressed with SoA poses: {2} ms (sampling {3} ms, conversion {4} ms)", uiNumCharacters,
+    s_uiNumJoints, ezArgF(tNew.GetMilliseconds(), 2), ezArgF(swSampleCompressed.GetRunningTotal().GetMilliseconds(), 2),
+    ezArgF(swConvertSoA.GetRunningTotal().GetMilliseconds(), 2));
+}
@@ -0,0 +1,6 @@
+#include <RendererCoreTestPCH.h>
+
+#include <TestFramework/Framework/TestFramework.h>
+#include <TestFramework/Utilities/TestSetup.h>
+
+EZ_TESTFRAMEWORK_ENTRY_POINT("RendererCoreTest", "Renderer Core Tests")
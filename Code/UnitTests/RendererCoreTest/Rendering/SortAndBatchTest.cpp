@@ -0,0 +1,138 @@
+#include <RendererCoreTestPCH.h>
+
+#include <Foundation/Math/Random.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <RendererCore/Meshes/MeshComponentBase.h>
+#include <RendererCore/Pipeline/ExtractedRenderData.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Rendering);
+
+namespace
+{
+  /// Creates render data like a large scene with few meshes and materials, without any resources or GPU involved.
+  void CreateRenderData(ezDynamicArray<ezMeshRenderData>& out_RenderData, ezUInt32 uiCount)
+  {
+    ezRandom rnd;
+    rnd.Initialize(23);
+
+    out_RenderData.SetCount(uiCount);
+    for (ezMeshRenderData& renderData : out_RenderData)
+    {
+      const ezUInt32 uiMesh = rnd.UIntInRange(300);
+      const ezUInt32 uiMaterial = rnd.UIntInRange(60);
+
+      renderData.m_GlobalTransform.SetIdentity();
+      renderData.m_GlobalTransform.m_vPosition =
+        ezVec3((float)rnd.DoubleMinMax(-500, 500), (float)rnd.DoubleMinMax(-500, 500), (float)rnd.DoubleMinMax(-50, 50));
+      renderData.m_GlobalBounds = ezBoundingBoxSphere(renderData.m_GlobalTransform.m_vPosition, ezVec3(1.0f), 1.0f);
+
+      renderData.m_uiBatchId = uiMesh * 64 + uiMaterial;
+      renderData.m_uiSortingKey = (uiMaterial << 16) | (uiMesh & 0xFFFE);
+    }
+  }
+
+  void AddRenderData(ezExtractedRenderData& extractedRenderData, const ezDynamicArray<ezMeshRenderData>& renderData)
+  {
+    for (ezUInt32 i = 0; i < renderData.GetCount(); ++i)
+    {
+      // a few transparent objects, like in typical scenes
+      const ezRenderData::Category category = (i % 8 == 0) ? ezDefaultRenderDataCategories::LitTransparent : ezDefaultRenderDataCategories::LitOpaque;
+      extractedRenderData.AddRenderData(&renderData[i], category);
+    }
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Rendering, SortAndBatch)
+{
+  ezCamera camera;
+  camera.LookAt(ezVec3(0, 0, 10), ezVec3(1, 0, 10), ezVec3(0, 0, 1));
+
+  ezDynamicArray<ezMeshRenderData> renderData;
+  CreateRenderData(renderData, 20000);
+
+  ezExtractedRenderData extractedRenderData;
+  extractedRenderData.SetCamera(camera);
+  AddRenderData(extractedRenderData, renderData);
+  extractedRenderData.SortAndBatch();
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Batches")
+  {
+    ezUInt32 uiNumRenderData = 0;
+
+    for (ezRenderData::Category category : {ezDefaultRenderDataCategories::LitOpaque, ezDefaultRenderDataCategories::LitTransparent})
+    {
+      const ezRenderDataBatchList batchList = extractedRenderData.GetRenderDataBatchesWithCategory(category);
+      EZ_TEST_BOOL(batchList.GetBatchCount() > 0);
+
+      ezUInt64 uiPreviousSortingKey = 0;
+      ezUInt32 uiPreviousBatchId = 0;
+
+      for (ezUInt32 uiBatch = 0; uiBatch < batchList.GetBatchCount(); ++uiBatch)
+      {
+        const ezRenderDataBatch batch = batchList.GetBatch(uiBatch);
+        EZ_TEST_BOOL(batch.GetCount() > 0);
+
+        const ezUInt32 uiBatchId = batch.GetFirstData<ezMeshRenderData>()->m_uiBatchId;
+
+        // consecutive batches must differ, otherwise they would have been merged
+        EZ_TEST_BOOL(uiBatch == 0 || uiBatchId != uiPreviousBatchId);
+        uiPreviousBatchId = uiBatchId;
+
+        for (auto it = batch.GetIterator<ezMeshRenderData>(); it.IsValid(); ++it)
+        {
+          EZ_TEST_INT(it->m_uiBatchId, uiBatchId);
+
+          const ezUInt64 uiSortingKey = it->GetCategorySortingKey(category, camera);
+          EZ_TEST_BOOL(uiSortingKey >= uiPreviousSortingKey);
+          uiPreviousSortingKey = uiSortingKey;
+
+          ++uiNumRenderData;
+        }
+      }
+    }
+
+    EZ_TEST_INT(uiNumRenderData, renderData.GetCount());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Clear")
+  {
+    extractedRenderData.Clear();
+    EZ_TEST_INT(extractedRenderData.GetRenderDataBatchesWithCategory(ezDefaultRenderDataCategories::LitOpaque).GetBatchCount(), 0);
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(Rendering, Profile_SortAndBatch)
+{
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+  const ezUInt32 uiNumRenderData = 20000;
+#else
+  const ezUInt32 uiNumRenderData = 200000;
+#endif
+  const ezUInt32 uiNumFrames = 10;
+
+  ezCamera camera;
+  camera.LookAt(ezVec3(0, 0, 10), ezVec3(1, 0, 10), ezVec3(0, 0, 1));
+
+  ezDynamicArray<ezMeshRenderData> renderData;
+  CreateRenderData(renderData, uiNumRenderData);
+
+  ezExtractedRenderData extractedRenderData;
+  extractedRenderData.SetCamera(camera);
+
+  // every frame extracts all render data again, only the sorting and batching is measured
+  ezTime tTotal;
+  for (ezUInt32 uiFrame = 0; uiFrame < uiNumFrames; ++uiFrame)
+  {
+    extractedRenderData.Clear();
+    AddRenderData(extractedRenderData, renderData);
+
+    ezStopwatch sw;
+    extractedRenderData.SortAndBatch();
+    tTotal += sw.GetRunningTotal();
+  }
+
+  const ezUInt32 uiNumBatches = extractedRenderData.GetRenderDataBatchesWithCategory(ezDefaultRenderDataCategories::LitOpaque).GetBatchCount();
+
+  ezLog::Info("[test]SortAndBatch of {0} render data: {1} ms per frame, {2} opaque batches", uiNumRenderData,
+    ezArgF(tTotal.GetMilliseconds() / uiNumFrames, 2), uiNumBatches);
+}